@@ -132,6 +132,9 @@ CartInterp::CartInterp(const string &progName,
       (_params.conv_strat_max_convectivity_for_stratiform);
     _convStrat.setMinGridOverlapForClumping
       (_params.conv_strat_min_overlap_for_convective_clumps);
+    if (_params.use_multiple_threads) {
+      _convStrat.setNThreads(_params.n_compute_threads);
+    }
   }
   _gotConvStrat = false;
 
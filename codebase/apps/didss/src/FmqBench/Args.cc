@@ -0,0 +1,149 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+//////////////////////////////////////////////////////////
+// Args.cc
+//
+// Command line args
+//
+// Oct 2026
+//
+//////////////////////////////////////////////////////////
+
+#include "Args.hh"
+#include "Params.hh"
+#include <cstring>
+#include <toolsa/umisc.h>
+using namespace std;
+
+// parse
+
+int Args::parse(int argc, char **argv, string &prog_name)
+
+{
+
+  int iret = 0;
+  char tmp_str[BUFSIZ];
+
+  // intialize
+
+  TDRP_init_override(&override);
+
+  // loop through args
+  
+  for (int i =  1; i < argc; i++) {
+
+    if (!strcmp(argv[i], "--") ||
+	!strcmp(argv[i], "-h") ||
+	!strcmp(argv[i], "-help") ||
+	!strcmp(argv[i], "-man")) {
+      
+      _usage(prog_name, cout);
+      exit (0);
+      
+    } else if (!strcmp(argv[i], "-debug")) {
+      
+      sprintf(tmp_str, "debug = DEBUG_NORM;");
+      TDRP_add_override(&override, tmp_str);
+      
+    } else if (!strcmp(argv[i], "-verbose")) {
+      
+      sprintf(tmp_str, "debug = DEBUG_VERBOSE;");
+      TDRP_add_override(&override, tmp_str);
+      
+    } else if (!strcmp(argv[i], "-fmq")) {
+      
+      if (i < argc - 1) {
+	sprintf(tmp_str, "fmq_path = \"%s\";", argv[++i]);
+	TDRP_add_override(&override, tmp_str);
+      } else {
+	iret = -1;
+      }
+	
+    } else if (!strcmp(argv[i], "-n")) {
+      
+      if (i < argc - 1) {
+	sprintf(tmp_str, "n_messages = %s;", argv[++i]);
+	TDRP_add_override(&override, tmp_str);
+      } else {
+	iret = -1;
+      }
+	
+    } else if (!strcmp(argv[i], "-len")) {
+      
+      if (i < argc - 1) {
+	sprintf(tmp_str, "message_len = %s;", argv[++i]);
+	TDRP_add_override(&override, tmp_str);
+      } else {
+	iret = -1;
+      }
+	
+    } else if (!strcmp(argv[i], "-readers")) {
+      
+      if (i < argc - 1) {
+	sprintf(tmp_str, "n_readers = %s;", argv[++i]);
+	TDRP_add_override(&override, tmp_str);
+      } else {
+	iret = -1;
+      }
+	
+    } else if (!strcmp(argv[i], "-interval")) {
+      
+      if (i < argc - 1) {
+	sprintf(tmp_str, "write_interval_usecs = %s;", argv[++i]);
+	TDRP_add_override(&override, tmp_str);
+      } else {
+	iret = -1;
+      }
+	
+    } // if
+    
+  } // i
+
+  if (iret) {
+    _usage(prog_name, cerr);
+  }
+
+  return (iret);
+    
+}
+
+void Args::_usage(string &prog_name, ostream &out)
+{
+
+  out << "Usage: " << prog_name << " [options as below]\n"
+      << "options:\n"
+      << "       [ --, -h, -help, -man ] produce this list.\n"
+      << "       [ -debug ] print debug messages\n"
+      << "       [ -fmq ? ] specify path of FMQ to test\n"
+      << "       [ -interval ? ] interval between writes (usecs)\n"
+      << "          If 0, write as fast as possible\n"
+      << "       [ -len ? ] message length (bytes)\n"
+      << "       [ -n ? ] number of messages per test\n"
+      << "       [ -readers ? ] number of reader processes\n"
+      << "       [ -verbose ] print verbose debug messages\n"
+      << endl;
+  
+  Params::usage(out);
+
+}
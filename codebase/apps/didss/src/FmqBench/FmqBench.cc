@@ -0,0 +1,456 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+///////////////////////////////////////////////////////////////
+// FmqBench.cc
+//
+// FmqBench object
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <toolsa/umisc.h>
+#include <toolsa/pmu.h>
+#include <toolsa/uusleep.h>
+#include <Fmq/Fmq.hh>
+#include "FmqBench.hh"
+using namespace std;
+
+// Constructor
+
+FmqBench::FmqBench(int argc, char **argv)
+
+{
+
+  isOK = true;
+
+  // set programe name
+
+  _progName = "FmqBench";
+  ucopyright((char *) _progName.c_str());
+
+  // get command line args
+
+  if (_args.parse(argc, argv, _progName)) {
+    cerr << "ERROR: " << _progName << endl;
+    cerr << "Problem with command line args" << endl;
+    isOK = FALSE;
+    return;
+  }
+
+  // get TDRP params
+  
+  _paramsPath = (char *) "unknown";
+  if (_params.loadFromArgs(argc, argv, _args.override.list,
+			   &_paramsPath)) {
+    cerr << "ERROR: " << _progName << endl;
+    cerr << "Problem with TDRP parameters" << endl;
+    isOK = FALSE;
+    return;
+  }
+
+  if (_params.message_len < (int) sizeof(msg_hdr_t)) {
+    cerr << "ERROR: " << _progName << endl;
+    cerr << "  message_len too small: " << _params.message_len << endl;
+    cerr << "  Minimum is: " << sizeof(msg_hdr_t) << endl;
+    isOK = FALSE;
+    return;
+  }
+
+  // init process mapper registration
+
+  PMU_auto_init((char *) _progName.c_str(),
+		_params.instance,
+		PROCMAP_REGISTER_INTERVAL);
+
+  return;
+
+}
+
+// destructor
+
+FmqBench::~FmqBench()
+
+{
+
+  // unregister process
+
+  PMU_auto_unregister();
+
+}
+
+//////////////////////////////////////////////////
+// Run
+
+int FmqBench::Run ()
+{
+
+  // register with procmap
+  
+  PMU_auto_register("Run");
+
+  fprintf(stdout, "FmqBench - fmq: %s\n", _params.fmq_path);
+  fprintf(stdout, "  n_messages: %d, message_len: %d, n_readers: %d\n",
+          _params.n_messages, _params.message_len, _params.n_readers);
+  fprintf(stdout, "  n_slots: %d, buf_size: %d, write_interval_usecs: %d\n",
+          _params.n_slots, _params.buf_size, _params.write_interval_usecs);
+  fprintf(stdout, "\n");
+  fprintf(stdout, "%-14s %6s %10s %8s %9s %9s"
+          " %9s %8s %8s %9s %9s\n",
+          "mode", "end", "writes/s", "MB/s", "meanW_us", "maxW_us",
+          "nRead", "skipped", "corrupt", "meanL_ms", "maxL_ms");
+  fflush(stdout);
+
+  int iret = 0;
+  for (int ii = 0; ii < _params.writer_modes_n; ii++) {
+    if (_runTest(_params._writer_modes[ii])) {
+      iret = -1;
+    }
+  }
+
+  return iret;
+
+}
+
+//////////////////////////////////////////////////
+// Run the test for a given writer mode
+// Returns 0 on success, -1 on failure
+
+int FmqBench::_runTest(Params::writer_mode_t mode)
+{
+
+  PMU_auto_register("_runTest");
+
+  if (_params.debug) {
+    cerr << "Running test, mode: " << _modeStr(mode) << endl;
+  }
+
+  // create the queue
+
+  Fmq fmq;
+  if (fmq.initCreate(_params.fmq_path, _progName.c_str(),
+                     _params.debug >= Params::DEBUG_VERBOSE,
+                     false, _params.n_slots, _params.buf_size)) {
+    cerr << "ERROR - FmqBench::_runTest" << endl;
+    cerr << "  Cannot create fmq: " << _params.fmq_path << endl;
+    cerr << fmq.getErrStr() << endl;
+    return -1;
+  }
+  if (mode == Params::SINGLE_WRITER) {
+    fmq.setSingleWriter();
+  }
+
+  // pipes for the readers to report back
+
+  int readyPipe[2], resultsPipe[2];
+  if (pipe(readyPipe) || pipe(resultsPipe)) {
+    int errNum = errno;
+    cerr << "ERROR - FmqBench::_runTest" << endl;
+    cerr << "  Cannot create pipe: " << strerror(errNum) << endl;
+    return -1;
+  }
+
+  // fork the readers
+
+  vector<pid_t> pids;
+  for (int ii = 0; ii < _params.n_readers; ii++) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      // child
+      close(readyPipe[0]);
+      close(resultsPipe[0]);
+      _runReader(readyPipe[1], resultsPipe[1]);
+      _exit(0);
+    }
+    if (pid < 0) {
+      int errNum = errno;
+      cerr << "ERROR - FmqBench::_runTest" << endl;
+      cerr << "  Cannot fork reader: " << strerror(errNum) << endl;
+      break;
+    }
+    pids.push_back(pid);
+  }
+  close(readyPipe[1]);
+  close(resultsPipe[1]);
+
+  // wait for the readers to open the queue
+
+  for (size_t ii = 0; ii < pids.size(); ii++) {
+    char ready;
+    if (read(readyPipe[0], &ready, 1) != 1) {
+      break;
+    }
+  }
+  close(readyPipe[0]);
+
+  // write the messages
+
+  vector<char> buf(_params.message_len);
+  double writeSecs = 0.0;
+  double maxWriteSecs = 0.0;
+  int iret = 0;
+
+  for (int ii = 0; ii < _params.n_messages; ii++) {
+    double start = _getTime();
+    _fillMessage(&buf[0], ii, start);
+    if (fmq.writeMsg(DATA_MSG, 0, &buf[0], buf.size())) {
+      cerr << "ERROR - FmqBench::_runTest" << endl;
+      cerr << "  Cannot write to fmq: " << _params.fmq_path << endl;
+      cerr << fmq.getErrStr() << endl;
+      iret = -1;
+      break;
+    }
+    double secs = _getTime() - start;
+    writeSecs += secs;
+    if (secs > maxWriteSecs) {
+      maxWriteSecs = secs;
+    }
+    if (_params.write_interval_usecs > 0) {
+      uusleep(_params.write_interval_usecs);
+    }
+  }
+  
+  // tell the readers we are done
+
+  fmq.writeMsg(END_MSG, 0, &buf[0], sizeof(msg_hdr_t));
+
+  // collect the results
+
+  vector<reader_results_t> results(pids.size());
+  for (size_t ii = 0; ii < pids.size(); ii++) {
+    if (read(resultsPipe[0], &results[ii], sizeof(reader_results_t)) !=
+        (ssize_t) sizeof(reader_results_t)) {
+      memset(&results[ii], 0, sizeof(reader_results_t));
+    }
+  }
+  close(resultsPipe[0]);
+  for (size_t ii = 0; ii < pids.size(); ii++) {
+    int status;
+    waitpid(pids[ii], &status, 0);
+  }
+
+  // print
+
+  if (results.size() == 0) {
+    _printResults(mode, writeSecs, maxWriteSecs, NULL);
+  }
+  for (size_t ii = 0; ii < results.size(); ii++) {
+    _printResults(mode, writeSecs, maxWriteSecs, &results[ii]);
+  }
+  fflush(stdout);
+
+  return iret;
+
+}
+
+//////////////////////////////////////////////////
+// Run a reader, in a child process.
+// Reads until the end message, checking each message.
+
+void FmqBench::_runReader(int readyFd, int resultsFd)
+{
+
+  reader_results_t results;
+  memset(&results, 0, sizeof(results));
+
+  Fmq fmq;
+  int iret = fmq.initReadOnly(_params.fmq_path, _progName.c_str(),
+                              _params.debug >= Params::DEBUG_VERBOSE,
+                              Fmq::START, _params.reader_msecs_sleep);
+  char ready = 1;
+  if (write(readyFd, &ready, 1) != 1 || iret) {
+    cerr << "ERROR - FmqBench::_runReader" << endl;
+    cerr << "  Cannot open fmq: " << _params.fmq_path << endl;
+    if (write(resultsFd, &results, sizeof(results))) {}
+    return;
+  }
+  close(readyFd);
+
+  // give up if there are no messages for a while, in case the
+  // end message has been missed
+
+  si64 expectedSeq = 0;
+  double lastReadTime = _getTime();
+  
+  while (_getTime() - lastReadTime < 10.0) {
+
+    // a read may fail if the writer overruns the reader,
+    // so carry on - missed messages are counted as skipped
+
+    bool gotOne = false;
+    if (fmq.readMsg(&gotOne, -1, _params.reader_msecs_sleep)) {
+      if (_params.debug >= Params::DEBUG_VERBOSE) {
+        cerr << "WARNING - FmqBench::_runReader" << endl;
+        cerr << "  Read failed, fmq: " << _params.fmq_path << endl;
+      }
+      continue;
+    }
+    if (!gotOne) {
+      continue;
+    }
+    double now = _getTime();
+    lastReadTime = now;
+
+    if (fmq.getMsgType() == END_MSG) {
+      results.gotEnd = true;
+      break;
+    }
+
+    results.nRead++;
+    msg_hdr_t hdr;
+    if (!_checkMessage((const char *) fmq.getMsg(), fmq.getMsgLen(), hdr)) {
+      results.nCorrupt++;
+      continue;
+    }
+    if (hdr.seqNum > expectedSeq) {
+      results.nSkipped += hdr.seqNum - expectedSeq;
+    }
+    expectedSeq = hdr.seqNum + 1;
+
+    double latency = now - hdr.writeTime;
+    results.sumLatency += latency;
+    if (latency > results.maxLatency) {
+      results.maxLatency = latency;
+    }
+
+  } // while
+
+  if (expectedSeq < _params.n_messages) {
+    results.nSkipped += _params.n_messages - expectedSeq;
+  }
+  
+  if (write(resultsFd, &results, sizeof(results)) != sizeof(results)) {
+    cerr << "ERROR - FmqBench::_runReader" << endl;
+    cerr << "  Cannot write results to pipe" << endl;
+  }
+  close(resultsFd);
+
+}
+
+//////////////////////////////////////////////////
+// Fill a message with the header and the fill pattern
+
+void FmqBench::_fillMessage(char *buf, si64 seqNum, double writeTime)
+{
+
+  msg_hdr_t hdr;
+  hdr.seqNum = seqNum;
+  hdr.writeTime = writeTime;
+  memcpy(buf, &hdr, sizeof(hdr));
+
+  for (int ii = sizeof(hdr); ii < _params.message_len; ii++) {
+    buf[ii] = (char) ((seqNum + ii) & 0xff);
+  }
+
+}
+
+//////////////////////////////////////////////////
+// Check a message against the fill pattern
+// Returns true if the message is intact
+
+bool FmqBench::_checkMessage(const char *buf, int len, msg_hdr_t &hdr)
+{
+
+  if (len != _params.message_len) {
+    return false;
+  }
+
+  memcpy(&hdr, buf, sizeof(hdr));
+  for (int ii = sizeof(hdr); ii < len; ii++) {
+    if (buf[ii] != (char) ((hdr.seqNum + ii) & 0xff)) {
+      return false;
+    }
+  }
+  return true;
+
+}
+
+//////////////////////////////////////////////////
+// Print the results line for a reader
+
+void FmqBench::_printResults(Params::writer_mode_t mode,
+                             double writeSecs,
+                             double maxWriteSecs,
+                             const reader_results_t *results)
+{
+
+  double nMessages = _params.n_messages;
+  double writeRate = 0.0, mbPerSec = 0.0;
+  if (writeSecs > 0) {
+    writeRate = nMessages / writeSecs;
+    mbPerSec = (nMessages * _params.message_len) / (writeSecs * 1.0e6);
+  }
+  double meanWriteUsecs = (writeSecs / nMessages) * 1.0e6;
+
+  reader_results_t noResults;
+  memset(&noResults, 0, sizeof(noResults));
+  if (results == NULL) {
+    results = &noResults;
+  }
+  double meanLatency = 0.0;
+  si64 nGood = results->nRead - results->nCorrupt;
+  if (nGood > 0) {
+    meanLatency = results->sumLatency / nGood;
+  }
+
+  fprintf(stdout, "%-14s %6s %10.0f %8.1f %9.2f %9.2f"
+          " %9ld %8ld %8ld %9.3f %9.3f\n",
+          _modeStr(mode), results->gotEnd ? "ok" : "noEnd",
+          writeRate, mbPerSec, meanWriteUsecs, maxWriteSecs * 1.0e6,
+          (long) results->nRead, (long) results->nSkipped,
+          (long) results->nCorrupt,
+          meanLatency * 1.0e3, results->maxLatency * 1.0e3);
+
+}
+
+//////////////////////////////////////////////////
+// get time in secs, with microsec precision
+
+double FmqBench::_getTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+//////////////////////////////////////////////////
+// string for writer mode
+
+const char *FmqBench::_modeStr(Params::writer_mode_t mode)
+{
+  switch (mode) {
+    case Params::SINGLE_WRITER:
+      return "SINGLE_WRITER";
+    case Params::LOCKED_WRITER:
+    default:
+      return "LOCKED_WRITER";
+  }
+}
@@ -0,0 +1,123 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// FmqBench.hh
+//
+// FmqBench object
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+//
+// FmqBench measures the throughput and latency of an FMQ.
+//
+// For each writer mode, the queue is created, the readers are
+// forked and the writer writes the messages. Each message
+// holds a sequence number, the write time and a fill pattern,
+// which the readers check for gaps and corruption. The readers
+// pass their results back to the parent through a pipe.
+//
+///////////////////////////////////////////////////////////////
+
+#ifndef FmqBench_H
+#define FmqBench_H
+
+#include <string>
+#include <dataport/port_types.h>
+#include "Args.hh"
+#include "Params.hh"
+using namespace std;
+
+////////////////////////
+// This class
+
+class FmqBench {
+  
+public:
+
+  // constructor
+
+  FmqBench (int argc, char **argv);
+
+  // destructor
+  
+  ~FmqBench();
+
+  // run 
+
+  int Run();
+
+  // data members
+
+  bool isOK;
+
+protected:
+  
+private:
+
+  // message types
+
+  static const int DATA_MSG = 0;
+  static const int END_MSG = 1;
+
+  // message header, followed by the fill pattern
+
+  typedef struct {
+    si64 seqNum;
+    fl64 writeTime;
+  } msg_hdr_t;
+
+  // results from a reader
+
+  typedef struct {
+    si64 nRead;
+    si64 nSkipped;
+    si64 nCorrupt;
+    fl64 sumLatency;
+    fl64 maxLatency;
+    bool gotEnd;
+  } reader_results_t;
+
+  string _progName;
+  char *_paramsPath;
+  Args _args;
+  Params _params;
+
+  int _runTest(Params::writer_mode_t mode);
+  void _runReader(int readyFd, int resultsFd);
+
+  void _fillMessage(char *buf, si64 seqNum, double writeTime);
+  bool _checkMessage(const char *buf, int len, msg_hdr_t &hdr);
+
+  void _printResults(Params::writer_mode_t mode,
+                     double writeSecs,
+                     double maxWriteSecs,
+                     const reader_results_t *results);
+  
+  static double _getTime();
+  static const char *_modeStr(Params::writer_mode_t mode);
+
+};
+
+#endif
@@ -375,38 +375,23 @@ int DsFmqServer::_performRead(DsFmqMsg &msg)
   }
   outMsg.clearAll();
 
-  // loop until we run out of data, we get more than
-  // 100 messages, or the total len exceeds a Mbyte
-
-  int count = 0;
-  int totLen = 0;
-  bool done = false;
-
-  while (!done) {
-
-    // read message
-
-    bool gotOne = false;
-    if (_fmq.readMsg(&gotOne, requestedType)) {
-      if (_sendReply(msg.getType(), -1, _fmq.getErrStr())) {
-	return -1;
-      }
+  // read the available data in a single batch, up to
+  // 100 messages or a total len of a Mbyte
+
+  vector<Fmq::MsgEntry> entries;
+  if (_fmq.readMsgs(entries,
+                    DsFmq::MAX_READ_NMESSAGES,
+                    DsFmq::MAX_READ_NBYTES,
+                    requestedType)) {
+    if (_sendReply(msg.getType(), -1, _fmq.getErrStr())) {
       return -1;
     }
+    return -1;
+  }
 
-    if (gotOne) {
-      outMsg.addReadData(_fmq);
-      count++;
-      totLen += _fmq.getMsgLen();
-    }
-
-    if (!gotOne ||
-	count > DsFmq::MAX_READ_NMESSAGES ||
-	totLen > DsFmq::MAX_READ_NBYTES) {
-      done = true;
-    }
-
-  } // while
+  for (size_t ii = 0; ii < entries.size(); ii++) {
+    outMsg.addReadData(entries[ii]);
+  }
   
   // assemble outgoing message
 
@@ -436,30 +421,23 @@ int DsFmqServer::_performWrite(DsFmqMsg &msg)
   const vector<void *> msgData = msg.getMsgData();
   const vector<DsFmqMsg::msgInfo_t> msgInfo = msg.getMsgInfo();
 
-  int iret = 0;
-    
-  for (int ii = 0; ii < (int) msgInfo.size(); ii++) {
+  // write the messages as a single batch
 
+  vector<Fmq::MsgEntry> entries;
+  for (int ii = 0; ii < (int) msgInfo.size(); ii++) {
+    Fmq::MsgEntry entry(msgInfo[ii].msgType,
+                        msgInfo[ii].msgSubtype,
+                        msgData[ii],
+                        msgInfo[ii].msgLen);
     if (msgInfo[ii].msgPreCompressed) {
-      int uncompLen = msgInfo[ii].msgUncompressedLen;
-      if (_fmq.writeMsgPreCompressed(msgInfo[ii].msgType,
-				     msgInfo[ii].msgSubtype,
-				     msgData[ii],
-				     msgInfo[ii].msgLen,
-				     uncompLen)) {
-	iret = -1;
-      }
-    } else {
-      if (_fmq.writeMsg(msgInfo[ii].msgType,
-			msgInfo[ii].msgSubtype,
-			msgData[ii],
-			msgInfo[ii].msgLen)) {
-	iret = -1;
-      }
+      entry.preCompressed = true;
+      entry.uncompressedLen = msgInfo[ii].msgUncompressedLen;
     }
-
+    entries.push_back(entry);
   } // ii
 
+  int iret = _fmq.writeMsgs(entries);
+
   if (iret == 0) {
     // success
     if (_sendReply(msg.getType(), 0, "")) {
@@ -34,8 +34,10 @@
 
 #include "Params.hh"
 #include "DsMdvServer.hh"
+#include "ReplyCache.hh"
 
 #include <toolsa/Path.hh>
+#include <toolsa/pmu.h>
 #include <dsserver/DsLocator.hh>
 #include <Mdv/DsMdvxMsg.hh>
 #include <Mdv/climo/DailyByYearFileFinder.hh>
@@ -64,7 +66,9 @@ DsMdvServer::DsMdvServer(string executableName,
                           params.run_read_only,
                           params.allow_http),
           _paramsOrig(params),
-          _climoFileFinder(0)
+          _climoFileFinder(0),
+          _replyCache(NULL),
+          _cacheStatsTime(0)
 
 {
     setNoThreadDebug(params.no_threads);
@@ -81,10 +85,89 @@ DsMdvServer::DsMdvServer(string executableName,
     }
 
     _createClimoObjects();
+
+    // set up the reply cache, one directory per port
+
+    if (params.use_reply_cache) {
+      string cacheDir = params.reply_cache_dir;
+      char portSubdir[64];
+      sprintf(portSubdir, "%sport_%d", PATH_DELIM, params.port);
+      cacheDir += portSubdir;
+      si64 maxBytes = (si64) (params.reply_cache_max_mbytes * 1.0e6);
+      _replyCache = new ReplyCache(cacheDir, maxBytes,
+                                   params.reply_cache_lock_wait_secs,
+                                   _isDebug);
+      _replyCache->clear();
+      _cacheStatsTime = time(NULL);
+      if (_isDebug) {
+        cerr << "Using reply cache, dir: " << cacheDir << endl;
+      }
+    }
+
 }
 
 DsMdvServer::~DsMdvServer()
 {
+  if (_replyCache) {
+    delete _replyCache;
+  }
+}
+
+//////////////////////////////////////////////////////
+// Override timeoutMethod and postHandlerMethod, to
+// report the cache statistics.
+// Both call the base class first, as required.
+
+bool DsMdvServer::timeoutMethod()
+{
+  bool shouldContinue = DsProcessServer::timeoutMethod();
+  _checkCacheStats();
+  return shouldContinue;
+}
+
+bool DsMdvServer::postHandlerMethod()
+{
+  bool shouldContinue = DsProcessServer::postHandlerMethod();
+  _checkCacheStats();
+  return shouldContinue;
+}
+
+//////////////////////////////////////////////////////
+// Report cache statistics to procmap, at the
+// specified interval
+
+void DsMdvServer::_checkCacheStats()
+{
+
+  if (_replyCache == NULL) {
+    return;
+  }
+
+  time_t now = time(NULL);
+  if (now - _cacheStatsTime < _paramsOrig.reply_cache_stats_interval_secs) {
+    return;
+  }
+  _cacheStatsTime = now;
+
+  ReplyCache::stats_t stats;
+  _replyCache->getStats(stats);
+
+  char statusStr[256];
+  sprintf(statusStr,
+          "Port %d, cache hits %lld, misses %lld, coalesced %lld, MB %.1f",
+          _paramsOrig.port,
+          (long long) stats.nHits, (long long) stats.nMisses,
+          (long long) stats.nCoalesced, stats.nBytes / 1.0e6);
+
+#ifndef DISABLE_PMU
+  PMU_force_register(statusStr);
+#endif
+
+  if (_isDebug) {
+    cerr << "Reply cache stats: " << statusStr << endl;
+    cerr << "  evictions: " << stats.nEvictions << endl;
+  }
+
 }
 
 // Handle data commands from the client.
@@ -50,6 +50,8 @@ class MdvFile;
 class DsMdvSocket;
 class DsMdvx;
 class ClimoFileFinder;
+class DsMdvxMsg;
+class ReplyCache;
 
 class DsMdvServer : public DsProcessServer {
   
@@ -65,6 +67,11 @@ protected:
     virtual int handleDataCommand(Socket * socket,
                                   const void * data, ssize_t dataSize);
   
+    // override to report cache statistics
+
+    virtual bool timeoutMethod();
+    virtual bool postHandlerMethod();
+  
 private:
 
   const Params &_paramsOrig;
@@ -72,6 +79,11 @@ private:
   string _incomingUrl;
 
   ClimoFileFinder *_climoFileFinder;
+
+  // cache for read replies
+
+  ReplyCache *_replyCache;
+  time_t _cacheStatsTime;
   
   // reading rhi azimuths
 
@@ -107,6 +119,15 @@ private:
 
   int _createClimoObjects();
   
+  // reply cache
+
+  bool _isCacheable(int subType, const DsMdvx &mdvx) const;
+  int _computeCacheKey(const DsMdvxMsg &msg, DsMdvx &mdvx,
+                       string &key, string &readPath, string &stamp);
+  int _computeFileStamp(const string &path, string &stamp);
+  int _sendReply(Socket *socket, const void *buf, ssize_t len);
+  void _checkCacheStats();
+  
   // set up and follow up on reads for headers, vol and vsection
   
   time_t _setupRead(DsMdvx &mdvx, bool readVolume);
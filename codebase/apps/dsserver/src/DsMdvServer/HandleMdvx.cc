@@ -34,12 +34,17 @@
 
 #include "Params.hh"
 #include "DsMdvServer.hh"
+#include "ReplyCache.hh"
 #include <Mdv/DsMdvx.hh>
 #include <Mdv/DsMdvxMsg.hh>
+#include <Mdv/MdvxTimeIndex.hh>
 #include <Mdv/climo/ClimoFileFinder.hh>
 #include <dsserver/DmapAccess.hh>
 #include <toolsa/TaStr.hh>
 #include <toolsa/pjg.h>
+#include <toolsa/MemBuf.hh>
+#include <didss/DsMsgPart.hh>
+#include <sys/stat.h>
 using namespace std;
 
 /////////////////////////////////////////////////////////
@@ -142,6 +147,34 @@ int DsMdvServer::handleMdvxCommand(Socket *socket,
     cerr << "  Client user: " << msg.getClientUser() << endl;
   }
 
+  // check the reply cache - if the reply is not there, lock the
+  // key so that identical requests wait for this one to complete
+
+  string cacheKey, cachePath, cacheStamp;
+  int cacheLock = -1;
+  if (_replyCache != NULL &&
+      _isCacheable(msg.getSubType(), mdvx) &&
+      _computeCacheKey(msg, mdvx, cacheKey, cachePath, cacheStamp) == 0) {
+    MemBuf cached;
+    if (_replyCache->lookup(cacheKey, cached)) {
+      if (_isDebug) {
+        cerr << "Reply cache hit" << endl;
+      }
+      _replyCache->countHit(false);
+      return _sendReply(socket, cached.getPtr(), cached.getLen());
+    }
+    cacheLock = _replyCache->lockKey(cacheKey);
+    if (_replyCache->lookup(cacheKey, cached)) {
+      // another client filled the cache while we waited
+      if (_isDebug) {
+        cerr << "Reply cache hit, after waiting on lock" << endl;
+      }
+      _replyCache->unlockKey(cacheLock);
+      _replyCache->countHit(true);
+      return _sendReply(socket, cached.getPtr(), cached.getLen());
+    }
+  }
+
   // handle major actions
   
   int iret = 0;
@@ -250,11 +283,39 @@ int DsMdvServer::handleMdvxCommand(Socket *socket,
     cerr << "==================================" << endl;
   }
   
-  // send reply
+  // store successful reply in cache, and release the key
 
   void *msgToSend = msg.assembledMsg();
   ssize_t msgLen = msg.lengthAssembled();
-  if (socket->writeMessage(0, msgToSend, msgLen)) {
+
+  if (cacheKey.size() > 0) {
+    // do not store if the file changed during the read, since
+    // the reply may not match the key
+    string stamp;
+    if (iret == 0 &&
+        _computeFileStamp(cachePath, stamp) == 0 && stamp == cacheStamp) {
+      _replyCache->store(cacheKey, msgToSend, msgLen);
+    }
+    _replyCache->countMiss();
+    _replyCache->unlockKey(cacheLock);
+  }
+
+  // send reply
+
+  return _sendReply(socket, msgToSend, msgLen);
+
+}
+
+//////////////////////////////////////////////
+// send reply to client
+//
+// Always returns 0
+
+int DsMdvServer::_sendReply(Socket *socket, const void *buf, ssize_t len)
+
+{
+
+  if (socket->writeMessage(0, buf, len)) {
     cerr << "ERROR - COMM -HandleMdvxCommand." << endl;
     cerr << "  Sending reply to client." << endl;
     cerr << socket->getErrStr() << endl;
@@ -268,6 +329,154 @@ int DsMdvServer::handleMdvxCommand(Socket *socket,
 
 }
 
+//////////////////////////////////////////////
+// check if the reply to this request may be cached
+//
+// Only volume and vsection reads from a single
+// local source are cached.
+
+bool DsMdvServer::_isCacheable(int subType, const DsMdvx &mdvx) const
+
+{
+
+  if (!_params.use_reply_cache) {
+    return false;
+  }
+
+  if (subType != DsMdvxMsg::MDVP_READ_VOLUME &&
+      subType != DsMdvxMsg::MDVP_READ_VSECTION) {
+    return false;
+  }
+
+  if (_params.serve_multiple_domains ||
+      _params.use_failover_urls ||
+      _params.use_climatology_url) {
+    return false;
+  }
+
+  if (subType == DsMdvxMsg::MDVP_READ_VSECTION && _params.serve_rhi_data) {
+    return false;
+  }
+
+  if (_params.handle_derived_fields && mdvx._readFieldNames.size() > 0) {
+    return false;
+  }
+
+  return true;
+
+}
+
+//////////////////////////////////////////////
+// compute the key for the reply cache
+//
+// The key is made up from the request message parts,
+// excluding the client details, plus the path, modify time
+// and size of the file which will be read.
+//
+// For a time-based request, the file found is then set as the
+// read dir, so that the read uses it without searching again.
+//
+// Returns 0 on success, -1 on failure
+
+int DsMdvServer::_computeCacheKey(const DsMdvxMsg &msg,
+                                  DsMdvx &mdvx,
+                                  string &key,
+                                  string &readPath,
+                                  string &stamp)
+  
+{
+
+  key.clear();
+
+  // request parts
+
+  char text[1024];
+  sprintf(text, "type %d subtype %d\n", msg.getType(), msg.getSubType());
+  key += text;
+
+  for (ssize_t ii = 0; ii < msg.getNParts(); ii++) {
+    const DsMsgPart *part = msg.getPart(ii);
+    int partType = part->getType();
+    if (partType == DsMdvxMsg::MDVP_CLIENT_USER_PART ||
+        partType == DsMdvxMsg::MDVP_CLIENT_HOST_PART ||
+        partType == DsMdvxMsg::MDVP_CLIENT_IPADDR_PART ||
+        partType == DsMdvxMsg::MDVP_APP_NAME_PART) {
+      continue;
+    }
+    sprintf(text, "part %d len %ld\n", partType, (long) part->getLength());
+    key += text;
+    key.append((const char *) part->getBuf(), part->getLength());
+  }
+
+  // find the file which would be read, using a copy of the
+  // request object, set up in the same way as for the read
+
+  DsMdvx probe(mdvx);
+  _setupRead(probe, msg.getSubType() == DsMdvxMsg::MDVP_READ_VOLUME);
+
+  DsURL url;
+  bool contactServer = false;
+  if (probe._resolveReadUrl(url, &contactServer) || contactServer) {
+    key.clear();
+    return -1;
+  }
+  if (probe._computeReadPath()) {
+    key.clear();
+    return -1;
+  }
+  readPath = probe._pathInUse;
+
+  if (_computeFileStamp(readPath, stamp)) {
+    key.clear();
+    return -1;
+  }
+  key += "\n";
+  key += stamp;
+  key += " path ";
+  key += readPath;
+
+  // Point the read dir at the file. Mdvx reads a read dir which is
+  // a file directly, and the search time and mode are kept for
+  // the reply. Carry over the gen time found by the search.
+  // The path must be fully qualified, so that it is not prefixed
+  // with RAP_DATA_DIR again when the URL is resolved.
+
+  if (mdvx._readTimeSet && !_params.use_static_file &&
+      (readPath[0] == '/' || readPath[0] == '.')) {
+    url.setFile(readPath);
+    mdvx._readDirUrl = url.getURLStr();
+    mdvx._genTimeForOverwrite = probe._genTimeForOverwrite;
+  }
+
+  return 0;
+
+}
+
+//////////////////////////////////////////////
+// compute the modify time and size of a file,
+// as a string for the cache key
+//
+// Returns 0 on success, -1 on failure
+
+int DsMdvServer::_computeFileStamp(const string &path, string &stamp)
+  
+{
+
+  struct stat fstat;
+  struct timespec mtime;
+  if (ta_stat(path.c_str(), &fstat) ||
+      MdvxTimeIndex::getModTime(path, mtime)) {
+    return -1;
+  }
+
+  char text[128];
+  sprintf(text, "mtime %ld.%.9ld size %ld",
+          (long) mtime.tv_sec, (long) mtime.tv_nsec, (long) fstat.st_size);
+  stamp = text;
+  return 0;
+
+}
+
 //////////////////////////////////////////////
 // setup read for headers, volume or vsection
 //
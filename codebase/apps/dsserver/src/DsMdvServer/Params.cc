@@ -725,6 +725,77 @@
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
     tt->param_name = tdrpStrDup("Comment 4");
+    tt->comment_hdr = tdrpStrDup("REPLY CACHE - READ OPERATIONS ONLY");
+    tt->comment_text = tdrpStrDup("Option to cache the encoded replies to volume and vertical section reads. Many displays request the same field and remap within seconds of each other. With the cache, the file is read, remapped and encoded once, and the following identical requests are served from the cache. The cache key includes the request details, and the path, modify time and size of the file which satisfies the request, so a new or changed file always causes a fresh read. Concurrent identical requests are coalesced into a single read. Caching is not used for derived fields, multiple domains, failover URLs, climatology or RHI data.");
+    tt++;
+    
+    // Parameter 'use_reply_cache'
+    // ctype is 'tdrp_bool_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = BOOL_TYPE;
+    tt->param_name = tdrpStrDup("use_reply_cache");
+    tt->descr = tdrpStrDup("Option to cache replies to read requests.");
+    tt->help = tdrpStrDup("");
+    tt->val_offset = (char *) &use_reply_cache - &_start_;
+    tt->single_val.b = pFALSE;
+    tt++;
+    
+    // Parameter 'reply_cache_dir'
+    // ctype is 'char*'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = STRING_TYPE;
+    tt->param_name = tdrpStrDup("reply_cache_dir");
+    tt->descr = tdrpStrDup("Directory for the reply cache.");
+    tt->help = tdrpStrDup("The server forks a child to handle each client, so the cache is shared between the children through files in this directory. It should be on a memory-backed file system, such as /dev/shm. A subdirectory is created for each server port.");
+    tt->val_offset = (char *) &reply_cache_dir - &_start_;
+    tt->single_val.s = tdrpStrDup("/dev/shm/DsMdvServer_cache");
+    tt++;
+    
+    // Parameter 'reply_cache_max_mbytes'
+    // ctype is 'double'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = DOUBLE_TYPE;
+    tt->param_name = tdrpStrDup("reply_cache_max_mbytes");
+    tt->descr = tdrpStrDup("Maximum size of the reply cache (MBytes).");
+    tt->help = tdrpStrDup("When the total size of cached replies exceeds this limit, the least recently used replies are removed, down to 90% of the limit.");
+    tt->val_offset = (char *) &reply_cache_max_mbytes - &_start_;
+    tt->single_val.d = 1000;
+    tt++;
+    
+    // Parameter 'reply_cache_lock_wait_secs'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("reply_cache_lock_wait_secs");
+    tt->descr = tdrpStrDup("Maximum wait for an identical request in progress (secs).");
+    tt->help = tdrpStrDup("A request which finds the same request already being read by another client waits for that reply, up to this time. After that it reads the data itself.");
+    tt->val_offset = (char *) &reply_cache_lock_wait_secs - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 0;
+    tt->single_val.i = 30;
+    tt++;
+    
+    // Parameter 'reply_cache_stats_interval_secs'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("reply_cache_stats_interval_secs");
+    tt->descr = tdrpStrDup("Interval for reporting cache statistics (secs).");
+    tt->help = tdrpStrDup("The hit and miss counts are included in the procmap status string at this interval, and printed in debug mode.");
+    tt->val_offset = (char *) &reply_cache_stats_interval_secs - &_start_;
+    tt->single_val.i = 60;
+    tt++;
+    
+    // Parameter 'Comment 5'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = COMMENT_TYPE;
+    tt->param_name = tdrpStrDup("Comment 5");
     tt->comment_hdr = tdrpStrDup("VERTICAL SECTIONS - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -765,11 +836,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 5'
+    // Parameter 'Comment 6'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 5");
+    tt->param_name = tdrpStrDup("Comment 6");
     tt->comment_hdr = tdrpStrDup("STATIC FILES - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("Option to serve out data from a static file if a time-based request is made.");
     tt++;
@@ -798,11 +869,11 @@
     tt->single_val.s = tdrpStrDup("none");
     tt++;
     
-    // Parameter 'Comment 6'
+    // Parameter 'Comment 7'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 6");
+    tt->param_name = tdrpStrDup("Comment 7");
     tt->comment_hdr = tdrpStrDup("FAILOVER OPTION - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -839,11 +910,11 @@
       tt->array_vals[1].s = tdrpStrDup("mdvp:://slowReliable::mdv/data");
     tt++;
     
-    // Parameter 'Comment 7'
+    // Parameter 'Comment 8'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 7");
+    tt->param_name = tdrpStrDup("Comment 8");
     tt->comment_hdr = tdrpStrDup("MULTIPLE DOMAINS - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -925,11 +996,11 @@
     tt->single_val.b = pTRUE;
     tt++;
     
-    // Parameter 'Comment 8'
+    // Parameter 'Comment 9'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 8");
+    tt->param_name = tdrpStrDup("Comment 9");
     tt->comment_hdr = tdrpStrDup("OVERRIDING ENCODING ON READ");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -970,20 +1041,20 @@
     tt->single_val.e = ENCODING_ASIS;
     tt++;
     
-    // Parameter 'Comment 9'
+    // Parameter 'Comment 10'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 9");
+    tt->param_name = tdrpStrDup("Comment 10");
     tt->comment_hdr = tdrpStrDup("OVERRIDING DATA SET SOURCE, NAME AND INFO - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("The following options allow you to override the data set source, name and info when reading. These will be replaced by the specified XML strings, for use by the client.");
     tt++;
     
-    // Parameter 'Comment 10'
+    // Parameter 'Comment 11'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 10");
+    tt->param_name = tdrpStrDup("Comment 11");
     tt->comment_hdr = tdrpStrDup("OVERRIDING DATA SET SOURCE, NAME AND INFO - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("The following options allow you to override the data set source, name and info when reading. These will be replaced by the specified XML strings, for use by the client.");
     tt++;
@@ -1060,11 +1131,11 @@
     tt->single_val.s = tdrpStrDup("<info></info>");
     tt++;
     
-    // Parameter 'Comment 11'
+    // Parameter 'Comment 12'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 11");
+    tt->param_name = tdrpStrDup("Comment 12");
     tt->comment_hdr = tdrpStrDup("REMAP TO LAT-LON - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("Option to remap the projection to a Lat-lon grid.");
     tt++;
@@ -1081,11 +1152,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 12'
+    // Parameter 'Comment 13'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 12");
+    tt->param_name = tdrpStrDup("Comment 13");
     tt->comment_hdr = tdrpStrDup("CONSTRAIN THE LEAD TIMES FOR FORECAST DATA - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("This option allows you to select only certain lead times to be served out. You can also specify that the search time be interpreted as the generate time.");
     tt++;
@@ -1138,11 +1209,11 @@
       tt->struct_vals[2].b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 13'
+    // Parameter 'Comment 14'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 13");
+    tt->param_name = tdrpStrDup("Comment 14");
     tt->comment_hdr = tdrpStrDup("CREATE COMPOSITE - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("Option to create a composite - max at any height.");
     tt++;
@@ -1159,11 +1230,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 14'
+    // Parameter 'Comment 15'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 14");
+    tt->param_name = tdrpStrDup("Comment 15");
     tt->comment_hdr = tdrpStrDup("DECIMATION - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -1192,11 +1263,11 @@
     tt->single_val.i = 1000000;
     tt++;
     
-    // Parameter 'Comment 15'
+    // Parameter 'Comment 16'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 15");
+    tt->param_name = tdrpStrDup("Comment 16");
     tt->comment_hdr = tdrpStrDup("MEASURED RHI DATA OPTION - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -1273,11 +1344,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 16'
+    // Parameter 'Comment 17'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 16");
+    tt->param_name = tdrpStrDup("Comment 17");
     tt->comment_hdr = tdrpStrDup("VERTICAL UNITS SPECIFICATION - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -1316,11 +1387,11 @@
     tt->single_val.e = HEIGHT_KM;
     tt++;
     
-    // Parameter 'Comment 17'
+    // Parameter 'Comment 18'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 17");
+    tt->param_name = tdrpStrDup("Comment 18");
     tt->comment_hdr = tdrpStrDup("DERIVED FIELDS - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("Creating derived fields on the fly.");
     tt++;
@@ -1518,11 +1589,11 @@
       tt->struct_vals[22].d = 0;
     tt++;
     
-    // Parameter 'Comment 18'
+    // Parameter 'Comment 19'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 18");
+    tt->param_name = tdrpStrDup("Comment 19");
     tt->comment_hdr = tdrpStrDup("CLIMATOLOGY DATA");
     tt->comment_text = tdrpStrDup("Option to serve out data from a climatology directory if a time-based request is made.");
     tt++;
@@ -1587,11 +1658,11 @@
     tt->single_val.s = tdrpStrDup("");
     tt++;
     
-    // Parameter 'Comment 19'
+    // Parameter 'Comment 20'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 19");
+    tt->param_name = tdrpStrDup("Comment 20");
     tt->comment_hdr = tdrpStrDup("FILLING IN REGIONS OF MISSING DATA - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -1608,11 +1679,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 20'
+    // Parameter 'Comment 21'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 20");
+    tt->param_name = tdrpStrDup("Comment 21");
     tt->comment_hdr = tdrpStrDup("SETTING VALID TIME SEARCH WEIGHT - READ OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("Only applies to forecast data sets stored in the gen_time/forecast_time format.");
     tt++;
@@ -1641,11 +1712,11 @@
     tt->single_val.d = 2.5;
     tt++;
     
-    // Parameter 'Comment 21'
+    // Parameter 'Comment 22'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 21");
+    tt->param_name = tdrpStrDup("Comment 22");
     tt->comment_hdr = tdrpStrDup("FORWARD ON WRITE - WRITE OPERATIONS ONLY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -1682,11 +1753,11 @@
       tt->array_vals[1].s = tdrpStrDup("mdvp:://remotehost::mdv/data/set1");
     tt++;
     
-    // Parameter 'Comment 22'
+    // Parameter 'Comment 23'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 22");
+    tt->param_name = tdrpStrDup("Comment 23");
     tt->comment_hdr = tdrpStrDup("OVERRIDE FORMAT for WRITES");
     tt->comment_text = tdrpStrDup("If set, these override the write format specified in the message from the client.\n\nFORMAT_MDV: normal legacy MDV format\n\nFORMAT_XML: XML format. XML data consists of 2 buffers/files: an XML text buffer for the headers/meta-data, and a data buffer for the data. NOTE: only COMPRESSION_NONE and COMPRESSION_GZIP_VOL are supported in XML. File extensions are .mdv.xml and .xml.buf\n\nFORMAT_NCF: netCDF CF format. File extension is .mdv.nc");
     tt++;
@@ -1725,11 +1796,11 @@
     tt->single_val.e = FORMAT_MDV;
     tt++;
     
-    // Parameter 'Comment 23'
+    // Parameter 'Comment 24'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 23");
+    tt->param_name = tdrpStrDup("Comment 24");
     tt->comment_hdr = tdrpStrDup("WRITE IN FORECAST PATH STYLE");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -1758,11 +1829,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 24'
+    // Parameter 'Comment 25'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 24");
+    tt->param_name = tdrpStrDup("Comment 25");
     tt->comment_hdr = tdrpStrDup("WRITE USING EXTENDED PATHS");
     tt->comment_text = tdrpStrDup("This will be overridden if the environment variable MDV_WRITE_USING_EXTENDED_PATHS exists and is set to TRUE.");
     tt++;
@@ -1779,11 +1850,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 25'
+    // Parameter 'Comment 26'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 25");
+    tt->param_name = tdrpStrDup("Comment 26");
     tt->comment_hdr = tdrpStrDup("NETCDF CF SUPPORT.");
     tt->comment_text = tdrpStrDup("The following parameters control conversion of MDV files to NetCDF CF-compliant files.");
     tt++;
@@ -504,6 +504,16 @@ public:
 
   tdrp_bool_t copy_message_memory;
 
+  tdrp_bool_t use_reply_cache;
+
+  char* reply_cache_dir;
+
+  double reply_cache_max_mbytes;
+
+  int reply_cache_lock_wait_secs;
+
+  int reply_cache_stats_interval_secs;
+
   tdrp_bool_t vsection_set_nsamples;
 
   int vsection_nsamples;
@@ -632,7 +642,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[95];
+  mutable TDRPtable _table[101];
 
   const char *_className;
 
@@ -0,0 +1,574 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 1990 - 2016
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+/////////////////////////////////////////////////////////////
+// ReplyCache.cc
+//
+// Cache of encoded DsMdvxMsg replies, for DsMdvServer.
+// See ReplyCache.hh for details.
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#include "ReplyCache.hh"
+#include <toolsa/file_io.h>
+#include <toolsa/ReadDir.hh>
+#include <toolsa/ta_crc32.h>
+#include <toolsa/Path.hh>
+#include <toolsa/uusleep.h>
+#include <algorithm>
+#include <vector>
+#include <set>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+using namespace std;
+
+// file name suffixes
+
+static const char *_entryExt = ".reply";
+static const char *_lockExt = ".lock";
+static const char *_statsName = "_cache_stats";
+static const char *_evictLockName = "_evict.lock";
+
+//////////////
+// Constructor
+
+ReplyCache::ReplyCache(const string &dir, si64 maxBytes,
+                       int lockWaitSecs, bool debug) :
+        _dir(dir),
+        _maxBytes(maxBytes),
+        _lockWaitSecs(lockWaitSecs),
+        _debug(debug)
+
+{
+  ta_makedir_recurse(_dir.c_str());
+}
+
+/////////////
+// Destructor
+
+ReplyCache::~ReplyCache()
+
+{
+}
+
+/////////////////////////////////////////////////////////
+// Remove all entries and reset the statistics.
+// Key locks held by other clients are left in place.
+
+void ReplyCache::clear()
+
+{
+
+  // exclude eviction while removing lock files
+
+  string evictLockPath = _dir + PATH_DELIM + _evictLockName;
+  int evictFd = open(evictLockPath.c_str(), O_RDWR | O_CREAT, 0666);
+  if (evictFd < 0) {
+    return;
+  }
+  flock(evictFd, LOCK_EX);
+
+  ReadDir rdir;
+  if (rdir.open(_dir.c_str()) == 0) {
+    struct dirent *dp;
+    for (dp = rdir.read(); dp != NULL; dp = rdir.read()) {
+      if (dp->d_name[0] == '.' || !strcmp(dp->d_name, _evictLockName)) {
+        continue;
+      }
+      string path = _dir + PATH_DELIM + dp->d_name;
+      if (_hasExt(dp->d_name, _lockExt)) {
+        _removeLock(path);
+      } else {
+        unlink(path.c_str());
+      }
+    }
+    rdir.close();
+  }
+
+  flock(evictFd, LOCK_UN);
+  close(evictFd);
+
+}
+
+/////////////////////////////////////////////////////////
+// Look up the reply for a key.
+// Returns true on hit, loading the reply into the buffer.
+
+bool ReplyCache::lookup(const string &key, MemBuf &reply)
+
+{
+
+  string path = _entryPath(key);
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  // read header and check it
+
+  entry_hdr_t hdr;
+  if (read(fd, &hdr, sizeof(hdr)) != (ssize_t) sizeof(hdr) ||
+      hdr.magic != _magicCookie ||
+      hdr.keyLen != (si64) key.size() ||
+      hdr.replyLen <= 0) {
+    close(fd);
+    return false;
+  }
+
+  // check the stored key - the file name is only a hash
+
+  MemBuf keyBuf;
+  char *storedKey = (char *) keyBuf.reserve(hdr.keyLen);
+  if (read(fd, storedKey, hdr.keyLen) != hdr.keyLen ||
+      memcmp(storedKey, key.c_str(), hdr.keyLen)) {
+    close(fd);
+    return false;
+  }
+
+  // read the reply
+
+  void *buf = reply.reserve(hdr.replyLen);
+  if (read(fd, buf, hdr.replyLen) != hdr.replyLen) {
+    close(fd);
+    reply.free();
+    return false;
+  }
+  close(fd);
+
+  // touch the entry, so that eviction is least-recently-used
+
+  utimes(path.c_str(), NULL);
+
+  return true;
+
+}
+
+/////////////////////////////////////////////////////////
+// Lock the key, to coalesce identical requests.
+// Waits while another client holds the lock, up to lockWaitSecs.
+// Returns lock handle on success, -1 on failure or timeout.
+
+int ReplyCache::lockKey(const string &key)
+
+{
+
+  string path = _lockPath(key);
+  time_t deadline = time(NULL) + _lockWaitSecs;
+
+  // The lock file may be removed by _removeLock() between the open
+  // and the lock, in which case we hold a lock on a file no other
+  // client can find. So check we locked the file at the path, and
+  // if not try again.
+
+  while (true) {
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd < 0) {
+      return -1;
+    }
+    while (flock(fd, LOCK_EX | LOCK_NB)) {
+      if (errno != EWOULDBLOCK || time(NULL) >= deadline) {
+        if (_debug) {
+          cerr << "WARNING - ReplyCache::lockKey" << endl;
+          cerr << "  Cannot lock key, file: " << path << endl;
+        }
+        close(fd);
+        return -1;
+      }
+      umsleep(10);
+    }
+    if (_isLinked(fd, path)) {
+      return fd;
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+  }
+
+}
+
+/////////////////////////////////////////////////////////
+// release the key lock
+
+void ReplyCache::unlockKey(int lockHandle)
+
+{
+  if (lockHandle >= 0) {
+    flock(lockHandle, LOCK_UN);
+    close(lockHandle);
+  }
+}
+
+/////////////////////////////////////////////////////////
+// Store the reply for a key, evicting old entries as needed.
+// Returns 0 on success, -1 on failure.
+
+int ReplyCache::store(const string &key, const void *reply, size_t len)
+
+{
+
+  if ((si64) len > _maxBytes) {
+    // will not fit
+    return -1;
+  }
+
+  // write to tmp file, then rename so that readers never
+  // see a partial entry
+
+  string path = _entryPath(key);
+  Path ppath(path);
+  string tmpPath = ppath.computeTmpPath();
+
+  int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    int errNum = errno;
+    if (_debug) {
+      cerr << "WARNING - ReplyCache::store" << endl;
+      cerr << "  Cannot create file: " << tmpPath << endl;
+      cerr << "  " << strerror(errNum) << endl;
+    }
+    return -1;
+  }
+
+  entry_hdr_t hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = _magicCookie;
+  hdr.version = 1;
+  hdr.keyLen = key.size();
+  hdr.replyLen = len;
+
+  bool ok =
+    (write(fd, &hdr, sizeof(hdr)) == (ssize_t) sizeof(hdr) &&
+     write(fd, key.c_str(), key.size()) == (ssize_t) key.size() &&
+     write(fd, reply, len) == (ssize_t) len);
+  close(fd);
+
+  if (!ok || rename(tmpPath.c_str(), path.c_str())) {
+    unlink(tmpPath.c_str());
+    return -1;
+  }
+
+  // scan the directory only when the running total is over the
+  // limit, or to correct the total after _scanInterval stores
+
+  if (_addStore(sizeof(hdr) + key.size() + len)) {
+    _evict();
+  }
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////
+// update the statistics
+
+void ReplyCache::countHit(bool coalesced)
+{
+  _updateStats(1, 0, coalesced ? 1 : 0, 0, 0, false);
+}
+
+void ReplyCache::countMiss()
+{
+  _updateStats(0, 1, 0, 0, 0, false);
+}
+
+/////////////////////////////////////////////////////////
+// read the statistics
+// Returns 0 on success, -1 on failure.
+
+int ReplyCache::getStats(stats_t &stats) const
+
+{
+
+  memset(&stats, 0, sizeof(stats));
+  string path = _statsPath();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  flock(fd, LOCK_SH);
+  ssize_t nRead = read(fd, &stats, sizeof(stats));
+  flock(fd, LOCK_UN);
+  close(fd);
+  if (nRead != (ssize_t) sizeof(stats)) {
+    memset(&stats, 0, sizeof(stats));
+    return -1;
+  }
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////
+// compute file name for key
+
+string ReplyCache::_computeName(const string &key) const
+
+{
+  char name[64];
+  snprintf(name, sizeof(name), "%.8x_%.8lx",
+           (unsigned int) ta_crc32(key.c_str(), key.size()),
+           (unsigned long) key.size());
+  return name;
+}
+
+string ReplyCache::_entryPath(const string &key) const
+{
+  return _dir + PATH_DELIM + _computeName(key) + _entryExt;
+}
+
+string ReplyCache::_lockPath(const string &key) const
+{
+  return _dir + PATH_DELIM + _computeName(key) + _lockExt;
+}
+
+string ReplyCache::_statsPath() const
+{
+  return _dir + PATH_DELIM + _statsName;
+}
+
+/////////////////////////////////////////////////////////
+// Remove least recently used entries until the total size
+// is within 90% of the limit, leaving room so that the next
+// stores do not each trigger a scan. Only one client evicts
+// at a time - others skip the check.
+
+void ReplyCache::_evict()
+
+{
+
+  string lockPath = _dir + PATH_DELIM + _evictLockName;
+  int lockFd = open(lockPath.c_str(), O_RDWR | O_CREAT, 0666);
+  if (lockFd < 0) {
+    return;
+  }
+  if (flock(lockFd, LOCK_EX | LOCK_NB)) {
+    // another client is evicting
+    close(lockFd);
+    return;
+  }
+
+  // gather entries, and the key lock files
+
+  class Entry {
+  public:
+    time_t mtime;
+    si64 size;
+    string name;
+    bool operator<(const Entry &other) const { return mtime < other.mtime; }
+  };
+  vector<Entry> entries;
+  vector<string> lockNames;
+  si64 totalBytes = 0;
+
+  ReadDir rdir;
+  if (rdir.open(_dir.c_str()) == 0) {
+    struct dirent *dp;
+    for (dp = rdir.read(); dp != NULL; dp = rdir.read()) {
+      if (_hasExt(dp->d_name, _lockExt) &&
+          strcmp(dp->d_name, _evictLockName)) {
+        lockNames.push_back(dp->d_name);
+        continue;
+      }
+      if (!_hasExt(dp->d_name, _entryExt)) {
+        continue;
+      }
+      string path = _dir + PATH_DELIM + dp->d_name;
+      struct stat fstat;
+      if (stat(path.c_str(), &fstat)) {
+        continue;
+      }
+      Entry entry;
+      entry.mtime = fstat.st_mtime;
+      entry.size = fstat.st_size;
+      entry.name = dp->d_name;
+      entries.push_back(entry);
+      totalBytes += fstat.st_size;
+    }
+    rdir.close();
+  }
+
+  // remove oldest first
+
+  si64 nEvicted = 0;
+  si64 targetBytes = (totalBytes > _maxBytes ? (_maxBytes / 10) * 9 : _maxBytes);
+  set<string> remaining;
+  sort(entries.begin(), entries.end());
+  for (size_t ii = 0; ii < entries.size(); ii++) {
+    const Entry &entry = entries[ii];
+    string base = entry.name.substr(0, entry.name.size() - strlen(_entryExt));
+    if (totalBytes > targetBytes) {
+      string path = _dir + PATH_DELIM + entry.name;
+      if (unlink(path.c_str()) == 0) {
+        totalBytes -= entry.size;
+        nEvicted++;
+        continue;
+      }
+    }
+    remaining.insert(base);
+  }
+  if (_debug && nEvicted > 0) {
+    cerr << "ReplyCache - evicted n entries: " << nEvicted << endl;
+  }
+
+  // remove the lock files for keys with no entry, unless held
+
+  for (size_t ii = 0; ii < lockNames.size(); ii++) {
+    const string &name = lockNames[ii];
+    string base = name.substr(0, name.size() - strlen(_lockExt));
+    if (remaining.find(base) == remaining.end()) {
+      _removeLock(_dir + PATH_DELIM + name);
+    }
+  }
+
+  _updateStats(0, 0, 0, nEvicted, totalBytes, true);
+
+  flock(lockFd, LOCK_UN);
+  close(lockFd);
+
+}
+
+/////////////////////////////////////////////////////////
+// Remove a key lock file, if no client holds the lock.
+// A client which opened the file before it was removed will
+// find in lockKey() that it is no longer linked, and open
+// the lock file again.
+
+void ReplyCache::_removeLock(const string &path)
+
+{
+  int fd = open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    return;
+  }
+  if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+    if (_isLinked(fd, path)) {
+      unlink(path.c_str());
+    }
+    flock(fd, LOCK_UN);
+  }
+  close(fd);
+}
+
+/////////////////////////////////////////////////////////
+// Check that an open file is still the file at the path.
+
+bool ReplyCache::_isLinked(int fd, const string &path)
+
+{
+  struct stat fdStat, pathStat;
+  if (fstat(fd, &fdStat) || stat(path.c_str(), &pathStat)) {
+    return false;
+  }
+  return (fdStat.st_dev == pathStat.st_dev &&
+          fdStat.st_ino == pathStat.st_ino);
+}
+
+/////////////////////////////////////////////////////////
+// Check for a file name extension.
+
+bool ReplyCache::_hasExt(const char *name, const char *ext)
+
+{
+  size_t nameLen = strlen(name);
+  size_t extLen = strlen(ext);
+  return (nameLen > extLen && !strcmp(name + nameLen - extLen, ext));
+}
+
+/////////////////////////////////////////////////////////
+// update the stats file, under lock
+
+void ReplyCache::_updateStats(si64 dHits, si64 dMisses, si64 dCoalesced,
+                              si64 dEvictions, si64 nBytes, bool setBytes)
+
+{
+
+  string path = _statsPath();
+  int fd = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+  if (fd < 0) {
+    return;
+  }
+  flock(fd, LOCK_EX);
+
+  stats_t stats;
+  if (pread(fd, &stats, sizeof(stats), 0) != (ssize_t) sizeof(stats)) {
+    memset(&stats, 0, sizeof(stats));
+  }
+  stats.nHits += dHits;
+  stats.nMisses += dMisses;
+  stats.nCoalesced += dCoalesced;
+  stats.nEvictions += dEvictions;
+  if (setBytes) {
+    stats.nBytes = nBytes;
+    stats.nStores = 0;
+  }
+  if (pwrite(fd, &stats, sizeof(stats), 0) != (ssize_t) sizeof(stats)) {
+    if (_debug) {
+      cerr << "WARNING - ReplyCache::_updateStats" << endl;
+      cerr << "  Cannot write stats file: " << path << endl;
+    }
+  }
+
+  flock(fd, LOCK_UN);
+  close(fd);
+
+}
+
+/////////////////////////////////////////////////////////
+// add a stored entry to the running totals, under lock
+// Returns true if the directory should be scanned.
+
+bool ReplyCache::_addStore(si64 nBytes)
+
+{
+
+  string path = _statsPath();
+  int fd = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+  if (fd < 0) {
+    return true;
+  }
+  flock(fd, LOCK_EX);
+
+  stats_t stats;
+  if (pread(fd, &stats, sizeof(stats), 0) != (ssize_t) sizeof(stats)) {
+    memset(&stats, 0, sizeof(stats));
+  }
+  stats.nBytes += nBytes;
+  stats.nStores++;
+  if (pwrite(fd, &stats, sizeof(stats), 0) != (ssize_t) sizeof(stats)) {
+    if (_debug) {
+      cerr << "WARNING - ReplyCache::_addStore" << endl;
+      cerr << "  Cannot write stats file: " << path << endl;
+    }
+  }
+
+  flock(fd, LOCK_UN);
+  close(fd);
+
+  return (stats.nBytes > _maxBytes || stats.nStores >= _scanInterval);
+
+}
@@ -0,0 +1,167 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 1990 - 2016
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+/////////////////////////////////////////////////////////////
+// ReplyCache.hh
+//
+// Cache of encoded DsMdvxMsg replies, for DsMdvServer.
+//
+// The server forks a child per client, so the cache cannot live
+// in the heap of a single process. Instead the replies are stored
+// as files in a cache directory, which should be on a memory-backed
+// file system such as /dev/shm, so that all children share them.
+//
+// Each entry is keyed on the normalized request plus the path,
+// modify time and size of the file which satisfies the request.
+// The full key is stored with the reply, and checked on lookup.
+//
+// Concurrent identical requests are coalesced: the first child
+// to miss takes an exclusive lock on the key, and the others wait
+// on the lock and then find the reply in the cache. The wait is
+// bounded - a client which times out reads the data itself.
+//
+// The cache is bounded in total size. A running total is kept in
+// the stats file, and when it exceeds the limit the directory is
+// scanned and the least recently used entries are removed, down to
+// 90% of the limit. The directory is also scanned after every
+// _scanInterval stores, to correct the total.
+// Key lock files with no entry are removed during the scan, but
+// only while no client holds them. A client whose lock file was
+// removed before it acquired the lock detects this and retries.
+//
+// Hit and miss counts are kept in a stats file in the cache dir.
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#ifndef _ReplyCache_HH
+#define _ReplyCache_HH
+
+#include <toolsa/MemBuf.hh>
+#include <dataport/port_types.h>
+#include <string>
+using namespace std;
+
+class ReplyCache {
+
+public:
+
+  // cache statistics
+
+  typedef struct {
+    si64 nHits;       // replies served from the cache
+    si64 nMisses;     // replies computed and stored
+    si64 nCoalesced;  // hits after waiting for another client's read
+    si64 nEvictions;  // entries removed to stay within size limit
+    si64 nBytes;      // total size of entries
+    si64 nStores;     // entries stored since the last scan
+  } stats_t;
+
+  // constructor
+  // dir: cache directory, created if it does not exist
+  // maxBytes: upper limit on total size of cached replies
+  // lockWaitSecs: max time to wait on a key lock
+
+  ReplyCache(const string &dir, si64 maxBytes,
+             int lockWaitSecs, bool debug);
+
+  // destructor
+
+  ~ReplyCache();
+
+  // Remove all entries and reset the statistics.
+  // Called at startup, since the params may have changed.
+
+  void clear();
+
+  // Look up the reply for a key.
+  // Returns true on hit, loading the reply into the buffer.
+
+  bool lookup(const string &key, MemBuf &reply);
+
+  // Lock the key, to coalesce identical requests.
+  // Waits while another client holds the lock, up to lockWaitSecs.
+  // Returns lock handle on success, -1 on failure or timeout.
+
+  int lockKey(const string &key);
+
+  // release the key lock
+
+  void unlockKey(int lockHandle);
+
+  // Store the reply for a key, evicting old entries as needed.
+  // Returns 0 on success, -1 on failure.
+
+  int store(const string &key, const void *reply, size_t len);
+
+  // update the statistics
+
+  void countHit(bool coalesced);
+  void countMiss();
+
+  // read the statistics
+  // Returns 0 on success, -1 on failure.
+
+  int getStats(stats_t &stats) const;
+
+  // get the cache directory
+
+  const string &getDir() const { return _dir; }
+
+protected:
+private:
+
+  string _dir;
+  si64 _maxBytes;
+  int _lockWaitSecs;
+  bool _debug;
+
+  // entry file header
+
+  typedef struct {
+    si32 magic;
+    si32 version;
+    si64 keyLen;
+    si64 replyLen;
+  } entry_hdr_t;
+
+  static const si32 _magicCookie = 0x4d444352; // "MDCR"
+  static const int _scanInterval = 1000;
+
+  string _computeName(const string &key) const;
+  string _entryPath(const string &key) const;
+  string _lockPath(const string &key) const;
+  string _statsPath() const;
+
+  void _evict();
+  void _removeLock(const string &path);
+  static bool _isLinked(int fd, const string &path);
+  static bool _hasExt(const char *name, const char *ext);
+  void _updateStats(si64 dHits, si64 dMisses, si64 dCoalesced,
+                    si64 dEvictions, si64 nBytes, bool setBytes);
+  bool _addStore(si64 nBytes);
+
+};
+
+#endif
@@ -86,6 +86,8 @@ int main(int argc, char **argv)
     
     if (params->noThreads) {
       _mgr->setNoThreadDebug(true);
+    } else if (params->nWorkerThreads > 0) {
+      _mgr->setWorkerPool(params->nWorkerThreads);
     }
     
     // set signal handling
@@ -651,6 +651,20 @@
     tt->single_val.i = 1024;
     tt++;
     
+    // Parameter 'nWorkerThreads'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("nWorkerThreads");
+    tt->descr = tdrpStrDup("Number of worker threads for serving clients.");
+    tt->help = tdrpStrDup("If 0, a thread is created for each client. If positive, a fixed pool of worker threads is used, and connections are watched with epoll between requests. This suits clients which use keep-alive connections, see DS_KEEP_ALIVE.");
+    tt->val_offset = (char *) &nWorkerThreads - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 0;
+    tt->single_val.i = 0;
+    tt++;
+    
     // Parameter 'runSecure'
     // ctype is 'tdrp_bool_t'
     
@@ -379,6 +379,8 @@ public:
 
   int maxClients;
 
+  int nWorkerThreads;
+
   tdrp_bool_t runSecure;
 
   tdrp_bool_t mdvReadOnly;
@@ -392,7 +394,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[11];
+  mutable TDRPtable _table[12];
 
   const char *_className;
 
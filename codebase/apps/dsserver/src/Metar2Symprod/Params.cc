@@ -856,6 +856,18 @@
       tt->struct_vals[3].f = 180;
     tt++;
     
+    // Parameter 'bbox_on_get'
+    // ctype is 'tdrp_bool_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = BOOL_TYPE;
+    tt->param_name = tdrpStrDup("bbox_on_get");
+    tt->descr = tdrpStrDup("Option to skip stations outside the horizontal limits when reading the data base.");
+    tt->help = tdrpStrDup("If TRUE, and horizontal limits are set by the client or by useBoundingBox, the SPDB get is constrained to chunks whose stored position lies within the limits, so that the other chunks are not read. Requires the data to be written with positions, as done by Metar2Spdb. Chunks written without positions are always read. Not used if the limits span the international date line.");
+    tt->val_offset = (char *) &bbox_on_get - &_start_;
+    tt->single_val.b = pFALSE;
+    tt++;
+    
     // Parameter 'decimate_spatially'
     // ctype is 'tdrp_bool_t'
     
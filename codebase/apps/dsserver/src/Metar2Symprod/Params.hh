@@ -496,6 +496,8 @@ public:
 
   bounding_box_t bounding_box;
 
+  tdrp_bool_t bbox_on_get;
+
   tdrp_bool_t decimate_spatially;
 
   int decimate_n_lat;
@@ -635,7 +637,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[95];
+  mutable TDRPtable _table[96];
 
   const char *_className;
 
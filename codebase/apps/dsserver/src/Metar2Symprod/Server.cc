@@ -121,6 +121,10 @@ Server::loadLocalParams( const string &paramFile, void **serverParams)
      _horizLimitsSet = true;
    }
 
+   // constrain the get to the limits, if requested
+
+   setBboxFromHorizLimits(localParams->bbox_on_get);
+
    if (_isDebug && _horizLimitsSet){
      cerr << "Horizontal limits set." << endl;
      cerr << "  Min lat: " << _minLat << endl;
@@ -86,6 +86,7 @@ int Args::parse(int argc, char **argv, string &prog_name)
   respectZeroTypes = false;
   horizLimitsSet = false;
   vertLimitsSet = false;
+  bboxOnGet = false;
   timeListMinInterval = 1;
   threaded = false;
   checkWriteTimeOnGet = false;
@@ -339,6 +340,19 @@ int Args::parse(int argc, char **argv, string &prog_name)
 	iret = -1;
       }
       
+    } else if (!strcmp(argv[i], "-bbox")) {
+      
+      if (i < argc - 1) {
+	if (sscanf(argv[++i], "%lg %lg %lg %lg",
+		   &bboxMinLat, &bboxMinLon, &bboxMaxLat, &bboxMaxLon) != 4) {
+	  iret = -1;
+	} else {
+	  bboxOnGet = true;
+	}
+      } else {
+	iret = -1;
+      }
+      
     } else if (!strcmp(argv[i], "-vlimits")) {
       
       if (i < argc - 1) {
@@ -569,6 +583,10 @@ void Args::_usage(ostream &out)
       << "     Only applicable to queries to servers which support this\n"
       << "     feature e.g. Metar2Symprod.\n"
       << "\n"
+      << "  [ -bbox \"min_lat min_lon max_lat max_lon\" ] only get chunks\n"
+      << "     whose stored bounding box overlaps this box.\n"
+      << "     Chunks stored without a bounding box are always returned.\n"
+      << "\n"
       << "  [ -threaded ] use threading for testing\n"
       << "    Uses DsSpdbThreaded object instead of DsSpdb object\n"
       << "\n"
@@ -82,6 +82,9 @@ public:
   bool vertLimitsSet;
   double minHt, maxHt;
 
+  bool bboxOnGet;
+  double bboxMinLat, bboxMinLon, bboxMaxLat, bboxMaxLon;
+
   bool respectZeroTypes;
   bool threaded;
 
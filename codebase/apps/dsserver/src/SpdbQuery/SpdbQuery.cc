@@ -139,6 +139,10 @@ int SpdbQuery::_doDataType(int dataType,
   if (_args.vertLimitsSet) {
     spdb->setVertLimits(_args.minHt, _args.maxHt);
   }
+  if (_args.bboxOnGet) {
+    spdb->setBboxOnGet(_args.bboxMinLat, _args.bboxMinLon,
+                       _args.bboxMaxLat, _args.bboxMaxLon);
+  }
   if (_args.auxXmlPath.size() > 0) {
     _setAuxXml(spdb);
   }
@@ -368,11 +368,18 @@ int Metar2Spdb::_processFile(const char *file_path,
 
         int stationId = Spdb::hash4CharsToInt32(stationName.c_str());
 
+        // station position, stored with each chunk so that
+        // spatially-constrained gets can skip it
+
+        const StationLoc &stationLoc = _locations[stationName];
+
         if (_params.write_decoded_metars) {
           spdbDecoded.addPutChunk(stationId,
                                   valid_time,
                                   valid_time + _params.expire_seconds,
                                   buf.getLen(), buf.getPtr());
+          spdbDecoded.setPutChunkBbox(stationLoc.lat, stationLoc.lon,
+                                      stationLoc.lat, stationLoc.lon);
         }
 
         if (_params.write_ascii_metars) {
@@ -386,6 +393,8 @@ int Metar2Spdb::_processFile(const char *file_path,
                                 valid_time + _params.expire_seconds,
                                 metarMessage.size() + 1,
                                 metarMessage.c_str());
+          spdbAscii.setPutChunkBbox(stationLoc.lat, stationLoc.lon,
+                                    stationLoc.lat, stationLoc.lon);
         }
       } /* endif - _decodeMetar(...) == 0) */
 
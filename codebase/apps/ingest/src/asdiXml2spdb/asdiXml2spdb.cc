@@ -59,6 +59,11 @@ asdiXml2spdb::asdiXml2spdb(Params *tdrpParams){
   memset(_asciiBuffer,  0, _asciiBufferLen);
   memset(_asciiBuffer2,  0, _asciiBufferLen);
   _spdbRoute.setPutMode(Spdb::putModeAdd);
+  if (_params->routeGroupCommitMsecs > 0) {
+    _spdbRoute.setPutGroupCommit(_params->routeGroupCommitMaxRoutes,
+				 _params->routeGroupCommitMsecs);
+  }
+  _routesPending = false;
 
   _route = NULL;
 
@@ -89,8 +94,43 @@ void asdiXml2spdb::flush()
       fprintf(stderr,"ERROR: Failed to put data\n");
       return;
     }    
+    _routesPending = false;
+    if (_spdbRoute.flushPuts()){
+      fprintf(stderr,"ERROR: Failed to flush route data\n");
+      return;
+    }
+  }
+
+}
+
+//
+// Merge routes in the group commit journal into the index,
+// so that readers see them.
+//
+void asdiXml2spdb::_flushRoutes()
+{
+  if (!_routesPending) {
+    return;
   }
+  _routesPending = false;
+  if (_spdbRoute.flushPuts()){
+    fprintf(stderr,"ERROR: Failed to flush route data\n");
+  }
+}
 
+//
+// Time since routes were first put to the journal (msecs),
+// 0 if none are pending.
+//
+int asdiXml2spdb::_msecsRoutesPending()
+{
+  if (!_routesPending) {
+    return 0;
+  }
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (now.tv_sec - _routesPendingTime.tv_sec) * 1000 +
+    (now.tv_usec - _routesPendingTime.tv_usec) / 1000;
 }
 
 void asdiXml2spdb::File(char *FilePath)
@@ -142,6 +182,11 @@ void asdiXml2spdb::File(char *FilePath)
   }
 
   fclose(_fp);
+
+  //
+  // Make the routes from this file visible to readers.
+  //
+  _flushRoutes();
 }
 
 void asdiXml2spdb::Stream()
@@ -219,6 +264,9 @@ void asdiXml2spdb::Stream()
 	if(iret == Z_STREAM_END) {
 	  //cout << xmlBuf << endl << endl;
 	  _processAsdiXml(xmlBuf);
+	  if (_msecsRoutesPending() >= _params->routeGroupCommitMsecs) {
+	    _flushRoutes();
+	  }
 	} else {
 	  
 	}
@@ -2170,6 +2218,10 @@ bool asdiXml2spdb::_saveRouteToSPDB(const si32 data_type, const time_t valid_tim
       return false;
     }
     _spdbRoute.clearPutChunks();
+    if (_params->routeGroupCommitMsecs > 0 && !_routesPending) {
+      _routesPending = true;
+      gettimeofday(&_routesPendingTime, NULL);
+    }
   }
   return true;
 }
@@ -2460,6 +2512,19 @@ int asdiXml2spdb::_readFromSocket(char *buffer, int numbytes)
 {
 
   int retVal;
+
+  //
+  // If routes are waiting in the group commit journal, merge
+  // them if nothing arrives before they are due.
+  //
+  if (_routesPending) {
+    int waitMsecs = _params->routeGroupCommitMsecs - _msecsRoutesPending();
+    if (waitMsecs <= 0 ||
+	(_S.readSelect(waitMsecs) && _S.getErrNum() == Socket::TIMED_OUT)) {
+      _flushRoutes();
+    }
+  }
+
   if (_S.readSelectPmu(60))
   {
 
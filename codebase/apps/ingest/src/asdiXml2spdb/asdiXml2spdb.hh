@@ -28,6 +28,7 @@
 
 
 #include <cstdio>
+#include <sys/time.h>
 #include <toolsa/Socket.hh>
 #include <Spdb/DsSpdb.hh>
 #include <tinyxml/tinystr.h>
@@ -88,6 +89,8 @@ private:
   bool _saveRouteToSPDB(const si32 data_type, const time_t valid_time,
 			const time_t expire_time, const int chunk_len,
 			const void *chunk_data, const si32 data_type2);
+  void _flushRoutes();
+  int _msecsRoutesPending();
 
   void _parseTZ(TiXmlElement* TZ, date_time_t T);
   void _parseFZ(TiXmlElement* FZ, date_time_t T);
@@ -129,6 +132,10 @@ private:
   int _spdbRouteBufferCount;
   DsSpdb _spdbRoute;
 
+  // routes put to the group commit journal, not yet merged
+  bool _routesPending;
+  struct timeval _routesPendingTime;
+
   const static int _asciiBufferLen = 8192;
   char _asciiBuffer[_asciiBufferLen];
   char _asciiBuffer2[_asciiBufferLen];
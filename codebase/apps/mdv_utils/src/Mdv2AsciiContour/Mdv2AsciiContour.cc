@@ -115,6 +115,11 @@ int Mdv2AsciiContour::Process(Mdvx::master_header_t Mhdr,
   // Now that we have a byte array, call the EG routines to
   // get the contour in indicie space.
   //
+  // The EG routines give one closed outline per clump, along
+  // the grid cell edges, which is what the output format and the
+  // clump size filter expect. This is for a single threshold, so
+  // the multi-level MarchingSquaresContourAlg is not used here.
+  //
 
   int i;  		/* counters */
   int num_intervals = 0;
@@ -50,6 +50,7 @@
 #include <contour/BinarySmoother.hh>
 #include <contour/Contour.hh>
 #include <contour/DouglasPeuckerSmoother.hh>
+#include <contour/MarchingSquaresContourAlg.hh>
 #include <contour/SimpleBoundaryContourAlg.hh>
 #include <dsdata/DsLdataTrigger.hh>
 #include <dsdata/DsTimeListTrigger.hh>
@@ -287,6 +288,13 @@ bool MdvContour::init()
 				   _params->debug);
     break;
 
+  case Params::MARCHING_SQUARES_CONTOUR_ALG :
+    _contourAlg =
+      new MarchingSquaresContourAlg(_params->marching_squares_alg_params.n_threads,
+				    _params->marching_squares_alg_params.simplify_tolerance,
+				    _params->debug);
+    break;
+
   }
   
   // Create the contour smoother algorithm object
@@ -308,10 +316,12 @@ bool MdvContour::init()
     } /* endswitch - _params->smoother_type */
   }
 
-  // Save the specified contour level.  We put it into a vector with a
-  // single level since the contouring algorithms take a vector
+  // Save the specified contour levels.  The contouring algorithms take
+  // a vector of levels.
 
   _contourLevels.push_back(_params->contour_level);
+  for (int i = 0; i < _params->extra_contour_levels_n; ++i)
+    _contourLevels.push_back(_params->_extra_contour_levels[i]);
   
   // initialize process registration
 
@@ -394,6 +404,14 @@ bool MdvContour::_processData(TriggerInfo &trigger_info)
   
   Mdvx::field_header_t field_hdr = mdv_field->getFieldHeader();
   
+  if (_params->contour_alg_type == Params::MARCHING_SQUARES_CONTOUR_ALG)
+  {
+    MarchingSquaresContourAlg *ms_alg =
+      (MarchingSquaresContourAlg *)_contourAlg;
+    ms_alg->setMissingDataValue(field_hdr.missing_data_value);
+    ms_alg->setBadDataValue(field_hdr.bad_data_value);
+  }
+  
   Contour *contour =
     _contourAlg->generateContour(field_hdr.nx, field_hdr.ny,
 				 field_hdr.grid_dx, field_hdr.grid_dy,
@@ -536,7 +554,7 @@ bool MdvContour::_writeContour(const Contour &contour,
       polygon.setExpireTime(expire_time);
     
       polygon.addFieldInfo("contour level", units);
-      polygon.addVal(_params->contour_level);
+      polygon.addVal(contour_level->getLevelValue());
       
       polygon.assemble();
     
@@ -739,14 +739,16 @@
     tt->ptype = ENUM_TYPE;
     tt->param_name = tdrpStrDup("contour_alg_type");
     tt->descr = tdrpStrDup("Type of algorithm to use for contouring");
-    tt->help = tdrpStrDup("");
+    tt->help = tdrpStrDup("\tSIMPLE_BOUNDARY_CONTOUR_ALG - Clump the grid at each level and use the clump boundaries as the contours. The levels are processed one at a time.\n\tMARCHING_SQUARES_CONTOUR_ALG - Interpolate the contours between the grid points using marching squares. All of the levels are contoured in a single pass over the grid, and the grid may be processed in parallel. Grid cells with missing data are not contoured.\n");
     tt->val_offset = (char *) &contour_alg_type - &_start_;
     tt->enum_def.name = tdrpStrDup("contour_alg_type_t");
-    tt->enum_def.nfields = 1;
+    tt->enum_def.nfields = 2;
     tt->enum_def.fields = (enum_field_t *)
         tdrpMalloc(tt->enum_def.nfields * sizeof(enum_field_t));
       tt->enum_def.fields[0].name = tdrpStrDup("SIMPLE_BOUNDARY_CONTOUR_ALG");
       tt->enum_def.fields[0].val = SIMPLE_BOUNDARY_CONTOUR_ALG;
+      tt->enum_def.fields[1].name = tdrpStrDup("MARCHING_SQUARES_CONTOUR_ALG");
+      tt->enum_def.fields[1].val = MARCHING_SQUARES_CONTOUR_ALG;
     tt->single_val.e = SIMPLE_BOUNDARY_CONTOUR_ALG;
     tt++;
     
@@ -780,6 +782,36 @@
       tt->struct_vals[1].i = 10;
     tt++;
     
+    // Parameter 'marching_squares_alg_params'
+    // ctype is '_marching_squares_alg_params_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = STRUCT_TYPE;
+    tt->param_name = tdrpStrDup("marching_squares_alg_params");
+    tt->descr = tdrpStrDup("Parameters used with the marching squares contouring algorithm");
+    tt->help = tdrpStrDup("Only used if contour_alg_type is set to MARCHING_SQUARES_CONTOUR_ALG.\n\tn_threads - number of threads used to contour the grid. The grid is split into bands of rows which are contoured in parallel and then stitched together. If 1, no threads are used. The output does not depend on the number of threads.\n\tsimplify_tolerance - Douglas-Peucker tolerance, in grid cells, used to remove points from the contours. Because it is applied in grid space, this is independent of the projection. If 0, the contours are not simplified.\n");
+    tt->val_offset = (char *) &marching_squares_alg_params - &_start_;
+    tt->struct_def.name = tdrpStrDup("marching_squares_alg_params_t");
+    tt->struct_def.nfields = 2;
+    tt->struct_def.fields = (struct_field_t *)
+        tdrpMalloc(tt->struct_def.nfields * sizeof(struct_field_t));
+      tt->struct_def.fields[0].ftype = tdrpStrDup("int");
+      tt->struct_def.fields[0].fname = tdrpStrDup("n_threads");
+      tt->struct_def.fields[0].ptype = INT_TYPE;
+      tt->struct_def.fields[0].rel_offset = 
+        (char *) &marching_squares_alg_params.n_threads - (char *) &marching_squares_alg_params;
+      tt->struct_def.fields[1].ftype = tdrpStrDup("double");
+      tt->struct_def.fields[1].fname = tdrpStrDup("simplify_tolerance");
+      tt->struct_def.fields[1].ptype = DOUBLE_TYPE;
+      tt->struct_def.fields[1].rel_offset = 
+        (char *) &marching_squares_alg_params.simplify_tolerance - (char *) &marching_squares_alg_params;
+    tt->n_struct_vals = 2;
+    tt->struct_vals = (tdrpVal_t *)
+        tdrpMalloc(tt->n_struct_vals * sizeof(tdrpVal_t));
+      tt->struct_vals[0].i = 1;
+      tt->struct_vals[1].d = 0;
+    tt++;
+    
     // Parameter 'smooth_contours'
     // ctype is 'tdrp_bool_t'
     
@@ -872,6 +904,24 @@
     tt->single_val.d = 3.5;
     tt++;
     
+    // Parameter 'extra_contour_levels'
+    // ctype is 'double'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = DOUBLE_TYPE;
+    tt->param_name = tdrpStrDup("extra_contour_levels");
+    tt->descr = tdrpStrDup("Additional contour levels for the data");
+    tt->help = tdrpStrDup("These levels are contoured along with contour_level, and each output polygon is tagged with its own level. The marching squares algorithm contours all of the levels in a single pass over the grid.");
+    tt->array_offset = (char *) &_extra_contour_levels - &_start_;
+    tt->array_n_offset = (char *) &extra_contour_levels_n - &_start_;
+    tt->is_array = TRUE;
+    tt->array_len_fixed = FALSE;
+    tt->array_elem_size = sizeof(double);
+    tt->array_n = 0;
+    tt->array_vals = (tdrpVal_t *)
+        tdrpMalloc(tt->array_n * sizeof(tdrpVal_t));
+    tt++;
+    
     // trailing entry has param_name set to NULL
     
     tt->param_name = NULL;
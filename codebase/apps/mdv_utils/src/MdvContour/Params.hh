@@ -74,7 +74,8 @@ public:
   } trigger_mode_t;
 
   typedef enum {
-    SIMPLE_BOUNDARY_CONTOUR_ALG = 0
+    SIMPLE_BOUNDARY_CONTOUR_ALG = 0,
+    MARCHING_SQUARES_CONTOUR_ALG = 1
   } contour_alg_type_t;
 
   typedef enum {
@@ -99,6 +100,11 @@ public:
     int min_num_poly_pts;
   } simple_bdry_alg_params_t;
 
+  typedef struct {
+    int n_threads;
+    double simplify_tolerance;
+  } marching_squares_alg_params_t;
+
   typedef struct {
     double epsilon;
   } douglas_peucker_params_t;
@@ -421,6 +427,8 @@ public:
 
   simple_bdry_alg_params_t simple_bdry_alg_params;
 
+  marching_squares_alg_params_t marching_squares_alg_params;
+
   tdrp_bool_t smooth_contours;
 
   smoother_type_t smoother_type;
@@ -431,6 +439,9 @@ public:
 
   double contour_level;
 
+  double *_extra_contour_levels;
+  int extra_contour_levels_n;
+
   char _end_; // end of data region
               // needed for zeroing out data
 
@@ -438,7 +449,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[20];
+  mutable TDRPtable _table[22];
 
   const char *_className;
 
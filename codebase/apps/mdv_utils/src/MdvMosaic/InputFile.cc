@@ -67,6 +67,11 @@ InputFile::InputFile(char *prog_name, MdvMosaic_tdrp_struct *params,
   //MCP perhaps move this initialization into _computeXYLut if we can...?
   _xyLut = (long *) umalloc(2 * 2 * sizeof(long));
   _zLut = (int *) umalloc(_outputGrid->nz * sizeof(int));
+
+  int nFields = _params->field_list.len;
+  _fieldMin = (double *) ucalloc_min_1(nFields, sizeof(double));
+  _fieldMax = (double *) ucalloc_min_1(nFields, sizeof(double));
+  _fieldHasData = (int *) ucalloc_min_1(nFields, sizeof(int));
 	 
 }
 
@@ -82,6 +87,9 @@ InputFile::~InputFile()
   MDV_free_handle(&_handle);
   ufree(_xyLut);
   ufree(_zLut);
+  ufree(_fieldMin);
+  ufree(_fieldMax);
+  ufree(_fieldHasData);
 
 }
 
@@ -132,6 +140,15 @@ int InputFile::read(time_t request_time)
     }
   }
 
+  // compute min and max for each field, so that the scale and
+  // bias computations do not need to scan the data again
+
+  for (int i = 0; i < _params->field_list.len; i++) {
+    _fieldHasData[i] =
+      (_computeMinAndMax(_params->field_list.val[i],
+			 _fieldMin + i, _fieldMax + i) == 0);
+  }
+
   readSuccess = TRUE;
   return (0);
 
@@ -145,6 +162,33 @@ int InputFile::read(time_t request_time)
 
 int InputFile::getMinAndMax(int field_num, double *min_p, double *max_p)
 
+{
+
+  for (int i = 0; i < _params->field_list.len; i++) {
+    if (_params->field_list.val[i] == field_num) {
+      if (!_fieldHasData[i]) {
+	return (-1);
+      }
+      *min_p = _fieldMin[i];
+      *max_p = _fieldMax[i];
+      return (0);
+    }
+  }
+
+  // not in field list, compute it now
+
+  return (_computeMinAndMax(field_num, min_p, max_p));
+
+}
+
+//////////////////////////////////
+// compute min and max for given field
+//
+// Returns 0 on success, -1 on failure
+//
+
+int InputFile::_computeMinAndMax(int field_num, double *min_p, double *max_p)
+
 {
 
   int min_byte = 256;
@@ -207,10 +251,14 @@ void InputFile::updateTimes(time_t *start_time_p, time_t *end_time_p)
 /////////////////////////////////////
 // load field data into output handle
 //
+// Only output rows start_row through end_row are merged, so that
+// the output grid may be divided into bands which are merged
+// in parallel.
 
 void InputFile::mergeField(int in_field,
 			   MDV_handle_t *outHandle, mdv_grid_t *outGrid,
-			   int out_field, double out_scale, double out_bias)
+			   int out_field, double out_scale, double out_bias,
+			   int start_row, int end_row)
 
 {
 
@@ -233,6 +281,15 @@ void InputFile::mergeField(int in_field,
     }
   }
 
+  // restrict the rows to the portion of the output grid
+  // where we have lut info
+
+  int lut_start_row = MAX(start_row, _out_lut_miny_idx);
+  int lut_end_row = MIN(end_row, _out_lut_miny_idx + _out_lut_ny - 1);
+  if (lut_start_row > lut_end_row) {
+    return;
+  }
+
   // loop through output planes
 
   for (int iz = 0; iz < outGrid->nz; iz++) {
@@ -242,57 +299,43 @@ void InputFile::mergeField(int in_field,
       continue;
     }
 
-    // set up pointers to planes and XY lookup table
+    // set up pointers to planes
 
     ui08 *inPlane = (ui08 *) _handle.field_plane[in_field][in_z];
     ui08 *outPlane = (ui08 *) outHandle->field_plane[out_field][iz];
 
-    // How do we know this is the "correct" _xyLut lookup table?
-    // Goes with current InputFile object?
-    long *xylut = _xyLut;
-    
     // loop through points in output plane, merging in the input
     // data if it exceeds the value already in the plane
 
-    ui08 *outbp = outPlane;
- // for (int i = 0; i < _grid.nx * _grid.ny; i++, xylut++) {
- // for (int i = 0; i < out_lut_nx * out_lut_ny; i++, xylut++) {
+    for (int iy = lut_start_row; iy <= lut_end_row; iy++) {
+
+      // XY lookup table row for this output row
+
+      long *xylut = _xyLut + (long) (iy - _out_lut_miny_idx) * _out_lut_nx;
 
-    // Now loop through only the portion of the output grid where we have lut info
-    for (int iy = _out_lut_miny_idx; iy < _out_lut_miny_idx + _out_lut_ny; iy++) {
       for (int ix = _out_lut_minx_idx; ix < _out_lut_minx_idx + _out_lut_nx; ix++, xylut++) {
 
         if (ix > 0 && ix < _outputGrid->nx &&
             iy > 0 && iy < _outputGrid->ny) {
 
-          int in_idx = *xylut;
+          long in_idx = *xylut;
           if (in_idx >= 0)
           {
             int inb = inPlane[in_idx];
             int outb = scaleLut[inb];
   
             // Point to output array based on loop index
-            int out_idx = (iy * _outputGrid->nx) + ix;
-            outbp = outPlane + out_idx;
+            ui08 *outbp = outPlane + (iy * _outputGrid->nx) + ix;
 
             if (*outbp < outb)
             {
               *outbp = outb;
             }
   
-            // MCP test
-            // *outbp = 73;
-
-//          if (*outbp > 0) {
-//            fprintf(stderr, "ix, iy, in_idx, out_idx, outbp: %d %d %d %d %d\n",
-//                  ix, iy, in_idx, out_idx, *outbp);
-//          }
-
           } // endif - in_idx >= 0
 
         } // endif - ix > 0...
 
-
       } // ix
     } // iy
   } // iz
@@ -509,11 +552,14 @@ void InputFile::_computeXYLookup()
 {
 
   // initialize projection geometry routines
-  // based on 0,0 being at VIL grid center
+  // based on 0,0 being at VIL grid center.
+  // Use the PJGs_ routines, which keep the projection in a struct
+  // rather than static memory, since the lookups for different
+  // inputs are computed in parallel threads.
 
-  PJGflat_init(_grid.proj_origin_lat,
-               _grid.proj_origin_lon,
-               _grid.proj_params.flat.rotation);
+  PJGstruct *proj = PJGs_flat_init(_grid.proj_origin_lat,
+                                   _grid.proj_origin_lon,
+                                   _grid.proj_params.flat.rotation);
 
   // Find the lat/lon of the corner cells of the input grid
   // Currently, the NIDS VIL grids have the origin in the center
@@ -534,22 +580,22 @@ void InputFile::_computeXYLookup()
   // lower left corner
   in_x = _grid.minx;
   in_y = _grid.miny;
-  PJGflat_xy2latlon(in_x, in_y, &in_ll_lat, &in_ll_lon);
+  PJGs_flat_xy2latlon(proj, in_x, in_y, &in_ll_lat, &in_ll_lon);
 
   // upper left corner
   in_x = _grid.minx;
   in_y = _grid.miny + (_grid.ny * _grid.dy);
-  PJGflat_xy2latlon(in_x, in_y, &in_ul_lat, &in_ul_lon);
+  PJGs_flat_xy2latlon(proj, in_x, in_y, &in_ul_lat, &in_ul_lon);
 
   // upper right corner
   in_x = _grid.minx + (_grid.nx * _grid.dx);
   in_y = _grid.miny + (_grid.ny * _grid.dy);
-  PJGflat_xy2latlon(in_x, in_y, &in_ur_lat, &in_ur_lon);
+  PJGs_flat_xy2latlon(proj, in_x, in_y, &in_ur_lat, &in_ur_lon);
 
   // lower right corner
   in_x = _grid.minx;
   in_y = _grid.miny + (_grid.ny * _grid.dy);
-  PJGflat_xy2latlon(in_x, in_y, &in_lr_lat, &in_lr_lon);
+  PJGs_flat_xy2latlon(proj, in_x, in_y, &in_lr_lat, &in_lr_lon);
 
   // Find the extremes of the grid
   out_lut_minx = MIN(in_ll_lon, in_ul_lon);
@@ -598,7 +644,7 @@ void InputFile::_computeXYLookup()
 
       double flat_xx, flat_yy;
       // This should give x,y based on input gride center point
-      PJGflat_latlon2xy(lat, lon, &flat_xx, &flat_yy);
+      PJGs_flat_latlon2xy(proj, lat, lon, &flat_xx, &flat_yy);
       
       // compute grid indicies for input grid
 
@@ -622,6 +668,8 @@ void InputFile::_computeXYLookup()
     } // xx
   } // yy
 
+  free(proj);
+
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -51,18 +51,24 @@ public:
   ~InputFile();
 
   // read in the relevant file
+  // This also computes the lookup tables if the grid has changed,
+  // and the min and max values of the fields.
+  // It may be called from a thread - different InputFile objects
+  // do not share any state.
   int read(time_t request_time);
 
-  // get min and max vals for a field
+  // get min and max vals for a field, computed in read()
   int getMinAndMax(int field_num, double *min_p, double *max_p);
   
   // get handle
   MDV_handle_t *handle() { return (&_handle); }
 
-  // merge field data
+  // merge field data, for output rows start_row through end_row
+  // Different row ranges may be merged concurrently.
   void mergeField(int in_field,
 		  MDV_handle_t *outHandle, mdv_grid_t *outGrid,
-		  int out_field, double out_scale, double out_bias);
+		  int out_field, double out_scale, double out_bias,
+		  int start_row, int end_row);
 
   // update the start and end times
   void updateTimes(time_t *start_time_p, time_t *end_time_p);
@@ -110,6 +116,12 @@ private:
   int _out_lut_maxx_idx;   // output maximum x index for current input grid
   int _out_lut_maxy_idx;   // output maximum y index for current input grid
 
+  // min and max values for the fields in the field list
+
+  double *_fieldMin;
+  double *_fieldMax;
+  int *_fieldHasData;
+
   // functions
 
   int _loadPath(time_t request_time);
@@ -120,6 +132,8 @@ private:
   void _computeXYLookup();
   void _computeZLookup();
 
+  int _computeMinAndMax(int field_num, double *min_p, double *max_p);
+
 };
 
 #endif
@@ -36,6 +36,7 @@
 #include "Trigger.hh"
 #include "InputFile.hh"
 #include "OutputFile.hh"
+#include "MosaicThread.hh"
 #include <toolsa/str.h>
 #include <toolsa/pmu.h>
 #include <rapmath/math_macros.h>
@@ -49,6 +50,14 @@ MdvMosaic::MdvMosaic(int argc, char **argv)
 
   OK = TRUE;
   Done = FALSE;
+  _nInput = 0;
+  _inFiles = NULL;
+  _outFile = NULL;
+  _triggerTime = 0;
+  _outScale = NULL;
+  _outBias = NULL;
+  _fieldHasData = NULL;
+  _nBands = 1;
 
   // set programe name
 
@@ -108,6 +117,19 @@ MdvMosaic::MdvMosaic(int argc, char **argv)
 
   _loadGrid();
 
+  // set up thread pool.
+  // The output grid is divided into several bands per thread,
+  // to balance the load since the inputs do not cover the
+  // grid evenly.
+
+  if (_params->n_threads > 1) {
+    for (int i = 0; i < _params->n_threads; i++) {
+      MosaicThread *thread = new MosaicThread(this, i);
+      _threadPool.addThreadToMain(thread);
+    }
+    _nBands = MIN(_params->n_threads * 4, _outGrid.ny);
+  }
+
   // init process mapper registration
 
   PMU_auto_init(_progName, _params->instance, PROCMAP_REGISTER_INTERVAL);
@@ -149,20 +171,26 @@ int MdvMosaic::Run ()
   
   // create the input file objects
 
-  int nInput = _params->input_dirs.len;
-  InputFile **inFiles = new InputFile*[nInput];
-  for (int i = 0; i < nInput; i++) {
-    inFiles[i] = new InputFile(_progName, _params,
-			       _params->input_dirs.val[i],
-			       (i == 0),
-			       &_outGrid, _locArray);
+  _nInput = _params->input_dirs.len;
+  _inFiles = new InputFile*[_nInput];
+  for (int i = 0; i < _nInput; i++) {
+    _inFiles[i] = new InputFile(_progName, _params,
+				_params->input_dirs.val[i],
+				(i == 0),
+				&_outGrid, _locArray);
   }
   
   // create output file object
 
-  OutputFile *outFile = new OutputFile(_progName, _params, &_outGrid);
-  MDV_handle_t *outHandle = outFile->handle();
+  _outFile = new OutputFile(_progName, _params, &_outGrid);
   int outInit = FALSE;
+
+  // alloc scale and bias arrays
+
+  int nFields = _params->field_list.len;
+  _outScale = (double *) ucalloc_min_1(nFields, sizeof(double));
+  _outBias = (double *) ucalloc_min_1(nFields, sizeof(double));
+  _fieldHasData = (int *) ucalloc_min_1(nFields, sizeof(int));
   
   // loop through times
 
@@ -173,35 +201,45 @@ int MdvMosaic::Run ()
     if (_params->debug) {
       fprintf(stderr, "----> Trigger time: %s\n", utimstr(triggerTime));
     }
+
+    struct timeval startTime_tv, readTime_tv, scaleTime_tv;
+    struct timeval mergeTime_tv, writeTime_tv;
+    gettimeofday(&startTime_tv, NULL);
     
-    // read relevant input files
+    // read relevant input files - the reads are independent,
+    // so they are done in parallel if we have threads
     
+    _triggerTime = triggerTime;
+    _runTasks(MosaicThread::READ_INPUT, _nInput);
+
     int dataAvail = FALSE;
-    for (int input = 0; input < nInput; input++) {
-      inFiles[input]->read(triggerTime);
-      if (inFiles[input]->readSuccess) {
+    int nRead = 0;
+    for (int input = 0; input < _nInput; input++) {
+      if (_inFiles[input]->readSuccess) {
 	dataAvail = TRUE;
+	nRead++;
 	// on first successful read, initialize the output file headers
 	if (!outInit) {
-	  outFile->initHeaders(inFiles[input]->handle());
+	  _outFile->initHeaders(_inFiles[input]->handle());
 	  outInit = TRUE;
 	}
       }
     }
+    gettimeofday(&readTime_tv, NULL);
     
     if (!dataAvail) {
       continue;
     }
     
     // clear vol
-    outFile->clearVol();
+    _outFile->clearVol();
 
     // set info string
-    outFile->addToInfo("Merged data set from the following files:\n");
-    for (int input = 0; input < nInput; input++) {
-      if (inFiles[input]->readSuccess) {
-	outFile->addToInfo(inFiles[input]->path());
-	outFile->addToInfo("\n");
+    _outFile->addToInfo("Merged data set from the following files:\n");
+    for (int input = 0; input < _nInput; input++) {
+      if (_inFiles[input]->readSuccess) {
+	_outFile->addToInfo(_inFiles[input]->path());
+	_outFile->addToInfo("\n");
       }
     }
 
@@ -209,68 +247,210 @@ int MdvMosaic::Run ()
 
     time_t startTime = -1;
     time_t endTime = -1;
-    for (int input = 0; input < nInput; input++) {
-      if (inFiles[input]->readSuccess) {
-	inFiles[input]->updateTimes(&startTime, &endTime);
+    for (int input = 0; input < _nInput; input++) {
+      if (_inFiles[input]->readSuccess) {
+	_inFiles[input]->updateTimes(&startTime, &endTime);
       }
     } // input
 
-    // loop through fields
+    // compute scale and bias for each field
     
-    for (int out_field = 0; out_field < _params->field_list.len; out_field++) {
+    for (int out_field = 0; out_field < nFields; out_field++) {
 
       int in_field = _params->field_list.val[out_field];
       
       // compute scale and bias - if error returned there was no data in
-      // this field in any of the input files, so jump to end of loop
+      // this field in any of the input files, so it is not merged
 
       double out_scale, out_bias;
 
-      if (_computeScaleAndBias(in_field, nInput, inFiles,
+      if (_computeScaleAndBias(in_field, _nInput, _inFiles,
 			       &out_scale, &out_bias) == 0) {
 	if (_params->debug) {
 	  fprintf(stderr, "out_scale, out_bias: %g, %g\n", out_scale, out_bias);
 	}
-	outFile->loadScaleAndBias(out_field, out_scale, out_bias);
+	_outFile->loadScaleAndBias(out_field, out_scale, out_bias);
+	_outScale[out_field] = out_scale;
+	_outBias[out_field] = out_bias;
+	_fieldHasData[out_field] = TRUE;
       } else {
 	if (_params->debug) {
 	  fprintf(stderr, "No data found, field %d\n", in_field);
 	}
-	outFile->loadScaleAndBias(out_field, 1.0, 0.0);
-	continue;
+	_outFile->loadScaleAndBias(out_field, 1.0, 0.0);
+	_fieldHasData[out_field] = FALSE;
       }
       
-      // for each input file, merge the field data into the output grid
-
-      for (int input = 0; input < nInput; input++) {
-	if (inFiles[input]->readSuccess) {
-	  inFiles[input]->mergeField(in_field,
-				     outHandle, &_outGrid, out_field,
-				     out_scale, out_bias);
-	}
-      } // input
-      
     } // out_field
+    gettimeofday(&scaleTime_tv, NULL);
+
+    // merge the field data into the output grid - the bands
+    // do not overlap, so they are merged in parallel
+
+    _runTasks(MosaicThread::MERGE_BAND, _nBands);
+    gettimeofday(&mergeTime_tv, NULL);
 
     // write out volume
 
-    outFile->writeVol(triggerTime, startTime, endTime);
+    _outFile->writeVol(triggerTime, startTime, endTime);
+    gettimeofday(&writeTime_tv, NULL);
+
+    if (_params->print_timing) {
+      fprintf(stderr, "%s - timing for %s, nInputs read: %d, nThreads: %ld\n",
+	      _progName, utimstr(triggerTime), nRead, _params->n_threads);
+      fprintf(stderr, "  read:  %.3f secs\n",
+	      _elapsedSecs(&startTime_tv, &readTime_tv));
+      fprintf(stderr, "  scale: %.3f secs\n",
+	      _elapsedSecs(&readTime_tv, &scaleTime_tv));
+      fprintf(stderr, "  merge: %.3f secs\n",
+	      _elapsedSecs(&scaleTime_tv, &mergeTime_tv));
+      fprintf(stderr, "  write: %.3f secs\n",
+	      _elapsedSecs(&mergeTime_tv, &writeTime_tv));
+      fprintf(stderr, "  total: %.3f secs\n",
+	      _elapsedSecs(&startTime_tv, &writeTime_tv));
+    }
 
   } // while
 
   // free up
 
   delete (trigger);
-  for (int i = 0; i < nInput; i++) {
-    delete (inFiles[i]);
+  for (int i = 0; i < _nInput; i++) {
+    delete (_inFiles[i]);
   }
-  delete inFiles;
-  delete outFile;
+  delete[] _inFiles;
+  _inFiles = NULL;
+  _nInput = 0;
+  delete _outFile;
+  _outFile = NULL;
+  ufree(_outScale);
+  ufree(_outBias);
+  ufree(_fieldHasData);
+  _outScale = NULL;
+  _outBias = NULL;
+  _fieldHasData = NULL;
 
   return (0);
 
 }
 
+//////////////////////////////////////////////////
+// doTask
+//
+// Perform a single read or merge task.
+// Called by the threads, or directly if single-threaded.
+
+void MdvMosaic::doTask(MosaicThread::task_t task, int index)
+{
+
+  if (task == MosaicThread::READ_INPUT) {
+    _inFiles[index]->read(_triggerTime);
+  } else {
+    _mergeBand(index);
+  }
+
+}
+
+//////////////////////////////////////////////////
+// _runTasks
+//
+// Run tasks 0 through nTasks-1, using the thread pool if
+// it is active. Returns when all tasks are complete.
+
+void MdvMosaic::_runTasks(MosaicThread::task_t task, int nTasks)
+{
+
+  if (_params->n_threads <= 1) {
+    for (int i = 0; i < nTasks; i++) {
+      doTask(task, i);
+    }
+    return;
+  }
+
+  _threadPool.initForRun();
+
+  int index = 0;
+  while (index < nTasks) {
+
+    // get a thread from the pool
+    
+    bool isDone = true;
+    MosaicThread *thread =
+      (MosaicThread *) _threadPool.getNextThread(true, isDone);
+    if (thread == NULL) {
+      break;
+    }
+
+    if (isDone) {
+      // return done thread to the available pool
+      _threadPool.addThreadToAvail(thread);
+    } else {
+      // set the task and start it running
+      thread->setTask(task, index);
+      thread->signalRunToStart();
+      index++;
+    }
+
+  } // while
+
+  // wait for remaining threads to complete
+
+  _threadPool.setReadyForDoneCheck();
+  while (!_threadPool.checkAllDone()) {
+    MosaicThread *thread = (MosaicThread *) _threadPool.getNextDoneThread();
+    if (thread == NULL) {
+      break;
+    }
+    _threadPool.addThreadToAvail(thread);
+  } // while
+
+}
+
+//////////////////////////////////////////////////
+// _mergeBand
+//
+// Merge all inputs into a band of output rows.
+// Merging takes the max value, so the order of inputs
+// does not affect the result.
+
+void MdvMosaic::_mergeBand(int band)
+{
+
+  int startRow = (int) (((long) band * _outGrid.ny) / _nBands);
+  int endRow = (int) ((((long) band + 1) * _outGrid.ny) / _nBands) - 1;
+  MDV_handle_t *outHandle = _outFile->handle();
+  
+  for (int out_field = 0; out_field < _params->field_list.len; out_field++) {
+
+    if (!_fieldHasData[out_field]) {
+      continue;
+    }
+    int in_field = _params->field_list.val[out_field];
+
+    // for each input file, merge the field data into the output band
+
+    for (int input = 0; input < _nInput; input++) {
+      if (_inFiles[input]->readSuccess) {
+	_inFiles[input]->mergeField(in_field,
+				    outHandle, &_outGrid, out_field,
+				    _outScale[out_field], _outBias[out_field],
+				    startRow, endRow);
+      }
+    } // input
+      
+  } // out_field
+
+}
+
+//////////////////////////////////////////////////
+// _elapsedSecs
+
+double MdvMosaic::_elapsedSecs(struct timeval *start, struct timeval *end)
+{
+  return ((double) (end->tv_sec - start->tv_sec) +
+	  (double) (end->tv_usec - start->tv_usec) * 1.0e-6);
+}
+
 //////////////////////////////////////////////////
 // _createTrigger
 
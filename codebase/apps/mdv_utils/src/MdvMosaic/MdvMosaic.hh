@@ -41,6 +41,9 @@
 
 #include "Args.hh"
 #include "Params.hh"
+#include "MosaicThread.hh"
+#include <toolsa/TaThreadPool.hh>
+#include <sys/time.h>
 using namespace std;
 
 #define VGRID_MISSING -9999.999
@@ -51,6 +54,7 @@ typedef struct {
 
 class Trigger;
 class InputFile;
+class OutputFile;
 
 class MdvMosaic {
   
@@ -68,6 +72,10 @@ public:
 
   int Run();
 
+  // perform a read or merge task - called by MosaicThread
+
+  void doTask(MosaicThread::task_t task, int index);
+
   // data members
 
   int OK;
@@ -83,12 +91,39 @@ private:
   mdv_grid_t _outGrid;
   lat_lon_t *_locArray;
 
+  // input and output files
+
+  int _nInput;
+  InputFile **_inFiles;
+  OutputFile *_outFile;
+  time_t _triggerTime;
+
+  // output scale and bias for each field in the field list,
+  // and whether any input has data for that field
+
+  double *_outScale;
+  double *_outBias;
+  int *_fieldHasData;
+
+  // the output grid is merged in bands of rows
+
+  int _nBands;
+
+  // thread pool, used if n_threads > 1
+
+  TaThreadPool _threadPool;
+
   // functions
 
   void _loadGrid();
 
   Trigger *_createTrigger();
 
+  void _runTasks(MosaicThread::task_t task, int nTasks);
+  void _mergeBand(int band);
+
+  double _elapsedSecs(struct timeval *start, struct timeval *end);
+
   int _computeScaleAndBias(int out_field, int nInput, InputFile **inFiles,
 			   double *scale_p, double *bias_p);
 
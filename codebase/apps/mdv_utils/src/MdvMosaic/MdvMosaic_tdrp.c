@@ -40,7 +40,7 @@
  * file scope variables
  */
 
-static TDRPtable Table[19];
+static TDRPtable Table[21];
 static MdvMosaic_tdrp_struct *Params;
 static char *Module = "MdvMosaic";
 
@@ -650,6 +650,32 @@ TDRPtable *MdvMosaic_tdrp_init(MdvMosaic_tdrp_struct *params)
   tt->single_val.b = pFALSE;
   tt++;
   
+  /* Parameter 'n_threads' */
+  /* ctype is 'long' */
+  
+  memset(tt, 0, sizeof(TDRPtable));
+  tt->ptype = LONG_TYPE;
+  tt->param_name = tdrpStrDup("n_threads");
+  tt->descr = tdrpStrDup("Number of threads for reading and merging.");
+  tt->help = tdrpStrDup("The input files are read, and their lookup tables computed, in parallel using this number of threads. The output grid is then divided into bands of rows, and the bands are merged in parallel. Set to 1 for single-threaded operation.");
+  tt->val_offset = (char *) &(pp.n_threads) - (char *) &pp;
+  tt->has_min = TRUE;
+  tt->min_val.l = 1;
+  tt->single_val.l = 1;
+  tt++;
+  
+  /* Parameter 'print_timing' */
+  /* ctype is 'tdrp_bool_t' */
+  
+  memset(tt, 0, sizeof(TDRPtable));
+  tt->ptype = BOOL_TYPE;
+  tt->param_name = tdrpStrDup("print_timing");
+  tt->descr = tdrpStrDup("Option to print timing for each processing stage.");
+  tt->help = tdrpStrDup("If TRUE, the time taken to read the input files, compute the scale and bias, merge the data and write the output file is printed to stderr for each trigger time.");
+  tt->val_offset = (char *) &(pp.print_timing) - (char *) &pp;
+  tt->single_val.b = pFALSE;
+  tt++;
+  
   /* trailing entry has param_name set to NULL */
   
   tt->param_name = NULL;
@@ -175,6 +175,14 @@ typedef struct {
 
   tdrp_bool_t compute_scale_and_bias;
 
+  /***** n_threads *****/
+
+  long n_threads;
+
+  /***** print_timing *****/
+
+  tdrp_bool_t print_timing;
+
 } MdvMosaic_tdrp_struct;
 
 /*
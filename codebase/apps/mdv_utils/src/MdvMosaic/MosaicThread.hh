@@ -0,0 +1,84 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// MosaicThread.hh
+//
+// Thread class for reading input files and merging bands
+// of the output grid in parallel.
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#ifndef MosaicThread_HH
+#define MosaicThread_HH
+
+#include <toolsa/TaThread.hh>
+using namespace std;
+
+class MdvMosaic;
+
+class MosaicThread : public TaThread
+{  
+
+public:
+
+  // tasks performed by the thread
+
+  typedef enum {
+    READ_INPUT,  // read an input file, and compute its lookup tables
+    MERGE_BAND   // merge all inputs into a band of output rows
+  } task_t;
+  
+  // constructor
+  
+  MosaicThread(MdvMosaic *parent, int threadNum);
+
+  // destructor
+  
+  virtual ~MosaicThread();
+
+  // set the task - index is the input number for READ_INPUT,
+  // and the band number for MERGE_BAND
+  
+  inline void setTask(task_t task, int index) {
+    _task = task;
+    _index = index;
+  }
+
+  // override run method
+
+  virtual void run();
+
+private:
+
+  MdvMosaic *_parent;
+  int _threadNum;
+
+  task_t _task;
+  int _index;
+
+};
+
+#endif
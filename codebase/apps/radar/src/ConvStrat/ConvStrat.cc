@@ -127,6 +127,8 @@ ConvStrat::ConvStrat(int argc, char **argv)
   _finder.setMinConvectivityForConvective(_params.min_convectivity_for_convective);
   _finder.setMaxConvectivityForStratiform(_params.max_convectivity_for_stratiform);
   _finder.setMinGridOverlapForClumping(_params.min_overlap_for_convective_clumps);
+  _finder.setNThreadsForClumping(_params.n_threads);
+  _finder.setNThreads(_params.n_threads);
   _finder.setTextureRadiusKm(_params.texture_radius_km);
   _finder.setMinValidFractionForTexture
     (_params.min_valid_fraction_for_texture);
@@ -947,6 +947,20 @@
     tt->single_val.i = 1;
     tt++;
     
+    // Parameter 'n_threads'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("n_threads");
+    tt->descr = tdrpStrDup("Number of threads for computing the partition.");
+    tt->help = tdrpStrDup("If greater than 1, the grid is split into tiles of columns which are processed in parallel, and the convective regions are clumped in parallel. The result does not depend on the number of threads.");
+    tt->val_offset = (char *) &n_threads - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 1;
+    tt->single_val.i = 4;
+    tt++;
+    
     // Parameter 'Comment 7'
     
     memset(tt, 0, sizeof(TDRPtable));
@@ -429,6 +429,8 @@ public:
 
   int min_overlap_for_convective_clumps;
 
+  int n_threads;
+
   char* output_url;
 
   tdrp_bool_t write_partition;
@@ -458,7 +460,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[45];
+  mutable TDRPtable _table[46];
 
   const char *_className;
 
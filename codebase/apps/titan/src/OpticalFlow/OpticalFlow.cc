@@ -52,11 +52,9 @@
 #include <Mdv/DsMdvx.hh>
 #include <Mdv/MdvxField.hh>
 #include <Mdv/MdvxRemapLut.hh>
+#include <advect/OpticalFlowTracker.hh>
 #include "OpticalFlow.hh"
-#include "optical_flow.h"
-#include "array_utils.h"
 using namespace std;
-using namespace ancilla;
 
 // Constructor
 
@@ -319,126 +317,42 @@ int OpticalFlow::_processTimeStep(DsMdvx &previous, DsMdvx &current)
     return -1;
   }
 
-  // get array pointers
-  
-  fl32 *prevVol = (fl32 *) prevComp->getVol();
-  fl32 *currVol = (fl32 *) currComp->getVol();
-
-  // set up arrays for algorithm
-
-  size_t dims[2];
-  dims[0] = ny;
-  dims[1] = nx;
-
-  array2<fl32> prevArray(dims);
-  array2<fl32> currArray(dims);
-
-  fl32 *prevData = prevArray.data();
-  fl32 *currData = currArray.data();
-  
-  memcpy(prevData, prevVol, ny * nx * sizeof(fl32));
-  memcpy(currData, currVol, ny * nx * sizeof(fl32));
-
-  // replace missing data with NaNs
-
-  fl32 missingPrev = prevComp->getFieldHeader().missing_data_value;
-  fl32 missingCurr = currComp->getFieldHeader().missing_data_value;
-
-  for (size_t ii = 0; ii < ny * nx; ii++) {
-    if (prevData[ii] == missingPrev) {
-      prevData[ii] = NAN;
-    }
-    if (currData[ii] == missingCurr) {
-      currData[ii] = NAN;
-    }
-  }
-
-  // get min and max so we can scale between 1 and 255
-  
-  fl32 minVal = 1.0e99;
-  fl32 maxVal = -1.0e99;
-  
-  for (size_t ii = 0; ii < ny * nx; ii++) {
-    fl32 val = prevData[ii];
-    if (isnan(val)) {
-      continue;
-    }
-    if (val < minVal) {
-      minVal = val;
-    }
-    if (val > maxVal) {
-      maxVal = val;
-    }
-  }
-
-  for (size_t ii = 0; ii < ny * nx; ii++) {
-    fl32 val = currData[ii];
-    if (isnan(val)) {
-      continue;
-    }
-    if (val < minVal) {
-      minVal = val;
-    }
-    if (val > maxVal) {
-      maxVal = val;
-    }
-  }
-
-  // perform the scaling between 2.5 and 252.5
-
-  double scale = 250.0 / (maxVal - minVal);
-  double offset = 2.5;
-
-  for (size_t ii = 0; ii < ny * nx; ii++) {
-    fl32 val = prevData[ii];
-    if (isfinite(val)) {
-      prevData[ii] = (val - minVal) * scale + offset;
-    }
-  }
-  for (size_t ii = 0; ii < ny * nx; ii++) {
-    fl32 val = currData[ii];
-    if (isfinite(val)) {
-      currData[ii] = (val - minVal) * scale + offset;
-    }
-  }
-  double threshold = (_params.tracking_threshold - minVal) * scale + offset;
-
-  // initialize arrays to hold our output vectors
-  
-  array2<fl32> adv_x(dims);
-  array2<fl32> adv_y(dims);
-  array_utils::zero(adv_x);
-  array_utils::zero(adv_y);
-
   // set up optical flow tracking object
 
-  optical_flow tracker(nx,
-                       ny,
-                       _params.scale_factor,
-                       _params.max_levels,
-                       _params.window_size,
-                       _params.n_iterations,
-                       _params.polygon_neighborhood,
-                       _params.polygon_sigma);
-  
-  // perform the tracking
-
-  double background = threshold / 2.0;
-  double gain = 1.0;
-
-  tracker.determine_velocities(prevArray,
-                               currArray,
-                               adv_x,
-                               adv_y,
-                               _params.seed_with_previous_vectors,
-                               background,
-                               threshold,
-                               gain,
-                               _params.interp_over_missing_areas,
+  OpticalFlowTracker tracker(_params.debug >= Params::DEBUG_VERBOSE);
+  tracker.setScaleFactor(_params.scale_factor);
+  tracker.setMaxLevels(_params.max_levels);
+  tracker.setWindowSize(_params.window_size);
+  tracker.setNIterations(_params.n_iterations);
+  tracker.setPolygonNeighborhood(_params.polygon_neighborhood);
+  tracker.setPolygonSigma(_params.polygon_sigma);
+  tracker.setInterpOverMissing(_params.interp_over_missing_areas,
                                _params.interp_spacing,
                                _params.min_frac_bins_for_avg,
                                _params.idw_low_res_pwr,
                                _params.idw_high_res_pwr);
+  tracker.setNThreads(_params.n_threads);
+
+  // perform the tracking
+  // motion is computed in grid cells over the interval
+
+  fl32 missingVal = -9999.0;
+  vector<fl32> uMotion(ny * nx, 0.0);
+  vector<fl32> vMotion(ny * nx, 0.0);
+
+  if (!tracker.compute(nx, ny,
+                       (fl32 *) prevComp->getVol(),
+                       prevComp->getFieldHeader().missing_data_value,
+                       (fl32 *) currComp->getVol(),
+                       currComp->getFieldHeader().missing_data_value,
+                       _params.tracking_threshold,
+                       uMotion.data(), vMotion.data(), missingVal,
+                       _params.seed_with_previous_vectors)) {
+    cerr << "ERROR - OpticalFlow::_processTimeStep" << endl;
+    cerr << "  Optical flow tracking failed" << endl;
+    delete currComp;
+    return -1;
+  }
 
   // scale the velocities into m/s
   // set missing value as appropriate
@@ -454,9 +368,8 @@ int OpticalFlow::_processTimeStep(DsMdvx &previous, DsMdvx &current)
     yscale = (prevComp->getFieldHeader().grid_dy * 1000.0 * KM_PER_DEG_AT_EQ) / timeDelta;
   }
   
-  fl32 missingVal = -9999.0;
-  fl32 *uu = adv_x.data();
-  fl32 *vv = adv_y.data();
+  fl32 *uu = uMotion.data();
+  fl32 *vv = vMotion.data();
   size_t ii = 0;
   for (size_t yindex = 0; yindex < ny; yindex++) { // Loop through y Dim - Rows
 
@@ -472,7 +385,7 @@ int OpticalFlow::_processTimeStep(DsMdvx &previous, DsMdvx &current)
       ii = yindex * nx + xindex;
 
       fl32 velx = uu[ii];
-      if (isfinite(velx)) {
+      if (velx != missingVal) {
 	velx *= xscale;
 	if (fabs(velx) < 1.0e-3) {
 	  velx = 0.0;
@@ -483,7 +396,7 @@ int OpticalFlow::_processTimeStep(DsMdvx &previous, DsMdvx &current)
       }
 
       fl32 vely = vv[ii];
-      if (isfinite(vely)) {
+      if (vely != missingVal) {
 	vely *= yscale;
 	if (fabs(vely) < 1.0e-3) {
 	  vely = 0.0;
@@ -890,6 +890,20 @@
     tt->single_val.d = 3;
     tt++;
     
+    // Parameter 'n_threads'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("n_threads");
+    tt->descr = tdrpStrDup("Number of threads for the optical flow computations.");
+    tt->help = tdrpStrDup("The blurs, polynomial expansion and iterations at each resolution level are split into tiles of rows, which are shared between the threads. The results do not depend on the number of threads.");
+    tt->val_offset = (char *) &n_threads - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 1;
+    tt->single_val.i = 1;
+    tt++;
+    
     // Parameter 'Comment 4'
     
     memset(tt, 0, sizeof(TDRPtable));
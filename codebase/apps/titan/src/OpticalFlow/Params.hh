@@ -432,6 +432,8 @@ public:
 
   double idw_high_res_pwr;
 
+  int n_threads;
+
   char* output_url;
 
   tdrp_bool_t write_composite_field_to_output;
@@ -450,7 +452,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[34];
+  mutable TDRPtable _table[35];
 
   const char *_className;
 
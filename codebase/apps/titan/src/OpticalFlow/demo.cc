@@ -25,9 +25,9 @@
  * Simple demo to exercise optical flow class extracted from Ancilla1
  *----------------------------------------------------------------------------*/
 
-#include "optical_flow.h"
-#include "array_utils.h"
-#include "advection.h"
+#include <advect/ancilla/optical_flow.h>
+#include <advect/ancilla/array_utils.h>
+#include <advect/ancilla/advection.h>
 #include <netcdf.h>
 #include <iostream>
 #include <stdexcept>
@@ -48,10 +48,9 @@ using namespace std;
 //
 
 Area::Area(const string &prog_name, const Params &params,
-	   const InputMdv &input_mdv, TitanStormFile &storm_file) :
+	   const InputMdv &input_mdv) :
   Worker(prog_name, params),
   _inputMdv(input_mdv),
-  _sfile(storm_file),
   _boundary(prog_name, params)
   
 {
@@ -225,25 +224,29 @@ void Area::compute(const GridClump &grid_clump,
 }
 
 //////////////////////////////////////////////////////////
-// storeProjRuns()
+// loadProjRuns()
 //
-// Store the projected area runs in the storm file handle
+// Load the projected area runs into the runs vector.
+// The storm file is not touched, so this is safe to call
+// from a thread.
 
-int Area::storeProjRuns(const GridClump &grid_clump)
+int Area::loadProjRuns(const GridClump &grid_clump,
+                       vector<storm_file_run_t> &runs)
 
 {
 
   int nIntervals = _boundary.nIntervals();
 
-  _sfile.AllocLayers(_inputMdv.grid.nz);
-  _sfile.AllocHist(_nDbzHistIntervals);
-  _sfile.AllocProjRuns(nIntervals);
+  runs.resize(nIntervals);
+  if (nIntervals == 0) {
+    return 0;
+  }
   
   int start_ix = grid_clump.startIx;
   int start_iy = grid_clump.startIy;
   
   Interval *intvl = _boundary.intervals();
-  storm_file_run_t *run = _sfile._proj_runs;
+  storm_file_run_t *run = &runs[0];
   
   for (int irun = 0; irun < nIntervals; irun++, run++, intvl++) {
     
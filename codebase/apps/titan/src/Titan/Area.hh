@@ -37,6 +37,7 @@
 
 #include "Worker.hh"
 #include "Boundary.hh"
+#include <vector>
 #include <titan/storm.h>
 #include <titan/TitanStormFile.hh>
 using namespace std;
@@ -63,7 +64,7 @@ public:
   // constructor
 
   Area(const string &prog_name, const Params &params,
-       const InputMdv &input_mdv, TitanStormFile &storm_file);
+       const InputMdv &input_mdv);
 
   // destructor
   
@@ -74,9 +75,11 @@ public:
 	       storm_file_global_props_t *gprops,
 	       dbz_hist_entry_t *dbz_hist);
 
-  // Store the projected area runs in the storm file handle
+  // Load the projected area runs into the runs vector.
+  // Returns the number of runs.
 
-  int storeProjRuns(const GridClump &grid_clump);
+  int loadProjRuns(const GridClump &grid_clump,
+                   vector<storm_file_run_t> &runs);
 
   int OK;
 
@@ -85,7 +88,6 @@ protected:
 private:
 
   const InputMdv &_inputMdv;
-  TitanStormFile &_sfile;
   Boundary _boundary;
 
   double _zPInverseCoeff, _zPInverseExpon;
@@ -76,6 +76,8 @@ ConvectionFinder::ConvectionFinder(const string &progName,
     (_params.convection_finder_max_convectivity_for_stratiform);
   _convStrat.setMinGridOverlapForClumping
     (_params.convection_finder_min_overlap_for_convective_clumps);
+  _convStrat.setNThreadsForClumping(_params.n_threads_for_clumping);
+  _convStrat.setNThreads(_params.convection_finder_n_threads);
 
 }
 
@@ -42,6 +42,7 @@
 #include <toolsa/umisc.h>
 #include <toolsa/str.h>
 #include <toolsa/pmu.h>
+#include <toolsa/TaThreadSimple.hh>
 using namespace std;
 
 //////////////
@@ -60,12 +61,21 @@ Identify::Identify(const string &prog_name, const Params &params,
   _props = NULL;
   _verify = NULL;
   _dualT = NULL;
+  _nextCandidate = 0;
+  pthread_mutex_init(&_candidateMutex, NULL);
+  _clumpingSecs = 0.0;
+  _candidatesSecs = 0.0;
+  _propsSecs = 0.0;
+  _writeSecs = 0.0;
   
+  _clumping.setNThreads(_params.n_threads_for_clumping);
+
   if (_params.create_verification_files) {
     _verify = new Verify(_progName, _params, _inputMdv);
   }
 
   _props = new Props(_progName, _params, _inputMdv, _sfile, _verify);
+  _threadProps.push_back(_props);
 
   // dual threshold takes precedence over morphology
 
@@ -93,6 +103,14 @@ Identify::~Identify()
     delete (_dualT);
   }
 
+  // _threadProps[0] is _props, deleted above
+
+  for (size_t ii = 1; ii < _threadProps.size(); ii++) {
+    delete _threadProps[ii];
+  }
+
+  pthread_mutex_destroy(&_candidateMutex);
+
 }
 
 //////////////////////////////////////////////////////
@@ -110,6 +128,7 @@ int Identify::run(int scan_num)
     
   // initialize
 
+  gettimeofday(&_timeStart, NULL);
   _nStorms = 0;
   const titan_grid_t &grid = _inputMdv.grid;
   int nBytesPlane = grid.nx * grid.ny;
@@ -137,6 +156,12 @@ int Identify::run(int scan_num)
     fprintf(stderr, "Number of clumps  =  %d\n", _nClumps);
   }
 
+  if (_params.print_timing) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    _clumpingSecs = _elapsedSecs(&_timeStart, &tv);
+  }
+
   // update the verification grid
 
   if (_verify) {
@@ -176,6 +201,10 @@ int Identify::run(int scan_num)
     _dualT->writeOutputMdv();
   }
 
+  if (_params.print_timing) {
+    _printTiming(scan_num);
+  }
+
   return (0);
 
 }
@@ -186,7 +215,8 @@ int Identify::run(int scan_num)
 //
 // Checks storm props
 // If necessary splits storms.
-// Passes clumps to props_compute for computations of storm properties.
+// Computes the storm properties, in parallel if n_threads_for_props > 1,
+// then stores them in the storm file in clump order.
 //
 // Returns 0 on success, -1 on failure
 //
@@ -195,6 +225,11 @@ int Identify::_processClumps(int scan_num)
      
 {
 
+  struct timeval tv0, tv1;
+  if (_params.print_timing) {
+    gettimeofday(&tv0, NULL);
+  }
+
   // read in storm file header
 
   if (_sfile.ReadHeader()) {
@@ -203,12 +238,9 @@ int Identify::_processClumps(int scan_num)
     return(-1);
   }
 
-  // initialize the computation module for storm props
-  
-  _props->init();
-
-  // loop through the clumps - index starts at 1
+  // loop through the clumps, building the list of candidate storms
   
+  _candidates.clear();
   const Clump_order *clump = _clumping.getClumps();
   
   for (int iclump = 0; iclump < _nClumps; iclump++, clump++) {
@@ -222,30 +254,56 @@ int Identify::_processClumps(int scan_num)
       int n_sub_clumps = _dualT->compute(gridClump);
 
       if (n_sub_clumps == 1) {
-	
-	if (_processThisClump(gridClump)) {
-	  return (-1);
-	}
-
+	_addCandidate(gridClump);
       } else {
-
 	for (int i = 0; i < n_sub_clumps; i++) {
-	  if (_processThisClump(_dualT->subClumps()[i])) {
-	    return (-1);
-	  }
+	  _addCandidate(_dualT->subClumps()[i]);
 	}
-
       }
 
     } else {
       
-      if (_processThisClump(gridClump)) {
-	return (-1);
-      }
+      _addCandidate(gridClump);
       
     }
 
   } // iclump
+
+  if (_params.print_timing) {
+    gettimeofday(&tv1, NULL);
+    _candidatesSecs = _elapsedSecs(&tv0, &tv1);
+    tv0 = tv1;
+  }
+  
+  // compute the properties for the candidates
+
+  _computeProps();
+
+  if (_params.print_timing) {
+    gettimeofday(&tv1, NULL);
+    _propsSecs = _elapsedSecs(&tv0, &tv1);
+    tv0 = tv1;
+  }
+
+  // store the valid storms, in order, and write to the storm file
+
+  for (size_t ii = 0; ii < _candidates.size(); ii++) {
+    
+    if (_propsStatus[ii] != 0) {
+      continue;
+    }
+    
+    _props->store(_candidates[ii], _stormProps[ii], _nStorms);
+    
+    if (_sfile.WriteProps(_nStorms)) {
+      cerr << "ERROR - " << _progName << "Identify::_processClumps" << endl;
+      cerr << _sfile.getErrStr() << endl;
+      return(-1);
+    }
+
+    _nStorms++;
+
+  } // ii
   
   // load up scan structure
   
@@ -302,6 +360,11 @@ int Identify::_processClumps(int scan_num)
   }
   _sfile.FlushFiles();
 
+  if (_params.print_timing) {
+    gettimeofday(&tv1, NULL);
+    _writeSecs = _elapsedSecs(&tv0, &tv1);
+  }
+
   // printout
 
   if (_params.debug) {
@@ -317,10 +380,12 @@ int Identify::_processClumps(int scan_num)
 }
 
 /////////////////////////////////
-// _processThisClump()
+// _addCandidate()
+//
+// Add clump to the candidate list if it is within the size limits
 //
 
-int Identify::_processThisClump(const GridClump &grid_clump)
+void Identify::_addCandidate(const GridClump &grid_clump)
 
 {
 
@@ -328,7 +393,7 @@ int Identify::_processThisClump(const GridClump &grid_clump)
 
   if (grid_clump.stormSize < _params.min_storm_size ||
       grid_clump.stormSize > _params.max_storm_size) {
-    return(0);
+    return;
   }
 
   if (_params.debug >= Params::DEBUG_EXTRA) {
@@ -340,27 +405,159 @@ int Identify::_processThisClump(const GridClump &grid_clump)
 	    grid_clump.nX, grid_clump.nY,
 	    grid_clump.offsetX, grid_clump.offsetY);
   }
+
+  _candidates.push_back(grid_clump);
+
+}
+
+/////////////////////////////////
+// _computeProps()
+//
+// Compute the properties for all candidates
+
+void Identify::_computeProps()
+
+{
+
+  int nCandidates = (int) _candidates.size();
+  _stormProps.resize(nCandidates);
+  _propsStatus.assign(nCandidates, -1);
+  _nextCandidate = 0;
+
+  int nThreads = _params.n_threads_for_props;
+  if (nThreads > nCandidates) {
+    nThreads = nCandidates;
+  }
+  if (nThreads < 1) {
+    nThreads = 1;
+  }
+
+  // make sure we have a Props object for each thread
+  // only the first one updates the verification grids, in store()
+
+  while ((int) _threadProps.size() < nThreads) {
+    _threadProps.push_back(new Props(_progName, _params, _inputMdv,
+                                     _sfile, NULL));
+  }
+
+  // initialize the computation modules for storm props
   
-  _sfile.AllocGprops(_nStorms + 1);
+  for (size_t ii = 0; ii < _threadProps.size(); ii++) {
+    _threadProps[ii]->init();
+  }
 
-  if (_props->compute(grid_clump, _nStorms) == 0) {
-    
-    // success - write the storm props to storm file
+  if (nThreads == 1) {
+    _computeCandidates(_props);
+    return;
+  }
 
-    if (_sfile.WriteProps(_nStorms)) {
-      cerr << "ERROR - " << _progName << "Identify::_processThisClump" << endl;
-      cerr << _sfile.getErrStr() << endl;
-      return(-1);
+  // each thread pulls candidates off the list until it is empty
+
+  PropsThreads threads;
+  threads.init(nThreads, false);
+  for (int ii = 0; ii < nThreads; ii++) {
+    PropsInfo *info = new PropsInfo(this, _threadProps[ii]);
+    threads.thread(ii, (void *) info);
+  }
+  threads.waitForThreads();
+
+}
+
+/////////////////////////////////
+// _computeCandidates()
+//
+// Compute properties for candidates until none are left
+
+void Identify::_computeCandidates(Props *props)
+
+{
+  int icand;
+  while ((icand = _getNextCandidate()) >= 0) {
+    if (props == _props) {
+      PMU_auto_register("Props::compute - computing properties");
     }
+    _propsStatus[icand] =
+      props->compute(_candidates[icand], _stormProps[icand]);
+  }
+}
 
-    _nStorms++;
+/////////////////////////////////
+// get index of next candidate
+// returns -1 when all have been taken
+
+int Identify::_getNextCandidate()
 
+{
+  int icand = -1;
+  pthread_mutex_lock(&_candidateMutex);
+  if (_nextCandidate < (int) _candidates.size()) {
+    icand = _nextCandidate;
+    _nextCandidate++;
   }
+  pthread_mutex_unlock(&_candidateMutex);
+  return icand;
+}
 
-  return (0);
+///////////////////////////////////////////////////
+// thread compute method
+
+void Identify::compute(void *ti)
+
+{
+  PropsInfo *info = static_cast<PropsInfo *>(ti);
+  info->_obj->_computeCandidates(info->_props);
+  delete info;
+}
+
+///////////////////////////////////////////////////
+// clone a thread for the que
+
+TaThread *Identify::PropsThreads::clone(int index)
+
+{
+  TaThreadSimple *t = new TaThreadSimple(index);
+  t->setThreadMethod(Identify::compute);
+  t->setThreadContext(this);
+  return (TaThread *) t;
+}
+
+///////////////////////////////////////////////////
+// print timing report for the scan
+
+void Identify::_printTiming(int scan_num)
+
+{
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  double totalSecs = _elapsedSecs(&_timeStart, &tv);
+
+  fprintf(stderr, "========== identification timing ========\n");
+  fprintf(stderr, "Scan number %d, nstorms %d, nthreads for props %d\n",
+          scan_num, _nStorms, _params.n_threads_for_props);
+  fprintf(stderr, "  clumping:    %.3f secs\n", _clumpingSecs);
+  fprintf(stderr, "  candidates:  %.3f secs\n", _candidatesSecs);
+  fprintf(stderr, "  props:       %.3f secs\n", _propsSecs);
+  for (int stage = 0; stage < Props::N_STAGES; stage++) {
+    double secs = 0.0;
+    for (size_t ii = 0; ii < _threadProps.size(); ii++) {
+      secs += _threadProps[ii]->getStageSecs(stage);
+    }
+    fprintf(stderr, "    %-13s %.3f secs (summed over threads)\n",
+            Props::stageName(stage), secs);
+  }
+  fprintf(stderr, "  write:       %.3f secs\n", _writeSecs);
+  fprintf(stderr, "  total:       %.3f secs\n", totalSecs);
 
 }
 
+///////////////////////////////////////////////////
+// compute elapsed time in secs
 
+double Identify::_elapsedSecs(struct timeval *start, struct timeval *end)
 
+{
+  return ((double) (end->tv_sec - start->tv_sec) +
+          (double) (end->tv_usec - start->tv_usec) * 1.0e-6);
+}
 
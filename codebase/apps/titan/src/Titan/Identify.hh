@@ -37,14 +37,18 @@
 
 #include "Worker.hh"
 #include "InputMdv.hh"
+#include "GridClump.hh"
+#include "Props.hh"
 #include <euclid/GridClumping.hh>
 #include <titan/TitanStormFile.hh>
+#include <toolsa/TaThreadDoubleQue.hh>
+#include <pthread.h>
+#include <sys/time.h>
+#include <vector>
 using namespace std;
 
 class Verify;
-class Props;
 class DualThresh;
-class GridClump;
 
 ////////////////////////////////
 // Identify
@@ -81,8 +85,64 @@ private:
   Verify *_verify;
   DualThresh *_dualT;
 
+  // candidate storms for this scan, and their computed properties.
+  // The properties are computed in parallel if n_threads_for_props > 1,
+  // and are then stored in candidate order, so that the storm file
+  // does not depend on the number of threads.
+
+  vector<GridClump> _candidates;
+  vector<StormProps> _stormProps;
+  vector<int> _propsStatus;
+
+  // Props objects for the threads. _props is used by the first thread,
+  // the others are created as needed.
+
+  vector<Props *> _threadProps;
+
+  // next candidate to be computed, shared between threads
+
+  int _nextCandidate;
+  pthread_mutex_t _candidateMutex;
+
+  // timing
+
+  struct timeval _timeStart;
+  double _clumpingSecs;
+  double _candidatesSecs;
+  double _propsSecs;
+  double _writeSecs;
+
+  // task for a thread - computes candidates until none are left
+
+  class PropsInfo {
+  public:
+    PropsInfo(Identify *obj, Props *props) :
+            _obj(obj), _props(props) {}
+    Identify *_obj;
+    Props *_props;
+  };
+
+  // thread que
+
+  class PropsThreads : public TaThreadDoubleQue
+  {
+  public:
+    inline PropsThreads() : TaThreadDoubleQue() {}
+    inline virtual ~PropsThreads() {}
+    TaThread *clone(int index);
+  };
+
+  // thread compute method
+  
+  static void compute(void *ti);
+
   int _processClumps(int scan_num);
-  int _processThisClump(const GridClump &grid_clump);
+  void _addCandidate(const GridClump &grid_clump);
+  void _computeProps();
+  void _computeCandidates(Props *props);
+  int _getNextCandidate();
+  void _printTiming(int scan_num);
+  static double _elapsedSecs(struct timeval *start, struct timeval *end);
 
 };
 
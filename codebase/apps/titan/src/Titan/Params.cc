@@ -608,6 +608,18 @@
     tt->single_val.s = tdrpStrDup("Test");
     tt++;
     
+    // Parameter 'print_timing'
+    // ctype is 'tdrp_bool_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = BOOL_TYPE;
+    tt->param_name = tdrpStrDup("print_timing");
+    tt->descr = tdrpStrDup("Option to print timing for each stage of storm identification.");
+    tt->help = tdrpStrDup("If TRUE, the time taken for clumping, splitting, computing the storm properties and writing the storm file is printed for each scan. The time for each stage of the properties computation is also printed, summed over all storms and threads.");
+    tt->val_offset = (char *) &print_timing - &_start_;
+    tt->single_val.b = pFALSE;
+    tt++;
+    
     // Parameter 'Comment 2'
     
     memset(tt, 0, sizeof(TDRPtable));
@@ -1000,6 +1012,34 @@
     tt->single_val.i = 1;
     tt++;
     
+    // Parameter 'n_threads_for_clumping'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("n_threads_for_clumping");
+    tt->descr = tdrpStrDup("Number of threads for clumping the storm runs.");
+    tt->help = tdrpStrDup("If greater than 1, the runs are clumped in parallel, in bands of rows which are then joined at the band borders. The storms found are the same for any number of threads. This also applies to clumping the convective regions, if identify_convective_regions is set.");
+    tt->val_offset = (char *) &n_threads_for_clumping - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 1;
+    tt->single_val.i = 1;
+    tt++;
+    
+    // Parameter 'n_threads_for_props'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("n_threads_for_props");
+    tt->descr = tdrpStrDup("Number of threads for computing the storm properties.");
+    tt->help = tdrpStrDup("If greater than 1, the properties of the storms are computed in parallel, each thread having its own work space. The storms are still written to the storm file in the same order, so the output does not depend on the number of threads. This helps in widespread convection, when there may be thousands of storms per scan.");
+    tt->val_offset = (char *) &n_threads_for_props - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 1;
+    tt->single_val.i = 1;
+    tt++;
+    
     // Parameter 'set_dbz_threshold_for_tops'
     // ctype is 'tdrp_bool_t'
     
@@ -1456,6 +1496,20 @@
     tt->single_val.i = 3;
     tt++;
     
+    // Parameter 'convection_finder_n_threads'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("convection_finder_n_threads");
+    tt->descr = tdrpStrDup("Number of threads for the convection finder.");
+    tt->help = tdrpStrDup("If greater than 1, the grid is split into tiles of columns which are processed in parallel, as are the convective clumps. The result does not depend on the number of threads. The convective regions are clumped using n_threads_for_clumping.");
+    tt->val_offset = (char *) &convection_finder_n_threads - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 1;
+    tt->single_val.i = 4;
+    tt++;
+    
     // Parameter 'convection_finder_write_debug_files'
     // ctype is 'tdrp_bool_t'
     
@@ -2214,6 +2268,53 @@
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
     tt->param_name = tdrpStrDup("Comment 20");
+    tt->comment_hdr = tdrpStrDup("TRACKING CHECKPOINTS.");
+    tt->comment_text = tdrpStrDup("Titan saves the tracking state after every scan, so that tracking can continue after a restart. Only the latest state is kept, however, and if it does not match the storm file - for example after a crash part way through a scan, or when a late data file is inserted into the day - the whole day must be retracked. Checkpoints keep the tracking state for each scan, so that tracking can resume from the latest scan which still matches the storm file.");
+    tt++;
+    
+    // Parameter 'checkpoint_tracking_state'
+    // ctype is 'tdrp_bool_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = BOOL_TYPE;
+    tt->param_name = tdrpStrDup("checkpoint_tracking_state");
+    tt->descr = tdrpStrDup("Option to write a tracking checkpoint after each scan.");
+    tt->help = tdrpStrDup("If set, after each scan is tracked Titan writes a checkpoint containing the tracking state (the current storms and their forecast history, and the simple and complex track bookkeeping) together with a copy of the track header file. The track data file is not copied. Instead, the previous contents of any part of it which is rewritten after the checkpoint are saved to an undo file, so that it can be rolled back to the checkpoint. The checkpoints are written to the directory '_checkpoints/yyyymmdd' below the directory of the storm file. On restart, if the saved state does not match the storm file, Titan restores the latest matching checkpoint instead of retracking from the first scan. Old checkpoint directories may be removed by the Janitor.");
+    tt->val_offset = (char *) &checkpoint_tracking_state - &_start_;
+    tt->single_val.b = pFALSE;
+    tt++;
+    
+    // Parameter 'checkpoint_max_count'
+    // ctype is 'int'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = INT_TYPE;
+    tt->param_name = tdrpStrDup("checkpoint_max_count");
+    tt->descr = tdrpStrDup("Number of checkpoints kept for each storm file.");
+    tt->help = tdrpStrDup("If 0, the default, a checkpoint is kept for every scan of the day, so that tracking can be resumed from any scan. Checkpoints are small - the track header and the undo data for one scan. If set, checkpoints older than this number of scans are deleted. Tracking can then only be resumed within that number of scans of the last scan tracked - an older resume, for example with archive_resume_from_start_time, retracks the whole day, and a warning is printed.");
+    tt->val_offset = (char *) &checkpoint_max_count - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.i = 0;
+    tt->single_val.i = 0;
+    tt++;
+    
+    // Parameter 'archive_resume_from_start_time'
+    // ctype is 'tdrp_bool_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = BOOL_TYPE;
+    tt->param_name = tdrpStrDup("archive_resume_from_start_time");
+    tt->descr = tdrpStrDup("Option to resume ARCHIVE mode from the start time.");
+    tt->help = tdrpStrDup("Normally ARCHIVE mode starts a new storm file and processes all of the data for the day. If this is set, and a storm file already exists for the start day with matching parameters, the scans in it before the start time are kept. Tracking is restored from the checkpoint for the last kept scan, or retracked from the storm file if there is no checkpoint, and processing continues from the start time. This allows part of a day to be re-run without rebuilding the whole day.");
+    tt->val_offset = (char *) &archive_resume_from_start_time - &_start_;
+    tt->single_val.b = pFALSE;
+    tt++;
+    
+    // Parameter 'Comment 21'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = COMMENT_TYPE;
+    tt->param_name = tdrpStrDup("Comment 21");
     tt->comment_hdr = tdrpStrDup("FORECAST PARAMETERS.");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -2393,20 +2494,20 @@
     tt->single_val.i = 5;
     tt++;
     
-    // Parameter 'Comment 21'
+    // Parameter 'Comment 22'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 21");
+    tt->param_name = tdrpStrDup("Comment 22");
     tt->comment_hdr = tdrpStrDup("SMOOTHING THE MOTION FORECAST.");
     tt->comment_text = tdrpStrDup("Options for smoothing motion forecasts. The smoothed motion is computed using the motion of surrounding storms. The storms included are out to a given radius from the storm undergoing smoothing. NOTE: this will not be performed if the field tracker option is used to override the speed/dirn forecast.");
     tt++;
     
-    // Parameter 'Comment 22'
+    // Parameter 'Comment 23'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 22");
+    tt->param_name = tdrpStrDup("Comment 23");
     tt->comment_hdr = tdrpStrDup("SMOOTHING CATEGORIES.");
     tt->comment_text = tdrpStrDup("For smoothing, you can turn on the following options separately or together: (a) tracking_smooth_invalid_forecasts: smooth motion for storms without a valid forecast; (b) tracking_spatial_smoothing: smooth motion for storms with a valid forecast; (c) tracking_smooth_fast_growth_decay: smooth the forecast for storms which have a rapid growth or decay. In addition to these main categories, you can set other parameters to control the way the smoothing is done.");
     tt++;
@@ -2435,11 +2536,11 @@
     tt->single_val.b = pTRUE;
     tt++;
     
-    // Parameter 'Comment 23'
+    // Parameter 'Comment 24'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 23");
+    tt->param_name = tdrpStrDup("Comment 24");
     tt->comment_hdr = tdrpStrDup("SMOOTHING RADIUS OF INFLUENCE");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -2470,11 +2571,11 @@
     tt->single_val.i = 5;
     tt++;
     
-    // Parameter 'Comment 24'
+    // Parameter 'Comment 25'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 24");
+    tt->param_name = tdrpStrDup("Comment 25");
     tt->comment_hdr = tdrpStrDup("SMOOTHING WEIGHTS");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -2515,11 +2616,11 @@
     tt->single_val.b = pFALSE;
     tt++;
     
-    // Parameter 'Comment 25'
+    // Parameter 'Comment 26'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 25");
+    tt->param_name = tdrpStrDup("Comment 26");
     tt->comment_hdr = tdrpStrDup("SMOOTHING THRESHOLDS FOR FAST GROWTH AND DECAY");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -2560,11 +2661,11 @@
     tt->single_val.d = -0.5;
     tt++;
     
-    // Parameter 'Comment 26'
+    // Parameter 'Comment 27'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 26");
+    tt->param_name = tdrpStrDup("Comment 27");
     tt->comment_hdr = tdrpStrDup("SMOOTHING - DETECTING ERRATIC FORECASTS");
     tt->comment_text = tdrpStrDup("To determine whether a forecast is eratic, the error of the speed and direction is computed for a storm as compared with the mean motion for the storms within the radius of influence.");
     tt++;
@@ -2605,11 +2706,11 @@
     tt->single_val.d = 50;
     tt++;
     
-    // Parameter 'Comment 27'
+    // Parameter 'Comment 28'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 27");
+    tt->param_name = tdrpStrDup("Comment 28");
     tt->comment_hdr = tdrpStrDup("OVERRIDE EARLY STORM MOTION FROM FIELD TRACKER");
     tt->comment_text = tdrpStrDup("If this is activated, all other spatial smoothing will be turned off.");
     tt++;
@@ -453,6 +453,8 @@ public:
 
   char* instance;
 
+  tdrp_bool_t print_timing;
+
   mode_t mode;
 
   tdrp_bool_t auto_restart;
@@ -493,6 +495,10 @@ public:
 
   int min_grid_overlap;
 
+  int n_threads_for_clumping;
+
+  int n_threads_for_props;
+
   tdrp_bool_t set_dbz_threshold_for_tops;
 
   double tops_dbz_threshold;
@@ -551,6 +557,8 @@ public:
 
   int convection_finder_min_overlap_for_convective_clumps;
 
+  int convection_finder_n_threads;
+
   tdrp_bool_t convection_finder_write_debug_files;
 
   char* convection_finder_output_url;
@@ -632,6 +640,12 @@ public:
 
   double tracking_min_sum_fraction_overlap;
 
+  tdrp_bool_t checkpoint_tracking_state;
+
+  int checkpoint_max_count;
+
+  tdrp_bool_t archive_resume_from_start_time;
+
   forecast_type_t tracking_forecast_type;
 
   int tracking_parabolic_growth_period;
@@ -708,7 +722,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[154];
+  mutable TDRPtable _table[162];
 
   const char *_className;
 
@@ -60,7 +60,7 @@ Props::Props(const string &prog_name, const Params &params,
         _inputMdv(input_mdv),
         _sfile(storm_file),
         _verify(verify),
-        _area(_progName, _params, _inputMdv, _sfile)
+        _area(_progName, _params, _inputMdv)
 
 {
   
@@ -94,6 +94,10 @@ Props::Props(const string &prog_name, const Params &params,
 
   _hailZM.setRelationship(params.hail_ZM.coeff, params.hail_ZM.expon,
                           params.hail_mass_dbz_threshold);
+
+  memset(_stageSecs, 0, sizeof(_stageSecs));
+  memset(&_stageStart, 0, sizeof(_stageStart));
+
 }
 
 /////////////
@@ -218,21 +222,31 @@ void Props::init()
   _freezingLevel = sndg.getProfile().getFreezingLevel();
   _htMinus20 = sndg.getProfile().getHtKmForTempC(-20.0);
 
+  // clear timing
+
+  memset(_stageSecs, 0, sizeof(_stageSecs));
+
 }
 
 ////////////////////////////////////////////////
 // compute()
 //
+// The properties are loaded into sprops. The storm file
+// is not touched - see store().
+//
+// This may be called from a thread. Each thread must have its
+// own Props object.
+//
 // Returns 0 if success (clump is a valid storm)
 //         -1 if failure
 //
 
-int Props::compute(const GridClump &grid_clump, int storm_num)
+int Props::compute(const GridClump &grid_clump, StormProps &sprops)
 
       
 {
 
-  PMU_auto_register("Props::compute - computing properties");
+  _startStages();
 
   // allocate
 
@@ -261,7 +275,9 @@ int Props::compute(const GridClump &grid_clump, int storm_num)
   // from which to compute the storm properties.
   // Also, count the number of data runs for this storm.
   
-  if (_computeFirstPass(grid_clump)) {
+  int iret = _computeFirstPass(grid_clump);
+  _endStage(STAGE_FIRST_PASS);
+  if (iret) {
     return (-1);
   }
 
@@ -272,15 +288,18 @@ int Props::compute(const GridClump &grid_clump, int storm_num)
   // now that we have the necessary first pass info, compute hail metrics.
 
   _computeHailMetrics(grid_clump);
+  _endStage(STAGE_HAIL_METRICS);
 
   // perform the areal computations for precip and projected
   // areas, including dbz histogram for area
 
   _area.compute(grid_clump, &_gprops, _dbzHist);
+  _endStage(STAGE_AREA);
 
   // compute other props during second pass through intervals
   
   _computeSecondPass(grid_clump);
+  _endStage(STAGE_SECOND_PASS);
 
   // tilt angle computations
 
@@ -295,49 +314,154 @@ int Props::compute(const GridClump &grid_clump, int storm_num)
   if (_params.check_second_trip) {
     _secondTrip = _checkSecondTrip();
   }
+  _endStage(STAGE_TILT);
       
-  // write valid_storms verification file
-  
-  if (_verify) {
-    _verify->updateValidStormsGrid(grid_clump);
-  }
-
   // load up global storm properties
 
-  storm_file_global_props_t *gprops = _sfile._gprops + storm_num;
+  storm_file_global_props_t *gprops = &sprops.gprops;
   *gprops = _gprops;
   
   _loadGprops(gprops,
- 	      storm_num, _nLayers, _baseLayer, _nDbzIntvls,
+ 	      _nLayers, _baseLayer, _nDbzIntvls,
  	      _rangeLimited, _topMissing,
  	      _hailPresent, _secondTrip);
   
   // load layer props structure, for each layer
   
+  storm_file_layer_props_t zeroLayer;
+  memset(&zeroLayer, 0, sizeof(zeroLayer));
+  sprops.lprops.assign(_inputMdv.grid.nz, zeroLayer);
   for (int iz = _baseLayer; iz <= _topLayer; iz++) {
-    _loadLprops(_layer + iz, _sfile._lprops + iz - _baseLayer);
+    _loadLprops(_layer + iz, &sprops.lprops[iz - _baseLayer]);
   }
   
   // load dbz histogram struct, for each histogram interval
     
+  storm_file_dbz_hist_t zeroHist;
+  memset(&zeroHist, 0, sizeof(zeroHist));
+  sprops.hist.assign(_nDbzHistIntervals, zeroHist);
   for (int dbz_intvl = 0; dbz_intvl < _nDbzIntvls; dbz_intvl++) {
-    _loadDbzHist(_dbzHist + dbz_intvl, _sfile._hist + dbz_intvl);
+    _loadDbzHist(_dbzHist + dbz_intvl, &sprops.hist[dbz_intvl]);
   }
   
   // store runs
   
   if (_params.store_storm_runs) {
-    gprops->n_runs = _storeRuns(grid_clump);
+    gprops->n_runs = _storeRuns(grid_clump, sprops.runs);
   } else {
+    sprops.runs.clear();
     gprops->n_runs = 0;
   }
 
-  gprops->n_proj_runs = _area.storeProjRuns(grid_clump);
+  gprops->n_proj_runs = _area.loadProjRuns(grid_clump, sprops.projRuns);
+  _endStage(STAGE_RUNS);
 
   return (0);
 
 }
 
+////////////////////////////////////////////////
+// store()
+//
+// Store properties computed by compute() in the storm file
+// handle, as storm number storm_num, and update the
+// valid_storms verification grid.
+//
+// Must be called in storm order, from the main thread.
+//
+
+void Props::store(const GridClump &grid_clump,
+                  const StormProps &sprops, int storm_num)
+
+{
+
+  // write valid_storms verification file
+  
+  if (_verify) {
+    _verify->updateValidStormsGrid(grid_clump);
+  }
+
+  // make sure there is space
+
+  _sfile.AllocGprops(storm_num + 1);
+  _sfile.AllocLayers(sprops.lprops.size());
+  _sfile.AllocHist(sprops.hist.size());
+  _sfile.AllocRuns(sprops.runs.size());
+  _sfile.AllocProjRuns(sprops.projRuns.size());
+
+  // copy in
+
+  storm_file_global_props_t *gprops = _sfile._gprops + storm_num;
+  *gprops = sprops.gprops;
+  gprops->storm_num = storm_num;
+
+  if (sprops.lprops.size() > 0) {
+    memcpy(_sfile._lprops, &sprops.lprops[0],
+           sprops.lprops.size() * sizeof(storm_file_layer_props_t));
+  }
+  if (sprops.hist.size() > 0) {
+    memcpy(_sfile._hist, &sprops.hist[0],
+           sprops.hist.size() * sizeof(storm_file_dbz_hist_t));
+  }
+  if (sprops.runs.size() > 0) {
+    memcpy(_sfile._runs, &sprops.runs[0],
+           sprops.runs.size() * sizeof(storm_file_run_t));
+  }
+  if (sprops.projRuns.size() > 0) {
+    memcpy(_sfile._proj_runs, &sprops.projRuns[0],
+           sprops.projRuns.size() * sizeof(storm_file_run_t));
+  }
+
+}
+
+////////////////////////////////////////////////
+// name of computation stage, for timing report
+
+const char *Props::stageName(int stage)
+
+{
+  switch (stage) {
+    case STAGE_FIRST_PASS:
+      return "first pass";
+    case STAGE_HAIL_METRICS:
+      return "hail metrics";
+    case STAGE_AREA:
+      return "area";
+    case STAGE_SECOND_PASS:
+      return "second pass";
+    case STAGE_TILT:
+      return "tilt";
+    case STAGE_RUNS:
+      return "load results";
+    default:
+      return "unknown";
+  }
+}
+
+////////////////////////////////////////////////
+// stage timing - only if print_timing is set
+
+void Props::_startStages()
+
+{
+  if (_params.print_timing) {
+    gettimeofday(&_stageStart, NULL);
+  }
+}
+
+void Props::_endStage(int stage)
+
+{
+  if (_params.print_timing) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    _stageSecs[stage] +=
+      ((double) (now.tv_sec - _stageStart.tv_sec) +
+       (double) (now.tv_usec - _stageStart.tv_usec) * 1.0e-6);
+    _stageStart = now;
+  }
+}
+
 ////////////////////
 // _alloc()
 //
@@ -370,9 +494,6 @@ void Props::_alloc(int nz, int nhist)
 
   }
     
-  _sfile.AllocLayers(_inputMdv.grid.nz);
-  _sfile.AllocHist(_nDbzHistIntervals);
-
 }
 
 //////////////////////////////////////
@@ -617,14 +738,16 @@ int Props::_computeFirstPass(const GridClump &grid_clump)
   } // iz
 
   // vil - computed from maz dbz in each layer
+  // use the local sum, since this may run in several threads
 
-  vil_init();
+  double sumVil;
+  vil_init_local(&sumVil);
   for (int iz = 0; iz < _nzValid; iz++) {
     if (_layer[iz].n > 0) {
-      vil_add(_layer[iz].dbz_max, grid.dz);
+      vil_add_local(&sumVil, _layer[iz].dbz_max, grid.dz);
     }
   } // iz
-  _gprops.vil_from_maxz = vil_compute();
+  _gprops.vil_from_maxz = vil_compute_local(&sumVil);
   
   // dbz histograms
   
@@ -858,22 +981,24 @@ void Props::_computeSecondPass(const GridClump &grid_clump)
 ////////////////////////////////////////////      
 // _storeRuns()
 //
-// Store the storm runs
+// Store the storm runs in the runs vector
 //
 // Returns the number of runs in the clump.
 //
 
-int Props::_storeRuns(const GridClump &grid_clump)
+int Props::_storeRuns(const GridClump &grid_clump,
+                      vector<storm_file_run_t> &runs)
 
 {
   
   // make sure there is space for the runs
 
-  _sfile.AllocLayers(grid_clump.grid.nz);
-  _sfile.AllocHist(_nDbzHistIntervals);
-  _sfile.AllocRuns(grid_clump.nIntervals);
+  runs.resize(grid_clump.nIntervals);
+  if (grid_clump.nIntervals == 0) {
+    return 0;
+  }
   
-  storm_file_run_t *run = _sfile._runs;
+  storm_file_run_t *run = &runs[0];
   int start_ix = grid_clump.startIx;
   int start_iy = grid_clump.startIy;
   
@@ -1134,7 +1259,6 @@ int Props::_checkSecondTrip()
 //
 
 void Props::_loadGprops(storm_file_global_props_t *gprops,
-			int storm_num,
 			int n_layers,
 			int base_layer,
 			int n_dbz_intvls,
@@ -1145,7 +1269,6 @@ void Props::_loadGprops(storm_file_global_props_t *gprops,
 
 {
 
-  gprops->storm_num = storm_num;
   gprops->n_layers = n_layers;
   gprops->base_layer = base_layer;
   gprops->n_dbz_intervals = n_dbz_intvls;
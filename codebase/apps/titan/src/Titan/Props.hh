@@ -40,6 +40,8 @@
 #include <titan/TitanStormFile.hh>
 #include "Worker.hh"
 #include "Area.hh"
+#include <vector>
+#include <sys/time.h>
 using namespace std;
 
 class InputMdv;
@@ -94,6 +96,22 @@ typedef struct {
 
 #define MISSING_VAL -9999.0
 
+////////////////////////////////////////////////////////////
+// StormProps
+//
+// Properties computed for a single storm, held until they are
+// stored in the storm file. This allows the properties to be
+// computed in parallel, and then written out in storm order.
+
+class StormProps {
+public:
+  storm_file_global_props_t gprops;
+  vector<storm_file_layer_props_t> lprops;
+  vector<storm_file_dbz_hist_t> hist;
+  vector<storm_file_run_t> runs;
+  vector<storm_file_run_t> projRuns;
+};
+
 ////////////////////////////////
 // Props
 
@@ -111,15 +129,40 @@ public:
   
   virtual ~Props();
 
+  // stages of the computation, for timing
+
+  typedef enum {
+    STAGE_FIRST_PASS = 0,
+    STAGE_HAIL_METRICS,
+    STAGE_AREA,
+    STAGE_SECOND_PASS,
+    STAGE_TILT,
+    STAGE_RUNS,
+    N_STAGES
+  } stage_t;
+
   // initialize for latest MDV input file
   void init();
 
-  // compute properties for clump
-  int compute(const GridClump &grid_clump, int storm_num);
+  // compute properties for clump, loading them into sprops.
+  // Does not modify the storm file, so that separate Props objects
+  // may be used in separate threads.
+  // Returns 0 if the clump is a valid storm, -1 otherwise.
+  int compute(const GridClump &grid_clump, StormProps &sprops);
+
+  // store the properties in the storm file handle, ready for
+  // TitanStormFile::WriteProps(), and update verification grid
+  void store(const GridClump &grid_clump,
+             const StormProps &sprops, int storm_num);
 
   // get methods
   double getMinValidZ() const { return _minValidZ; }
 
+  // time spent in each stage of compute(), summed since init()
+  // Times are only accumulated if print_timing is set.
+  double getStageSecs(int stage) const { return _stageSecs[stage]; }
+  static const char *stageName(int stage);
+
 protected:
   
 private:
@@ -181,18 +224,25 @@ private:
   double _htMinus20;
   double _ht45AboveFreezing;
 
+  // timing
+
+  double _stageSecs[N_STAGES];
+  struct timeval _stageStart;
+
   // methods
 
   void _alloc(int nz, int nhist);
   int _computeFirstPass(const GridClump &grid_clump);
   void _computeSecondPass(const GridClump &grid_clump);
-  int _storeRuns(const GridClump &grid_clump);
+  int _storeRuns(const GridClump &grid_clump,
+                 vector<storm_file_run_t> &runs);
+  void _startStages();
+  void _endStage(int stage);
   void _tiltCompute();
   void _dbzGradientCompute();
   int _checkSecondTrip();
      
   void _loadGprops(storm_file_global_props_t *gprops,
-		   int storm_num,
 		   int n_layers,
 		   int base_layer,
 		   int n_dbz_intvls,
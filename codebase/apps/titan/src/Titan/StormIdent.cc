@@ -304,9 +304,16 @@ int StormIdent::runRealtime()
 //////////////////////////////////////////////////
 // runArchive
 
+//
+// If resume_time is set, and the storm file for the day exists with
+// matching params, the scans before resume_time are kept and
+// processing continues from resume_time. Otherwise a new file is
+// started.
+
 int StormIdent::runArchive(time_t overlap_start_time,
 			   time_t start_time,
-			   time_t end_time)
+			   time_t end_time,
+			   time_t resume_time)
 
 {
 
@@ -316,6 +323,9 @@ int StormIdent::runArchive(time_t overlap_start_time,
 	 << DateTime::str(overlap_start_time) << endl;
     cerr << "  startTime: " << DateTime::str(start_time) << endl;
     cerr << "  endTime: " << DateTime::str(end_time) << endl;
+    if (resume_time > 0) {
+      cerr << "  resumeTime: " << DateTime::str(resume_time) << endl;
+    }
     cerr << "*****************************************************" << endl;
   }
   
@@ -323,12 +333,6 @@ int StormIdent::runArchive(time_t overlap_start_time,
   
   PMU_auto_register("StormIdent::runArchive");
   
-  // create data times object
-
-  DsMdvxTimes mdvTimes;
-  mdvTimes.setArchive(_params.input_url,
-		      overlap_start_time, end_time);
-  
   // load header file path based on start time
   
   _loadHeaderFilePath(start_time);
@@ -339,19 +343,54 @@ int StormIdent::runArchive(time_t overlap_start_time,
   storm_file_params_t sparams;
   _loadStormParams(&sparams);
   
-  // prepare new storm file
+  // check for existing storm file to resume from
+
+  int lastScan = -1;
+  if (resume_time > 0 &&
+      _openAndCheck(_headerFilePath, &sparams) == 0) {
+    _findLastScanBefore(resume_time, lastScan);
+  }
+
+  // prepare storm file
   
-  if (_prepareNew(_headerFilePath, &sparams)) {
-    return -1;
+  if (lastScan < 0) {
+    if (_prepareNew(_headerFilePath, &sparams)) {
+      return -1;
+    }
+  } else {
+    if (_params.debug) {
+      cerr << "Resuming storm file after scan " << lastScan << endl;
+    }
+    if (_prepareOld(_headerFilePath, lastScan)) {
+      _prepareNew(_headerFilePath, &sparams);
+      return -1;
+    }
   }
 
   // create storm track object in case we need it
   
   StormTrack tracking(_progName, _params, _headerFilePath);
+  if (_params.perform_tracking && lastScan >= 0) {
+    if (tracking.PrepareForAppend()) {
+      _prepareNew(_headerFilePath, &sparams);
+      return -1;
+    }
+  }
+  
+  // create data times object
+
+  time_t dataStartTime = overlap_start_time;
+  if (lastScan >= 0 && resume_time > dataStartTime) {
+    dataStartTime = resume_time;
+  }
+
+  DsMdvxTimes mdvTimes;
+  mdvTimes.setArchive(_params.input_url,
+		      dataStartTime, end_time);
   
   // loop through the input radar MDV files
   
-  int scanNum = 0;
+  int scanNum = lastScan + 1;
   time_t scanTime;
   
   while (mdvTimes.getNext(scanTime) == 0) {
@@ -712,6 +751,37 @@ int StormIdent::_openAndCheck(const char *header_file_path,
 
 }
   
+/////////////////////////////////////////////////////////////////////
+//
+// Find the last scan in the open storm file which is earlier
+// than the given time.
+//
+// Returns 0 on success, -1 if there is no such scan.
+
+int StormIdent::_findLastScanBefore(time_t before_time,
+				    int &last_scan)
+
+{
+
+  last_scan = -1;
+
+  for (int iscan = _sfile._header.n_scans - 1; iscan >= 0; iscan--) {
+    if (_sfile.ReadScan(iscan)) {
+      cerr << "ERROR - " << _progName
+	   << "StormIdent::_findLastScanBefore" << endl;
+      cerr << _sfile.getErrStr() << endl;
+      return -1;
+    }
+    if (_sfile._scan.time < before_time) {
+      last_scan = iscan;
+      return 0;
+    }
+  }
+
+  return -1;
+
+}
+  
 /////////////////////////////////////////////////////////////////////
 //
 // Find the current scan, the latest scan in the file
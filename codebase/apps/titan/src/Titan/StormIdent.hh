@@ -65,7 +65,8 @@ public:
 
   int runArchive(time_t overlap_start_time,
 		 time_t start_time,
-		 time_t end_time);
+		 time_t end_time,
+		 time_t resume_time);
 
   int runForecast(time_t gen_time);
 
@@ -100,6 +101,9 @@ private:
   int _openAndCheck(const char *header_file_path,
 		    const storm_file_params_t *expected_params);
   
+  int _findLastScanBefore(time_t before_time,
+			  int &last_scan);
+
   int _findCurrentScan(const DsMdvxTimes &time_list,
 		       int &current_scan,
 		       time_t &current_time);
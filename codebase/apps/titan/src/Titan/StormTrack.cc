@@ -39,9 +39,16 @@
 #include "TrForecast.hh"
 #include <toolsa/pmu.h>
 #include <toolsa/Path.hh>
+#include <toolsa/file_io.h>
 #include <rapmath/umath.h>
+#include <dirent.h>
 using namespace std;
 
+// extensions for checkpoint state and undo files
+
+static const char *CHECKPOINT_STATE_EXT = "state";
+static const char *CHECKPOINT_UNDO_EXT = "undo";
+
 // Constructor
 
 StormTrack::StormTrack(const string &prog_name, const Params &params,
@@ -55,6 +62,19 @@ StormTrack::StormTrack(const string &prog_name, const Params &params,
   _stateFilePath += PATH_DELIM;
   _stateFilePath += "_tracking.state";
 
+  // the track file path is the same as the storm file path except
+  // for the extension. Checkpoints go in a subdirectory named for
+  // the storm file.
+
+  Path stormPath(_stormHeaderPath);
+  string trackBase = stormPath.getDirectory() + PATH_DELIM +
+    stormPath.getBase() + ".";
+  _trackHeaderPath = trackBase + TRACK_HEADER_FILE_EXT;
+  _trackDataPath = trackBase + TRACK_DATA_FILE_EXT;
+
+  _checkpointDir = stormPath.getDirectory() + PATH_DELIM +
+    "_checkpoints" + PATH_DELIM + stormPath.getBase();
+
   _filePrepared = false;
   
   _prev_scan_entry_offset = 0;
@@ -147,6 +167,10 @@ int StormTrack::ReTrack ()
     cerr << "ERROR - StormTrack::ReTrack" << endl;
     return -1;
   }
+
+  // checkpoints from an earlier track file no longer apply
+
+  _clearCheckpoints();
   
   // loop through scans
 
@@ -256,6 +280,10 @@ int StormTrack::PrepareNewFile()
     return -1;
   }
 
+  // checkpoints from an earlier track file no longer apply
+
+  _clearCheckpoints();
+
   // save the current state to file
 
   if (_saveCurrentState()) {
@@ -293,7 +321,18 @@ int StormTrack::PrepareForAppend ()
 
   int startScan;
 
-  if (_readPrevState()) {
+  // Checkpoints depend on every rewrite of the track data file being
+  // saved to an undo file, so any written while checkpointing was
+  // off cannot be used.
+
+  if (!_params.checkpoint_tracking_state) {
+    _clearCheckpoints();
+  }
+
+  // Use the saved state if it matches the storm file. If not, try the
+  // latest checkpoint which does. Otherwise retrack from scan 0.
+
+  if (_readPrevState() && _restoreCheckpoint()) {
     if (PrepareNewFile()) {
       cerr << "ERROR - StormTrack::PrepareForAppend" << endl;
       cerr << "  Read prev state failed, "
@@ -303,6 +342,9 @@ int StormTrack::PrepareForAppend ()
     startScan = 1;
   } else {
     startScan = _tfile._header.last_scan_num + 1;
+    if (_startUndo(_tfile._header.last_scan_num)) {
+      return -1;
+    }
     if (_tfile.SeekEndData()) {
       cerr << "ERROR - " << _progName
 	   << "::StormTrack::PrepareForAppend" << endl;
@@ -899,6 +941,35 @@ void StormTrack::_loadBounds(double d_hours)
 
 int StormTrack::_saveCurrentState()
 
+{
+
+  if (_writeState(_stateFilePath)) {
+    return (-1);
+  }
+
+  // a failed checkpoint is not fatal - tracking carries on
+
+  if (_params.checkpoint_tracking_state) {
+    if (_writeCheckpoint()) {
+      cerr << "WARNING - StormTrack::_saveCurrentState" << endl;
+      cerr << "  Cannot write checkpoint for scan: "
+	   << _tfile._header.last_scan_num << endl;
+    }
+  }
+
+  return (0);
+
+}
+
+/////////////////////////////////////////////////////////////////
+//
+// writes the current state to the given file
+//
+// Returns 0 on success, -1 on failure
+//
+
+int StormTrack::_writeState(const string &state_path)
+
 {
 
   int iret = 0;
@@ -907,11 +978,11 @@ int StormTrack::_saveCurrentState()
 
   // open state file
 
-  if ((fp = fopen(_stateFilePath.c_str(), "w")) == NULL) {
-    fprintf(stderr, "%s::StormTrack::_saveCurrentState\n",
+  if ((fp = fopen(state_path.c_str(), "w")) == NULL) {
+    fprintf(stderr, "%s::StormTrack::_writeState\n",
 	    _progName.c_str());
     fprintf(stderr, "Cannot create state file\n");
-    perror(_stateFilePath.c_str());
+    perror(state_path.c_str());
     return (-1);
   }
 
@@ -986,6 +1057,28 @@ int StormTrack::_saveCurrentState()
 
 int StormTrack::_readPrevState()
 
+{
+
+  // open files
+
+  if (_openFiles("r+", _stormHeaderPath.c_str())) {
+    return (-1);
+  }
+
+  return _readState(_stateFilePath);
+
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// reads the state from the given file, checking it against the
+// open storm and track files
+//
+// returns 0 if successful, -1 if not
+///
+
+int StormTrack::_readState(const string &state_path)
+
 {
 
   int flag;
@@ -996,13 +1089,6 @@ int StormTrack::_readPrevState()
   track_file_header_t theader;
   FILE *fp;
 
-
-  // open files
-
-  if (_openFiles("r+", _stormHeaderPath.c_str())) {
-    return (-1);
-  }
-
   // check that track file is valid
   
   if (!_tfile._header.file_valid) {
@@ -1024,7 +1110,7 @@ int StormTrack::_readPrevState()
       
   // open state file
 
-  if ((fp = fopen(_stateFilePath.c_str(), "r")) == NULL)
+  if ((fp = fopen(state_path.c_str(), "r")) == NULL)
     return (-1);
   
   // read  flag - if not TRUE, return because the file was not
@@ -1080,6 +1166,24 @@ int StormTrack::_readPrevState()
     fclose(fp);
     return (-1);
   }
+
+  // check that the last scan tracked is still in the storm file -
+  // the storm file may have been truncated and re-identified since
+
+  if (_sfile.ReadScan(last_scan_num)) {
+    fclose(fp);
+    return (-1);
+  }
+
+  if (_sfile.scan().time != _time1.unix_time) {
+    if (_params.debug >= Params::DEBUG_NORM) {
+      fprintf(stderr, "State does not match storm file\n");
+      fprintf(stderr, "State time: %s\n", utimstr(_time1.unix_time));
+      fprintf(stderr, "Scan time : %s\n", utimstr(_sfile.scan().time));
+    }
+    fclose(fp);
+    return (-1);
+  }
   
   _clearStorms1();
   for (int istorm = 0; istorm < nstorms1; istorm++) {
@@ -1139,6 +1243,309 @@ void StormTrack::_removeCurrentStateFile()
 
 }
 
+///////////////////////////////////////////////////////////////////////
+//
+// Write a checkpoint for the last scan tracked.
+//
+// The checkpoint holds the current state and a copy of the track
+// header file, and starts an undo file for the track data file.
+// Data is only appended to the data file, apart from in-place
+// rewrites of track params and entry links. The undo file holds the
+// previous contents of those rewrites, and the length of the data
+// file, so the data file can be rolled back to this scan later
+// without copying it.
+//
+// Returns 0 on success, -1 on failure
+//
+
+int StormTrack::_writeCheckpoint()
+
+{
+
+  int scan_num = _tfile._header.last_scan_num;
+
+  if (ta_makedir_recurse(_checkpointDir.c_str())) {
+    cerr << "ERROR - " << _progName << "::StormTrack::_writeCheckpoint" << endl;
+    cerr << "  Cannot make checkpoint dir: " << _checkpointDir << endl;
+    return -1;
+  }
+
+  // remove any old state for this scan first, so that the checkpoint
+  // cannot be read with a partly copied header
+
+  string statePath = _checkpointPath(scan_num, CHECKPOINT_STATE_EXT);
+  unlink(statePath.c_str());
+
+  // copy the track header file
+
+  _tfile.FlushFiles();
+
+  string headerPath = _checkpointPath(scan_num, TRACK_HEADER_FILE_EXT);
+  if (filecopy_by_name(headerPath.c_str(), _trackHeaderPath.c_str())) {
+    cerr << "ERROR - " << _progName << "::StormTrack::_writeCheckpoint" << endl;
+    cerr << "  Cannot copy track header file to: " << _checkpointDir << endl;
+    return -1;
+  }
+
+  // start the undo file for rewrites from here on. This closes the
+  // undo file for the previous checkpoint, so if it fails rewrites
+  // are no longer saved and the earlier checkpoints cannot be used.
+
+  if (_startUndo(scan_num)) {
+    _clearCheckpoints();
+    return -1;
+  }
+
+  // write the state
+
+  if (_writeState(statePath)) {
+    return -1;
+  }
+
+  // remove the oldest checkpoint. Since checkpoints are removed
+  // oldest first, the undo files needed to roll back to the
+  // remaining ones are kept.
+
+  if (_params.checkpoint_max_count > 0) {
+    _removeCheckpoint(scan_num - _params.checkpoint_max_count);
+  }
+
+  if (_params.debug >= Params::DEBUG_VERBOSE) {
+    cerr << "Wrote tracking checkpoint for scan " << scan_num
+	 << " to: " << _checkpointDir << endl;
+  }
+
+  return 0;
+
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Start the undo file for the track data file, for the checkpoint
+// for the given scan. The track files must be open.
+//
+// Returns 0 on success, -1 on failure
+//
+
+int StormTrack::_startUndo(int scan_num)
+
+{
+
+  if (!_params.checkpoint_tracking_state) {
+    return 0;
+  }
+
+  if (ta_makedir_recurse(_checkpointDir.c_str())) {
+    cerr << "ERROR - " << _progName << "::StormTrack::_startUndo" << endl;
+    cerr << "  Cannot make checkpoint dir: " << _checkpointDir << endl;
+    return -1;
+  }
+
+  string undoPath = _checkpointPath(scan_num, CHECKPOINT_UNDO_EXT);
+  if (_tfile.OpenUndoFile(undoPath.c_str())) {
+    cerr << "ERROR - " << _progName << "::StormTrack::_startUndo" << endl;
+    cerr << _tfile.getErrStr() << endl;
+    return -1;
+  }
+
+  return 0;
+
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Restore the tracking state from the latest checkpoint which matches
+// the storm file.
+//
+// The undo files are applied to the track data file newest first,
+// rolling it back one scan at a time, until a checkpoint is found
+// whose state matches the storm file. The header file is then copied
+// from that checkpoint. The later checkpoints no longer apply, and
+// are removed. This modifies the track files, so it is only used when
+// they cannot be appended to anyway.
+//
+// Returns 0 on success, -1 on failure
+//
+
+int StormTrack::_restoreCheckpoint()
+
+{
+
+  if (!_params.checkpoint_tracking_state) {
+    return -1;
+  }
+
+  int lastScan = _lastCheckpointScan();
+  if (lastScan < 0) {
+    return -1;
+  }
+
+  _closeFiles();
+
+  for (int scan_num = lastScan; scan_num >= 0; scan_num--) {
+
+    // roll the data file back to this scan. If this fails
+    // the data file no longer matches the checkpoints.
+
+    string undoPath = _checkpointPath(scan_num, CHECKPOINT_UNDO_EXT);
+    if (ta_stat_exists(undoPath.c_str())) {
+      if (_tfile.RollbackData(_trackDataPath.c_str(), undoPath.c_str())) {
+	cerr << "WARNING - " << _progName
+	     << "::StormTrack::_restoreCheckpoint" << endl;
+	cerr << "  Cannot roll back track data to scan: " << scan_num << endl;
+	cerr << _tfile.getErrStr() << endl;
+	break;
+      }
+    }
+
+    string statePath = _checkpointPath(scan_num, CHECKPOINT_STATE_EXT);
+    if (!ta_stat_exists(statePath.c_str())) {
+      continue;
+    }
+
+    // copy the header file into place and read the state.
+    // _readState checks that it matches the storm file.
+
+    string headerPath = _checkpointPath(scan_num, TRACK_HEADER_FILE_EXT);
+    if (filecopy_by_name(_trackHeaderPath.c_str(), headerPath.c_str())) {
+      continue;
+    }
+
+    if (_openFiles("r+", _stormHeaderPath.c_str())) {
+      _closeFiles();
+      continue;
+    }
+
+    if (_readState(statePath) ||
+	_tfile._header.last_scan_num != scan_num) {
+      _closeFiles();
+      continue;
+    }
+
+    // remove the later checkpoints, and restart the undo file
+    // for this one
+
+    for (int later = scan_num + 1; later <= lastScan; later++) {
+      _removeCheckpoint(later);
+    }
+    if (_startUndo(scan_num)) {
+      _closeFiles();
+      return -1;
+    }
+
+    if (_params.debug) {
+      cerr << "Restored tracking checkpoint for scan " << scan_num
+	   << ", time " << utimstr(_time1.unix_time) << endl;
+    }
+
+    return 0;
+
+  } // scan_num
+
+  _closeFiles();
+
+  if (_params.checkpoint_max_count > 0) {
+    cerr << "WARNING - " << _progName
+	 << "::StormTrack::_restoreCheckpoint" << endl;
+    cerr << "  No usable tracking checkpoint for: " << _stormHeaderPath << endl;
+    cerr << "  Only the last " << _params.checkpoint_max_count
+	 << " checkpoints are kept (checkpoint_max_count)." << endl;
+    cerr << "  Tracking will be redone from the first scan." << endl;
+  }
+
+  return -1;
+
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Get the latest scan number with checkpoint files.
+// Returns -1 if there are none.
+
+int StormTrack::_lastCheckpointScan() const
+
+{
+
+  DIR *dirp;
+  if ((dirp = opendir(_checkpointDir.c_str())) == NULL) {
+    return -1;
+  }
+
+  int lastScan = -1;
+  struct dirent *dp;
+  for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
+    int scan_num;
+    if (sscanf(dp->d_name, "scan_%d.", &scan_num) == 1 &&
+	scan_num > lastScan) {
+      lastScan = scan_num;
+    }
+  }
+
+  closedir(dirp);
+  return lastScan;
+
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Remove the checkpoint for a scan
+
+void StormTrack::_removeCheckpoint(int scan_num)
+
+{
+
+  if (scan_num < 0) {
+    return;
+  }
+
+  unlink(_checkpointPath(scan_num, CHECKPOINT_STATE_EXT).c_str());
+  unlink(_checkpointPath(scan_num, TRACK_HEADER_FILE_EXT).c_str());
+  unlink(_checkpointPath(scan_num, CHECKPOINT_UNDO_EXT).c_str());
+
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Remove all checkpoints for this storm file
+
+void StormTrack::_clearCheckpoints()
+
+{
+
+  _tfile.CloseUndoFile();
+
+  DIR *dirp;
+  if ((dirp = opendir(_checkpointDir.c_str())) == NULL) {
+    return;
+  }
+
+  struct dirent *dp;
+  for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
+    if (strncmp(dp->d_name, "scan_", 5)) {
+      continue;
+    }
+    string path = _checkpointDir + PATH_DELIM + dp->d_name;
+    unlink(path.c_str());
+  }
+
+  closedir(dirp);
+
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Path of a checkpoint file for a scan
+
+string StormTrack::_checkpointPath(int scan_num, const char *ext) const
+
+{
+
+  char name[64];
+  sprintf(name, "scan_%.4d.%s", scan_num, ext);
+  return _checkpointDir + PATH_DELIM + name;
+
+}
+
 ////////////////////////////////////////
 // open files
 //
@@ -1177,27 +1584,14 @@ int StormTrack::_openFiles(const char *access_mode,
     return -1;
   }
   
-  /*
-   * compute the track file path, which is the same as the storm file
-   * path except for the extension
-   */
-  
-  Path stormPath(_stormHeaderPath);
-  char trackHeaderPath[MAX_PATH_LEN];
-  sprintf(trackHeaderPath, "%s%s%s%s%s",
-	  stormPath.getDirectory().c_str(),
-	  PATH_DELIM,
-	  stormPath.getBase().c_str(),
-	  ".",
-	  TRACK_HEADER_FILE_EXT);
-  
   /*
    * open track file for writing and subsequent reading
    */
   
   _tfile.CloseFiles();
   
-  if (_tfile.OpenFiles(access_mode, trackHeaderPath, TRACK_DATA_FILE_EXT)) {
+  if (_tfile.OpenFiles(access_mode, _trackHeaderPath.c_str(),
+		       TRACK_DATA_FILE_EXT)) {
     cerr << "ERROR - " << _progName << "::StormTrack::_openFiles" << endl;
     cerr << _tfile.getErrStr() << endl;
     return -1;
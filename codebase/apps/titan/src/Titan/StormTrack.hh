@@ -84,7 +84,10 @@ private:
 
   bool _fatalError;
   string _stormHeaderPath;
+  string _trackHeaderPath;
+  string _trackDataPath;
   string _stateFilePath;
+  string _checkpointDir;
   time_t _stateTag;
   TitanStormFile _sfile;
   TitanTrackFile _tfile;
@@ -130,8 +133,24 @@ private:
 
   // match routines
 
+  // valid edge between storm1 and storm2, for the assignment
+
+  typedef struct {
+    int istorm;
+    int jstorm;
+    double cost;
+  } match_edge_t;
+
   void _matchStorms(double d_hours);
 
+  void _loadMatchEdges(double d_hours, int grid_type,
+                       vector<match_edge_t> &edges,
+                       double &max_cost);
+
+  void _matchComponent(const vector<match_edge_t> &edges,
+                       const vector<int> &edge_nums,
+                       double cost_scale);
+
   bool _matchFeasible(TrStorm &storm1, TrStorm &storm2,
 		       double d_hours, int grid_type);
 
@@ -176,16 +195,31 @@ private:
   // Returns 0 on success, -1 on failure
 
   int _saveCurrentState();
+  int _writeState(const string &state_path);
 
   // read the previous state, set up _storms1 and _trackUtime vectors
   // Returns 0 on success, -1 on failure
 
   int _readPrevState();
+  int _readState(const string &state_path);
 
   // Remove the current state file
   
   void _removeCurrentStateFile();
 
+  // Checkpoints - the state, a copy of the track header file and
+  // an undo file for the track data file, saved after each scan if
+  // checkpoint_tracking_state is set.
+  // _restoreCheckpoint() returns 0 on success, -1 on failure
+
+  int _writeCheckpoint();
+  int _startUndo(int scan_num);
+  int _restoreCheckpoint();
+  int _lastCheckpointScan() const;
+  void _removeCheckpoint(int scan_num);
+  void _clearCheckpoints();
+  string _checkpointPath(int scan_num, const char *ext) const;
+
   // storm and track file handling
 
   int _openFiles(const char *access_mode,
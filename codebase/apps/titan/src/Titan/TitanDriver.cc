@@ -216,6 +216,13 @@ int TitanDriver::_runArchive ()
 				  startTime,
 				  restartTime);
     
+    // only the first day can be resumed
+
+    time_t resumeTime = 0;
+    if (_params.archive_resume_from_start_time) {
+      resumeTime = _args.startTime;
+    }
+
     while (startTime < _args.endTime) {
       
       // register with procmap
@@ -225,7 +232,8 @@ int TitanDriver::_runArchive ()
       // run
 
       StormIdent ident(_progName, _params);
-      if (ident.runArchive(overlapStartTime, startTime, restartTime)) {
+      if (ident.runArchive(overlapStartTime, startTime, restartTime,
+			   resumeTime)) {
 	cerr << "ERROR - TitanDriver::_runArchive" << endl;
 	return -1;
       }
@@ -235,6 +243,7 @@ int TitanDriver::_runArchive ()
       overlapStartTime += SECS_IN_DAY;
       startTime += SECS_IN_DAY;
       restartTime += SECS_IN_DAY;
+      resumeTime = 0;
 
     } // while
 
@@ -242,8 +251,14 @@ int TitanDriver::_runArchive ()
 
     // no auto restart
 
+    time_t resumeTime = 0;
+    if (_params.archive_resume_from_start_time) {
+      resumeTime = _args.startTime;
+    }
+
     StormIdent ident(_progName, _params);
-    if (ident.runArchive(_args.startTime, _args.startTime, _args.endTime)) {
+    if (ident.runArchive(_args.startTime, _args.startTime, _args.endTime,
+			 resumeTime)) {
       cerr << "ERROR - TitanDriver::_runArchive" << endl;
       return -1;
     }
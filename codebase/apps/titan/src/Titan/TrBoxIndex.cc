@@ -0,0 +1,243 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// TrBoxIndex.cc
+//
+// TrBoxIndex class - uniform-grid spatial index of bounding boxes,
+// used in tracking to find the storms near a given storm without
+// testing every pair.
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#include "TrBoxIndex.hh"
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+//////////////
+// constructor
+//
+
+TrBoxIndex::TrBoxIndex()
+
+{
+  _minX = 0.0;
+  _minY = 0.0;
+  _cellSize = 1.0;
+  _nx = 0;
+  _ny = 0;
+  _queryNum = 0;
+}
+
+/////////////
+// destructor
+//
+
+TrBoxIndex::~TrBoxIndex()
+
+{
+}
+
+///////////////////
+// clear the index
+
+void TrBoxIndex::clear()
+
+{
+  _boxes.clear();
+  _cells.clear();
+  _stamp.clear();
+  _nx = 0;
+  _ny = 0;
+  _queryNum = 0;
+}
+
+/////////////
+// add a box
+
+void TrBoxIndex::add(int id,
+                     double min_x, double min_y,
+                     double max_x, double max_y)
+
+{
+  box_t box;
+  box.id = id;
+  box.min_x = min_x;
+  box.min_y = min_y;
+  box.max_x = max_x;
+  box.max_y = max_y;
+  _boxes.push_back(box);
+}
+
+//////////////////////////////////////////////////////
+// build the index
+
+void TrBoxIndex::build(double cell_size)
+
+{
+
+  _cells.clear();
+  _stamp.assign(_boxes.size(), 0);
+  _queryNum = 0;
+  _nx = 0;
+  _ny = 0;
+
+  if (_boxes.size() == 0) {
+    return;
+  }
+
+  // extent of the boxes
+
+  double maxX, maxY;
+  _minX = _boxes[0].min_x;
+  _minY = _boxes[0].min_y;
+  maxX = _boxes[0].max_x;
+  maxY = _boxes[0].max_y;
+  for (size_t ii = 1; ii < _boxes.size(); ii++) {
+    const box_t &box = _boxes[ii];
+    _minX = min(_minX, box.min_x);
+    _minY = min(_minY, box.min_y);
+    maxX = max(maxX, box.max_x);
+    maxY = max(maxY, box.max_y);
+  }
+
+  // choose the cell size - limit the number of cells to
+  // a few per box, so that memory scales with the number of boxes
+
+  double rangeX = maxX - _minX;
+  double rangeY = maxY - _minY;
+  double maxCells = 4.0 * (double) _boxes.size() + 16.0;
+  _cellSize = cell_size;
+  if (!(_cellSize > 0.0)) {
+    _cellSize = 1.0;
+  }
+  double minCellSize = sqrt((rangeX * rangeY) / maxCells);
+  if (_cellSize < minCellSize) {
+    _cellSize = minCellSize;
+  }
+  while (((rangeX / _cellSize) + 1.0) * ((rangeY / _cellSize) + 1.0) >
+         maxCells) {
+    _cellSize *= 2.0;
+  }
+  
+  _nx = (int) (rangeX / _cellSize) + 1;
+  _ny = (int) (rangeY / _cellSize) + 1;
+  _cells.resize(_nx * _ny);
+
+  // load the boxes into the cells they touch
+
+  for (size_t ii = 0; ii < _boxes.size(); ii++) {
+    const box_t &box = _boxes[ii];
+    int ix1 = _cellX(box.min_x);
+    int ix2 = _cellX(box.max_x);
+    int iy1 = _cellY(box.min_y);
+    int iy2 = _cellY(box.max_y);
+    for (int iy = iy1; iy <= iy2; iy++) {
+      for (int ix = ix1; ix <= ix2; ix++) {
+        _cells[iy * _nx + ix].push_back((int) ii);
+      }
+    }
+  }
+
+}
+
+//////////////////////////////////////////////////////
+// find the ids of boxes which intersect the query box
+
+void TrBoxIndex::query(double min_x, double min_y,
+                       double max_x, double max_y,
+                       vector<int> &ids)
+
+{
+
+  ids.clear();
+  if (_nx == 0 || _ny == 0) {
+    return;
+  }
+
+  _queryNum++;
+  if (_queryNum == 0) {
+    // wrapped - reset the stamps
+    _stamp.assign(_boxes.size(), 0);
+    _queryNum = 1;
+  }
+
+  int ix1 = _cellX(min_x);
+  int ix2 = _cellX(max_x);
+  int iy1 = _cellY(min_y);
+  int iy2 = _cellY(max_y);
+
+  for (int iy = iy1; iy <= iy2; iy++) {
+    for (int ix = ix1; ix <= ix2; ix++) {
+      const vector<int> &cell = _cells[iy * _nx + ix];
+      for (size_t jj = 0; jj < cell.size(); jj++) {
+        int index = cell[jj];
+        if (_stamp[index] == _queryNum) {
+          continue;
+        }
+        _stamp[index] = _queryNum;
+        const box_t &box = _boxes[index];
+        if (box.min_x <= max_x && box.max_x >= min_x &&
+            box.min_y <= max_y && box.max_y >= min_y) {
+          ids.push_back(box.id);
+        }
+      } // jj
+    } // ix
+  } // iy
+
+  sort(ids.begin(), ids.end());
+
+}
+
+//////////////////////////////////////////////
+// compute cell index, clamping to the grid
+
+int TrBoxIndex::_cellX(double xx) const
+
+{
+  double dd = (xx - _minX) / _cellSize;
+  if (!(dd > 0.0)) {
+    return 0;
+  }
+  if (dd >= (double) (_nx - 1)) {
+    return _nx - 1;
+  }
+  return (int) dd;
+}
+
+int TrBoxIndex::_cellY(double yy) const
+
+{
+  double dd = (yy - _minY) / _cellSize;
+  if (!(dd > 0.0)) {
+    return 0;
+  }
+  if (dd >= (double) (_ny - 1)) {
+    return _ny - 1;
+  }
+  return (int) dd;
+}
+
@@ -0,0 +1,114 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// TrBoxIndex.hh
+//
+// TrBoxIndex class - uniform-grid spatial index of bounding boxes,
+// used in tracking to find the storms near a given storm without
+// testing every pair.
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#ifndef TrBoxIndex_HH
+#define TrBoxIndex_HH
+
+#include <vector>
+using namespace std;
+
+////////////////////////////////
+// TrBoxIndex
+
+class TrBoxIndex {
+  
+public:
+
+  // constructor
+
+  TrBoxIndex();
+
+  // destructor
+  
+  virtual ~TrBoxIndex();
+
+  // clear the index
+
+  void clear();
+
+  // Add a box, with the given id. A point is a box with
+  // min == max. Boxes are held until build() is called.
+
+  void add(int id,
+           double min_x, double min_y,
+           double max_x, double max_y);
+
+  // Build the index from the boxes added so far.
+  // cell_size is the preferred size of the index cells, in the
+  // same units as the boxes. It is increased if necessary to keep
+  // the number of cells of the order of the number of boxes.
+  
+  void build(double cell_size);
+
+  // Find the ids of the boxes which intersect the query box.
+  // The ids are returned in ascending order, with no duplicates.
+
+  void query(double min_x, double min_y,
+             double max_x, double max_y,
+             vector<int> &ids);
+
+  // number of boxes in index
+
+  int getNBoxes() const { return (int) _boxes.size(); }
+
+protected:
+  
+private:
+
+  typedef struct {
+    int id;
+    double min_x, min_y;
+    double max_x, max_y;
+  } box_t;
+
+  vector<box_t> _boxes;
+
+  // grid of cells, each holding indices into _boxes
+
+  double _minX, _minY;
+  double _cellSize;
+  int _nx, _ny;
+  vector< vector<int> > _cells;
+
+  // for removing duplicates during query
+
+  vector<int> _stamp;
+  int _queryNum;
+
+  int _cellX(double xx) const;
+  int _cellY(double yy) const;
+
+};
+
+#endif
@@ -34,8 +34,10 @@
 ///////////////////////////////////////////////////////////////
 
 #include "StormTrack.hh"
+#include "TrBoxIndex.hh"
 #include <rapmath/umath.h>
 #include <toolsa/pjg.h>
+#include <algorithm>
 using namespace std;
 
 /*********************************************************************
@@ -43,6 +45,15 @@ using namespace std;
  *
  * match storms from time1 to time2
  *
+ * Only storm pairs closer than the distance which could be covered
+ * at tracking_max_speed are considered - these are found using a
+ * spatial index of the storm2 centroids. The resulting sparse set of
+ * valid edges is split into its connected components, and the
+ * assignment problem is solved separately for each component.
+ * Since the components do not interact, the combined match is
+ * the optimal match for the whole problem, but the cost matrices
+ * are only as large as the components.
+ *
  *********************************************************************/
 
 #define MAX_ELT 100000
@@ -52,74 +63,150 @@ void StormTrack::_matchStorms(double d_hours)
 
 {
   
-  int transpose;
-  int grid_type;
+  /*
+   * set local vars
+   */
 
-  int nvalid_edges = 0;
-  long **icost;
-  long *match;
-  int dim1, dim2;
-  int max_storms;
+  int grid_type = _sfile.scan().grid.proj_type;
+  int n1 = (int) _storms1.size();
+  int n2 = (int) _storms2.size();
+  int max_storms = MAX(n1, n2);
   
-  double *xx1, *yy1, *xx2, *yy2;
-  double distance, dx_km, dy_km;
-  double x_km_scale, y_km_scale;
-  double mean_lat, cos_lat;
-  double delta_cube_root_volume;
-  double speed;
-  double cost_scale;
-  double cost, max_cost;
-  double **dcost;
-
   /*
-   * set local vars
+   * find the valid edges
    */
 
-  grid_type = _sfile.scan().grid.proj_type;
+  vector<match_edge_t> edges;
+  double max_cost = 0.0;
+  _loadMatchEdges(d_hours, grid_type, edges, max_cost);
+
+  if (edges.size() == 0) {
+    if (_params.debug >= Params::DEBUG_EXTRA) {
+      fprintf(stderr, "No valid tracks for match_storms()\n");
+    }
+    return;
+  }
 
   /*
-   * set dimensions of cost array. Note that the matrix must
-   * be transposed if _storms1.size() exceeds _storms2.size(),
-   * because dim1 must be less than or equal to dim2
+   * compute cost scale factor
    */
+  
+  double cost_scale =
+    (double) MAX_ELT / (max_cost * (double) (max_storms + 1));
+  
+  if (_params.debug >= Params::DEBUG_VERBOSE) {
+    fprintf(stderr, "n_valid_edges = %d\n", (int) edges.size());
+    fprintf(stderr, "max_cost = %g\n", max_cost);
+    fprintf(stderr, "cost_scale = %g\n", cost_scale);
+  }
 
-  if (_storms1.size() <= _storms2.size()) {
-    dim1 = _storms1.size();
-    dim2 = _storms2.size();
-    transpose = FALSE;
-    max_storms = _storms2.size();
-  } else {
-    dim1 = _storms2.size();
-    dim2 = _storms1.size();
-    transpose = TRUE;
-    max_storms = _storms1.size();
+  /*
+   * find the connected components of the graph, using union-find.
+   * storms1 are nodes 0 to n1-1, storms2 are nodes n1 to n1+n2-1.
+   */
+  
+  vector<int> parent(n1 + n2);
+  for (int ii = 0; ii < n1 + n2; ii++) {
+    parent[ii] = ii;
+  }
+  for (size_t iedge = 0; iedge < edges.size(); iedge++) {
+    int aa = edges[iedge].istorm;
+    int bb = n1 + edges[iedge].jstorm;
+    while (parent[aa] != aa) {
+      parent[aa] = parent[parent[aa]];
+      aa = parent[aa];
+    }
+    while (parent[bb] != bb) {
+      parent[bb] = parent[parent[bb]];
+      bb = parent[bb];
+    }
+    if (aa != bb) {
+      parent[MAX(aa, bb)] = MIN(aa, bb);
+    }
   }
 
   /*
-   * allocate mem for cost arrays and match arrray
+   * group the edges by component, in order of first appearance
    */
 
-  dcost = (double **) ucalloc2
-    (_storms1.size(), _storms2.size(), sizeof(double));
+  vector<int> compIndex(n1 + n2, -1);
+  vector< vector<int> > compEdges;
+  for (size_t iedge = 0; iedge < edges.size(); iedge++) {
+    int root = edges[iedge].istorm;
+    while (parent[root] != root) {
+      root = parent[root];
+    }
+    if (compIndex[root] < 0) {
+      compIndex[root] = (int) compEdges.size();
+      compEdges.push_back(vector<int>());
+    }
+    compEdges[compIndex[root]].push_back((int) iedge);
+  }
+
+  if (_params.debug >= Params::DEBUG_VERBOSE) {
+    fprintf(stderr, "n_components = %d\n", (int) compEdges.size());
+  }
 
-  icost = (long **) ucalloc2
-    (dim1, dim2, sizeof(long));
+  /*
+   * get the bipartite match for each component
+   */
 
-  match = (long *) ucalloc
-    ((_storms1.size() + _storms2.size()), sizeof(long));
+  for (size_t icomp = 0; icomp < compEdges.size(); icomp++) {
+    _matchComponent(edges, compEdges[icomp], cost_scale);
+  }
 
-  xx1 = (double *) umalloc
-    ((_storms1.size() * sizeof(double)));
+  /*
+   * print out the match
+   */
+  
+  if (_params.debug >= Params::DEBUG_EXTRA) {
+    
+    fprintf(stderr, "Matching 1 to 2\n");
+    
+    for (size_t i = 0; i < _storms1.size(); i++)
+      fprintf(stderr, "i = %d, match1 = %d\n", (int) i,
+              (int) _storms1[i]->status.match);
+    
+    fprintf(stderr, "\n");
+    
+    fprintf(stderr, "Matching 2 to 1:\n");
+    
+    for (size_t j = 0; j < _storms2.size(); j++)
+      fprintf(stderr, "j = %d, match2 = %d\n", (int) j,
+              (int) _storms2[j]->status.match);
+    
+    fprintf(stderr, "\n");
+    
+  } /* if (_params.debug ... */
 
-  yy1 = (double *) umalloc
-    ((_storms1.size() * sizeof(double)));
+}
 
-  xx2 = (double *) umalloc
-    ((_storms2.size() * sizeof(double)));
+/*********************************************************************
+ * _loadMatchEdges()
+ *
+ * Load up the valid edges between storms1 and storms2,
+ * with their costs. Also sets max_cost.
+ *
+ *********************************************************************/
 
-  yy2 = (double *) umalloc
-    ((_storms2.size() * sizeof(double)));
+void StormTrack::_loadMatchEdges(double d_hours, int grid_type,
+                                 vector<match_edge_t> &edges,
+                                 double &max_cost)
   
+{
+
+  double distance, dx_km, dy_km;
+  double x_km_scale, y_km_scale;
+  double mean_lat, cos_lat;
+  double delta_cube_root_volume;
+  double speed;
+  double cost;
+
+  edges.clear();
+  max_cost = 0.0;
+
+  const storm_file_global_props_t *gprops = _sfile.gprops();
+
   /*
    * load up storm coordinates
    */
@@ -128,8 +215,7 @@ void StormTrack::_matchStorms(double d_hours)
     fprintf(stderr, "Storms at time 1:\n");
   }
 
-  const storm_file_global_props_t *gprops = _sfile.gprops();
-
+  vector<double> xx1(_storms1.size()), yy1(_storms1.size());
   for (size_t i = 0; i < _storms1.size(); i++) {
     
     xx1[i] = _storms1[i]->current.proj_area_centroid_x;
@@ -146,6 +232,7 @@ void StormTrack::_matchStorms(double d_hours)
     fprintf(stderr, "Storms at time 2:\n");
   }
 
+  vector<double> xx2(_storms2.size()), yy2(_storms2.size());
   for (size_t j = 0; j < _storms2.size(); j++) {
     
     xx2[j] = gprops[j].proj_area_centroid_x;
@@ -157,281 +244,280 @@ void StormTrack::_matchStorms(double d_hours)
     }
     
   } /* j */
-  
+
   /*
-   * load up the dcost array
+   * Index the storm2 centroids. Storms already matched using
+   * overlaps are left out, since those edges are invalid.
+   * The max distance is that covered at the max tracking speed.
    */
 
-  max_cost = 0.0;
-
-  for (size_t i = 0; i < _storms1.size(); i++) {
-
-    for (size_t j = 0; j < _storms2.size(); j++) {
-
-      if (_storms1[i]->status.n_match > 0 ||
-	  _storms2[j]->status.n_match > 0) {
-	
-	/*
-	 * already matched, so set edge invalid
-	 */
-
-	dcost[i][j] = -1.0;
-
-	if (_params.debug >= Params::DEBUG_EXTRA) {
-	  fprintf(stderr, "Already matched using overlaps\n");
-	  fprintf(stderr, "Storm i - %d to storm j - %d\n", (int) i, (int) j);
-	  fprintf(stderr, "xx1[i], yy1[i]: (%g, %g)\n", xx1[i], yy1[i]);
-	  fprintf(stderr, "xx2[j], yy2[j]: (%g, %g)\n", xx2[j], yy2[j]);
-	  fprintf(stderr, "Already matched using overlaps\n");
-	}
-
-      } else {
-
-	if (grid_type == TITAN_PROJ_LATLON) {
-	  
-	  /*
-	   * compute factors to convert delta lat/lon to km
-	   */
-	
-	  mean_lat = (yy2[j] + yy1[i]) / 2.0;
-	  cos_lat = cos(mean_lat * DEG_TO_RAD);
-	  x_km_scale = KM_PER_DEG_AT_EQUATOR * cos_lat;
-	  y_km_scale = KM_PER_DEG_AT_EQUATOR;
-	
-	} else {
-	  
-	  x_km_scale = 1.0;
-	  y_km_scale = 1.0;
-	  
-	}
-	
-	dx_km = (xx2[j] - xx1[i]) * x_km_scale;
-	dy_km = (yy2[j] - yy1[i]) * y_km_scale;
-	
-	distance = sqrt (dx_km * dx_km + dy_km * dy_km);
-	speed = distance / d_hours;
-	
-	delta_cube_root_volume =
-	  fabs(pow((double) gprops[j].volume, 0.33333333) -
-	       pow((double) _storms1[i]->current.volume, 0.33333333));
-	
-	if (speed <= _params.tracking_max_speed &&
-	    _matchFeasible(*_storms1[i], *_storms2[j],
-			    d_hours, grid_type)) {
-	  
-	  /*
-	   * edge is valid
-	   */
-	  
-	  cost = 
-	    (distance * _params.tracking_weight_distance +
-	     delta_cube_root_volume *
-	     _params.tracking_weight_delta_cube_root_volume);
-	  
-	  if (max_cost < cost)
-	    max_cost = cost;
-	  
-	  dcost[i][j] = cost;
-	  
-	  nvalid_edges++;
-	  
-	} else {
-	  
-	  /*
-	   * edge is not valid
-	   */
-	  
-	  dcost[i][j] = -1.0;
-	  
-	} /* if (speed <= _params.tracking_max_speed ... */
-
-	if (_params.debug >= Params::DEBUG_EXTRA) {
-	  fprintf(stderr, "Storm i - %d to storm j - %d\n", (int) i, (int) j);
-	  fprintf(stderr, "xx1[i], yy1[i]: (%g, %g)\n", xx1[i], yy1[i]);
-	  fprintf(stderr, "xx2[j], yy2[j]: (%g, %g)\n", xx2[j], yy2[j]);
-	  fprintf(stderr, "distance, d_hours, speed = %g, %g, %g\n",
-		  distance, d_hours, speed);
-	  if (dcost[i][j] < 0) {
-	    fprintf(stderr, "Edge INVALID\n");
-	  } else {
-	    fprintf(stderr, "Edge valid\n");
-	  }
-	}
+  double max_dist_km = fabs(_params.tracking_max_speed * d_hours);
+  double max_dy = max_dist_km;
+  if (grid_type == TITAN_PROJ_LATLON) {
+    max_dy = max_dist_km / KM_PER_DEG_AT_EQUATOR;
+  }
+  
+  TrBoxIndex index;
+  for (size_t j = 0; j < _storms2.size(); j++) {
+    if (_storms2[j]->status.n_match == 0) {
+      index.add(j, xx2[j], yy2[j], xx2[j], yy2[j]);
+    }
+  }
+  index.build(max_dy);
 
-      } /* if (storms1[i]->n_match > 0  ... */
-	
-    } /* j */
+  /*
+   * load up the valid edges
+   */
 
-  } /* i */
+  vector<int> nearby;
 
-  if (nvalid_edges > 0) {
+  for (size_t i = 0; i < _storms1.size(); i++) {
 
+    if (_storms1[i]->status.n_match > 0) {
+      /*
+       * already matched, so edges are invalid
+       */
+      continue;
+    }
+    
     /*
-     * compute cost scale factor
+     * search box - enlarged slightly so that rounding
+     * cannot exclude a valid edge
      */
 
-    cost_scale = (double) MAX_ELT / (max_cost * (double) (max_storms + 1));
-
-    if (_params.debug >= Params::DEBUG_VERBOSE) {
-      fprintf(stderr, "max_cost = %g\n", max_cost);
-      fprintf(stderr, "cost_scale = %g\n", cost_scale);
+    double max_dx = max_dist_km;
+    if (grid_type == TITAN_PROJ_LATLON) {
+      double max_lat = fabs(yy1[i]) + max_dy;
+      if (max_lat < 89.0) {
+        max_dx = max_dist_km /
+          (KM_PER_DEG_AT_EQUATOR * cos(max_lat * DEG_TO_RAD));
+      } else {
+        max_dx = 360.0;
+      }
     }
-
-    /*
-     * load up integer cost matrix, transposing as necessary to fulfil the
-     * requirement that the first dimension must not exceed the second.
-     * Also, the entries are subtracted from MAX_ELT so that the problem
-     * may be treated as one of maximization rather than minimization.
-     */
+    double search_dx = max_dx * 1.01 + 1.0e-6;
+    double search_dy = max_dy * 1.01 + 1.0e-6;
     
-    for (size_t i = 0; i < _storms1.size(); i++) {
+    index.query(xx1[i] - search_dx, yy1[i] - search_dy,
+                xx1[i] + search_dx, yy1[i] + search_dy,
+                nearby);
 
-      size_t k = 0, l = 0;
+    for (size_t jj = 0; jj < nearby.size(); jj++) {
 
-      if (transpose == FALSE)
-	k = i;
-      else
-	l = i;
-      
-      for (size_t j = 0; j < _storms2.size(); j++) {
+      size_t j = nearby[jj];
 
-	if (transpose == FALSE)
-	  l = j;
-	else
-	  k = j;
+      if (grid_type == TITAN_PROJ_LATLON) {
 	
-	cost = dcost[i][j];
+	/*
+	 * compute factors to convert delta lat/lon to km
+	 */
 	
-	if (cost < 0) {
-	  icost[k][l] = MAX_ELT / 2;
-	} else {
-	  icost[k][l] = MAX_ELT - (int) (cost * cost_scale + 0.5);
-	}
-
-      } /* j */
+	mean_lat = (yy2[j] + yy1[i]) / 2.0;
+	cos_lat = cos(mean_lat * DEG_TO_RAD);
+	x_km_scale = KM_PER_DEG_AT_EQUATOR * cos_lat;
+	y_km_scale = KM_PER_DEG_AT_EQUATOR;
+	
+      } else {
+	
+	x_km_scale = 1.0;
+	y_km_scale = 1.0;
+	
+      }
       
-    } /* i */
-
-    /*
-     * print out icost matrix
-     */
-    
-    if (_params.debug >= Params::DEBUG_EXTRA) {
+      dx_km = (xx2[j] - xx1[i]) * x_km_scale;
+      dy_km = (yy2[j] - yy1[i]) * y_km_scale;
       
-      fprintf(stderr, "\nICOST MATRIX\n\n");
+      distance = sqrt (dx_km * dx_km + dy_km * dy_km);
+      speed = distance / d_hours;
       
-      if (transpose)
-	fprintf(stderr, "j\\i ");
-      else
-	fprintf(stderr, "i\\j ");
+      delta_cube_root_volume =
+	fabs(pow((double) gprops[j].volume, 0.33333333) -
+	     pow((double) _storms1[i]->current.volume, 0.33333333));
       
-      for (int j = 0; j < dim2; j++) {
-	fprintf(stderr, " %6d", j);
-      }
-      fprintf(stderr, "\n");
+      bool valid = false;
+      if (speed <= _params.tracking_max_speed &&
+	  _matchFeasible(*_storms1[i], *_storms2[j],
+			 d_hours, grid_type)) {
+	
+	/*
+	 * edge is valid
+	 */
+	
+	cost = 
+	  (distance * _params.tracking_weight_distance +
+	   delta_cube_root_volume *
+	   _params.tracking_weight_delta_cube_root_volume);
+	
+	if (max_cost < cost)
+	  max_cost = cost;
+
+	match_edge_t edge;
+	edge.istorm = i;
+	edge.jstorm = j;
+	edge.cost = cost;
+	edges.push_back(edge);
+	valid = true;
+	
+      } /* if (speed <= _params.tracking_max_speed ... */
       
-      for (int i = 0; i < dim1; i++) {
-	fprintf(stderr, "%4d", i);
-	for (int j = 0; j < dim2; j++) {
-	  fprintf(stderr, " %6ld", icost[i][j]);
+      if (_params.debug >= Params::DEBUG_EXTRA) {
+	fprintf(stderr, "Storm i - %d to storm j - %d\n", (int) i, (int) j);
+	fprintf(stderr, "xx1[i], yy1[i]: (%g, %g)\n", xx1[i], yy1[i]);
+	fprintf(stderr, "xx2[j], yy2[j]: (%g, %g)\n", xx2[j], yy2[j]);
+	fprintf(stderr, "distance, d_hours, speed = %g, %g, %g\n",
+		distance, d_hours, speed);
+	if (!valid) {
+	  fprintf(stderr, "Edge INVALID\n");
+	} else {
+	  fprintf(stderr, "Edge valid\n");
 	}
-	fprintf(stderr, "\n");
-      } /* i */
+      }
       
-    } /* if (_params.debug ... ) */
-    
-    /*
-     * get the bipartite match
-     */
-    
-    umax_wt_bip(icost, dim1, dim2, (int) MAX_ELT / 2, match);
-    
-    /*
-     * load local match arrays. match1 contains the storm numbers at time2
-     * which correspond to storms at time 1, and vice versa for match2.
-     */
-
-    if (transpose) {
-
-      if (_params.debug >= Params::DEBUG_VERBOSE)
-	fprintf(stderr, "\nCost matrix transposed.\n\n");
-
-      for (size_t i = 0; i < _storms2.size(); i++) {
-
-	if (match[i] >= 0) {
+    } /* jj */
 
-	  _storms2[i]->status.match = match[i];
-	  _storms1[match[i]]->status.match = i;
+  } /* i */
 
-	} /* if (match[i] >= 0) */
+}
 
-      } /* i */
+/*********************************************************************
+ * _matchComponent()
+ *
+ * Solve the assignment problem for one connected component
+ * of the graph of valid edges, and set the match for the storms.
+ *
+ *********************************************************************/
 
-    } else {
+void StormTrack::_matchComponent(const vector<match_edge_t> &edges,
+                                 const vector<int> &edge_nums,
+                                 double cost_scale)
+  
+{
 
-      for (size_t i = 0; i < _storms1.size(); i++) {
+  /*
+   * find the storms in this component, and their local indices
+   */
 
-	if (match[i] >= 0) {
+  vector<int> storms1, storms2;
+  for (size_t ii = 0; ii < edge_nums.size(); ii++) {
+    const match_edge_t &edge = edges[edge_nums[ii]];
+    storms1.push_back(edge.istorm);
+    storms2.push_back(edge.jstorm);
+  }
+  sort(storms1.begin(), storms1.end());
+  storms1.erase(unique(storms1.begin(), storms1.end()), storms1.end());
+  sort(storms2.begin(), storms2.end());
+  storms2.erase(unique(storms2.begin(), storms2.end()), storms2.end());
 
-	  _storms1[i]->status.match = match[i];
-	  _storms2[match[i]]->status.match = i;
+  int nn1 = (int) storms1.size();
+  int nn2 = (int) storms2.size();
+  
+  /*
+   * set dimensions of cost array. Note that the matrix must
+   * be transposed if nn1 exceeds nn2, because dim1 must be less
+   * than or equal to dim2
+   */
 
-	} /* if (match[i] >= 0) */
+  int dim1, dim2;
+  bool transpose;
+  if (nn1 <= nn2) {
+    dim1 = nn1;
+    dim2 = nn2;
+    transpose = false;
+  } else {
+    dim1 = nn2;
+    dim2 = nn1;
+    transpose = true;
+  }
+  
+  long **icost = (long **) ucalloc2(dim1, dim2, sizeof(long));
+  long *match = (long *) ucalloc(dim1 + dim2, sizeof(long));
 
-      } /* i */
+  /*
+   * load up integer cost matrix, transposing as necessary.
+   * Invalid edges are set to MAX_ELT / 2, and the valid entries
+   * are subtracted from MAX_ELT so that the problem may be
+   * treated as one of maximization rather than minimization.
+   */
 
-    } /* if (transpose) */
+  for (int k = 0; k < dim1; k++) {
+    for (int l = 0; l < dim2; l++) {
+      icost[k][l] = MAX_ELT / 2;
+    }
+  }
 
-    /*
-     * print out the match
-     */
+  for (size_t ii = 0; ii < edge_nums.size(); ii++) {
+    const match_edge_t &edge = edges[edge_nums[ii]];
+    int i = lower_bound(storms1.begin(), storms1.end(), edge.istorm) -
+      storms1.begin();
+    int j = lower_bound(storms2.begin(), storms2.end(), edge.jstorm) -
+      storms2.begin();
+    long val = MAX_ELT - (int) (edge.cost * cost_scale + 0.5);
+    if (transpose) {
+      icost[j][i] = val;
+    } else {
+      icost[i][j] = val;
+    }
+  }
 
-    if (_params.debug >= Params::DEBUG_EXTRA) {
-      
-      fprintf(stderr, "Match array\n");
-      
-      for (size_t i = 0; i < _storms1.size() + _storms2.size(); i++)
-	fprintf(stderr, "i = %d, match = %ld\n", (int) i, match[i]);
-      
+  /*
+   * print out icost matrix
+   */
+  
+  if (_params.debug >= Params::DEBUG_EXTRA) {
+    
+    fprintf(stderr, "\nICOST MATRIX\n\n");
+    
+    if (transpose)
+      fprintf(stderr, "j\\i ");
+    else
+      fprintf(stderr, "i\\j ");
+    
+    for (int l = 0; l < dim2; l++) {
+      fprintf(stderr, " %6d", transpose ? storms1[l] : storms2[l]);
+    }
+    fprintf(stderr, "\n");
+    
+    for (int k = 0; k < dim1; k++) {
+      fprintf(stderr, "%4d", transpose ? storms2[k] : storms1[k]);
+      for (int l = 0; l < dim2; l++) {
+	fprintf(stderr, " %6ld", icost[k][l]);
+      }
       fprintf(stderr, "\n");
+    } /* k */
+    
+  } /* if (_params.debug ... ) */
 
-      fprintf(stderr, "Matching 1 to 2\n");
+  /*
+   * get the bipartite match
+   */
+  
+  umax_wt_bip(icost, dim1, dim2, (int) MAX_ELT / 2, match);
 
-      for (size_t i = 0; i < _storms1.size(); i++)
-	fprintf(stderr, "i = %d, match1 = %d\n", (int) i,
-		(int) _storms1[i]->status.match);
-      
-      fprintf(stderr, "\n");
+  /*
+   * load the match into the storms, converting from local indices
+   */
 
-      fprintf(stderr, "Matching 2 to 1:\n");
+  for (int k = 0; k < dim1; k++) {
+    
+    if (match[k] >= 0) {
       
-      for (size_t j = 0; j < _storms2.size(); j++)
-	fprintf(stderr, "j = %d, match2 = %d\n", (int) j,
-		(int) _storms2[j]->status.match);
+      int i, j;
+      if (transpose) {
+	j = storms2[k];
+	i = storms1[match[k]];
+      } else {
+	i = storms1[k];
+	j = storms2[match[k]];
+      }
+      _storms1[i]->status.match = j;
+      _storms2[j]->status.match = i;
       
-      fprintf(stderr, "\n");
-
-    } /* if (_params.debug ... */
-
-  } else {
-
-    if (_params.debug >= Params::DEBUG_EXTRA) {
-      fprintf(stderr, "No valid tracks for match_storms()\n");
-    }
+    } /* if (match[k] >= 0) */
     
-  } /* if (nvalid_edges > 0) */
-
-  /*
-   * free up arrays
-   */
-
-  ufree2((void **) dcost);
+  } /* k */
+  
   ufree2((void **) icost);
   ufree(match);
-  ufree(xx1);
-  ufree(yy1);
-  ufree(xx2);
-  ufree(yy2);
 
 }
 
@@ -85,98 +85,91 @@ void TrOverlaps::find(const TitanStormFile &sfile,
   
 {
 
-  int overlap_in_x, overlap_in_y;
-  int bounds_overlap;
-
   TrTrack::bounding_box_t *box2;
   TrTrack::bounding_box_t *box1;
+
+  // index the storms2 bounding boxes, using the mean box
+  // size as the cell size
+
+  _boxIndex.clear();
+  double sumSize = 0.0;
+  for (size_t jstorm = 0; jstorm < storms2.size(); jstorm++) {
+    box2 = &storms2[jstorm]->box_for_overlap;
+    _boxIndex.add(jstorm,
+                  box2->min_ix, box2->min_iy,
+                  box2->max_ix, box2->max_iy);
+    sumSize += (box2->max_ix - box2->min_ix + 1);
+    sumSize += (box2->max_iy - box2->min_iy + 1);
+  }
+  if (storms2.size() > 0) {
+    _boxIndex.build(sumSize / (2.0 * storms2.size()));
+  }
   
   for (size_t istorm = 0; istorm < storms1.size(); istorm++) {
     
     TrStorm &storm1 = *storms1[istorm];
+    box1 = &storm1.box_for_overlap;
 
-    for (size_t jstorm = 0; jstorm < storms2.size(); jstorm++) {
-	
-      TrStorm &storm2 = *storms2[jstorm];
-	
-      /*
-       * check for overlap of bounding boxes
-       */
-	
-      box1 = &storm1.box_for_overlap;
-      box2 = &storm2.box_for_overlap;
-	
-      if (box1->min_ix <= box2->max_ix &&
-	  box1->max_ix >= box2->min_ix) {
-	overlap_in_x = TRUE;
-      } else {
-	overlap_in_x = FALSE;
-      }
+    // find the storms2 entries with bounding boxes which overlap
+    // the storm1 box - these are returned in ascending order
+    
+    _boxIndex.query(box1->min_ix, box1->min_iy,
+                    box1->max_ix, box1->max_iy,
+                    _nearby);
 
-      if (box1->min_iy <= box2->max_iy &&
-	  box1->max_iy >= box2->min_iy) {
-	overlap_in_y = TRUE;
-      } else {
-	overlap_in_y = FALSE;
-      }
+    for (size_t ii = 0; ii < _nearby.size(); ii++) {
 
-      if (overlap_in_x && overlap_in_y) {
-	bounds_overlap = TRUE;
-      } else {
-	bounds_overlap = FALSE;
-      }
+      size_t jstorm = _nearby[ii];
+      TrStorm &storm2 = *storms2[jstorm];
+      box2 = &storm2.box_for_overlap;
 
-      if (bounds_overlap) {
-	
-	if (_params.debug >= Params::DEBUG_EXTRA) {
-
-	  fprintf(stderr, "bounding_boxes - time1:storm %d "
-		  "overlaps with time2:storm %d\n",
-		  (int) istorm, (int) jstorm);
-	  
-	  fprintf(stderr, "Storm 1 centroid, area: %g, %g, %g\n",
-		  storm1.current.proj_area_centroid_x,
-		  storm1.current.proj_area_centroid_y,
-		  storm1.current.proj_area);
-	  
-	  fprintf(stderr, "Storm 2 centroid, area: %g, %g, %g\n",
-		  storm2.current.proj_area_centroid_x,
-		  storm2.current.proj_area_centroid_y,
-		  storm2.current.proj_area);
-	  
-	  fprintf(stderr,
-		  "Storm 1: box_min_ix, box_min_iy, box_max_ix, "
-		  "box_max_iy: %d, %d, %d, %d\n",
-		  box1->min_ix,
-		  box1->min_iy,
-		  box1->max_ix,
-		  box1->max_iy);
-
-	  fprintf(stderr,
-		  "Storm 2: box_min_ix, box_min_iy, box_max_ix, "
-		  "box_max_iy: %d, %d, %d, %d\n",
-		  box2->min_ix,
-		  box2->min_iy,
-		  box2->max_ix,
-		  box2->max_iy);
-
-	  fprintf(stderr, "forecast_x, forecast_y: %g, %g\n",
-		  storm1.track.status.forecast_x,
-		  storm1.track.status.forecast_y);
-
-	  fprintf(stderr, "forecast_area, length_ratio: %g, %g\n",
-		  storm1.track.status.forecast_area,
-		  storm1.track.status.forecast_length_ratio);
-	  
-	} /* if (_params.debug >= Params::DEBUG_EXTRA) */
-
-	load_overlaps(sfile, storm1, storm2,
-		      istorm, jstorm,
-		      box1, box2);
-
-      } /* if (bounds_overlap) */
-      
-    } /* jstorm */
+      if (_params.debug >= Params::DEBUG_EXTRA) {
+
+	fprintf(stderr, "bounding_boxes - time1:storm %d "
+		"overlaps with time2:storm %d\n",
+		(int) istorm, (int) jstorm);
+        
+	fprintf(stderr, "Storm 1 centroid, area: %g, %g, %g\n",
+		storm1.current.proj_area_centroid_x,
+		storm1.current.proj_area_centroid_y,
+		storm1.current.proj_area);
+        
+	fprintf(stderr, "Storm 2 centroid, area: %g, %g, %g\n",
+		storm2.current.proj_area_centroid_x,
+		storm2.current.proj_area_centroid_y,
+		storm2.current.proj_area);
+        
+	fprintf(stderr,
+		"Storm 1: box_min_ix, box_min_iy, box_max_ix, "
+		"box_max_iy: %d, %d, %d, %d\n",
+		box1->min_ix,
+		box1->min_iy,
+		box1->max_ix,
+		box1->max_iy);
+
+	fprintf(stderr,
+		"Storm 2: box_min_ix, box_min_iy, box_max_ix, "
+		"box_max_iy: %d, %d, %d, %d\n",
+		box2->min_ix,
+		box2->min_iy,
+		box2->max_ix,
+		box2->max_iy);
+
+	fprintf(stderr, "forecast_x, forecast_y: %g, %g\n",
+		storm1.track.status.forecast_x,
+		storm1.track.status.forecast_y);
+
+	fprintf(stderr, "forecast_area, length_ratio: %g, %g\n",
+		storm1.track.status.forecast_area,
+		storm1.track.status.forecast_length_ratio);
+        
+      } /* if (_params.debug >= Params::DEBUG_EXTRA) */
+
+      load_overlaps(sfile, storm1, storm2,
+		    istorm, jstorm,
+		    box1, box2);
+
+    } /* ii */
 
   } /* istorm */
 
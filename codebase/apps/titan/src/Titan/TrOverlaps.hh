@@ -39,6 +39,7 @@
 #include <vector>
 #include "Worker.hh"
 #include "TrStorm.hh"
+#include "TrBoxIndex.hh"
 using namespace std;
 
 ////////////////////////////////
@@ -74,6 +75,12 @@ private:
   int _n_overlap_grid_alloc;
   ui08 *_overlap_grid_array;
 
+  // spatial index of the storms2 bounding boxes, so that
+  // only storm pairs with overlapping boxes are considered
+
+  TrBoxIndex _boxIndex;
+  vector<int> _nearby;
+
   // functions
 
   int compute_overlap(ui08 *overlap_grid, int npoints_grid);
@@ -0,0 +1,1035 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// AccumStore.cc
+//
+// AccumStore class - incremental store of the raw grid stats
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#include "AccumStore.hh"
+#include <toolsa/file_io.h>
+#include <toolsa/str.h>
+#include <toolsa/mem.h>
+#include <toolsa/Path.hh>
+#include <toolsa/TaXml.hh>
+#include <toolsa/DateTime.hh>
+#include <toolsa/ta_crc32.h>
+#include <Mdv/MdvxField.hh>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+using namespace std;
+
+// names of the raw sum fields, in the order of stats_field_t
+
+const char *AccumStore::_fieldNames[N_STATS_FIELDS] = {
+  "n_events",
+  "n_weighted",
+  "n_complex",
+  "percent_activity",
+  "n_start",
+  "n_mid",
+  "precip",
+  "volume",
+  "dbz_max",
+  "tops",
+  "speed",
+  "u",
+  "v",
+  "distance",
+  "dx",
+  "dy",
+  "area",
+  "duration",
+  "ln_area",
+  "ellipse_u",
+  "ellipse_v"
+};
+
+///////////////
+// Constructor
+
+AccumStore::AccumStore (const string &prog_name,
+			const Params &params,
+			time_t start_time,
+			time_t end_time) :
+  _progName(prog_name),
+  _params(params),
+  _startTime(start_time),
+  _endTime(end_time)
+  
+{
+
+  DateTime stime(_startTime);
+  DateTime etime(_endTime);
+  char periodDir[128];
+  sprintf(periodDir, "%.4d%.2d%.2d_%.2d%.2d%.2d_%.4d%.2d%.2d_%.2d%.2d%.2d",
+	  stime.getYear(), stime.getMonth(), stime.getDay(),
+	  stime.getHour(), stime.getMin(), stime.getSec(),
+	  etime.getYear(), etime.getMonth(), etime.getDay(),
+	  etime.getHour(), etime.getMin(), etime.getSec());
+
+  _storeDir = _params.accum_store_dir;
+  _storeDir += PATH_DELIM;
+  _storeDir += periodDir;
+  _indexPath = _storeDir + PATH_DELIM + "index.xml";
+  _lockPath = _storeDir + PATH_DELIM + "_lock";
+  _lockFile = NULL;
+  _config = _loadConfig();
+  _generation = 0;
+
+  _gridSet = false;
+  MEM_zero(_grid);
+
+}
+
+/////////////
+// Destructor
+
+AccumStore::~AccumStore()
+
+{
+
+  if (_lockFile != NULL) {
+    ta_unlock_file(_lockPath.c_str(), _lockFile);
+    fclose(_lockFile);
+  }
+
+}
+
+////////////////////////////////////////////////////////
+// lock()
+//
+// Lock the store for the period.
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::lock()
+
+{
+
+  if (_lockFile != NULL) {
+    return 0;
+  }
+
+  if (ta_makedir_recurse(_storeDir.c_str())) {
+    int errNum = errno;
+    cerr << "ERROR - " << _progName << ":AccumStore::lock" << endl;
+    cerr << "  Cannot make dir: " << _storeDir << endl;
+    cerr << "  " << strerror(errNum) << endl;
+    return -1;
+  }
+
+  if ((_lockFile = fopen(_lockPath.c_str(), "w")) == NULL) {
+    int errNum = errno;
+    cerr << "ERROR - " << _progName << ":AccumStore::lock" << endl;
+    cerr << "  Cannot open lock file: " << _lockPath << endl;
+    cerr << "  " << strerror(errNum) << endl;
+    return -1;
+  }
+
+  if (_params.debug >= Params::DEBUG_VERBOSE) {
+    cerr << "Locking accumulation store: " << _storeDir << endl;
+  }
+
+  if (ta_lock_file(_lockPath.c_str(), _lockFile, "w")) {
+    cerr << "ERROR - " << _progName << ":AccumStore::lock" << endl;
+    cerr << "  Cannot lock file: " << _lockPath << endl;
+    fclose(_lockFile);
+    _lockFile = NULL;
+    return -1;
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// load()
+//
+// Read the store for the period.
+
+void AccumStore::load()
+
+{
+
+  _files.clear();
+  _sums.clear();
+  _gridSet = false;
+  _generation = 0;
+
+  if (!ta_stat_exists(_indexPath.c_str())) {
+    if (_params.debug) {
+      cerr << "Starting new accumulation store: " << _storeDir << endl;
+    }
+    return;
+  }
+
+  bool hasSums = false;
+  if (_readIndex(hasSums)) {
+    cerr << "WARNING - " << _progName << ":AccumStore::load" << endl;
+    cerr << "  Cannot use accumulation store: " << _storeDir << endl;
+    cerr << "  Starting again." << endl;
+    clear();
+    return;
+  }
+
+  // The running sums are only used if they were written for the
+  // generation in the index. Otherwise, for example after a crash
+  // during write(), they are rebuilt from the contributions.
+
+  if (hasSums) {
+    string accumPath = _accumPath(_generation);
+    if (_readSums(accumPath, _grid, _sums)) {
+      cerr << "WARNING - " << _progName << ":AccumStore::load" << endl;
+      cerr << "  Cannot read running sums: " << accumPath << endl;
+      cerr << "  Rebuilding from track file contributions." << endl;
+      if (_rebuild()) {
+	clear();
+	return;
+      }
+    } else {
+      _gridSet = true;
+    }
+  }
+
+  if (_params.debug) {
+    cerr << "Loaded accumulation store: " << _storeDir << endl;
+    cerr << "  N track files included: " << _files.size() << endl;
+  }
+
+}
+
+////////////////////////////////////////////////////////
+// isCurrent()
+//
+// Check whether a track file is already included in its
+// current version.
+
+bool AccumStore::isCurrent(const string &track_file_path) const
+
+{
+
+  int index = _findFile(track_file_path);
+  if (index < 0) {
+    return false;
+  }
+
+  struct stat fileStat;
+  if (ta_stat(track_file_path.c_str(), &fileStat)) {
+    return false;
+  }
+
+  const accum_file_t &file = _files[index];
+  return (file.mtime == fileStat.st_mtime &&
+	  file.size == (long) fileStat.st_size);
+
+}
+
+////////////////////////////////////////////////////////
+// update()
+//
+// Update the store with the contribution from a track file.
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::update(const string &track_file_path,
+		       const StatsGrid &contrib)
+
+{
+
+  struct stat fileStat;
+  if (ta_stat(track_file_path.c_str(), &fileStat)) {
+    cerr << "ERROR - " << _progName << ":AccumStore::update" << endl;
+    cerr << "  Cannot stat track file: " << track_file_path << endl;
+    return -1;
+  }
+
+  const Mdvx::coord_t &grid = contrib.getGrid();
+  const grid_stats_t *stats = contrib.getStats();
+
+  if (stats != NULL && _gridSet && !_gridMatches(grid)) {
+    cerr << "ERROR - " << _progName << ":AccumStore::update" << endl;
+    cerr << "  Grid has changed, track file: " << track_file_path << endl;
+    return -1;
+  }
+
+  // round the contribution to the stored precision, so that the
+  // running sums are consistent with the contribution files
+
+  string contribPath = _contribPath(track_file_path);
+  vector<grid_stats_t> sums;
+  if (stats != NULL) {
+    size_t npts = grid.nx * grid.ny;
+    sums.resize(npts);
+    const double *in = &stats->n_events;
+    double *out = &sums[0].n_events;
+    for (size_t ii = 0; ii < npts * N_STATS_FIELDS; ii++) {
+      out[ii] = (fl32) in[ii];
+    }
+    if (_writeSums(contribPath, grid, sums)) {
+      return -1;
+    }
+  } else {
+    unlink(contribPath.c_str());
+  }
+
+  // update the index
+
+  int index = _findFile(track_file_path);
+  bool replacing = (index >= 0 && _files[index].hasStats);
+  if (index < 0) {
+    accum_file_t newFile;
+    newFile.path = track_file_path;
+    _files.push_back(newFile);
+    index = _files.size() - 1;
+  }
+
+  accum_file_t &file = _files[index];
+  file.mtime = fileStat.st_mtime;
+  file.size = fileStat.st_size;
+  file.hasStats = (stats != NULL);
+  file.dataStart = contrib.getDataStart();
+  file.dataEnd = contrib.getDataEnd();
+  file.scanIntervalSecs = contrib.getScanIntervalSecs();
+  file.refLat = contrib.getRefLat();
+
+  if (_params.debug) {
+    cerr << (replacing ? "Replacing" : "Adding")
+	 << " contribution from track file: " << track_file_path << endl;
+  }
+  
+  // update the running sums
+
+  if (replacing) {
+    return _rebuild();
+  }
+  if (stats != NULL) {
+    _addSums(grid, sums);
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// removeOthers()
+//
+// Roll back the track files which are not in the set of paths.
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::removeOthers(const set<string> &track_file_paths)
+
+{
+
+  bool needRebuild = false;
+  vector<accum_file_t> kept;
+
+  for (size_t ii = 0; ii < _files.size(); ii++) {
+    const accum_file_t &file = _files[ii];
+    if (track_file_paths.find(file.path) != track_file_paths.end()) {
+      kept.push_back(file);
+      continue;
+    }
+    if (_params.debug) {
+      cerr << "Removing contribution from track file: " << file.path << endl;
+    }
+    if (file.hasStats) {
+      unlink(_contribPath(file.path).c_str());
+      needRebuild = true;
+    }
+  }
+
+  _files = kept;
+
+  if (needRebuild) {
+    return _rebuild();
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// clear()
+//
+// Clear the store, removing the files.
+//
+// All of the store files in the period directory are removed,
+// not just those in the index, since the index may be from a
+// different config or may not have been read at all. This covers
+// running sums from other generations, and contribution files
+// for track files which are no longer in the index.
+
+void AccumStore::clear()
+
+{
+
+  // index and running sums
+
+  DIR *dirp;
+  if ((dirp = opendir(_storeDir.c_str())) != NULL) {
+    struct dirent *dp;
+    for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
+      string name = dp->d_name;
+      if (name == "index.xml" || name == "index.xml.tmp" ||
+	  (name.find("accum") == 0 && name.size() > 4 &&
+	   name.substr(name.size() - 4) == ".mdv")) {
+	unlink((_storeDir + PATH_DELIM + name).c_str());
+      }
+    }
+    closedir(dirp);
+  }
+
+  // contributions
+
+  string filesDir = _storeDir + PATH_DELIM + "files";
+  if ((dirp = opendir(filesDir.c_str())) != NULL) {
+    struct dirent *dp;
+    for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
+      if (dp->d_name[0] == '.') {
+	continue;
+      }
+      unlink((filesDir + PATH_DELIM + dp->d_name).c_str());
+    }
+    closedir(dirp);
+  }
+
+  _files.clear();
+  _sums.clear();
+  _gridSet = false;
+  MEM_zero(_grid);
+  _generation = 0;
+
+}
+
+////////////////////////////////////////////////////////
+// write()
+//
+// Write the running sums for the next generation, and then
+// the index, which commits the new generation.
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::write()
+
+{
+
+  int nextGen = _generation + 1;
+  string nextPath = _accumPath(nextGen);
+  
+  if (_gridSet) {
+    if (_writeSums(nextPath, _grid, _sums)) {
+      unlink(nextPath.c_str());
+      return -1;
+    }
+  }
+
+  if (_writeIndex(nextGen)) {
+    unlink(nextPath.c_str());
+    return -1;
+  }
+
+  unlink(_accumPath(_generation).c_str());
+  _generation = nextGen;
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// loadStats()
+//
+// Load the running sums into the stats grid.
+// Returns 0 on success, -1 if there are no stats.
+
+int AccumStore::loadStats(StatsGrid &stats) const
+
+{
+
+  if (!_gridSet) {
+    return -1;
+  }
+
+  // data time limits over all files, and scan details
+  // from the latest file
+  
+  time_t dataStart = 0;
+  time_t dataEnd = 0;
+  double scanIntervalSecs = 0.0;
+  double refLat = 0.0;
+  bool timesInit = false;
+
+  for (size_t ii = 0; ii < _files.size(); ii++) {
+    const accum_file_t &file = _files[ii];
+    if (!file.hasStats) {
+      continue;
+    }
+    if (!timesInit) {
+      dataStart = file.dataStart;
+      dataEnd = file.dataEnd;
+      scanIntervalSecs = file.scanIntervalSecs;
+      refLat = file.refLat;
+      timesInit = true;
+    } else {
+      dataStart = MIN(dataStart, file.dataStart);
+      if (file.dataEnd >= dataEnd) {
+	dataEnd = file.dataEnd;
+	scanIntervalSecs = file.scanIntervalSecs;
+	refLat = file.refLat;
+      }
+    }
+  }
+
+  stats.setAccumulation(_grid, &_sums[0], dataStart, dataEnd,
+			scanIntervalSecs, refLat);
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// _loadConfig()
+//
+// String of the parameters which affect the contributions.
+// The store is started again if these change.
+
+string AccumStore::_loadConfig() const
+
+{
+
+  char config[1024];
+  sprintf(config,
+	  "track_data_type=%d min_duration=%g "
+	  "spatial_representation=%d compute_precip_from_dbz_histogram=%d "
+	  "z_r_coeff=%g z_r_exponent=%g hail_dbz_threshold=%g "
+	  "override_ellipse=%d circle_radius=%g smoothing_kernel_size=%d",
+	  (int) _params.track_data_type,
+	  _params.min_duration,
+	  (int) _params.spatial_representation,
+	  (int) _params.compute_precip_from_dbz_histogram,
+	  _params.z_r_coeff,
+	  _params.z_r_exponent,
+	  _params.hail_dbz_threshold,
+	  (int) _params.override_ellipse,
+	  _params.circle_radius,
+	  _params.smoothing_kernel_size);
+
+  return config;
+
+}
+
+////////////////////////////////////////////////////////
+// _accumPath()
+//
+// Path of the running sums file for a generation.
+
+string AccumStore::_accumPath(int generation) const
+
+{
+  char name[64];
+  sprintf(name, "accum_%d.mdv", generation);
+  return _storeDir + PATH_DELIM + name;
+}
+
+////////////////////////////////////////////////////////
+// _contribPath()
+//
+// Path of the contribution file for a track file.
+// The name includes a checksum of the full path, so that
+// track files with the same name in different directories
+// do not share a contribution file.
+
+string AccumStore::_contribPath(const string &track_file_path) const
+
+{
+  Path trackPath(track_file_path);
+  char crcStr[32];
+  sprintf(crcStr, "_%.8x",
+	  (unsigned int) ta_crc32(track_file_path.c_str(),
+				  track_file_path.size()));
+  string path = _storeDir + PATH_DELIM + "files" + PATH_DELIM;
+  path += trackPath.getFile();
+  path += crcStr;
+  path += ".mdv";
+  return path;
+}
+
+////////////////////////////////////////////////////////
+// _findFile()
+//
+// Returns index of track file in the index, -1 if not found.
+
+int AccumStore::_findFile(const string &track_file_path) const
+
+{
+  for (size_t ii = 0; ii < _files.size(); ii++) {
+    if (_files[ii].path == track_file_path) {
+      return (int) ii;
+    }
+  }
+  return -1;
+}
+
+////////////////////////////////////////////////////////
+// _rebuild()
+//
+// Rebuild the running sums from the contribution files.
+// A track file whose contribution cannot be read is dropped
+// from the index, so that it is read again on the next run.
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::_rebuild()
+
+{
+
+  _sums.clear();
+  _gridSet = false;
+  MEM_zero(_grid);
+
+  vector<accum_file_t> kept;
+
+  for (size_t ii = 0; ii < _files.size(); ii++) {
+
+    const accum_file_t &file = _files[ii];
+    if (!file.hasStats) {
+      kept.push_back(file);
+      continue;
+    }
+
+    string contribPath = _contribPath(file.path);
+    Mdvx::coord_t grid;
+    vector<grid_stats_t> sums;
+    if (_readSums(contribPath, grid, sums)) {
+      cerr << "WARNING - " << _progName << ":AccumStore::_rebuild" << endl;
+      cerr << "  Cannot read contribution: " << contribPath << endl;
+      cerr << "  Dropping track file: " << file.path << endl;
+      continue;
+    }
+    if (_gridSet && !_gridMatches(grid)) {
+      cerr << "ERROR - " << _progName << ":AccumStore::_rebuild" << endl;
+      cerr << "  Grid has changed, contribution: " << contribPath << endl;
+      return -1;
+    }
+
+    _addSums(grid, sums);
+    kept.push_back(file);
+
+  } // ii
+
+  _files = kept;
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// _addSums()
+//
+// Add a contribution to the running sums.
+
+void AccumStore::_addSums(const Mdvx::coord_t &grid,
+			  const vector<grid_stats_t> &sums)
+
+{
+
+  if (!_gridSet) {
+    _grid = grid;
+    _sums = sums;
+    _gridSet = true;
+    return;
+  }
+
+  const double *in = &sums[0].n_events;
+  double *out = &_sums[0].n_events;
+  for (size_t ii = 0; ii < _sums.size() * N_STATS_FIELDS; ii++) {
+    out[ii] += in[ii];
+  }
+
+}
+
+////////////////////////////////////////////////////////
+// _gridMatches()
+//
+// Check the grid against the running sums grid.
+
+bool AccumStore::_gridMatches(const Mdvx::coord_t &grid) const
+
+{
+
+  if (grid.proj_type != _grid.proj_type ||
+      grid.nx != _grid.nx || grid.ny != _grid.ny) {
+    return false;
+  }
+
+  double tol = 1.0e-4;
+  if (fabs(grid.dx - _grid.dx) > tol ||
+      fabs(grid.dy - _grid.dy) > tol ||
+      fabs(grid.minx - _grid.minx) > tol ||
+      fabs(grid.miny - _grid.miny) > tol ||
+      fabs(grid.proj_origin_lat - _grid.proj_origin_lat) > tol ||
+      fabs(grid.proj_origin_lon - _grid.proj_origin_lon) > tol) {
+    return false;
+  }
+
+  return true;
+
+}
+
+////////////////////////////////////////////////////////
+// _writeSums()
+//
+// Write sums to an MDV file, one FLOAT32 field per stat.
+// The fields are left uncompressed - they are small, and must
+// read back exactly.
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::_writeSums(const string &path,
+			   const Mdvx::coord_t &grid,
+			   const vector<grid_stats_t> &sums) const
+
+{
+
+  Path outPath(path);
+  if (ta_makedir_recurse(outPath.getDirectory().c_str())) {
+    cerr << "ERROR - " << _progName << ":AccumStore::_writeSums" << endl;
+    cerr << "  Cannot make dir: " << outPath.getDirectory() << endl;
+    return -1;
+  }
+
+  DsMdvx mdvx;
+
+  Mdvx::master_header_t mhdr;
+  MEM_zero(mhdr);
+  mhdr.time_begin = _startTime;
+  mhdr.time_end = _endTime;
+  mhdr.time_centroid = _endTime;
+  mhdr.num_data_times = 1;
+  mhdr.data_dimension = 2;
+  mhdr.data_collection_type = Mdvx::DATA_SYNTHESIS;
+  mhdr.native_vlevel_type = Mdvx::VERT_TYPE_SURFACE;
+  mhdr.vlevel_type = Mdvx::VERT_TYPE_SURFACE;
+  mhdr.vlevel_included = TRUE;
+  mhdr.grid_orientation = Mdvx::ORIENT_SN_WE;
+  mhdr.data_ordering = Mdvx::ORDER_XYZ;
+  mhdr.max_nx = grid.nx;
+  mhdr.max_ny = grid.ny;
+  mhdr.max_nz = 1;
+  mhdr.field_grids_differ = FALSE;
+  STRncopy(mhdr.data_set_info, _config.c_str(), MDV_INFO_LEN);
+  STRncopy(mhdr.data_set_name, "TrackGridStats raw sums", MDV_NAME_LEN);
+  STRncopy(mhdr.data_set_source, _progName.c_str(), MDV_NAME_LEN);
+  mdvx.setMasterHeader(mhdr);
+
+  size_t npts = grid.nx * grid.ny;
+  vector<fl32> vals(npts);
+  
+  for (int ifield = 0; ifield < N_STATS_FIELDS; ifield++) {
+    
+    Mdvx::field_header_t fhdr;
+    MEM_zero(fhdr);
+    Mdvx::vlevel_header_t vhdr;
+    MEM_zero(vhdr);
+
+    fhdr.nx = grid.nx;
+    fhdr.ny = grid.ny;
+    fhdr.nz = 1;
+    fhdr.proj_type = (Mdvx::projection_type_t) grid.proj_type;
+    fhdr.encoding_type = Mdvx::ENCODING_FLOAT32;
+    fhdr.data_element_nbytes = sizeof(fl32);
+    fhdr.volume_size = fhdr.nx * fhdr.ny * fhdr.nz * sizeof(fl32);
+    fhdr.compression_type = Mdvx::COMPRESSION_NONE;
+    fhdr.transform_type = Mdvx::DATA_TRANSFORM_NONE;
+    fhdr.scaling_type = Mdvx::SCALING_NONE;
+    fhdr.native_vlevel_type = Mdvx::VERT_TYPE_SURFACE;
+    fhdr.vlevel_type = Mdvx::VERT_TYPE_SURFACE;
+    fhdr.dz_constant = true;
+    fhdr.proj_origin_lat = grid.proj_origin_lat;
+    fhdr.proj_origin_lon = grid.proj_origin_lon;
+    fhdr.grid_dx = grid.dx;
+    fhdr.grid_dy = grid.dy;
+    fhdr.grid_minx = grid.minx;
+    fhdr.grid_miny = grid.miny;
+    fhdr.grid_dz = 1;
+    fhdr.grid_minz = 0;
+    fhdr.bad_data_value = -9999.0;
+    fhdr.missing_data_value = -9999.0;
+    STRncopy(fhdr.field_name, _fieldNames[ifield], MDV_SHORT_FIELD_LEN);
+    STRncopy(fhdr.field_name_long, _fieldNames[ifield], MDV_LONG_FIELD_LEN);
+    STRncopy(fhdr.units, "sum", MDV_UNITS_LEN);
+
+    vhdr.type[0] = Mdvx::VERT_TYPE_SURFACE;
+    vhdr.level[0] = 0.0;
+
+    for (size_t ii = 0; ii < npts; ii++) {
+      const double *stat = &sums[ii].n_events;
+      vals[ii] = (fl32) stat[ifield];
+    }
+    
+    mdvx.addField(new MdvxField(fhdr, vhdr, &vals[0]));
+
+  } // ifield
+
+  if (mdvx.writeToPath(path.c_str())) {
+    cerr << "ERROR - " << _progName << ":AccumStore::_writeSums" << endl;
+    cerr << mdvx.getErrStr() << endl;
+    return -1;
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// _readSums()
+//
+// Read sums from an MDV file written by _writeSums().
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::_readSums(const string &path,
+			  Mdvx::coord_t &grid,
+			  vector<grid_stats_t> &sums) const
+
+{
+
+  DsMdvx mdvx;
+  mdvx.setReadPath(path);
+  mdvx.setReadEncodingType(Mdvx::ENCODING_FLOAT32);
+  mdvx.setReadCompressionType(Mdvx::COMPRESSION_NONE);
+  if (mdvx.readVolume()) {
+    cerr << "ERROR - " << _progName << ":AccumStore::_readSums" << endl;
+    cerr << mdvx.getErrStr() << endl;
+    return -1;
+  }
+
+  for (int ifield = 0; ifield < N_STATS_FIELDS; ifield++) {
+
+    const MdvxField *field = mdvx.getField(_fieldNames[ifield]);
+    if (field == NULL) {
+      cerr << "ERROR - " << _progName << ":AccumStore::_readSums" << endl;
+      cerr << "  No field: " << _fieldNames[ifield] << endl;
+      cerr << "  File: " << path << endl;
+      return -1;
+    }
+    const Mdvx::field_header_t &fhdr = field->getFieldHeader();
+
+    if (ifield == 0) {
+      MEM_zero(grid);
+      grid.proj_type = fhdr.proj_type;
+      grid.proj_origin_lat = fhdr.proj_origin_lat;
+      grid.proj_origin_lon = fhdr.proj_origin_lon;
+      grid.nx = fhdr.nx;
+      grid.ny = fhdr.ny;
+      grid.nz = 1;
+      grid.dx = fhdr.grid_dx;
+      grid.dy = fhdr.grid_dy;
+      grid.dz = 1.0;
+      grid.minx = fhdr.grid_minx;
+      grid.miny = fhdr.grid_miny;
+      grid.dz_constant = true;
+      sums.resize(grid.nx * grid.ny);
+    } else if (fhdr.nx != grid.nx || fhdr.ny != grid.ny) {
+      cerr << "ERROR - " << _progName << ":AccumStore::_readSums" << endl;
+      cerr << "  Field grids differ, file: " << path << endl;
+      return -1;
+    }
+
+    const fl32 *vals = (const fl32 *) field->getVol();
+    for (size_t ii = 0; ii < sums.size(); ii++) {
+      double *stat = &sums[ii].n_events;
+      stat[ifield] = vals[ii];
+    }
+
+  } // ifield
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// _writeIndex()
+//
+// Write the index of included track files, via a tmp file.
+// Returns 0 on success, -1 on failure.
+
+int AccumStore::_writeIndex(int generation) const
+
+{
+
+  string xml;
+  xml += TaXml::writeStartTag("accum_store", 0);
+  xml += TaXml::writeString("config", 1, _config);
+  xml += TaXml::writeInt("generation", 1, generation);
+  xml += TaXml::writeUtime("start_time", 1, _startTime);
+  xml += TaXml::writeUtime("end_time", 1, _endTime);
+  xml += TaXml::writeBoolean("has_sums", 1, _gridSet);
+
+  for (size_t ii = 0; ii < _files.size(); ii++) {
+    const accum_file_t &file = _files[ii];
+    xml += TaXml::writeStartTag("track_file", 1);
+    xml += TaXml::writeString("path", 2, file.path);
+    xml += TaXml::writeUtime("mtime", 2, file.mtime);
+    xml += TaXml::writeLong("size", 2, file.size);
+    xml += TaXml::writeBoolean("has_stats", 2, file.hasStats);
+    xml += TaXml::writeUtime("data_start", 2, file.dataStart);
+    xml += TaXml::writeUtime("data_end", 2, file.dataEnd);
+    xml += TaXml::writeDouble("scan_interval", 2,
+			      file.scanIntervalSecs, "%.10g");
+    xml += TaXml::writeDouble("ref_lat", 2, file.refLat, "%.10g");
+    xml += TaXml::writeEndTag("track_file", 1);
+  }
+
+  xml += TaXml::writeEndTag("accum_store", 0);
+
+  if (ta_makedir_recurse(_storeDir.c_str())) {
+    cerr << "ERROR - " << _progName << ":AccumStore::_writeIndex" << endl;
+    cerr << "  Cannot make dir: " << _storeDir << endl;
+    return -1;
+  }
+
+  string tmpPath = _indexPath + ".tmp";
+  FILE *out;
+  if ((out = fopen(tmpPath.c_str(), "w")) == NULL) {
+    int errNum = errno;
+    cerr << "ERROR - " << _progName << ":AccumStore::_writeIndex" << endl;
+    cerr << "  Cannot open file for writing: " << tmpPath << endl;
+    cerr << "  " << strerror(errNum) << endl;
+    return -1;
+  }
+  if (fwrite(xml.c_str(), 1, xml.size(), out) != xml.size()) {
+    int errNum = errno;
+    cerr << "ERROR - " << _progName << ":AccumStore::_writeIndex" << endl;
+    cerr << "  Cannot write file: " << tmpPath << endl;
+    cerr << "  " << strerror(errNum) << endl;
+    fclose(out);
+    return -1;
+  }
+  fclose(out);
+
+  if (rename(tmpPath.c_str(), _indexPath.c_str())) {
+    int errNum = errno;
+    cerr << "ERROR - " << _progName << ":AccumStore::_writeIndex" << endl;
+    cerr << "  Cannot rename file: " << tmpPath << endl;
+    cerr << "  " << strerror(errNum) << endl;
+    return -1;
+  }
+
+  if (_params.debug >= Params::DEBUG_VERBOSE) {
+    cerr << "Wrote accumulation index: " << _indexPath << endl;
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////
+// _readIndex()
+//
+// Read the index of included track files.
+// Returns 0 on success, -1 on failure, or if the store was
+// built with different parameters.
+
+int AccumStore::_readIndex(bool &hasSums)
+
+{
+
+  // read in the file
+
+  FILE *in;
+  if ((in = fopen(_indexPath.c_str(), "r")) == NULL) {
+    int errNum = errno;
+    cerr << "ERROR - " << _progName << ":AccumStore::_readIndex" << endl;
+    cerr << "  Cannot open file for reading: " << _indexPath << endl;
+    cerr << "  " << strerror(errNum) << endl;
+    return -1;
+  }
+  string xml;
+  char buf[4096];
+  size_t nread;
+  while ((nread = fread(buf, 1, sizeof(buf), in)) > 0) {
+    xml.append(buf, nread);
+  }
+  fclose(in);
+
+  // check the config
+
+  string config;
+  if (TaXml::readString(xml, "config", config)) {
+    cerr << "ERROR - " << _progName << ":AccumStore::_readIndex" << endl;
+    cerr << "  No config in index: " << _indexPath << endl;
+    return -1;
+  }
+  if (config != _config) {
+    if (_params.debug) {
+      cerr << "Accumulation store built with different parameters" << endl;
+      cerr << "  Store: " << config << endl;
+      cerr << "  Now: " << _config << endl;
+    }
+    return -1;
+  }
+
+  if (TaXml::readInt(xml, "generation", _generation)) {
+    cerr << "ERROR - " << _progName << ":AccumStore::_readIndex" << endl;
+    cerr << "  No generation in index: " << _indexPath << endl;
+    return -1;
+  }
+
+  if (TaXml::readBoolean(xml, "has_sums", hasSums)) {
+    cerr << "ERROR - " << _progName << ":AccumStore::_readIndex" << endl;
+    cerr << "  No has_sums in index: " << _indexPath << endl;
+    return -1;
+  }
+
+  // the track files
+
+  vector<string> fileBufs;
+  TaXml::readTagBufArray(xml, "track_file", fileBufs);
+
+  for (size_t ii = 0; ii < fileBufs.size(); ii++) {
+    const string &fileBuf = fileBufs[ii];
+    accum_file_t file;
+    long size;
+    if (TaXml::readString(fileBuf, "path", file.path) ||
+	TaXml::readTime(fileBuf, "mtime", file.mtime) ||
+	TaXml::readLong(fileBuf, "size", size) ||
+	TaXml::readBoolean(fileBuf, "has_stats", file.hasStats) ||
+	TaXml::readTime(fileBuf, "data_start", file.dataStart) ||
+	TaXml::readTime(fileBuf, "data_end", file.dataEnd) ||
+	TaXml::readDouble(fileBuf, "scan_interval", file.scanIntervalSecs) ||
+	TaXml::readDouble(fileBuf, "ref_lat", file.refLat)) {
+      cerr << "ERROR - " << _progName << ":AccumStore::_readIndex" << endl;
+      cerr << "  Bad track_file entry in index: " << _indexPath << endl;
+      return -1;
+    }
+    file.size = size;
+    _files.push_back(file);
+  }
+
+  return 0;
+
+}
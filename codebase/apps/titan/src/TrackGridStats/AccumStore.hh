@@ -0,0 +1,219 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// AccumStore.hh
+//
+// AccumStore class - incremental store of the raw grid stats
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+//
+// The raw stats, before they are normalized by
+// StatsGrid::compute(), are sums over the storm entries.
+// They are kept on disk for each accumulation period:
+//
+//   accum_store_dir/yyyymmdd_hhmmss_yyyymmdd_hhmmss/
+//     index.xml      - the track files included, with their versions
+//     accum_gen.mdv  - the running sums for the period
+//     files/         - the sums contributed by each track file
+//
+// The index is authoritative. It is written last, via a tmp file,
+// and holds a generation number which is incremented on each write.
+// The running sums are written to a new file named with the next
+// generation number before the index, so a crash part-way through
+// a write leaves the previous index and running sums in place.
+// If the running sums for the index generation cannot be read,
+// they are rebuilt from the contributions of the files in the index.
+//
+// The contribution files are named from the track file name and a
+// checksum of its full path, since track files in different
+// directories may have the same name.
+//
+// A track file which has not changed since it was included is
+// not read again. If a track file has changed, for example because
+// scans have been added in realtime, or because a day has been
+// reprocessed, its contribution is replaced. A track file which
+// is no longer in the input is rolled back.
+//
+// The store is keyed on the start and end times of the run, so
+// incremental runs must use fixed periods, such as a day or a month,
+// with the same start and end times on each run. A run for a
+// different period, even an overlapping one, starts a new store.
+//
+// Runs for the same period are serialized by a lock on the file
+// _lock in the period directory, which is held from load() to the
+// end of the run.
+//
+// The track file is the unit of update, because track files are
+// rewritten in place as tracks are extended, and the track-based
+// stats such as duration depend on the whole track.
+//
+// The sums are stored as FLOAT32, so replacing or removing a
+// contribution rebuilds the running sums from the per-file
+// contributions, rather than subtracting, which would leave
+// rounding residues in cells with no remaining storms.
+//
+//
+// The store is specific to TrackGridStats. precip_map keeps its
+// ACCUM_FROM_START running sums in memory across scans, and its
+// ACCUM_PERIOD maps are a fixed window of radar volumes written once
+// per scan, through the legacy C MDV library. PrecipSeries samples
+// rates at points into text series. Neither rereads a period of
+// storm or track files, so neither uses the store.
+//
+///////////////////////////////////////////////////////////////
+
+#ifndef AccumStore_HH
+#define AccumStore_HH
+
+#include "Params.hh"
+#include "StatsGrid.hh"
+#include <string>
+#include <vector>
+#include <set>
+#include <Mdv/DsMdvx.hh>
+using namespace std;
+
+class AccumStore {
+  
+public:
+
+  // constructor
+
+  AccumStore (const string &prog_name,
+	      const Params &params,
+	      time_t start_time,
+	      time_t end_time);
+  
+  // destructor
+  
+  ~AccumStore();
+
+  // Lock the store for the period, waiting for any other run for
+  // the same period. The lock is released by the destructor.
+  // Returns 0 on success, -1 on failure.
+
+  int lock();
+
+  // Read the store for the period. If there is no store, or if
+  // it was built with different parameters, the store starts empty.
+
+  void load();
+
+  // Check whether a track file is already included in its
+  // current version.
+
+  bool isCurrent(const string &track_file_path) const;
+
+  // Update the store with the contribution from a track file,
+  // replacing any earlier contribution from the same file.
+  // Returns 0 on success, -1 on failure.
+
+  int update(const string &track_file_path,
+	     const StatsGrid &contrib);
+
+  // Roll back the track files which are not in the given set
+  // of paths. Returns 0 on success, -1 on failure.
+
+  int removeOthers(const set<string> &track_file_paths);
+
+  // Clear the store, removing the files.
+
+  void clear();
+
+  // Write the running sums and the index.
+  // Returns 0 on success, -1 on failure.
+
+  int write();
+
+  // Load the running sums into the stats grid.
+  // Returns 0 on success, -1 if there are no stats.
+
+  int loadStats(StatsGrid &stats) const;
+
+  // get the number of track files included
+
+  size_t getNFiles() const { return _files.size(); }
+
+protected:
+  
+private:
+
+  // an included track file
+
+  typedef struct {
+    string path;
+    time_t mtime;     // version of the track file
+    long size;
+    bool hasStats;    // false if no tracks in the period
+    time_t dataStart;
+    time_t dataEnd;
+    double scanIntervalSecs;
+    double refLat;
+  } accum_file_t;
+
+  const string &_progName;
+  const Params &_params;
+  time_t _startTime;
+  time_t _endTime;
+
+  string _storeDir;
+  string _indexPath;
+  string _lockPath;
+  FILE *_lockFile;
+  string _config;
+  int _generation;
+
+  vector<accum_file_t> _files;
+
+  bool _gridSet;
+  Mdvx::coord_t _grid;
+  vector<grid_stats_t> _sums;
+
+  static const char *_fieldNames[N_STATS_FIELDS];
+
+  string _loadConfig() const;
+  string _accumPath(int generation) const;
+  string _contribPath(const string &track_file_path) const;
+  int _findFile(const string &track_file_path) const;
+  int _rebuild();
+  void _addSums(const Mdvx::coord_t &grid,
+		const vector<grid_stats_t> &sums);
+  bool _gridMatches(const Mdvx::coord_t &grid) const;
+
+  int _writeSums(const string &path,
+		 const Mdvx::coord_t &grid,
+		 const vector<grid_stats_t> &sums) const;
+  
+  int _readSums(const string &path,
+		Mdvx::coord_t &grid,
+		vector<grid_stats_t> &sums) const;
+
+  int _writeIndex(int generation) const;
+  int _readIndex(bool &hasSums);
+
+};
+
+#endif
@@ -817,6 +817,39 @@
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
     tt->param_name = tdrpStrDup("Comment 4");
+    tt->comment_hdr = tdrpStrDup("INCREMENTAL ACCUMULATION.");
+    tt->comment_text = tdrpStrDup("");
+    tt++;
+    
+    // Parameter 'incremental_accumulation'
+    // ctype is 'tdrp_bool_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = BOOL_TYPE;
+    tt->param_name = tdrpStrDup("incremental_accumulation");
+    tt->descr = tdrpStrDup("Option to accumulate the stats incrementally.");
+    tt->help = tdrpStrDup("TITAN_TRACKS only. If true, the raw sums for each track file are kept in a store under accum_store_dir, along with the running sums for the period. On the next run for the same period, only the track files which are new, or have changed since the previous run, are read. The contribution from a changed track file is replaced, and the contribution from a track file which is no longer in the input is removed. This allows the stats to be updated in realtime, or after reprocessing a day, without reading the whole period again. The store is started again if any of the parameters which affect the sums are changed. The store is kept per period, named from the start and end times, so incremental runs must use fixed periods - for example a day or a month - with the same start and end times on each run. A run for any other period, even an overlapping one, starts a new store. Runs for the same period wait for each other.");
+    tt->val_offset = (char *) &incremental_accumulation - &_start_;
+    tt->single_val.b = pFALSE;
+    tt++;
+    
+    // Parameter 'accum_store_dir'
+    // ctype is 'char*'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = STRING_TYPE;
+    tt->param_name = tdrpStrDup("accum_store_dir");
+    tt->descr = tdrpStrDup("Directory for the accumulation store.");
+    tt->help = tdrpStrDup("See incremental_accumulation. A subdirectory is created for each period, named yyyymmdd_hhmmss_yyyymmdd_hhmmss from the start and end times.");
+    tt->val_offset = (char *) &accum_store_dir - &_start_;
+    tt->single_val.s = tdrpStrDup("./titan/track_grid_stats_accum");
+    tt++;
+    
+    // Parameter 'Comment 5'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = COMMENT_TYPE;
+    tt->param_name = tdrpStrDup("Comment 5");
     tt->comment_hdr = tdrpStrDup("MODEL PARAMETERS.");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -913,11 +946,11 @@
     tt->single_val.d = 3;
     tt++;
     
-    // Parameter 'Comment 5'
+    // Parameter 'Comment 6'
     
     memset(tt, 0, sizeof(TDRPtable));
     tt->ptype = COMMENT_TYPE;
-    tt->param_name = tdrpStrDup("Comment 5");
+    tt->param_name = tdrpStrDup("Comment 6");
     tt->comment_hdr = tdrpStrDup("DATA OUTPUT.");
     tt->comment_text = tdrpStrDup("");
     tt++;
@@ -444,6 +444,10 @@ public:
 
   double circle_radius;
 
+  tdrp_bool_t incremental_accumulation;
+
+  char* accum_store_dir;
+
   double scan_interval;
 
   model_grid_t model_grid;
@@ -481,7 +485,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[38];
+  mutable TDRPtable _table[41];
 
   const char *_className;
 
@@ -64,7 +64,7 @@ StatsGrid::StatsGrid (const string &prog_name,
   _progName(prog_name),
   _params(params),
   _args(args),
-  _trackData(trackData),
+  _trackData(&trackData),
   _startTime(startTime),
   _endTime(endTime)
   
@@ -72,7 +72,7 @@ StatsGrid::StatsGrid (const string &prog_name,
 
   // initialize
   
-  _stats = NULL;
+  _init();
   
   // load up track data
 
@@ -80,6 +80,41 @@ StatsGrid::StatsGrid (const string &prog_name,
   
 }
 
+////////////////////////////////////////////////////////
+// Constructor for stats loaded from an accumulation.
+// Use setAccumulation() to load the stats.
+
+StatsGrid::StatsGrid (const string &prog_name,
+		      const Params &params,
+		      const Args &args,
+		      time_t startTime,
+		      time_t endTime) :
+  _progName(prog_name),
+  _params(params),
+  _args(args),
+  _trackData(NULL),
+  _startTime(startTime),
+  _endTime(endTime)
+  
+{
+  _init();
+}
+
+/////////////
+// initialize
+
+void StatsGrid::_init()
+
+{
+  _stats = NULL;
+  MEM_zero(_grid);
+  _dataStart = 0;
+  _dataEnd = 0;
+  _nScansElapsed = 0.0;
+  _scanIntervalSecs = 0.0;
+  _refLat = 0.0;
+}
+
 /////////////
 // Destructor
 
@@ -110,7 +145,7 @@ void StatsGrid::_loadTrackData()
   double sum_start_x, sum_start_y;
   double sum_end_x, sum_end_y;
 
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _trackData->getGrid();
   
   // allocate storm and precip grids
   
@@ -125,16 +160,16 @@ void StatsGrid::_loadTrackData()
 
   while (!no_more_tracks) {
 
-    if (_trackData.loadNextTrack(&no_more_tracks) || no_more_tracks) {
+    if (_trackData->loadNextTrack(&no_more_tracks) || no_more_tracks) {
       continue;
     }
 
     // continue to next track if this one is too short
     
-    if (_trackData.durationInSecs < _params.min_duration) {
+    if (_trackData->durationInSecs < _params.min_duration) {
       continue;
     }
-    double duration_in_hr = (double) _trackData.durationInSecs / 3600.0;
+    double duration_in_hr = (double) _trackData->durationInSecs / 3600.0;
     
     /*
      * initialize
@@ -154,7 +189,7 @@ void StatsGrid::_loadTrackData()
     
     while (!no_more_entries) {
 
-      if (_trackData.loadNextEntry(&no_more_entries) || no_more_entries) {
+      if (_trackData->loadNextEntry(&no_more_entries) || no_more_entries) {
 	continue;
       }
       
@@ -175,34 +210,34 @@ void StatsGrid::_loadTrackData()
 	precip_grid = (double **) ucalloc2 (grid.ny, grid.nx, sizeof(double));
       }
       
-      if (_trackData.entryTime < _startTime ||
-	  _trackData.entryTime > _endTime) {
+      if (_trackData->entryTime < _startTime ||
+	  _trackData->entryTime > _endTime) {
 	continue;
       }
 
       if (_params.debug >= Params::DEBUG_VERBOSE) {
 	fprintf(stderr, "%s: %10g %10g %10g %10g %10g\n",
-		utimstr(_trackData.entryTime),
-		_trackData.centroidX, _trackData.centroidY,
-		_trackData.area,
-		_trackData.majorRadius, _trackData.minorRadius);
+		utimstr(_trackData->entryTime),
+		_trackData->centroidX, _trackData->centroidY,
+		_trackData->area,
+		_trackData->majorRadius, _trackData->minorRadius);
       }
       
-      sum_area += _trackData.area;
+      sum_area += _trackData->area;
       
       if (!timesInit) {
-	_dataStart = _trackData.entryTime;
-	_dataEnd = _trackData.entryTime;
+	_dataStart = _trackData->entryTime;
+	_dataEnd = _trackData->entryTime;
 	timesInit = true;
       } else {
-	_dataStart = MIN(_dataStart, _trackData.entryTime);
-	_dataEnd = MAX(_dataEnd, _trackData.entryTime);
+	_dataStart = MIN(_dataStart, _trackData->entryTime);
+	_dataEnd = MAX(_dataEnd, _trackData->entryTime);
       }
       
       int ix =
-	(int) floor((_trackData.centroidX - grid.minx) / grid.dx + 0.5);
+	(int) floor((_trackData->centroidX - grid.minx) / grid.dx + 0.5);
       int iy =
-	(int) floor((_trackData.centroidY - grid.miny) / grid.dy + 0.5);
+	(int) floor((_trackData->centroidY - grid.miny) / grid.dy + 0.5);
       
       if (iy >= 0 && iy < grid.ny && ix >= 0 && ix < grid.nx) {
 	
@@ -211,28 +246,28 @@ void StatsGrid::_loadTrackData()
 	
 	// deal with the centroid first
 	
-	if (_trackData.entryHistoryInScans == 1) {
+	if (_trackData->entryHistoryInScans == 1) {
 	  
 	  stat->n_start++;
 	  
-	  sum_start_x += _trackData.centroidX;
-	  sum_start_y += _trackData.centroidY;
+	  sum_start_x += _trackData->centroidX;
+	  sum_start_y += _trackData->centroidY;
 	  n_start++;
 	  
-	} /* if (_trackData.historyInScans == 1) */
+	} /* if (_trackData->historyInScans == 1) */
 	
-	if (_trackData.entryHistoryInScans ==
-	    _trackData.durationInScans / 2) {
+	if (_trackData->entryHistoryInScans ==
+	    _trackData->durationInScans / 2) {
 	  stat->n_mid++;
 	}
 	
-	if (_trackData.entryTime == _trackData.endTime) {
+	if (_trackData->entryTime == _trackData->endTime) {
 	  
-	  sum_end_x += _trackData.centroidX;
-	  sum_end_y += _trackData.centroidY;
+	  sum_end_x += _trackData->centroidX;
+	  sum_end_y += _trackData->centroidY;
 	  n_end++;
 	  
-	} /* if (_trackData.historyInScans .... */
+	} /* if (_trackData->historyInScans .... */
 	
       } /* if (iy >= 0 ... */
       
@@ -247,7 +282,7 @@ void StatsGrid::_loadTrackData()
       si32 end_ix, end_iy;
 
       if (_params.spatial_representation == Params::STORM_RUNS &&
-	  _trackData.nProjRuns > 0) {
+	  _trackData->nProjRuns > 0) {
 	_loadFromRuns(start_ix, start_iy, end_ix, end_iy,
 		      storm_grid, precip_grid);
       } else {
@@ -272,11 +307,11 @@ void StatsGrid::_loadTrackData()
 	    
 	    stat->precip += *precip;
 	    
-	    double u = _trackData.dxDt;
-	    double v = _trackData.dyDt;
+	    double u = _trackData->dxDt;
+	    double v = _trackData->dyDt;
 	    
 	    if (grid.proj_type == Mdvx::PROJ_LATLON) {
-	      u *= KM_PER_DEG_AT_EQ * cos(_trackData.centroidY * DEG_TO_RAD);
+	      u *= KM_PER_DEG_AT_EQ * cos(_trackData->centroidY * DEG_TO_RAD);
 	      v *= KM_PER_DEG_AT_EQ;
 	    }
 	    
@@ -284,18 +319,18 @@ void StatsGrid::_loadTrackData()
 	    stat->v += v;
 	    
 	    stat->speed += sqrt(u * u + v * v);
-	    stat->dbz_max += _trackData.dbzMax;
-	    stat->tops += _trackData.tops;
-	    stat->volume += _trackData.volume;
-	    stat->area += _trackData.area;
+	    stat->dbz_max += _trackData->dbzMax;
+	    stat->tops += _trackData->tops;
+	    stat->volume += _trackData->volume;
+	    stat->area += _trackData->area;
 	    stat->duration += duration_in_hr;
-	    stat->ln_area += log(_trackData.area);
+	    stat->ln_area += log(_trackData->area);
 
-	    double aspect = _trackData.majorRadius / _trackData.minorRadius;
+	    double aspect = _trackData->majorRadius / _trackData->minorRadius;
 	    stat->ellipse_u +=
-	      aspect * 10.0 * sin(_trackData.ellipseOrientation * DEG_TO_RAD);
+	      aspect * 10.0 * sin(_trackData->ellipseOrientation * DEG_TO_RAD);
 	    stat->ellipse_v +=
-	      aspect * 10.0 * cos(_trackData.ellipseOrientation * DEG_TO_RAD);
+	      aspect * 10.0 * cos(_trackData->ellipseOrientation * DEG_TO_RAD);
 	    
 	  }
 
@@ -347,10 +382,17 @@ void StatsGrid::_loadTrackData()
     fprintf(stderr, "Sum area: %g\n", sum_area);
   }
 
+  // save the grid and scan details, which are needed after the
+  // track data has gone
+
+  _grid = grid;
+  _scanIntervalSecs = _trackData->scanIntervalSecs;
+  _refLat = _trackData->centroidY;
+
   // compute estimated number of scans elapsed
 
   _nScansElapsed = ((double) (_dataEnd - _dataStart) /
-		    _trackData.scanIntervalSecs);
+		    _scanIntervalSecs);
 
   // free up tmp grids
   
@@ -359,6 +401,42 @@ void StatsGrid::_loadTrackData()
       
 }
 
+////////////////////////////////////////////////////////
+// setAccumulation()
+//
+// Load the stats from an accumulation, in place of loading
+// them from the track data. The stats must not have been
+// computed yet.
+
+void StatsGrid::setAccumulation(const Mdvx::coord_t &grid,
+				const grid_stats_t *stats,
+				time_t dataStart,
+				time_t dataEnd,
+				double scanIntervalSecs,
+				double refLat)
+
+{
+
+  if (_stats) {
+    ufree2((void **) _stats);
+  }
+  _stats = (grid_stats_t **) ucalloc2(grid.ny, grid.nx, sizeof(grid_stats_t));
+  memcpy(*_stats, stats, grid.nx * grid.ny * sizeof(grid_stats_t));
+
+  _grid = grid;
+  _dataStart = dataStart;
+  _dataEnd = dataEnd;
+  _scanIntervalSecs = scanIntervalSecs;
+  _refLat = refLat;
+
+  _nScansElapsed = 0.0;
+  if (_scanIntervalSecs > 0) {
+    _nScansElapsed = ((double) (_dataEnd - _dataStart) /
+		      _scanIntervalSecs);
+  }
+  
+}
+
 ////////////
 // compute()
 //
@@ -382,7 +460,7 @@ void StatsGrid::compute()
   // loop through grid, computing stats
   
   grid_stats_t *stat;
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _grid;
   
   for (int iy = 0; iy < grid.ny; iy++) {
     
@@ -479,8 +557,8 @@ void StatsGrid::_loadFromEllipse(si32 &start_ix,
   
   // load up the storm grid
   
-  double ellipse_x = _trackData.centroidX;
-  double ellipse_y = _trackData.centroidY;
+  double ellipse_x = _trackData->centroidX;
+  double ellipse_y = _trackData->centroidY;
   
   double major_radius, minor_radius, axis_rotation;
 
@@ -489,9 +567,9 @@ void StatsGrid::_loadFromEllipse(si32 &start_ix,
     minor_radius = _params.circle_radius;
     axis_rotation = 0.0;
   } else {
-    major_radius = _trackData.majorRadius;
-    minor_radius = _trackData.minorRadius;
-    axis_rotation = _trackData.ellipseOrientation;
+    major_radius = _trackData->majorRadius;
+    minor_radius = _trackData->minorRadius;
+    axis_rotation = _trackData->ellipseOrientation;
   }
   
   _setEllipseInGrid(ellipse_x,
@@ -534,10 +612,10 @@ void StatsGrid::_setRunsPrecipFromHist(ui08 **storm_grid,
   // We use a granularity of 0.1%, so we need 1000 points to
   // go from 0 to 100 %.
 
-  double low_dbz_threshold = _trackData.lowDbzThreshold;
-  double dbz_hist_interval = _trackData.dbzHistInterval;
-  int n_dbz_intervals = _trackData.nDbzIntervals;
-  double *areaHist = _trackData.areaHist;
+  double low_dbz_threshold = _trackData->lowDbzThreshold;
+  double dbz_hist_interval = _trackData->dbzHistInterval;
+  int n_dbz_intervals = _trackData->nDbzIntervals;
+  double *areaHist = _trackData->areaHist;
   double area_fraction = 0.0;
   double prev_fraction = area_fraction;
   double prev_dbz = low_dbz_threshold;
@@ -589,7 +667,7 @@ void StatsGrid::_setRunsPrecipFromHist(ui08 **storm_grid,
   // loop through the grid points, randomly assigning the point a 
   // reflectivity value, and convert to precip
 
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _trackData->getGrid();
   STATS_uniform_seed(98765432);
 
   for (int iy = 0; iy < grid.ny; iy++) {
@@ -607,7 +685,7 @@ void StatsGrid::_setRunsPrecipFromHist(ui08 **storm_grid,
 	double precip_rate = pow((z / _params.z_r_coeff),
 				 (1.0 / _params.z_r_exponent));
 	double precip_depth =
-	  (precip_rate * (double) _trackData.scanIntervalSecs) / 3600.0;
+	  (precip_rate * (double) _trackData->scanIntervalSecs) / 3600.0;
 	
 	precip_grid[iy][ix] = precip_depth;
 	
@@ -629,19 +707,19 @@ void StatsGrid::_setRunsPrecipFromFlux(ui08 **storm_grid,
 
   // compute precip vol in meters cubed
 
-  double precipVolM3 = _trackData.precipFlux * _trackData.scanIntervalSecs;
+  double precipVolM3 = _trackData->precipFlux * _trackData->scanIntervalSecs;
 
   // compute precip depth in mm
 
   double precipDepthMm = 0.0;
-  if (_trackData.precipArea > 0) {
-    precipDepthMm = (precipVolM3 / _trackData.precipArea) / 1000.0;
+  if (_trackData->precipArea > 0) {
+    precipDepthMm = (precipVolM3 / _trackData->precipArea) / 1000.0;
   }
 
   // loop through the grid points, assigning the point a 
   // precip value
 
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _trackData->getGrid();
 
   for (int iy = 0; iy < grid.ny; iy++) {
     for (int ix = 0; ix < grid.nx; ix++) {
@@ -673,20 +751,20 @@ void StatsGrid::_setEllipsePrecipFromHist(double ellipse_x,
 
   // alloc grids
 
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _trackData->getGrid();
   ui08 **pos_grid = (ui08 **) ucalloc2 (grid.ny, grid.nx, sizeof(ui08));
 
   // init
 
-  double low_dbz_threshold = _trackData.lowDbzThreshold;
-  double dbz_hist_interval = _trackData.dbzHistInterval;
-  int n_dbz_intervals = _trackData.nDbzIntervals;
+  double low_dbz_threshold = _trackData->lowDbzThreshold;
+  double dbz_hist_interval = _trackData->dbzHistInterval;
+  int n_dbz_intervals = _trackData->nDbzIntervals;
 
   // compute the area and incremental precip depth for
   // each reflectivity interval
 
   double area_fraction = 0.0;
-  double *areaHist = _trackData.areaHist;
+  double *areaHist = _trackData->areaHist;
 
   for (int interval = n_dbz_intervals - 1; interval >= 0; interval--) {
     
@@ -700,7 +778,7 @@ void StatsGrid::_setEllipsePrecipFromHist(double ellipse_x,
     double precip_rate = pow((z / _params.z_r_coeff),
 			     (1.0 / _params.z_r_exponent));
     double precip_depth =
-      (precip_rate * (double) _trackData.scanIntervalSecs) / 3600.0;
+      (precip_rate * (double) _trackData->scanIntervalSecs) / 3600.0;
 
     area_fraction += areaHist[interval] / 100.0;
 
@@ -756,13 +834,13 @@ void StatsGrid::_setEllipsePrecipFromFlux(si32 start_ix,
 
   // compute precip vol in meters cubed
 
-  double precipVolM3 = _trackData.precipFlux * _trackData.scanIntervalSecs;
+  double precipVolM3 = _trackData->precipFlux * _trackData->scanIntervalSecs;
 
   // compute precip depth in mm
 
   double precipDepthMm = 0.0;
-  if (_trackData.precipArea > 0) {
-    precipDepthMm = (precipVolM3 / _trackData.precipArea) / 1000.0;
+  if (_trackData->precipArea > 0) {
+    precipDepthMm = (precipVolM3 / _trackData->precipArea) / 1000.0;
   }
 
   for (int iy = start_iy; iy <= end_iy; iy++) {
@@ -820,7 +898,7 @@ void StatsGrid::_setEllipseInGrid(double ellipse_x,
   double end_x, end_y;
   double line_x, line_y;
 
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _trackData->getGrid();
 
   // clear grid
 
@@ -1006,7 +1084,7 @@ void StatsGrid::_setRunsInGrid(si32 &start_ix,
   
   // clear grid
   
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _trackData->getGrid();
   memset(*target_grid, 0, grid.nx * grid.ny * sizeof(ui08));
 
   start_ix = grid.nx - 1;
@@ -1016,8 +1094,8 @@ void StatsGrid::_setRunsInGrid(si32 &start_ix,
   
   // set grid
   
-  storm_file_run_t *run = _trackData.projRuns;
-  for (int irun = 0; irun < _trackData.nProjRuns; irun++, run++) {
+  storm_file_run_t *run = _trackData->projRuns;
+  for (int irun = 0; irun < _trackData->nProjRuns; irun++, run++) {
     int ix1 = run->ix / _params.smoothing_kernel_size;
     int ix2 = (run->ix + run->n - 1) / _params.smoothing_kernel_size;
     int iy = run->iy / _params.smoothing_kernel_size;
@@ -1195,7 +1273,7 @@ void StatsGrid::_initMdvx(DsMdvx &mdvx,
   mhdr.grid_orientation = Mdvx::ORIENT_SN_WE;
   mhdr.data_ordering = Mdvx::ORDER_XYZ;
 
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _grid;
   mhdr.max_nx = grid.nx;
   mhdr.max_ny = grid.ny;
   mhdr.max_nz = 1;
@@ -1208,7 +1286,7 @@ void StatsGrid::_initMdvx(DsMdvx &mdvx,
   sprintf(info, "%s\n%s : %d\n%s : %g\n%s : %g\n",
 	  _params.data_set_info,
 	  "n_seasons", _params.n_seasons,
-	  "scan_interval", _trackData.scanIntervalSecs,
+	  "scan_interval", _scanIntervalSecs,
 	  "min_duration", _params.min_duration); 
 
   STRncopy(mhdr.data_set_info, info, MDV_INFO_LEN);
@@ -1431,7 +1509,7 @@ void StatsGrid::_computeDensities()
 
 {
 
-  const Mdvx::coord_t &grid = _trackData.getGrid();
+  const Mdvx::coord_t &grid = _grid;
 
   // compute grid geometry
 
@@ -1439,7 +1517,7 @@ void StatsGrid::_computeDensities()
   double dyKm = grid.dy;
   if (grid.proj_type == Mdvx::PROJ_LATLON) {
     dxKm =
-      grid.dx * KM_PER_DEG_AT_EQ * cos(_trackData.centroidY * DEG_TO_RAD);
+      grid.dx * KM_PER_DEG_AT_EQ * cos(_refLat * DEG_TO_RAD);
     dyKm = grid.dy * KM_PER_DEG_AT_EQ;
   }
   double cellAreaKm2 = dxKm * dyKm;
@@ -109,10 +109,39 @@ public:
 	     time_t startTime,
 	     time_t endTime);
   
+  // constructor for stats loaded with setAccumulation()
+  
+  StatsGrid (const string &prog_name,
+	     const Params &params,
+	     const Args &args,
+	     time_t startTime,
+	     time_t endTime);
+  
   // Destructor
   
   virtual ~StatsGrid();
 
+  // Load the stats from an accumulation of raw stats,
+  // in place of the track data.
+  // stats has grid.nx * grid.ny entries.
+
+  void setAccumulation(const Mdvx::coord_t &grid,
+		       const grid_stats_t *stats,
+		       time_t dataStart,
+		       time_t dataEnd,
+		       double scanIntervalSecs,
+		       double refLat);
+
+  // raw stats loaded from the track data, before compute() is called.
+  // getStats() returns NULL if no track data was found.
+
+  const grid_stats_t *getStats() const { return _stats ? *_stats : NULL; }
+  const Mdvx::coord_t &getGrid() const { return _grid; }
+  time_t getDataStart() const { return _dataStart; }
+  time_t getDataEnd() const { return _dataEnd; }
+  double getScanIntervalSecs() const { return _scanIntervalSecs; }
+  double getRefLat() const { return _refLat; }
+
   // compute stats
 
   void compute();
@@ -128,16 +157,20 @@ private:
   const string &_progName;
   const Params &_params;
   const Args &_args;
-  TrackData &_trackData;
+  TrackData *_trackData;
   time_t _startTime;
   time_t _endTime;
   grid_stats_t **_stats;
 
+  Mdvx::coord_t _grid;
   time_t _dataStart;
   time_t _dataEnd;
 
   double _nScansElapsed;
+  double _scanIntervalSecs;
+  double _refLat; // latitude for densities on a latlon grid
 
+  void _init();
   void _loadTrackData();
 
   void _loadFromRuns(si32 &start_ix,
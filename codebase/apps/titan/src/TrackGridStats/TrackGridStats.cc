@@ -37,6 +37,7 @@
 #include "TitanTrackData.hh"
 #include "ModelTrackData.hh"
 #include "StatsGrid.hh"
+#include "AccumStore.hh"
 #include <toolsa/str.h>
 #include <didss/DsInputPath.hh>
 using namespace std;
@@ -103,6 +104,14 @@ TrackGridStats::TrackGridStats(int argc, char **argv)
       isOK = false;
       return;
     }
+    if (_params.incremental_accumulation &&
+	(_args.startTime == 0 || _args.endTime == 0)) {
+      cerr << "ERROR - TrackGridStats" << endl;
+      cerr << "  incremental_accumulation is set." << endl;
+      cerr << "  You must specify start and end times." << endl;
+      isOK = false;
+      return;
+    }
   }
     
  // file input object
@@ -126,16 +135,19 @@ TrackGridStats::TrackGridStats(int argc, char **argv)
   }
   
   // trackData object
+  // In incremental mode a TitanTrackData object is created
+  // for each track file as it is needed.
 
   if (_params.track_data_type == Params::TITAN_TRACKS) {
     
-    _trackData = new TitanTrackData(_progName, _params, *_input);
-
-    if (!_trackData->OK) {
-      fprintf(stderr, "ERROR - %s:TrackGridStats::TrackGridStats\n",
-	      _progName.c_str());
-      fprintf(stderr, "Cannot create TitanTrackData object\n");
-      isOK = FALSE;
+    if (!_params.incremental_accumulation) {
+      _trackData = new TitanTrackData(_progName, _params, *_input);
+      if (!_trackData->OK) {
+	fprintf(stderr, "ERROR - %s:TrackGridStats::TrackGridStats\n",
+		_progName.c_str());
+	fprintf(stderr, "Cannot create TitanTrackData object\n");
+	isOK = FALSE;
+      }
     }
 
   } else if (_params.track_data_type == Params::MODEL_TRACKS) {
@@ -185,6 +197,11 @@ TrackGridStats::~TrackGridStats()
 int TrackGridStats::Run ()
 {
 
+  if (_params.track_data_type == Params::TITAN_TRACKS &&
+      _params.incremental_accumulation) {
+    return _runIncremental();
+  }
+
   // create StatsGrid object
 
   StatsGrid statsGrid(_progName, _params, _args, *_trackData,
@@ -202,3 +219,113 @@ int TrackGridStats::Run ()
 
 }
 
+//////////////////////////////////////////////////
+// _runIncremental
+//
+// Update the accumulation store from the track files which
+// have changed, and compute the stats from the running sums.
+
+int TrackGridStats::_runIncremental()
+{
+
+  // runs for the same period are serialized
+
+  AccumStore store(_progName, _params, _args.startTime, _args.endTime);
+  if (store.lock()) {
+    cerr << "ERROR - " << _progName << ":_runIncremental" << endl;
+    cerr << "  Cannot lock accumulation store." << endl;
+    return -1;
+  }
+  store.load();
+
+  if (_updateStore(store)) {
+    cerr << "WARNING - " << _progName << ":_runIncremental" << endl;
+    cerr << "  Accumulation store is not consistent with track files." << endl;
+    cerr << "  Starting again." << endl;
+    store.clear();
+    if (_updateStore(store)) {
+      cerr << "ERROR - " << _progName << ":_runIncremental" << endl;
+      cerr << "  Cannot update accumulation store." << endl;
+      return -1;
+    }
+  }
+
+  if (store.write()) {
+    cerr << "ERROR - " << _progName << ":_runIncremental" << endl;
+    cerr << "  Cannot write accumulation store." << endl;
+    return -1;
+  }
+
+  // create StatsGrid object, and load it from the store
+
+  StatsGrid statsGrid(_progName, _params, _args,
+		      _args.startTime, _args.endTime);
+  store.loadStats(statsGrid);
+
+  // compute the stats
+
+  statsGrid.compute();
+
+  // Write out
+
+  statsGrid.writeOutputFile();
+
+  return (0);
+
+}
+
+//////////////////////////////////////////////////
+// _updateStore
+//
+// Add the contributions from the track files which are not
+// current in the store, and remove those for track files
+// no longer in the input.
+//
+// Returns 0 on success, -1 on failure.
+
+int TrackGridStats::_updateStore(AccumStore &store)
+{
+
+  set<string> trackFilePaths;
+  _input->reset();
+  
+  char *trackFilePath;
+  while ((trackFilePath = _input->next()) != NULL) {
+
+    PMU_auto_register("Updating accumulation");
+    trackFilePaths.insert(trackFilePath);
+
+    if (store.isCurrent(trackFilePath)) {
+      if (_params.debug >= Params::DEBUG_VERBOSE) {
+	cerr << "Track file is current: " << trackFilePath << endl;
+      }
+      continue;
+    }
+
+    // load the stats for this track file alone
+
+    vector<string> fileList;
+    fileList.push_back(trackFilePath);
+    DsInputPath fileInput(_progName,
+			  _params.debug >= Params::DEBUG_VERBOSE,
+			  fileList);
+    TitanTrackData trackData(_progName, _params, fileInput);
+    if (!trackData.OK) {
+      // keep the previous contribution, if any
+      cerr << "WARNING - " << _progName << ":_updateStore" << endl;
+      cerr << "  Cannot read track file: " << trackFilePath << endl;
+      continue;
+    }
+
+    StatsGrid contrib(_progName, _params, _args, trackData,
+		      _args.startTime, _args.endTime);
+
+    if (store.update(trackFilePath, contrib)) {
+      return -1;
+    }
+
+  } // while
+
+  return store.removeOthers(trackFilePaths);
+
+}
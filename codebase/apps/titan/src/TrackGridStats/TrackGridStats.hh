@@ -45,6 +45,7 @@ using namespace std;
 
 class TrackData;
 class DsInputPath;
+class AccumStore;
 
 class TrackGridStats {
   
@@ -78,6 +79,9 @@ private:
   DsInputPath *_input;
   TrackData *_trackData;
 
+  int _runIncremental();
+  int _updateStore(AccumStore &store);
+
 };
 
 #endif
@@ -467,10 +467,26 @@ bool GridForecast::Run ()
       
       vv.precompute(image_projection, _params->_forecast_output[i].lead_time);
       
-      if (forecast.compute(vv,
-			   image_projection,
-			   (fl32 *)_imageField->getVol(),
-			   _imageField->getFieldHeader().missing_data_value))
+      bool success;
+      
+      if (_params->advect_method == Params::SEMI_LAGRANGIAN)
+      {
+	success =
+	  forecast.precomputeTrajectories(vv, image_projection,
+					  _params->n_threads) &&
+	  forecast.computeFromTrajectories((fl32 *)_imageField->getVol(),
+					   _imageField->getFieldHeader().missing_data_value,
+					   _params->n_threads);
+      }
+      else
+      {
+	success = forecast.compute(vv,
+				   image_projection,
+				   (fl32 *)_imageField->getVol(),
+				   _imageField->getFieldHeader().missing_data_value);
+      }
+      
+      if (success)
       {
 	if (!_writeForecast(_params->image_grid_url,
                             _params->_forecast_output[i].url,
@@ -978,6 +978,40 @@
     tt->single_val.l = 180;
     tt++;
     
+    // Parameter 'advect_method'
+    // ctype is '_advect_method_t'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = ENUM_TYPE;
+    tt->param_name = tdrpStrDup("advect_method");
+    tt->descr = tdrpStrDup("Method used to advect the image grid.");
+    tt->help = tdrpStrDup("NEAREST_NEIGHBOR: each forecast grid point takes the value of the image grid point nearest to its source location. SEMI_LAGRANGIAN: the source location of each forecast grid point is computed once per lead time, and the image value is bilinearly interpolated there. Missing image points are left out of the interpolation.");
+    tt->val_offset = (char *) &advect_method - &_start_;
+    tt->enum_def.name = tdrpStrDup("advect_method_t");
+    tt->enum_def.nfields = 2;
+    tt->enum_def.fields = (enum_field_t *)
+        tdrpMalloc(tt->enum_def.nfields * sizeof(enum_field_t));
+      tt->enum_def.fields[0].name = tdrpStrDup("NEAREST_NEIGHBOR");
+      tt->enum_def.fields[0].val = NEAREST_NEIGHBOR;
+      tt->enum_def.fields[1].name = tdrpStrDup("SEMI_LAGRANGIAN");
+      tt->enum_def.fields[1].val = SEMI_LAGRANGIAN;
+    tt->single_val.e = NEAREST_NEIGHBOR;
+    tt++;
+    
+    // Parameter 'n_threads'
+    // ctype is 'long'
+    
+    memset(tt, 0, sizeof(TDRPtable));
+    tt->ptype = LONG_TYPE;
+    tt->param_name = tdrpStrDup("n_threads");
+    tt->descr = tdrpStrDup("Number of threads for SEMI_LAGRANGIAN advection.");
+    tt->help = tdrpStrDup("The grid rows are split between this many threads when computing source locations and interpolating the forecast.");
+    tt->val_offset = (char *) &n_threads - &_start_;
+    tt->has_min = TRUE;
+    tt->min_val.l = 1;
+    tt->single_val.l = 1;
+    tt++;
+    
     // Parameter 'Comment 5'
     
     memset(tt, 0, sizeof(TDRPtable));
@@ -83,6 +83,11 @@ public:
     MULTIPLE_URL = 5
   } mode_t;
 
+  typedef enum {
+    NEAREST_NEIGHBOR = 0,
+    SEMI_LAGRANGIAN = 1
+  } advect_method_t;
+
   // struct typedefs
 
   typedef struct {
@@ -446,6 +451,10 @@ public:
 
   long image_time_margin;
 
+  advect_method_t advect_method;
+
+  long n_threads;
+
   forecast_output_t *_forecast_output;
   int forecast_output_n;
 
@@ -464,7 +473,7 @@ private:
 
   void _init();
 
-  mutable TDRPtable _table[38];
+  mutable TDRPtable _table[40];
 
   const char *_className;
 
@@ -59,6 +59,7 @@
 #include <toolsa/pmu.h>
 #include <toolsa/procmap.h>
 #include <toolsa/str.h>
+#include <toolsa/TaThreadSimple.hh>
 #include <toolsa/umisc.h>
 
 #include "VariationalEchoTracker.hh"
@@ -98,6 +99,9 @@ const bool VariationalEchoTracker::DIAGCO = false;
 const int VariationalEchoTracker::IPRINT[2] = { 1, 0 };
 const float VariationalEchoTracker::EPSILON = 1.0e-6;
 
+const int VariationalEchoTracker::TILE_ROWS = 32;
+const int VariationalEchoTracker::MIN_LEVEL_DIM = 8;
+
 
 /*********************************************************************
  * Constructor
@@ -106,6 +110,8 @@ const float VariationalEchoTracker::EPSILON = 1.0e-6;
 VariationalEchoTracker::VariationalEchoTracker(int argc, char **argv) :
   _dataTrigger(0),
   _prevBaseField(0),
+  _prevUField(0),
+  _prevVField(0),
   _gnu(0),
   _gnv(0),
   _ffun1(0),
@@ -185,6 +191,8 @@ VariationalEchoTracker::~VariationalEchoTracker()
   delete _dataTrigger;
   
   delete _prevBaseField;
+  delete _prevUField;
+  delete _prevVField;
   
   delete [] _gnu;
   delete [] _gnv;
@@ -316,6 +324,11 @@ bool VariationalEchoTracker::init()
   _ffun1 = new double[_params->max_iterations];
   _gm = new double[_params->max_iterations];
   
+  // Start the threads for computing the cost function and gradients
+
+  if (_params->n_threads > 1)
+    _tileThreads.init(_params->n_threads, false);
+  
   // initialize process registration
 
   if (_params->trigger_mode == Params::LATEST_DATA)
@@ -384,19 +397,96 @@ void VariationalEchoTracker::_calcCostFuncGradient(const int iteration_num,
 						   double &cost_function,
 						   MdvxField &u_grad_field,
 						   MdvxField &v_grad_field,
-						   double *conservation_matrix) const
+						   double *conservation_matrix)
 {
   static const string method_name = "VariationalEchoTracker::_calcCostFuncGradient()";
   
-  // Calculate the cost function
+  // Retrieve some needed information
+
+  Mdvx::field_header_t prev_field_hdr = prev_base_field.getFieldHeader();
+  Mdvx::field_header_t curr_field_hdr = curr_base_field.getFieldHeader();
 
-  _calcCostFunction(prev_base_field, curr_base_field,
-		    u_field, v_field, cost_function, conservation_matrix);
+  MdvxPjg projection(curr_field_hdr);
+  
+  cost_grid_t grid;
+  
+  grid.nx = curr_field_hdr.nx;
+  grid.ny = curr_field_hdr.ny;
+  grid.prev_data = (fl32 *)prev_base_field.getVol();
+  grid.curr_data = (fl32 *)curr_base_field.getVol();
+  grid.prev_missing = prev_field_hdr.missing_data_value;
+  grid.prev_bad = prev_field_hdr.bad_data_value;
+  grid.curr_missing = curr_field_hdr.missing_data_value;
+  grid.curr_bad = curr_field_hdr.bad_data_value;
+  grid.u_data = (fl32 *)u_field.getVol();
+  grid.v_data = (fl32 *)v_field.getVol();
+  grid.u_grad_data = (fl32 *)u_grad_field.getVol();
+  grid.v_grad_data = (fl32 *)v_grad_field.getVol();
+  grid.conservation_matrix = conservation_matrix;
+  grid.dt = (double)(curr_field_hdr.user_time1 - prev_field_hdr.user_time1);
+  grid.dx = projection.x2km(curr_field_hdr.grid_dx);
+  grid.dy = projection.x2km(curr_field_hdr.grid_dy);
+  
+  if (_params->debug)
+  {
+    cerr << "dt = " << grid.dt << endl;
+    cerr << "dx = " << grid.dx << ", dy = " << grid.dy << endl;
+  }
   
-  // Calculate the gradients
+  // Split the rows into tiles.  The V grid has one more row than the
+  // base grid, so the tiles cover ny + 1 rows.  The cost function terms
+  // are summed per tile and then added up in tile order so that the
+  // result doesn't depend on the number of threads.
 
-  _calcGradients(prev_base_field, u_field, v_field,
-		 u_grad_field, v_grad_field, conservation_matrix);
+  grid.n_tiles = (grid.ny + TILE_ROWS) / TILE_ROWS;
+  
+  vector< double > tile_costs(grid.n_tiles * 3, 0.0);
+  grid.tile_costs = &tile_costs[0];
+  
+  int n_threads = _params->n_threads;
+  if (n_threads > grid.n_tiles)
+    n_threads = grid.n_tiles;
+  
+  if (n_threads <= 1)
+  {
+    for (int tile_num = 0; tile_num < grid.n_tiles; ++tile_num)
+      _calcTileCostGradient(grid, tile_num);
+  }
+  else
+  {
+    for (int thread_num = 0; thread_num < n_threads; ++thread_num)
+    {
+      TileInfo *info = new TileInfo(this, &grid, thread_num, n_threads);
+      _tileThreads.thread(thread_num, (void *)info);
+    }
+    _tileThreads.waitForThreads();
+  }
+  
+  double ffz = 0.0;
+  double ffsmsu = 0.0;
+  double ffsmsv = 0.0;
+  
+  for (int tile_num = 0; tile_num < grid.n_tiles; ++tile_num)
+  {
+    ffz += tile_costs[tile_num * 3];
+    ffsmsu += tile_costs[tile_num * 3 + 1];
+    ffsmsv += tile_costs[tile_num * 3 + 2];
+  }
+  
+  double ffsms = ffsmsu + ffsmsv;
+  
+  cost_function = ffz + ffsms;
+  
+  if (_params->debug)
+  {
+    cerr << "Cost Function Total: " << cost_function << endl;
+    cerr << "Cost Reflectivity: " << ffz << endl;
+    cerr << endl;
+    cerr << "Spatial smoothness constraint: " << ffsms << endl;
+    cerr << "  U portion = " << ffsmsu << endl;
+    cerr << "  V portion = " << ffsmsv << endl;
+    cerr << endl;
+  }
   
   // Calculate and print out diagnostics
 
@@ -449,82 +539,82 @@ void VariationalEchoTracker::_calcCostFuncGradient(const int iteration_num,
 
 
 /*********************************************************************
- * _calcCostFunction() - Calculate the current iteration cost function.
+ * _calcTileCostGradient() - Calculate the cost function terms and the
+ *                           gradients for the rows in the given tile.
+ *                           The cost function terms are saved in the
+ *                           tile_costs array for the tile.
  */
 
-void VariationalEchoTracker::_calcCostFunction(const MdvxField &prev_base_field,
-					       const MdvxField &curr_base_field,
-					       MdvxField &u_field,
-					       MdvxField &v_field,
-					       double &cost_function,
-					       double *conservation_matrix) const
+void VariationalEchoTracker::_calcTileCostGradient(const cost_grid_t &grid,
+						   const int tile_num) const
 {
-  static const string method_name = "VariationalEchoTracker::_calcCostFunction()";
-  
-  // Retrieve some needed information
+  // Get the grid sizes.  The U grid is offset in the X direction and
+  // the V grid is offset in the Y direction.
 
-  Mdvx::field_header_t prev_field_hdr = prev_base_field.getFieldHeader();
-  Mdvx::field_header_t curr_field_hdr = curr_base_field.getFieldHeader();
-
-  MdvxPjg projection(curr_field_hdr);
+  int nx = grid.nx;
+  int ny = grid.ny;
   
-  fl32 *prev_data = (fl32 *)prev_base_field.getVol();
-  fl32 *curr_data = (fl32 *)curr_base_field.getVol();
+  int u_nx = nx + 1;
+  int u_ny = ny;
+  int v_nx = nx;
+  int v_ny = ny + 1;
   
-  double dt = (double)(curr_field_hdr.user_time1 - prev_field_hdr.user_time1);
+  const fl32 *prev_data = grid.prev_data;
+  const fl32 *curr_data = grid.curr_data;
+  const fl32 *u_data = grid.u_data;
+  const fl32 *v_data = grid.v_data;
+  fl32 *u_grad_data = grid.u_grad_data;
+  fl32 *v_grad_data = grid.v_grad_data;
+  const double *conservation_matrix = grid.conservation_matrix;
   
-  double dx = projection.x2km(curr_field_hdr.grid_dx);
-  double dy = projection.x2km(curr_field_hdr.grid_dy);
+  double dt = grid.dt;
+  double dx = grid.dx;
+  double dy = grid.dy;
   
-  Mdvx::field_header_t u_field_hdr = u_field.getFieldHeader();
-  Mdvx::field_header_t v_field_hdr = v_field.getFieldHeader();
+  double u_weight = _params->smoothness_constraint_weights.u_weight;
+  double v_weight = _params->smoothness_constraint_weights.v_weight;
   
-  fl32 *u_data = (fl32 *)u_field.getVol();
-  fl32 *v_data = (fl32 *)v_field.getVol();
-  
-  if (_params->debug)
-  {
-    cerr << "dt = " << dt << endl;
-    cerr << "dx = " << dx << ", dy = " << dy << endl;
-  }
+  // Get the rows in this tile
+
+  int tile_start = tile_num * TILE_ROWS;
+  int tile_end = tile_start + TILE_ROWS;
   
   // Compute the cost function of reflectivity conservation
 
-  cost_function = 0.0;
   double ffz = 0.0;
   
-  for (int y = 1; y < curr_field_hdr.ny - 1; ++y)
+  for (int y = max(tile_start, 1); y < min(tile_end, ny - 1); ++y)
   {
-    for (int x = 1; x < curr_field_hdr.nx - 1; ++x)
+    for (int x = 1; x < nx - 1; ++x)
     {
       // Compute the indices for all of the surrounding points
 
-      int idx = (y * curr_field_hdr.nx) + x;
-      int idxn = ((y+1) * curr_field_hdr.nx) + x;
-      int idxs = ((y-1) * curr_field_hdr.nx) + x;
-      int idxe = (y * curr_field_hdr.nx) + (x+1);
-      int idxw = (y * curr_field_hdr.nx) + (x-1);
+      int idx = (y * nx) + x;
+      int idxn = ((y+1) * nx) + x;
+      int idxs = ((y-1) * nx) + x;
+      int idxe = (y * nx) + (x+1);
+      int idxw = (y * nx) + (x-1);
 
-      int uidx = (y * u_field_hdr.nx) + x;
-      int uidxw = (y * u_field_hdr.nx) + (x-1);
+      int uidx = (y * u_nx) + x;
+      int uidxw = (y * u_nx) + (x-1);
       
-      int vidx = (y * v_field_hdr.nx) + x;
-      int vidxs = ((y-1) * v_field_hdr.nx) + x;
+      int vidx = (y * v_nx) + x;
+      int vidxs = ((y-1) * v_nx) + x;
 
       // Don't process missing data values
 
-      if (curr_data[idx] == curr_field_hdr.missing_data_value ||
-	  curr_data[idx] == curr_field_hdr.bad_data_value ||
-	  prev_data[idx] == prev_field_hdr.missing_data_value ||
-	  prev_data[idx] == prev_field_hdr.bad_data_value ||
-	  prev_data[idxe] == prev_field_hdr.missing_data_value ||
-	  prev_data[idxe] == prev_field_hdr.bad_data_value ||
-	  prev_data[idxw] == prev_field_hdr.missing_data_value ||
-	  prev_data[idxw] == prev_field_hdr.bad_data_value ||
-	  prev_data[idxn] == prev_field_hdr.missing_data_value ||
-	  prev_data[idxn] == prev_field_hdr.bad_data_value ||
-	  prev_data[idxs] == prev_field_hdr.missing_data_value ||
-	  prev_data[idxs] == prev_field_hdr.bad_data_value)
+      if (curr_data[idx] == grid.curr_missing ||
+	  curr_data[idx] == grid.curr_bad ||
+	  prev_data[idx] == grid.prev_missing ||
+	  prev_data[idx] == grid.prev_bad ||
+	  prev_data[idxe] == grid.prev_missing ||
+	  prev_data[idxe] == grid.prev_bad ||
+	  prev_data[idxw] == grid.prev_missing ||
+	  prev_data[idxw] == grid.prev_bad ||
+	  prev_data[idxn] == grid.prev_missing ||
+	  prev_data[idxn] == grid.prev_bad ||
+	  prev_data[idxs] == grid.prev_missing ||
+	  prev_data[idxs] == grid.prev_bad)
 	continue;
       
       double ffz_increment = conservation_matrix[idx] *
@@ -543,22 +633,22 @@ void VariationalEchoTracker::_calcCostFunction(const MdvxField &prev_base_field,
 
   double ffsmsv = 0.0;
 
-  for (int y = 1; y < v_field_hdr.ny - 1; ++y)
+  for (int y = max(tile_start, 1); y < min(tile_end, v_ny - 1); ++y)
   {
-    for (int x = 1; x < v_field_hdr.nx - 1; ++x)
+    for (int x = 1; x < v_nx - 1; ++x)
     {
       // Compute the indices for all of the surrounding points
 
-      int idx = (y * v_field_hdr.nx) + x;
-      int idxn = ((y+1) * v_field_hdr.nx) + x;
-      int idxs = ((y-1) * v_field_hdr.nx) + x;
-      int idxe = (y * v_field_hdr.nx) + (x+1);
-      int idxw = (y * v_field_hdr.nx) + (x-1);
+      int idx = (y * v_nx) + x;
+      int idxn = ((y+1) * v_nx) + x;
+      int idxs = ((y-1) * v_nx) + x;
+      int idxe = (y * v_nx) + (x+1);
+      int idxw = (y * v_nx) + (x-1);
 
       double vfactor1 = v_data[idxn] - 2.0 * v_data[idx] + v_data[idxs];
       double vfactor2 = v_data[idxe] - 2.0 * v_data[idx] + v_data[idxw];
       
-      ffsmsv += _params->smoothness_constraint_weights.v_weight *
+      ffsmsv += v_weight *
 	((vfactor1 * vfactor1) + (vfactor2 * vfactor2));
       
     } /* endfor - x */
@@ -568,127 +658,84 @@ void VariationalEchoTracker::_calcCostFunction(const MdvxField &prev_base_field,
 
   double ffsmsu = 0.0;
 
-  for (int y = 1; y < u_field_hdr.ny - 1; ++y)
+  for (int y = max(tile_start, 1); y < min(tile_end, u_ny - 1); ++y)
   {
-    for (int x = 1; x < u_field_hdr.nx - 1; ++x)
+    for (int x = 1; x < u_nx - 1; ++x)
     {
       // Compute the indices for all of the surrounding points
 
-      int idx = (y * u_field_hdr.nx) + x;
-      int idxn = ((y+1) * u_field_hdr.nx) + x;
-      int idxs = ((y-1) * u_field_hdr.nx) + x;
-      int idxe = (y * u_field_hdr.nx) + (x+1);
-      int idxw = (y * u_field_hdr.nx) + (x-1);
+      int idx = (y * u_nx) + x;
+      int idxn = ((y+1) * u_nx) + x;
+      int idxs = ((y-1) * u_nx) + x;
+      int idxe = (y * u_nx) + (x+1);
+      int idxw = (y * u_nx) + (x-1);
 
       double ufactor1 = u_data[idxn] - 2.0 * u_data[idx] + u_data[idxs];
       double ufactor2 = u_data[idxe] - 2.0 * u_data[idx] + u_data[idxw];
       
-      ffsmsu +=	_params->smoothness_constraint_weights.u_weight *
+      ffsmsu +=	u_weight *
 	((ufactor1 * ufactor1) + (ufactor2 * ufactor2));
 
     } /* endfor - x */
   } /* endfor - y */
   
-  double ffsms = ffsmsu + ffsmsv;
-  
-  cost_function = ffz + ffsms;
-  
-  if (_params->debug)
-  {
-    cerr << "Cost Function Total: " << cost_function << endl;
-    cerr << "Cost Reflectivity: " << ffz << endl;
-    cerr << endl;
-    cerr << "Spatial smoothness constraint: " << ffsms << endl;
-    cerr << "  U portion = " << ffsmsu << endl;
-    cerr << "  V portion = " << ffsmsv << endl;
-    cerr << endl;
-  }
-}
-
-
-/*********************************************************************
- * _calcGradients() - Calculate the current iteration gradients.
- */
-
-void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
-					    MdvxField &u_field,
-					    MdvxField &v_field,
-					    MdvxField &u_grad_field,
-					    MdvxField &v_grad_field,
-					    double *conservation_matrix) const
-{
-  // Get some information we'll need below
-
-  Mdvx::field_header_t prev_field_hdr = prev_base_field.getFieldHeader();
-  Mdvx::field_header_t u_field_hdr = u_field.getFieldHeader();
-  Mdvx::field_header_t v_field_hdr = v_field.getFieldHeader();
-  
-  fl32 *prev_data = (fl32 *)prev_base_field.getVol();
-  
-  fl32 *u_data = (fl32 *)u_field.getVol();
-  fl32 *v_data = (fl32 *)v_field.getVol();
-  
-  fl32 *u_grad_data = (fl32 *)u_grad_field.getVol();
-  fl32 *v_grad_data = (fl32 *)v_grad_field.getVol();
-  
-  MdvxPjg projection(u_field_hdr);
-  
-  double dx = projection.x2km(u_field_hdr.grid_dx);
-  double dy = projection.x2km(u_field_hdr.grid_dy);
+  grid.tile_costs[tile_num * 3] = ffz;
+  grid.tile_costs[tile_num * 3 + 1] = ffsmsu;
+  grid.tile_costs[tile_num * 3 + 2] = ffsmsv;
   
   // Calculate the gradient of the reflectivity conservation equation
 
-  for (int x = 1; x < prev_field_hdr.nx - 2; ++x)
+  for (int y = max(tile_start, 1); y < min(tile_end, ny - 1); ++y)
   {
-    for (int y = 1; y < prev_field_hdr.ny - 1; ++y)
+    for (int x = 1; x < nx - 2; ++x)
     {
-      int idx = (y * prev_field_hdr.nx) + x;
-      int idxe = (y * prev_field_hdr.nx) + (x+1);
-      int idxee = (y * prev_field_hdr.nx) + (x+2);
-      int idxw = (y * prev_field_hdr.nx) + (x-1);
+      int idx = (y * nx) + x;
+      int idxe = (y * nx) + (x+1);
+      int idxee = (y * nx) + (x+2);
+      int idxw = (y * nx) + (x-1);
       
-      int uidx = (y * u_field_hdr.nx) + x;
+      int uidx = (y * u_nx) + x;
       
       u_grad_data[uidx] = 0.5 / dx *
 	(conservation_matrix[idx] * (prev_data[idxe] - prev_data[idxw]) +
 	 conservation_matrix[idxe] * (prev_data[idxee] - prev_data[idx]));
       
-    } /* endfor - y */
-  } /* endfor - x */
+    } /* endfor - x */
+  } /* endfor - y */
   
-  for (int x = 1; x < prev_field_hdr.nx - 1; ++x)
+  for (int y = max(tile_start, 1); y < min(tile_end, ny - 2); ++y)
   {
-    for (int y = 1; y < prev_field_hdr.ny - 2; ++y)
+    for (int x = 1; x < nx - 1; ++x)
     {
-      int idx = (y * prev_field_hdr.nx) + x;
-      int idxn = ((y+1) * prev_field_hdr.nx) + x;
-      int idxnn = ((y+2) * prev_field_hdr.nx) + x;
-      int idxs = ((y-1) * prev_field_hdr.nx) + x;
+      int idx = (y * nx) + x;
+      int idxn = ((y+1) * nx) + x;
+      int idxnn = ((y+2) * nx) + x;
+      int idxs = ((y-1) * nx) + x;
       
-      int vidx = (y * v_field_hdr.nx) + x;
+      int vidx = (y * v_nx) + x;
       
       v_grad_data[vidx] = 0.5 / dy *
 	(conservation_matrix[idx] * (prev_data[idxn] - prev_data[idxs]) +
 	 conservation_matrix[idxn] * (prev_data[idxnn] - prev_data[idx]));
       
-    } /* endfor - y */
-  } /* endfor - x */
+    } /* endfor - x */
+  } /* endfor - y */
   
   // Calculate the gradients of the smoothness constraint
 
-  for (int y = 2; y < u_field_hdr.ny - 2; ++y)
+  for (int y = max(tile_start, 2); y < min(tile_end, u_ny - 2); ++y)
   {
-    for (int x = 2; x < u_field_hdr.nx - 2; ++x)
+    for (int x = 2; x < u_nx - 2; ++x)
     {
-      int idx = (y * u_field_hdr.nx) + x;
-      int idxe = (y * u_field_hdr.nx) + (x+1);
-      int idxee = (y * u_field_hdr.nx) + (x+2);
-      int idxw = (y * u_field_hdr.nx) + (x-1);
-      int idxww = (y * u_field_hdr.nx) + (x-2);
-      int idxn = ((y+1) * u_field_hdr.nx) + x;
-      int idxnn = ((y+2) * u_field_hdr.nx) + x;
-      int idxs = ((y-1) * u_field_hdr.nx) + x;
-      int idxss = ((y-2) * u_field_hdr.nx) + x;
+      int idx = (y * u_nx) + x;
+      int idxe = (y * u_nx) + (x+1);
+      int idxee = (y * u_nx) + (x+2);
+      int idxw = (y * u_nx) + (x-1);
+      int idxww = (y * u_nx) + (x-2);
+      int idxn = ((y+1) * u_nx) + x;
+      int idxnn = ((y+2) * u_nx) + x;
+      int idxs = ((y-1) * u_nx) + x;
+      int idxss = ((y-2) * u_nx) + x;
 
       double uym2;
       double uyp2;
@@ -700,7 +747,7 @@ void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
       else
 	uym2 = 2.0 * u_data[idxs] - u_data[idx];
       
-      if (y < u_field_hdr.ny - 1)
+      if (y < u_ny - 1)
 	uyp2 = u_data[idxnn];
       else
 	uyp2 = 2.0 * u_data[idxn] - u_data[idx];
@@ -710,17 +757,17 @@ void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
       else
 	uxm2 = 2.0 * u_data[idxw] - u_data[idx];
       
-      if (x < u_field_hdr.nx)
+      if (x < u_nx)
 	uxp2 = u_data[idxee];
       else
 	uxp2 = 2.0 * u_data[idxe] - u_data[idx];
       
       u_grad_data[idx] = u_grad_data[idx] +
-	2.0 * _params->smoothness_constraint_weights.u_weight *
+	2.0 * u_weight *
 	(-2.0 * (u_data[idxn] + u_data[idxs] - 2.0 * u_data[idx]) +
 	 (u_data[idx] + uym2 - 2.0 * u_data[idxs]) +
 	 (uyp2 + u_data[idx] - 2.0 * u_data[idxn])) +
-	2.0 * _params->smoothness_constraint_weights.u_weight *
+	2.0 * u_weight *
 	(-2.0 * (u_data[idxe] + u_data[idxw] - 2.0 * u_data[idx]) +
 	(u_data[idx] + uxm2 - 2.0 * u_data[idxw]) +
 	(uxp2 + u_data[idx] - 2.0 * u_data[idxe]));
@@ -728,19 +775,19 @@ void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
     } /* endfor - x */
   } /* endfor - y */
   
-  for (int y = 2; y < v_field_hdr.ny - 2; ++y)
+  for (int y = max(tile_start, 2); y < min(tile_end, v_ny - 2); ++y)
   {
-    for (int x = 2; x < v_field_hdr.nx - 2; ++x)
+    for (int x = 2; x < v_nx - 2; ++x)
     {
-      int idx = (y * v_field_hdr.nx) + x;
-      int idxe = (y * v_field_hdr.nx) + (x+1);
-      int idxee = (y * v_field_hdr.nx) + (x+2);
-      int idxw = (y * v_field_hdr.nx) + (x-1);
-      int idxww = (y * v_field_hdr.nx) + (x-2);
-      int idxn = ((y+1) * v_field_hdr.nx) + x;
-      int idxnn = ((y+2) * v_field_hdr.nx) + x;
-      int idxs = ((y-1) * v_field_hdr.nx) + x;
-      int idxss = ((y-2) * v_field_hdr.nx) + x;
+      int idx = (y * v_nx) + x;
+      int idxe = (y * v_nx) + (x+1);
+      int idxee = (y * v_nx) + (x+2);
+      int idxw = (y * v_nx) + (x-1);
+      int idxww = (y * v_nx) + (x-2);
+      int idxn = ((y+1) * v_nx) + x;
+      int idxnn = ((y+2) * v_nx) + x;
+      int idxs = ((y-1) * v_nx) + x;
+      int idxss = ((y-2) * v_nx) + x;
 
       double vym2;
       double vyp2;
@@ -752,7 +799,7 @@ void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
       else
 	vym2 = 2.0 * v_data[idxs] - v_data[idx];
       
-      if (y < v_field_hdr.ny - 1)
+      if (y < v_ny - 1)
 	vyp2 = v_data[idxnn];
       else
 	vyp2 = 2.0 * v_data[idxn] - v_data[idx];
@@ -762,17 +809,17 @@ void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
       else
 	vxm2 = 2.0 * v_data[idxw] - v_data[idx];
       
-      if (x < v_field_hdr.nx)
+      if (x < v_nx)
 	vxp2 = v_data[idxee];
       else
 	vxp2 = 2.0 * v_data[idxe] - v_data[idx];
       
       v_grad_data[idx] = v_grad_data[idx] +
-	_params->smoothness_constraint_weights.v_weight *
+	v_weight *
 	(-4.0 * (v_data[idxn] + v_data[idxs] - 2.0 * v_data[idx]) +
 	 2.0 * (v_data[idx] + vym2 - 2.0 * v_data[idxs]) +
 	 2.0 * (vyp2 + v_data[idx] - 2.0 * v_data[idxn])) +
-	_params->smoothness_constraint_weights.v_weight *
+	v_weight *
 	(-4.0 * (v_data[idxe] + v_data[idxw] - 2.0 * v_data[idx]) +
 	 2.0 * (v_data[idx] + vxm2 - 2.0 * v_data[idxw]) +
 	 2.0 * (vxp2 + v_data[idx] - 2.0 * v_data[idxe]));
@@ -783,6 +830,160 @@ void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
 }
 
 
+/*********************************************************************
+ * _coarsenBaseField() - Create a base field at half the resolution of
+ *                       the given field by averaging the valid data in
+ *                       each 2x2 block of grid squares.
+ *
+ * Returns a pointer to the new field, which must be deleted by the
+ * caller.
+ */
+
+MdvxField *VariationalEchoTracker::_coarsenBaseField(const MdvxField &base_field)
+{
+  Mdvx::field_header_t field_hdr = base_field.getFieldHeader();
+  
+  // The coarse grid squares are centered on the 2x2 blocks of the
+  // fine grid.  Any odd row or column at the edge is dropped.
+
+  Mdvx::field_header_t coarse_hdr = field_hdr;
+  coarse_hdr.nx = field_hdr.nx / 2;
+  coarse_hdr.ny = field_hdr.ny / 2;
+  coarse_hdr.nz = 1;
+  coarse_hdr.grid_dx = field_hdr.grid_dx * 2.0;
+  coarse_hdr.grid_dy = field_hdr.grid_dy * 2.0;
+  coarse_hdr.grid_minx = field_hdr.grid_minx + (field_hdr.grid_dx / 2.0);
+  coarse_hdr.grid_miny = field_hdr.grid_miny + (field_hdr.grid_dy / 2.0);
+  coarse_hdr.volume_size =
+    coarse_hdr.nx * coarse_hdr.ny * coarse_hdr.data_element_nbytes;
+  
+  MdvxField *coarse_field =
+    new MdvxField(coarse_hdr, base_field.getVlevelHeader());
+  
+  const fl32 *data = (fl32 *)base_field.getVol();
+  fl32 *coarse_data = (fl32 *)coarse_field->getVol();
+  
+  for (int y = 0; y < coarse_hdr.ny; ++y)
+  {
+    for (int x = 0; x < coarse_hdr.nx; ++x)
+    {
+      double sum = 0.0;
+      int num_valid = 0;
+      
+      for (int j = 2 * y; j < 2 * y + 2; ++j)
+      {
+	for (int i = 2 * x; i < 2 * x + 2; ++i)
+	{
+	  fl32 value = data[(j * field_hdr.nx) + i];
+	  
+	  if (value == field_hdr.missing_data_value ||
+	      value == field_hdr.bad_data_value)
+	    continue;
+	  
+	  sum += value;
+	  ++num_valid;
+	} /* endfor - i */
+      } /* endfor - j */
+      
+      int coarse_idx = (y * coarse_hdr.nx) + x;
+      
+      if (num_valid > 0)
+	coarse_data[coarse_idx] = sum / (double)num_valid;
+      else
+	coarse_data[coarse_idx] = coarse_hdr.missing_data_value;
+      
+    } /* endfor - x */
+  } /* endfor - y */
+  
+  return coarse_field;
+}
+
+
+/*********************************************************************
+ * _computeTiles() - Thread method.  Calculates the cost function and
+ *                   gradients for the tiles assigned to this thread.
+ */
+
+void VariationalEchoTracker::_computeTiles(void *ti)
+{
+  TileInfo *info = static_cast<TileInfo *>(ti);
+  
+  for (int tile_num = info->_threadNum; tile_num < info->_grid->n_tiles;
+       tile_num += info->_nThreads)
+    info->_obj->_calcTileCostGradient(*info->_grid, tile_num);
+  
+  delete info;
+}
+
+
+/*********************************************************************
+ * _createMotionField() - Create an offset U or V field, with all values
+ *                        set to 0, for the given base field.
+ *
+ * Returns a pointer to the new field, which must be deleted by the
+ * caller.
+ */
+
+MdvxField *VariationalEchoTracker::_createMotionField(const MdvxField &base_field,
+						      const bool u_field,
+						      const bool grad_field)
+{
+  // Note that the U and V fields are offset from the base field so that
+  // the center of the base grid square is on the border between two U
+  // grid squares in the X direction and on the border between two V grid
+  // squares in the Y direction.  This makes the U grid larger by 1 in the
+  // X direction and the V grid larger by one in the Y direction.
+
+  Mdvx::field_header_t field_hdr = base_field.getFieldHeader();
+  
+  if (u_field)
+  {
+    field_hdr.nx = field_hdr.nx + 1;
+    field_hdr.grid_minx = field_hdr.grid_minx - (field_hdr.grid_dx / 2.0);
+  }
+  else
+  {
+    field_hdr.ny = field_hdr.ny + 1;
+    field_hdr.grid_miny = field_hdr.grid_miny - (field_hdr.grid_dy / 2.0);
+  }
+  
+  field_hdr.nz = 1;
+  field_hdr.volume_size =
+    field_hdr.nx * field_hdr.ny * field_hdr.data_element_nbytes;
+  field_hdr.bad_data_value = -999.0;
+  field_hdr.missing_data_value = -999.0;
+  field_hdr.min_value = 0.0;
+  field_hdr.max_value = 0.0;
+  field_hdr.transform[0] = '\0';
+  
+  string name = u_field ? "U" : "V";
+  
+  if (grad_field)
+  {
+    STRcopy(field_hdr.field_name_long, (name + " gradient").c_str(),
+	    MDV_LONG_FIELD_LEN);
+    STRcopy(field_hdr.field_name, (name + " grad").c_str(),
+	    MDV_SHORT_FIELD_LEN);
+    STRcopy(field_hdr.units, "none", MDV_UNITS_LEN);
+  }
+  else
+  {
+    STRcopy(field_hdr.field_name_long, name.c_str(), MDV_LONG_FIELD_LEN);
+    STRcopy(field_hdr.field_name, name.c_str(), MDV_SHORT_FIELD_LEN);
+    STRcopy(field_hdr.units, "m/s", MDV_UNITS_LEN);
+  }
+  
+  MdvxField *motion_field =
+    new MdvxField(field_hdr, base_field.getVlevelHeader());
+  
+  fl32 *motion_data = (fl32 *)motion_field->getVol();
+  memset(motion_data, 0,
+	 field_hdr.nx * field_hdr.ny * sizeof(fl32));
+  
+  return motion_field;
+}
+
+
 /*********************************************************************
  * _generateMotionVectors() - Generate the U and V fields based on the
  *                            given previous and current base fields.
@@ -793,120 +994,139 @@ void VariationalEchoTracker::_calcGradients(const MdvxField &prev_base_field,
 bool VariationalEchoTracker::_generateMotionVectors(const MdvxField &prev_base_field,
 						    const MdvxField &curr_base_field)
 {
-  static const string method_name = "VariationalEchoTracker::_processData()";
+  static const string method_name = "VariationalEchoTracker::_generateMotionVectors()";
   
-  // Extract some needed field information
+  // Create the multigrid levels.  Level 0 is the native grid and each
+  // following level has half the resolution of the one before.
 
-  Mdvx::field_header_t prev_field_hdr = prev_base_field.getFieldHeader();
-  Mdvx::field_header_t curr_field_hdr = curr_base_field.getFieldHeader();
-  
-  Mdvx::vlevel_header_t curr_vlevel_hdr = curr_base_field.getVlevelHeader();
-  
-  // Specify the first guess U and V fields.  Note that the U and V fields
-  // are offset from the base field so that the center of the base grid square
-  // is on the border between two U grid squares in the X direction and on
-  // the border between two V grid squares in the Y direction.  This makes
-  // the U grid larger by 1 in the X direction and the V grid larger by one
-  // in the Y direction.  In the end, the final U/V fields will be calculated
-  // by averaging the 2 U grid values in the X direction and the 2 V grid
-  // values in the Y direction.
-
-  Mdvx::field_header_t u_field_hdr = curr_field_hdr;
-  u_field_hdr.nx = u_field_hdr.nx + 1;
-  u_field_hdr.nz = 1;
-  u_field_hdr.grid_minx = u_field_hdr.grid_minx - (u_field_hdr.grid_dx / 2.0);
-  u_field_hdr.volume_size =
-    u_field_hdr.nx * u_field_hdr.ny * u_field_hdr.data_element_nbytes;
-  u_field_hdr.bad_data_value = -999.0;
-  u_field_hdr.missing_data_value = -999.0;
-  u_field_hdr.min_value = 0.0;
-  u_field_hdr.max_value = 0.0;
-  STRcopy(u_field_hdr.field_name_long, "U", MDV_LONG_FIELD_LEN);
-  STRcopy(u_field_hdr.field_name, "U", MDV_SHORT_FIELD_LEN);
-  STRcopy(u_field_hdr.units, "m/s", MDV_UNITS_LEN);
-  u_field_hdr.transform[0] = '\0';
-  MdvxField u_field(u_field_hdr, curr_vlevel_hdr);
-
-  Mdvx::field_header_t v_field_hdr = curr_field_hdr;
-  v_field_hdr.ny = v_field_hdr.ny + 1;
-  v_field_hdr.nz = 1;
-  v_field_hdr.grid_miny = v_field_hdr.grid_miny - (v_field_hdr.grid_dy / 2.0);
-  v_field_hdr.volume_size =
-    v_field_hdr.nx * v_field_hdr.ny * v_field_hdr.data_element_nbytes;
-  v_field_hdr.bad_data_value = -999.0;
-  v_field_hdr.missing_data_value = -999.0;
-  v_field_hdr.min_value = 0.0;
-  v_field_hdr.max_value = 0.0;
-  STRcopy(v_field_hdr.field_name_long, "V", MDV_LONG_FIELD_LEN);
-  STRcopy(v_field_hdr.field_name, "V", MDV_SHORT_FIELD_LEN);
-  STRcopy(v_field_hdr.units, "m/s", MDV_UNITS_LEN);
-  v_field_hdr.transform[0] = '\0';
-  MdvxField v_field(v_field_hdr, curr_vlevel_hdr);
-  
-  if (!_getFirstGuessUV(u_field, v_field))
-    return false;
+  vector< const MdvxField* > prev_levels;
+  vector< const MdvxField* > curr_levels;
+  vector< MdvxField* > coarse_fields;
   
-  // Create and initialize the U/V gradient fields.  Initialize all of
-  // the field values to 0 because we don't calculate gradients along the
-  // edges in the later code.
-
-  Mdvx::field_header_t u_grad_hdr = u_field_hdr;
-  STRcopy(u_grad_hdr.field_name_long, "U gradient", MDV_LONG_FIELD_LEN);
-  STRcopy(u_grad_hdr.field_name, "U grad", MDV_SHORT_FIELD_LEN);
-  STRcopy(u_grad_hdr.units, "none", MDV_UNITS_LEN);
-  MdvxField u_grad_field(u_grad_hdr, curr_vlevel_hdr);
-  fl32 *u_grad_data = (fl32 *)u_grad_field.getVol();
-  memset(u_grad_data, 0, u_grad_hdr.nx * u_grad_hdr.ny * sizeof(fl32));
+  prev_levels.push_back(&prev_base_field);
+  curr_levels.push_back(&curr_base_field);
   
-  Mdvx::field_header_t v_grad_hdr = v_field_hdr;
-  STRcopy(v_grad_hdr.field_name_long, "V gradient", MDV_LONG_FIELD_LEN);
-  STRcopy(v_grad_hdr.field_name, "V grad", MDV_SHORT_FIELD_LEN);
-  STRcopy(v_grad_hdr.units, "none", MDV_UNITS_LEN);
-  MdvxField v_grad_field(v_grad_hdr, curr_vlevel_hdr);
-  fl32 *v_grad_data = (fl32 *)v_grad_field.getVol();
-  memset(v_grad_data, 0, v_grad_hdr.nx * v_grad_hdr.ny * sizeof(fl32));
+  while ((int)curr_levels.size() < _params->n_multigrid_levels)
+  {
+    Mdvx::field_header_t field_hdr = curr_levels.back()->getFieldHeader();
+    
+    if (field_hdr.nx / 2 < MIN_LEVEL_DIM || field_hdr.ny / 2 < MIN_LEVEL_DIM)
+    {
+      if (_params->debug)
+	cerr << "Grid too small for more than " << curr_levels.size()
+	     << " multigrid levels" << endl;
+      
+      break;
+    }
+    
+    MdvxField *prev_field = _coarsenBaseField(*prev_levels.back());
+    MdvxField *curr_field = _coarsenBaseField(*curr_levels.back());
+    
+    prev_levels.push_back(prev_field);
+    curr_levels.push_back(curr_field);
+    coarse_fields.push_back(prev_field);
+    coarse_fields.push_back(curr_field);
+  }
   
-  // Initialize work arrays before the iterations begin
+  // Minimize the cost function on each level, from the coarsest to the
+  // finest.  Each level starts from the motion found on the level before.
 
-  _initializeWorkArrays(u_field_hdr, v_field_hdr, MdvxPjg(prev_field_hdr));
+  MdvxField *u_field = 0;
+  MdvxField *v_field = 0;
+  MdvxField *u_grad_field = 0;
+  MdvxField *v_grad_field = 0;
   
-  // Minimize the cost function and gradients
-
-  double cost_function;
-    
-  for (int iteration_num = 0; iteration_num < _params->max_iterations;
-       ++iteration_num)
+  bool success = true;
+  
+  for (int level = (int)curr_levels.size() - 1; level >= 0; --level)
   {
-    if (_params->debug)
-      cerr << "----- ITERATION " << iteration_num << " -----" << endl;
+    const MdvxField &level_base_field = *curr_levels[level];
     
-    // Calculate the current iteration cost function and gradients
-
-    _calcCostFuncGradient(iteration_num, prev_base_field, curr_base_field,
-			  u_field, v_field,
-			  cost_function, u_grad_field, v_grad_field,
-			  _conservationMatrix);
+    MdvxField *level_u_field =
+      _createMotionField(level_base_field, true, false);
+    MdvxField *level_v_field =
+      _createMotionField(level_base_field, false, false);
     
-    // Minimize the functions
+    // Specify the first guess U and V fields
 
-    int ret = _performMinimization(u_field, v_field,
-				   u_grad_field, v_grad_field,
-				   cost_function);
+    if (u_field != 0)
+    {
+      _interpMotionField(*u_field, *level_u_field);
+      _interpMotionField(*v_field, *level_v_field);
+    }
+    else if (_params->use_previous_motion && _prevUField != 0)
+    {
+      _interpMotionField(*_prevUField, *level_u_field);
+      _interpMotionField(*_prevVField, *level_v_field);
+    }
+    else if (!_getFirstGuessUV(*level_u_field, *level_v_field))
+    {
+      delete level_u_field;
+      delete level_v_field;
+      
+      success = false;
+      break;
+    }
     
-    if (_params->debug)
-      cerr << "minimization return = " << ret << endl;
+    delete u_field;
+    delete v_field;
+    delete u_grad_field;
+    delete v_grad_field;
     
-    if (ret <= 0)
-      break;
+    u_field = level_u_field;
+    v_field = level_v_field;
+    
+    // Create the U/V gradient fields.  All of the field values are
+    // initialized to 0 because we don't calculate gradients along the
+    // edges in the later code.
+
+    u_grad_field = _createMotionField(level_base_field, true, true);
+    v_grad_field = _createMotionField(level_base_field, false, true);
     
     if (_params->debug)
-      cerr << " FINISHED ITERATION " << iteration_num << endl;
+    {
+      Mdvx::field_header_t level_hdr = level_base_field.getFieldHeader();
+      cerr << "===== LEVEL " << level << ": " << level_hdr.nx << " x "
+	   << level_hdr.ny << " =====" << endl;
+    }
     
-  } /* endfor - iteration_num */
+    _minimizeLevel(*prev_levels[level], level_base_field,
+		   *u_field, *v_field, *u_grad_field, *v_grad_field);
+    
+  } /* endfor - level */
+  
+  for (size_t i = 0; i < coarse_fields.size(); ++i)
+    delete coarse_fields[i];
   
   // Write out the motion vectors
 
-  if (!_writeVectors(u_field, v_field, u_grad_field, v_grad_field))
+  if (success &&
+      !_writeVectors(*u_field, *v_field, *u_grad_field, *v_grad_field))
+    success = false;
+  
+  // Save the motion to use as the first guess for the next volume
+
+  delete _prevUField;
+  delete _prevVField;
+  
+  _prevUField = 0;
+  _prevVField = 0;
+  
+  if (success)
+  {
+    _prevUField = u_field;
+    _prevVField = v_field;
+  }
+  else
+  {
+    delete u_field;
+    delete v_field;
+  }
+  
+  delete u_grad_field;
+  delete v_grad_field;
+  
+  if (!success)
     return false;
   
   if (_params->debug)
@@ -997,6 +1217,116 @@ void VariationalEchoTracker::_initializeWorkArrays(const Mdvx::field_header_t &u
 }
 
 
+/*********************************************************************
+ * _interpMotionField() - Fill in the destination motion field by
+ *                        bilinear interpolation from the source motion
+ *                        field.  The fields may be at different
+ *                        resolutions, but must be on the same
+ *                        projection.
+ */
+
+void VariationalEchoTracker::_interpMotionField(const MdvxField &src_field,
+						MdvxField &dest_field)
+{
+  Mdvx::field_header_t src_hdr = src_field.getFieldHeader();
+  Mdvx::field_header_t dest_hdr = dest_field.getFieldHeader();
+  
+  int src_nx = src_hdr.nx;
+  int src_ny = src_hdr.ny;
+  
+  const fl32 *src_data = (fl32 *)src_field.getVol();
+  fl32 *dest_data = (fl32 *)dest_field.getVol();
+  
+  for (int y = 0; y < dest_hdr.ny; ++y)
+  {
+    // Find the source grid position of this row, clamped to the
+    // source grid
+
+    double src_y = (dest_hdr.grid_miny + (y * dest_hdr.grid_dy) -
+		    src_hdr.grid_miny) / src_hdr.grid_dy;
+    src_y = max(0.0, min(src_y, (double)(src_ny - 1)));
+    
+    int y0 = min((int)src_y, max(src_ny - 2, 0));
+    int y1 = min(y0 + 1, src_ny - 1);
+    double wy = src_y - y0;
+    
+    for (int x = 0; x < dest_hdr.nx; ++x)
+    {
+      double src_x = (dest_hdr.grid_minx + (x * dest_hdr.grid_dx) -
+		      src_hdr.grid_minx) / src_hdr.grid_dx;
+      src_x = max(0.0, min(src_x, (double)(src_nx - 1)));
+      
+      int x0 = min((int)src_x, max(src_nx - 2, 0));
+      int x1 = min(x0 + 1, src_nx - 1);
+      double wx = src_x - x0;
+      
+      double value_y0 = (1.0 - wx) * src_data[(y0 * src_nx) + x0] +
+	wx * src_data[(y0 * src_nx) + x1];
+      double value_y1 = (1.0 - wx) * src_data[(y1 * src_nx) + x0] +
+	wx * src_data[(y1 * src_nx) + x1];
+      
+      dest_data[(y * dest_hdr.nx) + x] =
+	(1.0 - wy) * value_y0 + wy * value_y1;
+      
+    } /* endfor - x */
+  } /* endfor - y */
+}
+
+
+/*********************************************************************
+ * _minimizeLevel() - Minimize the cost function on one grid level,
+ *                    starting from the motion already in the U and V
+ *                    fields.
+ */
+
+void VariationalEchoTracker::_minimizeLevel(const MdvxField &prev_base_field,
+					    const MdvxField &curr_base_field,
+					    MdvxField &u_field,
+					    MdvxField &v_field,
+					    MdvxField &u_grad_field,
+					    MdvxField &v_grad_field)
+{
+  // Initialize work arrays before the iterations begin
+
+  _initializeWorkArrays(u_field.getFieldHeader(), v_field.getFieldHeader(),
+			MdvxPjg(prev_base_field.getFieldHeader()));
+  
+  // Minimize the cost function and gradients
+
+  double cost_function;
+    
+  for (int iteration_num = 0; iteration_num < _params->max_iterations;
+       ++iteration_num)
+  {
+    if (_params->debug)
+      cerr << "----- ITERATION " << iteration_num << " -----" << endl;
+    
+    // Calculate the current iteration cost function and gradients
+
+    _calcCostFuncGradient(iteration_num, prev_base_field, curr_base_field,
+			  u_field, v_field,
+			  cost_function, u_grad_field, v_grad_field,
+			  _conservationMatrix);
+    
+    // Minimize the functions
+
+    int ret = _performMinimization(u_field, v_field,
+				   u_grad_field, v_grad_field,
+				   cost_function);
+    
+    if (_params->debug)
+      cerr << "minimization return = " << ret << endl;
+    
+    if (ret <= 0)
+      break;
+    
+    if (_params->debug)
+      cerr << " FINISHED ITERATION " << iteration_num << endl;
+    
+  } /* endfor - iteration_num */
+}
+
+
 /*********************************************************************
  * _performMinimization() - Perform the minimization
  *
@@ -1149,6 +1479,11 @@ bool VariationalEchoTracker::_processData(const DateTime &trigger_time)
     cerr << "Projections for previous and current base fields don't match" << endl;
     cerr << "Skipping this time period..." << endl;
     
+    delete _prevUField;
+    delete _prevVField;
+    _prevUField = 0;
+    _prevVField = 0;
+    
     delete _prevBaseField;
     _prevBaseField = curr_base_field;
     
@@ -1381,3 +1716,16 @@ bool VariationalEchoTracker::_writeVectors(const MdvxField &u_field,
   
   return true;
 }
+
+
+/*********************************************************************
+ * TileThreads::clone() - Clone a thread for the que.
+ */
+
+TaThread *VariationalEchoTracker::TileThreads::clone(int index)
+{
+  TaThreadSimple *t = new TaThreadSimple(index);
+  t->setThreadMethod(VariationalEchoTracker::_computeTiles);
+  t->setThreadContext(this);
+  return (TaThread *) t;
+}
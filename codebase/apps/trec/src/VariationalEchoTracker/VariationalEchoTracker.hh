@@ -56,6 +56,7 @@
 #include <dsdata/DsTrigger.hh>
 #include <Mdv/MdvxField.hh>
 #include <toolsa/DateTime.hh>
+#include <toolsa/TaThreadDoubleQue.hh>
 
 #include "Args.hh"
 #include "Params.hh"
@@ -133,6 +134,68 @@ class VariationalEchoTracker
   static const int IPRINT[2];
   static const float EPSILON;
   
+  // Number of grid rows in each tile when computing the cost function
+  // and gradients, and the smallest grid dimension allowed for a
+  // multigrid level.
+
+  static const int TILE_ROWS;
+  static const int MIN_LEVEL_DIM;
+  
+
+  ///////////////////
+  // Private types //
+  ///////////////////
+
+  // The data needed to compute the cost function and gradients on one
+  // grid level.  The U grid is one larger than the base grid in X, and
+  // the V grid is one larger in Y.
+
+  typedef struct
+  {
+    int nx;
+    int ny;
+    const fl32 *prev_data;
+    const fl32 *curr_data;
+    fl32 prev_missing;
+    fl32 prev_bad;
+    fl32 curr_missing;
+    fl32 curr_bad;
+    const fl32 *u_data;
+    const fl32 *v_data;
+    fl32 *u_grad_data;
+    fl32 *v_grad_data;
+    const double *conservation_matrix;
+    double dt;
+    double dx;
+    double dy;
+    int n_tiles;
+    double *tile_costs;   // 3 values per tile: ffz, ffsmsu, ffsmsv
+  } cost_grid_t;
+
+  // Information passed to each tile thread
+
+  class TileInfo
+  {
+  public:
+    TileInfo(const VariationalEchoTracker *obj, const cost_grid_t *grid,
+	     const int thread_num, const int n_threads) :
+      _obj(obj), _grid(grid), _threadNum(thread_num), _nThreads(n_threads) {}
+    const VariationalEchoTracker *_obj;
+    const cost_grid_t *_grid;
+    int _threadNum;
+    int _nThreads;
+  };
+  
+  // Thread que for the cost function and gradient tiles
+
+  class TileThreads : public TaThreadDoubleQue
+  {
+  public:
+    inline TileThreads() : TaThreadDoubleQue() {}
+    inline virtual ~TileThreads() {}
+    TaThread *clone(int index);
+  };
+  
 
   /////////////////////
   // Private members //
@@ -155,6 +218,16 @@ class VariationalEchoTracker
   MdvxField *_prevBaseField;
   Mdvx::master_header_t _currMasterHdr;
   
+  // Motion fields from the previous volume, used as the first guess
+  // when use_previous_motion is set.  These are on the offset U/V grids.
+
+  MdvxField *_prevUField;
+  MdvxField *_prevVField;
+  
+  // Threads for computing the cost function and gradients
+
+  TileThreads _tileThreads;
+  
   // Pointers to diagnostic arrays
 
   double *_gnu;
@@ -200,31 +273,51 @@ class VariationalEchoTracker
 			     double &cost_function,
 			     MdvxField &u_grad_field,
 			     MdvxField &v_grad_field,
-			     double *conservation_matrix) const;
+			     double *conservation_matrix);
   
 
   /*********************************************************************
-   * _calcCostFunction() - Calculate the current iteration cost function.
+   * _calcTileCostGradient() - Calculate the cost function terms and the
+   *                           gradients for the rows in the given tile.
+   *                           The cost function terms are saved in the
+   *                           tile_costs array for the tile.
    */
   
-  void _calcCostFunction(const MdvxField &prev_base_field,
-			 const MdvxField &curr_base_field,
-			 MdvxField &u_field,
-			 MdvxField &v_field,
-			 double &cost_function,
-			 double *conservation_matrix) const;
+  void _calcTileCostGradient(const cost_grid_t &grid,
+			     const int tile_num) const;
   
 
   /*********************************************************************
-   * _calcGradients() - Calculate the current iteration gradients.
+   * _coarsenBaseField() - Create a base field at half the resolution of
+   *                       the given field by averaging the valid data in
+   *                       each 2x2 block of grid squares.
+   *
+   * Returns a pointer to the new field, which must be deleted by the
+   * caller.
    */
+
+  static MdvxField *_coarsenBaseField(const MdvxField &base_field);
   
-  void _calcGradients(const MdvxField &prev_base_field,
-		      MdvxField &u_field,
-		      MdvxField &v_field,
-		      MdvxField &u_grad_field,
-		      MdvxField &v_grad_field,
-		      double *conservation_matrix) const;
+
+  /*********************************************************************
+   * _computeTiles() - Thread method.  Calculates the cost function and
+   *                   gradients for the tiles assigned to this thread.
+   */
+
+  static void _computeTiles(void *ti);
+  
+
+  /*********************************************************************
+   * _createMotionField() - Create an offset U or V field, with all values
+   *                        set to 0, for the given base field.
+   *
+   * Returns a pointer to the new field, which must be deleted by the
+   * caller.
+   */
+
+  static MdvxField *_createMotionField(const MdvxField &base_field,
+				       const bool u_field,
+				       const bool grad_field);
   
 
   /*********************************************************************
@@ -248,6 +341,18 @@ class VariationalEchoTracker
 			MdvxField &v_field) const;
   
 
+  /*********************************************************************
+   * _interpMotionField() - Fill in the destination motion field by
+   *                        bilinear interpolation from the source motion
+   *                        field.  The fields may be at different
+   *                        resolutions, but must be on the same
+   *                        projection.
+   */
+
+  static void _interpMotionField(const MdvxField &src_field,
+				 MdvxField &dest_field);
+  
+
   /*********************************************************************
    * _initializeWorkArrays() - Initialize the arrays used in the minimization
    * process.
@@ -258,6 +363,20 @@ class VariationalEchoTracker
 			     const MdvxPjg &base_projection);
   
 
+  /*********************************************************************
+   * _minimizeLevel() - Minimize the cost function on one grid level,
+   *                    starting from the motion already in the U and V
+   *                    fields.
+   */
+
+  void _minimizeLevel(const MdvxField &prev_base_field,
+		      const MdvxField &curr_base_field,
+		      MdvxField &u_field,
+		      MdvxField &v_field,
+		      MdvxField &u_grad_field,
+		      MdvxField &v_grad_field);
+  
+
   /*********************************************************************
    * _performMinimization() - Perform the minimization
    *
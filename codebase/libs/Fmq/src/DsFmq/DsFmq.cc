@@ -577,30 +577,10 @@ int DsFmq::readMsg(bool *gotOne, int type /* = -1*/, int msecs_sleep /* = -1*/)
     
     // out of data, do a new read
     
-    _socketMsg.assembleRequestRead(type, msecs_sleep);
-    _printDebugLabel("readMsg");
-    if (_contactServer(_socketMsg.assembledMsg(),
-		       _socketMsg.lengthAssembled())) {
+    if (_readFromServer(type, msecs_sleep)) {
       return -1;
     }
 
-    // check for error
-    if (_checkError()) {
-      return -1;
-    }
-    
-    // add data to queue, checking message type as applicable
-    
-    for (int ii = 0; ii < (int) _socketMsg.getMsgInfo().size(); ii++) {
-      if (type < 0 || type == _socketMsg.getMsgInfo()[ii].msgType) {
-	readData *rdata = new readData();
-	rdata->info = _socketMsg.getMsgInfo()[ii];
-	rdata->buf.add(_socketMsg.getMsgData()[ii],
-		       rdata->info.msgLen);
-	_readQueue.push_back(rdata);
-      }
-    }
-
   } // if (_readQueue.size() == 0)
   
   // check if we have any data
@@ -754,6 +734,129 @@ int DsFmq::writeMsg(int type, int subType, const void *msg, int msgLen)
   return 0;
 }
 
+//////////////////////////////////////////////////////
+// Writes a batch of messages to the fmq
+// Returns 0 on success, -1 on error
+  
+int DsFmq::writeMsgs(const vector<MsgEntry> &msgs)
+{ 
+
+  if (!_isServed) {
+    // local
+    return Fmq::writeMsgs(msgs);
+  }
+
+  if (msgs.size() == 0) {
+    return 0;
+  }
+
+  // assemble the write message for the whole batch
+
+  _socketMsg.clearAll();
+  for (size_t ii = 0; ii < msgs.size(); ii++) {
+    _socketMsg.addWriteData(msgs[ii], _compress, _compressMethod);
+  }
+  _socketMsg.assembleRequestWrite();
+
+  _printDebugLabel("writeMsgs");
+  if (_contactServer(_socketMsg.assembledMsg(),
+		     _socketMsg.lengthAssembled())) {
+    return  -1;
+  }
+  
+  // check for error
+  if (_checkError()) {
+    return -1;
+  }
+
+  return 0;
+}
+
+//////////////////////////////////////////////////////
+// Reads the available messages, up to maxMsgs messages
+// or maxBytes total length. Does not wait.
+// Returns 0 on success, -1 on error
+
+int DsFmq::readMsgs(vector<MsgEntry> &msgs,
+                    int maxMsgs,
+                    int maxBytes /* = -1 */,
+                    int type /* = -1 */)
+
+{
+
+  if (!_isServed) {
+    // local
+    return Fmq::readMsgs(msgs, maxMsgs, maxBytes, type);
+  }
+
+  msgs.clear();
+  _batchBuf.free();
+
+  // if the local read queue is empty, request the next
+  // batch from the server
+
+  if (_readQueue.size() == 0) {
+    if (_readFromServer(type, -1)) {
+      return -1;
+    }
+  }
+
+  // step through the queued messages, decompressing as required
+
+  vector<size_t> offsets;
+  int nBytes = 0;
+
+  while (_readQueue.size() > 0 && (int) msgs.size() < maxMsgs) {
+
+    readData *rdata = _readQueue.front();
+    _readQueue.pop_front();
+    
+    if (type >= 0 && rdata->info.msgType != type) {
+      delete rdata;
+      continue;
+    }
+
+    if (_load_read_msg(rdata->info.msgType,
+                       rdata->info.msgSubtype,
+                       rdata->info.msgId,
+                       rdata->info.msgTime,
+                       rdata->buf.getPtr(),
+                       rdata->info.msgLen,
+                       rdata->info.msgPreCompressed,
+                       rdata->info.msgUncompressedLen)) {
+      // decompression error
+      delete rdata;
+      return -1;
+    }
+    delete rdata;
+
+    MsgEntry entry;
+    entry.type = _slot.type;
+    entry.subType = _slot.subtype;
+    entry.id = _slot.id;
+    entry.time = _slot.time;
+    entry.msgLen = _msgBuf.getLen();
+    entry.uncompressedLen = _msgBuf.getLen();
+    offsets.push_back(_batchBuf.getLen());
+    _batchBuf.add(_msgBuf.getPtr(), _msgBuf.getLen());
+    msgs.push_back(entry);
+
+    nBytes += entry.msgLen;
+    if (maxBytes > 0 && nBytes >= maxBytes) {
+      break;
+    }
+
+  } // while
+
+  const char *bptr = (const char *) _batchBuf.getPtr();
+  for (size_t ii = 0; ii < msgs.size(); ii++) {
+    msgs[ii].msg = bptr + offsets[ii];
+  }
+
+  return 0;
+
+}
+
 ///////////////////////////////////////////////////////
 // clear write cache - before adding for later write
 
@@ -784,7 +887,7 @@ void DsFmq::addToWriteCache(int type, int subType,
 //////////////////////////////////////////////////////
 // Writes all data in the cache to the fmq.
 // For remote writes, this is performed in a single action.
-// For local writes, these are written one at a time.
+// For local writes, the cache is written as a single batch.
 // Returns 0 on success, -1 on error
   
 int DsFmq::writeTheCache()
@@ -792,21 +895,18 @@ int DsFmq::writeTheCache()
   
   if (!_isServed) {
     // local
-    int iret = 0;
-    while (_writeQueue.size() > 0) {
-      if (_debug) {
-        cerr << "writing cache, size: " << _writeQueue.size() << endl;
-      }
-      writeData *wdata = _writeQueue.front();
-      if (Fmq::writeMsg(wdata->type,
-			wdata->subType,
-			wdata->buf.getPtr(),
-			wdata->buf.getLen())) {
-	iret = -1;
-      }
-      delete wdata;
-      _writeQueue.pop_front();
+    if (_debug) {
+      cerr << "writing cache, size: " << _writeQueue.size() << endl;
     }
+    vector<MsgEntry> msgs;
+    for (size_t ii = 0; ii < _writeQueue.size(); ii++) {
+      const writeData *wdata = _writeQueue[ii];
+      msgs.push_back(MsgEntry(wdata->type, wdata->subType,
+                              wdata->buf.getPtr(),
+                              wdata->buf.getLen()));
+    }
+    int iret = Fmq::writeMsgs(msgs);
+    _clearWriteQueue();
     return iret;
   }
 
@@ -842,6 +942,43 @@ int DsFmq::writeTheCache()
 }
 
 
+/////////////////////////////////////////////////////////////
+// Request a read from the server, and add the messages
+// returned to the read queue, checking message type as applicable.
+// Returns 0 on success, -1 on error
+
+int DsFmq::_readFromServer(int type, int msecs_sleep)
+
+{
+
+  _socketMsg.assembleRequestRead(type, msecs_sleep);
+  _printDebugLabel("readMsg");
+  if (_contactServer(_socketMsg.assembledMsg(),
+                     _socketMsg.lengthAssembled())) {
+    return -1;
+  }
+  
+  // check for error
+  if (_checkError()) {
+    return -1;
+  }
+  
+  // add data to queue, checking message type as applicable
+  
+  for (int ii = 0; ii < (int) _socketMsg.getMsgInfo().size(); ii++) {
+    if (type < 0 || type == _socketMsg.getMsgInfo()[ii].msgType) {
+      readData *rdata = new readData();
+      rdata->info = _socketMsg.getMsgInfo()[ii];
+      rdata->buf.add(_socketMsg.getMsgData()[ii],
+                     rdata->info.msgLen);
+      _readQueue.push_back(rdata);
+    }
+  }
+
+  return 0;
+
+}
+
 /////////////////////////////////////////////////////////////
 // resolve the URL
 // set _isServer flag if we need to communicate via server
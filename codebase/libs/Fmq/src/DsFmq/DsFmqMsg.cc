@@ -47,6 +47,35 @@ using namespace std;
 DsFmqMsg::DsFmqMsg() : DsServerMsg()
 {
   _initInfoSet = false;
+  _compressCtx = NULL;
+}
+
+///////////////////////////////////////////////
+// copy constructor
+   
+DsFmqMsg::DsFmqMsg(const DsFmqMsg &rhs) :
+        DsServerMsg(rhs),
+        _initInfoSet(rhs._initInfoSet),
+        _initInfo(rhs._initInfo),
+        _msgData(rhs._msgData),
+        _msgInfo(rhs._msgInfo),
+        _compressCtx(NULL)
+{
+}
+
+///////////////////////////////////////////////
+// assignment
+   
+DsFmqMsg &DsFmqMsg::operator=(const DsFmqMsg &rhs)
+{
+  if (this != &rhs) {
+    DsServerMsg::operator=(rhs);
+    _initInfoSet = rhs._initInfoSet;
+    _initInfo = rhs._initInfo;
+    _msgData = rhs._msgData;
+    _msgInfo = rhs._msgInfo;
+  }
+  return *this;
 }
 
 ///////////////////////////////////////////////
@@ -54,7 +83,9 @@ DsFmqMsg::DsFmqMsg() : DsServerMsg()
    
 DsFmqMsg::~DsFmqMsg()
 {
-
+  if (_compressCtx) {
+    ta_compress_ctx_free(_compressCtx);
+  }
 }
 
 ///////////////////////////////////////////////////////////////
@@ -284,6 +315,39 @@ void DsFmqMsg::addReadData(const Fmq &fmq)
 
 }
 
+///////////////////////////////////////////////
+// Add read data for a message entry returned by
+// Fmq::readMsgs(), in preparation for calling
+// assembleReadReply().
+
+void DsFmqMsg::addReadData(const Fmq::MsgEntry &entry)
+
+{
+
+  msgInfo_t info;
+  MEM_zero(info);
+  
+  info.msgType = entry.type;
+  info.msgSubtype = entry.subType;
+  info.msgId = entry.id;
+  info.msgTime = entry.time;
+  info.msgLen = entry.msgLen;
+  info.msgPreCompressed = entry.preCompressed;
+  info.msgUncompressedLen = entry.uncompressedLen;
+  
+  if (_debug) {
+    cerr << "==>> DsFmqMsg::addReadData" << endl;
+    printMsgInfo(cerr, "  ", info);
+  }
+
+  // add it to the message
+  
+  BEfromInfo(&info);
+  addPart(DS_FMQ_INFO_PART, sizeof(msgInfo_t), &info);
+  addPart(DS_FMQ_DATA_PART, entry.msgLen, entry.msg);
+
+}
+
 ///////////////////////////////////////////////
 // Assemble reply after successful read.
 // Assumes clearAll() was called, and data was
@@ -349,11 +413,19 @@ void DsFmqMsg::addWriteData(int msgType, int msgSubtype,
     const void *cmsg = msg;
 
     if (compress) {
-      if ((cmsg = ta_compress(cmethod, msg, msgLen, &clen)) == NULL) {
+      // compress into buffer owned by this object, reusing the context
+      if (_compressCtx == NULL) {
+        _compressCtx = ta_compress_ctx_create();
+      }
+      ui64 blen = ta_compress_bound(cmethod, msgLen);
+      void *cbuf = _compressBuf.reserve(blen);
+      if (ta_compress_buf(_compressCtx, cmethod,
+                          msg, msgLen, cbuf, blen, &clen)) {
 	cerr << "WARNING - DsFmqMsg::addWriteData" << endl;
 	cerr << "  Compression failed - cannot compress message" << endl;
-	compress = false;
+        clen = msgLen;
       } else {
+        cmsg = cbuf;
 	info.msgPreCompressed = true;
 	info.msgLen = clen;
 	info.msgUncompressedLen = msgLen;
@@ -363,14 +435,46 @@ void DsFmqMsg::addWriteData(int msgType, int msgSubtype,
     addPart(DS_FMQ_INFO_PART, sizeof(msgInfo_t), &info);
     addPart(DS_FMQ_DATA_PART, clen, cmsg);
 
-    if (compress) {
-      ta_compress_free((void *) cmsg);
-    }
-
   } // if (msg == NULL)
   
 }
 
+///////////////////////////////////////////////////////
+// Add write data for a message entry.
+// If the entry is pre-compressed it is passed on as it is.
+
+void DsFmqMsg::addWriteData(const Fmq::MsgEntry &entry,
+			    bool compress,
+			    ta_compression_method_t cmethod)
+
+{
+
+  if (!entry.preCompressed || entry.msg == NULL) {
+    addWriteData(entry.type, entry.subType,
+		 entry.msg, entry.msgLen,
+		 compress, cmethod);
+    return;
+  }
+
+  msgInfo_t info;
+  MEM_zero(info);
+  info.msgType = entry.type;
+  info.msgSubtype = entry.subType;
+  info.msgLen = entry.msgLen;
+  info.msgPreCompressed = true;
+  info.msgUncompressedLen = entry.uncompressedLen;
+  
+  if (_debug) {
+    cerr << "==>> DsFmqMsg::addWriteData" << endl;
+    printMsgInfo(cerr, "  ", info);
+  }
+
+  BEfromInfo(&info);
+  addPart(DS_FMQ_INFO_PART, sizeof(msgInfo_t), &info);
+  addPart(DS_FMQ_DATA_PART, entry.msgLen, entry.msg);
+  
+}
+
 ///////////////////////////////////////////////
 // assemble request write message
 // Assumes clearAll() was called, and data was
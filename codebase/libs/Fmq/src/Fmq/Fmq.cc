@@ -42,6 +42,7 @@
 #include <dsserver/DmapAccess.hh>
 #include <Fmq/Fmq.hh>
 #include <climits>
+#include <sched.h>
 
 using namespace std;
 
@@ -67,6 +68,7 @@ Fmq::Fmq()
   _createdOnOpen = false;
   _server = false;
   _compressMethod = TA_COMPRESSION_GZIP;
+  _compressCtx = NULL;
 
   MEM_zero(_stat);
   MEM_zero(_slot);
@@ -103,6 +105,10 @@ Fmq::~Fmq()
   _free_slots();
   _free_entry();
 
+  if (_compressCtx) {
+    ta_compress_ctx_free(_compressCtx);
+  }
+
 }
 
 /////////////////////////////////////////////////////////////
@@ -621,6 +627,113 @@ int Fmq::writeMsg(int type, int subType,
 
 }
 
+//////////////////////////////////////////////////////
+// Writes a batch of messages to the fmq, under a single
+// lock and with a single status update.
+// Returns 0 on success, -1 on error
+  
+int Fmq::writeMsgs(const vector<MsgEntry> &msgs)
+{
+
+  initErrStr();
+
+  if (!_dev) {
+    cerr << "ERROR - Fmq::writeMsgs" << endl;
+    cerr << "  Fmq path: " << _fmqPath << endl;
+    cerr << "  Queue not open, must call init functions" << endl;
+    return -1;
+  }
+
+  if (msgs.size() == 0) {
+    return 0;
+  }
+
+  int iret = _write_batch(msgs);
+  if (iret == 0) {
+    _doRegisterWithDmap();
+  }
+  return iret;
+
+}
+
+//////////////////////////////////////////////////////
+// Reads the available messages, up to maxMsgs messages
+// or maxBytes total length, with a single status read.
+// Returns 0 on success, -1 on error
+
+int Fmq::readMsgs(vector<MsgEntry> &msgs,
+                  int maxMsgs,
+                  int maxBytes /* = -1 */,
+                  int type /* = -1 */)
+
+{
+
+  initErrStr();
+  msgs.clear();
+  _batchBuf.free();
+
+  if (!_dev) {
+    cerr << "ERROR - Fmq::readMsgs" << endl;
+    cerr << "  Fmq path: " << _fmqPath << endl;
+    cerr << "  Queue not open, must call init functions" << endl;
+    return -1;
+  }
+
+  if (_read_stat()) {
+    return -1;
+  }
+
+  // offsets of messages in the batch buffer - the buffer
+  // may move as it grows, so set the pointers at the end
+
+  vector<size_t> offsets;
+  int nBytes = 0;
+  
+  while ((int) msgs.size() < maxMsgs) {
+
+    int msgRead;
+    if (_read_next(&msgRead, false)) {
+      if (msgs.size() == 0) {
+        return -1;
+      }
+      // return what we have so far
+      break;
+    }
+    if (!msgRead) {
+      break;
+    }
+    if (type >= 0 && _slot.type != type) {
+      continue;
+    }
+
+    MsgEntry entry;
+    entry.type = _slot.type;
+    entry.subType = _slot.subtype;
+    entry.id = _slot.id;
+    entry.time = _slot.time;
+    entry.msgLen = _msgBuf.getLen();
+    entry.preCompressed = (_server && _slot.compress);
+    entry.uncompressedLen = _slot.msg_len;
+    offsets.push_back(_batchBuf.getLen());
+    _batchBuf.add(_msgBuf.getPtr(), _msgBuf.getLen());
+    msgs.push_back(entry);
+
+    nBytes += entry.msgLen;
+    if (maxBytes > 0 && nBytes >= maxBytes) {
+      break;
+    }
+
+  } // while
+
+  const char *bptr = (const char *) _batchBuf.getPtr();
+  for (size_t ii = 0; ii < msgs.size(); ii++) {
+    msgs[ii].msg = bptr + offsets[ii];
+  }
+
+  return 0;
+
+}
+
 /////////////////////////////////////////////////////////
 // Writing precompressed msg
 // Returns 0 on success, -1 on error
@@ -988,13 +1101,18 @@ int Fmq::_free_oldest_slot()
     _next_slot(_stat.oldest_slot);
 
   // Zero out the slot and save it to file.
+  // The update is closed before the buffer space is overwritten,
+  // so readers which copied the message before the slot was
+  // zeroed see the sequence number change and discard it.
   
+  _begin_update_device(oldest_slot);
   MEM_zero(*oldest_ptr);
   if (_write_slot(oldest_slot)) {
     _print_error("free_oldest_slot",
 		 "Cannot write slot %d\n", oldest_slot);
     return -1;
   }
+  _end_update_device(oldest_slot);
 
   return 0;
 
@@ -1118,6 +1236,7 @@ int Fmq::_open_create(int nslots, int buf_size)
   _lock_device();
   _prepare_for_writing(nslots, buf_size);
   _unlock_device();
+  _notify_device();
 
   _createdOnOpen = true;
 
@@ -1189,9 +1308,9 @@ int Fmq::_open_rdonly ()
     _print_error("_open_rdonly",
 		 "FMQ does not yet exist: %s\n", _fmqPath.c_str());
     if (_msecSleep <= 1000) {
-      umsleep(1000);
+      _wait_device(1000);
     } else {
-      umsleep(_msecSleep);
+      _wait_device(_msecSleep);
     }
     return -1;
   }
@@ -1289,9 +1408,9 @@ int Fmq::_open_blocking(int msecs_sleep)
       // no FMQ yet - sleep as requested
       
       if (msecs_sleep < 0) {
-	umsleep(1000);
+	_wait_device(1000);
       } else if (msecs_sleep > 0) {
-	umsleep(msecs_sleep);
+	_wait_device(msecs_sleep);
       }
 
     } else {
@@ -1336,9 +1455,9 @@ int Fmq::_open_blocking_rdwr(int msecs_sleep)
       // no FMQ yet - sleep 1 sec
 
       if (msecs_sleep < 0) {
-	umsleep(1000);
+	_wait_device(1000);
       } else if (msecs_sleep > 0) {
-	umsleep(msecs_sleep);
+	_wait_device(msecs_sleep);
       }
 
     } else {
@@ -1402,6 +1521,7 @@ int Fmq::_clear()
     return -1;
   }
   _unlock_device();
+  _notify_device();
 
   return 0;
 
@@ -1505,7 +1625,12 @@ int Fmq::_seek_start ()
 
 {
 
-  _lastSlotRead = _prev_slot(_stat.oldest_slot);
+  if (_stat.oldest_slot < 0) {
+    // empty queue
+    _lastSlotRead = -1;
+  } else {
+    _lastSlotRead = _prev_slot(_stat.oldest_slot);
+  }
   _lastIdRead = -1;
 
   return 0;
@@ -1611,7 +1736,7 @@ int Fmq::_read_blocking (int msecs_sleep, int type)
 {
 
   int msg_read;
-  int sleepTotalMsecs = 0;
+  double sleepTotalMsecs = 0.0;
   if (msecs_sleep < 0) {
     msecs_sleep = 10;
   }
@@ -1637,8 +1762,14 @@ int Fmq::_read_blocking (int msecs_sleep, int type)
 
     } else {
 
-      umsleep(msecs_sleep);
-      sleepTotalMsecs += msecs_sleep;
+      // wait for a write, or the sleep interval
+
+      struct timeval tv0, tv1;
+      gettimeofday(&tv0, NULL);
+      _wait_device(msecs_sleep);
+      gettimeofday(&tv1, NULL);
+      sleepTotalMsecs += (tv1.tv_sec - tv0.tv_sec) * 1.0e3 +
+        (tv1.tv_usec - tv0.tv_usec) / 1.0e3;
 
       if (_msecBlockingReadTimeout > 0 && 
           sleepTotalMsecs > _msecBlockingReadTimeout) {
@@ -1729,7 +1860,17 @@ int Fmq::_read_non_blocking (int *msg_read, int type, int msecs_sleep)
 
     } else {
       
-      umsleep(10);
+      // wait for a write, up to the end time
+
+      gettimeofday(&tv, NULL);
+      double now = tv.tv_sec + (double) tv.tv_usec / 1.0e6;
+      int msecsWait = (int) ((endTime - now) * 1.0e3 + 0.5);
+      if (msecsWait < 1) {
+        msecsWait = 1;
+      } else if (msecsWait > 1000) {
+        msecsWait = 1000;
+      }
+      _wait_device(msecsWait);
       
       if (_heartbeatFunc != NULL) {
         _heartbeatFunc("In FMQ::_read_blocking()");
@@ -1766,6 +1907,16 @@ int Fmq::_read_stat ()
 
   for (ii = 0; ii < 5; ii++) {
 
+    // get the update sequence number - odd if the writer
+    // is part way through an update, in which case give it
+    // a chance to complete
+
+    unsigned int seq = _get_update_seq_device(FmqDevice::STAT_SEQ);
+    if (seq & 1) {
+      sched_yield();
+      seq = _get_update_seq_device(FmqDevice::STAT_SEQ);
+    }
+
     // seek to start of status file
     
     if (_seek_device(FmqDevice::STAT_IDENT, 0)) {
@@ -1790,6 +1941,14 @@ int Fmq::_read_stat ()
 
     _stat = status;
     
+    // check the struct was not updated while it was read.
+    // On the last try fall back on the checksum alone.
+
+    if (_get_update_seq_device(FmqDevice::STAT_SEQ) != seq && ii < 4) {
+      sched_yield();
+      continue;
+    }
+
     // checksum check
     
     if (_check_stat_checksum(&status) == 0) {
@@ -1947,7 +2106,7 @@ int Fmq::_read_slot ( int slot_num)
 //  Returns 0 on success, -1 on failure.
 ///
 
-int Fmq::_read_next(int *msg_read)
+int Fmq::_read_next(int *msg_read, bool read_stat /* = true */)
      
 {
   static int num_calls = 0;
@@ -1958,7 +2117,7 @@ int Fmq::_read_next(int *msg_read)
   
   *msg_read = false;
 
-  if (_read_stat()) {
+  if (read_stat && _read_stat()) {
     return -1;
   }
 
@@ -1985,10 +2144,20 @@ int Fmq::_read_next(int *msg_read)
 
     // no valid message for the next logical slot, so the buffer has
     // probably overflowed. The best option is to move ahead to
-    // the youngest slot and start reading from there
-
-    if (_read_msg_for_slot(_stat.youngest_slot)) {
-      return -1;
+    // the youngest slot and start reading from there.
+    // If the writer is far ahead it may overwrite the youngest
+    // slot as well, so re-read the status and try again.
+
+    int ntries = 0;
+    while (true) {
+      _lastIdRead = -1;
+      if (_read_msg_for_slot(_stat.youngest_slot) == 0) {
+        break;
+      }
+      ntries++;
+      if (ntries == 5 || _read_stat()) {
+        return -1;
+      }
     }
 
     slot_read = _stat.youngest_slot;
@@ -2050,6 +2219,16 @@ int Fmq::_read_msg_for_slot( int slot_num)
   int prev_id;
   q_slot_t *slot;
 
+  // get the update sequence number for the slot, and check it
+  // has not changed once the message is copied.
+  // It may be odd - the writer only changes a slot's buffer space
+  // after the slot has been freed and its update closed, so the
+  // slot struct decides whether there is a message. This also
+  // copes with a number left odd by a writer which died, or by
+  // a writer which does not use the sequence table.
+
+  unsigned int seq = _get_update_seq_device(slot_num);
+  
   if (_read_slot(slot_num)) {
     return -1;
   }
@@ -2062,8 +2241,9 @@ int Fmq::_read_msg_for_slot( int slot_num)
 
     // read in message
     
-    if (_read_msg(slot_num)) {
-      // failed
+    if (_read_msg(slot_num) ||
+        _get_update_seq_device(slot_num) != seq) {
+      // failed, or the slot was overwritten while being read
       _lastSlotRead = slot_num;
       _lastIdRead = slot->id;
       return -1;
@@ -2209,26 +2389,31 @@ int Fmq::_read_msg (int slot_num)
         return -1;
       }
     } else {
-      // uncompress the data
-      _msgBuf.free();
+      // uncompress the data directly into the message buffer,
+      // reusing the buffer memory and the compression context
       compressed_msg = (void *) (iptr + 2);
-      void *umsg = ta_decompress(compressed_msg, &nfull);
-      if (umsg == NULL || (int) nfull != slot->msg_len) {
+      int msg_len = slot->msg_len;
+      if (msg_len < 0 || msg_len > _bufSize) {
+        cerr << "ERROR - _read_msg" << endl;
+        cerr << "  fmq path: " << _fmqPath << endl;
+        cerr << "  bad message size on read: " << msg_len << endl;
+        return -1;
+      }
+      if (_compressCtx == NULL) {
+        _compressCtx = ta_compress_ctx_create();
+      }
+      void *umsg = _msgBuf.prepare(msg_len);
+      nfull = 0;
+      if (ta_decompress_buf(_compressCtx, compressed_msg,
+                            umsg, msg_len, &nfull) ||
+          (int) nfull != msg_len) {
 	_print_error("read_msg",
 		     "Error on decompression, expected %d bytes, "
 		     "got %d bytes",
-		     (int) slot->msg_len, (int) nfull);
-	if (umsg != NULL) {
-	  ta_compress_free(umsg);
-	}
+		     msg_len, (int) nfull);
+        _msgBuf.free();
 	return -1;
       }
-      int msg_len = slot->msg_len;
-      if (_add_read_msg(umsg, msg_len)) {
-        cerr << "ERROR - _read_msg" << endl;
-        return -1;
-      }
-      ta_compress_free(umsg);
     }
   } else {
     // data not compressed
@@ -2276,24 +2461,25 @@ int Fmq::_load_read_msg(int msg_type,
 
   if (compressed) {
 
-    void *dmsg = ta_decompress(msg, &nfull);
-    
-    if (dmsg == NULL || (int) nfull != uncompressed_len) {
+    if (_compressCtx == NULL) {
+      _compressCtx = ta_compress_ctx_create();
+    }
+    void *dmsg = _msgBuf.prepare(uncompressed_len < 0 ? 0 : uncompressed_len);
+    nfull = 0;
+    if (uncompressed_len < 0 ||
+        ta_decompress_buf(_compressCtx, msg, dmsg,
+                          uncompressed_len, &nfull) ||
+        (int) nfull != uncompressed_len) {
       _print_error("load_read_msg",
 		   "Error on decompression, expected %d bytes, "
 		   "got %d bytes",
 		   (int) uncompressed_len, (int) nfull);
-      if (dmsg != NULL) {
-	ta_compress_free(dmsg);
-      }
+      _msgBuf.free();
       return -1;
     }
 
     _slot.msg_len = uncompressed_len;
     _slot.stored_len = stored_len;
-    _msgBuf.free();
-    _msgBuf.add(dmsg, uncompressed_len);
-    ta_compress_free(dmsg);
     
   } else {
 
@@ -2400,11 +2586,13 @@ int Fmq::_prepare_for_writing(int nslots, int buf_size)
   // write out slots and status
 
   for (islot = 0; islot < nslots; islot++) {
+    _begin_update_device(islot);
     if (_write_slot(islot)) {
       _print_error("init_files",
 		   "Cannot write slot struct %d", islot);
       return -1;
     }
+    _end_update_device(islot);
   } // islot
 
   if (_write_stat()) {
@@ -2443,6 +2631,60 @@ int Fmq::_write(void *msg, int msg_len,
   iret = _write_msg(msg, msg_len, msg_type, msg_subtype,
 		    false, msg_len);
   _unlock_device();
+  _notify_device();
+  
+  return (iret);
+  
+}
+
+////////////////////////////////////////////////////////////
+//  Fmq::_write_batch()
+//
+//  This function writes a batch of messages to an FMQ.
+//
+//  Provides file locking layer. The status struct is read
+//  once before the batch and written once after it.
+//  If a message fails, the status is still written for
+//  the messages already in the queue.
+//
+//  Return value:
+//    0 on success, -1 on error.
+///
+
+int Fmq::_write_batch(const vector<MsgEntry> &msgs)
+  
+{
+
+  if (_lock_device() != 0) {
+    _print_error("_write_batch", "Error locking for read/write");
+    return -1;
+  }
+
+  if (_read_stat()) {
+    _unlock_device();
+    return -1;
+  }
+  
+  int iret = 0;
+  for (size_t ii = 0; ii < msgs.size(); ii++) {
+    const MsgEntry &entry = msgs[ii];
+    if (_write_msg((void *) entry.msg, entry.msgLen,
+                   entry.type, entry.subType,
+                   entry.preCompressed,
+                   entry.preCompressed ?
+                   entry.uncompressedLen : entry.msgLen,
+                   true)) {
+      iret = -1;
+      break;
+    }
+  }
+
+  if (_write_stat()) {
+    iret = -1;
+  }
+
+  _unlock_device();
+  _notify_device();
   
   return (iret);
   
@@ -2476,6 +2718,7 @@ int Fmq::_write_precompressed(void *msg, int msg_len,
   iret = _write_msg(msg, msg_len, msg_type, msg_subtype,
 		    true, uncompressed_len);
   _unlock_device();
+  _notify_device();
   
   return (iret);
 
@@ -2512,10 +2755,12 @@ int Fmq::_write_stat()
   
   // write
   
+  _begin_update_device(FmqDevice::STAT_SEQ);
   if (_write_device(FmqDevice::STAT_IDENT, &stat, sizeof(q_stat_t))) {
     _print_error("_write_stat", "Cannot write stat info.");
     return -1;
   }
+  _end_update_device(FmqDevice::STAT_SEQ);
 
   return 0;
 
@@ -2599,13 +2844,17 @@ int Fmq::_write_slot ( int slot_num)
 //        are passed through so the reading routine can determine
 //        something about the message from the header.
 //
+//  In batch mode, the caller reads the status struct before the
+//  batch and writes it after, so it is not read or written here.
+//
 //  Return value:
 //    0 on success, -1 on error.
 ///
 
 int Fmq::_write_msg(void *msg, int msg_len, 
 		    int msg_type, int msg_subtype,
-		    int pre_compressed, int uncompressed_len)
+		    int pre_compressed, int uncompressed_len,
+		    bool batch /* = false */)
 
 {
 
@@ -2622,7 +2871,7 @@ int Fmq::_write_msg(void *msg, int msg_len,
   
   // read in status struct 
   
-  if (_read_stat()) {
+  if (!batch && _read_stat()) {
     return -1;
   }
 
@@ -2642,6 +2891,12 @@ int Fmq::_write_msg(void *msg, int msg_len,
 
     while (overwrite_id == _stat.last_id_read) {
 
+      // in batch mode, publish the messages written so far
+      // before releasing the lock
+
+      if (batch && _write_stat()) {
+        return -1;
+      }
       _unlock_device();
       if (_heartbeatFunc != NULL) {
 	_heartbeatFunc("_write - blocked ...");
@@ -2677,8 +2932,14 @@ int Fmq::_write_msg(void *msg, int msg_len,
   }
 
   if (do_compress) {
-    if ((cmsg = ta_compress(_compressMethod,
-			    msg, msg_len, &clen)) == NULL) {
+    // compress into buffer owned by this object, reusing the context
+    if (_compressCtx == NULL) {
+      _compressCtx = ta_compress_ctx_create();
+    }
+    ui64 blen = ta_compress_bound(_compressMethod, msg_len);
+    cmsg = _compressBuf.reserve(blen);
+    if (ta_compress_buf(_compressCtx, _compressMethod,
+                        msg, msg_len, cmsg, blen, &clen)) {
       _print_error("_write_msg",
 		   "Message compression failed.");
       return -1;
@@ -2701,9 +2962,6 @@ int Fmq::_write_msg(void *msg, int msg_len,
 		 "Message size %d bytes too large for FMQ\n"
 		 "Max msg len %d",
 		 clen, _stat.buf_size - Q_NBYTES_EXTRA);
-    if (do_compress) {
-      ta_compress_free(cmsg);
-    }
     return -1;
   }
 
@@ -2744,11 +3002,13 @@ int Fmq::_write_msg(void *msg, int msg_len,
           offset);
 #endif
   
+  // mark the slot as being updated, so that readers do not
+  // use it until the message and slot are complete
+
+  _begin_update_device(write_slot);
+
   iret = _write_msg_to_slot(write_slot, write_id, cmsg,
 			    clen, stored_len, offset);
-  if (do_compress) {
-    ta_compress_free(cmsg);
-  }
   if (iret) {
     return -1;
   }
@@ -2775,6 +3035,7 @@ int Fmq::_write_msg(void *msg, int msg_len,
     slot->active = false;
     return -1;
   }
+  _end_update_device(write_slot);
 
   _slot = _slots[write_slot];
 
@@ -2791,7 +3052,7 @@ int Fmq::_write_msg(void *msg, int msg_len,
   }
   _stat.youngest_id = write_id;
   
-  if (_write_stat()) {
+  if (!batch && _write_stat()) {
     return -1;
   }
 
@@ -2999,6 +3260,67 @@ int Fmq::_unlock_device()
 
 }
 
+////////////////////////////////////////////////////////////
+// wait for a write to the device, or for msecs
+// returns 0 if woken by a write, -1 on timeout
+
+int Fmq::_wait_device(int msecs)
+{
+
+  if (_dev == NULL) {
+    umsleep(msecs);
+    return -1;
+  }
+
+  return _dev->wait_for_write(msecs);
+
+}
+
+////////////////////////////////////////////////////////////
+// notify readers waiting on the device
+
+void Fmq::_notify_device()
+{
+
+  if (_dev != NULL) {
+    _dev->notify_write();
+  }
+
+}
+
+////////////////////////////////////////////////////////////
+// update sequence numbers at the device level
+// slot_num is FmqDevice::STAT_SEQ for the stat struct
+
+void Fmq::_begin_update_device(int slot_num)
+{
+
+  if (_dev != NULL) {
+    _dev->begin_update(slot_num);
+  }
+
+}
+
+void Fmq::_end_update_device(int slot_num)
+{
+
+  if (_dev != NULL) {
+    _dev->end_update(slot_num);
+  }
+
+}
+
+unsigned int Fmq::_get_update_seq_device(int slot_num)
+{
+
+  if (_dev == NULL) {
+    return 0;
+  }
+
+  return _dev->get_update_seq(slot_num);
+
+}
+
 // checking at the device level
 // returns 0 on success, -1 on failure
 
@@ -4018,10 +4340,12 @@ int Fmq::_recover ()
     if (!_slot_in_active_region(islot) && slot->active) {
       _print_error("_recover",
 		   "Setting slot %d inactive", islot);
+      _begin_update_device(islot);
       MEM_zero(*slot);
       if (_write_slot(islot)) {
 	return -1;
       }
+      _end_update_device(islot);
     }
   }
 
@@ -34,6 +34,8 @@
                                  
 #include <cassert>
 #include <cstdarg>
+#include <cstdlib>
+#include <strings.h>
 #include <dataport/bigend.h>
 #include <toolsa/MsgLog.hh>
 #include <toolsa/TaStr.hh>
@@ -53,8 +55,61 @@ FmqDevice::FmqDevice(const string &fmqPath,
   
 {
 
+  _useNotify = true;
+  char *useNotifyStr = getenv("FMQ_USE_NOTIFY");
+  if (useNotifyStr != NULL && !strcasecmp(useNotifyStr, "FALSE")) {
+    _useNotify = false;
+  }
+
 }
 
 FmqDevice::~FmqDevice()
 {
 }
+
+////////////////////////////////////////////////////////////
+// Wait for a write to the queue.
+//
+// The base class has no notification, so it sleeps.
+//
+// Returns 0 if woken by a write, -1 on timeout.
+
+int FmqDevice::wait_for_write(int msecs)
+
+{
+  if (msecs > 0) {
+    umsleep(msecs);
+  }
+  return -1;
+}
+
+////////////////////////////////////////////////////////////
+// Wake readers waiting on the queue.
+//
+// No-op in the base class.
+
+void FmqDevice::notify_write()
+
+{
+}
+
+////////////////////////////////////////////////////////////
+// Update sequence numbers.
+//
+// No-ops in the base class.
+
+void FmqDevice::begin_update(int slot_num)
+
+{
+}
+
+void FmqDevice::end_update(int slot_num)
+
+{
+}
+
+unsigned int FmqDevice::get_update_seq(int slot_num)
+
+{
+  return 0;
+}
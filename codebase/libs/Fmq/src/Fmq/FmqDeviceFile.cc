@@ -42,6 +42,11 @@
 #include <toolsa/uusleep.h>
 #include <Fmq/FmqDeviceFile.hh>
 #include <Fmq/Fmq.hh>
+#include <poll.h>
+#include <sys/time.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
 using namespace std;
 
 FmqDeviceFile::FmqDeviceFile(const string &fmqPath, 
@@ -67,11 +72,19 @@ FmqDeviceFile::FmqDeviceFile(const string &fmqPath,
   _stat_fd = 0;
   _buf_fd = 0;
 
+  // notification
+
+  _inotifyFd = -1;
+  _inotifyWd = -1;
+  Path statPath(_stat_path);
+  _statName = statPath.getFile();
+
 }
 
 FmqDeviceFile::~FmqDeviceFile()
 {
   FmqDeviceFile::do_close();
+  _closeNotify();
 }
 
 ////////////////////////////////////////////////////////////
@@ -516,3 +529,124 @@ int FmqDeviceFile::update_last_id_read(int lastIdRead)
 
 }
 
+////////////////////////////////////////////////////////////
+// Wait for a write to the queue.
+//
+// Watches the queue directory with inotify, rather than the
+// stat file itself, so that we can also wait for the queue
+// to be created.
+//
+// Returns 0 if woken by a write, -1 on timeout.
+
+int FmqDeviceFile::wait_for_write(int msecs)
+
+{
+
+#if defined(__linux__)
+
+  if (!_useNotify) {
+    return FmqDevice::wait_for_write(msecs);
+  }
+
+  if (_inotifyFd < 0) {
+    _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotifyFd < 0) {
+      return FmqDevice::wait_for_write(msecs);
+    }
+  }
+
+  if (_inotifyWd < 0) {
+    Path statPath(_stat_path);
+    string dir = statPath.getDirectory();
+    if (dir.size() == 0) {
+      dir = ".";
+    }
+    _inotifyWd = inotify_add_watch(_inotifyFd, dir.c_str(),
+                                   IN_MODIFY | IN_CLOSE_WRITE |
+                                   IN_CREATE | IN_MOVED_TO);
+    if (_inotifyWd < 0) {
+      // directory does not exist yet
+      return FmqDevice::wait_for_write(msecs);
+    }
+    // writes before now have not been tracked,
+    // so return for the caller to check the queue again
+    return 0;
+  }
+
+  struct timeval start;
+  gettimeofday(&start, NULL);
+  int msecsLeft = msecs;
+
+  while (msecsLeft >= 0) {
+
+    struct pollfd pfd;
+    pfd.fd = _inotifyFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int nReady = poll(&pfd, 1, msecsLeft);
+    if (nReady < 0 && errno != EINTR) {
+      return FmqDevice::wait_for_write(msecsLeft);
+    }
+
+    if (nReady > 0) {
+
+      // drain the events, checking for the stat file
+
+      bool statWritten = false;
+      char buf[4096]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+      ssize_t len;
+      while ((len = read(_inotifyFd, buf, sizeof(buf))) > 0) {
+        for (char *ptr = buf; ptr < buf + len; ) {
+          struct inotify_event *event = (struct inotify_event *) ptr;
+          if (event->mask & IN_IGNORED) {
+            // directory removed, watch again next time
+            _inotifyWd = -1;
+            statWritten = true;
+          } else if (event->len > 0 && _statName == event->name) {
+            statWritten = true;
+          }
+          ptr += sizeof(struct inotify_event) + event->len;
+        }
+      }
+      if (statWritten) {
+        return 0;
+      }
+
+    }
+
+    // some other file in the directory - wait for the remaining time
+    
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int msecsUsed = (now.tv_sec - start.tv_sec) * 1000 +
+      (now.tv_usec - start.tv_usec) / 1000;
+    if (msecsUsed >= msecs) {
+      break;
+    }
+    msecsLeft = msecs - msecsUsed;
+
+  } // while
+
+  return -1;
+
+#else
+
+  return FmqDevice::wait_for_write(msecs);
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////
+// Close the inotify instance
+
+void FmqDeviceFile::_closeNotify()
+
+{
+  if (_inotifyFd >= 0) {
+    close(_inotifyFd);
+    _inotifyFd = -1;
+    _inotifyWd = -1;
+  }
+}
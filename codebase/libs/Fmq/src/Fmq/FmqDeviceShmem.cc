@@ -45,7 +45,16 @@
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <sys/fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <semaphore.h>
+#include <unistd.h>
+#include <climits>
+#include <ctime>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 using namespace std;
 
 FmqDeviceShmem::FmqDeviceShmem(const string &fmqPath,
@@ -65,6 +74,14 @@ FmqDeviceShmem::FmqDeviceShmem(const string &fmqPath,
   _statPtr = NULL;
   _bufPtr = NULL;
 
+  _notify = NULL;
+  _notifyInit = false;
+  _lastNotifySeq = 0;
+
+  _seqTable = NULL;
+  _seqNslots = 0;
+  _seqTableSize = 0;
+
   _offset[STAT_IDENT] = 0;
   _offset[BUF_IDENT] = 0;
 
@@ -80,6 +97,8 @@ FmqDeviceShmem::FmqDeviceShmem(const string &fmqPath,
 FmqDeviceShmem::~FmqDeviceShmem()
 {
   FmqDeviceShmem::do_close();
+  _closeNotify();
+  _closeSeqTable();
 }
 
 ////////////////////////////////////////
@@ -142,6 +161,12 @@ int FmqDeviceShmem::do_open(const char *mode)
 
   FmqDeviceShmem::do_close();
 
+  // the segments may have been re-created since the shared files
+  // were mapped, so map them again when next needed
+
+  _closeNotify();
+  _closeSeqTable();
+
   // create mode
 
   if (!strcmp(mode, "w+")) {
@@ -211,6 +236,12 @@ int FmqDeviceShmem::_open_create()
     }
   }
   
+  // a new queue, so remove the shared files from any earlier one
+
+  if (!_ushmCheck(_statKey, 0)) {
+    _removeShmFiles();
+  }
+
   // create shmem segments
   
   if ((_statPtr = (char *) _ushmCreate(_statKey, _nbytes[STAT_IDENT], 0666)) == NULL) {
@@ -547,6 +578,376 @@ int FmqDeviceShmem::update_last_id_read(int lastIdRead)
 
 }
 
+////////////////////////////////////////////////////////////
+// Wait for a write to the queue, using a futex on the
+// write sequence number in the notification block.
+//
+// Returns 0 if woken by a write, -1 on timeout.
+
+int FmqDeviceShmem::wait_for_write(int msecs)
+
+{
+
+#if defined(__linux__)
+
+  if (!_useNotify || _openNotify()) {
+    return FmqDevice::wait_for_write(msecs);
+  }
+
+  // register as a waiter before checking the sequence number,
+  // so that the writer does not skip the wake up
+
+  __atomic_add_fetch(&_notify->nWaiters, 1, __ATOMIC_SEQ_CST);
+  int seq = __atomic_load_n(&_notify->seq, __ATOMIC_SEQ_CST);
+
+  int iret = 0;
+  if (!_notifyInit) {
+    // first wait - writes before now have not been tracked,
+    // so return for the caller to check the queue again
+    _notifyInit = true;
+  } else if (seq == _lastNotifySeq && msecs > 0) {
+    struct timespec timeout;
+    timeout.tv_sec = msecs / 1000;
+    timeout.tv_nsec = (msecs % 1000) * 1000000;
+    syscall(SYS_futex, &_notify->seq, FUTEX_WAIT, seq, &timeout, NULL, 0);
+    seq = __atomic_load_n(&_notify->seq, __ATOMIC_SEQ_CST);
+    if (seq == _lastNotifySeq) {
+      iret = -1;
+    }
+  } else if (seq == _lastNotifySeq) {
+    iret = -1;
+  }
+
+  __atomic_sub_fetch(&_notify->nWaiters, 1, __ATOMIC_SEQ_CST);
+  _lastNotifySeq = seq;
+  return iret;
+
+#else
+
+  return FmqDevice::wait_for_write(msecs);
+
+#endif
+  
+}
+
+////////////////////////////////////////////////////////////
+// Wake readers waiting on the queue
+
+void FmqDeviceShmem::notify_write()
+
+{
+
+#if defined(__linux__)
+
+  if (!_useNotify || _openNotify()) {
+    return;
+  }
+
+  __atomic_add_fetch(&_notify->seq, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&_notify->nWaiters, __ATOMIC_SEQ_CST) > 0) {
+    syscall(SYS_futex, &_notify->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+  }
+
+#endif
+  
+}
+
+////////////////////////////////////////////////////////////
+// Begin an update to the stat struct or a slot.
+// Sets the sequence number to a new odd value, before the data
+// is modified.
+
+void FmqDeviceShmem::begin_update(int slot_num)
+
+{
+
+  unsigned int *seqPtr = _getSeqPtr(slot_num);
+  if (seqPtr == NULL) {
+    return;
+  }
+
+  // if the number is already odd, left by a writer which died
+  // part way through an update, still change it so that readers
+  // see this update
+
+  unsigned int seq = __atomic_load_n(seqPtr, __ATOMIC_RELAXED);
+  __atomic_store_n(seqPtr, (seq & 1) ? seq + 2 : seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+}
+
+////////////////////////////////////////////////////////////
+// End an update to the stat struct or a slot.
+// Sets the sequence number even, after the data is complete.
+
+void FmqDeviceShmem::end_update(int slot_num)
+
+{
+
+  unsigned int *seqPtr = _getSeqPtr(slot_num);
+  if (seqPtr == NULL) {
+    return;
+  }
+
+  unsigned int seq = __atomic_load_n(seqPtr, __ATOMIC_RELAXED);
+  if (seq & 1) {
+    __atomic_store_n(seqPtr, seq + 1, __ATOMIC_RELEASE);
+  }
+
+}
+
+////////////////////////////////////////////////////////////
+// Get the update sequence number for the stat struct or a slot.
+// The fence makes sure that reads of the data before this call
+// are complete before the sequence number is read.
+// Returns 0 if the sequence table is not available.
+
+unsigned int FmqDeviceShmem::get_update_seq(int slot_num)
+
+{
+
+  unsigned int *seqPtr = _getSeqPtr(slot_num);
+  if (seqPtr == NULL) {
+    return 0;
+  }
+
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(seqPtr, __ATOMIC_ACQUIRE);
+
+}
+
+////////////////////////////////////////////////////////////
+// Open the notification block - see _mapShmFile().
+// It stays mapped until the object is destroyed.
+//
+// Returns 0 on success, -1 on failure.
+
+int FmqDeviceShmem::_openNotify()
+
+{
+
+  if (_notify != NULL) {
+    return 0;
+  }
+
+  void *ptr = _mapShmFile("fmq_notify", sizeof(notify_t));
+  if (ptr == NULL) {
+    return -1;
+  }
+
+  _notify = (notify_t *) ptr;
+  _notifyInit = false;
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// Close the notification block
+
+void FmqDeviceShmem::_closeNotify()
+
+{
+  if (_notify != NULL) {
+    munmap(_notify, sizeof(notify_t));
+    _notify = NULL;
+  }
+}
+
+////////////////////////////////////////////////////////////
+// Map a file in /dev/shm shared by the processes using the queue.
+//
+// The file is named from the prefix and the shmem key. Its first
+// int holds the shmid of the status segment, so that a file left
+// over from an earlier queue with the same key is not used.
+//
+// The file is created, with the owner and permissions of the status
+// segment, only by the owner of the queue. It is written under a
+// temporary name and then linked into place, so other processes
+// never see a partial file. Other users get NULL until the owner
+// has created it, and fall back to the non-shared behavior.
+//
+// Returns pointer to the mapping, NULL on failure.
+
+void *FmqDeviceShmem::_mapShmFile(const char *prefix, size_t size)
+
+{
+
+  if (_getShmemKeys()) {
+    return NULL;
+  }
+
+  int shmId = shmget(_statKey, 0, 0);
+  struct shmid_ds shmInfo;
+  if (shmId < 0 || shmctl(shmId, IPC_STAT, &shmInfo) != 0) {
+    return NULL;
+  }
+  bool isOwner = (geteuid() == shmInfo.shm_perm.uid);
+
+  string path = _shmFilePath(prefix);
+  int fd = open(path.c_str(), O_RDWR);
+  if (fd >= 0) {
+    struct stat fileStat;
+    int stamp = 0;
+    if (fstat(fd, &fileStat) == 0 &&
+        fileStat.st_uid == shmInfo.shm_perm.uid &&
+        (size_t) fileStat.st_size == size &&
+        pread(fd, &stamp, sizeof(stamp), 0) == sizeof(stamp) &&
+        stamp == shmId) {
+      void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+      return (ptr == MAP_FAILED ? NULL : ptr);
+    }
+    // stale - replace it if we own the queue, making sure the name
+    // still refers to the file we checked
+    close(fd);
+    struct stat pathStat;
+    if (!isOwner || stat(path.c_str(), &pathStat) ||
+        pathStat.st_ino != fileStat.st_ino) {
+      return NULL;
+    }
+    unlink(path.c_str());
+  } else if (errno != ENOENT || !isOwner) {
+    return NULL;
+  }
+
+  // create under a temporary name, then link into place
+
+  char tmpPath[1024];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.%d", path.c_str(), (int) getpid());
+  unlink(tmpPath);
+  fd = open(tmpPath, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    return NULL;
+  }
+  
+  // match the segment permissions, which are not narrowed by umask
+
+  mode_t mode = shmInfo.shm_perm.mode & 0777;
+  if (fchmod(fd, mode) || ftruncate(fd, size) ||
+      pwrite(fd, &shmId, sizeof(shmId), 0) != sizeof(shmId)) {
+    close(fd);
+    unlink(tmpPath);
+    return NULL;
+  }
+  int iret = link(tmpPath, path.c_str());
+  int errNum = errno;
+  unlink(tmpPath);
+  if (iret) {
+    close(fd);
+    if (errNum == EEXIST) {
+      // another process got there first
+      return _mapShmFile(prefix, size);
+    }
+    return NULL;
+  }
+
+  void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  return (ptr == MAP_FAILED ? NULL : ptr);
+
+}
+
+////////////////////////////////////////////////////////////
+// Get path for a shared file in /dev/shm
+
+string FmqDeviceShmem::_shmFilePath(const char *prefix)
+
+{
+  char path[1024];
+  snprintf(path, sizeof(path), "/dev/shm/%s_%d", prefix, (int) _statKey);
+  return path;
+}
+
+////////////////////////////////////////////////////////////
+// Remove the shared files in /dev/shm.
+// Called when the queue segments are created, so that files
+// from an earlier queue with the same key are not left behind.
+
+void FmqDeviceShmem::_removeShmFiles()
+
+{
+  unlink(_shmFilePath("fmq_notify").c_str());
+  unlink(_shmFilePath("fmq_seq").c_str());
+}
+
+////////////////////////////////////////////////////////////
+// Get pointer to the sequence number for a slot, or for the
+// stat struct if slot_num is STAT_SEQ. The table is opened,
+// or re-opened if the number of slots has changed.
+//
+// Returns NULL if the table is not available.
+
+unsigned int *FmqDeviceShmem::_getSeqPtr(int slot_num)
+
+{
+
+#if defined(__linux__)
+
+  if (_nbytes[STAT_IDENT] < sizeof(Fmq::q_stat_t)) {
+    return NULL;
+  }
+  size_t nslots =
+    (_nbytes[STAT_IDENT] - sizeof(Fmq::q_stat_t)) / sizeof(Fmq::q_slot_t);
+  if (slot_num < STAT_SEQ || slot_num >= (int) nslots) {
+    return NULL;
+  }
+
+  if (_seqTable == NULL || _seqNslots != nslots) {
+    if (_openSeqTable(nslots)) {
+      return NULL;
+    }
+  }
+
+  return _seqTable + slot_num + 2;
+
+#else
+
+  return NULL;
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////
+// Open the sequence table - see _mapShmFile().
+// _seqTable[0] holds the shmid of the stat segment, followed by
+// the sequence numbers for the stat struct and the slots.
+//
+// Returns 0 on success, -1 on failure.
+
+int FmqDeviceShmem::_openSeqTable(size_t nslots)
+
+{
+
+  _closeSeqTable();
+
+  size_t tableSize = (nslots + 2) * sizeof(unsigned int);
+  void *ptr = _mapShmFile("fmq_seq", tableSize);
+  if (ptr == NULL) {
+    return -1;
+  }
+
+  _seqTable = (unsigned int *) ptr;
+  _seqNslots = nslots;
+  _seqTableSize = tableSize;
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// Close the sequence table
+
+void FmqDeviceShmem::_closeSeqTable()
+
+{
+  if (_seqTable != NULL) {
+    munmap(_seqTable, _seqTableSize);
+    _seqTable = NULL;
+    _seqNslots = 0;
+    _seqTableSize = 0;
+  }
+}
+
 ////////////////////////////////////////////////////////////
 // Get the segment name
 
@@ -285,6 +285,24 @@ public:
   
   virtual int writeMsg(int type, int subType=0, const void *msg=NULL, int msgLen=0);
 
+  // Writes a batch of messages to the fmq.
+  // For remote writes, the batch is sent to the server in a
+  // single request, and the server writes it under a single lock.
+  // Returns 0 on success, -1 on error
+  
+  virtual int writeMsgs(const vector<MsgEntry> &msgs);
+
+  // Reads the available messages, up to maxMsgs messages or
+  // maxBytes total length. Does not wait.
+  // For remote reads, at most one request is made to the server.
+  // See Fmq::readMsgs().
+  // Returns 0 on success, -1 on error
+
+  virtual int readMsgs(vector<MsgEntry> &msgs,
+                       int maxMsgs,
+                       int maxBytes = -1,
+                       int type = -1);
+
   ////////////////////////
   // using the write cache
 
@@ -302,8 +320,8 @@ public:
   int getWriteCacheSize() { return (int) _writeQueue.size(); }
 
   // Writes all data in the cache to the fmq.
-  // For remote writes, this is performed in a single action.
-  // For local writes, these are written one at a time.
+  // This is performed in a single action - for remote writes
+  // as a single request, for local writes as a single batch.
   // Returns 0 on success, -1 on error
   
   int writeTheCache();
@@ -394,6 +412,7 @@ private:
   int _checkClientSocket();
   
   int _contactServer(void *buffer, const size_t bufLen);
+  int _readFromServer(int type, int msecs_sleep);
   
   void _printDebugLabel(const string &label);
 
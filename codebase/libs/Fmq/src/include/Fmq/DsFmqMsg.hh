@@ -103,6 +103,12 @@ public:
 
   DsFmqMsg();
   
+  // copy constructor and assignment - the compression
+  // context is not shared between copies
+
+  DsFmqMsg(const DsFmqMsg &rhs);
+  DsFmqMsg &operator=(const DsFmqMsg &rhs);
+
   // destructor
 
   virtual ~DsFmqMsg();
@@ -143,6 +149,11 @@ public:
 
   void addReadData(const Fmq &fmq);
   
+  // Add read data for a message entry returned by
+  // Fmq::readMsgs(), in preparation for calling assembleReadReply().
+
+  void addReadData(const Fmq::MsgEntry &entry);
+  
   // Assemble reply after successful read.
   // Assumes clearAll() was called, and data was
   // added with a series of calls to addReadData()
@@ -158,6 +169,14 @@ public:
 		    bool compress,
 		    ta_compression_method_t cmethod);
   
+  // Add write data for a message entry, as passed to
+  // Fmq::writeMsgs(). If the entry is pre-compressed it is
+  // passed on as it is, otherwise it is compressed if requested.
+
+  void addWriteData(const Fmq::MsgEntry &entry,
+		    bool compress,
+		    ta_compression_method_t cmethod);
+  
   // assemble request write message
   // Assumes clearAll() was called, and data was
   // added with a series of calls to addwriteData()
@@ -216,6 +235,11 @@ protected:
   vector<void *> _msgData;
   vector<msgInfo_t> _msgInfo;
 
+  // compression on write - context created on first use
+
+  ta_compress_ctx_t *_compressCtx;
+  MemBuf _compressBuf;
+
   // methods
  
   void BEfromInfo(msgInfo_t *info);
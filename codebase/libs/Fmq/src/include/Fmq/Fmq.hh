@@ -39,6 +39,7 @@
 #ifndef _FMQ_HH_INCLUDED_
 #define _FMQ_HH_INCLUDED_
 
+#include <vector>
 #include <toolsa/compress.h>
 #include <toolsa/MemBuf.hh>
 #include <Fmq/FmqDeviceFile.hh>
@@ -135,6 +136,38 @@ public:
     si32 checksum;
     
   } q_slot_t;
+
+  // message entry for batch writes and reads - see writeMsgs()
+  // and readMsgs()
+  //
+  // For writes, set type, subType, msg and msgLen. If the message
+  // has already been compressed, set preCompressed and
+  // uncompressedLen, and msgLen to the compressed length.
+  //
+  // For reads, all members are filled in. preCompressed is only
+  // set for a server, which passes compressed data on to the
+  // client.
+
+  class MsgEntry {
+  public:
+    MsgEntry() :
+            type(0), subType(0), id(-1), time(0),
+            msg(NULL), msgLen(0),
+            preCompressed(false), uncompressedLen(0) {}
+    MsgEntry(int msgType, int msgSubType,
+             const void *msgPtr, int len) :
+            type(msgType), subType(msgSubType), id(-1), time(0),
+            msg(msgPtr), msgLen(len),
+            preCompressed(false), uncompressedLen(len) {}
+    int type;
+    int subType;
+    int id;
+    time_t time;
+    const void *msg;
+    int msgLen;
+    bool preCompressed;
+    int uncompressedLen;
+  };
   
   // constructor
   // note: you must call one of the init() functions
@@ -188,7 +221,10 @@ public:
   //   numSlots: for creates, number of slots in queue.
   //   bufSize: for creates, total size of data buffer.
   //   msecSleep: for blocking reads, number of milli-seconds
-  //              to wait while polling.
+  //              to wait while polling. Readers are woken early
+  //              when the queue is written, unless the
+  //              FMQ_USE_NOTIFY environment variable is FALSE -
+  //              see FmqDevice::wait_for_write().
   //   msgLog: optional pointer to a message log. If NULL, a log
   //           is created by this object.
 
@@ -331,7 +367,11 @@ public:
   virtual int setBlockingWrite();
  
   // Set flag to indicate that there is only a single writer
-  // so the locking is not necessary
+  // so the locking is not necessary.
+  // Readers never lock. For shmem queues they check the update
+  // sequence numbers (see FmqDevice::begin_update()) to discard
+  // messages overwritten while they were being copied, so a
+  // single writer never waits on either readers or a lock file.
   // Returns 0 on success, -1 on error
 
   virtual int setSingleWriter();
@@ -390,6 +430,32 @@ public:
 		       int subType = 0,
 		       const void *msg = NULL,
 		       int msgLen = 0);
+
+  // Writes a batch of messages to the fmq, taking the lock once
+  // and updating the status struct once for the whole batch.
+  // Each message gets its own slot, id and type, exactly as for
+  // writeMsg(), so readers are not affected. If compression is
+  // active, each message is compressed separately.
+  // Returns 0 on success, -1 on error. On error, the messages
+  // before the failed one have been written.
+
+  virtual int writeMsgs(const vector<MsgEntry> &msgs);
+
+  // Reads the available messages, up to maxMsgs messages or
+  // maxBytes total message length, with a single read of the
+  // status struct. Does not wait for messages.
+  // If maxBytes is non-positive, there is no limit on length.
+  // If type is specified, only messages of that type are returned.
+  // The msg pointers in the entries point into a buffer owned
+  // by this object, and remain valid until the next readMsgs().
+  // The get methods below refer to the last message in the batch.
+  // Returns 0 on success, -1 on error. msgs is empty if no
+  // messages are available.
+
+  virtual int readMsgs(vector<MsgEntry> &msgs,
+                       int maxMsgs,
+                       int maxBytes = -1,
+                       int type = -1);
   
   // Writing precompressed msg
   // Returns 0 on success, -1 on error
@@ -617,6 +683,12 @@ protected:
   // buffer for message
   
   MemBuf _msgBuf;      /* buffer for message */
+  MemBuf _batchBuf;    /* buffer for messages from readMsgs() */
+
+  // compression context and output buffer, reused between messages
+
+  ta_compress_ctx_t *_compressCtx;
+  MemBuf _compressBuf;
   
   // copy of latest stat and slot read
 
@@ -695,6 +767,11 @@ protected:
 
   int _lock_device();
   int _unlock_device();
+  int _wait_device(int msecs);
+  void _notify_device();
+  void _begin_update_device(int slot_num);
+  void _end_update_device(int slot_num);
+  unsigned int _get_update_seq_device(int slot_num);
 
   // seek
 
@@ -712,7 +789,7 @@ protected:
   int _read_stat();
   int _read_slots();
   int _read_slot(int slot_num);
-  int _read_next(int *msg_read);
+  int _read_next(int *msg_read, bool read_stat = true);
   int _read_msg_for_slot(int slot_num);
   int _read_msg(int slot_num);
 
@@ -739,13 +816,16 @@ protected:
   int _write_precompressed(void *msg, int msg_len,
 			   int msg_type, int msg_subtype,
 			   int uncompressed_len);
+
+  int _write_batch(const vector<MsgEntry> &msgs);
   
   int _write_stat();
   int _write_slot(int slot_num);
   
   int _write_msg(void *msg, int msg_len,
 		 int msg_type, int msg_subtype,
-		 int pre_compressed, int uncompressed_len);
+		 int pre_compressed, int uncompressed_len,
+		 bool batch = false);
   
   int _write_msg_to_slot(int write_slot, int write_id,
 			 void *msg, int msg_len, int stored_len, int offset);
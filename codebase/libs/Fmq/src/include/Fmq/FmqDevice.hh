@@ -107,6 +107,52 @@ public:
 
   virtual int get_size(ident_t id) = 0;
   
+  // Notification of writes, so that readers can wait for new
+  // data instead of sleeping for a fixed interval.
+  //
+  // wait_for_write() returns as soon as the queue has been
+  // written since the previous wait, or after msecs if there
+  // has been no write. If notification is not available,
+  // or is turned off, it sleeps for msecs.
+  //
+  // Notification may be turned off by setting the environment
+  // variable FMQ_USE_NOTIFY to FALSE.
+  //
+  // Returns 0 if woken by a write, -1 on timeout.
+
+  virtual int wait_for_write(int msecs);
+
+  // wake readers waiting on the queue - called after writing
+
+  virtual void notify_write();
+
+  // Update sequence numbers, so that readers can detect a stat
+  // struct or slot which was modified while they were copying it,
+  // without taking a lock.
+  //
+  // The writer calls begin_update() before modifying the slot, or
+  // the buffer area it points to, and end_update() once the slot
+  // and message are complete. The sequence number is odd while an
+  // update is in progress. Use STAT_SEQ as the slot number for
+  // the stat struct.
+  //
+  // The reader gets the sequence number before and after copying.
+  // The copy is good if the number has not changed. Each update
+  // sets a new odd number, so an update which starts while the
+  // reader is copying is always seen. A slot's buffer space is
+  // only overwritten after the slot has been freed and that update
+  // closed, so an odd number on an active slot means the update is
+  // finishing, or was abandoned, and the slot can still be read.
+  //
+  // The base class does not keep sequence numbers, and
+  // get_update_seq() always returns 0.
+
+  static const int STAT_SEQ = -1;
+
+  virtual void begin_update(int slot_num);
+  virtual void end_update(int slot_num);
+  virtual unsigned int get_update_seq(int slot_num);
+
   ///////////////////////////////////////////////////////////////////
   // error string is set during open/read/write operations
   // get error string is an error is returned
@@ -128,6 +174,10 @@ protected:
 
   TA_heartbeat_t _heartbeatFunc;
   
+  // use notification of writes?
+
+  bool _useNotify;
+
 private:
 
 };
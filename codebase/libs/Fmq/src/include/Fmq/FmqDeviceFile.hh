@@ -103,6 +103,15 @@ public:
   // Get size of device buffer
 
   virtual int get_size(ident_t id);
+
+  // Notification of writes.
+  //
+  // Readers watch the queue directory with inotify, and wake
+  // when the stat file is modified. No action is needed by
+  // the writer. Not available on non-Linux hosts, which sleep
+  // instead.
+
+  virtual int wait_for_write(int msecs);
   
 protected:
 
@@ -124,6 +133,14 @@ private:
   int _buf_fd;
   int _fd[N_IDENT];
 
+  // inotify for notification of writes
+
+  int _inotifyFd;
+  int _inotifyWd;
+  string _statName;
+
+  void _closeNotify();
+
 };
 
 #endif
@@ -100,6 +100,43 @@ public:
   // Get size of device buffer
 
   virtual int get_size(ident_t id);
+
+  // Notification of writes.
+  //
+  // The notification block is a small file in /dev/shm, named from
+  // the shmem key, holding a write sequence number and a count of
+  // waiting readers. Readers wait on the sequence number with a
+  // futex, and the writer increments it and wakes them.
+  // The file has the same owner and permissions as the queue
+  // segments. It is removed when a writer creates the segments;
+  // if the segments are removed by hand (ipcrm), remove
+  // /dev/shm/fmq_*_<key> too, or run nuke_ipcs.
+  // Readers fall back to sleeping if the block is not available.
+  // Not available on non-Linux hosts, which sleep instead.
+
+  virtual int wait_for_write(int msecs);
+  virtual void notify_write();
+
+  // Update sequence numbers.
+  //
+  // The sequence table is a file in /dev/shm, named from the shmem
+  // key, holding a sequence number for the stat struct and one
+  // for each slot. The writer updates it under the write lock, or
+  // without a lock in single-writer mode. Readers never lock -
+  // they use the sequence numbers to discard inconsistent copies.
+  // The table is kept separate from the stat segment so that the
+  // queue layout is unchanged for existing readers and writers.
+  // It is created and removed like the notification block, and
+  // holds the shmid of the stat segment, so a table from an
+  // earlier queue with the same key is never used. With a writer
+  // which does not update the table, readers fall back on the
+  // checksums and id checks, as on non-Linux hosts.
+  // Not available on non-Linux hosts, which rely on the checksums
+  // and id checks alone.
+
+  virtual void begin_update(int slot_num);
+  virtual void end_update(int slot_num);
+  virtual unsigned int get_update_seq(int slot_num);
   
 protected:
 
@@ -123,6 +160,25 @@ private:
   // off_t _bufOffset; // current offset in buf segment
   off_t _offset[N_IDENT];
 
+  // notification block, shared between processes
+
+  typedef struct {
+    int shmId;     // shmid of the stat segment, see _mapShmFile()
+    int seq;       // incremented on every write
+    int nWaiters;  // number of readers waiting
+  } notify_t;
+
+  notify_t *_notify;
+  bool _notifyInit;
+  int _lastNotifySeq;
+
+  // update sequence table, shared between processes
+  // _seqTable[0] is for the stat struct, followed by the slots
+
+  unsigned int *_seqTable;
+  size_t _seqNslots;
+  size_t _seqTableSize;
+
   // lock file for synchronization
   
   string _lock_path;
@@ -143,6 +199,17 @@ private:
   int _ushmDetach(void *shm_ptr);
   int _ushmRemove(key_t key);
 
+  void *_mapShmFile(const char *prefix, size_t size);
+  string _shmFilePath(const char *prefix);
+  void _removeShmFiles();
+
+  int _openNotify();
+  void _closeNotify();
+
+  unsigned int *_getSeqPtr(int slot_num);
+  int _openSeqTable(size_t nslots);
+  void _closeSeqTable();
+
 };
 
 #endif
@@ -5655,10 +5655,19 @@ int MdvxField::compress(int compression_type) const
 
   buffer_to_BE(_volBuf.getPtr(), nbytes_vol, _fhdr.encoding_type);
 
-  // create working buffer
+  // create working buffer, and a compression context
+  // which is reused for all planes
   
   MemBuf workBuf;
+  ta_compress_ctx_t *ctx = ta_compress_ctx_create();
+  ui64 plane_bound = ta_compress_bound(TA_COMPRESSION_GZIP, nbytes_plane);
+
+  // the plane index goes at the start of the working buffer,
+  // ahead of the compressed planes
 
+  int64_t index_array_size = nz * sizeof(ui32);
+  int64_t index_len = 2 * index_array_size;
+  
   // compress plane-by-plane
   
   ui32 plane_offsets[MDV_MAX_VLEVELS];
@@ -5667,15 +5676,16 @@ int MdvxField::compress(int compression_type) const
   for (int iz = 0; iz < nz; iz++) {
 
     // only use GZIP compression - all others are deprecated
+    // compress directly into the end of the working buffer
     
     void *uncompressed_plane = ((char *) _volBuf.getPtr() + iz * nbytes_plane);
+    char *work = (char *) workBuf.prepare(index_len + next_offset + plane_bound);
     ui64 nbytes_compressed;
-    void *compressed_plane = ta_compress(TA_COMPRESSION_GZIP,
-                                         uncompressed_plane,
-                                         nbytes_plane,
-                                         &nbytes_compressed);
-    
-    if (compressed_plane == NULL) {
+    if (ta_compress_buf(ctx, TA_COMPRESSION_GZIP,
+                        uncompressed_plane, nbytes_plane,
+                        work + index_len + next_offset, plane_bound,
+                        &nbytes_compressed)) {
+      ta_compress_ctx_free(ctx);
       _errStr += "ERROR - MdvxField::_compress.\n";
       _errStr +=  "  Compression failed.\n";
       return -1;
@@ -5683,25 +5693,23 @@ int MdvxField::compress(int compression_type) const
 
     plane_offsets[iz] = next_offset;
     plane_sizes[iz] = nbytes_compressed;
-    
-    workBuf.add(compressed_plane, nbytes_compressed);
-    ta_compress_free(compressed_plane);
     next_offset += nbytes_compressed;
 
   } // iz
 
+  char *work = (char *) workBuf.prepare(index_len + next_offset);
+  ta_compress_ctx_free(ctx);
+
   // swap plane offset and size arrays
 
-  int64_t index_array_size = nz * sizeof(ui32);
   BE_from_array_32(plane_offsets, index_array_size);
   BE_from_array_32(plane_sizes, index_array_size);
 
-  // assemble compressed buffer
+  // fill in the index, and swap the work buffer into the volume
   
-  _volBuf.free();
-  _volBuf.add(plane_offsets, index_array_size);
-  _volBuf.add(plane_sizes, index_array_size);
-  _volBuf.add(workBuf.getPtr(), workBuf.getLen());
+  memcpy(work, plane_offsets, index_array_size);
+  memcpy(work + index_array_size, plane_sizes, index_array_size);
+  _volBuf.swap(workBuf);
 
   // adjust header
 
@@ -5781,9 +5789,18 @@ int MdvxField::compress64(int compression_type) const
 
   buffer_to_BE(_volBuf.getPtr(), nbytes_vol, _fhdr.encoding_type);
 
-  // create working buffer
+  // create working buffer, and a compression context
+  // which is reused for all planes
   
   MemBuf workBuf;
+  ta_compress_ctx_t *ctx = ta_compress_ctx_create();
+  ui64 plane_bound = ta_compress_bound(TA_COMPRESSION_GZIP, nbytes_plane);
+
+  // the plane index goes at the start of the working buffer,
+  // ahead of the compressed planes
+
+  int64_t index_array_size = nz * sizeof(ui64);
+  int64_t index_len = sizeof(flags64) + 2 * index_array_size;
   
   // compress plane-by-plane
   
@@ -5793,15 +5810,16 @@ int MdvxField::compress64(int compression_type) const
   for (int iz = 0; iz < nz; iz++) {
 
     // only use GZIP compression - all others are deprecated
+    // compress directly into the end of the working buffer
     
     void *uncompressed_plane = ((char *) _volBuf.getPtr() + iz * nbytes_plane);
+    char *work = (char *) workBuf.prepare(index_len + next_offset + plane_bound);
     ui64 nbytes_compressed;
-    void *compressed_plane = ta_compress(TA_COMPRESSION_GZIP,
-                                         uncompressed_plane,
-                                         nbytes_plane,
-                                         &nbytes_compressed);
-    
-    if (compressed_plane == NULL) {
+    if (ta_compress_buf(ctx, TA_COMPRESSION_GZIP,
+                        uncompressed_plane, nbytes_plane,
+                        work + index_len + next_offset, plane_bound,
+                        &nbytes_compressed)) {
+      ta_compress_ctx_free(ctx);
       _errStr += "ERROR - MdvxField::_compress.\n";
       _errStr +=  "  Compression failed.\n";
       return -1;
@@ -5809,26 +5827,25 @@ int MdvxField::compress64(int compression_type) const
 
     plane_offsets[iz] = next_offset;
     plane_sizes[iz] = nbytes_compressed;
-    
-    workBuf.add(compressed_plane, nbytes_compressed);
-    ta_compress_free(compressed_plane);
     next_offset += nbytes_compressed;
 
   } // iz
 
+  char *work = (char *) workBuf.prepare(index_len + next_offset);
+  ta_compress_ctx_free(ctx);
+
   // swap plane offset and size arrays
 
-  int64_t index_array_size = nz * sizeof(ui64);
   BE_from_array_64(plane_offsets, index_array_size);
   BE_from_array_64(plane_sizes, index_array_size);
 
-  // assemble compressed buffer
+  // fill in the index, and swap the work buffer into the volume
   
-  _volBuf.free();
-  _volBuf.add(flags64, sizeof(flags64));
-  _volBuf.add(plane_offsets, index_array_size);
-  _volBuf.add(plane_sizes, index_array_size);
-  _volBuf.add(workBuf.getPtr(), workBuf.getLen());
+  memcpy(work, flags64, sizeof(flags64));
+  memcpy(work + sizeof(flags64), plane_offsets, index_array_size);
+  memcpy(work + sizeof(flags64) + index_array_size,
+         plane_sizes, index_array_size);
+  _volBuf.swap(workBuf);
 
   // adjust header
 
@@ -5858,29 +5875,30 @@ int MdvxField::_compressGzipVol() const
 
   buffer_to_BE(_volBuf.getPtr(), nbytes_vol, _fhdr.encoding_type);
 
-  // compress vol into single buffer
+  // compress vol into single buffer, directly into
+  // the working buffer
   
-  void *uncompressed_vol = _volBuf.getPtr();
+  MemBuf workBuf;
+  ta_compress_ctx_t *ctx = ta_compress_ctx_create();
+  ui64 vol_bound = ta_compress_bound(TA_COMPRESSION_GZIP, nbytes_vol);
+  void *compressed_vol = workBuf.prepare(vol_bound);
   ui64 nbytes_compressed;
-  void *compressed_vol = ta_compress(TA_COMPRESSION_GZIP,
-                                     uncompressed_vol,
-                                     nbytes_vol,
-                                     &nbytes_compressed);
+  int iret = ta_compress_buf(ctx, TA_COMPRESSION_GZIP,
+                             _volBuf.getPtr(), nbytes_vol,
+                             compressed_vol, vol_bound,
+                             &nbytes_compressed);
+  ta_compress_ctx_free(ctx);
   
-  if (compressed_vol == NULL) {
+  if (iret) {
     _errStr += "ERROR - MdvxField::_compressGzipVol.\n";
     _errStr +=  "  Compression failed.\n";
     return -1;
   }
   
-  // load compressed buffer into volume buffer
+  // swap compressed buffer into volume buffer
   
-  _volBuf.free();
-  _volBuf.add(compressed_vol, nbytes_compressed);
-
-  // free up
-
-  ta_compress_free(compressed_vol);
+  workBuf.prepare(nbytes_compressed);
+  _volBuf.swap(workBuf);
   
   // adjust header
 
@@ -5945,9 +5963,12 @@ int MdvxField::decompress() const
   BE_to_array_32(plane_offsets, index_array_size);
   BE_to_array_32(plane_sizes, index_array_size);
 
-  // create work buffer
+  // create work buffer, sized for the uncompressed volume,
+  // and a compression context which is reused for all planes
 
   MemBuf workBuf;
+  char *work = (char *) workBuf.prepare(nbytes_vol);
+  ta_compress_ctx_t *ctx = ta_compress_ctx_create();
   
   for (int iz = 0; iz < nz; iz++) {
 
@@ -5959,6 +5980,7 @@ int MdvxField::decompress() const
     // check for valid offset
 
     if (this_offset > _volBuf.getLen() - 1) {
+      ta_compress_ctx_free(ctx);
       _errStr += "ERROR - MdvxField::decompress.\n";
       char errstr[1024];
       snprintf(errstr, 1024,
@@ -5970,17 +5992,20 @@ int MdvxField::decompress() const
       return -1;
     }
 
+    // decompress directly into place in the work buffer
+
     compressed_plane = ((char *) _volBuf.getPtr() + this_offset);
+    uncompressed_plane = work + iz * nbytes_plane;
     
-    uncompressed_plane =
-      ta_decompress(compressed_plane, &nbytes_uncompressed);
-    
-    if (uncompressed_plane == NULL) {
-      _errStr += "ERROR - MdvxField::decompress.\n";
-      _errStr +=  "  Field not compressed.\n";
-      return -1;
+    if (ta_decompress_buf(ctx, compressed_plane,
+                          uncompressed_plane, nbytes_plane,
+                          &nbytes_uncompressed) == 0 &&
+        (int) nbytes_uncompressed == nbytes_plane) {
+      continue;
     }
 
+    ta_compress_ctx_free(ctx);
+    nbytes_uncompressed = ta_decompress_len(compressed_plane);
     if ((int) nbytes_uncompressed != nbytes_plane) {
       _errStr += "ERROR - MdvxField::decompress.\n";
       _errStr +=  "  Wrong number of bytes in plane.\n";
@@ -5988,15 +6013,16 @@ int MdvxField::decompress() const
       sprintf(errstr, "  %ld expected, %ld found.\n",
 	      (long) nbytes_plane, (long) nbytes_uncompressed);
       _errStr += errstr;
-      ta_compress_free(uncompressed_plane);
-      return -1;
+    } else {
+      _errStr += "ERROR - MdvxField::decompress.\n";
+      _errStr +=  "  Field not compressed.\n";
     }
-    
-    workBuf.add(uncompressed_plane, nbytes_plane);
-    ta_compress_free(uncompressed_plane);
+    return -1;
 
   } // iz
 
+  ta_compress_ctx_free(ctx);
+
   // check
   
   if ((int) workBuf.getLen() != nbytes_vol) {
@@ -6009,10 +6035,9 @@ int MdvxField::decompress() const
     return -1;
   }
   
-  // copy work buf to volume buf
+  // swap work buf into volume buf
   
-  _volBuf.reset();
-  _volBuf.add(workBuf.getPtr(), nbytes_vol);
+  _volBuf.swap(workBuf);
 
   // swap volume data from BE as appropriate
 
@@ -6056,20 +6081,24 @@ int MdvxField::_decompress64() const
   BE_to_array_64(plane_offsets, index_array_size);
   BE_to_array_64(plane_sizes, index_array_size);
 
-  // create work buffer
+  // create work buffer, sized for the uncompressed volume,
+  // and a compression context which is reused for all planes
 
   MemBuf workBuf;
+  char *work = (char *) workBuf.prepare(nbytes_vol);
+  ta_compress_ctx_t *ctx = ta_compress_ctx_create();
   
   for (int iz = 0; iz < nz; iz++) {
     
     char *compressed_plane;
     void *uncompressed_plane;
-    ui64 nbytes_uncompressed;
+    ui64 nbytes_uncompressed = 0;
     ui64 this_offset = plane_offsets[iz] + sizeof(flags64) + 2 * index_array_size;
 
     // check for valid offset
 
     if (this_offset > _volBuf.getLen() - 1) {
+      ta_compress_ctx_free(ctx);
       _errStr += "ERROR - MdvxField::decompress64.\n";
       char errstr[1024];
       snprintf(errstr, 1024,
@@ -6081,33 +6110,37 @@ int MdvxField::_decompress64() const
       return -1;
     }
 
+    // decompress directly into place in the work buffer
+
     compressed_plane = ((char *) _volBuf.getPtr() + this_offset);
+    uncompressed_plane = work + iz * nbytes_plane;
     
-    uncompressed_plane =
-      ta_decompress(compressed_plane, &nbytes_uncompressed);
-    
-    if (uncompressed_plane == NULL) {
-      _errStr += "ERROR - MdvxField::decompress64.\n";
-      _errStr +=  "  Field not compressed.\n";
-      return -1;
+    if (ta_decompress_buf(ctx, compressed_plane,
+                          uncompressed_plane, nbytes_plane,
+                          &nbytes_uncompressed) == 0 &&
+        (int64_t) nbytes_uncompressed == nbytes_plane) {
+      continue;
     }
 
-    if ((int) nbytes_uncompressed != nbytes_plane) {
+    ta_compress_ctx_free(ctx);
+    nbytes_uncompressed = ta_decompress_len(compressed_plane);
+    if ((int64_t) nbytes_uncompressed != nbytes_plane) {
       _errStr += "ERROR - MdvxField::decompress64.\n";
       _errStr +=  "  Wrong number of bytes in plane.\n";
       char errstr[1024];
       snprintf(errstr, 1024, "  %ld expected, %ld found.\n",
                (long) nbytes_plane, (long) nbytes_uncompressed);
       _errStr += errstr;
-      ta_compress_free(uncompressed_plane);
-      return -1;
+    } else {
+      _errStr += "ERROR - MdvxField::decompress64.\n";
+      _errStr +=  "  Field not compressed.\n";
     }
-    
-    workBuf.add(uncompressed_plane, nbytes_plane);
-    ta_compress_free(uncompressed_plane);
+    return -1;
 
   } // iz
 
+  ta_compress_ctx_free(ctx);
+
   // check
   
   if ((int) workBuf.getLen() != nbytes_vol) {
@@ -6120,10 +6153,9 @@ int MdvxField::_decompress64() const
     return -1;
   }
   
-  // copy work buf to volume buf
+  // swap work buf into volume buf
   
-  _volBuf.reset();
-  _volBuf.add(workBuf.getPtr(), nbytes_vol);
+  _volBuf.swap(workBuf);
 
   // swap volume data from BE as appropriate
 
@@ -6152,41 +6184,48 @@ int MdvxField::_decompressGzipVol() const
   int64_t nbytes_plane = npoints_plane * _fhdr.data_element_nbytes;
   int64_t nbytes_vol = _fhdr.nz * nbytes_plane;
 
-  // uncompress buffer
-  
+  // check size
+
   void *compressed_vol = _volBuf.getPtr();
-  ui64 nbytes_uncompressed;
-  void *uncompressed_vol =
-    ta_decompress(compressed_vol, &nbytes_uncompressed);
-    
-  if (uncompressed_vol == NULL) {
+  ui64 nbytes_uncompressed = 0;
+  if (ta_is_compressed(compressed_vol, _volBuf.getLen())) {
+    nbytes_uncompressed = ta_decompress_len(compressed_vol);
+  } else {
     _errStr += "ERROR - MdvxField::_decompressGzipVol.\n";
     _errStr +=  "  Compression type not recognized.\n";
     return -1;
   }
 
-  // check size
-
-  if ((int) nbytes_uncompressed != nbytes_vol) {
+  if ((int64_t) nbytes_uncompressed != nbytes_vol) {
     _errStr += "ERROR - MdvxField::_decompressGzipVol.\n";
     _errStr +=  "  Wrong number of bytes in vol.\n";
     char errstr[1024];
     snprintf(errstr, 1024, "  %ld expected, %ld found.\n",
              (long) nbytes_vol, (long) nbytes_uncompressed);
     _errStr += errstr;
-    ta_compress_free(uncompressed_vol);
     return -1;
   }
   
-  // copy work buf to volume buf
+  // uncompress buffer directly into the working buffer
   
-  _volBuf.reset();
-  _volBuf.add(uncompressed_vol, nbytes_vol);
+  MemBuf workBuf;
+  void *uncompressed_vol = workBuf.prepare(nbytes_vol);
+  ta_compress_ctx_t *ctx = ta_compress_ctx_create();
+  int iret = ta_decompress_buf(ctx, compressed_vol,
+                               uncompressed_vol, nbytes_vol,
+                               &nbytes_uncompressed);
+  ta_compress_ctx_free(ctx);
+    
+  if (iret) {
+    _errStr += "ERROR - MdvxField::_decompressGzipVol.\n";
+    _errStr +=  "  Cannot uncompress volume.\n";
+    return -1;
+  }
 
-  // free up
-  
-  ta_compress_free(uncompressed_vol);
+  // swap work buf into volume buf
   
+  _volBuf.swap(workBuf);
+
   // swap volume data from BE as appropriate
   
   buffer_from_BE(_volBuf.getPtr(), nbytes_vol, _fhdr.encoding_type);
@@ -0,0 +1,457 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 1990 - 2016
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+//////////////////////////////////////////////////////////
+// MdvxTimeIndex.cc
+//
+// Time index for a single MDV day directory.
+//
+// See MdvxTimeIndex.hh for details.
+//
+//////////////////////////////////////////////////////////
+
+#include <Mdv/MdvxTimeIndex.hh>
+#include <toolsa/Path.hh>
+#include <toolsa/TaFile.hh>
+#include <toolsa/file_io.h>
+#include <toolsa/mem.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+const char *MdvxTimeIndex::FILE_NAME = ".mdvx_time_index";
+
+// header line identifying the index file
+
+static const char *_indexHeader = "# MdvxTimeIndex version 2";
+
+/////////////////////////////////////////////////////////////////
+// constructor
+
+MdvxTimeIndex::MdvxTimeIndex(const string &dayDir) :
+        _dayDir(dayDir)
+
+{
+  _computePath(_dayDir, _indexDir, _path);
+  _scanStart.tv_sec = 0;
+  _scanStart.tv_nsec = 0;
+  MEM_zero(_scanDirState);
+}
+
+/////////////////////////////////////////////////////////////////
+// destructor
+
+MdvxTimeIndex::~MdvxTimeIndex()
+
+{
+
+}
+
+/////////////////////////////////////////////////////////////////
+// load the index for the day directory.
+// Returns 0 on success, -1 if the index does not exist,
+// is stale or cannot be read.
+
+int MdvxTimeIndex::load()
+
+{
+
+  _entries.clear();
+
+  if (_path.size() == 0) {
+    return -1;
+  }
+
+  TaFile infile;
+  FILE *in = infile.fopen(_path, "r");
+  if (in == NULL) {
+    return -1;
+  }
+
+  // check header
+
+  char line[BUFSIZ];
+  if (fgets(line, BUFSIZ, in) == NULL ||
+      strncmp(line, _indexHeader, strlen(_indexHeader))) {
+    return -1;
+  }
+
+  // the index is fresh if the day dir is the same, and has not
+  // been modified, since the scan
+
+  dir_state_t indexState, dirState;
+  if (fgets(line, BUFSIZ, in) == NULL ||
+      _decodeDirState(line, indexState) ||
+      _getDirState(_dayDir, dirState) ||
+      !_dirStatesEqual(indexState, dirState)) {
+    return -1;
+  }
+
+  // read entries
+
+  bool sorted = true;
+  while (fgets(line, BUFSIZ, in) != NULL) {
+    long validTime, genTime;
+    int nChars = 0;
+    if (sscanf(line, "%ld %ld %n", &validTime, &genTime, &nChars) < 2 ||
+        nChars == 0) {
+      continue;
+    }
+    string name(line + nChars);
+    while (name.size() > 0 &&
+           (name[name.size() - 1] == '\n' || name[name.size() - 1] == '\r')) {
+      name.resize(name.size() - 1);
+    }
+    if (name.size() == 0) {
+      continue;
+    }
+    Entry entry((time_t) validTime, (time_t) genTime, name);
+    if (_entries.size() > 0 && entry < _entries[_entries.size() - 1]) {
+      sorted = false;
+    }
+    _entries.push_back(entry);
+  }
+
+  // make sure the entries are sorted and unique, in case the
+  // file has been edited
+
+  if (!sorted) {
+    sort(_entries.begin(), _entries.end());
+  }
+  _entries.erase(unique(_entries.begin(), _entries.end()), _entries.end());
+
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////////////
+// set the entries, prior to writing
+
+void MdvxTimeIndex::setEntries(const vector<Entry> &entries)
+
+{
+  _entries = entries;
+  sort(_entries.begin(), _entries.end());
+  _entries.erase(unique(_entries.begin(), _entries.end()), _entries.end());
+}
+
+/////////////////////////////////////////////////////////////////
+// Record the start time of a directory scan. Call this before
+// reading the day directory to rebuild the index.
+
+void MdvxTimeIndex::startScan()
+
+{
+  clock_gettime(CLOCK_REALTIME, &_scanStart);
+  if (_getDirState(_dayDir, _scanDirState)) {
+    _scanStart.tv_sec = 0;
+  }
+}
+
+/////////////////////////////////////////////////////////////////
+// write the index for the day directory.
+// The index is written to a tmp file and then renamed.
+// It holds the state of the day dir at the start of the scan.
+// Returns 0 on success, -1 on failure.
+
+int MdvxTimeIndex::write()
+
+{
+
+  if (_scanStart.tv_sec == 0) {
+    // startScan() not called, so we cannot tell which
+    // directory changes are covered by the entries
+    return -1;
+  }
+
+  // If the dir was modified within a second of the start of the
+  // scan, a later change could have the same modify time on file
+  // systems with 1 sec time stamps, or with a coarse clock.
+
+  if (_scanDirState.mtime.tv_sec >= _scanStart.tv_sec - 1) {
+    return -1;
+  }
+
+  if (_path.size() == 0) {
+    return -1;
+  }
+
+  if (ta_makedir_recurse(_indexDir.c_str())) {
+    return -1;
+  }
+
+  Path ipath(_path);
+  string tmpPath = ipath.computeTmpPath();
+
+  TaFile outfile;
+  outfile.setRemoveOnDestruct();
+  FILE *out = outfile.fopen(tmpPath, "w");
+  if (out == NULL) {
+    // directory is probably not writable
+    return -1;
+  }
+
+  fprintf(out, "%s\n", _indexHeader);
+  fprintf(out, "%s\n", _encodeDirState(_scanDirState).c_str());
+  for (size_t ii = 0; ii < _entries.size(); ii++) {
+    const Entry &entry = _entries[ii];
+    fprintf(out, "%ld %ld %s\n",
+            (long) entry.validTime, (long) entry.genTime,
+            entry.name.c_str());
+  }
+
+  if (fflush(out) || ferror(out)) {
+    return -1;
+  }
+  outfile.fclose();
+
+  if (rename(tmpPath.c_str(), _path.c_str())) {
+    return -1;
+  }
+  outfile.clearRemoveOnDestruct();
+
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////////////
+// get entries with valid times between start and end, inclusive
+
+void MdvxTimeIndex::getRange(time_t startTime, time_t endTime,
+                             vector<Entry> &entries) const
+
+{
+
+  entries.clear();
+  if (endTime < startTime) {
+    return;
+  }
+
+  Entry lower(startTime, 0, "");
+  vector<Entry>::const_iterator first =
+    lower_bound(_entries.begin(), _entries.end(), lower);
+
+  for (vector<Entry>::const_iterator ii = first;
+       ii != _entries.end(); ii++) {
+    if (ii->validTime > endTime) {
+      break;
+    }
+    if (ii->validTime >= startTime) {
+      entries.push_back(*ii);
+    }
+  }
+
+}
+
+/////////////////////////////////////////////////////////////////
+// Check if the day dir is active, i.e. it was modified within
+// the last ACTIVE_SECS, or has a modify time in the future.
+
+bool MdvxTimeIndex::isActive(const string &dayDir)
+
+{
+  struct timespec dirTime;
+  if (getModTime(dayDir, dirTime)) {
+    return false;
+  }
+  time_t now = time(NULL);
+  return (dirTime.tv_sec > now - ACTIVE_SECS);
+}
+
+/////////////////////////////////////////////////////////////////
+// get the modify time of a file or dir, with sub-second precision
+// Returns 0 on success, -1 on failure.
+
+int MdvxTimeIndex::getModTime(const string &path, struct timespec &mtime)
+
+{
+
+  struct stat fstat;
+  if (stat(path.c_str(), &fstat)) {
+    return -1;
+  }
+#if defined(__APPLE__)
+  mtime = fstat.st_mtimespec;
+#else
+  mtime = fstat.st_mtim;
+#endif
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////////////
+// is indexing enabled? Checks the MDV_USE_TIME_INDEX env var.
+
+bool MdvxTimeIndex::isEnabled()
+
+{
+  char *useIndexStr = getenv("MDV_USE_TIME_INDEX");
+  if (useIndexStr != NULL && !strcasecmp(useIndexStr, "FALSE")) {
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////
+// get the state of the day dir.
+// Returns 0 on success, -1 on failure.
+
+int MdvxTimeIndex::_getDirState(const string &dayDir, dir_state_t &state)
+
+{
+
+  struct stat dstat;
+  if (stat(dayDir.c_str(), &dstat) || !S_ISDIR(dstat.st_mode)) {
+    return -1;
+  }
+  MEM_zero(state);
+  state.dev = (unsigned long) dstat.st_dev;
+  state.ino = (unsigned long) dstat.st_ino;
+#if defined(__APPLE__)
+  state.mtime = dstat.st_mtimespec;
+#else
+  state.mtime = dstat.st_mtim;
+#endif
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////////////
+// encode / decode the day dir state line in the index
+
+string MdvxTimeIndex::_encodeDirState(const dir_state_t &state)
+
+{
+  char line[256];
+  snprintf(line, sizeof(line), "# day_dir dev %lu ino %lu mtime %ld %ld",
+           state.dev, state.ino,
+           (long) state.mtime.tv_sec, (long) state.mtime.tv_nsec);
+  return line;
+}
+
+int MdvxTimeIndex::_decodeDirState(const char *line, dir_state_t &state)
+
+{
+  MEM_zero(state);
+  long sec, nsec;
+  if (sscanf(line, "# day_dir dev %lu ino %lu mtime %ld %ld",
+             &state.dev, &state.ino, &sec, &nsec) != 4) {
+    return -1;
+  }
+  state.mtime.tv_sec = sec;
+  state.mtime.tv_nsec = nsec;
+  return 0;
+}
+
+/////////////////////////////////////////////////////////////////
+// compare day dir states
+
+bool MdvxTimeIndex::_dirStatesEqual(const dir_state_t &aa,
+                                    const dir_state_t &bb)
+
+{
+  return (aa.dev == bb.dev && aa.ino == bb.ino &&
+          aa.mtime.tv_sec == bb.mtime.tv_sec &&
+          aa.mtime.tv_nsec == bb.mtime.tv_nsec);
+}
+
+/////////////////////////////////////////////////////////////////
+// Compute the index dir and path for a day dir.
+// Returns 0 on success, -1 if there is no usable index root,
+// in which case the path is empty.
+
+int MdvxTimeIndex::_computePath(const string &dayDir,
+                                string &indexDir, string &path)
+
+{
+
+  indexDir.clear();
+  path.clear();
+
+  // index root
+
+  string root;
+  bool isDefaultRoot = false;
+  char *rootStr = getenv("MDV_TIME_INDEX_DIR");
+  if (rootStr != NULL && strlen(rootStr) > 0) {
+    root = rootStr;
+  } else {
+    char defaultRoot[256];
+    snprintf(defaultRoot, sizeof(defaultRoot),
+             "/tmp/mdvx_time_index.%d", (int) geteuid());
+    root = defaultRoot;
+    isDefaultRoot = true;
+  }
+  if (isDefaultRoot && _checkRoot(root)) {
+    return -1;
+  }
+
+  // absolute day dir
+
+  string absDayDir(dayDir);
+  if (absDayDir.size() == 0 || absDayDir[0] != '/') {
+    char cwd[MAX_PATH_LEN];
+    if (getcwd(cwd, MAX_PATH_LEN) == NULL) {
+      return -1;
+    }
+    absDayDir = string(cwd) + PATH_DELIM + absDayDir;
+  }
+
+  indexDir = root + absDayDir;
+  Path ipath(indexDir, FILE_NAME);
+  path = ipath.getPath();
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////////////
+// Check the default index root - it must be a directory owned by
+// this user, and not writable by others, so that other users
+// cannot plant an index which hides files.
+// The root is created with mode 0700 if it does not exist.
+// Returns 0 if the root is usable, -1 otherwise.
+
+int MdvxTimeIndex::_checkRoot(const string &root)
+
+{
+
+  mkdir(root.c_str(), 0700);
+
+  struct stat rstat;
+  if (lstat(root.c_str(), &rstat)) {
+    return -1;
+  }
+  if (!S_ISDIR(rstat.st_mode) ||
+      rstat.st_uid != geteuid() ||
+      (rstat.st_mode & (S_IWGRP | S_IWOTH))) {
+    return -1;
+  }
+
+  return 0;
+
+}
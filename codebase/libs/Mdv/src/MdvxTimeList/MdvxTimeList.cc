@@ -34,6 +34,7 @@
 //////////////////////////////////////////////////////////
 
 #include <Mdv/MdvxTimeList.hh>
+#include <Mdv/MdvxTimeIndex.hh>
 #include <Mdv/Mdvx.hh>
 #include <toolsa/TaStr.hh>
 #include <toolsa/file_io.h>
@@ -59,6 +60,7 @@ MdvxTimeList::MdvxTimeList()
   clearCheckLatestValidModTime();
   clearConstrainFcastLeadTimes();
   clearValidTimeSearchWt();
+  _useTimeIndex = MdvxTimeIndex::isEnabled();
 }
 
 /////////////////////////////////////////////////////////////////
@@ -1194,6 +1196,15 @@ void MdvxTimeList::_searchDayForValid(const string &dayDir,
   
 {
 
+  // use the time index if possible
+
+  if (_useTimeIndex && !_hasForecasts && !_checkLatestValidModTime) {
+    if (_searchDayIndexForValid(dayDir, midday, checkTimeRange,
+                                startTime, endTime, timePaths) == 0) {
+      return;
+    }
+  }
+
   ReadDir rdir;
   if (rdir.open(dayDir.c_str()) == 0) {
     
@@ -1226,6 +1237,89 @@ void MdvxTimeList::_searchDayForValid(const string &dayDir,
   
 }
 
+///////////////////////////////////////////////////
+// Search a day directory for valid files, using the time index.
+// If the index is missing or stale, the directory is scanned
+// and the index is rewritten.
+//
+// The index holds every entry with a valid time in its name, so
+// the file checks are applied to the entries in the time range
+// each time the index is used. A file which is still being
+// written when the index is built is then found once complete.
+//
+// Returns 0 on success, -1 if the index should not be used for
+// this directory, in which case the caller scans it.
+
+int MdvxTimeList::_searchDayIndexForValid(const string &dayDir,
+                                           const DateTime &midday,
+                                           bool checkTimeRange,
+                                           time_t startTime,
+                                           time_t endTime,
+                                           TimePathSet &timePaths)
+  
+{
+
+  MdvxTimeIndex index(dayDir);
+
+  if (index.load()) {
+
+    // No index, or stale. If the directory is being written,
+    // a new index would soon be stale, so use a plain scan.
+
+    if (MdvxTimeIndex::isActive(dayDir)) {
+      return -1;
+    }
+
+    // read all entry names in the directory
+
+    index.startScan();
+    ReadDir rdir;
+    if (rdir.open(dayDir.c_str())) {
+      return 0;
+    }
+    vector<MdvxTimeIndex::Entry> entries;
+    struct dirent *dp;
+    for (dp = rdir.read(); dp != NULL; dp = rdir.read()) {
+      if (dp->d_name[0] == '.') {
+	continue;
+      }
+      time_t validTime;
+      if (_getValidTime(midday, dp->d_name, validTime) == 0) {
+        entries.push_back(MdvxTimeIndex::Entry(validTime, 0, dp->d_name));
+      }
+    } // dp
+    rdir.close();
+
+    // rewrite the index - this may fail if the index dir
+    // is not writable, in which case we use the entries anyway
+
+    index.setEntries(entries);
+    index.write();
+
+  }
+
+  // add the valid files in the time range
+
+  vector<MdvxTimeIndex::Entry> entries;
+  if (checkTimeRange) {
+    index.getRange(startTime, endTime, entries);
+  } else {
+    entries = index.getEntries();
+  }
+  for (size_t ii = 0; ii < entries.size(); ii++) {
+    Path fpath(dayDir, entries[ii].name);
+    if (!_validFile(fpath.getPath())) {
+      continue;
+    }
+    TimePath tpath(entries[ii].validTime, entries[ii].genTime,
+                   fpath.getPath());
+    timePaths.insert(timePaths.end(), tpath);
+  }
+
+  return 0;
+
+}
+
 ///////////////////////////////////////////////////
 // Search a day directory for generate sub-dirs
 
@@ -1265,22 +1359,19 @@ void MdvxTimeList::_searchDayGen(const string &dayDir,
 }
 
 ///////////////////////////////////////////////////
-// add valid time
+// get the valid time from a day dir entry name.
+// Returns 0 on success, -1 if the name has no valid time.
 
-void MdvxTimeList::_addValid(const string &dayDir,
-			     const DateTime &midday,
-			     const string &entryName,
-			     bool checkTimeRange,
-			     time_t startTime,
-			     time_t endTime,
-			     TimePathSet &timePaths)
+int MdvxTimeList::_getValidTime(const DateTime &midday,
+                                const string &entryName,
+                                time_t &entryTime)
   
 {
 
   // exclude entry names which are too short
   
   if (entryName.size() < 6) {
-    return;
+    return -1;
   }
 
   // find first digit in entry name - if no digits, return now
@@ -1292,11 +1383,11 @@ void MdvxTimeList::_addValid(const string &dayDir,
       break;
     }
   }
-  if (!start) return;
+  if (!start) return -1;
   
   // get time
 
-  time_t entryTime = 0;
+  entryTime = 0;
   int year, month, day, hour, min, sec;
   const char *end = start + strlen(start);
   char spacer;
@@ -1305,11 +1396,11 @@ void MdvxTimeList::_addValid(const string &dayDir,
       // dorade sweep file
       DateTime doradeTime;
       if (getDoradeTime(entryName, doradeTime)) {
-        return;
+        return -1;
       }
       // do not include IDLE files
       if (strstr(entryName.c_str(), "IDL") != NULL) {
-        return;
+        return -1;
       }
       entryTime = doradeTime.utime();
       break;
@@ -1319,10 +1410,10 @@ void MdvxTimeList::_addValid(const string &dayDir,
       if ((sscanf(start, "%4d%2d%2d%2d%2d",
                   &year, &month, &day, &hour, &min) == 5)) {
         if (year < 1900 || month < 1 || month > 12 || day < 1 || day > 31) {
-          return;
+          return -1;
         }
         if (hour < 0 || hour > 23 || min < 0 || min > 59) {
-          return;
+          return -1;
         }
         DateTime etime(year, month, day, hour, min, 0);
         entryTime = etime.utime();
@@ -1335,10 +1426,10 @@ void MdvxTimeList::_addValid(const string &dayDir,
                   &year, &month, &day, &hour, &min, &sec) == 6)) {
         year += 1900;
         if (month < 1 || month > 12 || day < 1 || day > 31) {
-          return;
+          return -1;
         }
         if (hour < 0 || hour > 23 || min < 0 || min > 59 || sec < 0 || sec > 59) {
-          return;
+          return -1;
         }
         DateTime etime(year, month, day, hour, min, 0);
         entryTime = etime.utime();
@@ -1348,10 +1439,10 @@ void MdvxTimeList::_addValid(const string &dayDir,
                        &year, &month, &day, &spacer, &hour, &min, &sec) == 7)) {
       // format - yyyymmdd?hhmmss
       if (year < 1900 || month < 1 || month > 12 || day < 1 || day > 31) {
-        return;
+        return -1;
       }
       if (hour < 0 || hour > 23 || min < 0 || min > 59 || sec < 0 || sec > 59) {
-        return;
+        return -1;
       }
       DateTime etime(year, month, day, hour, min, sec);
       entryTime = etime.utime();
@@ -1359,7 +1450,7 @@ void MdvxTimeList::_addValid(const string &dayDir,
     } else if (sscanf(start, "%2d%2d%2d", &hour, &min, &sec) == 3) {
       // normal format - yyyymmdd/hhmmss
       if (hour < 0 || hour > 23 || min < 0 || min > 59 || sec < 0 || sec > 59) {
-        return;
+        return -1;
       }
       DateTime etime(midday);
       etime.setTime(hour, min, sec);
@@ -1370,6 +1461,30 @@ void MdvxTimeList::_addValid(const string &dayDir,
   }
 
   if (entryTime == 0) {
+    return -1;
+  }
+
+  return 0;
+
+}
+
+///////////////////////////////////////////////////
+// add valid time
+
+void MdvxTimeList::_addValid(const string &dayDir,
+			     const DateTime &midday,
+			     const string &entryName,
+			     bool checkTimeRange,
+			     time_t startTime,
+			     time_t endTime,
+			     TimePathSet &timePaths)
+  
+{
+
+  // get time
+
+  time_t entryTime;
+  if (_getValidTime(midday, entryName, entryTime)) {
     return;
   }
 	
@@ -0,0 +1,224 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+// ** Copyright UCAR (c) 1990 - 2016
+// ** University Corporation for Atmospheric Research (UCAR)
+// ** National Center for Atmospheric Research (NCAR)
+// ** Boulder, Colorado, USA
+// ** BSD licence applies - redistribution and use in source and binary
+// ** forms, with or without modification, are permitted provided that
+// ** the following conditions are met:
+// ** 1) If the software is modified to produce derivative works,
+// ** such modified software should be clearly marked, so as not
+// ** to confuse it with the version available from UCAR.
+// ** 2) Redistributions of source code must retain the above copyright
+// ** notice, this list of conditions and the following disclaimer.
+// ** 3) Redistributions in binary form must reproduce the above copyright
+// ** notice, this list of conditions and the following disclaimer in the
+// ** documentation and/or other materials provided with the distribution.
+// ** 4) Neither the name of UCAR nor the names of its contributors,
+// ** if any, may be used to endorse or promote products derived from
+// ** this software without specific prior written permission.
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*
+////////////////////////////////////////////////////////////////////
+// Mdv/MdvxTimeIndex.hh
+//
+// Time index for a single MDV day directory.
+//
+// The index is an ASCII file holding one line per entry in the
+// day directory whose name contains a valid time:
+//
+//   valid_time gen_time file_name
+//
+// sorted by valid time. It allows MdvxTimeList to find the files
+// in a time range with a binary search, instead of reading the
+// directory and parsing every file name.
+//
+// The entries are not filtered on the file type or size. Files
+// being written in place, for example by cp, may be too small to
+// use when the index is built, and writing to an existing file
+// does not change the directory modify time. MdvxTimeList checks
+// the files in the requested time range each time it uses the
+// index.
+//
+// The index is kept outside the data tree, so that building it
+// does not change the day directory, and so that clients without
+// write access to the data can keep an index. The index for day
+// directory /path/yyyymmdd is:
+//
+//   index_root/path/yyyymmdd/.mdvx_time_index
+//
+// where index_root is set by the environment variable
+// MDV_TIME_INDEX_DIR, and defaults to /tmp/mdvx_time_index.uid,
+// with uid the user id. The default root must be owned by the user,
+// and is created with mode 0700. The index files are small, and may
+// be removed at any time, for example by a tmp cleaner - they are
+// rebuilt on the next read.
+//
+// The index records the device, inode and modify time of the day
+// directory, taken just before the directory is read. The index is
+// fresh only while the day directory still has exactly that state.
+// Any file added, removed or renamed in the day directory after
+// the scan started, by any process, changes the directory modify
+// time, so the index becomes stale. So does replacing the directory,
+// even if its modify time is restored, for example by rsync or tar.
+// The index is not written if the directory was modified within a
+// second of the start of the scan, since a later change could then
+// leave the same modify time on file systems with 1 sec time stamps,
+// or kernels which stamp files from a coarse clock.
+// A stale index makes load() fail, and the caller should scan the
+// directory and rewrite the index.
+//
+// Writers do not update the index, since a writer cannot tell
+// whether other processes changed the directory at the same time.
+// Instead, a directory modified within the last ACTIVE_SECS is
+// treated as active, and is searched without the index - see
+// isActive(). Rebuilding the index after every write would cost
+// more than the plain search. Once the directory has been quiet
+// for ACTIVE_SECS, the index is rebuilt on the next read.
+//
+// Only flat (non-forecast) day directories are indexed.
+//
+// Indexing may be turned off by setting the environment variable
+// MDV_USE_TIME_INDEX to FALSE.
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef MdvxTimeIndex_hh
+#define MdvxTimeIndex_hh
+
+#include <string>
+#include <vector>
+#include <ctime>
+using namespace std;
+
+class MdvxTimeIndex
+{
+
+public:
+
+  // name of index file
+
+  static const char *FILE_NAME;
+
+  // a day dir modified within this time is not indexed
+
+  static const int ACTIVE_SECS = 60;
+
+  // index entry
+
+  class Entry {
+  public:
+    time_t validTime;
+    time_t genTime;
+    string name; // file name relative to day dir
+    Entry() : validTime(0), genTime(0) {}
+    Entry(time_t v, time_t g, const string &n) :
+      validTime(v), genTime(g), name(n) {}
+    bool operator<(const Entry &other) const {
+      if (validTime != other.validTime) {
+        return validTime < other.validTime;
+      }
+      if (genTime != other.genTime) {
+        return genTime < other.genTime;
+      }
+      return name < other.name;
+    }
+    bool operator==(const Entry &other) const {
+      return (validTime == other.validTime &&
+              genTime == other.genTime &&
+              name == other.name);
+    }
+  };
+
+  // constructor - specify the day directory
+
+  MdvxTimeIndex(const string &dayDir);
+
+  // destructor
+
+  ~MdvxTimeIndex();
+
+  // load the index for the day directory.
+  // Returns 0 on success, -1 if the index does not exist,
+  // is stale or cannot be read.
+
+  int load();
+
+  // set the entries, prior to writing
+
+  void setEntries(const vector<Entry> &entries);
+
+  // Record the start time of a directory scan, and the state of
+  // the day dir. Call this before reading the day directory to
+  // rebuild the index.
+
+  void startScan();
+
+  // write the index for the day directory.
+  // The index is written to a tmp file and then renamed.
+  // It holds the day dir state from startScan().
+  // Returns 0 on success, -1 on failure.
+
+  int write();
+
+  // get entries with valid times between start and end, inclusive
+
+  void getRange(time_t startTime, time_t endTime,
+                vector<Entry> &entries) const;
+
+  // get all entries, sorted by valid time
+
+  const vector<Entry> &getEntries() const { return _entries; }
+
+  // get the index path - empty if there is no usable index root
+
+  const string &getPath() const { return _path; }
+
+  // Check if the day dir is active, i.e. it was modified within
+  // the last ACTIVE_SECS, or has a modify time in the future.
+
+  static bool isActive(const string &dayDir);
+
+  // get the modify time of a file or dir, with sub-second precision
+  // Returns 0 on success, -1 on failure.
+
+  static int getModTime(const string &path, struct timespec &mtime);
+
+  // is indexing enabled? Checks the MDV_USE_TIME_INDEX env var.
+
+  static bool isEnabled();
+
+protected:
+private:
+
+  // state of the day dir
+
+  typedef struct {
+    unsigned long dev;
+    unsigned long ino;
+    struct timespec mtime;
+  } dir_state_t;
+
+  string _dayDir;
+  string _indexDir;
+  string _path;
+  struct timespec _scanStart;
+  dir_state_t _scanDirState;
+  vector<Entry> _entries;
+
+  static int _getDirState(const string &dayDir, dir_state_t &state);
+  static string _encodeDirState(const dir_state_t &state);
+  static int _decodeDirState(const char *line, dir_state_t &state);
+  static bool _dirStatesEqual(const dir_state_t &aa,
+                              const dir_state_t &bb);
+
+  static int _computePath(const string &dayDir,
+                          string &indexDir, string &path);
+
+  static int _checkRoot(const string &root);
+
+};
+
+#endif
@@ -268,6 +268,14 @@ public:
   
   void clearConstrainFcastLeadTimes();
   
+  /////////////////////////////////////////////////////////////////
+  // Use the per-day time index files to find valid times, if
+  // possible. See MdvxTimeIndex. Only applies to non-forecast data.
+  // Default is true, unless MDV_USE_TIME_INDEX is set to FALSE.
+
+  void setUseTimeIndex(bool state) { _useTimeIndex = state; }
+  bool getUseTimeIndex() const { return _useTimeIndex; }
+  
   ///////////////////////////////////////////////////////////
   // Set the weight given to valid time differences, over gen
   // time differences, when searching for the best forecast
@@ -410,6 +418,8 @@ private:
 
   double _validTimeSearchWt;
 
+  bool _useTimeIndex;
+
   vector<time_t> _validTimes;
   vector<time_t> _genTimes;
   vector<string> _pathList;
@@ -453,6 +463,13 @@ private:
 			  time_t endTime,
 			  TimePathSet &timePaths);
   
+  int _searchDayIndexForValid(const string &dayDir,
+                              const DateTime &midday,
+                              bool checkTimeRange,
+                              time_t startTime,
+                              time_t endTime,
+                              TimePathSet &timePaths);
+  
   void _searchDayGen(const string &dayDir,
 		     const DateTime &midday,
 		     bool checkTimeRange,
@@ -460,6 +477,10 @@ private:
 		     time_t endTime,
 		     TimePathSet &timePaths);
   
+  int _getValidTime(const DateTime &midday,
+                    const string &entryName,
+                    time_t &entryTime);
+
   void _addValid(const string &dir,
 		 const DateTime &midday,
 		 const string &fileName,
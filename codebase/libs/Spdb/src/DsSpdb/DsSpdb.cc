@@ -178,6 +178,9 @@ void DsSpdb::setLimitsInMsg(DsSpdbMsg &msg)
   if (_vertLimitsSet) {
     msg.setVertLimits(_minHt, _maxHt);
   }
+  if (_bboxOnGet) {
+    msg.setBboxOnGet(_getMinLat, _getMinLon, _getMaxLat, _getMaxLon);
+  }
 
 }  
 
@@ -1210,6 +1213,14 @@ int DsSpdb::doMsgGet(const DsSpdbMsg &inMsg, DsSpdbMsg::info_t &getInfo)
     clearVertLimits();
   }
 
+  // bounding box - if not in the message, leave any box set
+  // by the server itself
+
+  if (inMsg.bboxOnGetSet()) {
+    const DsSpdbMsg::horiz_limits_t &bbox = inMsg.getBboxOnGet();
+    setBboxOnGet(bbox.min_lat, bbox.min_lon, bbox.max_lat, bbox.max_lon);
+  }
+
   // perform the get specified by the mode
 
   switch (inMsg.getMode()) {
@@ -61,6 +61,9 @@ DsSpdbMsg::DsSpdbMsg(memModel_t mem_model /* = CopyMem */ ) :
   MEM_zero(_vertLimits);
   _horizLimitsSet = false;
   _vertLimitsSet = false;
+  MEM_zero(_bboxOnGet);
+  _bboxOnGetSet = false;
+  _compressCtx = NULL;
   clearData();
 }
 
@@ -71,6 +74,7 @@ DsSpdbMsg::DsSpdbMsg(memModel_t mem_model /* = CopyMem */ ) :
 DsSpdbMsg::DsSpdbMsg(const DsSpdbMsg &rhs)
 
 {
+  _compressCtx = NULL;
   if (this != &rhs) {
     _copy(rhs);
   }
@@ -82,6 +86,9 @@ DsSpdbMsg::DsSpdbMsg(const DsSpdbMsg &rhs)
 DsSpdbMsg::~DsSpdbMsg()
 
 {
+  if (_compressCtx) {
+    ta_compress_ctx_free(_compressCtx);
+  }
 }
 
 //////////////////////////////
@@ -924,6 +931,12 @@ int DsSpdbMsg::disassemble(const void *in_msg, ssize_t msg_len,
     BE_to_array_32(&_horizLimits, sizeof(_horizLimits));
     _horizLimitsSet = true;
   }
+  if (partExists(DS_SPDB_BBOX_ON_GET_PART)) {
+    memcpy(&_bboxOnGet, getPartByType(DS_SPDB_BBOX_ON_GET_PART)->getBuf(),
+	   sizeof(horiz_limits_t));
+    BE_to_array_32(&_bboxOnGet, sizeof(_bboxOnGet));
+    _bboxOnGetSet = true;
+  }
   if (partExists(DS_SPDB_VERT_LIMITS_PART)) {
     memcpy(&_vertLimits, getPartByType(DS_SPDB_VERT_LIMITS_PART)->getBuf(),
 	   sizeof(vert_limits_t));
@@ -1010,26 +1023,26 @@ void DsSpdbMsg::compressDataBuf(Spdb::compression_t compression)
     compress_method = TA_COMPRESSION_BZIP;
   }
   
-  // compress
+  // compress into the work buffer, reusing the context,
+  // then swap it with the data buffer
 
+  if (_compressCtx == NULL) {
+    _compressCtx = ta_compress_ctx_create();
+  }
+  ui64 blen = ta_compress_bound(compress_method, _dataBuf.getLen());
+  void *compressed = _workBuf.reserve(blen);
   ui64 nbytesCompressed;
-  void *compressedData = ta_compress(compress_method,
-                                     _dataBuf.getPtr(),
-                                     _dataBuf.getLen(),
-                                     &nbytesCompressed);
-  if (compressedData == NULL) {
+  if (ta_compress_buf(_compressCtx, compress_method,
+                      _dataBuf.getPtr(), _dataBuf.getLen(),
+                      compressed, blen, &nbytesCompressed)) {
     // failed to compress
     return;
   }
 
   // success
 
-  _dataBuf.free();
-  _dataBuf.add(compressedData, nbytesCompressed);
-  
-  // free up
-
-  ta_compress_free(compressedData);
+  _workBuf.reserve(nbytesCompressed);
+  _dataBuf.swap(_workBuf);
 
   // set compression status
 
@@ -1053,20 +1066,33 @@ void DsSpdbMsg::uncompressDataBuf()
     return;
   }
 
-  // uncompress
+  // uncompress into the work buffer, then swap it
+  // with the data buffer
 
-  ui64 nbytesUncompressed;
-  void *uncompressed  = ta_decompress(_dataBuf.getPtr(), &nbytesUncompressed);
-  if (uncompressed == NULL) {
+  if (_compressCtx == NULL) {
+    _compressCtx = ta_compress_ctx_create();
+  }
+  bool ok = ta_is_compressed(_dataBuf.getPtr(), _dataBuf.getLen());
+  ui64 nbytesUncompressed = 0;
+  if (ok) {
+    nbytesUncompressed = ta_decompress_len(_dataBuf.getPtr());
+  }
+  void *uncompressed = _workBuf.reserve(nbytesUncompressed);
+  if (ok && nbytesUncompressed > 0 &&
+      ta_decompress_buf(_compressCtx, _dataBuf.getPtr(),
+                        uncompressed, nbytesUncompressed,
+                        &nbytesUncompressed)) {
+    ok = false;
+  }
+  if (!ok) {
     cerr << "WARNING - DsSpdbMsg::uncompressDataBuf" << endl;
     cerr << "  Cannot uncompress data buffer" << endl;
     _info2.data_buf_compression = Spdb::COMPRESSION_NONE;
     return;
   }
 
-  _dataBuf.free();
-  _dataBuf.add(uncompressed, nbytesUncompressed);
-  ta_compress_free(uncompressed);
+  _workBuf.reserve(nbytesUncompressed);
+  _dataBuf.swap(_workBuf);
 
   // set compression status
 
@@ -1209,6 +1235,13 @@ void DsSpdbMsg::print(ostream &out, const char *spacer) const
         out << spacer << "    Max lat: " << _horizLimits.max_lat << endl;
         out << spacer << "    Max lon: " << _horizLimits.max_lon << endl;
       }
+      if (_bboxOnGetSet) {
+        out << spacer << "  Bbox on get:" << endl;
+        out << spacer << "    Min lat: " << _bboxOnGet.min_lat << endl;
+        out << spacer << "    Min lon: " << _bboxOnGet.min_lon << endl;
+        out << spacer << "    Max lat: " << _bboxOnGet.max_lat << endl;
+        out << spacer << "    Max lon: " << _bboxOnGet.max_lon << endl;
+      }
       if (_vertLimitsSet) {
         out << spacer << "  Vert limits:" << endl;
         out << spacer << "    Min ht: " << _vertLimits.min_ht << endl;
@@ -1330,6 +1363,14 @@ void *DsSpdbMsg::_assembleGet(const mode_enum_t request_mode)
     addPart(DS_SPDB_HORIZ_LIMITS_PART, sizeof(hlimits), &hlimits);
   }
 
+  // bounding box for chunk selection
+
+  if (_bboxOnGetSet) {
+    horiz_limits_t bbox = _bboxOnGet;
+    BE_from_array_32(&bbox, sizeof(bbox));
+    addPart(DS_SPDB_BBOX_ON_GET_PART, sizeof(bbox), &bbox);
+  }
+
   // vertical limits
 
   if (_vertLimitsSet) {
@@ -1462,6 +1503,31 @@ void DsSpdbMsg::clearHorizLimits()
   _horizLimitsSet = false;
 }
 
+/////////////////////////////////////////////
+// set or clear bounding box for get requests
+//
+// Chunks whose stored bounding box does not overlap
+// this box are not returned.
+  
+void DsSpdbMsg::setBboxOnGet(double min_lat,
+                             double min_lon,
+                             double max_lat,
+                             double max_lon)
+  
+{
+  _bboxOnGet.min_lat = min_lat;
+  _bboxOnGet.min_lon = min_lon;
+  _bboxOnGet.max_lat = max_lat;
+  _bboxOnGet.max_lon = max_lon;
+  _bboxOnGetSet = true;
+}
+
+void DsSpdbMsg::clearBboxOnGet()
+  
+{
+  _bboxOnGetSet = false;
+}
+
 ///////////////////////////////
 // set or clear vertical limits
 //
@@ -1601,6 +1667,8 @@ string DsSpdbMsg::part2Str(int part)
       return "DS_SPDB_AUX_REF_PART";
     case DS_SPDB_AUX_XML_PART:
       return "DS_SPDB_AUX_XML_PART";
+    case DS_SPDB_BBOX_ON_GET_PART:
+      return "DS_SPDB_BBOX_ON_GET_PART";
     default:
       return "UNKNOWN"; 
   }
@@ -1634,6 +1702,8 @@ DsSpdbMsg &DsSpdbMsg::_copy(const DsSpdbMsg &rhs)
   _vertLimits = rhs._vertLimits;
   _horizLimitsSet = rhs._horizLimitsSet;
   _vertLimitsSet = rhs._vertLimitsSet;
+  _bboxOnGet = rhs._bboxOnGet;
+  _bboxOnGetSet = rhs._bboxOnGetSet;
   _refBuf = rhs._refBuf;
   _auxBuf = rhs._auxBuf;
   _dataBuf = rhs._dataBuf;
@@ -73,6 +73,7 @@ DsSymprodServer::DsSymprodServer(const string &prog_name,
   _horizLimitsSet = false;
   _vertLimitsSet = false;
   _unique = Spdb::UniqueOff;
+  _bboxFromHorizLimits = false;
 }
 
 /////////////////////////////////////////////////////////
@@ -279,6 +280,14 @@ int DsSymprodServer::_handleGet(const void *localParams,
   DsSpdb spdb;
   DsSpdbMsg replyMsg;
 
+  // constrain the get to the horizontal limits, if requested.
+  // The box may not cross the date line.
+
+  if (_bboxFromHorizLimits && _horizLimitsSet &&
+      _minLon <= _maxLon && _minLon >= -180.0 && _maxLon <= 180.0) {
+    spdb.setBboxOnGet(_minLat, _minLon, _maxLat, _maxLon);
+  }
+
   if (spdb.doMsgGet(inMsg, getInfo)) {
     
     string errStr = "ERROR - DsSypmrodServer::_handleGet()\n";
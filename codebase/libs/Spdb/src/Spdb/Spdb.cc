@@ -37,6 +37,7 @@
 ////////////////////////////////////////////////////////////////
 
 #include <Spdb/Spdb.hh>
+#include <Spdb/SpdbIndexCache.hh>
 #include <dataport/bigend.h>
 #include <toolsa/file_io.h>
 #include <toolsa/TaFile.hh>
@@ -50,11 +51,15 @@
 #include <didss/RapDataDir.hh>
 #include <iostream>
 #include <iomanip>
+#include <cmath>
 #include <unistd.h>
 #include <fcntl.h>
 #include <cerrno>
 #include <sys/stat.h>
 #include <set>
+#include <map>
+#include <algorithm>
+#include <sys/time.h>
 using namespace std;
 
 // initialize constants
@@ -63,6 +68,7 @@ int Spdb::_fileMajorVersion = 1;
 int Spdb::_fileMinorVersion = 1;
 const char *Spdb::_indxExt = "indx";
 const char *Spdb::_dataExt = "data";
+const char *Spdb::_jrnlExt = "jrnl";
 
 ////////////////////////////////////////////////////////////
 // Constructor
@@ -79,12 +85,25 @@ Spdb::Spdb() :
         _nGetChunks(0),
         _checkWriteTimeOnGet(false),
         _latestValidWriteTime(0),
+        _bboxOnGet(false),
+        _getMinLat(0.0),
+        _getMinLon(0.0),
+        _getMaxLat(0.0),
+        _getMaxLon(0.0),
 
         _putMode(putModeOver),
         _nPutChunks(0),
         _latestValidTimePut(0),
         _leadTimeStorage(LEAD_TIME_NOT_APPLICABLE),
 
+        _groupMaxChunks(0),
+        _groupMaxMsecs(0),
+        _groupProdId(0),
+        _groupLatestValid(0),
+        _groupMaxDataType(0),
+        _groupMaxDataType2(0),
+        _journalApplied(false),
+
         _chunkCompressOnPut(COMPRESSION_NONE),
         _chunkUncompressOnGet(true),
 
@@ -108,6 +127,7 @@ Spdb::Spdb() :
 
   MEM_zero(_indxPath);
   MEM_zero(_dataPath);
+  MEM_zero(_jrnlPath);
   MEM_zero(_lockPath);
   MEM_zero(_hdr);
 
@@ -119,6 +139,7 @@ Spdb::Spdb() :
 Spdb::~Spdb()
 
 {
+  flushPuts();
   _closeFiles();
 }
 
@@ -130,6 +151,23 @@ void Spdb::setPutMode(const put_mode_t mode)
   _putMode = mode;
 }
 
+////////////////////////////////////////////////////
+// Group commit for high-rate puts.
+// See Spdb.hh for details.
+
+void Spdb::setPutGroupCommit(int max_chunks, int max_msecs)
+{
+  _groupMaxChunks = max_chunks;
+  _groupMaxMsecs = max_msecs;
+}
+
+void Spdb::clearPutGroupCommit()
+{
+  flushPuts();
+  _groupMaxChunks = 0;
+  _groupMaxMsecs = 0;
+}
+
 ////////////////////////////////////////////////////
 // set the lead time storage
 // If you are dealing with forecast data, you may wish to store
@@ -216,38 +254,39 @@ void Spdb::addPutChunk(int data_type,
     return;
   }
 
-  // handle compression if required
-
-  void *compressedBuf = NULL;
-  ui64 nbytesCompressed = chunk_len;
-  
-  if (_chunkCompressOnPut == COMPRESSION_GZIP) {
-    compressedBuf = ta_compress(TA_COMPRESSION_GZIP,
-                                chunk_data,
-                                chunk_len,
-                                &nbytesCompressed);
-  } else if (_chunkCompressOnPut == COMPRESSION_BZIP2) {
-    compressedBuf = ta_compress(TA_COMPRESSION_BZIP,
-                                chunk_data,
-                                chunk_len,
-                                &nbytesCompressed);
-  }
+  // handle compression if required - the chunk is compressed
+  // straight onto the end of the put data buffer
 
-  // ignore compression if it does not reduce the data size
+  ui64 offset = _putDataBuf.getLen();
+  ui64 nbytesCompressed = 0;
+  bool compressed = false;
 
-  if (compressedBuf != NULL &&
-      nbytesCompressed >= (unsigned int) chunk_len) {
-    ta_compress_free(compressedBuf);
-    compressedBuf = NULL;
+  if (_chunkCompressOnPut == COMPRESSION_GZIP ||
+      _chunkCompressOnPut == COMPRESSION_BZIP2) {
+    ta_compression_method_t method = TA_COMPRESSION_GZIP;
+    if (_chunkCompressOnPut == COMPRESSION_BZIP2) {
+      method = TA_COMPRESSION_BZIP;
+    }
+    ui64 blen = ta_compress_bound(method, chunk_len);
+    char *out = (char *) _putDataBuf.prepare(offset + blen) + offset;
+    if (ta_compress_buf(_getCompressCtx(), method,
+                        chunk_data, chunk_len,
+                        out, blen, &nbytesCompressed) == 0 &&
+        nbytesCompressed < (ui64) chunk_len) {
+      // only keep the compressed data if it reduces the size
+      compressed = true;
+    }
   }
 
-  // set len and pointer to data
+  // set len, and add the data if it was not compressed
 
   int storedLen = chunk_len;
-  const void *data = chunk_data;
-  if (compressedBuf != NULL) {
+  if (compressed) {
     storedLen = nbytesCompressed;
-    data = compressedBuf;
+    _putDataBuf.prepare(offset + nbytesCompressed);
+  } else {
+    _putDataBuf.prepare(offset);
+    _putDataBuf.add(chunk_data, chunk_len);
   }
   
   // load ref
@@ -258,14 +297,14 @@ void Spdb::addPutChunk(int data_type,
   ref.valid_time = valid_time;
   ref.expire_time = expire_time;
   ref.len = storedLen;
-  ref.offset = _putDataBuf.getLen();
+  ref.offset = offset;
 
   // load auxiliary ref
 
   aux_ref_t aux;
   MEM_zero(aux);
   aux.write_time = (ti32) time(NULL);
-  if (compressedBuf != NULL) {
+  if (compressed) {
     aux.compression = _chunkCompressOnPut;
   }
 
@@ -282,13 +321,6 @@ void Spdb::addPutChunk(int data_type,
   _nPutChunks++;
   _putRefBuf.add(&ref, sizeof(chunk_ref_t));
   _putAuxBuf.add(&aux, sizeof(aux_ref_t));
-  _putDataBuf.add(data, storedLen);
-
-  // free up as required
-
-  if (compressedBuf != NULL) {
-    ta_compress_free(compressedBuf);
-  }
 
 }
 
@@ -318,6 +350,80 @@ void Spdb::addPutChunks(int n_chunks,
   
 }
 
+//////////////////////////////////////////////////////////////
+// Set the lat/lon bounding box for the chunk most recently
+// added with addPutChunk().
+
+void Spdb::setPutChunkBbox(double min_lat, double min_lon,
+                           double max_lat, double max_lon)
+
+{
+  if (_nPutChunks < 1) {
+    return;
+  }
+  aux_ref_t *aux = (aux_ref_t *) _putAuxBuf.getPtr() + (_nPutChunks - 1);
+  setAuxBbox(*aux, min_lat, min_lon, max_lat, max_lon);
+}
+
+//////////////////////////////////////////////////////////////
+// Constrain gets to a lat/lon bounding box.
+
+void Spdb::setBboxOnGet(double min_lat, double min_lon,
+                        double max_lat, double max_lon)
+
+{
+  _bboxOnGet = true;
+  _getMinLat = min_lat;
+  _getMinLon = min_lon;
+  _getMaxLat = max_lat;
+  _getMaxLon = max_lon;
+}
+
+//////////////////////////////////////////////////////////////
+// Store the bounding box in the aux ref spares, rounding
+// outwards to the storage resolution.
+
+void Spdb::setAuxBbox(aux_ref_t &aux,
+                      double min_lat, double min_lon,
+                      double max_lat, double max_lon)
+
+{
+
+  si16 ilimits[4];
+  ilimits[0] = (si16) floor(min_lat * SPDB_BBOX_SCALE);
+  ilimits[1] = (si16) ceil(max_lat * SPDB_BBOX_SCALE);
+  ilimits[2] = (si16) floor(min_lon * SPDB_BBOX_SCALE);
+  ilimits[3] = (si16) ceil(max_lon * SPDB_BBOX_SCALE);
+
+  aux.spares[0] = SPDB_AUX_BBOX_FLAG;
+  aux.spares[1] = (((ui32) (ui16) ilimits[0]) << 16) | (ui16) ilimits[1];
+  aux.spares[2] = (((ui32) (ui16) ilimits[2]) << 16) | (ui16) ilimits[3];
+
+}
+
+//////////////////////////////////////////////////////////////
+// Retrieve the bounding box from the aux ref.
+// Returns false if the box is not set.
+
+bool Spdb::getAuxBbox(const aux_ref_t &aux,
+                      double &min_lat, double &min_lon,
+                      double &max_lat, double &max_lon)
+
+{
+
+  if (aux.spares[0] != SPDB_AUX_BBOX_FLAG) {
+    return false;
+  }
+
+  min_lat = (si16) (aux.spares[1] >> 16) / SPDB_BBOX_SCALE;
+  max_lat = (si16) (aux.spares[1] & 0xffff) / SPDB_BBOX_SCALE;
+  min_lon = (si16) (aux.spares[2] >> 16) / SPDB_BBOX_SCALE;
+  max_lon = (si16) (aux.spares[2] & 0xffff) / SPDB_BBOX_SCALE;
+
+  return true;
+
+}
+
 //////////////////////////////////////////////
 // Add chunks - used by server message classes
 // No change in compression.
@@ -394,13 +500,25 @@ int Spdb::put(const string &dir,
     return 0;
   }
 
+  // pending group commits are for a single dir and product
+
+  if (_groupDays.size() > 0 &&
+      (dir != _groupDir || prod_id != _groupProdId)) {
+    flushPuts();
+  }
+
   _clearErrStr();
   _errStr += "Spdb::put\n";
 
   _dir = dir;
   _setLock(WriteMode);
   
-  int iret = _put(prod_id, prod_label);
+  int iret;
+  if (_groupMaxChunks > 0 && _putMode == putModeAdd) {
+    iret = _appendPut(prod_id, prod_label);
+  } else {
+    iret = _put(prod_id, prod_label);
+  }
 
   _clearLock();
   return iret;
@@ -429,6 +547,380 @@ int Spdb::erase(const string &dir,
 
 }
 
+////////////////////////////////////////////////////
+// Merge journals from group-committed puts into the index.
+// Returns 0 on success, -1 on error
+
+int Spdb::flushPuts()
+
+{
+
+  if (_groupDays.size() == 0) {
+    return 0;
+  }
+
+  _clearErrStr();
+  _errStr += "Spdb::flushPuts\n";
+
+  _dir = _groupDir;
+  _setLock(WriteMode);
+
+  int iret = 0;
+  set<int> days = _groupDays;
+  for (set<int>::iterator ii = days.begin(); ii != days.end(); ii++) {
+    if (_commitJournal(*ii)) {
+      iret = -1;
+    }
+  }
+  _groupDays.clear();
+
+  _clearLock();
+  return iret;
+
+}
+
+////////////////////////////////////////////////////
+// Group-committed put.
+//
+// Append the chunks to the data file, and the refs to the
+// journal, for each day. Merge the journal into the index
+// if it is full or old enough.
+//
+// If the files for a day do not yet exist, or are compressed,
+// a normal put is done instead.
+//
+// Returns 0 on success, -1 on failure
+
+int Spdb::_appendPut(int prod_id,
+                     const string &prod_label)
+
+{
+
+  // sort the chunks by day
+
+  const chunk_ref_t *putRefs = (chunk_ref_t *) _putRefBuf.getPtr();
+  map<int, vector<int> > dayChunks;
+  for (int ii = 0; ii < _nPutChunks; ii++) {
+    dayChunks[putRefs[ii].valid_time / SECS_IN_DAY].push_back(ii);
+  }
+
+  // check that the files exist
+
+  RapDataDir.fillPath(_dir, _path);
+  map<int, vector<int> >::iterator it;
+  for (it = dayChunks.begin(); it != dayChunks.end(); it++) {
+    _computePaths(it->first * SECS_IN_DAY);
+    struct stat fileStat;
+    if (stat(_indxPath, &fileStat) ||
+        fileStat.st_size < (off_t) sizeof(header_t) ||
+        stat(_dataPath, &fileStat)) {
+      return _put(prod_id, prod_label);
+    }
+  }
+
+  _groupDir = _dir;
+  _groupProdId = prod_id;
+  _groupProdLabel = prod_label;
+
+  for (int ii = 0; ii < _nPutChunks; ii++) {
+    _groupLatestValid = MAX(_groupLatestValid,
+                            (time_t) putRefs[ii].valid_time);
+    _groupMaxDataType = MAX(_groupMaxDataType, putRefs[ii].data_type);
+    _groupMaxDataType2 = MAX(_groupMaxDataType2, putRefs[ii].data_type2);
+  }
+
+  // append to the journal for each day
+
+  for (it = dayChunks.begin(); it != dayChunks.end(); it++) {
+
+    int day = it->first;
+    _computePaths(day * SECS_IN_DAY);
+
+    int nPending = 0;
+    double ageMsecs = 0.0;
+    if (_appendToJournal(it->second, nPending, ageMsecs)) {
+      _errStr += "ERROR - Spdb::put\n";
+      _addStrErr("  Cannot append chunks in dir: ", _dir);
+      return -1;
+    }
+    _groupDays.insert(day);
+
+    if (nPending >= _groupMaxChunks || ageMsecs >= _groupMaxMsecs) {
+      if (_commitJournal(day)) {
+        return -1;
+      }
+    }
+
+  } // it
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////
+// Append chunks to the data file, and their refs to the
+// journal. The paths must be set for the day.
+//
+// Sets n_pending to the number of entries in the journal,
+// and age_msecs to the time since the first entry.
+//
+// Returns 0 on success, -1 on failure
+
+int Spdb::_appendToJournal(const vector<int> &chunk_indices,
+                           int &n_pending, double &age_msecs)
+
+{
+
+  struct timeval now;
+  gettimeofday(&now, NULL);
+
+  int jrnlFd = open(_jrnlPath, O_RDWR | O_CREAT, 0666);
+  if (jrnlFd < 0) {
+    int errNum = errno;
+    _errStr += "ERROR - Spdb::_appendToJournal\n";
+    _addStrErr("  Cannot open journal: ", _jrnlPath);
+    _addStrErr("  ", strerror(errNum));
+    return -1;
+  }
+
+  // read the journal header. If the journal is new, start it
+  // with the generation of the index.
+
+  journal_hdr_t jhdr;
+  struct stat jrnlStat;
+  off_t jrnlSize = 0;
+  if (fstat(jrnlFd, &jrnlStat) == 0 &&
+      jrnlStat.st_size >= (off_t) sizeof(jhdr) &&
+      pread(jrnlFd, &jhdr, sizeof(jhdr), 0) == (ssize_t) sizeof(jhdr)) {
+    BE_to_array_32(&jhdr, sizeof(jhdr));
+    if (jhdr.magic == SPDB_JOURNAL_MAGIC) {
+      jrnlSize = jrnlStat.st_size;
+    }
+  }
+
+  if (jrnlSize == 0) {
+    header_t ihdr;
+    int indxFd = open(_indxPath, O_RDONLY);
+    if (indxFd < 0 ||
+        pread(indxFd, &ihdr, sizeof(ihdr), 0) != (ssize_t) sizeof(ihdr)) {
+      _errStr += "ERROR - Spdb::_appendToJournal\n";
+      _addStrErr("  Cannot read index header: ", _indxPath);
+      if (indxFd >= 0) {
+        close(indxFd);
+      }
+      close(jrnlFd);
+      return -1;
+    }
+    close(indxFd);
+    BE_to_array_32(((char *) &ihdr + SPDB_LABEL_MAX),
+                   sizeof(header_t) - SPDB_LABEL_MAX);
+    MEM_zero(jhdr);
+    jhdr.magic = SPDB_JOURNAL_MAGIC;
+    jhdr.generation = ihdr.generation;
+    jhdr.start_time = now.tv_sec;
+    jhdr.start_usecs = now.tv_usec;
+    journal_hdr_t beHdr = jhdr;
+    BE_from_array_32(&beHdr, sizeof(beHdr));
+    if (ftruncate(jrnlFd, 0) ||
+        pwrite(jrnlFd, &beHdr, sizeof(beHdr), 0) != (ssize_t) sizeof(beHdr)) {
+      int errNum = errno;
+      _errStr += "ERROR - Spdb::_appendToJournal\n";
+      _addStrErr("  Cannot write journal: ", _jrnlPath);
+      _addStrErr("  ", strerror(errNum));
+      close(jrnlFd);
+      return -1;
+    }
+    jrnlSize = sizeof(beHdr);
+  }
+
+  // load the data, and the refs with the offsets in the data file
+
+  int dataFd = open(_dataPath, O_WRONLY);
+  if (dataFd < 0) {
+    int errNum = errno;
+    _errStr += "ERROR - Spdb::_appendToJournal\n";
+    _addStrErr("  Cannot open data file: ", _dataPath);
+    _addStrErr("  ", strerror(errNum));
+    close(jrnlFd);
+    return -1;
+  }
+  off_t dataOffset = lseek(dataFd, 0, SEEK_END);
+
+  const chunk_ref_t *putRefs = (chunk_ref_t *) _putRefBuf.getPtr();
+  const aux_ref_t *putAuxs = (aux_ref_t *) _putAuxBuf.getPtr();
+  const char *putData = (char *) _putDataBuf.getPtr();
+
+  MemBuf dataBuf;
+  MemBuf entryBuf;
+  for (size_t ii = 0; ii < chunk_indices.size(); ii++) {
+    int index = chunk_indices[ii];
+    chunk_ref_t ref = putRefs[index];
+    aux_ref_t aux = putAuxs[index];
+    dataBuf.add(putData + ref.offset, ref.len);
+    ref.offset = dataOffset + dataBuf.getLen() - ref.len;
+    chunk_refs_to_BE(&ref, 1);
+    aux_refs_to_BE(&aux, 1);
+    entryBuf.add(&ref, sizeof(ref));
+    entryBuf.add(&aux, sizeof(aux));
+  }
+
+  // write the data first, so that the journal never refers
+  // to data which is not there
+
+  if (write(dataFd, dataBuf.getPtr(), dataBuf.getLen()) !=
+      (ssize_t) dataBuf.getLen()) {
+    int errNum = errno;
+    _errStr += "ERROR - Spdb::_appendToJournal\n";
+    _addStrErr("  Cannot write data file: ", _dataPath);
+    _addStrErr("  ", strerror(errNum));
+    close(dataFd);
+    close(jrnlFd);
+    return -1;
+  }
+  close(dataFd);
+
+  if (pwrite(jrnlFd, entryBuf.getPtr(), entryBuf.getLen(), jrnlSize) !=
+      (ssize_t) entryBuf.getLen()) {
+    int errNum = errno;
+    _errStr += "ERROR - Spdb::_appendToJournal\n";
+    _addStrErr("  Cannot write journal: ", _jrnlPath);
+    _addStrErr("  ", strerror(errNum));
+    close(jrnlFd);
+    return -1;
+  }
+  close(jrnlFd);
+
+  jrnlSize += entryBuf.getLen();
+  n_pending = (jrnlSize - sizeof(jhdr)) /
+    (sizeof(chunk_ref_t) + sizeof(aux_ref_t));
+  age_msecs = (now.tv_sec - jhdr.start_time) * 1000.0 +
+    (now.tv_usec - jhdr.start_usecs) / 1000.0;
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////
+// Merge the journal for a day into the index.
+// Opening the files in write mode applies the journal,
+// and closing them writes the index and removes the journal.
+// Must be called with the lock set.
+//
+// Returns 0 on success, -1 on failure
+
+int Spdb::_commitJournal(int day)
+
+{
+
+  time_t midday = (time_t) day * SECS_IN_DAY + SECS_IN_DAY / 2;
+
+  if (_openFiles(_groupProdId, _groupProdLabel, midday, WriteMode)) {
+    _errStr += "ERROR - Spdb::_commitJournal\n";
+    _addStrErr("  Cannot open files in dir: ", _dir);
+    _addStrErr("  Time: ", utimstr(midday));
+    return -1;
+  }
+  _closeFiles();
+  _groupDays.erase(day);
+
+  _latestValidTimePut = _groupLatestValid;
+  if (_writeLdataInfo(_groupLatestValid,
+                      _groupMaxDataType, _groupMaxDataType2)) {
+    return -1;
+  }
+
+  if (_groupDays.size() == 0) {
+    _groupLatestValid = 0;
+    _groupMaxDataType = 0;
+    _groupMaxDataType2 = 0;
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////
+// Apply the journal for the open day, if there is one,
+// adding its chunk refs to the index.
+//
+// The journal is discarded if its generation does not match
+// that of the index - it has already been applied.
+// Sets _journalApplied, so that the journal is removed once
+// the index has been written.
+//
+// Returns 0 on success, -1 on failure
+
+int Spdb::_applyJournal()
+
+{
+
+  _journalApplied = false;
+
+  int jrnlFd = open(_jrnlPath, O_RDONLY);
+  if (jrnlFd < 0) {
+    // no journal
+    return 0;
+  }
+
+  _journalApplied = true;
+
+  journal_hdr_t jhdr;
+  struct stat jrnlStat;
+  if (fstat(jrnlFd, &jrnlStat) ||
+      jrnlStat.st_size < (off_t) sizeof(jhdr) ||
+      pread(jrnlFd, &jhdr, sizeof(jhdr), 0) != (ssize_t) sizeof(jhdr)) {
+    close(jrnlFd);
+    return 0;
+  }
+  BE_to_array_32(&jhdr, sizeof(jhdr));
+  if (jhdr.magic != SPDB_JOURNAL_MAGIC ||
+      jhdr.generation != _hdr.generation) {
+    close(jrnlFd);
+    return 0;
+  }
+
+  // read the entries - ignore a partial entry at the end
+
+  size_t entryLen = sizeof(chunk_ref_t) + sizeof(aux_ref_t);
+  int nEntries = (jrnlStat.st_size - sizeof(jhdr)) / entryLen;
+  MemBuf entryBuf;
+  char *entries = (char *) entryBuf.reserve(nEntries * entryLen);
+  if (pread(jrnlFd, entries, nEntries * entryLen, sizeof(jhdr)) !=
+      (ssize_t) (nEntries * entryLen)) {
+    int errNum = errno;
+    _errStr += "ERROR - Spdb::_applyJournal\n";
+    _addStrErr("  Cannot read journal: ", _jrnlPath);
+    _addStrErr("  ", strerror(errNum));
+    close(jrnlFd);
+    _journalApplied = false;
+    return -1;
+  }
+  close(jrnlFd);
+
+  struct stat dataStat;
+  off_t dataSize = 0;
+  if (fstat(_dataFd, &dataStat) == 0) {
+    dataSize = dataStat.st_size;
+  }
+
+  for (int ii = 0; ii < nEntries; ii++) {
+    chunk_ref_t ref;
+    aux_ref_t aux;
+    memcpy(&ref, entries + ii * entryLen, sizeof(ref));
+    memcpy(&aux, entries + ii * entryLen + sizeof(ref), sizeof(aux));
+    chunk_refs_from_BE(&ref, 1);
+    aux_refs_from_BE(&aux, 1);
+    if ((off_t) ref.offset + (off_t) ref.len > dataSize) {
+      continue;
+    }
+    _addChunkRef(ref, aux);
+    _updateHdrStats(ref);
+  }
+
+  return 0;
+
+}
+
 ///////////////////////////////////////////////////////////////////
 // Erase data for a given set of chunk refs.
 // Before calling this function, call clearPutChunks(),
@@ -1008,6 +1500,20 @@ int Spdb::_put(int prod_id,
   
   // write latest data info
 
+  return _writeLdataInfo(latestValidTime, maxDataType, maxDataType2);
+
+}
+
+////////////////////////////////////////////////////
+// write latest data info for a put
+// Returns 0 on success, -1 on failure
+
+int Spdb::_writeLdataInfo(time_t latestValidTime,
+                          int maxDataType,
+                          int maxDataType2)
+
+{
+
   DsLdataInfo ldata;
   ldata.setDir(_path);
   ldata.setDataFileExt(_indxExt);
@@ -1329,8 +1835,8 @@ int Spdb::_fetchExact(time_t request_time,
     return 0;
   }
   
-  chunk_ref_t *fileRefs = (chunk_ref_t *) _hdrRefBuf.getPtr();
-  aux_ref_t *fileAuxs = (aux_ref_t *) _hdrAuxBuf.getPtr();
+  const chunk_ref_t *fileRefs = _hdrRefs();
+  const aux_ref_t *fileAuxs = _hdrAuxs();
 
   MemBuf readBuf;
 
@@ -1624,8 +2130,8 @@ int Spdb::_getInterval(time_t start_time,
 	return -1;
       }
     }
-    chunk_ref_t *fileRefs = (chunk_ref_t *) _hdrRefBuf.getPtr();
-    aux_ref_t *fileAuxs = (aux_ref_t *) _hdrAuxBuf.getPtr();
+    const chunk_ref_t *fileRefs = _hdrRefs();
+    const aux_ref_t *fileAuxs = _hdrAuxs();
     
     // get the first indx posn at or after start time
     
@@ -1720,8 +2226,8 @@ int Spdb::_getValid(time_t request_time,
       }
     }
 
-    chunk_ref_t *fileRefs = (chunk_ref_t *) _hdrRefBuf.getPtr();
-    aux_ref_t *fileAuxs = (aux_ref_t *) _hdrAuxBuf.getPtr();
+    const chunk_ref_t *fileRefs = _hdrRefs();
+    const aux_ref_t *fileAuxs = _hdrAuxs();
 
     // get the first indx posn at or after start time
     
@@ -1857,8 +2363,8 @@ int Spdb::_compileTimeList(time_t start_time,
       iret = 0;
 
       time_t lastAdded = -1;
-      chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr();
-      aux_ref_t *aux = (aux_ref_t *) _hdrAuxBuf.getPtr();
+      const chunk_ref_t *ref = _hdrRefs();
+      const aux_ref_t *aux = _hdrAuxs();
       for (int i = 0; i < _hdr.n_chunks; i++, ref++, aux++) {
         if ((time_t) ref->valid_time >= start_time &&
 	    (time_t) ref->valid_time <= end_time) {
@@ -2008,29 +2514,36 @@ void Spdb::uncompressGetChunks()
     void *chunk = data + refCopy.offset;
     compression_t compression = (compression_t) auxCopy.compression;
     
-    // uncompress chunk if it is compressed
-    // otherwise add it unchanged to the buffers
+    // uncompress chunk straight onto the end of the data buffer
+    // if it is compressed, otherwise add it unchanged
     
+    bool added = false;
     if (ta_is_compressed(chunk, refCopy.len)) {
-      ui64 nbytesUncompressed;
-      void *uncompressed  = ta_decompress(chunk, &nbytesUncompressed);
-      if (uncompressed != NULL) {
-        memcpy(chunk, uncompressed, nbytesUncompressed);
+      ui64 offset = dataBuf.getLen();
+      ui64 nbytesUncompressed = ta_decompress_len(chunk);
+      char *out = (char *) dataBuf.prepare(offset + nbytesUncompressed) + offset;
+      if (ta_decompress_buf(_getCompressCtx(), chunk,
+                            out, nbytesUncompressed,
+                            &nbytesUncompressed) == 0) {
         refCopy.len = nbytesUncompressed;
-        refCopy.offset = dataBuf.getLen();
+        refCopy.offset = offset;
         auxCopy.compression = 0;
-        ta_compress_free(uncompressed);
+        added = true;
       } else {
+        dataBuf.prepare(offset);
         cerr << "WARNING - Spdb::uncompressGetChunks" << endl;
         cerr << "  Cannot uncompress chunk, offset, len: "
              << refCopy.offset << ", " << refCopy.len << endl;
       }
     }
+    if (!added) {
+      refCopy.offset = dataBuf.getLen();
+      dataBuf.add(chunk, refCopy.len);
+    }
 
     nChunks++;
     refBuf.add(&refCopy, sizeof(chunk_ref_t));
     auxBuf.add(&auxCopy, sizeof(aux_ref_t));
-    dataBuf.add(chunk, refCopy.len);
     storedCompression.push_back(compression);
 
   } // i
@@ -2089,19 +2602,7 @@ int Spdb::_openFiles(int prod_id,
 
   // compute the path names
   
-  date_time_t vtime;
-  vtime.unix_time = valid_time;
-  uconvert_from_utime(&vtime);
-  
-  sprintf(_indxPath, "%s%s%.4d%.2d%.2d.%s",
-	  _path.c_str(), PATH_DELIM,
-	  vtime.year, vtime.month, vtime.day,
-	  _indxExt);
-
-  sprintf(_dataPath, "%s%s%.4d%.2d%.2d.%s",
-	  _path.c_str(), PATH_DELIM,
-	  vtime.year, vtime.month, vtime.day,
-	  _dataExt);
+  _computePaths(valid_time);
 
   // decide if files exist
   
@@ -2132,6 +2633,13 @@ int Spdb::_openFiles(int prod_id,
       return -1;
     }
 
+    // apply any journal from group-committed puts before writing
+
+    if (mode == WriteMode && read_chunk_refs && _applyJournal()) {
+      _closeFiles(false);
+      return -1;
+    }
+
   } else {
 
     // no files
@@ -2152,11 +2660,12 @@ int Spdb::_openFiles(int prod_id,
 
     }
 
-    // create it in write mode
+    // create it in write mode - any journal is stale
 
     if (_openCreate(prod_id, prod_label, valid_time, mode)) {
       return -1;
     }
+    unlink(_jrnlPath);
     
   }
 
@@ -2169,6 +2678,34 @@ int Spdb::_openFiles(int prod_id,
   
 }
 
+/////////////////////////////////////////////////////
+// compute the file paths for the day of the valid time
+
+void Spdb::_computePaths(time_t valid_time)
+
+{
+
+  date_time_t vtime;
+  vtime.unix_time = valid_time;
+  uconvert_from_utime(&vtime);
+  
+  sprintf(_indxPath, "%s%s%.4d%.2d%.2d.%s",
+	  _path.c_str(), PATH_DELIM,
+	  vtime.year, vtime.month, vtime.day,
+	  _indxExt);
+
+  sprintf(_dataPath, "%s%s%.4d%.2d%.2d.%s",
+	  _path.c_str(), PATH_DELIM,
+	  vtime.year, vtime.month, vtime.day,
+	  _dataExt);
+
+  sprintf(_jrnlPath, "%s%s%.4d%.2d%.2d.%s",
+	  _path.c_str(), PATH_DELIM,
+	  vtime.year, vtime.month, vtime.day,
+	  _jrnlExt);
+
+}
+
 /////////////////////////////////////////////////////
 // _openReadWrite()
 //
@@ -2182,6 +2719,19 @@ int Spdb::_openReadWrite(int prod_id,
      
 {
 
+  // in read mode, use the process-level index cache if possible.
+  // The data file is opened when the first chunk is read.
+
+  _cachedIndx.reset();
+  if (mode == ReadMode && SpdbIndexCache::isEnabled()) {
+    _cachedIndx = SpdbIndexCache::get(_indxPath);
+  }
+  if (_cachedIndx) {
+    _hdr = _cachedIndx->hdr;
+    _filesOpen = true;
+    return _checkIndxHdr(prod_id);
+  }
+
   // open files as appropriate
   
   const char *open_mode;
@@ -2262,6 +2812,30 @@ int Spdb::_openReadWrite(int prod_id,
   BE_to_array_32(((char *) &_hdr + SPDB_LABEL_MAX),
 		 sizeof(header_t) - SPDB_LABEL_MAX);
   
+  if (_checkIndxHdr(prod_id)) {
+    return -1;
+  }
+  
+  if (read_chunk_refs) {
+    _readChunkRefs();
+  }
+
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////
+// _checkIndxHdr()
+//
+// Check the product ID in the index header, and set
+// the product info from it.
+//
+// Returns 0 on success, -1 on failure.
+
+int Spdb::_checkIndxHdr(int prod_id)
+     
+{
+
   // check that the ID is correct - if ID of 0 is passed in
   // we accept any data ID
   
@@ -2286,10 +2860,37 @@ int Spdb::_openReadWrite(int prod_id,
     _leadTimeStorage = (lead_time_storage_t) _hdr.lead_time_storage;
   }
   
-  if (read_chunk_refs) {
-    _readChunkRefs();
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////
+// _openDataForRead()
+//
+// Open the data file for reading, if it is not already open.
+// When the index comes from the cache, the data file is only
+// opened if chunks are read.
+//
+// Returns 0 on success, -1 on failure.
+
+int Spdb::_openDataForRead()
+     
+{
+
+  if (_dataFile != NULL) {
+    return 0;
   }
 
+  if ((_dataFile = ta_fopen_uncompress(_dataPath, "rb")) == NULL) {
+    int errNum = errno;
+    _errStr += "ERROR - Spdb::_openDataForRead\n";
+    _addStrErr("  Product: ", _hdr.prod_label);
+    _errStr += "  Cannot open data file for read.\n";
+    _addStrErr("  _dataPath: ", strerror(errNum));
+    return -1;
+  }
+  _dataFd = fileno(_dataFile);
+
   return 0;
 
 }
@@ -2453,6 +3054,9 @@ void Spdb::_closeFiles(bool sync /* = true*/ )
 	_errStr += "ERROR - Spdb::_closeFiles\n";
 	_errStr += "  Cannot write indx file.\n";
 	_addStrErr("  Product label: ", _hdr.prod_label);
+      } else if (_journalApplied) {
+        // journal entries are now in the index
+        unlink(_jrnlPath);
       }
     }
 
@@ -2468,6 +3072,10 @@ void Spdb::_closeFiles(bool sync /* = true*/ )
     _dataFile = NULL;
   }
 
+  _indxFd = -1;
+  _dataFd = -1;
+  _cachedIndx.reset();
+  _journalApplied = false;
   _filesOpen = false;
   _openDay = 0;
 
@@ -2483,6 +3091,12 @@ void Spdb::_closeFiles(bool sync /* = true*/ )
 int Spdb::_writeIndxFile(bool write_refs /* = true*/ )
 {
 
+  // the generation changes whenever the refs change
+
+  if (write_refs) {
+    _hdr.generation++;
+  }
+
   // copy header and put into BE order
   
   header_t tmp_hdr = _hdr;
@@ -2717,8 +3331,8 @@ int Spdb::printHeader(const string &dir,
       << endl;
   
 
-  chunk_ref_t *refs = (chunk_ref_t *) _hdrRefBuf.getPtr();
-  aux_ref_t *auxs = (aux_ref_t *) _hdrAuxBuf.getPtr();
+  const chunk_ref_t *refs = _hdrRefs();
+  const aux_ref_t *auxs = _hdrAuxs();
   for (int i = 0; i < _hdr.n_chunks; i++, refs++, auxs++) {
     out << setw(8) << i
 	<< setw(15) << refs->data_type
@@ -2768,6 +3382,7 @@ void Spdb::_printIndxHeader(header_t &hdr,
   out << "end_valid: " << utimstr(hdr.end_valid) << endl;
   out << "latest_expire: " << utimstr(hdr.latest_expire) << endl;
   out << "earliest_valid: " << utimstr(hdr.earliest_valid) << endl;
+  out << "generation: " << hdr.generation << endl;
 
   if (hdr.lead_time_storage == LEAD_TIME_IN_DATA_TYPE) {
     out << "Lead time: stored in data_type" << endl;
@@ -3050,15 +3665,17 @@ int Spdb::_firstPosnAfter(time_t start_time)
     return -1;
   }
   
-  chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr() + start_posn;
+  // the refs are sorted on valid time, so do a binary search
+  // from the minute position
 
-  for (int i = start_posn; i < _hdr.n_chunks; i++, ref++) {
-    if ((time_t) ref->valid_time >= start_time) {
-      return i;
-    }
-  } // i
-
-  return -1;
+  const chunk_ref_t *refs = _hdrRefs();
+  const chunk_ref_t *ref = lower_bound(refs + start_posn, refs + _hdr.n_chunks,
+                                       start_time, _refTimeBefore);
+  if (ref == refs + _hdr.n_chunks) {
+    return -1;
+  }
+  
+  return (int) (ref - refs);
 
 }
 
@@ -3113,8 +3730,8 @@ int Spdb::_getFirstTimeAfter(time_t request_time,
     
     if (posn >= 0) {
       
-      chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr() + posn;
-      aux_ref_t *aux = (aux_ref_t *) _hdrAuxBuf.getPtr() + posn;
+      const chunk_ref_t *ref = _hdrRefs() + posn;
+      const aux_ref_t *aux = _hdrAuxs() + posn;
       for (int i = posn; i < _hdr.n_chunks; i++, ref++) {
 	if ((time_t) ref->valid_time >= search_time &&
 	    (time_t) ref->valid_time <= end_time &&
@@ -3208,8 +3825,8 @@ int Spdb::_getFirstTimeBefore(time_t request_time,
 	return -1;
       }
       
-      chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr() + posn_ahead;
-      aux_ref_t *aux = (aux_ref_t *) _hdrAuxBuf.getPtr() + posn_ahead;
+      const chunk_ref_t *ref = _hdrRefs() + posn_ahead;
+      const aux_ref_t *aux = _hdrAuxs() + posn_ahead;
       for (int i = posn_ahead; i >= 0; i--, ref--) {
 	if ((time_t) ref->valid_time <= search_time &&
 	    (time_t) ref->valid_time >= start_time &&
@@ -3338,17 +3955,17 @@ int Spdb::_posn1MinAhead(int start_posn)
 
 {
 
-  chunk_ref_t *refs = (chunk_ref_t *) _hdrRefBuf.getPtr();
+  const chunk_ref_t *refs = _hdrRefs();
   time_t start_time = refs[start_posn].valid_time;
   time_t target_time = start_time + SECS_IN_MIN;
 
-  for (int i = start_posn + 1; i < _hdr.n_chunks; i++) {
-    if ((time_t) refs[i].valid_time >= target_time) {
-      return i;
-    }
+  const chunk_ref_t *ref = lower_bound(refs + start_posn + 1, refs + _hdr.n_chunks,
+                                       target_time, _refTimeBefore);
+  if (ref == refs + _hdr.n_chunks) {
+    return (_hdr.n_chunks - 1);
   }
 
-  return (_hdr.n_chunks - 1);
+  return (int) (ref - refs);
 
 }
 
@@ -3373,8 +3990,8 @@ int Spdb::_posnAtTime(time_t valid_time,
     return -1;
   }
 
-  chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr() + minute_posn;
-  aux_ref_t *aux = (aux_ref_t *) _hdrAuxBuf.getPtr() + minute_posn;
+  const chunk_ref_t *ref = _hdrRefs() + minute_posn;
+  const aux_ref_t *aux = _hdrAuxs() + minute_posn;
 
   for (int i = minute_posn; i < _hdr.n_chunks; i++, ref++, aux++) {
     if (((time_t) ref->valid_time - valid_time) > SECS_IN_MIN) {
@@ -3438,6 +4055,47 @@ void Spdb::_readChunkRefs()
   
 }
 
+/////////////////////////////////////////////////
+// chunk refs and aux refs for the open file -
+// from the index cache if in use, otherwise from
+// the buffers read from the file.
+// The cache entries are shared, so these are read-only.
+
+const Spdb::chunk_ref_t *Spdb::_hdrRefs() const
+
+{
+  if (_cachedIndx) {
+    return (const chunk_ref_t *) _cachedIndx->refBuf.getPtr();
+  }
+  return (const chunk_ref_t *) _hdrRefBuf.getPtr();
+}
+
+const Spdb::aux_ref_t *Spdb::_hdrAuxs() const
+
+{
+  if (_cachedIndx) {
+    return (const aux_ref_t *) _cachedIndx->auxBuf.getPtr();
+  }
+  return (const aux_ref_t *) _hdrAuxBuf.getPtr();
+}
+
+/////////////////////////////////////////////////
+// chunk refs and aux refs read from the file,
+// for modification. Files opened for writing never
+// use the index cache.
+
+Spdb::chunk_ref_t *Spdb::_fileRefs()
+
+{
+  return (chunk_ref_t *) _hdrRefBuf.getPtr();
+}
+
+Spdb::aux_ref_t *Spdb::_fileAuxs()
+
+{
+  return (aux_ref_t *) _hdrAuxBuf.getPtr();
+}
+
 /////////////////////////////////////////////////
 // do the chunk read if the data type is correct
 // Appends to the ref, aux and data buffers, and
@@ -3457,6 +4115,12 @@ int Spdb::_checkTypeThenReadChunk(int data_type,
   if (!_acceptRef(data_type, data_type2, ref, aux)) {
     return 0;
   }
+
+  // check the bounding box, if requested
+
+  if (_bboxOnGet && !_bboxOverlaps(aux)) {
+    return 0;
+  }
     
   // copy the references
   
@@ -3524,6 +4188,25 @@ int Spdb::_readChunk(chunk_ref_t &ref,
   // allocate space in buffer for chunk data
   
   void *chunk = readBuf.reserve(ref.len);
+
+  // in read mode, read just the chunk bytes, without going
+  // through the stdio buffer
+
+  if (_openMode == ReadMode) {
+    if (_openDataForRead()) {
+      return -1;
+    }
+    if (pread(_dataFd, chunk, ref.len, ref.offset) != (ssize_t) ref.len) {
+      int errNum = errno;
+      _errStr += "ERROR - Spdb::_readChunk\n";
+      _addStrErr(" Prod label: ", _hdr.prod_label);
+      _addIntErr(" Cannot read chunk of len: ", ref.len);
+      _addIntErr(" Data offset: ", ref.offset);
+      _addStrErr(_dataPath, strerror(errNum));
+      return -1;
+    }
+    return _uncompressChunk(ref, aux, readBuf, doUncompress);
+  }
   
   // seek to offset
   
@@ -3548,22 +4231,58 @@ int Spdb::_readChunk(chunk_ref_t &ref,
     return -1;
   }
 
-  // uncompress chunk if it is compressed
+  return _uncompressChunk(ref, aux, readBuf, doUncompress);
+
+}
+
+//////////////////////////////////////////
+// _getCompressCtx()
+//
+// Returns the compression context, creating it on first use.
+
+ta_compress_ctx_t *Spdb::_getCompressCtx()
+  
+{
+  if (!_compressCtx) {
+    _compressCtx.reset(ta_compress_ctx_create(), ta_compress_ctx_free);
+  }
+  return _compressCtx.get();
+}
+
+//////////////////////////////////////////
+// _uncompressChunk()
+//
+// Uncompresses chunk in buffer if needed, adjusts
+// the values in ref and aux accordingly.
+//
+// Returns 0 on success, -1 on failure.
+
+int Spdb::_uncompressChunk(chunk_ref_t &ref,
+                           aux_ref_t &aux,
+                           MemBuf &readBuf,
+                           bool doUncompress)
+  
+{
+
+  void *chunk = readBuf.getPtr();
+
+  // uncompress chunk if it is compressed, into the work
+  // buffer, then swap that with the read buffer
 
   if (doUncompress && ta_is_compressed(chunk, ref.len)) {
-    ui64 nbytesUncompressed;
-    void *uncompressed  = ta_decompress(chunk, &nbytesUncompressed);
-    if (uncompressed == NULL) {
+    ui64 nbytesUncompressed = ta_decompress_len(chunk);
+    void *out = _uncompressBuf.reserve(nbytesUncompressed);
+    if (ta_decompress_buf(_getCompressCtx(), chunk,
+                          out, nbytesUncompressed,
+                          &nbytesUncompressed)) {
       _errStr += "WARNING - Spdb::_readChunk\n";
       _addStrErr(" Prod label: ", _hdr.prod_label);
       _addIntErr(" Cannot uncompress chunk of len: ", ref.len);
       _addIntErr(" Data offset: ", ref.offset);
     } else {
-      chunk = readBuf.reserve(nbytesUncompressed);
-      memcpy(chunk, uncompressed, nbytesUncompressed);
+      readBuf.swap(_uncompressBuf);
       ref.len = nbytesUncompressed;
       aux.compression = 0;
-      ta_compress_free(uncompressed);
     }
   }
 
@@ -3704,7 +4423,7 @@ int Spdb::_storeChunk(const chunk_ref_t *input_ref,
     
   } else {
     
-    chunk_ref_t *existRef = (chunk_ref_t *) _hdrRefBuf.getPtr() + posn;
+    chunk_ref_t *existRef = _fileRefs() + posn;
     
     if (existRef->len >= inref.len) {
 
@@ -3751,15 +4470,28 @@ int Spdb::_storeChunk(const chunk_ref_t *input_ref,
 
     // store chunk ref at previous location
 
-    chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr() + posn;
+    chunk_ref_t *ref = _fileRefs() + posn;
     *ref = inref;
 
-    aux_ref_t *aux = (aux_ref_t *) _hdrAuxBuf.getPtr() + posn;
+    aux_ref_t *aux = _fileAuxs() + posn;
     *aux = inaux;
 
   }
 
   // keep stats up to date
+
+  _updateHdrStats(inref);
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////
+// update the header stats for a new chunk ref
+
+void Spdb::_updateHdrStats(const chunk_ref_t &inref)
+
+{
   
   _hdr.max_duration =
     MAX(_hdr.max_duration,
@@ -3776,8 +4508,6 @@ int Spdb::_storeChunk(const chunk_ref_t *input_ref,
   _setEarliestValid(inref.valid_time,
 		    inref.expire_time);
 
-  return 0;
-
 }
 
 ////////////////////////////////////////////////////
@@ -3802,7 +4532,7 @@ int Spdb::_addChunkRef(const chunk_ref_t &inref,
   bool latest = false;
   {
     chunk_ref_t *ref  =
-      (chunk_ref_t *) _hdrRefBuf.getPtr() + (_hdr.n_chunks - 1);
+      _fileRefs() + (_hdr.n_chunks - 1);
     int i;
     for (i = _hdr.n_chunks - 1; i >= 0; i--, ref--) {
       if ((time_t) inref.valid_time >= (time_t) ref->valid_time) {
@@ -3823,14 +4553,14 @@ int Spdb::_addChunkRef(const chunk_ref_t &inref,
   if (!latest) {
 
     chunk_ref_t *ref =
-      (chunk_ref_t *) _hdrRefBuf.getPtr() + (_hdr.n_chunks - 1);
+      _fileRefs() + (_hdr.n_chunks - 1);
     chunk_ref_t *ref2 = ref + 1;
     for (int i = _hdr.n_chunks; i > store_posn; i--, ref--, ref2--) {
       *ref2 = *ref;
     }
 
     aux_ref_t *aux =
-      (aux_ref_t *) _hdrAuxBuf.getPtr() + (_hdr.n_chunks - 1);
+      _fileAuxs() + (_hdr.n_chunks - 1);
     aux_ref_t *aux2 = aux + 1;
     for (int i = _hdr.n_chunks; i > store_posn; i--, aux--, aux2--) {
       *aux2 = *aux;
@@ -3840,10 +4570,10 @@ int Spdb::_addChunkRef(const chunk_ref_t &inref,
 
   // store the refs in the header
 
-  chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr() + store_posn;
+  chunk_ref_t *ref = _fileRefs() + store_posn;
   *ref = inref;
   
-  aux_ref_t *aux = (aux_ref_t *) _hdrAuxBuf.getPtr() + store_posn;
+  aux_ref_t *aux = _fileAuxs() + store_posn;
   *aux = inaux;
   
   // increment the number of chunks and nbytes_data
@@ -3900,8 +4630,8 @@ int Spdb::_eraseChunks(time_t valid_time, int data_type, int data_type2)
 
   while (posn < _hdr.n_chunks) {
 
-    chunk_ref_t *ref = (chunk_ref_t *) _hdrRefBuf.getPtr() + posn;
-    aux_ref_t *aux = (aux_ref_t *) _hdrAuxBuf.getPtr() + posn;
+    const chunk_ref_t *ref = _hdrRefs() + posn;
+    const aux_ref_t *aux = _hdrAuxs() + posn;
 
     if ((time_t) ref->valid_time != valid_time ||
 	!_acceptRef(data_type, data_type2, *ref, *aux)) {
@@ -3940,7 +4670,7 @@ void Spdb::_eraseChunkRef(time_t valid_time, int posn)
   bool reset = true;
   
   if (posn > 0) {
-    chunk_ref_t *prevRef  = (chunk_ref_t *) _hdrRefBuf.getPtr() + (posn - 1);
+    chunk_ref_t *prevRef  = _fileRefs() + (posn - 1);
     int prevVmin = ((time_t) prevRef->valid_time % SECS_IN_DAY) / SECS_IN_MIN;
     if (prevVmin == vmin) {
       reset = false;
@@ -3948,7 +4678,7 @@ void Spdb::_eraseChunkRef(time_t valid_time, int posn)
   }
   
   if (reset && posn < (_hdr.n_chunks - 1)) {
-    chunk_ref_t *nextRef  = (chunk_ref_t *) _hdrRefBuf.getPtr() + (posn + 1);
+    chunk_ref_t *nextRef  = _fileRefs() + (posn + 1);
     int nextVmin = ((time_t) nextRef->valid_time % SECS_IN_DAY) / SECS_IN_MIN;
     if (nextVmin == vmin) {
       reset = false;
@@ -3968,12 +4698,12 @@ void Spdb::_eraseChunkRef(time_t valid_time, int posn)
 
   // move the refs below up one slot
 
-  chunk_ref_t *ref  = (chunk_ref_t *) _hdrRefBuf.getPtr() + posn;
+  chunk_ref_t *ref  = _fileRefs() + posn;
   for (int ii = posn; ii < _hdr.n_chunks - 1; ii++, ref++) {
     *ref = *(ref + 1);
   }
 
-  aux_ref_t *aux  = (aux_ref_t *) _hdrAuxBuf.getPtr() + posn;
+  aux_ref_t *aux  = _fileAuxs() + posn;
   for (int ii = posn; ii < _hdr.n_chunks - 1; ii++, aux++) {
     *aux = *(aux + 1);
   }
@@ -4148,8 +4878,8 @@ int Spdb::_defrag()
   MemBuf refBuf;
   MemBuf auxBuf;
 
-  chunk_ref_t *ref  = (chunk_ref_t *) _hdrRefBuf.getPtr();
-  aux_ref_t *aux  = (aux_ref_t *) _hdrAuxBuf.getPtr();
+  chunk_ref_t *ref  = _fileRefs();
+  aux_ref_t *aux  = _fileAuxs();
 
   for (int i = 0; i < _hdr.n_chunks; i++, ref++, aux++) {
 
@@ -4215,6 +4945,28 @@ int Spdb::_defrag()
 
 }
 
+//////////////////////////////////////////////////////////////
+// Does the bounding box of the chunk overlap the requested box?
+// Returns true if the chunk has no bounding box.
+
+bool Spdb::_bboxOverlaps(const aux_ref_t &aux) const
+
+{
+
+  double minLat, minLon, maxLat, maxLon;
+  if (!getAuxBbox(aux, minLat, minLon, maxLat, maxLon)) {
+    return true;
+  }
+
+  if (maxLat < _getMinLat || minLat > _getMaxLat ||
+      maxLon < _getMinLon || minLon > _getMaxLon) {
+    return false;
+  }
+
+  return true;
+
+}
+
 bool Spdb::_acceptRef(int data_type,
 		      int data_type2,
 		      const chunk_ref_t &ref,
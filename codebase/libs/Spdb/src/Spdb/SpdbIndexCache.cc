@@ -0,0 +1,344 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////
+// SpdbIndexCache.cc
+//
+// Process-level cache of SPDB index files, for reads.
+// See SpdbIndexCache.hh for details.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////
+
+#include <Spdb/SpdbIndexCache.hh>
+#include <dataport/bigend.h>
+#include <toolsa/str.h>
+#include <cstdlib>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+#if defined(__APPLE__)
+#define SPDB_ST_MTIME(st) ((st).st_mtimespec)
+#define SPDB_ST_CTIME(st) ((st).st_ctimespec)
+#else
+#define SPDB_ST_MTIME(st) ((st).st_mtim)
+#define SPDB_ST_CTIME(st) ((st).st_ctim)
+#endif
+
+// static members
+
+SpdbIndexCache::CacheMap SpdbIndexCache::_cache;
+size_t SpdbIndexCache::_totalBytes = 0;
+unsigned long SpdbIndexCache::_useCount = 0;
+int SpdbIndexCache::_nHits = 0;
+int SpdbIndexCache::_nLoads = 0;
+pthread_mutex_t SpdbIndexCache::_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//////////////////////////////
+// Is the cache enabled?
+
+bool SpdbIndexCache::isEnabled()
+
+{
+  const char *enableStr = getenv("SPDB_INDEX_CACHE");
+  if (enableStr != NULL && STRequal(enableStr, "false")) {
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////
+// Get the entry for an index file, loading it if needed.
+// Returns NULL if the file cannot be cached.
+//
+// The file is opened and checked through the open fd, so that
+// the stat, the generation check and the load all refer to the
+// same file.
+
+SpdbIndexCache::EntryPtr SpdbIndexCache::get(const string &indxPath)
+
+{
+
+  // open and stat the plain file - compressed files are not cached
+
+  int fd = open(indxPath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return EntryPtr();
+  }
+  struct stat fstat;
+  if (::fstat(fd, &fstat) ||
+      !S_ISREG(fstat.st_mode) ||
+      fstat.st_size < (off_t) sizeof(Spdb::header_t)) {
+    close(fd);
+    return EntryPtr();
+  }
+
+  // the generation in the file header changes whenever the refs
+  // are rewritten, which catches changes within the time stamp
+  // resolution of the file system
+
+  si32 generation;
+  if (_readGeneration(fd, generation)) {
+    close(fd);
+    return EntryPtr();
+  }
+
+  pthread_mutex_lock(&_mutex);
+  _useCount++;
+  CacheMap::iterator it = _cache.find(indxPath);
+  if (it != _cache.end()) {
+    if (_matches(it->second, fstat) &&
+        it->second.entry->hdr.generation == generation) {
+      it->second.lastUsed = _useCount;
+      _nHits++;
+      EntryPtr entry = it->second.entry;
+      pthread_mutex_unlock(&_mutex);
+      close(fd);
+      return entry;
+    }
+    // file has changed
+    _totalBytes -= it->second.nbytes;
+    _cache.erase(it);
+  }
+  pthread_mutex_unlock(&_mutex);
+
+  // load outside the lock, so that other readers are not held up
+
+  EntryPtr entry = _load(fd, fstat);
+  close(fd);
+  if (!entry) {
+    return entry;
+  }
+
+  CacheEntry centry;
+  centry.dev = fstat.st_dev;
+  centry.ino = fstat.st_ino;
+  centry.size = fstat.st_size;
+  centry.mtime = SPDB_ST_MTIME(fstat);
+  centry.ctime = SPDB_ST_CTIME(fstat);
+  centry.nbytes = (sizeof(SpdbIndexEntry) +
+                   entry->refBuf.getLen() + entry->auxBuf.getLen());
+  centry.entry = entry;
+
+  size_t maxBytes = _getMaxBytes();
+  if (centry.nbytes > maxBytes) {
+    // too large to cache, use it once
+    return entry;
+  }
+
+  pthread_mutex_lock(&_mutex);
+  _nLoads++;
+  centry.lastUsed = ++_useCount;
+  it = _cache.find(indxPath);
+  if (it != _cache.end()) {
+    // loaded by another thread in the meantime
+    _totalBytes -= it->second.nbytes;
+    _cache.erase(it);
+  }
+  _cache[indxPath] = centry;
+  _totalBytes += centry.nbytes;
+  _evict(maxBytes);
+  pthread_mutex_unlock(&_mutex);
+
+  return entry;
+
+}
+
+//////////////////////////////
+// Remove all entries
+
+void SpdbIndexCache::clear()
+
+{
+  pthread_mutex_lock(&_mutex);
+  _cache.clear();
+  _totalBytes = 0;
+  pthread_mutex_unlock(&_mutex);
+}
+
+//////////////////////////////
+// get the size limit
+
+size_t SpdbIndexCache::_getMaxBytes()
+
+{
+  size_t maxMb = 256;
+  const char *maxStr = getenv("SPDB_INDEX_CACHE_MB");
+  if (maxStr != NULL) {
+    int mb = atoi(maxStr);
+    if (mb >= 0) {
+      maxMb = mb;
+    }
+  }
+  return maxMb * 1024 * 1024;
+}
+
+/////////////////////////////////////////////////
+// does the cached entry match the file on disk?
+
+bool SpdbIndexCache::_matches(const CacheEntry &centry,
+                              const struct stat &fstat)
+
+{
+  const struct timespec &mtime = SPDB_ST_MTIME(fstat);
+  const struct timespec &ctime = SPDB_ST_CTIME(fstat);
+  return (centry.dev == fstat.st_dev &&
+          centry.ino == fstat.st_ino &&
+          centry.size == fstat.st_size &&
+          centry.mtime.tv_sec == mtime.tv_sec &&
+          centry.mtime.tv_nsec == mtime.tv_nsec &&
+          centry.ctime.tv_sec == ctime.tv_sec &&
+          centry.ctime.tv_nsec == ctime.tv_nsec);
+}
+
+/////////////////////////////////////////////////////////////
+// read the generation from the index file header
+// Returns 0 on success, -1 on failure.
+
+int SpdbIndexCache::_readGeneration(int fd, si32 &generation)
+
+{
+  si32 gen;
+  if (pread(fd, &gen, sizeof(gen),
+            offsetof(Spdb::header_t, generation)) != sizeof(gen)) {
+    return -1;
+  }
+  generation = BE_to_si32(gen);
+  return 0;
+}
+
+/////////////////////////////////////////////////////////////
+// read len bytes at offset, retrying short reads
+// Returns 0 on success, -1 on failure.
+
+int SpdbIndexCache::_readFully(int fd, void *buf, size_t len, off_t offset)
+
+{
+  char *ptr = (char *) buf;
+  while (len > 0) {
+    ssize_t nread = pread(fd, ptr, len, offset);
+    if (nread < 0 && errno == EINTR) {
+      continue;
+    }
+    if (nread <= 0) {
+      return -1;
+    }
+    ptr += nread;
+    offset += nread;
+    len -= nread;
+  }
+  return 0;
+}
+
+/////////////////////////////////////////////////////////////
+// load an index file from the open fd
+//
+// fstat is the stat of the open fd, so the sizes used here are
+// those of the file actually being read. The header and refs
+// are read rather than mapped, so a file truncated by a writer
+// during the load gives a failed read, not a fault. The refs are
+// stored big-endian on disk, so they are swapped into the entry.
+// As in Spdb::_readChunkRefs(), if there are fewer refs in the
+// file than in the header, n_chunks is trimmed, and if the aux
+// refs are missing they are set to 0.
+
+SpdbIndexCache::EntryPtr
+  SpdbIndexCache::_load(int fd, const struct stat &fstat)
+
+{
+
+  size_t fileLen = fstat.st_size;
+  SpdbIndexEntry *entry = new SpdbIndexEntry;
+
+  // header - swap all but the label, which is char
+
+  if (_readFully(fd, &entry->hdr, sizeof(Spdb::header_t), 0)) {
+    delete entry;
+    return EntryPtr();
+  }
+  BE_to_array_32(((char *) &entry->hdr + SPDB_LABEL_MAX),
+                 sizeof(Spdb::header_t) - SPDB_LABEL_MAX);
+  Spdb::header_t &hdr = entry->hdr;
+  if (hdr.n_chunks < 0) {
+    hdr.n_chunks = 0;
+  }
+
+  // chunk refs
+
+  size_t refsOffset = sizeof(Spdb::header_t);
+  int nRefsAvail = (fileLen - refsOffset) / sizeof(Spdb::chunk_ref_t);
+  if (nRefsAvail < hdr.n_chunks) {
+    hdr.n_chunks = nRefsAvail;
+  }
+  size_t refsLen = hdr.n_chunks * sizeof(Spdb::chunk_ref_t);
+  if (_readFully(fd, entry->refBuf.reserve(refsLen), refsLen, refsOffset)) {
+    delete entry;
+    return EntryPtr();
+  }
+  Spdb::chunk_refs_from_BE((Spdb::chunk_ref_t *) entry->refBuf.getPtr(),
+                           hdr.n_chunks);
+
+  // aux refs
+
+  size_t auxOffset = refsOffset + refsLen;
+  size_t auxLen = hdr.n_chunks * sizeof(Spdb::aux_ref_t);
+  if (auxOffset + auxLen <= fileLen) {
+    if (_readFully(fd, entry->auxBuf.reserve(auxLen), auxLen, auxOffset)) {
+      delete entry;
+      return EntryPtr();
+    }
+    Spdb::aux_refs_from_BE((Spdb::aux_ref_t *) entry->auxBuf.getPtr(),
+                           hdr.n_chunks);
+  } else {
+    memset(entry->auxBuf.reserve(auxLen), 0, auxLen);
+  }
+
+  return EntryPtr(entry);
+
+}
+
+/////////////////////////////////////////////////////////////
+// remove least recently used entries until within the limit
+// mutex must be held
+
+void SpdbIndexCache::_evict(size_t maxBytes)
+
+{
+
+  while (_totalBytes > maxBytes && _cache.size() > 0) {
+    CacheMap::iterator oldest = _cache.begin();
+    for (CacheMap::iterator it = _cache.begin(); it != _cache.end(); it++) {
+      if (it->second.lastUsed < oldest->second.lastUsed) {
+        oldest = it;
+      }
+    }
+    _totalBytes -= oldest->second.nbytes;
+    _cache.erase(oldest);
+  }
+
+}
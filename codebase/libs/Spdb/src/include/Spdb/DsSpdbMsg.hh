@@ -35,6 +35,7 @@
 
 #include <toolsa/str.h>
 #include <toolsa/MemBuf.hh>
+#include <toolsa/compress.h>
 #include <dsserver/DsServerMsg.hh>
 #include <Spdb/Spdb.hh>
 #include <iostream>
@@ -244,7 +245,8 @@ public:
     DS_SPDB_TIME_LIST_PART = 77508,
     DS_SPDB_APP_NAME_PART = 77509,
     DS_SPDB_AUX_REF_PART = 77510,
-    DS_SPDB_AUX_XML_PART = 77511
+    DS_SPDB_AUX_XML_PART = 77511,
+    DS_SPDB_BBOX_ON_GET_PART = 77512
   } part_enum_t;
 
   ///////////////////
@@ -544,6 +546,20 @@ public:
 
   void clearHorizLimits();
 
+  /////////////////////////////////////////////
+  // set or clear bounding box for get requests
+  //
+  // Unlike the horizontal limits, this is applied by the Spdb
+  // get itself: chunks whose stored bounding box does not overlap
+  // this box are not returned. See Spdb::setBboxOnGet().
+  
+  void setBboxOnGet(double min_lat,
+                    double min_lon,
+                    double max_lat,
+                    double max_lon);
+
+  void clearBboxOnGet();
+
   ///////////////////////////////
   // set or clear vertical limits
   //
@@ -624,6 +640,9 @@ public:
   bool horizLimitsSet() const { return _horizLimitsSet; }
   const horiz_limits_t &getHorizLimits() const { return _horizLimits; }
 
+  bool bboxOnGetSet() const { return _bboxOnGetSet; }
+  const horiz_limits_t &getBboxOnGet() const { return _bboxOnGet; }
+
   bool vertLimitsSet() const { return _vertLimitsSet; }
   const vert_limits_t &getVertLimits() const { return _vertLimits; }
 
@@ -698,6 +717,9 @@ private:
   bool _horizLimitsSet;
   bool _vertLimitsSet;
 
+  horiz_limits_t _bboxOnGet;
+  bool _bboxOnGetSet;
+
   // chunk refs and data
 
   MemBuf _refBuf;
@@ -705,6 +727,12 @@ private:
   MemBuf _dataBuf;
   string _auxXml;
 
+  // data buffer compression - the context is created on first
+  // use and not shared between copies
+
+  ta_compress_ctx_t *_compressCtx;
+  MemBuf _workBuf;
+
   vector<time_t> _timeList;
 
   // functions
@@ -69,6 +69,13 @@ public:
   // specify uniqueness in the returned data set
 
   void setUnique(Spdb::get_unique_t state) { _unique = state; }
+
+  // Option to use the horizontal limits from the client to
+  // constrain the get to chunks with an overlapping bounding box.
+  // Only useful if the writer stores bounding boxes, see
+  // Spdb::setPutChunkBbox(). Off by default.
+
+  void setBboxFromHorizLimits(bool state) { _bboxFromHorizLimits = state; }
   
 protected:
 
@@ -96,6 +103,10 @@ protected:
   // uniqueness on get
 
   Spdb::get_unique_t _unique;
+
+  // use horiz limits as bounding box on get
+
+  bool _bboxFromHorizLimits;
   
   // Allocate, load, and free the server parameters from the specified file
   // Alloc should return 0 if successful
@@ -74,13 +74,18 @@
 #include <cstdio>
 #include <string>
 #include <vector>
+#include <set>
 #include <iostream>
+#include <memory>
 #include <toolsa/MemBuf.hh>
+#include <toolsa/compress.h>
 #include <dataport/port_types.h>
 #include <Spdb/Product_defines.hh>
 
 using namespace std;
 
+class SpdbIndexEntry;
+
 ///////////////////////////////////////////////////////////////
 // class definition
 
@@ -162,6 +167,33 @@ public:
   
   void setPutMode(put_mode_t mode);
 
+  ////////////////////////////////////////////////////
+  // Group commit for high-rate puts.
+  //
+  // By default each put reads and rewrites the whole index file
+  // for the day. If group commit is set, puts in putModeAdd to a
+  // local directory instead append the chunk data to the data file,
+  // and the chunk refs to a journal file for the day. The journal
+  // is merged into the index once it holds max_chunks entries,
+  // or max_msecs after its first entry, whichever comes first.
+  //
+  // Readers only see the chunks after the merge. The time limit is
+  // only checked on put, so call flushPuts() when a burst of puts
+  // is over. Pending chunks are also flushed by the destructor.
+  //
+  // The first put for a day, and puts in other modes, are done
+  // in the normal way. Any other write to the day, by this or another
+  // process, merges the journal first.
+  
+  void setPutGroupCommit(int max_chunks, int max_msecs);
+  void clearPutGroupCommit();
+
+  ////////////////////////////////////////////////////
+  // Merge journals from group-committed puts into the index.
+  // Returns 0 on success, -1 on error
+  
+  int flushPuts();
+
   ////////////////////////////////////////////////////
   // set the lead time storage
   // If you are dealing with forecast data, you may wish to store
@@ -228,6 +260,16 @@ public:
 		    const chunk_ref_t *chunk_refs,
 		    const void *chunk_data);
 
+  //////////////////////////////////////////////////////////////
+  // Set the lat/lon bounding box for the chunk most recently
+  // added with addPutChunk(). This is optional. If it is set,
+  // gets with setBboxOnGet() can skip the chunk without reading
+  // it. For a point product, set min and max to the point.
+  // Longitudes should be in the range -180 to 180.
+
+  void setPutChunkBbox(double min_lat, double min_lon,
+                       double max_lat, double max_lon);
+
   
   //////////////////////////////////////////////
   // Set respect_zero_types on put.
@@ -517,6 +559,38 @@ public:
     _latestValidWriteTime = 0;
   }
 
+  /////////////////////////////////////////////////////////
+  // Option to constrain gets to a lat/lon bounding box.
+  // If set, chunks with a stored bounding box which does not
+  // overlap the requested box are not returned, and their data
+  // is not read. Chunks without a stored bounding box are always
+  // returned, so the client should still check the contents.
+  // Because the stored boxes are rounded outwards to 0.01 deg,
+  // chunks just outside the box may also be returned.
+  // The box may not cross the date line.
+
+  void setBboxOnGet(double min_lat, double min_lon,
+                    double max_lat, double max_lon);
+
+  void clearBboxOnGet() { _bboxOnGet = false; }
+
+  bool isBboxOnGetSet() const { return _bboxOnGet; }
+  double getBboxOnGetMinLat() const { return _getMinLat; }
+  double getBboxOnGetMinLon() const { return _getMinLon; }
+  double getBboxOnGetMaxLat() const { return _getMaxLat; }
+  double getBboxOnGetMaxLon() const { return _getMaxLon; }
+
+  // store and retrieve the bounding box in the aux ref.
+  // getAuxBbox() returns false if the box is not set.
+
+  static void setAuxBbox(aux_ref_t &aux,
+                         double min_lat, double min_lon,
+                         double max_lat, double max_lon);
+
+  static bool getAuxBbox(const aux_ref_t &aux,
+                         double &min_lat, double &min_lon,
+                         double &max_lat, double &max_lon);
+
   ////////////////////////////////////////////////////////////
   // get the first, last and last_valid_time in the data base
   // Use getFirstTime(), getLastTime() and getLastValidTime()
@@ -736,6 +810,7 @@ public:
   static int _fileMinorVersion;
   static const char *_indxExt;
   static const char *_dataExt;
+  static const char *_jrnlExt;
   
   // name of application
   
@@ -752,6 +827,7 @@ public:
   string _path;
   char _indxPath[SPDB_PATH_MAX];
   char _dataPath[SPDB_PATH_MAX];
+  char _jrnlPath[SPDB_PATH_MAX];
   char _lockPath[SPDB_PATH_MAX];
   
   // file header and chunk refs
@@ -759,6 +835,12 @@ public:
   header_t _hdr;
   MemBuf _hdrRefBuf;
   MemBuf _hdrAuxBuf;
+
+  // index from the process-level cache, for reads - see
+  // SpdbIndexCache. If set, the chunk refs are taken from the
+  // cache entry instead of the buffers above.
+
+  std::shared_ptr<const SpdbIndexEntry> _cachedIndx;
   
   // get() chunk refs and data
   
@@ -780,6 +862,12 @@ public:
   
   bool _checkWriteTimeOnGet;
   time_t _latestValidWriteTime;
+
+  // Option to constrain gets to a bounding box
+
+  bool _bboxOnGet;
+  double _getMinLat, _getMinLon;
+  double _getMaxLat, _getMaxLon;
   
   // put attributes
   
@@ -791,11 +879,30 @@ public:
   time_t _latestValidTimePut;
   lead_time_storage_t _leadTimeStorage;
 
+  // group commit - days with journals pending merge
+
+  int _groupMaxChunks;
+  int _groupMaxMsecs;
+  string _groupDir;
+  int _groupProdId;
+  string _groupProdLabel;
+  set<int> _groupDays;
+  time_t _groupLatestValid;
+  int _groupMaxDataType;
+  int _groupMaxDataType2;
+  bool _journalApplied;
+
   // compression control
 
   compression_t _chunkCompressOnPut;
   bool _chunkUncompressOnGet;
 
+  // compression context, created on first use, and the
+  // work buffer for uncompressing chunks on read
+
+  std::shared_ptr<ta_compress_ctx_t> _compressCtx;
+  MemBuf _uncompressBuf;
+
   // auxiliary XML buffer
   // may be used to pass extra information from a client
   // to a server
@@ -843,6 +950,18 @@ public:
                      const void *chunk_data);
   
   int _put(int prod_id, const string &prod_label);
+
+  int _writeLdataInfo(time_t latest_valid_time,
+                      int max_data_type,
+                      int max_data_type2);
+
+  // group commit
+
+  int _appendPut(int prod_id, const string &prod_label);
+  int _appendToJournal(const vector<int> &chunk_indices,
+                       int &n_pending, double &age_msecs);
+  int _commitJournal(int day);
+  int _applyJournal();
   
   int _erase();
   
@@ -899,6 +1018,8 @@ public:
                  time_t valid_time,
                  open_mode_t mode,
                  bool read_chunk_refs = true);
+
+  void _computePaths(time_t valid_time);
   
   int _openReadWrite(int prod_id,
                      open_mode_t mode,
@@ -909,6 +1030,10 @@ public:
                   time_t valid_time,
                   open_mode_t mode);
   
+  int _checkIndxHdr(int prod_id);
+
+  int _openDataForRead();
+
   int _checkOpen(int prod_id,
                  const string &prod_label,
                  time_t valid_time,
@@ -970,6 +1095,11 @@ public:
 
   void _readChunkRefs();
 
+  const chunk_ref_t *_hdrRefs() const;
+  const aux_ref_t *_hdrAuxs() const;
+  chunk_ref_t *_fileRefs();
+  aux_ref_t *_fileAuxs();
+
   int _checkTypeThenReadChunk(int data_type,
                               int data_type2,
                               const chunk_ref_t &ref,
@@ -979,6 +1109,17 @@ public:
   int _readChunk(chunk_ref_t &ref, aux_ref_t &aux,
                  MemBuf &buf, bool doUncompress);
 
+  int _uncompressChunk(chunk_ref_t &ref, aux_ref_t &aux,
+                       MemBuf &buf, bool doUncompress);
+
+  ta_compress_ctx_t *_getCompressCtx();
+
+  // for binary search of refs on valid time
+
+  static bool _refTimeBefore(const chunk_ref_t &ref, time_t valid_time) {
+    return (time_t) ref.valid_time < valid_time;
+  }
+
   int _setEarliestValid(time_t valid_time, time_t expire_time);
 
   int _storeChunk(const chunk_ref_t *input_ref,
@@ -995,6 +1136,8 @@ public:
   int _addChunkRef(const chunk_ref_t &inref,
                    const aux_ref_t &inaux);
 
+  void _updateHdrStats(const chunk_ref_t &inref);
+
   int _eraseChunks(time_t valid_time, int data_type, int data_type2);
 
   void _eraseChunkRef(time_t valid_time, int posn);
@@ -1007,6 +1150,8 @@ public:
 
   int _defrag();
 
+  bool _bboxOverlaps(const aux_ref_t &aux) const;
+
   bool _acceptRef(int data_type,
                   int data_type2,
                   const chunk_ref_t &ref,
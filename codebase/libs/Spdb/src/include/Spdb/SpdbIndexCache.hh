@@ -0,0 +1,144 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////
+// SpdbIndexCache.hh
+//
+// Process-level cache of SPDB index files, for reads.
+//
+// A server which handles many requests for the same product reads
+// the same day index files over and over. This cache keeps the
+// decoded header, chunk refs and aux refs for recently used index
+// files, so that a read only needs to stat the file.
+//
+// Entries are keyed on the index path, and are checked against the
+// device, inode, size and modify/change times (to the nanosecond) of
+// the open file, and against the generation in the file header, which
+// the writer increments whenever the refs change. The generation
+// catches rewrites within the time stamp resolution of the file
+// system. If the file has changed, the entry is reloaded. The refs
+// are stored big-endian on disk, so they are swapped into the entry.
+//
+// Entries are shared between readers, so they are const. Spdb only
+// modifies the refs it reads itself, for files opened for writing.
+//
+// Compressed index files are not cached.
+//
+// The cache is bounded in total size - the least recently used
+// entries are removed when the limit is exceeded. The limit is
+// set from the environment variable SPDB_INDEX_CACHE_MB, default
+// 256. Set SPDB_INDEX_CACHE to FALSE to disable the cache.
+//
+// The cache is thread-safe. Entries are reference counted, so an
+// entry in use by a reader stays valid after it is evicted.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////
+
+#ifndef SpdbIndexCache_HH
+#define SpdbIndexCache_HH
+
+#include <Spdb/Spdb.hh>
+#include <toolsa/MemBuf.hh>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <map>
+#include <memory>
+#include <string>
+using namespace std;
+
+// cached index file
+
+class SpdbIndexEntry {
+public:
+  Spdb::header_t hdr;
+  MemBuf refBuf;
+  MemBuf auxBuf;
+};
+
+class SpdbIndexCache {
+
+public:
+
+  typedef std::shared_ptr<const SpdbIndexEntry> EntryPtr;
+
+  // Is the cache enabled?
+
+  static bool isEnabled();
+
+  // Get the entry for an index file, loading it if it is not in
+  // the cache or if the file has changed.
+  // Returns NULL if the file cannot be cached - for example it is
+  // compressed - in which case the caller should read the file.
+
+  static EntryPtr get(const string &indxPath);
+
+  // Remove all entries
+
+  static void clear();
+
+  // statistics
+
+  static int getNHits() { return _nHits; }
+  static int getNLoads() { return _nLoads; }
+
+protected:
+
+  class CacheEntry {
+  public:
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+    struct timespec ctime;
+    size_t nbytes;
+    unsigned long lastUsed;
+    EntryPtr entry;
+  };
+
+  typedef map<string, CacheEntry> CacheMap;
+
+  static CacheMap _cache;
+  static size_t _totalBytes;
+  static unsigned long _useCount;
+  static int _nHits;
+  static int _nLoads;
+  static pthread_mutex_t _mutex;
+
+  static size_t _getMaxBytes();
+  static bool _matches(const CacheEntry &centry, const struct stat &fstat);
+  static int _readGeneration(int fd, si32 &generation);
+  static int _readFully(int fd, void *buf, size_t len, off_t offset);
+  static EntryPtr _load(int fd, const struct stat &fstat);
+  static void _evict(size_t maxBytes);
+
+private:
+
+  // static class, no instances
+
+  SpdbIndexCache();
+
+};
+
+#endif
@@ -114,7 +114,11 @@ typedef struct {
 
   si32 lead_time_storage; // see lead_time_storage_t above
 
-  si32 spares[66];
+  si32 generation;     // incremented each time the chunk refs are
+                       // written. Used to check whether a journal
+                       // of group-committed puts has been applied.
+
+  si32 spares[65];
     
   // Minute_posn stores the first chunk position for each minute
   // of the day. If no chunk corresponds to this minute the value is -1
@@ -151,11 +155,42 @@ typedef struct {
   
   ti32 write_time; // time entry written to the data base
   ui32 compression;
-  ui32 spares[4];
+  ui32 spares[4];    // see bounding box below
   char tag[TAG_LEN];
   
 } aux_ref_t;
 
+// Optional lat/lon bounding box of the chunk contents, for point
+// and polygon products. See Spdb::setPutChunkBbox().
+// If set, it is stored in the aux ref spares:
+//   spares[0]: SPDB_AUX_BBOX_FLAG
+//   spares[1]: min and max lat, as 2 si16s, in SPDB_BBOX_SCALE units
+//   spares[2]: min and max lon, as 2 si16s, in SPDB_BBOX_SCALE units
+// The limits are rounded outwards, so the stored box always
+// contains the original one.
+
+#define SPDB_AUX_BBOX_FLAG 0x42424f58 // "BBOX"
+#define SPDB_BBOX_SCALE 100.0         // 0.01 deg
+
+// Journal for group-committed puts. See Spdb::setPutGroupCommit().
+// The journal file (YYYYMMDD.jrnl) holds this header, followed by
+// a chunk_ref_t and aux_ref_t for each chunk which has been appended
+// to the data file but not yet added to the index. All in BE order.
+// The journal is only applied if its generation matches that of
+// the index, so that it cannot be applied twice.
+
+#define SPDB_JOURNAL_MAGIC 0x4a524e4c // "JRNL"
+
+typedef struct {
+
+  si32 magic;        // SPDB_JOURNAL_MAGIC
+  si32 generation;   // index generation when the journal was started
+  ti32 start_time;   // time of first entry - secs
+  si32 start_usecs;  // time of first entry - usecs
+  si32 spares[4];
+
+} journal_hdr_t;
+
 // chunk class
 
 class chunk_t {
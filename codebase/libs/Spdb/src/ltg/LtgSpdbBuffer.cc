@@ -224,14 +224,33 @@ int LtgSpdbBuffer::writeToDatabase(char *database_url,
       spdb.setPutMode(Spdb::putModeAddUnique);
 
     data_len = _strikeBufferUsed * sizeof(LTG_strike_t);
+    spdb.clearPutChunks();
+    spdb.addPutChunk(data_type,
+		     strike_time,
+		     strike_time + expire_secs,
+		     data_len,
+		     (void *)_strikeBufferBE);
+
+    // store the bounding box of the strikes with the chunk
+
+    {
+      double minLat = _strikeBuffer[0].latitude;
+      double maxLat = minLat;
+      double minLon = _strikeBuffer[0].longitude;
+      double maxLon = minLon;
+      for (int strike = 1; strike < _strikeBufferUsed; strike++) {
+	const LTG_strike_t &ss = _strikeBuffer[strike];
+	minLat = MIN(minLat, ss.latitude);
+	maxLat = MAX(maxLat, ss.latitude);
+	minLon = MIN(minLon, ss.longitude);
+	maxLon = MAX(maxLon, ss.longitude);
+      }
+      spdb.setPutChunkBbox(minLat, minLon, maxLat, maxLon);
+    }
+
     if (spdb.put(database_url,
 		 SPDB_KAV_LTG_ID,
-		 SPDB_KAV_LTG_LABEL,
-		 data_type,
-		 strike_time,
-		 strike_time + expire_secs,
-		 data_len,
-		 (void *)_strikeBufferBE)) {
+		 SPDB_KAV_LTG_LABEL)) {
       fprintf(stderr, "ERROR: LtgSpdbBuffer::writeToDatabase\n");
       fprintf(stderr, "  Error writing ltg to URL <%s>\n",
 	      database_url);
@@ -270,14 +289,33 @@ int LtgSpdbBuffer::writeToDatabase(char *database_url,
 
     data_type = 0;
     data_len = _strikeBufferUsed * sizeof(LTG_extended_t);
+    spdb.clearPutChunks();
+    spdb.addPutChunk(data_type,
+		     strike_time,
+		     strike_time + expire_secs,
+		     data_len,
+		     (void *)_strikeBufferBEextended);
+
+    // store the bounding box of the strikes with the chunk
+
+    {
+      double minLat = _strikeBufferExtended[0].latitude;
+      double maxLat = minLat;
+      double minLon = _strikeBufferExtended[0].longitude;
+      double maxLon = minLon;
+      for (int strike = 1; strike < _strikeBufferUsed; strike++) {
+	const LTG_extended_t &ss = _strikeBufferExtended[strike];
+	minLat = MIN(minLat, ss.latitude);
+	maxLat = MAX(maxLat, ss.latitude);
+	minLon = MIN(minLon, ss.longitude);
+	maxLon = MAX(maxLon, ss.longitude);
+      }
+      spdb.setPutChunkBbox(minLat, minLon, maxLat, maxLon);
+    }
+
     if (spdb.put(database_url,
 		 SPDB_LTG_ID,
-		 SPDB_LTG_LABEL,
-		 data_type,
-		 strike_time,
-		 strike_time + expire_secs,
-		 data_len,
-		 (void *)_strikeBufferBEextended)) {
+		 SPDB_LTG_LABEL)) {
       fprintf(stderr, "ERROR: LtgSpdbBuffer::writeToDatabase\n");
       fprintf(stderr, "  Error writing extended ltg to URL <%s>\n",
 	      database_url);
@@ -32,7 +32,10 @@
 //
 ///////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include <advect/GridAdvect.hh>
+#include <advect/ancilla/parallel.h>
 #include <euclid/CircularTemplate.hh>
 #include <euclid/EllipticalTemplate.hh>
 #include <euclid/Pjg.hh>
@@ -42,6 +45,8 @@
 #include <toolsa/pmu.h>
 
 
+const int GridAdvect::TILE_ROWS = 16;
+
 //////////////
 // Constructor
 
@@ -54,7 +59,9 @@ GridAdvect::GridAdvect(const double image_val_min,
         _imageValMax(image_val_max),
         _checkImageValues(image_val_min < image_val_max),
         _replaceValueWithMax(replace_value_with_max),
-        _forecastData(0)
+        _forecastData(0),
+        _trajNx(0),
+        _trajNy(0)
 {
   if (_debugFlag) {
     cerr << "In debug mode" << endl;
@@ -141,3 +148,180 @@ bool GridAdvect::compute(Advector &advector,
 
   return true;
 }
+
+////////////////////////////
+// precomputeTrajectories()
+//
+// Trace each forecast grid location back to its source location and
+// save the bilinear stencil, for use by computeFromTrajectories().
+//
+// Returns true on success, false on failure
+
+bool GridAdvect::precomputeTrajectories(const Advector &advector,
+                                        const Pjg &projection,
+                                        const int n_threads)
+{
+  int nx, ny, nz;
+  projection.getGridDims(nx, ny, nz);
+
+  if (nx <= 0 || ny <= 0)
+  {
+    cerr << "ERROR - GridAdvect::precomputeTrajectories" << endl;
+    cerr << "Invalid grid dimensions: " << nx << " x " << ny << endl;
+    return false;
+  }
+
+  PMU_auto_register("GridAdvect::precomputeTrajectories");
+
+  _forecastProj = projection;
+  _trajNx = nx;
+  _trajNy = ny;
+  _trajectories.resize((size_t)nx * ny);
+
+  ancilla::parallel_rows(n_threads, ny, TILE_ROWS,
+                         [&](int y_start, int y_end)
+  {
+    _computeTrajectoryRows(advector, y_start, y_end);
+  });
+
+  return true;
+}
+
+////////////////////////////
+// computeFromTrajectories()
+//
+// Compute the forecast grid by interpolating the image data at the
+// source locations saved by precomputeTrajectories().
+//
+// Returns true on success, false on failure
+
+bool GridAdvect::computeFromTrajectories(const fl32 *image_data,
+                                         const fl32 missing_data_value,
+                                         const int n_threads)
+{
+  if (_trajectories.empty())
+  {
+    cerr << "ERROR - GridAdvect::computeFromTrajectories" << endl;
+    cerr << "precomputeTrajectories() must be called first" << endl;
+    return false;
+  }
+
+  PMU_auto_register("GridAdvect::computeFromTrajectories");
+
+  delete[] _forecastData;
+  _forecastData = new fl32[_trajectories.size()];
+
+  ancilla::parallel_rows(n_threads, _trajNy, TILE_ROWS,
+                         [&](int y_start, int y_end)
+  {
+    _gatherRows(image_data, missing_data_value, y_start, y_end);
+  });
+
+  return true;
+}
+
+////////////////////////////
+// _computeTrajectoryRows()
+//
+// Fill in the bilinear stencils for the given rows.
+
+void GridAdvect::_computeTrajectoryRows(const Advector &advector,
+                                        const int y_start,
+                                        const int y_end)
+{
+  int nx = _trajNx;
+  int ny = _trajNy;
+
+  for (int y_index = y_start; y_index < y_end; y_index++)
+  {
+    trajectory_t *traj = &_trajectories[(size_t)y_index * nx];
+
+    for (int x_index = 0; x_index < nx; x_index++, traj++)
+    {
+      traj->index = -1;
+
+      double src_x, src_y;
+      if (!advector.calcSourceLocation(x_index, y_index, src_x, src_y))
+        continue;
+
+      // Use the same extent as the nearest neighbour lookup in
+      // compute(), clamping to the outer grid centres.
+
+      if (src_x < -0.5 || src_x >= nx - 0.5 ||
+          src_y < -0.5 || src_y >= ny - 0.5)
+        continue;
+
+      src_x = std::min(std::max(src_x, 0.0), (double)(nx - 1));
+      src_y = std::min(std::max(src_y, 0.0), (double)(ny - 1));
+
+      int x0 = std::min((int)src_x, std::max(nx - 2, 0));
+      int y0 = std::min((int)src_y, std::max(ny - 2, 0));
+
+      traj->index = x0 + y0 * nx;
+      traj->dx = (nx > 1) ? 1 : 0;
+      traj->dy = (ny > 1) ? nx : 0;
+      traj->wx = (fl32)(src_x - x0);
+      traj->wy = (fl32)(src_y - y0);
+
+    } /* endfor - x_index */
+  } /* endfor - y_index */
+}
+
+////////////////////////////
+// _gatherRows()
+//
+// Interpolate the forecast values for the given rows.
+
+void GridAdvect::_gatherRows(const fl32 *image,
+                             const fl32 missing_data_value,
+                             const int y_start,
+                             const int y_end)
+{
+  int nx = _trajNx;
+
+  for (int y_index = y_start; y_index < y_end; y_index++)
+  {
+    const trajectory_t *traj = &_trajectories[(size_t)y_index * nx];
+    fl32 *forecast = _forecastData + (size_t)y_index * nx;
+
+    for (int x_index = 0; x_index < nx; x_index++, traj++, forecast++)
+    {
+      *forecast = missing_data_value;
+
+      if (traj->index < 0)
+        continue;
+
+      const fl32 *src = image + traj->index;
+      fl32 vals[4] = { src[0], src[traj->dx],
+                       src[traj->dy], src[traj->dy + traj->dx] };
+      fl32 wts[4] = { (1.0f - traj->wx) * (1.0f - traj->wy),
+                      traj->wx * (1.0f - traj->wy),
+                      (1.0f - traj->wx) * traj->wy,
+                      traj->wx * traj->wy };
+
+      double sum = 0.0;
+      double sum_wt = 0.0;
+
+      for (int i = 0; i < 4; i++)
+      {
+        if (wts[i] <= 0.0f || !_isValid(vals[i], missing_data_value))
+          continue;
+
+        // as in compute(), values are only clamped when the
+        // image values are being checked
+
+        fl32 val = vals[i];
+        if (_checkImageValues && _replaceValueWithMax &&
+            val > _imageValMax)
+          val = _imageValMax;
+
+        sum += wts[i] * val;
+        sum_wt += wts[i];
+      }
+
+      if (sum_wt > 0.0)
+        *forecast = (fl32)(sum / sum_wt);
+
+    } /* endfor - x_index */
+  } /* endfor - y_index */
+}
@@ -0,0 +1,221 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+///////////////////////////////////////////////////////////////
+// OpticalFlowTracker.cc
+//
+// OpticalFlowTracker class
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#include <advect/OpticalFlowTracker.hh>
+#include <advect/ancilla/optical_flow.h>
+#include <advect/ancilla/array_utils.h>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+using namespace ancilla;
+
+//////////////
+// Constructor
+
+OpticalFlowTracker::OpticalFlowTracker(const bool debug_flag) :
+  _debugFlag(debug_flag),
+  _scaleFactor(0.5),
+  _maxLevels(100),
+  _windowSize(5),
+  _nIterations(3),
+  _polygonNeighborhood(5),
+  _polygonSigma(1.1),
+  _interpOverMissing(false),
+  _interpSpacing(8),
+  _minFracBinsForAvg(0.05),
+  _idwLowResPwr(4.0),
+  _idwHighResPwr(3.0),
+  _nThreads(1)
+{
+}
+
+/////////////
+// Destructor
+
+OpticalFlowTracker::~OpticalFlowTracker()
+{
+}
+
+/////////////////////////////////////////////////
+// setInterpOverMissing()
+
+void OpticalFlowTracker::setInterpOverMissing(const bool interp,
+                                              const int spacing,
+                                              const double min_frac_bins_for_avg,
+                                              const double idw_low_res_pwr,
+                                              const double idw_high_res_pwr)
+{
+  _interpOverMissing = interp;
+  _interpSpacing = spacing;
+  _minFracBinsForAvg = min_frac_bins_for_avg;
+  _idwLowResPwr = idw_low_res_pwr;
+  _idwHighResPwr = idw_high_res_pwr;
+}
+
+/////////////////////////////////////////////////
+// compute()
+//
+// Returns true on success, false on failure
+
+bool OpticalFlowTracker::compute(const int nx, const int ny,
+                                 const fl32 *prev_grid, const fl32 prev_missing,
+                                 const fl32 *curr_grid, const fl32 curr_missing,
+                                 const double threshold,
+                                 fl32 *u_motion, fl32 *v_motion,
+                                 const fl32 missing_motion,
+                                 const bool use_initial_motion)
+{
+  size_t npoints = (size_t) nx * ny;
+
+  // set up arrays for algorithm, with missing data as NaNs
+
+  size_t dims[2];
+  dims[0] = ny;
+  dims[1] = nx;
+
+  array2<fl32> prevArray(dims);
+  array2<fl32> currArray(dims);
+  fl32 *prevData = prevArray.data();
+  fl32 *currData = currArray.data();
+
+  for (size_t ii = 0; ii < npoints; ii++) {
+    prevData[ii] = (prev_grid[ii] == prev_missing ? NAN : prev_grid[ii]);
+    currData[ii] = (curr_grid[ii] == curr_missing ? NAN : curr_grid[ii]);
+  }
+
+  // get min and max so we can scale between 2.5 and 252.5
+
+  double minVal = 1.0e99;
+  double maxVal = -1.0e99;
+  for (size_t ii = 0; ii < npoints; ii++) {
+    if (std::isfinite(prevData[ii])) {
+      minVal = std::min(minVal, (double) prevData[ii]);
+      maxVal = std::max(maxVal, (double) prevData[ii]);
+    }
+    if (std::isfinite(currData[ii])) {
+      minVal = std::min(minVal, (double) currData[ii]);
+      maxVal = std::max(maxVal, (double) currData[ii]);
+    }
+  }
+
+  if (minVal > maxVal) {
+    // no data, so no motion
+    if (_debugFlag) {
+      std::cerr << "OpticalFlowTracker::compute - no valid data" << std::endl;
+    }
+    for (size_t ii = 0; ii < npoints; ii++) {
+      u_motion[ii] = missing_motion;
+      v_motion[ii] = missing_motion;
+    }
+    return true;
+  }
+
+  double scale = 1.0;
+  if (maxVal > minVal) {
+    scale = 250.0 / (maxVal - minVal);
+  }
+  double offset = 2.5;
+
+  for (size_t ii = 0; ii < npoints; ii++) {
+    if (std::isfinite(prevData[ii])) {
+      prevData[ii] = (prevData[ii] - minVal) * scale + offset;
+    }
+    if (std::isfinite(currData[ii])) {
+      currData[ii] = (currData[ii] - minVal) * scale + offset;
+    }
+  }
+  double scaledThreshold = (threshold - minVal) * scale + offset;
+
+  // initialize arrays to hold the motion
+
+  array2<fl32> uArray(dims);
+  array2<fl32> vArray(dims);
+  fl32 *uu = uArray.data();
+  fl32 *vv = vArray.data();
+  if (use_initial_motion) {
+    for (size_t ii = 0; ii < npoints; ii++) {
+      uu[ii] = (u_motion[ii] == missing_motion ? 0.0 : u_motion[ii]);
+      vv[ii] = (v_motion[ii] == missing_motion ? 0.0 : v_motion[ii]);
+    }
+  } else {
+    array_utils::zero(uArray);
+    array_utils::zero(vArray);
+  }
+
+  // perform the tracking
+
+  try {
+
+    optical_flow tracker(nx, ny,
+                         _scaleFactor,
+                         _maxLevels,
+                         _windowSize,
+                         _nIterations,
+                         _polygonNeighborhood,
+                         _polygonSigma);
+    tracker.set_threads(_nThreads);
+    
+    double background = scaledThreshold / 2.0;
+    double gain = 1.0;
+    
+    tracker.determine_velocities(prevArray,
+                                 currArray,
+                                 uArray,
+                                 vArray,
+                                 use_initial_motion,
+                                 background,
+                                 scaledThreshold,
+                                 gain,
+                                 _interpOverMissing,
+                                 _interpSpacing,
+                                 _minFracBinsForAvg,
+                                 _idwLowResPwr,
+                                 _idwHighResPwr);
+
+  } catch (std::exception &e) {
+    std::cerr << "ERROR - OpticalFlowTracker::compute" << std::endl;
+    std::cerr << "  " << e.what() << std::endl;
+    return false;
+  }
+
+  // copy out, setting missing values
+
+  for (size_t ii = 0; ii < npoints; ii++) {
+    u_motion[ii] = (std::isfinite(uu[ii]) ? uu[ii] : missing_motion);
+    v_motion[ii] = (std::isfinite(vv[ii]) ? vv[ii] : missing_motion);
+  }
+
+  return true;
+
+}
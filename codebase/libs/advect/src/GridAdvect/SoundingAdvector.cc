@@ -42,7 +42,13 @@
 // Constructor
 
 SoundingAdvector::SoundingAdvector(const bool debug_flag) :
-  _debugFlag(debug_flag)
+  _debugFlag(debug_flag),
+  _uComp(0.0),
+  _vComp(0.0),
+  _xOffset(0),
+  _yOffset(0),
+  _xGridOffset(0.0),
+  _yGridOffset(0.0)
 {
   if (_debugFlag) {
     cerr << "In debug mode" << endl;
@@ -91,6 +97,8 @@ bool SoundingAdvector::precompute(const Pjg &projection,
 
   _xOffset = 0;
   _yOffset = 0;
+  _xGridOffset = 0.0;
+  _yGridOffset = 0.0;
   
   // Determine the distance for advection from sounding winds
 
@@ -101,8 +109,11 @@ bool SoundingAdvector::precompute(const Pjg &projection,
     double translate_km_x = _uComp * (double)lead_time_secs / 1000.0;
     double translate_km_y = _vComp * (double)lead_time_secs / 1000.0;
     
-    _xOffset = (int)(projection.km2xGrid(translate_km_x) + 0.5);
-    _yOffset = (int)(projection.km2yGrid(translate_km_y) + 0.5);
+    _xGridOffset = projection.km2xGrid(translate_km_x);
+    _yGridOffset = projection.km2yGrid(translate_km_y);
+    
+    _xOffset = (int)(_xGridOffset + 0.5);
+    _yOffset = (int)(_yGridOffset + 0.5);
   }
  
   return true;
@@ -135,3 +146,24 @@ int SoundingAdvector::calcFcstIndex(const int x_index,
 	
   return fcst_x + (fcst_y * nx);
 }
+
+
+////////////////////////////
+// calcSourceLocation()
+//
+// Calculate the fractional grid location in the original grid from
+// which this forecast grid location is advected.
+//
+// Returns true if successful, returns false if there is no motion
+// in that location.
+
+bool SoundingAdvector::calcSourceLocation(const int x_index,
+                                          const int y_index,
+                                          double &src_x,
+                                          double &src_y) const
+{
+  src_x = (double)x_index - _xGridOffset;
+  src_y = (double)y_index - _yGridOffset;
+
+  return true;
+}
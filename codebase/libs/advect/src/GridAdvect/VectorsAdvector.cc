@@ -379,6 +379,38 @@ int VectorsAdvector::calcFcstIndex(const int x_index,
 }
 
 
+////////////////////////////
+// calcSourceLocation()
+//
+// Calculate the fractional grid location in the original grid from
+// which this forecast grid location is advected.
+//
+// Returns true if successful, returns false if there is no motion
+// in that location.
+
+bool VectorsAdvector::calcSourceLocation(const int x_index,
+                                         const int y_index,
+                                         double &src_x,
+                                         double &src_y) const
+{
+  int nx = _motionProjection.getNx();
+  
+  int index = x_index + (y_index * nx);
+  
+  if (_motionUData[index] == MISSING_MOTION_VALUE ||
+      _motionVData[index] == MISSING_MOTION_VALUE)
+    return false;
+  
+  double x_km = _motionUData[index] * (double)_leadTimeSecs / 1000.0;
+  double y_km = _motionVData[index] * (double)_leadTimeSecs / 1000.0;
+	
+  src_x = (double)x_index - _motionProjection.km2xGrid(x_km);
+  src_y = (double)y_index - _motionProjection.km2yGrid(y_km);
+  
+  return true;
+}
+
+
 /////////////////////
 // _loadMotionGrid()
 //
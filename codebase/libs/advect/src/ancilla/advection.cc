@@ -21,7 +21,7 @@
 // ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
 // %=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%
 
-#include "advection.h"
+#include <advect/ancilla/advection.h>
 #include <stdexcept>
 
 using namespace ancilla;
@@ -0,0 +1,161 @@
+// %=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%
+// ** Ancilla Radar Quality Control System (ancilla)
+// ** Copyright BOM (C) 2013
+// ** Bureau of Meteorology, Commonwealth of Australia, 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from the BOM.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of the BOM nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// %=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%
+
+#include <advect/ancilla/filters.h>
+#include <advect/ancilla/parallel.h>
+
+#include <alloca.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace ancilla;
+
+// rows per tile when sharing the passes between threads
+static constexpr int tile_rows = 32;
+
+// horizontal pass, with the edge pixels replicated
+// note: the kernel loop is outermost so that the inner loop runs over contiguous
+//       memory and can be vectorised by the compiler
+static void run_kernel_x(
+      array2<real>& output
+    , const array2<real>& input
+    , const real kernel[]
+    , int kernel_size
+    , int threads)
+{
+  // get signed versions of our dims (eliminates many casts)
+  const int dims_x = output.cols();
+  const int dims_y = output.rows();
+
+  if (dims_x < kernel_size)
+    throw std::runtime_error("filter field smaller than kernel - unimplemented feature");
+
+  const int side = kernel_size / 2;
+  parallel_rows(threads, dims_y, tile_rows, [&](int y0, int y1)
+  {
+    std::vector<real> pad(dims_x + side * 2);
+    for (int y = y0; y < y1; ++y)
+    {
+      // padded copy of the row
+      auto inp = input[y];
+      for (int x = 0; x < side; ++x)
+      {
+        pad[x] = inp[0];
+        pad[dims_x + side + x] = inp[dims_x - 1];
+      }
+      std::copy(inp, inp + dims_x, &pad[side]);
+
+      auto out = output[y];
+      for (int x = 0; x < dims_x; ++x)
+        out[x] = 0.0_r;
+      for (int i = 0; i < kernel_size; ++i)
+      {
+        const real k = kernel[i];
+        const real* src = &pad[i];
+        for (int x = 0; x < dims_x; ++x)
+          out[x] += k * src[x];
+      }
+    }
+  });
+}
+
+// vertical pass, with the edge rows replicated
+// note: as above, the inner loop runs along the rows
+static void run_kernel_y(
+      array2<real>& output
+    , const array2<real>& input
+    , const real kernel[]
+    , int kernel_size
+    , int threads)
+{
+  // get signed versions of our dims (eliminates many casts)
+  const int dims_x = output.cols();
+  const int dims_y = output.rows();
+
+  if (dims_y < kernel_size)
+    throw std::runtime_error("filter field smaller than kernel - unimplemented feature");
+
+  const int side = kernel_size / 2;
+  parallel_rows(threads, dims_y, tile_rows, [&](int y0, int y1)
+  {
+    for (int y = y0; y < y1; ++y)
+    {
+      auto out = output[y];
+      for (int x = 0; x < dims_x; ++x)
+        out[x] = 0.0_r;
+      for (int i = 0; i < kernel_size; ++i)
+      {
+        const real k = kernel[i];
+        const real* src = input[std::min(std::max(y + i - side, 0), dims_y - 1)];
+        for (int x = 0; x < dims_x; ++x)
+          out[x] += k * src[x];
+      }
+    }
+  });
+}
+
+void ancilla::filters::gaussian_blur(
+      array2<real>& output
+    , const array2<real>& input
+    , int kernel_size
+    , real sigma
+    , int threads)
+{
+  // sanity checks
+  if (output.size() != input.size())
+    throw std::logic_error("array size mismatch");
+
+  // auto calculate the kernel size from sigma or vice versa (if desired)
+  if (kernel_size == 0 && sigma > 0.0_r)
+    kernel_size = static_cast<int>(std::round(sigma * 4 * 2 + 1)) | 1;
+  else if (sigma <= 0.0_r && kernel_size > 0)
+    sigma = ((kernel_size - 1) * 0.5_r - 1.0_r) * 0.3_r + 0.8_r;
+
+  // sanity checks
+  if (kernel_size < 0 || kernel_size % 2 != 1)
+    throw std::invalid_argument("gaussian_blur: invalid kernel size (must be 0 or odd)");
+
+  // build the kernel
+  real* kernel = static_cast<real*>(alloca(kernel_size * sizeof(real)));
+  {
+    real scale_2x = -0.5_r / (sigma * sigma);
+    real sum = 0.0_r;
+    for (int i = 0; i < kernel_size; ++i)
+    {
+      real x = i - (kernel_size - 1) * 0.5_r;
+      kernel[i] = std::exp(scale_2x * x * x);
+      sum += kernel[i];
+    }
+    sum = 1.0_r / sum;
+    for (int i = 0; i < kernel_size; ++i)
+      kernel[i] *= sum;
+  }
+
+  // as our kernel is symetrical, we can do 2 passes of the 1D kernel
+  // the passes are not done in place, so that the rows are independent
+  array2<real> tmp(input.rows(), input.cols());
+  run_kernel_x(tmp, input, kernel, kernel_size, threads);
+  run_kernel_y(output, tmp, kernel, kernel_size, threads);
+}
+
@@ -21,9 +21,10 @@
 // ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
 // %=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%
 
-#include "optical_flow.h"
-#include "filters.h"
-#include "array_utils.h"
+#include <advect/ancilla/optical_flow.h>
+#include <advect/ancilla/filters.h>
+#include <advect/ancilla/array_utils.h>
+#include <advect/ancilla/parallel.h>
 
 #include <stdexcept>
 #include <limits>
@@ -32,6 +33,9 @@
 
 using namespace ancilla;
 
+// rows per tile when sharing the work between threads
+static constexpr int tile_rows = 32;
+
 optical_flow::optical_flow(
       size_t dim_x
     , size_t dim_y
@@ -47,6 +51,7 @@ optical_flow::optical_flow(
   , iterations_(iterations)
   , poly_n_(polygon_neighbourhood)
   , poly_sigma_(polygon_sigma)
+  , threads_(1)
 {
   constexpr int min_size = 32;
 
@@ -95,6 +100,7 @@ optical_flow::optical_flow(optical_flow&& rhs) noexcept
   , iterations_(rhs.iterations_)
   , poly_n_(rhs.poly_n_)
   , poly_sigma_(rhs.poly_sigma_)
+  , threads_(rhs.threads_)
   , info_(std::move(rhs.info_))
   , kbuf_(std::move(rhs.kbuf_))
   , ig11_(rhs.ig11_)
@@ -114,6 +120,7 @@ auto optical_flow::operator=(optical_flow&& rhs) noexcept -> optical_flow&
   iterations_ = rhs.iterations_;
   poly_n_ = rhs.poly_n_;
   poly_sigma_ = rhs.poly_sigma_;
+  threads_ = rhs.threads_;
   info_ = std::move(rhs.info_);
   kbuf_ = std::move(rhs.kbuf_);
   ig11_ = rhs.ig11_;
@@ -313,12 +320,12 @@ auto optical_flow::track_fields(
     if (lvl > 0)
     {
       array_utils::copy(img0, lag1);
-      filters::gaussian_blur(img0, img0, info.ksize, info.sigma);
+      filters::gaussian_blur(img0, img0, info.ksize, info.sigma, threads_);
       array_utils::interpolate(img1, img0);
       poly_exp(img1, r0);
 
       array_utils::copy(img0, lag0);
-      filters::gaussian_blur(img0, img0, info.ksize, info.sigma);
+      filters::gaussian_blur(img0, img0, info.ksize, info.sigma, threads_);
       array_utils::interpolate(img1, img0);
       poly_exp(img1, r1);
     }
@@ -329,7 +336,10 @@ auto optical_flow::track_fields(
     }
 
     // update the matricies
-    update_matrices(r0, r1, *flow_u, *flow_v, m, 0, flow_u->rows());
+    parallel_rows(threads_, flow_u->rows(), tile_rows, [&](int y0, int y1)
+    {
+      update_matrices(r0, r1, *flow_u, *flow_v, m, y0, y1);
+    });
 
     // perform our blur/update iterations
     for (int i = 0; i < iterations_; ++i) {
@@ -453,9 +463,23 @@ auto optical_flow::poly_exp_setup() -> void
 }
 
 auto optical_flow::poly_exp(const array2<real>& src, array2<vec5d>& dst) const -> void
+{
+  const int rows = src.rows();
+
+  // rows are independent, so share them between the threads
+  parallel_rows(threads_, rows, tile_rows, [&](int y0, int y1)
+  {
+    poly_exp_rows(src, dst, y0, y1);
+  });
+}
+
+auto optical_flow::poly_exp_rows(
+      const array2<real>& src
+    , array2<vec5d>& dst
+    , int row_from
+    , int row_to) const -> void
 {
   // allocate some buffers
-  // TODO - can this be allocated outside here to reduce repeat allocs?
   std::unique_ptr<real[]> rbuf(new real[(src.cols() + poly_n_ * 2) * 3]);
 
   // get the pointers into our buffers
@@ -468,7 +492,7 @@ auto optical_flow::poly_exp(const array2<real>& src, array2<vec5d>& dst) const -
   const int rows = src.rows();
   const int cols = src.cols();
 
-  for (int y = 0; y < rows; ++y)
+  for (int y = row_from; y < row_to; ++y)
   {
     real g0 = g[0], g1, g2;
     const real* srow0 = src[y];
@@ -535,10 +559,6 @@ auto optical_flow::poly_exp(const array2<real>& src, array2<vec5d>& dst) const -
       drow[x][4] = b6 * ig55_;
     }
   }
-
-  // TODO - why is this here?!?! from OpenCV implementation
-  // all this does is realign row with rbuf, but it's never used...
-  row -= poly_n_*3;
 }
 
 auto optical_flow::update_matrices(
@@ -642,32 +662,50 @@ auto optical_flow::blur_iteration(
     , bool update_mats) const -> void
 {
   const int frows = flow_u.rows();
+
+  // compute blur(G)*flow=blur(h)
+  parallel_rows(threads_, frows, tile_rows, [&](int y0, int y1)
+  {
+    blur_rows(mat, flow_u, flow_v, y0, y1);
+  });
+
+  // update the matrices from the new flow
+  // this must wait until the blur is complete, since each row of the blur reads
+  // the matrices from the neighbouring rows
+  if (update_mats)
+  {
+    parallel_rows(threads_, frows, tile_rows, [&](int y0, int y1)
+    {
+      update_matrices(r0, r1, flow_u, flow_v, mat, y0, y1);
+    });
+  }
+}
+
+auto optical_flow::blur_rows(
+      const array2<vec5d>& mat
+    , array2<real>& flow_u
+    , array2<real>& flow_v
+    , int row_from
+    , int row_to) const -> void
+{
+  const int frows = flow_u.rows();
   const int fcols = flow_u.cols();
 
   int m = win_size_ / 2;
-  int min_update_stripe = std::max((1 << 10) / fcols, win_size_);
   double scale = 1.0 / (win_size_ * win_size_);
 
   // allocate a buffer
-  // TODO - move this outside and unify with poly_exp's temp buffer since
-  //        we only need one of them at a time
   std::unique_ptr<vec5d[]> vbuf(new vec5d[fcols + m * 2 + 2]);
   vec5d* vsum = &vbuf[m+1];
 
-  // init vsum
-  const vec5d* srow0 = mat[0];
+  // init vsum with the window for the first row, replicating the edge rows
+  const vec5d* srow0;
   for (int x = 0; x < fcols; ++x)
-  {
-    vsum[x][0] = srow0[x][0] * (m + 2);
-    vsum[x][1] = srow0[x][1] * (m + 2);
-    vsum[x][2] = srow0[x][2] * (m + 2);
-    vsum[x][3] = srow0[x][3] * (m + 2);
-    vsum[x][4] = srow0[x][4] * (m + 2);
-  }
+    vsum[x][0] = vsum[x][1] = vsum[x][2] = vsum[x][3] = vsum[x][4] = 0.0;
 
-  for (int y = 1; y < m; ++y)
+  for (int y = row_from - m; y <= row_from + m; ++y)
   {
-    srow0 = mat[std::min(y, frows - 1)];
+    srow0 = mat[std::min(std::max(y, 0), frows - 1)];
     for (int x = 0; x < fcols; ++x)
     {
       vsum[x][0] += srow0[x][0];
@@ -678,23 +716,25 @@ auto optical_flow::blur_iteration(
     }
   }
 
-  // compute blur(G)*flow=blur(h)
-  for (int y = 0, y0 = 0; y < frows; ++y)
+  for (int y = row_from; y < row_to; ++y)
   {
     auto flow_u_y = flow_u[y];
     auto flow_v_y = flow_v[y];
 
-                 srow0 = mat[std::max(y - m - 1, 0)];
-    const vec5d* srow1 = mat[std::min(y + m, frows - 1)];
-
-    // vertical blur
-    for (int x = 0; x < fcols; ++x)
+    // vertical blur - slide the window down to this row
+    if (y > row_from)
     {
-      vsum[x][0] += srow1[x][0] - srow0[x][0];
-      vsum[x][1] += srow1[x][1] - srow0[x][1];
-      vsum[x][2] += srow1[x][2] - srow0[x][2];
-      vsum[x][3] += srow1[x][3] - srow0[x][3];
-      vsum[x][4] += srow1[x][4] - srow0[x][4];
+                   srow0 = mat[std::max(y - m - 1, 0)];
+      const vec5d* srow1 = mat[std::min(y + m, frows - 1)];
+
+      for (int x = 0; x < fcols; ++x)
+      {
+        vsum[x][0] += srow1[x][0] - srow0[x][0];
+        vsum[x][1] += srow1[x][1] - srow0[x][1];
+        vsum[x][2] += srow1[x][2] - srow0[x][2];
+        vsum[x][3] += srow1[x][3] - srow0[x][3];
+        vsum[x][4] += srow1[x][4] - srow0[x][4];
+      }
     }
 
     // update borders
@@ -751,13 +791,6 @@ auto optical_flow::blur_iteration(
       flow_u_y[x] = (g11_ *h2_ - g12_ * h1_) * idet;
       flow_v_y[x] = (g22_ *h1_ - g12_ * h2_) * idet;
     }
-
-    int y1 = y == frows - 1 ? frows : y - win_size_;
-    if (update_mats && (y1 == frows || y1 >= y0 + min_update_stripe))
-    {
-      update_matrices(r0, r1, flow_u, flow_v, mat, y0, y1);
-      y0 = y1;
-    }
   }
 }
 
@@ -817,87 +850,93 @@ auto optical_flow::interpolate_gaps(
   auto pwr = idw_low_res_pwr * 0.5; // to avoid std::pow(std::sqrt(...))
   size_t max_x = ((grid_u.cols() - 1) * spacing + half_spacing < velocity_u.cols() ? grid_u.cols() : grid_u.cols() - 1);
   size_t max_y = ((grid_u.rows() - 1) * spacing + half_spacing < velocity_u.rows() ? grid_u.rows() : grid_u.rows() - 1);
-  for (size_t y = 0; y < max_y; ++y)
+  parallel_rows(threads_, max_y, 1, [&](int row_from, int row_to)
   {
-    size_t yo = y * spacing + half_spacing;
-    for (size_t x = 0; x < max_x; ++x)
+    for (size_t y = row_from; y < (size_t) row_to; ++y)
     {
-      auto& out_u = velocity_u[yo][x * spacing + half_spacing];
-      auto& out_v = velocity_v[yo][x * spacing + half_spacing];
-
-      if (is_nan(out_u))
+      size_t yo = y * spacing + half_spacing;
+      for (size_t x = 0; x < max_x; ++x)
       {
-        double ac_weight = 0.0;
-        double ac_val_u = 0.0;
-        double ac_val_v = 0.0;
+        auto& out_u = velocity_u[yo][x * spacing + half_spacing];
+        auto& out_v = velocity_v[yo][x * spacing + half_spacing];
 
-        // search in rings around the point until we get at least 8 neighbours
-        // TODO - is this really doing what it says!?!?!! this really IDVs the whole low res grid!
-        for (size_t yy = 0; yy < grid_u.rows(); ++yy)
+        if (is_nan(out_u))
         {
-          for (size_t xx = 0; xx < grid_u.cols(); ++xx)
+          double ac_weight = 0.0;
+          double ac_val_u = 0.0;
+          double ac_val_v = 0.0;
+
+          // search in rings around the point until we get at least 8 neighbours
+          // TODO - is this really doing what it says!?!?!! this really IDVs the whole low res grid!
+          for (size_t yy = 0; yy < grid_u.rows(); ++yy)
           {
-            auto vv_u = grid_u[yy][xx];
-            auto vv_v = grid_v[yy][xx];
-            if (!is_nan(vv_u))
+            for (size_t xx = 0; xx < grid_u.cols(); ++xx)
             {
-              double weight = 1.0 / std::pow((double(xx) - x) * (double(xx) - x) + (double(yy) - y) * (double(yy) - y), pwr);
-              ac_val_u += vv_u * weight;
-              ac_val_v += vv_v * weight;
-              ac_weight += weight;
+              auto vv_u = grid_u[yy][xx];
+              auto vv_v = grid_v[yy][xx];
+              if (!is_nan(vv_u))
+              {
+                double weight = 1.0 / std::pow((double(xx) - x) * (double(xx) - x) + (double(yy) - y) * (double(yy) - y), pwr);
+                ac_val_u += vv_u * weight;
+                ac_val_v += vv_v * weight;
+                ac_weight += weight;
+              }
             }
           }
-        }
-        if (ac_weight > 0.0)
-        {
-          out_u = ac_val_u / ac_weight;
-          out_v = ac_val_v / ac_weight;
-        }
-        else
-        {
-          out_u = 0.0;
-          out_v = 0.0;
+          if (ac_weight > 0.0)
+          {
+            out_u = ac_val_u / ac_weight;
+            out_v = ac_val_v / ac_weight;
+          }
+          else
+          {
+            out_u = 0.0;
+            out_v = 0.0;
+          }
         }
       }
     }
-  }
+  });
 
   // stage 4 - perform the high resolution interpolation
   pwr = idw_high_res_pwr * 0.5; // to avoid std::pow(std::sqrt(...))
   array2<real> ref_u(velocity_u);
   array2<real> ref_v(velocity_v);
-  for (size_t y = 0; y < velocity_u.rows(); ++y)
+  parallel_rows(threads_, velocity_u.rows(), tile_rows, [&](int row_from, int row_to)
   {
-    for (size_t x = 0; x < velocity_u.cols(); ++x)
+    for (size_t y = row_from; y < (size_t) row_to; ++y)
     {
-      if (!is_nan(ref_u[y][x]))
-        continue;
-
-      double ac_weight = 0.0;
-      double ac_val_u = 0.0;
-      double ac_val_v = 0.0;
-      size_t min_x = std::max(x, spacing) - spacing;
-      size_t min_y = std::max(y, spacing) - spacing;
-      size_t max_x = std::min(x + spacing, velocity_u.cols());
-      size_t max_y = std::min(y + spacing, velocity_u.rows());
-      for (auto yy = min_y; yy < max_y; ++yy)
+      for (size_t x = 0; x < velocity_u.cols(); ++x)
       {
-        for (auto xx = min_x; xx < max_x; ++xx)
+        if (!is_nan(ref_u[y][x]))
+          continue;
+
+        double ac_weight = 0.0;
+        double ac_val_u = 0.0;
+        double ac_val_v = 0.0;
+        size_t min_x = std::max(x, spacing) - spacing;
+        size_t min_y = std::max(y, spacing) - spacing;
+        size_t max_x = std::min(x + spacing, velocity_u.cols());
+        size_t max_y = std::min(y + spacing, velocity_u.rows());
+        for (auto yy = min_y; yy < max_y; ++yy)
         {
-          const auto& vv_u = ref_u[yy][xx];
-          const auto& vv_v = ref_v[yy][xx];
-          if (!is_nan(vv_u))
+          for (auto xx = min_x; xx < max_x; ++xx)
           {
-            double weight = 1.0 / std::pow((double(xx) - x) * (double(xx) - x) + (double(yy) - y) * (double(yy) - y), pwr);
-            ac_val_u += vv_u * weight;
-            ac_val_v += vv_v * weight;
-            ac_weight += weight;
+            const auto& vv_u = ref_u[yy][xx];
+            const auto& vv_v = ref_v[yy][xx];
+            if (!is_nan(vv_u))
+            {
+              double weight = 1.0 / std::pow((double(xx) - x) * (double(xx) - x) + (double(yy) - y) * (double(yy) - y), pwr);
+              ac_val_u += vv_u * weight;
+              ac_val_v += vv_v * weight;
+              ac_weight += weight;
+            }
           }
         }
+        velocity_u[y][x] = ac_val_u / ac_weight;
+        velocity_v[y][x] = ac_val_v / ac_weight;
       }
-      velocity_u[y][x] = ac_val_u / ac_weight;
-      velocity_v[y][x] = ac_val_v / ac_weight;
     }
-  }
+  });
 }
 
@@ -63,6 +63,22 @@ public:
   virtual int calcFcstIndex(const int x_index,
 			    const int y_index) = 0;
   
+  // Calculate the fractional grid location in the original grid from
+  // which this forecast grid location is advected.  Unlike
+  // calcFcstIndex(), the offsets are not rounded to whole grid cells,
+  // so the result can be used for interpolation.  This method may be
+  // called concurrently from several threads once the advector has
+  // been precomputed.
+  //
+  // Returns true if successful, returns false if there is no motion
+  // in that location.  The returned location may lie outside of the
+  // grid.
+
+  virtual bool calcSourceLocation(const int x_index,
+                                  const int y_index,
+                                  double &src_x,
+                                  double &src_y) const = 0;
+  
 protected:
   
 private:
@@ -36,6 +36,7 @@
 #define GridAdvect_H
 
 #include <string>
+#include <vector>
 
 #include <advect/Advector.hh>
 #include <euclid/GridTemplate.hh>
@@ -67,6 +68,30 @@ public:
                const fl32 *image_data,
                const fl32 missing_data_value);
 
+  // Semi-Lagrangian mode.
+  //
+  // precomputeTrajectories() traces every forecast grid location back
+  // to its fractional source location using the advector, and saves
+  // the bilinear interpolation stencil for it.  This only needs to be
+  // done once per lead time, after the advector has been precomputed.
+  // computeFromTrajectories() then gathers a forecast from the image
+  // data using the saved stencils, and may be called for any number of
+  // fields on the same grid.  Both are split across n_threads threads.
+  //
+  // Missing source points, and points outside the image value limits,
+  // are left out of the interpolation and the remaining weights are
+  // renormalized.  Unlike compute(), the image data is not modified.
+  //
+  // Returns true on success, false on failure
+
+  bool precomputeTrajectories(const Advector &advector,
+                              const Pjg &projection,
+                              const int n_threads = 1);
+
+  bool computeFromTrajectories(const fl32 *image_data,
+                               const fl32 missing_data_value,
+                               const int n_threads = 1);
+
   // Retrieve the forecast data
 
   const fl32 *getForecastData() const
@@ -88,6 +113,40 @@ private:
   Pjg _forecastProj;
   fl32 *_forecastData;
 
+  // Bilinear stencil for each forecast grid location.  index is the
+  // lower-left source grid index, or -1 if there is no source, and
+  // dx/dy are the offsets to the neighbouring column and row.
+
+  typedef struct
+  {
+    int index;
+    int dx, dy;
+    fl32 wx, wy;
+  } trajectory_t;
+
+  std::vector<trajectory_t> _trajectories;
+  int _trajNx, _trajNy;
+
+  static const int TILE_ROWS;
+
+  void _computeTrajectoryRows(const Advector &advector,
+                              const int y_start, const int y_end);
+
+  void _gatherRows(const fl32 *image, const fl32 missing_data_value,
+                   const int y_start, const int y_end);
+
+  inline bool _isValid(const fl32 value,
+                       const fl32 missing_data_value) const
+  {
+    if (value == missing_data_value)
+      return false;
+    if (!_checkImageValues)
+      return true;
+    if (value < _imageValMin)
+      return false;
+    return _replaceValueWithMax || value <= _imageValMax;
+  }
+
 };
 
 #endif
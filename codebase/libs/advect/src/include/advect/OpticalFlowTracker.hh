@@ -0,0 +1,147 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// OpticalFlowTracker.hh
+//
+// OpticalFlowTracker class
+//
+// Computes the motion between two grids of the same size,
+// using the multi-level polynomial expansion optical flow
+// in advect/ancilla/optical_flow.h.
+//
+// The grids are row-major fl32 arrays, as stored in MDV fields.
+// The motion is returned in grid cells over the interval between
+// the grids, so that it can be used directly by Titan forecasts
+// and the advectors.
+//
+// The work at each resolution level is shared between threads,
+// see setNThreads().
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#ifndef OpticalFlowTracker_H
+#define OpticalFlowTracker_H
+
+#include <string>
+#include <dataport/port_types.h>
+using namespace std;
+
+class OpticalFlowTracker
+{
+  
+public:
+
+  // constructor
+
+  OpticalFlowTracker(const bool debug_flag = false);
+
+  // destructor
+  
+  ~OpticalFlowTracker();
+
+  // algorithm parameters - see the OpticalFlow app for details
+
+  void setScaleFactor(const double scale_factor) {
+    _scaleFactor = scale_factor;
+  }
+  void setMaxLevels(const int max_levels) {
+    _maxLevels = max_levels;
+  }
+  void setWindowSize(const int window_size) {
+    _windowSize = window_size;
+  }
+  void setNIterations(const int n_iterations) {
+    _nIterations = n_iterations;
+  }
+  void setPolygonNeighborhood(const int polygon_neighborhood) {
+    _polygonNeighborhood = polygon_neighborhood;
+  }
+  void setPolygonSigma(const double polygon_sigma) {
+    _polygonSigma = polygon_sigma;
+  }
+
+  // Interpolate the motion over regions with no data.
+  
+  void setInterpOverMissing(const bool interp,
+                            const int spacing = 8,
+                            const double min_frac_bins_for_avg = 0.05,
+                            const double idw_low_res_pwr = 4.0,
+                            const double idw_high_res_pwr = 3.0);
+
+  // Number of threads used for the computations.
+  // The results do not depend on the number of threads.
+
+  void setNThreads(const int n_threads) {
+    _nThreads = (n_threads < 1 ? 1 : n_threads);
+  }
+  
+  // Compute the motion from prev_grid to curr_grid.
+  //
+  // Points with values at or below the threshold, or missing, are
+  // treated as background.
+  //
+  // On return, u_motion and v_motion hold the motion in grid cells
+  // over the interval, located on the current grid. Points with no
+  // motion are set to missing_motion.
+  //
+  // If use_initial_motion is true, the motion grids passed in are
+  // used to seed the computation.
+  //
+  // Returns true on success, false on failure
+
+  bool compute(const int nx, const int ny,
+               const fl32 *prev_grid, const fl32 prev_missing,
+               const fl32 *curr_grid, const fl32 curr_missing,
+               const double threshold,
+               fl32 *u_motion, fl32 *v_motion,
+               const fl32 missing_motion,
+               const bool use_initial_motion = false);
+  
+protected:
+  
+private:
+
+  bool _debugFlag;
+  
+  double _scaleFactor;
+  int _maxLevels;
+  int _windowSize;
+  int _nIterations;
+  int _polygonNeighborhood;
+  double _polygonSigma;
+
+  bool _interpOverMissing;
+  int _interpSpacing;
+  double _minFracBinsForAvg;
+  double _idwLowResPwr;
+  double _idwHighResPwr;
+
+  int _nThreads;
+  
+};
+
+
+#endif
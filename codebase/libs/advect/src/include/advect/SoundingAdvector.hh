@@ -75,6 +75,17 @@ public:
   int calcFcstIndex(const int x_index,
 		    const int y_index);
   
+  // Calculate the fractional grid location in the original grid from
+  // which this forecast grid location is advected.
+  //
+  // Returns true if successful, returns false if there is no motion
+  // in that location.
+
+  bool calcSourceLocation(const int x_index,
+                          const int y_index,
+                          double &src_x,
+                          double &src_y) const;
+  
 protected:
   
 private:
@@ -89,6 +100,11 @@ private:
   int _xOffset;
   int _yOffset;
   
+  // Unrounded offsets, used by calcSourceLocation()
+
+  double _xGridOffset;
+  double _yGridOffset;
+  
 };
 
 #endif
@@ -33,12 +33,14 @@ namespace filters {
   /**
    * In-place operation is supported.
    * Does not cope with NaN inputs.
+   * The rows are processed in tiles, shared between the given number of threads.
    */
   void gaussian_blur(
         array2<real>& output
       , const array2<real>& input
       , int kernel_size
-      , real sigma);
+      , real sigma
+      , int threads = 1);
 }}
 
 #endif
@@ -27,6 +27,7 @@
 #include "array.h"
 #include "real.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace ancilla {
@@ -71,6 +72,14 @@ namespace ancilla {
     /// destruction
     ~optical_flow() noexcept = default;
 
+    /// Set the number of threads used for the tracking
+    /**
+     * The blurs, polynomial expansion and matrix updates at each resolution level
+     * are split into tiles of rows, shared between the threads.  The results do
+     * not depend on the number of threads.
+     */
+    auto set_threads(int threads) -> void { threads_ = std::max(threads, 1); }
+
     /// Determine the advection velocity field between two fields
     /**
      * The tracking algorithm does not play nice with NaNs.  If either of the input fields
@@ -129,6 +138,11 @@ namespace ancilla {
         ) const -> void;
     auto poly_exp_setup() -> void;
     auto poly_exp(const array2<real>& src, array2<vec5d>& dst) const -> void;
+    auto poly_exp_rows(
+          const array2<real>& src
+        , array2<vec5d>& dst
+        , int y0
+        , int y1) const -> void;
     auto update_matrices(
           const array2<vec5d>& r0
         , const array2<vec5d>& r1
@@ -144,6 +158,12 @@ namespace ancilla {
         , array2<real>& flow_v
         , array2<vec5d>& mat
         , bool update_mats) const -> void;
+    auto blur_rows(
+          const array2<vec5d>& mat
+        , array2<real>& flow_u
+        , array2<real>& flow_v
+        , int y0
+        , int y1) const -> void;
 
     auto interpolate_gaps(
           array2<real>& velocity_u
@@ -162,6 +182,7 @@ namespace ancilla {
     int     iterations_;
     int     poly_n_;
     double  poly_sigma_;
+    int     threads_;
 
     // precalculated terms
     std::vector<level_info> info_;    // used in main loop
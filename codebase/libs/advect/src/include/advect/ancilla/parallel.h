@@ -0,0 +1,72 @@
+// %=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%
+// ** Ancilla Radar Quality Control System (ancilla)
+// ** Copyright BOM (C) 2013
+// ** Bureau of Meteorology, Commonwealth of Australia, 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from the BOM.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of the BOM nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// %=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%=%
+
+#ifndef ANCILLA_MODELS_PARALLEL_H
+#define ANCILLA_MODELS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ancilla {
+  /// Call fn(row_from, row_to) for each tile of rows, using a pool of threads
+  /**
+   * The rows are split into tiles of a fixed size, which are handed out to the
+   * threads on demand.  The tile boundaries do not depend on the number of
+   * threads, so the results are the same for any thread count.
+   *
+   * fn must not throw, and must only write to the rows of its own tile.
+   */
+  template <typename F>
+  void parallel_rows(int threads, int rows, int tile_rows, F fn)
+  {
+    tile_rows = std::max(tile_rows, 1);
+    const int tiles = (rows + tile_rows - 1) / tile_rows;
+    threads = std::min(threads, tiles);
+
+    if (threads <= 1)
+    {
+      for (int t = 0; t < tiles; ++t)
+        fn(t * tile_rows, std::min((t + 1) * tile_rows, rows));
+      return;
+    }
+
+    std::atomic<int> next{0};
+    auto worker = [&]()
+    {
+      for (int t = next++; t < tiles; t = next++)
+        fn(t * tile_rows, std::min((t + 1) * tile_rows, rows));
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int i = 0; i < threads - 1; ++i)
+      pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool)
+      thread.join();
+  }
+}
+
+#endif
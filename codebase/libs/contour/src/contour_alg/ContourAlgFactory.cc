@@ -52,6 +52,7 @@
 
 // Local include files
 #include <contour/SimpleBoundaryContourAlg.hh>
+#include <contour/MarchingSquaresContourAlg.hh>
 #include <contour/ContourAlg.hh>
 #include <contour/ContourAlgFactory.hh>
 
@@ -120,6 +121,9 @@ ContourAlgFactory::createContourAlg(const alg_type_t& alg_type,
   case SIMPLE_BOUNDARY_ALG:
     contourAlg = _createSimpleBoundaryContourAlg(debug_flag);
     break;
+  case MARCHING_SQUARES_ALG:
+    contourAlg = _createMarchingSquaresContourAlg(debug_flag);
+    break;
   default:
     cerr << "Unknown algorithm type." << endl;
     break;
@@ -158,3 +162,20 @@ ContourAlgFactory::_createSimpleBoundaryContourAlg(const bool& debug_flag)
 }
 
 
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	ContourAlgFactory::_createMarchingSquaresContourAlg
+//
+// Description:	creates a marching squares contour alg object.
+//
+// Returns:	
+//
+// Notes:	single threaded, with no simplification.
+//
+//
+
+ContourAlg* 
+ContourAlgFactory::_createMarchingSquaresContourAlg(const bool& debug_flag)
+{
+  return new MarchingSquaresContourAlg(1, 0.0, debug_flag);
+}
@@ -0,0 +1,670 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////////////////
+//
+// Class:	MarchingSquaresContourAlg
+//
+// Date:	Oct 2026
+//
+// Description: Marching squares contour algorithm. All of the requested
+//		levels are contoured in a single pass over the grid, using
+//		row tiles which may be processed in parallel.
+// 
+// 
+
+
+// C++ include files
+#include <algorithm>
+
+// System/RAP include files
+#include <toolsa/TaThreadSimple.hh>
+#include <euclid/DPbasic.hh>
+
+// Local include files
+#include <contour/MarchingSquaresContourAlg.hh>
+#include <contour/Contour.hh>
+
+using namespace std;
+
+
+const int MarchingSquaresContourAlg::TILE_ROWS = 64;
+
+// Segments for each marching squares case. The case index has bit 0
+// set if the lower left corner is inside the contour, bit 1 for the
+// lower right, bit 2 for the upper right and bit 3 for the upper left.
+// Each entry gives the number of segments followed by the pair of cell
+// edges for each segment, where edge 0 is the bottom, 1 the right,
+// 2 the top and 3 the left. The saddle cases (5 and 10) are listed
+// with the center outside the contour; when the center is inside, the
+// segments for the complementary case are used.
+
+static const int SEGMENT_TABLE[16][5] =
+{
+  { 0, 0, 0, 0, 0 },
+  { 1, 3, 0, 0, 0 },
+  { 1, 0, 1, 0, 0 },
+  { 1, 3, 1, 0, 0 },
+  { 1, 1, 2, 0, 0 },
+  { 2, 3, 0, 1, 2 },
+  { 1, 0, 2, 0, 0 },
+  { 1, 2, 3, 0, 0 },
+  { 1, 2, 3, 0, 0 },
+  { 1, 0, 2, 0, 0 },
+  { 2, 0, 1, 2, 3 },
+  { 1, 1, 2, 0, 0 },
+  { 1, 3, 1, 0, 0 },
+  { 1, 0, 1, 0, 0 },
+  { 1, 3, 0, 0, 0 },
+  { 0, 0, 0, 0, 0 }
+};
+
+
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+//
+// Constructors
+//
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+
+MarchingSquaresContourAlg::MarchingSquaresContourAlg(const int n_threads,
+						     const double simplify_tolerance,
+						     const bool& debug_flag) :
+  ContourAlg(debug_flag),
+  _nThreads(n_threads),
+  _simplifyTolerance(simplify_tolerance),
+  _checkMissing(false),
+  _missingDataValue(0.0),
+  _checkBad(false),
+  _badDataValue(0.0),
+  _nx(0),
+  _ny(0),
+  _dx(1.0),
+  _dy(1.0),
+  _minX(0.0),
+  _minY(0.0),
+  _data(0)
+{
+  if (_nThreads > 1)
+    _threads.init(_nThreads, false);
+}
+
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+//
+// Destructors
+//
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+  
+MarchingSquaresContourAlg::~MarchingSquaresContourAlg()
+{
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+//
+// Public Methods
+//
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::generateContour
+//
+// Description:	contours the data at all of the given levels.
+//
+// Returns:	pointer to Contour object if successful, and 0 otherwise.
+//
+// Notes:	The polylines for each level are added to the contour in
+//		a fixed order, so the output doesn't depend on the number
+//		of threads.
+//
+
+Contour *
+MarchingSquaresContourAlg::generateContour(const int& nx, const int& ny,
+					   const float& dx, const float& dy,
+					   const float& min_x, const float& min_y,
+					   const vector<float>& levels,
+					   const float* data)
+{
+  const string methodName = "MarchingSquaresContourAlg::generateContour";
+
+  Contour *contour = new Contour();
+  
+  if (nx < 2 || ny < 2 || data == 0 || levels.size() == 0)
+    return contour;
+  
+  _nx = nx;
+  _ny = ny;
+  _dx = dx;
+  _dy = dy;
+  _minX = min_x;
+  _minY = min_y;
+  _data = data;
+  
+  // The levels are searched for each grid cell, so they must be sorted
+
+  _levels = levels;
+  sort(_levels.begin(), _levels.end());
+  _levels.erase(unique(_levels.begin(), _levels.end()), _levels.end());
+  
+  int n_levels = _levels.size();
+  
+  //
+  // contour the tiles
+  //
+
+  int n_cell_rows = _ny - 1;
+  int n_tiles = (n_cell_rows + TILE_ROWS - 1) / TILE_ROWS;
+  
+  _tiles.clear();
+  _tiles.resize(n_tiles);
+  
+  for (int tile_num = 0; tile_num < n_tiles; ++tile_num) {
+    _tiles[tile_num].start_row = tile_num * TILE_ROWS;
+    _tiles[tile_num].end_row = min((tile_num + 1) * TILE_ROWS, n_cell_rows);
+  } // endfor -- tile_num
+
+  _runPhase(TILE_PHASE, n_tiles);
+  
+  //
+  // stitch the open polylines across the tile boundaries. Open
+  // polylines which end on the grid edge or next to missing data are
+  // passed through unchanged.
+  //
+
+  vector< vector< edge_chain_t > > stitched_chains(n_levels);
+  _finalChains.clear();
+  
+  for (int level_index = 0; level_index < n_levels; ++level_index) {
+    vector< long > open_edges;
+    vector< int > open_starts;
+    vector< int > open_lens;
+    
+    for (int tile_num = 0; tile_num < n_tiles; ++tile_num) {
+      const vector< edge_chain_t > &chains =
+	_tiles[tile_num].chains[level_index];
+      
+      for (size_t i = 0; i < chains.size(); ++i) {
+	const edge_chain_t &chain = chains[i];
+	
+	if (chain.size() > 2 && chain.front() == chain.back()) {
+	  final_chain_t final_chain;
+	  final_chain.level_index = level_index;
+	  final_chain.edges = &chain;
+	  _finalChains.push_back(final_chain);
+	} else {
+	  open_starts.push_back(open_edges.size());
+	  open_lens.push_back(chain.size());
+	  open_edges.insert(open_edges.end(), chain.begin(), chain.end());
+	}
+      } // endfor -- i
+    } // endfor -- tile_num
+
+    if (open_starts.size() == 0)
+      continue;
+    
+    _joinPieces(open_edges, open_starts, open_lens,
+		stitched_chains[level_index]);
+
+    for (size_t i = 0; i < stitched_chains[level_index].size(); ++i) {
+      final_chain_t final_chain;
+      final_chain.level_index = level_index;
+      final_chain.edges = &stitched_chains[level_index][i];
+      _finalChains.push_back(final_chain);
+    } // endfor -- i
+  } // endfor -- level_index
+  
+  //
+  // convert the chains to polylines
+  //
+
+  int n_chains = _finalChains.size();
+  
+  _finalPolylines.clear();
+  _finalPolylines.resize(n_chains);
+
+  _runPhase(POLYLINE_PHASE, n_chains);
+  
+  for (int i = 0; i < n_chains; ++i) {
+    contour->addPolyline(_levels[_finalChains[i].level_index],
+			 _finalPolylines[i]);
+  } // endfor -- i
+
+  if (_debugFlag) {
+    cerr << methodName << ": " << n_levels << " levels, "
+	 << n_tiles << " tiles, " << n_chains << " polylines" << endl;
+  }
+  
+  // release the work space
+
+  vector< tile_t >().swap(_tiles);
+  vector< final_chain_t >().swap(_finalChains);
+  vector< ContourPolyline >().swap(_finalPolylines);
+  _data = 0;
+  
+  return contour;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+//
+// Protected Methods
+//
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::_runPhase
+//
+// Description:	runs a processing phase over n_items tiles or polylines.
+//
+// Returns:	
+//
+// Notes:	The items are split between the threads in a fixed
+//		pattern, and each item is written to its own slot.
+//
+
+void MarchingSquaresContourAlg::_runPhase(const phase_t phase,
+					  const int n_items)
+{
+  int n_threads = _nThreads;
+  if (n_threads > n_items)
+    n_threads = n_items;
+  
+  if (n_threads <= 1) {
+    _processItems(phase, 0, 1);
+    return;
+  }
+  
+  for (int thread_num = 0; thread_num < n_threads; ++thread_num) {
+    ThreadInfo *info = new ThreadInfo(this, phase, thread_num, n_threads);
+    _threads.thread(thread_num, (void *)info);
+  } // endfor -- thread_num
+
+  _threads.waitForThreads();
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::_processItems
+//
+// Description:	processes every n_threads'th item, starting at
+//		thread_num.
+//
+// Returns:	
+//
+// Notes:
+//
+//
+
+void MarchingSquaresContourAlg::_processItems(const phase_t phase,
+					      const int thread_num,
+					      const int n_threads)
+{
+  switch (phase) {
+  case TILE_PHASE:
+    for (size_t i = thread_num; i < _tiles.size(); i += n_threads)
+      _processTile(_tiles[i]);
+    break;
+  case POLYLINE_PHASE:
+    for (size_t i = thread_num; i < _finalChains.size(); i += n_threads)
+      _createPolyline(_finalChains[i], _finalPolylines[i]);
+    break;
+  } // endswitch -- phase
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::_processTile
+//
+// Description:	generates the contour segments for all levels in the
+//		cells of the given tile and chains them into polylines.
+//
+// Returns:	
+//
+// Notes:	A level crosses a cell if it is greater than the minimum
+//		corner value and no greater than the maximum, so only
+//		the crossing levels are visited for each cell.
+//
+
+void MarchingSquaresContourAlg::_processTile(tile_t &tile) const
+{
+  int n_levels = _levels.size();
+  const float *levels_begin = &_levels[0];
+  const float *levels_end = levels_begin + n_levels;
+  
+  tile.chains.clear();
+  tile.chains.resize(n_levels);
+  
+  // the segments for each level, as pairs of edge ids
+
+  vector< vector< long > > segments(n_levels);
+  
+  for (int iy = tile.start_row; iy < tile.end_row; ++iy) {
+    const float *row0 = _data + (long)iy * _nx;
+    const float *row1 = row0 + _nx;
+    
+    for (int ix = 0; ix < _nx - 1; ++ix) {
+      float ll = row0[ix];
+      float lr = row0[ix + 1];
+      float ur = row1[ix + 1];
+      float ul = row1[ix];
+      
+      if (_checkMissing &&
+	  (ll == _missingDataValue || lr == _missingDataValue ||
+	   ur == _missingDataValue || ul == _missingDataValue))
+	continue;
+      
+      if (_checkBad &&
+	  (ll == _badDataValue || lr == _badDataValue ||
+	   ur == _badDataValue || ul == _badDataValue))
+	continue;
+      
+      float min_val = min(min(ll, lr), min(ur, ul));
+      float max_val = max(max(ll, lr), max(ur, ul));
+      
+      if (!(min_val < max_val))
+	continue;
+      
+      const float *level = upper_bound(levels_begin, levels_end, min_val);
+      if (level == levels_end || *level > max_val)
+	continue;
+      
+      long node = (long)iy * _nx + ix;
+      long cell_edges[4];
+      cell_edges[0] = 2 * node;
+      cell_edges[1] = 2 * (node + 1) + 1;
+      cell_edges[2] = 2 * (node + _nx);
+      cell_edges[3] = 2 * node + 1;
+      
+      for (; level != levels_end && *level <= max_val; ++level) {
+	int case_index = 0;
+	if (ll >= *level) case_index |= 1;
+	if (lr >= *level) case_index |= 2;
+	if (ur >= *level) case_index |= 4;
+	if (ul >= *level) case_index |= 8;
+	
+	if ((case_index == 5 || case_index == 10) &&
+	    ((double)ll + lr + ur + ul) * 0.25 >= *level)
+	  case_index = 15 - case_index;
+	
+	const int *entry = SEGMENT_TABLE[case_index];
+	vector< long > &level_segments = segments[level - levels_begin];
+
+	for (int i = 0; i < entry[0]; ++i) {
+	  level_segments.push_back(cell_edges[entry[2 * i + 1]]);
+	  level_segments.push_back(cell_edges[entry[2 * i + 2]]);
+	} // endfor -- i
+      } // endfor -- level
+    } // endfor -- ix
+  } // endfor -- iy
+
+  // chain the segments for each level
+
+  vector< int > starts;
+  vector< int > lens;
+  
+  for (int level_index = 0; level_index < n_levels; ++level_index) {
+    const vector< long > &level_segments = segments[level_index];
+    int n_segments = level_segments.size() / 2;
+    
+    if (n_segments == 0)
+      continue;
+    
+    starts.resize(n_segments);
+    lens.assign(n_segments, 2);
+    for (int i = 0; i < n_segments; ++i)
+      starts[i] = 2 * i;
+    
+    _joinPieces(level_segments, starts, lens, tile.chains[level_index]);
+  } // endfor -- level_index
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::_createPolyline
+//
+// Description:	converts an edge chain to a polyline.
+//
+// Returns:	
+//
+// Notes:	Repeated points, which occur where the data equals the
+//		level at a grid point, are dropped before simplifying.
+//		Closed rings which would simplify to fewer than 3 points
+//		are left as they are.
+//
+
+void MarchingSquaresContourAlg::_createPolyline(const final_chain_t &chain,
+						ContourPolyline &polyline) const
+{
+  const edge_chain_t &edges = *chain.edges;
+  float level = _levels[chain.level_index];
+  
+  int n_edges = edges.size();
+  bool closed = (n_edges > 2 && edges.front() == edges.back());
+  if (closed)
+    --n_edges;
+
+  POINT *pts = new POINT[n_edges];
+  int n_pts = 0;
+  
+  for (int i = 0; i < n_edges; ++i) {
+    double x, y;
+    _edgePoint(edges[i], level, x, y);
+    if (n_pts > 0 && pts[n_pts - 1][XX] == x && pts[n_pts - 1][YY] == y)
+      continue;
+    pts[n_pts][XX] = x;
+    pts[n_pts][YY] = y;
+    ++n_pts;
+  } // endfor -- i
+
+  if (closed) {
+    while (n_pts > 1 &&
+	   pts[n_pts - 1][XX] == pts[0][XX] &&
+	   pts[n_pts - 1][YY] == pts[0][YY])
+      --n_pts;
+  }
+  
+  int *out_pts = new int[n_pts > 0 ? n_pts : 1];
+  int num_out_pts = 0;
+  
+  if (_simplifyTolerance > 0.0 && n_pts > (closed ? 3 : 2)) {
+    DPbasic dp_basic(pts, n_pts);
+    num_out_pts = dp_basic.dp(0, n_pts - 1, _simplifyTolerance, out_pts);
+    if (closed && num_out_pts < 3)
+      num_out_pts = 0;
+  }
+  
+  if (num_out_pts <= 0) {
+    num_out_pts = n_pts;
+    for (int i = 0; i < n_pts; ++i)
+      out_pts[i] = i;
+  }
+  
+  for (int i = 0; i < num_out_pts; ++i)
+    polyline.addPoint(_minX + pts[out_pts[i]][XX] * _dx,
+		      _minY + pts[out_pts[i]][YY] * _dy);
+
+  if (closed && num_out_pts > 0)
+    polyline.addPoint(_minX + pts[out_pts[0]][XX] * _dx,
+		      _minY + pts[out_pts[0]][YY] * _dy);
+
+  delete [] out_pts;
+  delete [] pts;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::_joinPieces
+//
+// Description:	joins pieces which share an end edge into chains.
+//
+// Returns:	
+//
+// Notes:	Each edge is shared by at most two pieces. A chain which
+//		comes back to its first piece is closed, and repeats its
+//		first edge at the end. Chains are started from the lowest
+//		numbered unused piece, so the output is deterministic.
+//
+
+void MarchingSquaresContourAlg::_joinPieces(const vector< long > &edges,
+					    const vector< int > &starts,
+					    const vector< int > &lens,
+					    vector< edge_chain_t > &chains)
+{
+  int n_pieces = starts.size();
+  
+  // Match up the piece ends. End 2 * k is the front of piece k and
+  // end 2 * k + 1 is the back.
+
+  vector< pair< long, int > > ends(2 * n_pieces);
+  
+  for (int k = 0; k < n_pieces; ++k) {
+    ends[2 * k] = make_pair(edges[starts[k]], 2 * k);
+    ends[2 * k + 1] = make_pair(edges[starts[k] + lens[k] - 1], 2 * k + 1);
+  } // endfor -- k
+
+  sort(ends.begin(), ends.end());
+  
+  vector< int > partner(2 * n_pieces, -1);
+  
+  for (size_t i = 0; i + 1 < ends.size(); ) {
+    if (ends[i].first == ends[i + 1].first) {
+      partner[ends[i].second] = ends[i + 1].second;
+      partner[ends[i + 1].second] = ends[i].second;
+      i += 2;
+    } else {
+      ++i;
+    }
+  } // endfor -- i
+
+  // Walk the chains
+
+  vector< bool > used(n_pieces, false);
+  
+  for (int k = 0; k < n_pieces; ++k) {
+    if (used[k])
+      continue;
+    
+    // Walk backwards to the first piece in the chain. If we get back
+    // to piece k, the chain is closed and starts at piece k.
+
+    int head = k;
+    bool head_reversed = false;
+    
+    while (true) {
+      int end = partner[2 * head + (head_reversed ? 1 : 0)];
+      if (end < 0)
+	break;
+      int prev = end / 2;
+      if (prev == k) {
+	head = k;
+	head_reversed = false;
+	break;
+      }
+      if (used[prev])
+	break;
+      head = prev;
+      head_reversed = (end % 2 == 0);
+    } // endwhile
+
+    // Walk forwards, adding the edges. Each joined piece starts with
+    // the last edge already added.
+
+    chains.push_back(edge_chain_t());
+    edge_chain_t &chain = chains.back();
+    
+    int piece = head;
+    bool reversed = head_reversed;
+    
+    while (true) {
+      used[piece] = true;
+
+      int start = starts[piece];
+      int len = lens[piece];
+      for (int i = (chain.size() == 0 ? 0 : 1); i < len; ++i)
+	chain.push_back(edges[reversed ? start + len - 1 - i : start + i]);
+
+      int end = partner[2 * piece + (reversed ? 0 : 1)];
+      if (end < 0)
+	break;
+      int next = end / 2;
+      if (used[next])
+	break;
+      piece = next;
+      reversed = (end % 2 == 1);
+    } // endwhile
+  } // endfor -- k
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::_threadMethod
+//
+// Description:	thread method for processing tiles or polylines.
+//
+// Returns:	
+//
+// Notes:	deletes the ThreadInfo object.
+//
+
+void MarchingSquaresContourAlg::_threadMethod(void *thread_data)
+{
+  ThreadInfo *info = (ThreadInfo *)thread_data;
+  info->_obj->_processItems(info->_phase, info->_threadNum, info->_nThreads);
+  delete info;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Method Name:	MarchingSquaresContourAlg::ContourThreads::clone
+//
+// Description:	clones a thread for the que.
+//
+// Returns:	
+//
+// Notes:
+//
+//
+
+TaThread *MarchingSquaresContourAlg::ContourThreads::clone(int index)
+{
+  TaThreadSimple *t = new TaThreadSimple(index);
+  t->setThreadMethod(MarchingSquaresContourAlg::_threadMethod);
+  t->setThreadContext(this);
+  return (TaThread *) t;
+}
@@ -67,7 +67,8 @@ public:
   ////////////////////
 
   typedef enum {
-    SIMPLE_BOUNDARY_ALG = 0
+    SIMPLE_BOUNDARY_ALG = 0,
+    MARCHING_SQUARES_ALG = 1
   } alg_type_t;
   
   ////////////////////
@@ -113,6 +114,7 @@ private:
   /////////////////////
 
   static ContourAlg *_createSimpleBoundaryContourAlg(const bool& debug_flag = false);
+  static ContourAlg *_createMarchingSquaresContourAlg(const bool& debug_flag = false);
 
 
 };
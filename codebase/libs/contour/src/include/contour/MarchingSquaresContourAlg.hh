@@ -0,0 +1,294 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+//////////////////////////////////////////////////////////////////////////
+// 
+// Header:	MarchingSquaresContourAlg
+// 
+// Date:	Oct 2026
+// 
+// Description:	Marching squares contour algorithm. All of the requested
+//		levels are contoured in a single pass over the grid. The
+//		grid is split into bands of rows (tiles) which may be
+//		processed in parallel. Segments are chained into polylines
+//		within each tile, and the polylines that end on a tile
+//		boundary are stitched together afterwards. The output
+//		polylines may be simplified using Douglas-Peucker.
+// 
+// 
+
+
+# ifndef    MARCHING_SQUARES_CONTOUR_ALG_H
+# define    MARCHING_SQUARES_CONTOUR_ALG_H
+
+// C++ include files
+#include <vector>
+
+// System/RAP include files
+#include <toolsa/TaThreadDoubleQue.hh>
+#include <contour/ContourAlg.hh>
+#include <contour/ContourPolyline.hh>
+
+// Local include files
+
+using namespace std;
+
+
+class Contour;
+
+class MarchingSquaresContourAlg : public ContourAlg {
+  
+public:
+
+  ////////////////////
+  // public methods //
+  ////////////////////
+
+  // constructor
+  // n_threads - number of threads used to process the tiles. If 1 or
+  //   less, the tiles are processed in the calling thread.
+  // simplify_tolerance - Douglas-Peucker tolerance, in grid cells, used
+  //   to simplify the output polylines. If 0 or less, the polylines are
+  //   not simplified.
+
+  MarchingSquaresContourAlg(const int n_threads = 1,
+			    const double simplify_tolerance = 0.0,
+			    const bool& debug_flag = false);
+ 
+  // destructor
+  virtual ~MarchingSquaresContourAlg();
+
+  // simplify_tolerance - Douglas-Peucker tolerance in grid cells
+
+  void setSimplifyTolerance(const double simplify_tolerance)
+  {
+    _simplifyTolerance = simplify_tolerance;
+  }
+  
+  // Grid cells with a missing data value at any corner are not
+  // contoured. By default, all data values are used.
+
+  void setMissingDataValue(const float missing_data_value)
+  {
+    _checkMissing = true;
+    _missingDataValue = missing_data_value;
+  }
+  
+  void clearMissingDataValue()
+  {
+    _checkMissing = false;
+  }
+  
+  // Grid cells with a bad data value at any corner are not contoured
+  // either. By default, all data values are used.
+
+  void setBadDataValue(const float bad_data_value)
+  {
+    _checkBad = true;
+    _badDataValue = bad_data_value;
+  }
+  
+  void clearBadDataValue()
+  {
+    _checkBad = false;
+  }
+  
+  // calculate the contours
+  //
+  // nx - number of points in x-direction
+  // ny - number of points in y-direction
+  // dx - grid spacing in x-direction
+  // dy - grid spacing in y-direction
+  // min_x - leftmost value of grid in x-direction
+  // min_y - lowest value of grid in y-direction
+  // levels - list of contour levsls
+  // data - the data of which we will contour
+  //
+  // A grid point is inside the contour for a level if its value is
+  // greater than or equal to the level. Closed polylines repeat the
+  // first point at the end.
+  //
+  // Returns the calculated contour on success, 0 on failure
+
+  virtual Contour* generateContour(const int& nx, const int& ny,
+				   const float& dx, const float& dy,
+				   const float& min_x, const float& min_y,
+				   const vector<float>& levels,
+				   const float* data);
+
+protected:
+
+  ///////////////////////
+  // protected members //
+  ///////////////////////
+  
+  // Number of rows of grid cells in each tile. This is fixed so that
+  // the output doesn't depend on the number of threads.
+
+  static const int TILE_ROWS;
+
+  // A polyline is stored as the list of grid edges it crosses.  Edge
+  // ids are 2 * (y * nx + x) for the edge from point (x, y) to
+  // (x + 1, y), and 2 * (y * nx + x) + 1 for the edge from (x, y) to
+  // (x, y + 1).  The cells on either side of an edge compute the same
+  // crossing point, so chains can be joined by matching edge ids.  A
+  // closed polyline repeats the first edge at the end.
+
+  typedef vector< long > edge_chain_t;
+
+  // Polylines computed for one tile, indexed by level
+
+  typedef struct
+  {
+    int start_row;
+    int end_row;
+    vector< vector< edge_chain_t > > chains;
+  } tile_t;
+
+  // A finished polyline waiting to be converted to points
+
+  typedef struct
+  {
+    int level_index;
+    const edge_chain_t *edges;
+  } final_chain_t;
+
+  // Processing phases run in the threads
+
+  typedef enum {
+    TILE_PHASE,
+    POLYLINE_PHASE
+  } phase_t;
+
+  // Information passed to each thread
+
+  class ThreadInfo
+  {
+  public:
+    ThreadInfo(MarchingSquaresContourAlg *obj, const phase_t phase,
+	       const int thread_num, const int n_threads) :
+      _obj(obj), _phase(phase), _threadNum(thread_num),
+      _nThreads(n_threads) {}
+    MarchingSquaresContourAlg *_obj;
+    phase_t _phase;
+    int _threadNum;
+    int _nThreads;
+  };
+  
+  // Thread que for the tile and polyline phases
+
+  class ContourThreads : public TaThreadDoubleQue
+  {
+  public:
+    inline ContourThreads() : TaThreadDoubleQue() {}
+    inline virtual ~ContourThreads() {}
+    TaThread *clone(int index);
+  };
+  
+  int _nThreads;
+  double _simplifyTolerance;
+  bool _checkMissing;
+  float _missingDataValue;
+  bool _checkBad;
+  float _badDataValue;
+
+  ContourThreads _threads;
+  
+  // Members valid during a generateContour() call
+
+  int _nx;
+  int _ny;
+  double _dx;
+  double _dy;
+  double _minX;
+  double _minY;
+  const float *_data;
+  vector< float > _levels;
+  vector< tile_t > _tiles;
+  vector< final_chain_t > _finalChains;
+  vector< ContourPolyline > _finalPolylines;
+
+  ///////////////////////
+  // protected methods //
+  ///////////////////////
+
+  // Run the given phase, in threads if requested
+
+  void _runPhase(const phase_t phase, const int n_items);
+
+  // Process every n_threads'th tile or polyline, starting at thread_num
+
+  void _processItems(const phase_t phase,
+		     const int thread_num, const int n_threads);
+
+  // Generate and chain the contour segments for all levels in a tile
+
+  void _processTile(tile_t &tile) const;
+
+  // Convert a finished edge chain to a polyline, simplifying it in
+  // grid coordinates
+
+  void _createPolyline(const final_chain_t &chain,
+		       ContourPolyline &polyline) const;
+
+  // Compute the location of the level crossing on the given edge, in
+  // grid coordinates
+
+  inline void _edgePoint(const long edge, const float level,
+			 double &x, double &y) const
+  {
+    long node = edge >> 1;
+    int ix = (int)(node % _nx);
+    int iy = (int)(node / _nx);
+    double v0 = _data[node];
+    if ((edge & 1) == 0)
+    {
+      double v1 = _data[node + 1];
+      x = ix + (level - v0) / (v1 - v0);
+      y = iy;
+    }
+    else
+    {
+      double v1 = _data[node + _nx];
+      x = ix;
+      y = iy + (level - v0) / (v1 - v0);
+    }
+  }
+  
+  // Join pieces which share an end edge into chains. Piece k is
+  // edges[starts[k]] through edges[starts[k] + lens[k] - 1]. The
+  // resulting chains are appended to chains.
+
+  static void _joinPieces(const vector< long > &edges,
+			  const vector< int > &starts,
+			  const vector< int > &lens,
+			  vector< edge_chain_t > &chains);
+
+  // Thread method
+
+  static void _threadMethod(void *thread_data);
+
+};
+
+
+# endif     /* MARCHING_SQUARES_CONTOUR_ALG_H */
@@ -38,6 +38,7 @@
 #include <cstdio>
 #include <string>
 #include <vector>
+#include <set>
 #include <algorithm>
 #include <stdexcept>
 #include <sys/stat.h>
@@ -321,6 +322,8 @@ void DsInputPath::_init()
   _pathPosn = 0;
   _use_inotify = false;
   _inotifyFd = -1;
+  _incremental_scan = true;
+  _scanNum = 0;
   
 }
 
@@ -501,6 +504,21 @@ void DsInputPath::setUseInotify(bool useInotifyFlag /*= true */)
   _use_inotify = useInotifyFlag;
 }
 
+///////////////////////////////////////////////////////////
+// set whether to scan directories incrementally
+// default is true
+//
+// See DsInputPath.hh for details.
+
+void DsInputPath::setIncrementalScan(bool state /*= true */)
+{
+  _incremental_scan = state;
+  if (!_incremental_scan) {
+    _dirStates.clear();
+    _dayIndex.clear();
+  }
+}
+
 ///////////////////////////////////////////////////////////
 // set the max recursion depth.
 //
@@ -753,6 +771,19 @@ char *DsInputPath::getClosest(time_t search_time,
 
 {
 
+  // use the day directory index if possible
+
+  if (_incremental_scan) {
+    int iret = _getClosestIndexed(search_time, start_time, end_time,
+                                  data_time);
+    if (iret == 0) {
+      return((char *) _returned_path.c_str());
+    } else if (iret == -1) {
+      return NULL;
+    }
+    // layout not indexed, scan in full
+  }
+
   // construct temporary object containing all paths
   // within the search time
 
@@ -1616,64 +1647,44 @@ void DsInputPath::_load_timelist_realtime(const string &input_dir,
     return;
   }
   
-  DIR *dirp;
-  if ((dirp = opendir(input_dir.c_str())) == NULL) {
-    if (_debug) {
-      int errNum = errno;
-      cerr << "ERROR: DsInputPath::_load_timelist_realtime" << endl;
-      cerr << "  Cannot open dir: " << input_dir << endl;
-      cerr << "  " << strerror(errNum) << endl;
-    }
+  // get the state of the directory, re-reading it if it has changed
+
+  time_t now = time(NULL);
+  if (depth == 0) {
+    _scanNum++;
+  }
+  DirState *state = _updateDirState(input_dir, now);
+  if (state == NULL) {
     return;
   }
-  
-  // read directory looking for data files to be transferred
 
-  time_t now = time(NULL);
-  struct dirent *dp;
-  for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
-    
-    // exclude dir entries and files beginning with '.' and '_'
+  // check the entries for data files to be returned
+
+  map<string, entry_state_t>::iterator it;
+  for (it = state->entries.begin(); it != state->entries.end(); it++) {
     
-    if (dp->d_name[0] == '.') {
-      continue;
-    }
-    if (dp->d_name[0] == '_') {
-      continue;
-    }
-    if (strstr(dp->d_name, "latest_data_info") != NULL) {
-      continue;
-    }
+    const string &name = it->first;
+    const entry_state_t &entry = it->second;
 
     // check file time
     
-    char filePath[MAX_PATH_LEN];
-    sprintf(filePath, "%s%s%s", input_dir.c_str(), PATH_DELIM, dp->d_name);
-    struct stat fileStat;
-    if (ta_stat(filePath, &fileStat)) {
-      if (_debug) {
-	int errNum = errno;
-	cerr << "WARNING: DsInputPath::_load_timelist_realtime" << endl;
-	cerr << "  Cannot stat file: " << filePath << endl;
-	cerr << "  " << strerror(errNum) << endl;
-      }
-      continue;
-    }
-
-    time_t file_time = fileStat.st_mtime;
-    if (!S_ISDIR(fileStat.st_mode)) {
+    time_t file_time = entry.mtime;
+    if (!entry.isDir) {
       if (file_time < _latest_time_used) {
 	continue;
       }
     }
 
+    char filePath[MAX_PATH_LEN];
+    sprintf(filePath, "%s%s%s", input_dir.c_str(), PATH_DELIM, name.c_str());
+
     // check links
 
     if (!_follow_links) {
-      if (S_ISLNK(fileStat.st_mode)) {
+      if (entry.isLink) {
 	if (_debug) {
 	  cerr << "-->> Ignoring symbolic link dir, depth, name: "
-	       << input_dir << ", " << depth << ", " << dp->d_name << endl;
+	       << input_dir << ", " << depth << ", " << name << endl;
 	}
 	continue;
       }
@@ -1685,20 +1696,18 @@ void DsInputPath::_load_timelist_realtime(const string &input_dir,
 
     // for directories, search recursively, if pass strict test
     
-    if (S_ISDIR(fileStat.st_mode)) {
-      if (_recurse && _scanThisDir(dp->d_name, age)) {
-	char dirPath[MAX_PATH_LEN];
-	sprintf(dirPath, "%s%s%s", input_dir.c_str(), PATH_DELIM, dp->d_name);
+    if (entry.isDir) {
+      if (_recurse && _scanThisDir((char *) name.c_str(), age)) {
 	if (_debug) {
 	  cerr << "-->> Scanning dir, age, depth: "
-	       << dirPath << ", " << age << ", " << (depth + 1) << endl;
+	       << filePath << ", " << age << ", " << (depth + 1) << endl;
 	}
-	_load_timelist_realtime(dirPath, depth + 1);
+	_load_timelist_realtime(filePath, depth + 1);
       }
       continue;
     }
     
-    if (!S_ISREG(fileStat.st_mode)) {
+    if (!entry.isReg) {
       continue;
     }
 
@@ -1712,11 +1721,11 @@ void DsInputPath::_load_timelist_realtime(const string &input_dir,
     
     // Check substring and extension if appropriate
 
-    if (!_hasSubStr(dp->d_name)) {
+    if (!_hasSubStr(name)) {
       continue;
     }
 
-    if (!_hasExt(dp->d_name)) {
+    if (!_hasExt(name)) {
       continue;
     }
     
@@ -1724,33 +1733,31 @@ void DsInputPath::_load_timelist_realtime(const string &input_dir,
     
     _insertRealtimePair(file_time, filePath);
     
-  } // dp
+  } // it
   
-  closedir(dirp);
-
   if (depth == 0) {
 
-    // remove any entries from previous list
-    
-    bool done = false;
-    while (!done) {
-      TimePathIter ii, jj;
-      done = true;
-      for (ii = _realtimePathMap.begin();
-           ii != _realtimePathMap.end(); ii++) {
-	for (jj = _prevRealtimeMap.begin();
-             jj != _prevRealtimeMap.end(); jj++) {
-	  if ((*ii).first == (*jj).first) {
-	    _realtimePathMap.erase(ii);
-	    done = false;
-	    break; // from jj
-	  } // if
-	} // jj
-	if (!done) {
-	  break; // from ii
-	}
-      } // ii
-    } // while
+    // remove any entries with the same time as those in previous list
+    
+    TimePathIter ii = _realtimePathMap.begin();
+    while (ii != _realtimePathMap.end()) {
+      if (_prevRealtimeMap.find((*ii).first) != _prevRealtimeMap.end()) {
+        _realtimePathMap.erase(ii++);
+      } else {
+        ii++;
+      }
+    } // ii
+
+    // forget dirs which were not visited in this scan
+
+    map<string, DirState>::iterator jj = _dirStates.begin();
+    while (jj != _dirStates.end()) {
+      if (jj->second.scanNum != _scanNum) {
+        _dirStates.erase(jj++);
+      } else {
+        jj++;
+      }
+    } // jj
     
     // if current path list is empty but prev path list is not, then
     // at least a second has gone by since a file arrived.
@@ -1791,6 +1798,403 @@ void DsInputPath::_load_timelist_realtime(const string &input_dir,
   
 }
 
+////////////////////////////////////////////////////////////
+// Update the state of a directory, for realtime scanning.
+//
+// The directory is re-read only if its modify time has changed
+// since the last read. Only entries not seen before, and those
+// which may have changed, are statted:
+//   dirs - always, since the age is used to decide on recursion;
+//   files young enough to be returned - these may still be
+//     growing, or may be rewritten;
+//   all entries, every max_file_age / 2 secs - to find old
+//     files which have been rewritten in place.
+//
+// Returns pointer to the state, NULL on failure.
+
+DsInputPath::DirState *DsInputPath::_updateDirState(const string &dir,
+                                                    time_t now)
+  
+{
+
+  struct stat dirStat;
+  if (ta_stat(dir.c_str(), &dirStat)) {
+    if (_debug) {
+      int errNum = errno;
+      cerr << "ERROR: DsInputPath::_load_timelist_realtime" << endl;
+      cerr << "  Cannot open dir: " << dir << endl;
+      cerr << "  " << strerror(errNum) << endl;
+    }
+    _dirStates.erase(dir);
+    return NULL;
+  }
+
+  DirState &state = _dirStates[dir];
+  state.scanNum = _scanNum;
+
+  // Is the dir new or changed?
+  // If the dir was modified in the second in which it was read,
+  // the read may have missed changes, so read it again.
+
+  bool readDir = true;
+  if (_incremental_scan &&
+      state.readTime >= 0 &&
+      dirStat.st_mtime == state.dirMtime &&
+      state.dirMtime < state.readTime - 1) {
+    readDir = false;
+  }
+  
+  // is it time to stat all entries?
+
+  int fullStatSecs = _max_file_age / 2;
+  if (fullStatSecs < _dir_scan_sleep_secs) {
+    fullStatSecs = _dir_scan_sleep_secs;
+  }
+  bool statAll = true;
+  if (_incremental_scan &&
+      state.fullStatTime >= 0 &&
+      now - state.fullStatTime < fullStatSecs) {
+    statAll = false;
+  }
+  
+  if (readDir) {
+    
+    DIR *dirp;
+    if ((dirp = opendir(dir.c_str())) == NULL) {
+      if (_debug) {
+        int errNum = errno;
+        cerr << "ERROR: DsInputPath::_load_timelist_realtime" << endl;
+        cerr << "  Cannot open dir: " << dir << endl;
+        cerr << "  " << strerror(errNum) << endl;
+      }
+      _dirStates.erase(dir);
+      return NULL;
+    }
+    
+    // read directory, keeping the state of entries we have seen before
+    
+    map<string, entry_state_t> entries;
+    struct dirent *dp;
+    for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
+      
+      // exclude dir entries and files beginning with '.' and '_'
+      
+      if (dp->d_name[0] == '.') {
+        continue;
+      }
+      if (dp->d_name[0] == '_') {
+        continue;
+      }
+      if (strstr(dp->d_name, "latest_data_info") != NULL) {
+        continue;
+      }
+
+      string name(dp->d_name);
+      map<string, entry_state_t>::iterator prev = state.entries.find(name);
+      if (prev != state.entries.end()) {
+        entries[name] = prev->second;
+      } else {
+        entry_state_t entry;
+        if (_statEntry(dir, name, now, entry) == 0) {
+          entries[name] = entry;
+        }
+      }
+      
+    } // dp
+    
+    closedir(dirp);
+
+    state.entries.swap(entries);
+    state.dirMtime = dirStat.st_mtime;
+    state.readTime = now;
+
+  } // if (readDir)
+
+  // stat the entries which may have changed
+  
+  map<string, entry_state_t>::iterator it = state.entries.begin();
+  while (it != state.entries.end()) {
+    entry_state_t &entry = it->second;
+    if (entry.statTime == now ||
+        (!statAll && !entry.isDir && now - entry.mtime > _max_file_age)) {
+      it++;
+      continue;
+    }
+    if (_statEntry(dir, it->first, now, entry)) {
+      // removed since the dir was read
+      state.entries.erase(it++);
+    } else {
+      it++;
+    }
+  } // it
+
+  if (statAll) {
+    state.fullStatTime = now;
+  }
+
+  return &state;
+
+}
+
+////////////////////////////////////////////////////////////
+// Stat a directory entry, loading up the entry state.
+//
+// Returns 0 on success, -1 on failure.
+
+int DsInputPath::_statEntry(const string &dir, const string &name,
+                            time_t now, entry_state_t &entry)
+  
+{
+
+  char filePath[MAX_PATH_LEN];
+  sprintf(filePath, "%s%s%s", dir.c_str(), PATH_DELIM, name.c_str());
+  struct stat fileStat;
+  if (ta_stat(filePath, &fileStat)) {
+    if (_debug) {
+      int errNum = errno;
+      cerr << "WARNING: DsInputPath::_load_timelist_realtime" << endl;
+      cerr << "  Cannot stat file: " << filePath << endl;
+      cerr << "  " << strerror(errNum) << endl;
+    }
+    return -1;
+  }
+
+  entry.mtime = fileStat.st_mtime;
+  entry.statTime = now;
+  entry.isDir = S_ISDIR(fileStat.st_mode);
+  entry.isReg = S_ISREG(fileStat.st_mode);
+  entry.isLink = S_ISLNK(fileStat.st_mode);
+
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////////////////
+// get closest file to given time within the given time limits,
+// using the day directory index.
+//
+// Returns 0 on success, setting _returned_path and data_time.
+// Returns -1 if the layout is indexed but no file is within the
+// time limits.
+// Returns -2 if the layout cannot be indexed, in which case the
+// directories must be scanned in full.
+
+int DsInputPath::_getClosestIndexed(time_t search_time,
+                                    time_t start_time,
+                                    time_t end_time,
+                                    time_t *data_time) const
+  
+{
+
+  int start_day = start_time / SECS_IN_DAY;
+  int end_day = end_time / SECS_IN_DAY;
+
+  bool haveValidTime = false;
+  bool found = false;
+  int minDiff = 0;
+  const TimePathPair *best = NULL;
+  
+  for (int iday = start_day; iday <= end_day; iday++) {
+
+    const DayIndex *index = _updateDayIndex(iday);
+    if (index == NULL) {
+      continue;
+    }
+    if (index->hasForecast || index->hasSubdirs) {
+      return -2;
+    }
+    if (index->hasValidTime) {
+      haveValidTime = true;
+    }
+
+    const vector<TimePathPair> &paths = index->paths;
+    if (paths.size() == 0) {
+      continue;
+    }
+
+    // Find the entries either side of the search time.
+    // Within a time the entries are sorted by path, so the
+    // last entry for a given time has the last path.
+    
+    vector<TimePathPair>::const_iterator after =
+      lower_bound(paths.begin(), paths.end(),
+                  TimePathPair(search_time, string()));
+
+    vector<const TimePathPair *> candidates;
+    if (after != paths.begin()) {
+      candidates.push_back(&(*(after - 1)));
+    }
+    if (after != paths.end()) {
+      vector<TimePathPair>::const_iterator last =
+        lower_bound(after, paths.end(),
+                    TimePathPair(after->first + 1, string()));
+      candidates.push_back(&(*(last - 1)));
+    }
+
+    for (size_t ii = 0; ii < candidates.size(); ii++) {
+      const TimePathPair *cand = candidates[ii];
+      if (cand->first < start_time || cand->first > end_time) {
+        continue;
+      }
+      int diff = abs(search_time - cand->first);
+      if (!found || diff < minDiff ||
+          (diff == minDiff && cand->second > best->second)) {
+        best = cand;
+        minDiff = diff;
+        found = true;
+      }
+    } // ii
+
+  } // iday
+
+  if (found) {
+    _returned_path = best->second;
+    *data_time = best->first;
+    return 0;
+  }
+
+  // If the day dirs in the time limits contain data files,
+  // but none within the limits, there is no data. Otherwise
+  // fall back on the full scan, which also searches outside
+  // the day dirs.
+
+  if (haveValidTime) {
+    return -1;
+  }
+
+  return -2;
+
+}
+
+/////////////////////////////////////////////////////////////////
+// Update the index for a day directory.
+//
+// The directory is only re-read if its modify time has changed.
+// Files seen before are not statted again.
+//
+// Returns pointer to the index, NULL if the dir does not exist.
+
+const DsInputPath::DayIndex *DsInputPath::_updateDayIndex(int day_num) const
+  
+{
+
+  date_time_t day_time;
+  day_time.unix_time = day_num * SECS_IN_DAY;
+  uconvert_from_utime(&day_time);
+  
+  char daydir_path[MAX_PATH_LEN];
+  sprintf(daydir_path, "%s%s%.4d%.2d%.2d",
+	  _input_dir.c_str(), PATH_DELIM,
+	  day_time.year, day_time.month, day_time.day);
+
+  time_t now = time(NULL);
+  struct stat dirStat;
+  if (ta_stat(daydir_path, &dirStat) || !S_ISDIR(dirStat.st_mode)) {
+    _dayIndex.erase(daydir_path);
+    return NULL;
+  }
+  
+  DayIndex &index = _dayIndex[daydir_path];
+  index.useTime = now;
+
+  // Is the index current?
+  // If the dir was modified in the second in which it was read,
+  // the read may have missed changes, so read it again.
+
+  if (index.readTime >= 0 &&
+      dirStat.st_mtime == index.dirMtime &&
+      index.dirMtime < index.readTime - 1) {
+    return &index;
+  }
+  
+  DIR *dirp;
+  if ((dirp = opendir(daydir_path)) == NULL) {
+    _dayIndex.erase(daydir_path);
+    return NULL;
+  }
+
+  // entries from previous read are known not to be dirs
+
+  set<string> prevFiles(index.otherFiles);
+  for (size_t ii = 0; ii < index.paths.size(); ii++) {
+    prevFiles.insert(index.paths[ii].second);
+  }
+
+  index.paths.clear();
+  index.otherFiles.clear();
+  index.hasValidTime = false;
+  index.hasForecast = false;
+  index.hasSubdirs = false;
+
+  struct dirent *dp;
+  for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
+
+    // exclude dir entries and files beginning with '.'
+
+    if (dp->d_name[0] == '.')
+      continue;
+    
+    // check for forecast generate time format
+
+    int hour, min, sec;
+    if (sscanf(dp->d_name, "g_%2d%2d%2d",
+               &hour, &min, &sec) == 3) {
+      index.hasForecast = true;
+      continue;
+    }
+
+    string path = daydir_path;
+    path += PATH_DELIM;
+    path += dp->d_name;
+
+    // the archive scan searches sub-directories recursively,
+    // which the index does not do
+    
+    if (prevFiles.find(path) == prevFiles.end() &&
+        ta_stat_is_dir(path.c_str())) {
+      index.hasSubdirs = true;
+      continue;
+    }
+      
+    // as in the archive scan, any file with a time in the name
+    // is included
+
+    time_t data_time;
+    if (getDataTime(path, data_time) == 0) {
+      index.hasValidTime = true;
+      index.paths.push_back(TimePathPair(data_time, path));
+    } else {
+      index.otherFiles.insert(path);
+    }
+
+  } // endfor - dp
+  
+  closedir(dirp);
+
+  sort(index.paths.begin(), index.paths.end());
+  index.dirMtime = dirStat.st_mtime;
+  index.readTime = now;
+
+  // limit the number of days held in the index,
+  // removing the least recently used
+
+  while (_dayIndex.size() > _maxDayIndexSize) {
+    map<string, DayIndex>::iterator oldest = _dayIndex.begin();
+    map<string, DayIndex>::iterator jj;
+    for (jj = _dayIndex.begin(); jj != _dayIndex.end(); jj++) {
+      if (jj->second.useTime < oldest->second.useTime) {
+        oldest = jj;
+      }
+    }
+    if (oldest->first == daydir_path) {
+      break;
+    }
+    _dayIndex.erase(oldest);
+  }
+
+  return &_dayIndex[daydir_path];
+
+}
 
 ////////////////////////////////////
 // test for file extension, if set
@@ -652,6 +652,9 @@ int LdataInfo::read(int max_valid_age /* = -1*/ )
 // sleep_msecs (millisecs):
 //   While in the polling state, the program sleeps for sleep_msecs
 //   millisecs at a time before checking again.
+//   If the directory is watched with inotify, the program instead
+//   waits until the latest data info is rewritten, checking at
+//   least once a second, or every sleep_msecs if that is longer.
 //
 //  heartbeat_func(): heartbeat function
 //    Just before sleeping each time, heartbeat_func() is called
@@ -674,12 +677,32 @@ void LdataInfo::readBlocking(int max_valid_age,
     if (heartbeat_func != NULL) {
       heartbeat_func("LdataInfo::readBlocking");
     }
-    umsleep(sleep_msecs);
+    _waitForChange(sleep_msecs);
   }
   return;
 
 }
 
+/////////////////////////////////////////////////////////////////
+// _waitForChange()
+//
+// Wait for the latest data info files to be rewritten, or sleep
+// for sleep_msecs if the directory cannot be watched.
+// When watching, waits for at most 1 sec, or sleep_msecs if that
+// is longer, so that the caller still polls occasionally.
+
+void LdataInfo::_waitForChange(int sleep_msecs)
+
+{
+  int max_msecs = sleep_msecs;
+  if (max_msecs < 1000) {
+    max_msecs = 1000;
+  }
+  string filePrefix("_");
+  filePrefix += _fileName;
+  _watcher.wait(_dataDirPath, filePrefix, sleep_msecs, max_msecs);
+}
+
 ////////////////////////////////////////////////////////////////////
 // readForced()
 //
@@ -0,0 +1,528 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////////
+// LdataWatcher.cc
+//
+// Waits for the latest data info files in a directory to change.
+// See LdataWatcher.hh for details.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#include <didss/LdataWatcher.hh>
+#include <toolsa/umisc.h>
+#include <toolsa/str.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+#include <sys/time.h>
+#if defined(__linux)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#endif
+using namespace std;
+
+// file system magic numbers, from statfs(2)
+
+#define LDATA_NFS_SUPER_MAGIC 0x6969
+#define LDATA_SMB_SUPER_MAGIC 0x517B
+#define LDATA_CIFS_MAGIC_NUMBER 0xFF534D42
+#define LDATA_SMB2_MAGIC_NUMBER 0xFE534D42
+
+// shared inotify instance
+
+pthread_mutex_t LdataWatcher::_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t LdataWatcher::_cond = PTHREAD_COND_INITIALIZER;
+int LdataWatcher::_fd = -1;
+pid_t LdataWatcher::_fdPid = 0;
+bool LdataWatcher::_polling = false;
+bool LdataWatcher::_initFailLogged = false;
+set<LdataWatcher *> *LdataWatcher::_watchers = NULL;
+
+//////////////
+// constructor
+
+LdataWatcher::LdataWatcher()
+
+{
+  _enabled = true;
+  const char *watchStr = getenv("LDATA_WATCH");
+  if (watchStr != NULL && STRequal(watchStr, "false")) {
+    _enabled = false;
+  }
+  _wd = -1;
+  _remote = false;
+  _changed = false;
+  _fallbackLogged = false;
+}
+
+////////////////////
+// copy constructor
+
+LdataWatcher::LdataWatcher(const LdataWatcher &orig)
+
+{
+  _enabled = orig._enabled;
+  _wd = -1;
+  _remote = false;
+  _changed = false;
+  _fallbackLogged = false;
+}
+
+//////////////
+// assignment
+
+LdataWatcher &LdataWatcher::operator=(const LdataWatcher &other)
+
+{
+  if (this != &other) {
+    _enabled = other._enabled;
+  }
+  return *this;
+}
+
+/////////////
+// destructor
+
+LdataWatcher::~LdataWatcher()
+
+{
+  close();
+}
+
+////////////////////////////////////////////////////////////////
+// wait()
+//
+// Wait for a file in dirPath, whose name starts with filePrefix,
+// to be rewritten.
+//
+// Returns true if a change was seen, false otherwise.
+
+bool LdataWatcher::wait(const string &dirPath, const string &filePrefix,
+                        int poll_msecs, int max_msecs)
+
+{
+
+#if defined(__linux)
+
+  if (_enabled) {
+
+    pthread_mutex_lock(&_mutex);
+
+    if (_openInstance()) {
+      // out of inotify instances, poll from now on
+      _enabled = false;
+      pthread_mutex_unlock(&_mutex);
+      umsleep(poll_msecs);
+      return false;
+    }
+
+    // set up the watch if the directory has changed, or if
+    // it could not be watched before because it did not exist
+
+    _filePrefix = filePrefix;
+    if (dirPath != _dirPath || (_wd < 0 && !_remote)) {
+      if (_addWatch(dirPath) == 0) {
+        pthread_mutex_unlock(&_mutex);
+        return true;
+      }
+    }
+
+    if (_wd >= 0) {
+      bool changed = _waitForChange(max_msecs);
+      pthread_mutex_unlock(&_mutex);
+      return changed;
+    }
+
+    pthread_mutex_unlock(&_mutex);
+
+  } // if (_enabled)
+
+#endif
+
+  umsleep(poll_msecs);
+  return false;
+
+}
+
+////////////////////////////////////////////////////////////////
+// remove the watch
+
+void LdataWatcher::close()
+
+{
+  pthread_mutex_lock(&_mutex);
+  _removeWatch();
+  _remote = false;
+  _changed = false;
+  _dirPath.clear();
+  pthread_mutex_unlock(&_mutex);
+}
+
+////////////////////////////////////////////////////////////////
+// Wait for a change to be seen for this watcher, for at most
+// max_msecs.
+//
+// Only one thread polls the inotify instance at a time. It reads
+// the events for all of the watchers, then wakes the others, which
+// wait on the condition variable in the meantime.
+//
+// Returns true if a change was seen, false otherwise.
+
+bool LdataWatcher::_waitForChange(int max_msecs)
+
+{
+
+#if defined(__linux)
+
+  struct timeval start;
+  gettimeofday(&start, NULL);
+  struct timespec deadline;
+  long long deadlineUsecs =
+    (long long) start.tv_usec + (long long) max_msecs * 1000;
+  deadline.tv_sec = start.tv_sec + deadlineUsecs / 1000000;
+  deadline.tv_nsec = (deadlineUsecs % 1000000) * 1000;
+
+  while (!_changed && _wd >= 0) {
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int elapsedMsecs = (now.tv_sec - start.tv_sec) * 1000 +
+      (now.tv_usec - start.tv_usec) / 1000;
+    int waitMsecs = max_msecs - elapsedMsecs;
+    if (waitMsecs <= 0) {
+      break;
+    }
+
+    if (_polling) {
+      // another thread is polling, and will wake us up
+      pthread_cond_timedwait(&_cond, &_mutex, &deadline);
+      continue;
+    }
+
+    _polling = true;
+    struct pollfd pfd;
+    pfd.fd = _fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    pthread_mutex_unlock(&_mutex);
+    int nReady = poll(&pfd, 1, waitMsecs);
+    int errNum = errno;
+    pthread_mutex_lock(&_mutex);
+    _polling = false;
+    if (nReady > 0) {
+      _readEvents();
+    }
+    pthread_cond_broadcast(&_cond);
+    if (nReady < 0 && errNum != EINTR) {
+      break;
+    }
+
+  } // while
+
+#endif
+
+  bool changed = _changed;
+  _changed = false;
+  return changed;
+
+}
+
+////////////////////////////////////////////////////////////////
+// Set up the watch on a directory, replacing any previous one.
+//
+// Returns 0 on success, -1 if the directory cannot be watched.
+
+int LdataWatcher::_addWatch(const string &dirPath)
+
+{
+
+  _removeWatch();
+  _dirPath = dirPath;
+  _changed = false;
+
+#if defined(__linux)
+
+  _remote = _isRemoteFs(dirPath);
+  if (_remote) {
+    _logFallback("Directory is on a network file system");
+    return -1;
+  }
+
+  // watchers on the same directory get the same watch descriptor
+
+  _wd = inotify_add_watch(_fd, dirPath.c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY |
+                          IN_DELETE_SELF | IN_MOVE_SELF);
+  if (_wd < 0) {
+    if (errno != ENOENT) {
+      // the directory may not exist yet, otherwise it cannot
+      // be watched, for example if out of inotify watches
+      _logFallback(string("Cannot watch directory: ") + strerror(errno));
+    }
+    return -1;
+  }
+
+  if (_watchers == NULL) {
+    _watchers = new set<LdataWatcher *>;
+  }
+  _watchers->insert(this);
+
+  return 0;
+
+#else
+
+  return -1;
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////
+// Remove this watcher's watch. The watch itself is only removed
+// from the inotify instance if no other watcher is using it.
+
+void LdataWatcher::_removeWatch()
+
+{
+
+  if (_wd < 0) {
+    return;
+  }
+
+  _watchers->erase(this);
+
+#if defined(__linux)
+
+  bool inUse = false;
+  for (set<LdataWatcher *>::iterator it = _watchers->begin();
+       it != _watchers->end(); it++) {
+    if ((*it)->_wd == _wd) {
+      inUse = true;
+      break;
+    }
+  }
+  if (!inUse) {
+    inotify_rm_watch(_fd, _wd);
+  }
+
+#endif
+
+  _wd = -1;
+
+}
+
+////////////////////////////////////////////////////////////////
+// Print a warning, the first time this watcher falls back to
+// polling.
+
+void LdataWatcher::_logFallback(const string &reason)
+
+{
+  if (_fallbackLogged) {
+    return;
+  }
+  _fallbackLogged = true;
+  cerr << "WARNING - LdataWatcher" << endl;
+  cerr << "  " << reason << endl;
+  cerr << "  Polling for changes instead, dir: " << _dirPath << endl;
+}
+
+////////////////////////////////////////////////////////////////
+// Open the shared inotify instance, if it is not open in this
+// process. After a fork, the child does not use the parent's
+// instance, since they would each read the other's events.
+//
+// Returns 0 on success, -1 on failure.
+
+int LdataWatcher::_openInstance()
+
+{
+
+#if defined(__linux)
+
+  pid_t pid = getpid();
+  if (_fd >= 0 && _fdPid == pid) {
+    return 0;
+  }
+
+  if (_fd >= 0) {
+    // forked - drop the parent's instance and watches
+    ::close(_fd);
+    _fd = -1;
+    if (_watchers != NULL) {
+      for (set<LdataWatcher *>::iterator it = _watchers->begin();
+           it != _watchers->end(); it++) {
+        (*it)->_wd = -1;
+      }
+      _watchers->clear();
+    }
+    _polling = false;
+  }
+
+  _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (_fd < 0) {
+    if (!_initFailLogged) {
+      _initFailLogged = true;
+      int errNum = errno;
+      cerr << "WARNING - LdataWatcher" << endl;
+      cerr << "  Cannot create inotify instance: "
+           << strerror(errNum) << endl;
+      cerr << "  Polling for changes instead" << endl;
+    }
+    return -1;
+  }
+  _fdPid = pid;
+  return 0;
+
+#else
+
+  return -1;
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////
+// Read the pending events, and pass them on to the watchers.
+//
+// A watcher's _changed flag is set if one of its files was
+// rewritten, or if the watch was lost, so that the caller
+// should check the files.
+
+void LdataWatcher::_readEvents()
+
+{
+
+#if defined(__linux)
+
+  char buf[8192] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+  while (true) {
+
+    ssize_t len = ::read(_fd, buf, sizeof(buf));
+    if (len <= 0) {
+      break;
+    }
+
+    for (char *ptr = buf; ptr < buf + len; ) {
+
+      const struct inotify_event *event = (const struct inotify_event *) ptr;
+      ptr += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // events lost, all watchers should check their files
+        for (set<LdataWatcher *>::iterator it = _watchers->begin();
+             it != _watchers->end(); it++) {
+          (*it)->_changed = true;
+        }
+        continue;
+      }
+
+      bool lost = ((event->mask & (IN_IGNORED |
+                                   IN_DELETE_SELF | IN_MOVE_SELF)) != 0);
+      string name;
+      if (event->len > 0) {
+        name = event->name;
+      }
+
+      set<LdataWatcher *>::iterator it = _watchers->begin();
+      while (it != _watchers->end()) {
+
+        LdataWatcher *watcher = *it;
+        if (watcher->_wd != event->wd) {
+          it++;
+          continue;
+        }
+
+        if (lost) {
+          // directory gone
+          watcher->_changed = true;
+          watcher->_wd = -1;
+          _watchers->erase(it++);
+          continue;
+        }
+        it++;
+
+        if (name.size() == 0) {
+          continue;
+        }
+        const string &filePrefix = watcher->_filePrefix;
+        if (name.compare(0, filePrefix.size(), filePrefix) != 0) {
+          continue;
+        }
+        // skip the lock file, and temporary files which will
+        // be renamed into place
+        if (name.find(".lock") != string::npos ||
+            name.find(".tmp") != string::npos) {
+          continue;
+        }
+        watcher->_changed = true;
+
+      } // it
+
+      if (event->mask & IN_MOVE_SELF) {
+        // the kernel keeps the watch on the moved directory
+        inotify_rm_watch(_fd, event->wd);
+      }
+
+    } // ptr
+
+  } // while
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////
+// Is the directory on a network file system?
+// inotify only sees changes made on this host.
+
+bool LdataWatcher::_isRemoteFs(const string &dirPath)
+
+{
+
+#if defined(__linux)
+
+  struct statfs fsStat;
+  if (statfs(dirPath.c_str(), &fsStat)) {
+    return false;
+  }
+  unsigned int fsType = (unsigned int) fsStat.f_type;
+  if (fsType == LDATA_NFS_SUPER_MAGIC ||
+      fsType == LDATA_SMB_SUPER_MAGIC ||
+      fsType == LDATA_CIFS_MAGIC_NUMBER ||
+      fsType == LDATA_SMB2_MAGIC_NUMBER) {
+    return true;
+  }
+
+#endif
+
+  return false;
+
+}
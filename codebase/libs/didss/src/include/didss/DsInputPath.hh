@@ -56,6 +56,11 @@
 //   mode, the blocking routine can be used to wait for new data to
 //   arrive within the specified interval.
 //
+// Incremental scanning:
+//   By default the object keeps an index of the directories it has
+//   scanned, so that repeated scans do not re-read and re-stat every
+//   file. See setIncrementalScan().
+//
 // Mike Dixon, RAP, NCAR, P.O.Box 3000, Boulder, CO, 80307-3000, USA
 //
 // March 1998
@@ -68,6 +73,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <deque>
 #include <didss/LdataInfo.hh>
 
@@ -335,6 +341,28 @@ public:
 
   void setUseInotify(bool useInotifyFlag = true);
 
+  ///////////////////////////////////////////////////////////
+  // set whether to scan directories incrementally
+  // default is true
+  //
+  // In REALTIME mode, when neither the latest_data_info file nor
+  // inotify is used, the state of each directory is kept between
+  // scans. A directory is only re-read if its modify time has
+  // changed, and only new files, and files young enough to be
+  // returned, are statted on each scan. All files are statted
+  // at least every max_file_age / 2 secs, so that old files
+  // which are rewritten in place are still found.
+  //
+  // For getClosest() and the related search methods, a time-sorted
+  // index of each day directory is kept. The index is only rebuilt
+  // when the directory modify time changes, and the search is
+  // a binary search of the index. Layouts other than
+  // <input_dir>/YYYYMMDD/hhmmss.<ext> are scanned in full.
+  //
+  // If false, the directories are scanned in full each time.
+
+  void setIncrementalScan(bool state = true);
+
   ///////////////////////////////////////////////////////////
   // Option to set _latest_file_only flag
   //
@@ -586,6 +614,53 @@ private:
   mutable LdataInfo _ldata;
   mutable string _returned_path;
 
+  // incremental scanning - see setIncrementalScan()
+
+  bool _incremental_scan;
+
+  // realtime mode - state of the directory entries at the last scan
+
+  typedef struct {
+    time_t mtime;      // modify time
+    time_t statTime;   // time of last stat
+    bool isDir;
+    bool isReg;
+    bool isLink;
+  } entry_state_t;
+
+  class DirState {
+  public:
+    DirState() : dirMtime(-1), readTime(-1), fullStatTime(-1), scanNum(-1) {}
+    time_t dirMtime;      // dir modify time when last read
+    time_t readTime;      // time dir was last read
+    time_t fullStatTime;  // time all entries were last statted
+    int scanNum;          // scan in which dir was last visited
+    map<string, entry_state_t> entries;
+  };
+
+  int _scanNum;
+  map<string, DirState> _dirStates;
+
+  // triggered searches - time-sorted index of day directories
+
+  class DayIndex {
+  public:
+    DayIndex() : dirMtime(-1), readTime(-1), useTime(-1),
+                 hasValidTime(false), hasForecast(false),
+                 hasSubdirs(false) {}
+    time_t dirMtime;      // dir modify time when last read
+    time_t readTime;      // time dir was last read
+    time_t useTime;       // time index was last used
+    bool hasValidTime;    // contains files with data times
+    bool hasForecast;     // contains g_hhmmss subdirs
+    bool hasSubdirs;      // contains other subdirs
+    vector<TimePathPair> paths; // sorted by time, then path
+    set<string> otherFiles;     // files without data times
+  };
+
+  mutable map<string, DayIndex> _dayIndex;
+  static const size_t _maxDayIndexSize = 64;
+
   // default constructor - only used by class itself
 
   DsInputPath();
@@ -620,6 +695,18 @@ private:
 
   void _load_timelist_realtime(const string &input_dir, int depth);
 
+  DirState *_updateDirState(const string &dir, time_t now);
+
+  int _statEntry(const string &dir, const string &name,
+                 time_t now, entry_state_t &entry);
+
+  int _getClosestIndexed(time_t search_time,
+                         time_t start_time,
+                         time_t end_time,
+                         time_t *data_time) const;
+
+  const DayIndex *_updateDayIndex(int day_num) const;
+
   bool _hasExt(const string &path);
   bool _hasExt(const string &path, string ext);
 
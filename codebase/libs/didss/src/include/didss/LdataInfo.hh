@@ -57,6 +57,10 @@
 //                      Default is true.
 //  LDATA_FMQ_NSLOTS -  number of slots in fmq.
 //                      Default is 2500.
+//  LDATA_WATCH -       if 'false', readBlocking() polls at the sleep
+//                      interval instead of watching the directory
+//                      with inotify. See LdataWatcher.
+//                      Default is true.
 //
 /////////////////////////////////////////////////////////////////////
 
@@ -67,6 +71,7 @@
 #include <toolsa/fmq.h>
 #include <toolsa/MemBuf.hh>
 #include <didss/DsURL.hh>
+#include <didss/LdataWatcher.hh>
 #include <dataport/port_types.h>
 using namespace std;
 
@@ -441,6 +446,9 @@ public:
   // sleep_msecs (millisecs):
   //   While in the polling state, the program sleeps for sleep_msecs
   //   millisecs at a time before checking again.
+  //   If the directory is watched with inotify, the program instead
+  //   waits until the latest data info is rewritten, checking at
+  //   least once a second, or every sleep_msecs if that is longer.
   //
   //  heartbeat_func(): heartbeat function
   //    Just before sleeping each time, heartbeat_func() is called
@@ -717,6 +725,10 @@ protected:
 
   LdataInfo *_latestReadInfo;
 
+  // watcher for changes to the info files, used while blocking
+
+  LdataWatcher _watcher;
+
   ////////////////////////////////////////////////////////
   // the following is information about the data set files
   // rather than this object itself
@@ -793,6 +805,7 @@ protected:
   int _readFmq(int max_valid_age, bool &newData);
   int _openReadFmq(int max_valid_age);
   void _closeReadFmq();
+  void _waitForChange(int sleep_msecs);
   void _checkFilesForReading(int max_valid_age,
 			     bool &useFmq, bool &useXml, bool &useAscii);
   int _makeDir() const;
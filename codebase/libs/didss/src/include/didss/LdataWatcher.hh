@@ -0,0 +1,143 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+
+#ifndef LDATA_WATCHER_HH
+#define LDATA_WATCHER_HH
+
+////////////////////////////////////////////////////////////////////
+// LdataWatcher.hh
+//
+// Waits for the latest data info files in a directory to change.
+//
+// Used by LdataInfo::readBlocking() in place of a fixed sleep
+// between polls. On Linux the directory is watched with inotify,
+// and the wait returns as soon as one of the latest data info
+// files is rewritten. The wait is bounded, so the caller still
+// polls occasionally, which covers any missed events.
+//
+// All watchers in a process share a single inotify instance, so
+// a process with many LdataInfo objects uses one file descriptor,
+// and watchers on the same directory share one watch. Whichever
+// thread is waiting polls the instance, and hands events on to the
+// other watchers. After a fork the child opens its own instance.
+//
+// inotify does not see changes made on other hosts, so for
+// directories on NFS or SMB file systems, and on other platforms,
+// the watcher falls back to sleeping for the poll interval.
+// A warning is printed the first time a watcher falls back.
+//
+// Environment variables:
+//
+//  LDATA_WATCH - if 'false', do not use inotify, always poll.
+//                Default is true.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <set>
+#include <pthread.h>
+#include <sys/types.h>
+using namespace std;
+
+class LdataWatcher {
+
+public:
+
+  // constructor
+
+  LdataWatcher();
+
+  // copy constructor and assignment
+  // The watch itself is not copied - the copy sets up its own
+  // watch on the first call to wait().
+
+  LdataWatcher(const LdataWatcher &orig);
+  LdataWatcher &operator=(const LdataWatcher &other);
+
+  // destructor - removes the watch
+
+  ~LdataWatcher();
+
+  ////////////////////////////////////////////////////////////////
+  // wait()
+  //
+  // Wait for a file in dirPath, whose name starts with filePrefix,
+  // to be rewritten.
+  //
+  // If the directory can be watched, blocks until a change is seen
+  // or for max_msecs at most. Otherwise sleeps for poll_msecs.
+  //
+  // When the watch is first set up, returns immediately, since a
+  // change may have been missed before the watch was in place.
+  //
+  // Returns true if a change was seen, false otherwise.
+
+  bool wait(const string &dirPath, const string &filePrefix,
+            int poll_msecs, int max_msecs);
+
+  // remove the watch
+
+  void close();
+
+  // is a directory being watched?
+
+  bool isWatching() const { return (_wd >= 0); }
+
+protected:
+private:
+
+  bool _enabled;
+  int _wd;
+  bool _remote;
+  bool _changed;
+  bool _fallbackLogged;
+  string _dirPath;
+  string _filePrefix;
+
+  // the inotify instance shared by the process, and the
+  // watchers which currently have a watch on it
+
+  static pthread_mutex_t _mutex;
+  static pthread_cond_t _cond;
+  static int _fd;
+  static pid_t _fdPid;
+  static bool _polling;
+  static bool _initFailLogged;
+  static set<LdataWatcher *> *_watchers;
+
+  // these are called with the mutex held
+
+  bool _waitForChange(int max_msecs);
+  int _addWatch(const string &dirPath);
+  void _removeWatch();
+  void _logFallback(const string &reason);
+  static int _openInstance();
+  static void _readEvents();
+  static bool _isRemoteFs(const string &dirPath);
+
+};
+
+#endif
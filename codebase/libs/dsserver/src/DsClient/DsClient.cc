@@ -37,8 +37,19 @@
 #include <dsserver/DsLocator.hh>
 #include <dsserver/DsServerMsg.hh>
 #include <toolsa/TaStr.hh>
+#include <toolsa/str.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <cerrno>
 using namespace std;
 
+// static members
+
+map<string, vector<DsClient::KeptConn> > DsClient::_keptConns;
+set<string> DsClient::_noKeepAlive;
+pthread_mutex_t DsClient::_keptMutex = PTHREAD_MUTEX_INITIALIZER;
+
 // constructor
 
 DsClient::DsClient()
@@ -47,6 +58,13 @@ DsClient::DsClient()
   _debug = false;
   _mergeDebugWithErrStr = false;
   _openTimeoutMsecs = -1;
+  _keepAlive = false;
+  const char *DS_KEEP_ALIVE = getenv("DS_KEEP_ALIVE");
+  if (DS_KEEP_ALIVE != NULL && STRequal(DS_KEEP_ALIVE, "true")) {
+    _keepAlive = true;
+  }
+  _keptSock = NULL;
+  _keptSecs = 0;
 }
 
 // destructor
@@ -54,7 +72,7 @@ DsClient::DsClient()
 DsClient::~DsClient()
 
 {
-
+  _releaseKeptConn();
 }
 
 // free up data which the socket object manages
@@ -62,6 +80,9 @@ DsClient::~DsClient()
 void DsClient::freeData()
 {
   _sock.freeData();
+  if (_keptSock != NULL) {
+    _keptSock->freeData();
+  }
 }
 
 ////////////////////////////////////////////////////
@@ -94,6 +115,10 @@ int DsClient::communicateAutoFwd(const DsURL &url,
     cerr << "-------------------------" << endl;
   }
 
+  // return any keep-alive connection from a previous call to the pool
+  
+  _releaseKeptConn();
+
   // check for forwarding
   
   if (url.prepareForwarding("DsClient::communicateAutoFwd", msgLen)) {
@@ -244,6 +269,17 @@ int DsClient::_communicateNoFwd(const DsURL &url,
   
 {
   
+  // use keep-alive connection if possible
+  
+  if (_keepAlive) {
+    int iret = _communicateKeepAlive(url, msgType, msgBuf, msgLen,
+                                     commTimeoutMsecs);
+    if (iret <= 0) {
+      return iret;
+    }
+    // server does not support keep-alive, use one-shot connection
+  }
+
   if (_debug) {
     _writeDebug("------> _communicateNoFwd() opening socket");
   }
@@ -452,6 +488,321 @@ int DsClient::_communicateFwd(const DsURL &url,
 
 }
 
+////////////////////////////////////////////
+// Communicate with server on a keep-alive
+// connection - no forwarding
+//
+// Reuses an idle connection to the server from the pool
+// if there is one and reuseConn is true, otherwise opens a
+// new connection and negotiates keep-alive on it. On success
+// the connection is held in _keptSock until the reply is no
+// longer needed.
+//
+// If the server closes a reused connection before any of the
+// reply arrives, the request is sent once more on a new one.
+//
+// Returns 0 on success, -1 on error, 1 if the server does
+// not support keep-alive.
+
+int DsClient::_communicateKeepAlive(const DsURL &url,
+                                    int msgType,
+                                    const void *msgBuf,
+                                    ssize_t msgLen,
+                                    int commTimeoutMsecs,
+                                    bool reuseConn /* = true */)
+  
+{
+
+  string key = url.getHost();
+  TaStr::AddInt(key, ":", url.getPort(), false);
+
+  pthread_mutex_lock(&_keptMutex);
+  bool refused = (_noKeepAlive.find(key) != _noKeepAlive.end());
+  pthread_mutex_unlock(&_keptMutex);
+  if (refused) {
+    return 1;
+  }
+
+  // get idle connection from the pool, or open and negotiate a new one
+
+  int keepAliveSecs = 0;
+  ThreadSocket *sock = NULL;
+  if (reuseConn) {
+    sock = _checkOutKeptConn(key, keepAliveSecs);
+  }
+  bool reused = (sock != NULL);
+
+  if (reused) {
+
+    if (_debug) {
+      _writeDebug("------> _communicateKeepAlive() reusing connection: ", key);
+    }
+
+  } else {
+
+    if (_debug) {
+      _writeDebug("------> _communicateKeepAlive() opening socket: ", key);
+    }
+
+    sock = new ThreadSocket;
+    if (sock->open(url.getHost().c_str(),
+                   url.getPort(),
+                   _openTimeoutMsecs)) {
+      _errStr += "ERROR - COMM - DsClient::_communicateKeepAlive sock->open\n";
+      _errStr += "  Cannot connect to server\n";
+      TaStr::AddStr(_errStr, "  host: ", url.getHost());
+      TaStr::AddInt(_errStr, "  port: ", url.getPort());
+      TaStr::AddStr(_errStr, "  url: ", url.getURLStr());
+      _errStr += sock->getErrStr();
+      delete sock;
+      return -1;
+    }
+
+    // messages are written as a header then a body, so disable
+    // Nagle to avoid delayed-ack stalls on the persistent connection
+    
+    int nodelay = 1;
+    setsockopt(sock->getSd(), IPPROTO_TCP, TCP_NODELAY,
+               (char *) &nodelay, sizeof(nodelay));
+
+    int iret = _negotiateKeepAlive(sock, commTimeoutMsecs, keepAliveSecs);
+    if (iret != 0) {
+      if (iret > 0) {
+        if (_debug) {
+          _writeDebug("------> _communicateKeepAlive() not supported: ", key);
+        }
+        pthread_mutex_lock(&_keptMutex);
+        _noKeepAlive.insert(key);
+        pthread_mutex_unlock(&_keptMutex);
+      } else {
+        _errStr += "ERROR - COMM - DsClient::_communicateKeepAlive\n";
+        _errStr += "  Cannot negotiate keep-alive with server\n";
+        TaStr::AddStr(_errStr, "  url: ", url.getURLStr());
+        _errStr += sock->getErrStr();
+      }
+      delete sock;
+      return iret;
+    }
+
+  }
+
+  // write the message
+  
+  if (sock->writeMessage(msgType, msgBuf, msgLen, commTimeoutMsecs)) {
+    if (reused) {
+      // server closed the connection - try again on a new one
+      if (_debug) {
+        _writeDebug("------> _communicateKeepAlive() stale connection: ", key);
+      }
+      delete sock;
+      return _communicateKeepAlive(url, msgType, msgBuf, msgLen,
+                                   commTimeoutMsecs);
+    }
+    _errStr +=
+      "ERROR - COMM - DsClient::_communicateKeepAlive sock->writeMessage\n";
+    _errStr += "  Errors writing message to server.\n";
+    TaStr::AddStr(_errStr, "  url: ", url.getURLStr());
+    _errStr += sock->getErrStr();
+    delete sock;
+    return -1;
+  }
+  
+  // on a reused connection, check that the reply is on its way -
+  // the server may have closed the connection as the request was
+  // sent, in which case try once more on a new connection
+
+  if (reused) {
+    int iret = _waitForReply(sock, commTimeoutMsecs);
+    if (iret > 0) {
+      if (_debug) {
+        _writeDebug("------> _communicateKeepAlive() closed before reply: ",
+                    key);
+      }
+      delete sock;
+      return _communicateKeepAlive(url, msgType, msgBuf, msgLen,
+                                   commTimeoutMsecs, false);
+    } else if (iret < 0) {
+      _errStr +=
+        "ERROR - COMM - DsClient::_communicateKeepAlive\n";
+      _errStr += "  No reply from server.\n";
+      TaStr::AddStr(_errStr, "  url: ", url.getURLStr());
+      _errStr += sock->getErrStr();
+      delete sock;
+      return -1;
+    }
+  }
+
+  // read the reply
+
+  if (sock->readMessage(commTimeoutMsecs)) {
+    _errStr +=
+      "ERROR - COMM - DsClient::_communicateKeepAlive sock->readMessage\n";
+    _errStr += "  Cannot read reply from server.\n";
+    TaStr::AddStr(_errStr, "  url: ", url.getURLStr());
+    _errStr += sock->getErrStr();
+    delete sock;
+    return -1;
+  }
+
+  // hold on to the connection until the reply is no longer needed
+  
+  _keptSock = sock;
+  _keptKey = key;
+  _keptSecs = keepAliveSecs;
+  return 0;
+
+}
+
+////////////////////////////////////////////
+// Wait for the reply to start arriving on a
+// keep-alive connection, without reading it.
+//
+// Returns 0 if the reply is ready to read, 1 if the server
+// closed or reset the connection before sending any of it,
+// -1 on timeout or other error.
+
+int DsClient::_waitForReply(ThreadSocket *sock, int commTimeoutMsecs)
+
+{
+
+  if (sock->readSelect(commTimeoutMsecs)) {
+    return -1;
+  }
+
+  char byte;
+  ssize_t nRead;
+  do {
+    nRead = recv(sock->getSd(), &byte, 1, MSG_PEEK);
+  } while (nRead < 0 && errno == EINTR);
+
+  if (nRead > 0) {
+    return 0;
+  }
+  if (nRead == 0 || errno == ECONNRESET) {
+    return 1;
+  }
+  return -1;
+
+}
+
+////////////////////////////////////////////
+// Check out an idle keep-alive connection
+// from the pool.
+//
+// Connections which the server may have closed, because they
+// have been idle for close to the server's keep-alive time, or
+// which have something to read - the end-of-file from the server
+// closing - are discarded.
+//
+// Returns the connection, or NULL if there are none.
+
+ThreadSocket *DsClient::_checkOutKeptConn(const string &key,
+                                          int &keepAliveSecs)
+
+{
+
+  ThreadSocket *sock = NULL;
+  time_t now = time(NULL);
+
+  pthread_mutex_lock(&_keptMutex);
+  vector<KeptConn> &conns = _keptConns[key];
+  while (conns.size() > 0) {
+    KeptConn conn = conns.back();
+    conns.pop_back();
+    if (now - conn.lastUsed < conn.keepAliveSecs - 2 &&
+        conn.sock->readSelect(0) != 0) {
+      // timed out waiting for data, so the connection is idle and open
+      conn.sock->removeState(SockUtil::STATE_ERROR);
+      sock = conn.sock;
+      keepAliveSecs = conn.keepAliveSecs;
+      break;
+    }
+    delete conn.sock;
+  }
+  pthread_mutex_unlock(&_keptMutex);
+
+  return sock;
+
+}
+
+////////////////////////////////////////////
+// Return the keep-alive connection in use,
+// if any, to the pool.
+
+void DsClient::_releaseKeptConn()
+
+{
+
+  if (_keptSock == NULL) {
+    return;
+  }
+
+  _keptSock->freeData();
+  
+  pthread_mutex_lock(&_keptMutex);
+  vector<KeptConn> &conns = _keptConns[_keptKey];
+  if (conns.size() < _maxKeptPerServer) {
+    KeptConn conn;
+    conn.sock = _keptSock;
+    conn.lastUsed = time(NULL);
+    conn.keepAliveSecs = _keptSecs;
+    conns.push_back(conn);
+  } else {
+    delete _keptSock;
+  }
+  pthread_mutex_unlock(&_keptMutex);
+
+  _keptSock = NULL;
+
+}
+
+////////////////////////////////////////////
+// Negotiate keep-alive on a new connection,
+// by sending the KEEP_ALIVE server command.
+//
+// Servers which support it reply with the idle time for
+// which they keep the connection open.
+//
+// Returns 0 on success, -1 on comm error, 1 if the server
+// does not support keep-alive.
+
+int DsClient::_negotiateKeepAlive(ThreadSocket *sock,
+                                  int commTimeoutMsecs,
+                                  int &keepAliveSecs)
+
+{
+
+  DsServerMsg msg;
+  msg.setCategory(DsServerMsg::ServerStatus);
+  msg.setType(DsServerMsg::KEEP_ALIVE);
+  void *msgToSend = msg.assemble();
+  ssize_t msgLen = msg.lengthAssembled();
+
+  if (sock->writeMessage(0, msgToSend, msgLen, commTimeoutMsecs)) {
+    return -1;
+  }
+  if (sock->readMessage(commTimeoutMsecs)) {
+    return -1;
+  }
+
+  DsServerMsg reply;
+  if (reply.disassemble(sock->getData(), sock->getNumBytes())) {
+    return 1;
+  }
+  if (reply.getMessageErr() != DsServerMsg::DSS_MSG_SUCCESS ||
+      reply.getMessageCat() != DsServerMsg::ServerStatus ||
+      reply.getType() != DsServerMsg::KEEP_ALIVE) {
+    return 1;
+  }
+  keepAliveSecs = reply.getFirstInt();
+  if (keepAliveSecs <= 0) {
+    return 1;
+  }
+
+  return 0;
+
+}
+
 ///////////////////////////////////////////////////////////
 // Request the DsServerMgr to start the server for this URL
 //
@@ -576,7 +576,12 @@ void DsLdataInfo::readBlocking(int max_valid_age,
     if (heartbeat_func != NULL) {
       heartbeat_func("DsLdataInfo::readBlocking");
     }
-    umsleep(sleep_msecs);
+    if (_useServer) {
+      umsleep(sleep_msecs);
+    } else {
+      // local data - wait on the directory watch if possible
+      _waitForChange(sleep_msecs);
+    }
   }
   return;
 
@@ -37,6 +37,9 @@
 
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <signal.h>
 using namespace std;
 
@@ -77,7 +80,8 @@ DsProcessServer::DsProcessServer(const string & executableName,
   _isSecure(isSecure),
   _isReadOnly(isReadOnly),
   _allowHttp(allowHttp),
-  _lastPrint(0)
+  _lastPrint(0),
+  _keepAliveSecs(DS_DEFAULT_KEEP_ALIVE_SECS)
 
 {
 
@@ -128,6 +132,16 @@ DsProcessServer::DsProcessServer(const string & executableName,
     }
   }
   
+  // override keep-alive idle time from environment?
+  
+  char *DS_KEEP_ALIVE_SECS = getenv("DS_KEEP_ALIVE_SECS");
+  if (DS_KEEP_ALIVE_SECS != NULL) {
+    int keep_alive_secs;
+    if (sscanf(DS_KEEP_ALIVE_SECS, "%d", &keep_alive_secs) == 1) {
+      _keepAliveSecs = keep_alive_secs;
+    }
+  }
+  
   // Open socket on the port.
   _serverSocket = new ServerSocket();
   if (_serverSocket->openServer(_port) < 0) {
@@ -879,6 +893,10 @@ int DsProcessServer::sendReply(Socket * socket,
 // Looks at the incoming data, verifies that it is a valid DsServerMsg,
 //   and determines whether it is a server command or a data command.
 //   Calls the appropriate handler method based on the determined type.
+//
+// If the client negotiates keep-alive, further requests are served
+//   on the same connection until the client closes it or is idle
+//   for more than _keepAliveSecs.
 // 
 // If there is a problem reading or interpreting the message, replies
 //   to the client with an error message having one of the following types:
@@ -932,7 +950,55 @@ void * DsProcessServer::__serveClient(void * svrsockstruct)
     return NULL;
   }
 
-  if (server->_isVerbose) {
+  // Serve requests until the client is done. Unless keep-alive has
+  // been negotiated, this is a single request.
+
+  bool keepAlive = false;
+  while (server->serveRequest(socket, keepAlive) == 0 && keepAlive) {
+
+    // wait for the next request on this connection,
+    // closing it if the client is idle for too long
+
+    if (socket->readSelect(server->_keepAliveSecs * 1000)) {
+      if (server->_isVerbose) {
+        cerr << "Client handler closing idle keep-alive connection." << endl;
+      }
+      break;
+    }
+
+  }
+
+  // Notify the server this thread is finished.
+  server->clientDone();
+
+  // Done with the thread. Exit cleanly.
+  return NULL;
+
+}
+
+///////////////////////////////////////////////////////////////////////
+// serveRequest()
+// 
+// Read a single request from the client, and handle it.
+//
+// Looks at the incoming data, verifies that it is a valid DsServerMsg,
+//   and determines whether it is a server command or a data command.
+//   Calls the appropriate handler method based on the determined type.
+//
+// keepAlive is set true if the client negotiates keep-alive.
+//   If it is already true, a failed read is taken to mean that
+//   the client has closed the connection, and no reply is sent.
+//
+// Threads: Called by Worker threads.
+// 
+// Returns 0 if the connection may be used for further requests,
+//        -1 if it should be closed.
+
+int DsProcessServer::serveRequest(Socket * socket, bool &keepAlive)
+
+{
+
+  if (_isVerbose) {
     cerr << "Client handler thread reading from socket..." << endl;
   }
 
@@ -951,6 +1017,15 @@ void * DsProcessServer::__serveClient(void * svrsockstruct)
   int status = socket->readMessage(commTimeoutMsecs);
 
   if (status != 0) {
+
+    if (keepAlive) {
+      // client has closed a keep-alive connection
+      if (_isVerbose) {
+        cerr << "Client closed keep-alive connection." << endl;
+      }
+      return -1;
+    }
+
     char buf[10];
     sprintf(buf, "%d", status);
     string errMsg  = "Error: Server could not read. Got status: ";
@@ -960,26 +1035,24 @@ void * DsProcessServer::__serveClient(void * svrsockstruct)
     errMsg += buf;
     errMsg += ". Error String: ";
     errMsg += socket->getErrString();
-    if (server->_isDebug) {
+    if (_isDebug) {
       cerr << errMsg << endl;
     }
 
     // Send error reply to client
     string statusString;
-    server->sendReply(socket, DsServerMsg::SERVER_ERROR,
-		      errMsg, statusString, commTimeoutMsecs);
+    sendReply(socket, DsServerMsg::SERVER_ERROR,
+              errMsg, statusString, commTimeoutMsecs);
 
     // wait up to 10 secs for client to close socket
     // Disabled because it breaks the operation of the tunnel - Mike
     // socket->readSelect(commTimeoutMsecs);
 
-    // Indicate that the client is done
-    server->clientDone();
-    return NULL;
+    return -1;
 
   }
   
-  if (server->_isVerbose) {
+  if (_isVerbose) {
     cerr << "Client handler thread performed successful read." << endl;
   }
 
@@ -987,7 +1060,7 @@ void * DsProcessServer::__serveClient(void * svrsockstruct)
   const void * data = socket->getData();
   size_t dataSize = socket->getNumBytes();
   
-  if (server->_isVerbose) {
+  if (_isVerbose) {
     cerr << "  Client handler thread Read " << dataSize << " Bytes." << endl;
     cerr << "  Client handler thread decoding message..." << endl;
   }
@@ -999,21 +1072,19 @@ void * DsProcessServer::__serveClient(void * svrsockstruct)
     string errMsg  = "Error: Message from client could not be decoded. ";
     errMsg += "Either the message is too small, or it has an ";
     errMsg += "invalid category.";
-    if (server->_isDebug) {
+    if (_isDebug) {
       cerr << errMsg << endl;
     }
     // Send error reply to client.
     string statusString;
-    server->sendReply(socket, DsServerMsg::BAD_MESSAGE,
-		      errMsg, statusString, commTimeoutMsecs);
+    sendReply(socket, DsServerMsg::BAD_MESSAGE,
+              errMsg, statusString, commTimeoutMsecs);
 
     // wait up to 10 secs for client to close socket
     // Disabled because it breaks the operation of the tunnel - Mike
     // socket->readSelect(10000);
 
-    // Indicate that the client is done
-    server->clientDone();
-    return NULL;
+    return -1;
   }
 
   // Determine if this is a server command or a task request.
@@ -1021,11 +1092,17 @@ void * DsProcessServer::__serveClient(void * svrsockstruct)
   DsServerMsg::category_t category = msg.getMessageCat();
   if (category == DsServerMsg::ServerStatus) {
 
-    success = server->handleServerCommand(socket, data, dataSize);
+    if (msg.getType() == DsServerMsg::KEEP_ALIVE) {
+      // handled here, so that subclasses which override
+      // handleServerCommand() need not know about it
+      return handleKeepAlive(socket, keepAlive, commTimeoutMsecs);
+    }
+
+    success = handleServerCommand(socket, data, dataSize);
 
   } else {
     
-    success = server->handleDataCommand(socket, data, dataSize);
+    success = handleDataCommand(socket, data, dataSize);
 
   }
  
@@ -1044,34 +1121,86 @@ void * DsProcessServer::__serveClient(void * svrsockstruct)
     // 
     // Note that the subclass is not intended to ever return an error.
     // 
-    string newError  = "Error in DsProcessServer::__serveClient: ";
+    string newError  = "Error in DsProcessServer::serveRequest: ";
     newError += "Could not handle message.\n";
     newError += DateTime::str();
     cerr << newError << endl;
  
-    // Remove this thread from the client count.
-    server->clientDone();
-
     // Exit if this is a debug server.
     // 
-    if (server->_isDebug) {
+    if (_isDebug) {
       // Todo: Wait for all the threads to end?
       //       To make this work, need to block new clients.
 
-      server->exitMethod();
-      cerr << " DsProcessServer::__serveClient" << endl;
+      clientDone();
+      exitMethod();
+      cerr << " DsProcessServer::serveRequest" << endl;
       cerr << "  " << DateTime::str() << endl;
       cerr << "  Exiting because debug server" << endl;
       exit(1);
     }
 
-    return NULL;
+    return -1;
   }
     
-  // Notify the server this thread is finished.
-  server->clientDone();
+  return 0;
 
-  // Done with the thread. Exit cleanly.
-  return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////
+// handleKeepAlive()
+// 
+// Reply to a KEEP_ALIVE command from the client.
+//
+// The reply carries the idle time, in secs, for which the server
+//   will keep the connection open between requests. If keep-alive
+//   is refused the reply has the NOT_SUPPORTED error set, and the
+//   connection is closed after the reply.
+//
+// Keep-alive is refused in no-thread debug mode, since the boss
+//   would block on the idle connection.
+//
+// Threads: Called by Worker threads.
+// 
+// Returns 0 on success, -1 on failure.
+
+int DsProcessServer::handleKeepAlive(Socket * socket, bool &keepAlive,
+                                     int wait_msecs)
+
+{
+
+  DsServerMsg msg;
+  msg.setCategory(DsServerMsg::ServerStatus);
+  msg.setType(DsServerMsg::KEEP_ALIVE);
+  if (_keepAliveSecs > 0 && !_isNoThreadDebug) {
+    msg.addInt(_keepAliveSecs);
+    keepAlive = true;
+    // replies are written as a header then a body, so disable
+    // Nagle to avoid delayed-ack stalls on the persistent connection
+    int nodelay = 1;
+    setsockopt(socket->getSd(), IPPROTO_TCP, TCP_NODELAY,
+               (char *) &nodelay, sizeof(nodelay));
+  } else {
+    msg.setErr(DsServerMsg::NOT_SUPPORTED);
+    keepAlive = false;
+  }
+  void * msgToSend = msg.assemble();
+  ssize_t msgLen = msg.lengthAssembled();
+  
+  if (socket->writeMessage(0, msgToSend, msgLen, wait_msecs)) {
+    if (_isDebug) {
+      cerr << "Error in DsProcessServer::handleKeepAlive(): "
+           << "Could not send reply message: "
+           << socket->getErrString() << endl;
+    }
+    keepAlive = false;
+    return -1;
+  }
+
+  if (_isVerbose) {
+    cerr << "Client handler keep-alive: " << (keepAlive ? "Y" : "N") << endl;
+  }
+
+  return 0;
 
 }
@@ -38,6 +38,11 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <cerrno>
+#include <cstring>
+#if defined(__linux)
+#include <sys/epoll.h>
+#endif
 using namespace std;
 
 //////////////////////////////////////////////////////////////////////////
@@ -60,7 +65,11 @@ DsThreadedServer::DsThreadedServer(const string & executableName,
 				   bool isRdOnly /* = false */) :
   DsProcessServer(executableName, instanceName, port,
 		  maxQuiescentSecs, maxClients,
-		  isDebug, isVerbose, isSecure, isRdOnly)
+		  isDebug, isVerbose, isSecure, isRdOnly),
+  _nWorkers(0),
+  _poolStarted(false),
+  _poolDone(false),
+  _epollFd(-1)
 
 {
 
@@ -68,15 +77,66 @@ DsThreadedServer::DsThreadedServer(const string & executableName,
     pthread_mutex_init(&_threadStatusMutex, NULL);
     pthread_mutex_init(&_procmapInfoMutex, NULL);
   }
+  pthread_mutex_init(&_poolMutex, NULL);
+  pthread_cond_init(&_poolCond, NULL);
 
 }
 
 // Destructor.
-//   Uses the base class
+//   Stops the worker pool if it is running.
 //
 DsThreadedServer::~DsThreadedServer()
 {
 
+  if (!_poolStarted) {
+    return;
+  }
+
+  pthread_mutex_lock(&_poolMutex);
+  _poolDone = true;
+  pthread_cond_broadcast(&_poolCond);
+  pthread_mutex_unlock(&_poolMutex);
+
+  pthread_join(_reactorThread, NULL);
+  for (size_t ii = 0; ii < _workerThreads.size(); ii++) {
+    pthread_join(_workerThreads[ii], NULL);
+  }
+
+  for (size_t ii = 0; ii < _readyConns.size(); ii++) {
+    delete _readyConns[ii].socket;
+  }
+  _readyConns.clear();
+  map<int, PoolConn>::iterator it;
+  for (it = _idleConns.begin(); it != _idleConns.end(); it++) {
+    delete it->second.socket;
+  }
+  _idleConns.clear();
+
+  if (_epollFd >= 0) {
+    close(_epollFd);
+  }
+
+}
+
+///////////////////////////////////////////////////
+// setWorkerPool()
+//
+// Use a fixed pool of nWorkers threads to serve requests,
+// instead of a thread per client.
+
+void DsThreadedServer::setWorkerPool(int nWorkers)
+
+{
+
+#if defined(__linux)
+  _nWorkers = nWorkers;
+#else
+  if (nWorkers > 0) {
+    cerr << "WARNING - DsThreadedServer::setWorkerPool" << endl;
+    cerr << "  epoll not available, using a thread per client" << endl;
+  }
+#endif
+
 }
 
 ///////////////////////////////////////////////////
@@ -90,6 +150,39 @@ void DsThreadedServer::spawn(ServerSocketStruct * sss, Socket * socket)
 
 {
   
+  // start the worker pool on the first client, falling back
+  // to a thread per client if that fails
+
+  if (_nWorkers > 0 && !_poolStarted && _startPool()) {
+    cerr << "WARNING - DsThreadedServer::spawn()" << endl;
+    cerr << "  Could not start worker pool: " << _errString << endl;
+    cerr << "  Using a thread per client" << endl;
+    _nWorkers = 0;
+  }
+
+  if (_nWorkers > 0) {
+
+    // Hand the connection to the worker pool. The struct is not
+    // needed since the workers are members of this object.
+
+    delete sss;
+
+    pthread_mutex_lock(&_threadStatusMutex);
+    _numClients++;
+    pthread_mutex_unlock(&_threadStatusMutex);
+
+    // watch for the first request
+
+    PoolConn conn;
+    conn.socket = socket;
+    conn.keepAlive = false;
+    conn.lastActive = time(NULL);
+    conn.idleSecs = DS_DEFAULT_COMM_TIMEOUT_MSECS / 1000;
+    _watchConn(conn);
+    return;
+
+  }
+
   // Start a thread.
   
   pthread_mutex_lock(&_threadStatusMutex);
@@ -398,3 +491,250 @@ void DsThreadedServer::purgeCompletedThreads()
 
 }
 
+
+////////////////////////////////////////////////////////////////
+// Start the worker pool - the reactor thread and the workers.
+//
+// Called by the Boss thread on the first client.
+//
+// Returns 0 on success, -1 on failure.
+
+int DsThreadedServer::_startPool()
+
+{
+
+#if defined(__linux)
+
+  _epollFd = epoll_create(1024);
+  if (_epollFd < 0) {
+    _errString = "epoll_create failed: ";
+    _errString += strerror(errno);
+    return -1;
+  }
+
+  int err = pthread_create(&_reactorThread, NULL, __poolReactor, this);
+  if (err != 0) {
+    _errString = "Cannot create reactor thread: ";
+    _errString += strerror(err);
+    close(_epollFd);
+    _epollFd = -1;
+    return -1;
+  }
+  _poolStarted = true;
+
+  for (int ii = 0; ii < _nWorkers; ii++) {
+    pthread_t thread;
+    err = pthread_create(&thread, NULL, __poolWorker, this);
+    if (err != 0) {
+      cerr << "WARNING - DsThreadedServer::_startPool" << endl;
+      cerr << "  Cannot create worker thread: " << strerror(err) << endl;
+      break;
+    }
+    _workerThreads.push_back(thread);
+  }
+  if (_workerThreads.size() == 0) {
+    _errString = "Cannot create any worker threads";
+    return -1;
+  }
+
+  if (_isDebug) {
+    cerr << "DsThreadedServer started worker pool, nWorkers: "
+         << _workerThreads.size() << endl;
+  }
+
+  return 0;
+
+#else
+
+  _errString = "epoll not available";
+  return -1;
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////
+// Hand a connection to the reactor, to watch for the next request.
+
+void DsThreadedServer::_watchConn(const PoolConn &conn)
+
+{
+
+#if defined(__linux)
+
+  int sd = conn.socket->getSd();
+  pthread_mutex_lock(&_poolMutex);
+  _idleConns[sd] = conn;
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.fd = sd;
+  if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, sd, &event)) {
+    int errNum = errno;
+    _idleConns.erase(sd);
+    pthread_mutex_unlock(&_poolMutex);
+    if (_isDebug) {
+      cerr << "ERROR - DsThreadedServer::_watchConn" << endl;
+      cerr << "  epoll_ctl failed: " << strerror(errNum) << endl;
+    }
+    _closeConn(conn);
+    return;
+  }
+  pthread_mutex_unlock(&_poolMutex);
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////
+// Close a connection and update the client count.
+
+void DsThreadedServer::_closeConn(const PoolConn &conn)
+
+{
+
+  // deleting the socket closes it, which also removes it from epoll
+  delete conn.socket;
+
+  pthread_mutex_lock(&_threadStatusMutex);
+  _numClients--;
+  _lastActionTime = time(NULL);
+  pthread_mutex_unlock(&_threadStatusMutex);
+
+}
+
+////////////////////////////////////////////////////////////////
+// Reactor thread.
+//
+// Waits on the connections in _idleConns. When a connection becomes
+// readable, it is moved to _readyConns for a worker to serve.
+// Connections idle for longer than their idle time are closed.
+
+void DsThreadedServer::_runReactor()
+
+{
+
+#if defined(__linux)
+
+  const int maxEvents = 64;
+  struct epoll_event events[maxEvents];
+  time_t lastCheck = time(NULL);
+
+  while (true) {
+
+    int nReady = epoll_wait(_epollFd, events, maxEvents, 1000);
+    if (nReady < 0 && errno != EINTR) {
+      cerr << "ERROR - DsThreadedServer::_runReactor" << endl;
+      cerr << "  epoll_wait failed: " << strerror(errno) << endl;
+      umsleep(1000);
+    }
+
+    pthread_mutex_lock(&_poolMutex);
+
+    if (_poolDone) {
+      pthread_mutex_unlock(&_poolMutex);
+      break;
+    }
+
+    // move ready connections to the ready queue
+
+    for (int ii = 0; ii < nReady; ii++) {
+      int sd = events[ii].data.fd;
+      map<int, PoolConn>::iterator it = _idleConns.find(sd);
+      if (it == _idleConns.end()) {
+        continue;
+      }
+      epoll_ctl(_epollFd, EPOLL_CTL_DEL, sd, NULL);
+      _readyConns.push_back(it->second);
+      _idleConns.erase(it);
+    }
+    if (nReady > 0) {
+      pthread_cond_broadcast(&_poolCond);
+    }
+
+    // once per second, find connections which have been idle too long
+
+    vector<PoolConn> expired;
+    time_t now = time(NULL);
+    if (now != lastCheck) {
+      lastCheck = now;
+      map<int, PoolConn>::iterator it = _idleConns.begin();
+      while (it != _idleConns.end()) {
+        if (now - it->second.lastActive > it->second.idleSecs) {
+          epoll_ctl(_epollFd, EPOLL_CTL_DEL, it->first, NULL);
+          expired.push_back(it->second);
+          _idleConns.erase(it++);
+        } else {
+          it++;
+        }
+      }
+    }
+
+    pthread_mutex_unlock(&_poolMutex);
+
+    for (size_t ii = 0; ii < expired.size(); ii++) {
+      if (_isVerbose) {
+        cerr << "Worker pool closing idle connection." << endl;
+      }
+      _closeConn(expired[ii]);
+    }
+
+  } // while
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////
+// Worker thread.
+//
+// Serves one request at a time from _readyConns. Keep-alive
+// connections are handed back to the reactor afterwards, others
+// are closed.
+
+void DsThreadedServer::_runWorker()
+
+{
+
+  while (true) {
+
+    pthread_mutex_lock(&_poolMutex);
+    while (_readyConns.empty() && !_poolDone) {
+      pthread_cond_wait(&_poolCond, &_poolMutex);
+    }
+    if (_poolDone) {
+      pthread_mutex_unlock(&_poolMutex);
+      break;
+    }
+    PoolConn conn = _readyConns.front();
+    _readyConns.pop_front();
+    pthread_mutex_unlock(&_poolMutex);
+
+    if (serveRequest(conn.socket, conn.keepAlive) == 0 && conn.keepAlive) {
+      conn.lastActive = time(NULL);
+      conn.idleSecs = _keepAliveSecs;
+      _watchConn(conn);
+    } else {
+      _closeConn(conn);
+    }
+
+  } // while
+
+}
+
+////////////////////////////////////////////////////////////////
+// Thread start functions for the worker pool
+
+void *DsThreadedServer::__poolReactor(void *server)
+
+{
+  ((DsThreadedServer *) server)->_runReactor();
+  return NULL;
+}
+
+void *DsThreadedServer::__poolWorker(void *server)
+
+{
+  ((DsThreadedServer *) server)->_runWorker();
+  return NULL;
+}
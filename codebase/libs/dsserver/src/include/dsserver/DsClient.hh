@@ -38,6 +38,11 @@
 
 #include <didss/DsURL.hh>
 #include <toolsa/ThreadSocket.hh>
+#include <pthread.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 using namespace std;
 
 class DsClient {
@@ -71,8 +76,8 @@ public:
   
   // get data after successful comm call
 
-  const void *getReplyBuf() { return _sock.getData(); }
-  ssize_t getReplyLen() { return _sock.getNumBytes(); }
+  const void *getReplyBuf() { return _replySock()->getData(); }
+  ssize_t getReplyLen() { return _replySock()->getNumBytes(); }
 
   // Request the DsServerMgr to start the server for this URL
   //
@@ -97,6 +102,20 @@ public:
 
   void setOpenTimeoutMsecs(int msecs) { _openTimeoutMsecs = msecs; }
 
+  // set keep-alive
+  //
+  // If true, the client negotiates keep-alive with the server,
+  // and the connection is kept in a process-level pool after the
+  // reply is read, so that later requests to the same host and port
+  // reuse it instead of connecting again. Servers which do not
+  // support keep-alive are remembered, and used one-shot.
+  // Not used when forwarding through a proxy or tunnel.
+  //
+  // Defaults to false, or true if DS_KEEP_ALIVE is set to TRUE in
+  // the environment.
+
+  void setKeepAlive(bool state) { _keepAlive = state; }
+
   // clear/set/get the Error String.
   // This has contents when an error is returned.
   
@@ -111,9 +130,47 @@ protected:
   ThreadSocket _sock;
   mutable string _errStr;
   int _openTimeoutMsecs;
-  
+
+  // keep-alive - the connection in use is checked out of the pool,
+  // and returned to it when the client is done with the reply
+
+  bool _keepAlive;
+  ThreadSocket *_keptSock;
+  string _keptKey;
+  int _keptSecs;
+
+  // process-level pool of idle keep-alive connections, keyed on
+  // host:port, and set of servers which refused keep-alive
+
+  class KeptConn {
+  public:
+    ThreadSocket *sock;
+    time_t lastUsed;
+    int keepAliveSecs;
+  };
+
+  static map<string, vector<KeptConn> > _keptConns;
+  static set<string> _noKeepAlive;
+  static pthread_mutex_t _keptMutex;
+  static const size_t _maxKeptPerServer = 4;
+
+  ThreadSocket *_replySock() {
+    return (_keptSock != NULL ? _keptSock : &_sock);
+  }
+
   void _closeSocket();
 
+  int _communicateKeepAlive(const DsURL &url, int msgType,
+                            const void *msgBuf, ssize_t msgLen,
+                            int commTimeoutMsecs,
+                            bool reuseConn = true);
+  int _waitForReply(ThreadSocket *sock, int commTimeoutMsecs);
+
+  ThreadSocket *_checkOutKeptConn(const string &key, int &keepAliveSecs);
+  void _releaseKeptConn();
+  int _negotiateKeepAlive(ThreadSocket *sock, int commTimeoutMsecs,
+                          int &keepAliveSecs);
+
   int _communicateNoFwd(const DsURL &url, int msgType,
 			const void *msgBuf, ssize_t msgLen,
 			int commTimeoutMsecs);
@@ -164,6 +164,17 @@ public:
   void setNoThreadDebug(bool isNoThread) { _isNoThreadDebug = isNoThread; }
   bool isNoThreadDebug() const { return _isNoThreadDebug; }
 
+  // Set the keep-alive idle time, in secs.
+  //   Clients may send a KEEP_ALIVE server command to ask that the
+  //   connection be kept open, and then send further requests on it.
+  //   The connection is closed if the client is idle for longer
+  //   than this. Set to 0 to refuse keep-alive.
+  //   Defaults to DS_DEFAULT_KEEP_ALIVE_SECS, or DS_KEEP_ALIVE_SECS
+  //   from the environment.
+  // 
+  void setKeepAliveSecs(int secs) { _keepAliveSecs = secs; }
+  int getKeepAliveSecs() const { return _keepAliveSecs; }
+
   // Block and wait for clients.
   //   If a positive timeoutMSecs is provided, the wait times out,
   //     PMU registration is performed, and timeoutMethod() is called.
@@ -317,6 +328,12 @@ protected:
   // Threads: should only be set in main thread
   time_t _lastPrint;
 
+  // Idle secs for keep-alive connections, 0 if refused.
+  // 
+  // Threads: Should only be set before waitForClients().
+  // 
+  int _keepAliveSecs;
+
   ////////////////////////////////////////////////////////////
   // ACCESS FUNCTIONS FOR DATA MEMBERS
 
@@ -504,6 +521,28 @@ protected:
 		DsServerMsg::msgErr errCode, const string & errMsg,
 		string & errString, int wait_msecs = 10000);
   
+  // Read a single request from the client, and handle it.
+  //
+  // keepAlive is set true if the client negotiates keep-alive.
+  //   If it is already true, a failed read is taken to mean that
+  //   the client has closed the connection, and no reply is sent.
+  //
+  // Threads: Called by Worker threads.
+  // 
+  // Returns 0 if the connection may be used for further requests,
+  //        -1 if it should be closed.
+  
+  int serveRequest(Socket * socket, bool &keepAlive);
+
+  // Reply to a KEEP_ALIVE command from the client.
+  //
+  // Threads: Called by Worker threads.
+  // 
+  // Returns 0 on success, -1 on failure.
+  
+  int handleKeepAlive(Socket * socket, bool &keepAlive,
+                      int wait_msecs);
+
   // Static function for servicing request.
   // This is called by the child or thread created for servicing the request.
 
@@ -41,6 +41,7 @@ using namespace std;
 
 #define DS_DEFAULT_PING_TIMEOUT_MSECS 10000
 #define DS_DEFAULT_COMM_TIMEOUT_MSECS 30000
+#define DS_DEFAULT_KEEP_ALIVE_SECS 10
 
 //////////////////////////////
 // forward class declarations
@@ -132,7 +133,12 @@ public:
     GET_NUM_SERVERS,       // Returns integer.
     GET_SERVER_INFO,       // Returns int and formatted string, list of servers.
     GET_FAILURE_INFO,      // Returns int and formatted string, failure list.
-    GET_DENIED_SERVICES    // Returns int and formatted string, executable list.
+    GET_DENIED_SERVICES,   // Returns int and formatted string, executable list.
+
+    // Connection commands.
+    KEEP_ALIVE             // Returns int, idle secs the server will keep
+                           // the connection open between requests.
+                           // Returns NOT_SUPPORTED if not available.
   };
 
   //////////////
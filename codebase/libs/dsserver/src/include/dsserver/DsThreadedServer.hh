@@ -30,6 +30,9 @@
 #include <string>
 #include <pthread.h>
 #include <list>
+#include <deque>
+#include <map>
+#include <vector>
 
 class Socket;
 class ServerSocket;
@@ -93,6 +96,11 @@ using namespace std;
 //    o Constructor takes arguments such as port number, and max quiescent
 //        secs, to support DIDSS server executables which must take -port
 //        and -qmax args.
+//    o A fixed pool of Worker threads may be used instead of a thread
+//        per client, by calling setWorkerPool() before waitForClients().
+//        Connections are then watched by a reactor thread using epoll,
+//        and handed to a Worker only when a request is ready to be read.
+//        Idle keep-alive connections do not tie up a Worker.
 // 
 //   Subclassing notes:
 //    In general, when subclasses define special virtual methods such as 
@@ -169,6 +177,16 @@ public:
     bool done;
   };
 
+  // class for keeping state of connections served by the worker pool
+
+  class PoolConn {
+  public:
+    Socket * socket;
+    bool keepAlive;
+    time_t lastActive;
+    int idleSecs;
+  };
+
   // Constructor:
   //   o Registers with procmap
   //   o Opens socket on specified port
@@ -192,6 +210,15 @@ public:
   // 
   virtual ~DsThreadedServer();
     
+  // Use a fixed pool of nWorkers threads to serve requests,
+  //   instead of a thread per client.
+  //   Must be called before waitForClients().
+  //   Has no effect if nWorkers is not positive, or if epoll is
+  //   not available on this platform.
+  // 
+  void setWorkerPool(int nWorkers);
+  int getNWorkers() const { return _nWorkers; }
+
 protected:
 
   /////////////////////////////////////////////////////////
@@ -295,6 +322,31 @@ protected:
   // list of active threads - used for deciding when to join
   list<ThreadStatus> _threadStatus;
   
+  // worker pool, if _nWorkers > 0
+  //   _readyConns: connections with a request ready to be read
+  //   _idleConns: connections being watched by the reactor, keyed on fd
+  // Both are protected by _poolMutex.
+
+  int _nWorkers;
+  bool _poolStarted;
+  bool _poolDone;
+  int _epollFd;
+  pthread_t _reactorThread;
+  vector<pthread_t> _workerThreads;
+  pthread_mutex_t _poolMutex;
+  pthread_cond_t _poolCond;
+  deque<PoolConn> _readyConns;
+  map<int, PoolConn> _idleConns;
+
+  int _startPool();
+  void _watchConn(const PoolConn &conn);
+  void _closeConn(const PoolConn &conn);
+  void _runReactor();
+  void _runWorker();
+
+  static void *__poolReactor(void *server);
+  static void *__poolWorker(void *server);
+
 private:
   // Private methods with no bodies. DO NOT USE!
   // 
@@ -28,6 +28,7 @@
 #include <vector>
 #include <euclid/Grid2dClump.hh>
 #include <euclid/PointList.hh>
+#include <euclid/ParallelClumping.hh>
 #include <toolsa/LogStream.hh>
 using std::vector;
 using std::pair;
@@ -37,6 +38,7 @@ Grid2dClump::Grid2dClump(const Grid2d &g) : Grid2d(g), _iwork(g)
 {
   _nx = g.getNx();
   _ny = g.getNy();
+  _nThreads = 1;
   _iwork.setAllToValue(NO_MARKER);
   for (int i=0; i<_nx*_ny; ++i)
   {
@@ -54,6 +56,7 @@ Grid2dClump::Grid2dClump(const Grid2d &g, const double bad) : Grid2d(g),
 {
   _nx = g.getNx();
   _ny = g.getNy();
+  _nThreads = 1;
   _iwork.setAllToValue(NO_MARKER);
   for (int i=0; i<_nx*_ny; ++i)
   {
@@ -81,50 +84,22 @@ Grid2dClump::~Grid2dClump()
 //----------------------------------------------------------------
 std::vector<clump::Region_t> Grid2dClump::buildRegions(void)
 {
-  int x, y;
-  clump::Region_t l;
   vector<clump::Region_t> ret;
-
-  for (y=0; y<_ny; ++y)
-  {
-    for (x=0; x<_nx; ++x)
-    {
-      if (_iwork(x,y) == PROCESSED)
-      {
-	continue;
-      }
-      _buildRegion(x, y);
-      if (!_n.empty())
-      {
-	ret.push_back(_n);
-      }
-    }
-  }
+  _buildAllRegions(ret);
   return ret;
 }
 
 //----------------------------------------------------------------
 std::vector<PointList> Grid2dClump::buildRegionPointlists(void)
 {
-  int x, y;
-  clump::Region_t l;
-  vector<PointList> ret;
+  vector<clump::Region_t> regions;
+  _buildAllRegions(regions);
 
-  for (y=0; y<_ny; ++y)
+  vector<PointList> ret;
+  for (size_t i=0; i<regions.size(); ++i)
   {
-    for (x=0; x<_nx; ++x)
-    {
-      if (_iwork(x,y) == PROCESSED)
-      {
-	continue;
-      }
-      _buildRegion(x, y);
-      if (!_n.empty())
-      {
-	PointList P(_nx, _ny, _n);
-	ret.push_back(P);
-      }
-    }
+    PointList P(_nx, _ny, regions[i]);
+    ret.push_back(P);
   }
   return ret;
 }
@@ -156,32 +131,78 @@ vector<clump::Region_t> Grid2dClump::buildRegionsRecursive(void)
 }
 
 //----------------------------------------------------------------
-void Grid2dClump::_buildRegion(int ix, int iy)
+void Grid2dClump::_buildAllRegions(vector<clump::Region_t> &regions)
 {
-  _n.clear();
-  
-  while (true)
+  regions.clear();
+
+  // the runs of unprocessed points in each row
+  vector<Interval> intervals;
+  vector<int> rowStart(_ny + 1);
+  for (int y=0; y<_ny; ++y)
   {
-    bool done;
-    _iwork(ix, iy) = THISCLUMP_NOTDONE;
-    pair<int, int> p = _growNonrecursive(ix, iy, done);
-    if (done)
+    rowStart[y] = static_cast<int>(intervals.size());
+    int x = 0;
+    while (x < _nx)
     {
-      pair<int, int> p2 = _findNondone(done);
-      if (done)
+      if (_iwork(x, y) == PROCESSED)
+      {
+	++x;
+	continue;
+      }
+      Interval intv;
+      intv.id = NULL_ID;
+      intv.plane = 0;
+      intv.row_in_vol = y;
+      intv.row_in_plane = y;
+      intv.begin = x;
+      while (x < _nx && _iwork(x, y) != PROCESSED)
       {
-	break;
+	++x;
       }
-      ix = p2.first;
-      iy = p2.second;
+      intv.end = x - 1;
+      intv.len = intv.end - intv.begin + 1;
+      intervals.push_back(intv);
     }
-    else
+  }
+  rowStart[_ny] = static_cast<int>(intervals.size());
+  if (intervals.empty())
+  {
+    return;
+  }
+
+  vector<Row_hdr> rowh(_ny);
+  for (int y=0; y<_ny; ++y)
+  {
+    rowh[y].size = rowStart[y+1] - rowStart[y];
+    rowh[y].intervals = &intervals[0] + rowStart[y];
+  }
+
+  // 8-connected regions are runs that touch, including diagonally,
+  // which is a minimum overlap of 0
+  vector<Interval *> intervalOrder(intervals.size() + 1);
+  vector<Clump_order> clumps(intervals.size() + 1);
+  ParallelClumping clumping;
+  clumping.setNThreads(_nThreads);
+  clumping.setConnectivity(ParallelClumping::CONNECT_2D);
+  int nClumps = clumping.performClumping(&rowh[0], _ny, 1, 0,
+					 &intervalOrder[0], &clumps[0]);
+
+  // load up the points in row order, and mark them done
+  regions.resize(nClumps);
+  for (int i=0; i<nClumps; ++i)
+  {
+    regions[i].reserve(clumps[i+1].pts);
+  }
+  for (size_t i=0; i<intervals.size(); ++i)
+  {
+    const Interval &intv = intervals[i];
+    clump::Region_t &region = regions[intv.id - 1];
+    for (int x=intv.begin; x<=intv.end; ++x)
     {
-      ix = p.first;
-      iy = p.second;
+      region.push_back(pair<int, int>(x, intv.row_in_vol));
+      _iwork(x, intv.row_in_vol) = PROCESSED;
     }
   }
-  _buildN();
 }
 
 //----------------------------------------------------------------
@@ -219,52 +240,6 @@ void Grid2dClump::_growRecursive(int x, int y)
   }
 }
 
-//----------------------------------------------------------------
-pair<int,int> Grid2dClump::_growNonrecursive(int x, int y, bool &done)
-{
-  int ix, iy;
-  int ix_ret, iy_ret;
-  bool did_grow = false;
-
-  // make sure input point is set properly.
-  if (_iwork(x, y) != THISCLUMP_NOTDONE)
-  {
-    LOG(WARNING) << "in clump";
-  }
-  
-  // by the time through here, it'll be done.
-  _iwork(x, y) = THISCLUMP_DONE;
-
-  // Recursively add neighboring points and set one for return 
-  for ( iy=y-1; iy<=y+1; ++iy )
-  {
-    for ( ix=x-1; ix<=x+1; ++ix )
-    {
-      if (!_growOkNonrecursive(ix, iy, x, y))
-      {
-	continue;
-      }
-      _iwork(ix, iy) = THISCLUMP_NOTDONE;
-      ix_ret = ix;
-      iy_ret = iy;
-      did_grow = true;
-    }
-  }
-
-  if (did_grow)
-  {
-    pair<int, int> p(ix_ret, iy_ret);
-    done = false;
-    return p;
-  }
-  else
-  {
-    done = true;
-    pair<int, int> p(0,0);
-    return p;
-  }
-}
-
 //----------------------------------------------------------------
 void Grid2dClump::_buildN(void)
 {
@@ -289,27 +264,6 @@ void Grid2dClump::_buildN(void)
   }
 }
 
-//----------------------------------------------------------------
-pair<int, int> Grid2dClump::_findNondone(bool &done) const
-{
-  int x, y;
-  for (y=0; y<_ny; ++y)
-  {
-    for (x=0; x<_nx; ++x)
-    {
-      if (_iwork(x, y) == THISCLUMP_NOTDONE)
-      {
-	pair<int, int> p(x, y);
-	done = false;
-	return p;
-      }
-    }
-  }
-  pair<int, int> p(0,0);
-  done = true;
-  return p;
-}
-
 //----------------------------------------------------------------
 bool Grid2dClump::_growOk(int ix, int iy, int x, int y) const
   {
@@ -334,32 +288,3 @@ bool Grid2dClump::_growOk(int ix, int iy, int x, int y) const
     }
     return(true); 
   }
-
-//----------------------------------------------------------------
-bool Grid2dClump::_growOkNonrecursive(int ix, int iy, int x, int y) const
-{
-  // The point has been dealt with (just added)
-  if ( ix == x && iy == y )
-  {
-    return(false);
-  }
-  // Out of range of the data
-  if ( ix < 0 || ix >= _nx)
-  {
-    return(false);
-  }
-  if ( iy < 0 || iy >= _ny)
-  {
-    return(false);
-  }
-
-  // Previously dealt with
-  if (_iwork(ix, iy) == PROCESSED || _iwork(ix, iy) == THISCLUMP_DONE)
-  {
-    return false;
-  }
-
-  // here either NO_MARKER or THISCLUMP_NOTDONE.
-  return(true); 
-}
-
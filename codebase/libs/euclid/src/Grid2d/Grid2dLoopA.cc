@@ -35,7 +35,7 @@ using std::string;
 
 //----------------------------------------------------------------
 Grid2dLoopA::Grid2dLoopA(int nx, int ny, int sx, int sy) : _nx(nx), _ny(ny),
-  _sx(sx), _sy(sy)
+  _x0(0), _x1(nx-1), _sx(sx), _sy(sy)
 {
   if (_nx < 2 || _ny < 2)
   {
@@ -44,13 +44,34 @@ Grid2dLoopA::Grid2dLoopA(int nx, int ny, int sx, int sy) : _nx(nx), _ny(ny),
   }
 
   // lower left, initial state
-  _x = 0;
-  _y = 0;
-  _minx = _x - _sx;
-  _miny = _y - _sy;
-  _maxx = _x + _sx;
-  _maxy = _y + _sy;
-  _state = INIT;
+  reinit();
+}
+
+//----------------------------------------------------------------
+Grid2dLoopA::Grid2dLoopA(int nx, int ny, int sx, int sy, int x0, int x1) :
+  _nx(nx), _ny(ny), _x0(x0), _x1(x1), _sx(sx), _sy(sy)
+{
+  if (_nx < 2 || _ny < 2)
+  {
+    LOG(FATAL) << "too few x,y " << nx << " " << ny;
+    exit(1);
+  }
+  if (_x0 < 0)
+  {
+    _x0 = 0;
+  }
+  if (_x1 > _nx-1)
+  {
+    _x1 = _nx-1;
+  }
+  if (_x0 > _x1)
+  {
+    LOG(FATAL) << "bad strip " << x0 << " " << x1;
+    exit(1);
+  }
+
+  // lower left of strip, initial state
+  reinit();
 }
 
 //----------------------------------------------------------------
@@ -62,7 +83,7 @@ Grid2dLoopA::~Grid2dLoopA()
 void Grid2dLoopA::reinit(void)
 {
   // lower left
-  _x = 0;
+  _x = _x0;
   _y = 0;
   _minx = _x - _sx;
   _miny = _y - _sy;
@@ -113,7 +134,7 @@ bool Grid2dLoopA::increment(const Grid2d &G, Grid2dLoopAlg &alg)
     }
     else
     {
-      if (++_x >= _nx)
+      if (++_x > _x1)
       {
 	// upper right will be last point depending on nx
 	return false;
@@ -138,7 +159,7 @@ bool Grid2dLoopA::increment(const Grid2d &G, Grid2dLoopAlg &alg)
     }
     else
     {
-      if (++_x >= _nx)
+      if (++_x > _x1)
       {
 	// lower right will be last point depending on nx
 	return false;
@@ -242,6 +242,82 @@ static double _medianInBox(Grid2d &data, int x0, int y0, int nx, int ny,
 }
 
 
+//----------------------------------------------------------------
+// number of rows in each band for the banded box filters, which
+// limits the size of the working arrays
+static const int _bandRows = 128;
+
+//----------------------------------------------------------------
+// running sums and counts of non-missing data over a window of
+// half width r, centered at each point of a line of data
+static void _runningSum(const double *data, int n, int r, double missing,
+			double *sum, double *count)
+{
+  double s = 0.0, c = 0.0;
+  for (int i=0; i<=r && i<n; ++i)
+  {
+    if (data[i] != missing)
+    {
+      s += data[i];
+      c++;
+    }
+  }
+  for (int i=0; i<n; ++i)
+  {
+    sum[i] = s;
+    count[i] = c;
+    int iadd = i + r + 1;
+    if (iadd < n && data[iadd] != missing)
+    {
+      s += data[iadd];
+      c++;
+    }
+    int isub = i - r;
+    if (isub >= 0 && data[isub] != missing)
+    {
+      s -= data[isub];
+      c--;
+    }
+  }
+}
+
+//----------------------------------------------------------------
+// running max over a window of half width r, centered at each point
+// of a line of data, using the van Herk/Gil-Werman algorithm.
+// Missing data should be set to -HUGE_VAL, as should points outside
+// the line.  g and h are work arrays.
+static void _runningMax(const double *data, int n, int r, double *max,
+			std::vector<double> &g, std::vector<double> &h)
+{
+  // the line is padded by r points at each end, and divided into
+  // blocks of the window size
+  int k = 2*r + 1;
+  int np = n + 2*r;
+  int nb = ((np + k - 1)/k)*k;
+  g.resize(nb);
+  h.resize(nb);
+
+  // max from start of block, and max to end of block
+  for (int j=0; j<nb; ++j)
+  {
+    int i = j - r;
+    double v = (i >= 0 && i < n) ? data[i] : -HUGE_VAL;
+    g[j] = (j % k == 0) ? v : std::max(g[j-1], v);
+  }
+  for (int j=nb-1; j>=0; --j)
+  {
+    int i = j - r;
+    double v = (i >= 0 && i < n) ? data[i] : -HUGE_VAL;
+    h[j] = (j % k == k-1) ? v : std::max(h[j+1], v);
+  }
+
+  // each window spans at most two blocks
+  for (int i=0; i<n; ++i)
+  {
+    max[i] = std::max(h[i], g[i + 2*r]);
+  }
+}
+
 //------------------------------------------------------------------
 TaThread *GridAlgs::GridAlgThreads::clone(int index)
 {
@@ -1908,27 +1984,14 @@ double GridAlgs::localCenteredAverageNoMissing(int ix, int iy, int sx,
 //----------------------------------------------------------------
 void GridAlgs::smooth(int xw, int yw)
 {
-  // make an object to loop through the grid
-  Grid2dLoopA G(_nx, _ny, xw, yw);
-
-  // make a copy of the local object
-  GridAlgs tmp(*this);
-
-  Grid2dLoopAlgMean A;
+  _runTiles(GridAlgsInfo::BOX_MEAN_ROWS, xw, yw, xw*yw/2, 0, 0, 0, 1);
+}
 
-  while (G.increment(tmp, A))
-  {
-    int x, y;
-    double result;
-    if (G.getXyAndResult(A, xw*yw/2, x, y, result))
-    {
-      _data[y*_nx + x] = result;
-    }
-    else
-    {
-      _data[y*_nx + x] = _missing;
-    }
-  }
+//----------------------------------------------------------------
+void GridAlgs::smoothTiled(int xw, int yw, int numThread)
+{
+  _runTiles(GridAlgsInfo::BOX_MEAN_ROWS, xw, yw, xw*yw/2, 0, 0, 0,
+	    numThread);
 }
 
 
@@ -1950,19 +2013,9 @@ void GridAlgs::smoothSimple(int sx, int sy)
 //---------------------------------------------------------------------------
 void GridAlgs::smoothThreaded(int sx, int sy, int numThread)
 {
-  GridAlgThreads *thread = new GridAlgs::GridAlgThreads();
-  thread->init(numThread, false);
-
-  GridAlgs tmp(*this);
-  for (int iy=0; iy<_ny; ++iy)
-  {
-    GridAlgsInfo *info = new GridAlgsInfo(GridAlgsInfo::SMOOTH,
-					  sx, sy, iy, this, tmp);
-    thread->thread(iy, (void *)info);
-  }
-  thread->waitForThreads();
-  delete thread;
-  *this = tmp;
+  // same good data requirement as localCenteredAverage() with needHalf
+  double maxbad = static_cast<double>((sx-1)*(sy-1))/2.0;
+  _runTiles(GridAlgsInfo::BOX_MEAN_ROWS, sx, sy, maxbad, 0, 0, 0, numThread);
 }
 
 
@@ -2327,18 +2380,15 @@ bool GridAlgs::interpolate(const Grid2d &lowres, int res)
 //----------------------------------------------------------------
 void GridAlgs::dilate(int xw, int yw)
 {
-  // make a copy of the input grid..
-  GridAlgs tmp(*this);
-
   // for each point, set value to max in a xw by yw window around
   // the point
-  for (int y=0; y<_ny; y++)
-  {
-    for (int x=0; x<_nx; x++)
-    {
-      _data[y*_nx + x] = tmp._max(x, y, xw, yw);
-    }
-  }
+  _runTiles(GridAlgsInfo::BOX_MAX_ROWS, xw, yw, 0, 0, 0, 0, 1);
+}
+
+//----------------------------------------------------------------
+void GridAlgs::dilateTiled(int xw, int yw, int numThread)
+{
+  _runTiles(GridAlgsInfo::BOX_MAX_ROWS, xw, yw, 0, 0, 0, 0, numThread);
 }
 
 //----------------------------------------------------------------
@@ -2448,6 +2498,14 @@ void GridAlgs::median(int xw, int yw, double bin_min, double bin_max,
   }
 }
 
+//----------------------------------------------------------------
+void GridAlgs::medianTiled(int xw, int yw, double bin_min, double bin_max,
+			   double bin_delta, int numThread)
+{
+  _runTiles(GridAlgsInfo::MEDIAN_COLS, xw, yw, xw*yw/2, bin_min, bin_max,
+	    bin_delta, numThread);
+}
+
 //----------------------------------------------------------------
 void GridAlgs::medianNoOverlap(int xw, int yw, double bin_min, double bin_max,
 			       double bin_delta, bool allow_any_data)
@@ -2571,6 +2629,14 @@ void GridAlgs::speckle(int xw, int yw, double bin_min, double bin_max,
   }
 }
 
+//----------------------------------------------------------------
+void GridAlgs::speckleTiled(int xw, int yw, double bin_min, double bin_max,
+			    double bin_delta, int numThread)
+{
+  _runTiles(GridAlgsInfo::SPECKLE_COLS, xw, yw, xw*yw/2, bin_min, bin_max,
+	    bin_delta, numThread);
+}
+
 //----------------------------------------------------------------
 void GridAlgs::speckleInterest(int xw, int yw, double bin_min, double bin_max,
 			       double bin_delta, const FuzzyF &fuzzyDataDiff,
@@ -3799,6 +3865,30 @@ void GridAlgs::compute(void *ti)
       info->_out.setValue(ix, info->_y, v);
     }
     break;
+  case GridAlgsInfo::BOX_MEAN_ROWS:
+    info->_gridAlgs->_boxMeanRows(info->_sx, info->_sy, info->_minGood,
+				  info->_i0, info->_i1, info->_out);
+    break;
+  case GridAlgsInfo::BOX_MAX_ROWS:
+    info->_gridAlgs->_boxMaxRows(info->_sx, info->_sy,
+				 info->_i0, info->_i1, info->_out);
+    break;
+  case GridAlgsInfo::MEDIAN_COLS:
+    {
+      Grid2dLoopAlgMedian A(info->_binMin, info->_binMax, info->_binDelta);
+      info->_gridAlgs->_loopAlgColumns(A, info->_sx, info->_sy,
+				       static_cast<int>(info->_minGood),
+				       info->_i0, info->_i1, info->_out);
+    }
+    break;
+  case GridAlgsInfo::SPECKLE_COLS:
+    {
+      Grid2dLoopAlgSpeckle A(info->_binMin, info->_binMax, info->_binDelta);
+      info->_gridAlgs->_loopAlgColumns(A, info->_sx, info->_sy,
+				       static_cast<int>(info->_minGood),
+				       info->_i0, info->_i1, info->_out);
+    }
+    break;
   default:
     break;
   }
@@ -3950,6 +4040,219 @@ double GridAlgs::_max(int x, int y, int xw, int yw) const
   }
 }
 
+//----------------------------------------------------------------
+// Apply a box filter to tiles of the grid, in parallel if numThread > 1.
+// Box mean and max use bands of rows, the Grid2dLoopA algorithms use
+// strips of columns.  Each tile reads its halo directly from a copy
+// of the input grid, and writes only its own points, so the tiles
+// are independent.
+void GridAlgs::_runTiles(GridAlgsInfo::Info_t type, int sx, int sy,
+			 double minGood, double binMin, double binMax,
+			 double binDelta, int numThread)
+{
+  if (_nx <= 0 || _ny <= 0)
+  {
+    return;
+  }
+
+  // make a copy of the input grid, output goes to the local object
+  GridAlgs tmp(*this);
+
+  bool isRows = (type == GridAlgsInfo::BOX_MEAN_ROWS ||
+		 type == GridAlgsInfo::BOX_MAX_ROWS);
+  int n, nTile;
+  if (isRows)
+  {
+    n = _ny;
+    nTile = (n + _bandRows - 1)/_bandRows;
+  }
+  else
+  {
+    n = _nx;
+    nTile = 1;
+  }
+  if (numThread > 1 && nTile < numThread*4)
+  {
+    // several tiles per thread to balance the load
+    nTile = numThread*4;
+  }
+  if (nTile > n)
+  {
+    nTile = n;
+  }
+
+  GridAlgThreads *thread = NULL;
+  if (numThread > 1)
+  {
+    thread = new GridAlgs::GridAlgThreads();
+    thread->init(numThread, false);
+  }
+  for (int i=0; i<nTile; ++i)
+  {
+    int i0 = static_cast<int>((static_cast<long>(i)*n)/nTile);
+    int i1 = static_cast<int>((static_cast<long>(i+1)*n)/nTile) - 1;
+    GridAlgsInfo *info = new GridAlgsInfo(type, sx, sy, i0, i1, minGood,
+					  binMin, binMax, binDelta,
+					  &tmp, *this);
+    if (thread == NULL)
+    {
+      compute((void *)info);
+    }
+    else
+    {
+      thread->thread(i, (void *)info);
+    }
+  }
+  if (thread != NULL)
+  {
+    thread->waitForThreads();
+    delete thread;
+  }
+}
+
+//----------------------------------------------------------------
+// Box mean over rows y0 to y1, written to out.  Separable: running
+// sums along x for the band plus a halo of sy rows on each side, then
+// running sums of those along y.
+void GridAlgs::_boxMeanRows(int sx, int sy, double minGood, int y0, int y1,
+			    Grid2d &out) const
+{
+  int hy0 = std::max(0, y0 - sy);
+  int hy1 = std::min(_ny - 1, y1 + sy);
+  int nh = hy1 - hy0 + 1;
+
+  vector<double> hsum(static_cast<size_t>(nh)*_nx);
+  vector<double> hcount(static_cast<size_t>(nh)*_nx);
+  for (int y=hy0; y<=hy1; ++y)
+  {
+    size_t offset = static_cast<size_t>(y - hy0)*_nx;
+    _runningSum(&_data[static_cast<size_t>(y)*_nx], _nx, sx, _missing,
+		&hsum[offset], &hcount[offset]);
+  }
+
+  // initial box for row y0
+  vector<double> sum(_nx, 0.0), count(_nx, 0.0);
+  for (int y=hy0; y<=std::min(hy1, y0 + sy); ++y)
+  {
+    size_t offset = static_cast<size_t>(y - hy0)*_nx;
+    for (int x=0; x<_nx; ++x)
+    {
+      sum[x] += hsum[offset + x];
+      count[x] += hcount[offset + x];
+    }
+  }
+
+  for (int y=y0; y<=y1; ++y)
+  {
+    if (y > y0)
+    {
+      int yadd = y + sy;
+      if (yadd <= hy1)
+      {
+	size_t offset = static_cast<size_t>(yadd - hy0)*_nx;
+	for (int x=0; x<_nx; ++x)
+	{
+	  sum[x] += hsum[offset + x];
+	  count[x] += hcount[offset + x];
+	}
+      }
+      int ysub = y - sy - 1;
+      if (ysub >= hy0)
+      {
+	size_t offset = static_cast<size_t>(ysub - hy0)*_nx;
+	for (int x=0; x<_nx; ++x)
+	{
+	  sum[x] -= hsum[offset + x];
+	  count[x] -= hcount[offset + x];
+	}
+      }
+    }
+    for (int x=0; x<_nx; ++x)
+    {
+      if (count[x] > minGood)
+      {
+	out.setValue(x, y, sum[x]/count[x]);
+      }
+      else
+      {
+	out.setMissing(x, y);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------
+// Box max over rows y0 to y1, written to out.  Separable: running max
+// along x for the band plus a halo of sy rows on each side, then
+// running max of those along y.  Missing data is ignored, output is
+// missing if all data in the box is missing.
+void GridAlgs::_boxMaxRows(int sx, int sy, int y0, int y1, Grid2d &out) const
+{
+  int hy0 = std::max(0, y0 - sy);
+  int hy1 = std::min(_ny - 1, y1 + sy);
+  int nh = hy1 - hy0 + 1;
+
+  vector<double> g, h;
+  vector<double> line(std::max(_nx, nh));
+  vector<double> hmax(static_cast<size_t>(nh)*_nx);
+  for (int y=hy0; y<=hy1; ++y)
+  {
+    const double *data = &_data[static_cast<size_t>(y)*_nx];
+    for (int x=0; x<_nx; ++x)
+    {
+      line[x] = (data[x] == _missing) ? -HUGE_VAL : data[x];
+    }
+    _runningMax(&line[0], _nx, sx, &hmax[static_cast<size_t>(y - hy0)*_nx],
+		g, h);
+  }
+
+  // columns of the band, the rows outside the grid are padding
+  vector<double> col(nh), cmax(nh);
+  for (int x=0; x<_nx; ++x)
+  {
+    for (int j=0; j<nh; ++j)
+    {
+      col[j] = hmax[static_cast<size_t>(j)*_nx + x];
+    }
+    _runningMax(&col[0], nh, sy, &cmax[0], g, h);
+    for (int y=y0; y<=y1; ++y)
+    {
+      double v = cmax[y - hy0];
+      if (v == -HUGE_VAL)
+      {
+	out.setMissing(x, y);
+      }
+      else
+      {
+	out.setValue(x, y, v);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------
+// Apply a Grid2dLoopA algorithm to the strip of columns x0 to x1,
+// written to out
+void GridAlgs::_loopAlgColumns(Grid2dLoopAlg &alg, int sx, int sy,
+			       int minGood, int x0, int x1,
+			       Grid2d &out) const
+{
+  Grid2dLoopA G(_nx, _ny, sx, sy, x0, x1);
+  while (G.increment(*this, alg))
+  {
+    int x, y;
+    double result;
+    if (G.getXyAndResult(alg, minGood, x, y, result))
+    {
+      out.setValue(x, y, result);
+    }
+    else
+    {
+      out.setMissing(x, y);
+    }
+  }
+}
+
 //----------------------------------------------------------------
 double GridAlgs::_maxOneValue(double value, int x, int y, int xw, int yw) const
 {
@@ -59,6 +59,9 @@ GridClumping::GridClumping()
   _clumps = NULL;
   _nClumps = 0;
 
+  _nThreads = 1;
+  _connectivity = ParallelClumping::CONNECT_3D;
+
 }
 
 /////////////
@@ -204,6 +207,27 @@ void GridClumping::erode(int nx, int ny, unsigned char *eroded_grid,
 
 }
 
+//////////////////////////
+// set number of threads
+
+void GridClumping::setNThreads(int nThreads)
+
+{
+  _nThreads = nThreads;
+  _parallel.setNThreads(nThreads);
+}
+
+//////////////////////////
+// set connectivity
+
+void GridClumping::setConnectivity
+  (ParallelClumping::connectivity_t connectivity)
+
+{
+  _connectivity = connectivity;
+  _parallel.setConnectivity(connectivity);
+}
+
 ///////////////////////////////////////////////////
 // performGridClumping
 //
@@ -247,8 +271,7 @@ int GridClumping::performClumping(int nx, int ny, int nz,
   
   // clump
   
-  _nClumps = EG_rclump_3d(_rowh, nrows_per_plane, nplanes, TRUE,
-			 min_overlap, _intervalOrder, _clumps);
+  _nClumps = _clumpIntervals(nrows_per_plane, nplanes, min_overlap);
 
   return _nClumps;
   
@@ -297,8 +320,7 @@ int GridClumping::performClumping(int nx, int ny, int nz,
   
   // clump
   
-  _nClumps = EG_rclump_3d(_rowh, nrows_per_plane, nplanes, TRUE,
-                          min_overlap, _intervalOrder, _clumps);
+  _nClumps = _clumpIntervals(nrows_per_plane, nplanes, min_overlap);
 
   return _nClumps;
   
@@ -316,5 +338,25 @@ void GridClumping::_allocRowh(int nrows_per_vol)
   EG_alloc_rowh(nrows_per_vol, &_nRowsAlloc, &_rowh);
 }
 
+///////////////////////
+// _clumpIntervals()
+//
+// clump the intervals in the row headers
+//
+// returns number of clumps
+//
 
+int GridClumping::_clumpIntervals(int nrows_per_plane, int nplanes,
+                                  int min_overlap)
 
+{
+
+  if (_nThreads > 1 || _connectivity == ParallelClumping::CONNECT_2D) {
+    return _parallel.performClumping(_rowh, nrows_per_plane, nplanes,
+                                     min_overlap, _intervalOrder, _clumps);
+  }
+
+  return EG_rclump_3d(_rowh, nrows_per_plane, nplanes, TRUE,
+                      min_overlap, _intervalOrder, _clumps);
+
+}
@@ -0,0 +1,356 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// ParallelClumping.cc
+//
+// ParallelClumping class
+//
+// Clumps run intervals using union-find, in parallel.
+// See ParallelClumping.hh for details.
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#include <euclid/ParallelClumping.hh>
+#include <toolsa/TaThreadSimple.hh>
+using namespace std;
+
+//////////////
+// constructor
+//
+
+ParallelClumping::ParallelClumping()
+
+{
+
+  _nThreads = 1;
+  _connectivity = CONNECT_3D;
+
+  _rowh = NULL;
+  _nRowsPerPlane = 0;
+  _nPlanes = 0;
+  _minOverlap = 1;
+
+}
+
+/////////////
+// destructor
+//
+
+ParallelClumping::~ParallelClumping()
+
+{
+
+}
+
+//////////////////////
+// set number of threads
+
+void ParallelClumping::setNThreads(int nThreads)
+
+{
+  _nThreads = nThreads;
+  if (_nThreads < 1) {
+    _nThreads = 1;
+  }
+}
+
+///////////////////////////////////////////////////
+// performClumping
+//
+// returns number of clumps
+//
+
+int ParallelClumping::performClumping(Row_hdr *row_hdr,
+                                      int nrows_per_plane, int nplanes,
+                                      int min_overlap,
+                                      Interval **interval_order,
+                                      Clump_order *clump_order)
+
+{
+
+  _rowh = row_hdr;
+  _nRowsPerPlane = nrows_per_plane;
+  _nPlanes = nplanes;
+  _minOverlap = min_overlap;
+
+  if (_nRowsPerPlane < 1 || _nPlanes < 1) {
+    return 0;
+  }
+
+  // index the intervals, and initialize the union-find
+
+  int nRows = _nRowsPerPlane * _nPlanes;
+  _rowStart.resize(nRows + 1);
+  int nInt = 0;
+  for (int irow = 0; irow < nRows; irow++) {
+    _rowStart[irow] = nInt;
+    nInt += _rowh[irow].size;
+  }
+  _rowStart[nRows] = nInt;
+  if (nInt == 0) {
+    return 0;
+  }
+
+  _parent.resize(nInt);
+  for (int ii = 0; ii < nInt; ii++) {
+    _parent[ii] = ii;
+  }
+
+  // split the rows into bands - several per thread to
+  // balance the load, since storms are not evenly spread
+
+  int nBands = 1;
+  if (_nThreads > 1) {
+    nBands = _nThreads * 4;
+    if (nBands > _nRowsPerPlane) {
+      nBands = _nRowsPerPlane;
+    }
+  }
+  vector<int> bandStart(nBands + 1);
+  for (int iband = 0; iband <= nBands; iband++) {
+    bandStart[iband] = (int) (((long) iband * _nRowsPerPlane) / nBands);
+  }
+
+  // link the intervals within each band
+
+  if (nBands == 1) {
+    _linkBand(0, _nRowsPerPlane - 1);
+  } else {
+    ClumpThreads threads;
+    threads.init(_nThreads, false);
+    for (int iband = 0; iband < nBands; iband++) {
+      BandInfo *info =
+        new BandInfo(this, bandStart[iband], bandStart[iband + 1] - 1);
+      threads.thread(iband, (void *) info);
+    }
+    threads.waitForThreads();
+  }
+
+  // link the rows on either side of the band borders
+
+  for (int iband = 1; iband < nBands; iband++) {
+    int iy = bandStart[iband];
+    for (int iz = 0; iz < _nPlanes; iz++) {
+      int row = iz * _nRowsPerPlane + iy;
+      _linkRows(row - 1, row, SOUTH_INTERVAL, NORTH_INTERVAL);
+    }
+  }
+
+  // assign the clump ids
+
+  return _labelClumps(interval_order, clump_order);
+
+}
+    
+///////////////////////////////////////////////////
+// thread compute method - link a band of rows
+
+void ParallelClumping::compute(void *ti)
+
+{
+  BandInfo *info = static_cast<BandInfo *>(ti);
+  info->_obj->_linkBand(info->_y0, info->_y1);
+  delete info;
+}
+
+///////////////////////////////////////////////////
+// clone a thread for the que
+
+TaThread *ParallelClumping::ClumpThreads::clone(int index)
+
+{
+  TaThreadSimple *t = new TaThreadSimple(index);
+  t->setThreadMethod(ParallelClumping::compute);
+  t->setThreadContext(this);
+  return (TaThread *) t;
+}
+
+///////////////////////////////////////////////////
+// Link the intervals in rows y0 through y1, in all planes.
+// Only intervals within the band are joined.
+
+void ParallelClumping::_linkBand(int y0, int y1)
+
+{
+
+  for (int iz = 0; iz < _nPlanes; iz++) {
+
+    int planeStart = iz * _nRowsPerPlane;
+
+    for (int iy = y0; iy <= y1; iy++) {
+
+      int row = planeStart + iy;
+
+      // no overlaps beyond the edges of the grid
+
+      if (iy == 0) {
+        _setNoOverlaps(row, NORTH_INTERVAL);
+      }
+      if (iy == _nRowsPerPlane - 1) {
+        _setNoOverlaps(row, SOUTH_INTERVAL);
+      }
+      if (iz == 0 || _connectivity == CONNECT_2D) {
+        _setNoOverlaps(row, DOWN_INTERVAL);
+      }
+      if (iz == _nPlanes - 1 || _connectivity == CONNECT_2D) {
+        _setNoOverlaps(row, UP_INTERVAL);
+      }
+
+      // overlap rows in the horizontal
+
+      if (iy < y1) {
+        _linkRows(row, row + 1, SOUTH_INTERVAL, NORTH_INTERVAL);
+      }
+
+      // overlap rows in the vertical
+
+      if (_connectivity == CONNECT_3D && iz < _nPlanes - 1) {
+        _linkRows(row, row + _nRowsPerPlane, UP_INTERVAL, DOWN_INTERVAL);
+      }
+
+    } // iy
+
+  } // iz
+
+}
+
+///////////////////////////////////////////////////
+// Link the intervals in two rows, setting the overlaps
+// in both directions.
+
+void ParallelClumping::_linkRows(int row1, int row2, int dir12, int dir21)
+
+{
+  _overlapRows(row1, row2, dir12);
+  _overlapRows(row2, row1, dir21);
+}
+
+///////////////////////////////////////////////////
+// Find the overlaps of the intervals in row1 with those in
+// row2, as in EG_overlap_rows(), and join the overlapping
+// intervals.
+
+void ParallelClumping::_overlapRows(int row1, int row2, int direction)
+
+{
+
+  Row_hdr *rowh1 = _rowh + row1;
+  Row_hdr *rowh2 = _rowh + row2;
+  int start1 = _rowStart[row1];
+  int start2 = _rowStart[row2];
+
+  int startIndex = 0;
+  for (int ii = 0; ii < rowh1->size; ii++) {
+    int overlapBegin, overlapEnd;
+    EG_find_overlap(ii, startIndex, rowh1, rowh2,
+                    _minOverlap, &overlapBegin, &overlapEnd);
+    rowh1->intervals[ii].overlaps[direction][0] = overlapBegin;
+    rowh1->intervals[ii].overlaps[direction][1] = overlapEnd;
+    for (int jj = overlapBegin; jj <= overlapEnd; jj++) {
+      _union(start1 + ii, start2 + jj);
+    }
+    startIndex = overlapEnd;
+  }
+
+}
+
+///////////////////////////////////////////////////
+// Set the overlaps for a row at the edge of the grid
+
+void ParallelClumping::_setNoOverlaps(int row, int direction)
+
+{
+  Row_hdr *rowh = _rowh + row;
+  for (int ii = 0; ii < rowh->size; ii++) {
+    rowh->intervals[ii].overlaps[direction][0] = 1;
+    rowh->intervals[ii].overlaps[direction][1] = 0;
+  }
+}
+
+///////////////////////////////////////////////////
+// Assign the clump ids, and load up the clump order.
+//
+// Since each root is the lowest index in its clump, the roots
+// are found in the same order as the seeds in EG_rclump_3d().
+//
+// Returns number of clumps.
+
+int ParallelClumping::_labelClumps(Interval **interval_order,
+                                   Clump_order *clump_order)
+
+{
+
+  int nRows = _nRowsPerPlane * _nPlanes;
+  int nInt = _rowStart[nRows];
+  _label.resize(nInt);
+
+  // set the ids, and count the intervals and points in each clump
+
+  int nClumps = 0;
+  for (int irow = 0; irow < nRows; irow++) {
+    Row_hdr *rowh = _rowh + irow;
+    int start = _rowStart[irow];
+    for (int ii = 0; ii < rowh->size; ii++) {
+      int index = start + ii;
+      int root = _find(index);
+      if (root == index) {
+        nClumps++;
+        _label[index] = nClumps;
+        clump_order[nClumps].size = 0;
+        clump_order[nClumps].pts = 0;
+      }
+      int id = _label[root];
+      Interval *intvl = rowh->intervals + ii;
+      intvl->id = id;
+      clump_order[id].size++;
+      clump_order[id].pts += intvl->end - intvl->begin + 1;
+    }
+  }
+
+  // set the clump pointers into the interval order
+
+  int offset = 0;
+  for (int id = 1; id <= nClumps; id++) {
+    clump_order[id].ptr = interval_order + offset;
+    offset += clump_order[id].size;
+    clump_order[id].size = 0;
+  }
+
+  // load the interval order, using size as the insertion count
+
+  for (int irow = 0; irow < nRows; irow++) {
+    Row_hdr *rowh = _rowh + irow;
+    for (int ii = 0; ii < rowh->size; ii++) {
+      Interval *intvl = rowh->intervals + ii;
+      Clump_order *clump = clump_order + intvl->id;
+      clump->ptr[clump->size++] = intvl;
+    }
+  }
+
+  return nClumps;
+
+}
+
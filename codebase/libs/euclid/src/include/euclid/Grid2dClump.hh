@@ -78,6 +78,13 @@ public:
    */
   virtual ~Grid2dClump(void);
 
+  /**
+   * Set the number of threads used by buildRegions() and
+   * buildRegionPointlists(), default 1.
+   * @param[in] nThreads
+   */
+  inline void setNThreads(int nThreads) { _nThreads = nThreads; }
+
   /**
    * Debug print
    */
@@ -86,6 +93,10 @@ public:
   /** 
    * build all the disjoint regions you can.
    * @return the vector of region point lists.
+   *
+   * The regions are found by union-find on the runs of points in each
+   * row (see ParallelClumping), in order of their first point, with the
+   * points in each region in row order.
    */
   std::vector<clump::Region_t> buildRegions(void);
 
@@ -112,15 +123,13 @@ private:
   clump::Region_t _n; /**< region points. */
   int _nx;            /**< grid dimension */
   int _ny;            /**< grid dimension */
+  int _nThreads;      /**< number of threads for union-find clumping */
 
-  void _buildRegion(int ix, int iy);
+  void _buildAllRegions(std::vector<clump::Region_t> &regions);
   void _buildRegionRecursive(int ix, int iy);
   void _growRecursive(int x, int y);
-  std::pair<int,int> _growNonrecursive(int x, int y, bool &done);
-  std::pair<int, int> _findNondone(bool &done) const;
   void _buildN(void);
   bool _growOk(int ix, int iy, int x, int y) const;
-  bool _growOkNonrecursive(int ix, int iy, int x, int y) const;
 };
 
 # endif 
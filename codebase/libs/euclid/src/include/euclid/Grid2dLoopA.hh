@@ -35,6 +35,10 @@
  * @note Move up then right, then down, then right, then up, etc.
  * The class was created for efficient averaging techniques that allow
  * subtraction and addition of only a subset of values for each step.
+ *
+ * @note The traversal can be restricted to a strip of columns, so that
+ * strips can be processed in parallel.  The box still takes data from
+ * the full grid, so the results are the same as for a full traversal.
  */
 
 #ifndef GRID2DLOOPA_H
@@ -71,6 +75,18 @@ public:
    */
   Grid2dLoopA(int nx, int ny, int sx, int sy);
 
+  /**
+   * Traverse only the strip of columns x0 to x1
+   *
+   * @param[in] nx  Number of Grid2d points x
+   * @param[in] ny  Number of Grid2d points y
+   * @param[in] sx  The box width (x)
+   * @param[in] sy  The box width (y)
+   * @param[in] x0  First column of the strip
+   * @param[in] x1  Last column of the strip
+   */
+  Grid2dLoopA(int nx, int ny, int sx, int sy, int x0, int x1);
+
   /**
    * Destructor
    */
@@ -126,6 +142,8 @@ private:
 
   int _nx;  /**< Grid size */
   int _ny;  /**< Grid size */
+  int _x0;  /**< First column to traverse */
+  int _x1;  /**< Last column to traverse */
 
   int _x;         /**< Current centerpoint index */
   int _y;         /**< Current centerpoint index */
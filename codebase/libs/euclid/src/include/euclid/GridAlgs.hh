@@ -37,6 +37,7 @@
 #include <toolsa/TaThreadDoubleQue.hh>
 
 class Grid2dLoop;
+class Grid2dLoopAlg;
 class FuzzyF;
 
 //------------------------------------------------------------------
@@ -675,8 +676,8 @@ public:
    * Apply a sx by sy smoothing filter to the local grid.  At each point the
    * output is set to the mean value within the box centered at the point.
    *
-   * This version is the fastest algorithm, traverses the grid using
-   * Grid2dLoopA and passing around a Grid2dLoopAlgMean object
+   * This version is the fastest algorithm, using separable running box
+   * sums, so the cost per point does not depend on the box size.
    *
    * This is the recommended algorithm to use.
    *
@@ -685,6 +686,16 @@ public:
    */
   void smooth(int sx, int sy);
 
+  /**
+   * Same as smooth(), but with the grid divided into bands of rows
+   * that are processed in parallel
+   *
+   * @param[in] sx
+   * @param[in] sy
+   * @param[in] numThread  Number of threads to create
+   */
+  void smoothTiled(int sx, int sy, int numThread);
+
   /**
    * Apply a sx by sy smoothing filter to the local grid
    *
@@ -700,11 +711,9 @@ public:
   /**
    * Apply a sx by sy smoothing filter to the local grid
    *
-   * This version does the smoothing by creating a thread for each
-   * 'y', and then within the thread calling localAverage() at each 'x'
-   * for that 'y'.  If you have a lot of CPU's this might be faster
-   * than smooth()
-   *
+   * This version divides the grid into bands of rows that are smoothed
+   * in parallel using running box sums.  The output is the same as
+   * calling localCenteredAverage() with needHalf=true at each point.
    *
    * @param[in] sx
    * @param[in] sy
@@ -882,9 +891,22 @@ public:
    *
    * @param[in] nx  Dilation window x
    * @param[in] ny  Dilation window y
+   *
+   * Uses a separable running max (van Herk/Gil-Werman), so the cost
+   * per point does not depend on the window size.
    */
   void dilate(int nx, int ny);
 
+  /** 
+   * Same as dilate(), but with the grid divided into bands of rows
+   * that are processed in parallel
+   *
+   * @param[in] nx  Dilation window x
+   * @param[in] ny  Dilation window y
+   * @param[in] numThread  Number of threads to create
+   */
+  void dilateTiled(int nx, int ny, int numThread);
+
   /** 
    * At all points where a window around it has a value, set output to the
    * value. At all other points, nothing happens.
@@ -939,6 +961,20 @@ public:
   void median(int nx, int ny, double binMin, double binMax,
 	       double binDelta);
 
+  /**
+   * Same as median(), but with the grid divided into strips of columns
+   * that are processed in parallel, each with its own Grid2dLoopA
+   *
+   * @param[in] nx  Median window size x
+   * @param[in] ny  Median window size y
+   * @param[in] binMin  Data minimum bin center (histograms)
+   * @param[in] binMax  Data maximum bin center (histograms)
+   * @param[in] binDelta Data diff between bin centers (histograms)
+   * @param[in] numThread  Number of threads to create
+   */
+  void medianTiled(int nx, int ny, double binMin, double binMax,
+		   double binDelta, int numThread);
+
   /**
    * Median over the entire grid, with no overlapping boxes (output is
    * replicated within each box, one computation per box, each shift is a
@@ -988,6 +1024,20 @@ public:
   void speckle(int nx, int ny, double binMin, double binMax,
 	       double binDelta);
 
+  /**
+   * Same as speckle(), but with the grid divided into strips of columns
+   * that are processed in parallel
+   * 
+   * @param[in] nx  Percentile window size x
+   * @param[in] ny  Percentile window size y
+   * @param[in] binMin  Data minimum bin center (histograms)
+   * @param[in] binMax  Data maximum bin center (histograms)
+   * @param[in] binDelta Data diff between bin centers (histograms)
+   * @param[in] numThread  Number of threads to create
+   */
+  void speckleTiled(int nx, int ny, double binMin, double binMax,
+		    double binDelta, int numThread);
+
   /**
    * Create a 'speckle' interest measure from data in a grid, using fuzzy
    * remappings.  This is done using bins like in the median calculations.
@@ -1339,7 +1389,9 @@ private:
      * @enum Info_t  
      * @brief The algorithms that are implemented for threading
      */
-    typedef enum {SMOOTH, SDEV, TEXTURE_X, TEXTURE_Y, NONE} Info_t;
+    typedef enum {SMOOTH, SDEV, TEXTURE_X, TEXTURE_Y,
+		  BOX_MEAN_ROWS, BOX_MAX_ROWS, MEDIAN_COLS, SPECKLE_COLS,
+		  NONE} Info_t;
     
     /**
      * Constructor, values are stored into the corresponding members
@@ -1353,7 +1405,32 @@ private:
      */
     inline GridAlgsInfo(Info_t t, int sx, int sy, int iy, const GridAlgs *alg,
 			Grid2d &out) :
-      _type(t), _sx(sx), _sy(sy), _y(iy), _gridAlgs(alg), _out(out) {}
+      _type(t), _sx(sx), _sy(sy), _y(iy), _i0(iy), _i1(iy), _minGood(0),
+      _binMin(0), _binMax(0), _binDelta(0), _gridAlgs(alg), _out(out) {}
+
+    /**
+     * Constructor for a tile, which is a band of rows or a strip of
+     * columns, values are stored into the corresponding members
+     *
+     * @param[in] t
+     * @param[in] sx
+     * @param[in] sy
+     * @param[in] i0  First row or column of the tile
+     * @param[in] i1  Last row or column of the tile
+     * @param[in] minGood  Output is missing unless number of good points
+     *                     in the box exceeds this
+     * @param[in] binMin  Histogram minimum, for medians
+     * @param[in] binMax  Histogram maximum, for medians
+     * @param[in] binDelta  Histogram resolution, for medians
+     * @param[in] alg
+     * @param[in,out] out
+     */
+    inline GridAlgsInfo(Info_t t, int sx, int sy, int i0, int i1,
+			double minGood, double binMin, double binMax,
+			double binDelta, const GridAlgs *alg, Grid2d &out) :
+      _type(t), _sx(sx), _sy(sy), _y(i0), _i0(i0), _i1(i1),
+      _minGood(minGood), _binMin(binMin), _binMax(binMax),
+      _binDelta(binDelta), _gridAlgs(alg), _out(out) {}
 
     /**
      * Destructor
@@ -1364,6 +1441,12 @@ private:
     int _sx;                      /**< box size, x */
     int _sy;                      /**< box size, y */
     int _y;                       /**< Y index for this thread */
+    int _i0;                      /**< First row or column of tile */
+    int _i1;                      /**< Last row or column of tile */
+    double _minGood;              /**< Min number of good points in box */
+    double _binMin;               /**< Histogram minimum */
+    double _binMax;               /**< Histogram maximum */
+    double _binDelta;             /**< Histogram resolution */
     const GridAlgs *_gridAlgs;    /**< Pointer to the actual GridAlgs */
     Grid2d &_out;                 /**< Reference to the output data grid */
   protected:
@@ -1382,6 +1465,15 @@ private:
 		   const Grid2d &lowres);
 
   double _max(int x, int y, int xw, int yw) const;
+
+  void _runTiles(GridAlgsInfo::Info_t type, int sx, int sy, double minGood,
+		 double binMin, double binMax, double binDelta,
+		 int numThread);
+  void _boxMeanRows(int sx, int sy, double minGood, int y0, int y1,
+		    Grid2d &out) const;
+  void _boxMaxRows(int sx, int sy, int y0, int y1, Grid2d &out) const;
+  void _loopAlgColumns(Grid2dLoopAlg &alg, int sx, int sy, int minGood,
+		       int x0, int x1, Grid2d &out) const;
   double _maxOneValue(double value, int x, int y, int xw, int yw) const;
   void _fillEdge(int xw, int yw, double value);
   bool _fillHole(int n, int ix, int iy);
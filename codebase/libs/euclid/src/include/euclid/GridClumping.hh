@@ -41,6 +41,7 @@
 
 #include <string>
 #include <euclid/clump.h>
+#include <euclid/ParallelClumping.hh>
 #include <dataport/port_types.h>
 using namespace std;
 
@@ -89,6 +90,18 @@ public:
   void erode(int nx, int ny, unsigned char *eroded_grid,
 	     int erosion_threshold);
 
+  // Set the number of threads for clumping - defaults to 1.
+  // If more than 1, the intervals are clumped in parallel
+  // using ParallelClumping.
+
+  void setNThreads(int nThreads);
+
+  // Set the connectivity for clumping - defaults to 3D.
+  // With 2D connectivity each plane is clumped independently,
+  // using ParallelClumping.
+
+  void setConnectivity(ParallelClumping::connectivity_t connectivity);
+
   // perform clumping
 
   int performClumping(int nx, int ny, int nz,
@@ -128,9 +141,16 @@ private:
   int _nIntOrderAlloc;
   Interval **_intervalOrder;
 
+  int _nThreads;
+  ParallelClumping::connectivity_t _connectivity;
+  ParallelClumping _parallel;
+
   // allocate row headers
   void _allocRowh(int nrows_per_vol);
 
+  // clump the intervals
+  int _clumpIntervals(int nrows_per_plane, int nplanes, int min_overlap);
+
 };
 
 #endif
@@ -0,0 +1,193 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+/////////////////////////////////////////////////////////////
+// ParallelClumping.hh
+//
+// ParallelClumping class
+//
+// Clumps run intervals using union-find, in parallel.
+//
+// This is an alternative to EG_rclump_3d(). The grid is split
+// into bands of rows, each band spanning all of the planes.
+// The bands are linked in separate threads, each joining the
+// intervals within its own band. Since the bands do not share
+// intervals, no locking is required. The rows on either side of
+// the band borders are then linked serially, and the clumps
+// are labelled.
+//
+// The union-find roots are the lowest interval index in each
+// clump, so the clump ids are assigned in the same order as
+// EG_rclump_3d(), i.e. in order of the first interval found in
+// a plane-row-column scan. The overlaps[] of each interval are
+// set as in EG_overlap_volume(). Within each clump, the interval
+// pointers are in scan order rather than seed-fill order.
+//
+// The overlaps are found with EG_find_overlap(), in both
+// directions, and any overlap joins the pair of intervals. For
+// min_overlap of 0 or 1 the overlap lists are symmetric and the
+// clumps are identical to EG_rclump_3d(). For other values a
+// pair may appear in only one of the lists, in which case the
+// seed fill in EG_rclump_3d() depends on the scan order and may
+// split the clump - here the pair is always joined.
+//
+// Connectivity:
+//   CONNECT_3D - intervals are linked between adjacent rows in
+//                the same plane, and between the same row in
+//                adjacent planes, as in EG_rclump_3d().
+//   CONNECT_2D - intervals are only linked within a plane, so
+//                that each plane is clumped independently.
+//
+// Oct 2026
+//
+///////////////////////////////////////////////////////////////
+
+#ifndef ParallelClumping_HH
+#define ParallelClumping_HH
+
+#include <vector>
+#include <euclid/clump.h>
+#include <toolsa/TaThreadDoubleQue.hh>
+using namespace std;
+
+////////////////////////////////
+// ParallelClumping
+
+class ParallelClumping {
+  
+public:
+
+  typedef enum {
+    CONNECT_2D,
+    CONNECT_3D
+  } connectivity_t;
+
+  // constructor
+
+  ParallelClumping();
+
+  // destructor
+  
+  virtual ~ParallelClumping();
+
+  // set the number of threads - defaults to 1
+
+  void setNThreads(int nThreads);
+
+  // set the connectivity - defaults to CONNECT_3D
+
+  void setConnectivity(connectivity_t connectivity) {
+    _connectivity = connectivity;
+  }
+
+  // Clump the intervals.
+  //
+  // Arguments and results as for EG_rclump_3d() with clear set:
+  //   row_hdr: row headers, nrows_per_plane * nplanes
+  //   interval_order: allocated by caller, size (n_intervals + 1)
+  //   clump_order: allocated by caller, size (n_intervals + 1)
+  //
+  // The interval ids are set to the clump ids, which start at 1.
+  //
+  // Returns number of clumps.
+
+  int performClumping(Row_hdr *row_hdr,
+                      int nrows_per_plane, int nplanes,
+                      int min_overlap,
+                      Interval **interval_order,
+                      Clump_order *clump_order);
+
+  // thread compute method, for linking a band of rows
+
+  static void compute(void *ti);
+
+protected:
+  
+private:
+
+  int _nThreads;
+  connectivity_t _connectivity;
+
+  // state for current clumping
+
+  Row_hdr *_rowh;
+  int _nRowsPerPlane;
+  int _nPlanes;
+  int _minOverlap;
+
+  vector<int> _rowStart; // index of first interval in each row
+  vector<int> _parent;   // union-find parent of each interval
+  vector<int> _label;    // clump id of each root
+
+  // band of rows, for a thread
+
+  class BandInfo {
+  public:
+    BandInfo(ParallelClumping *obj, int y0, int y1) :
+            _obj(obj), _y0(y0), _y1(y1) {}
+    ParallelClumping *_obj;
+    int _y0;
+    int _y1;
+  };
+
+  // thread que
+
+  class ClumpThreads : public TaThreadDoubleQue
+  {
+  public:
+    inline ClumpThreads() : TaThreadDoubleQue() {}
+    inline virtual ~ClumpThreads() {}
+    TaThread *clone(int index);
+  };
+
+  void _linkBand(int y0, int y1);
+  void _linkRows(int row1, int row2, int dir12, int dir21);
+  void _overlapRows(int row1, int row2, int direction);
+  void _setNoOverlaps(int row, int direction);
+  int _labelClumps(Interval **interval_order,
+                   Clump_order *clump_order);
+
+  // union-find
+
+  inline int _find(int ii) {
+    while (_parent[ii] != ii) {
+      _parent[ii] = _parent[_parent[ii]];
+      ii = _parent[ii];
+    }
+    return ii;
+  }
+
+  inline void _union(int ii, int jj) {
+    int iroot = _find(ii);
+    int jroot = _find(jj);
+    if (iroot < jroot) {
+      _parent[jroot] = iroot;
+    } else if (jroot < iroot) {
+      _parent[iroot] = jroot;
+    }
+  }
+
+};
+
+#endif
+
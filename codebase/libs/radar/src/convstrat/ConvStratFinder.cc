@@ -43,12 +43,14 @@
 #include <map>
 #include <toolsa/pmu.h>
 #include <toolsa/toolsa_macros.h>
+#include <toolsa/TaThreadSimple.hh>
 #include <radar/ConvStratFinder.hh>
 #include <rapmath/PlaneFit.hh>
 using namespace std;
 
 const fl32 ConvStratFinder::_missingFl32 = -9999.0;
 const ui08 ConvStratFinder::_missingUi08 = ConvStratFinder::CATEGORY_MISSING;
+const size_t ConvStratFinder::_tileSize = 64;
 
 // Constructor
 
@@ -89,6 +91,12 @@ ConvStratFinder::ConvStratFinder()
   _projIsLatLon = false;
   _gridSet = false;
 
+  _dbzInput = NULL;
+  _dbzInputMissing = _missingFl32;
+
+  _nThreads = 1;
+  _threads = NULL;
+  _nThreadsInQue = 0;
 
 }
 
@@ -97,7 +105,9 @@ ConvStratFinder::ConvStratFinder()
 ConvStratFinder::~ConvStratFinder()
 
 {
+  _freeClumps();
   freeArrays();
+  delete _threads;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -210,17 +220,6 @@ int ConvStratFinder::computePartition(const fl32 *dbz,
     }
   } // iz
 
-  // set dbz field to missing if below the min threshold
-  
-  fl32 *volDbz = _dbz3D.dat();
-  for (size_t ii = 0; ii < _nxyz; ii++) {
-    if (dbz[ii] == dbzMissingVal || dbz[ii] < _minValidDbz) {
-      volDbz[ii] = _missingFl32;
-    } else {
-      volDbz[ii] = dbz[ii];
-    }
-  }
-
   // compute the circular kernel
   
   _computeKernels();
@@ -228,30 +227,37 @@ int ConvStratFinder::computePartition(const fl32 *dbz,
   if (_verbose) {
     _printSettings(cerr);
   }
+
+  // split the grid into tiles
+
+  _computeTiles();
+  _dbzInput = dbz;
+  _dbzInputMissing = dbzMissingVal;
   
-  // compute column maxima
-  
-  _computeColMax();
+  // set dbz field to missing if below the min threshold,
+  // and compute column maxima and echo tops
   
-  // compute spatial texture of reflectivity
+  _runStage(STAGE_COL_MAX, _tiles.size());
   
-  _computeTexture();
-
-  // compute convectivity convectivity
+  // compute spatial texture of reflectivity, and the
+  // convectivity from it
   
-  _computeConvectivity();
+  _runStage(STAGE_TEXTURE, _tiles.size());
 
   // perform clumping on the convectivity field
 
   _performClumping();
 
-  // set the 3D version of the partition
+  // set the partition for the convective clumps
 
-  _setPartition3D();
+  _runStage(STAGE_CLUMPS, _clumps.size());
 
-  // compute the 2D fields from the 3D fields
+  // set the rest of the 3D partition, and compute
+  // the 2D fields from the 3D fields
 
-  _set2DFields();
+  _runStage(STAGE_PARTITION, _tiles.size());
+
+  _dbzInput = NULL;
 
   return 0;
 
@@ -360,39 +366,192 @@ void ConvStratFinder::freeArrays()
 }
 
 /////////////////////////////////////////////////////////
-// compute the column maximum
+// split the grid into tiles of columns
 
-void ConvStratFinder::_computeColMax()
+void ConvStratFinder::_computeTiles()
   
 {
 
-  PMU_auto_register("ConvStratFinder::_computeColMax()");
+  _tiles.clear();
 
-  // get data pointers
+  for (size_t iy0 = 0; iy0 < _ny; iy0 += _tileSize) {
+    for (size_t ix0 = 0; ix0 < _nx; ix0 += _tileSize) {
+      tile_t tile;
+      tile.ix0 = ix0;
+      tile.ix1 = min(ix0 + _tileSize, _nx);
+      tile.iy0 = iy0;
+      tile.iy1 = min(iy0 + _tileSize, _ny);
+      _tiles.push_back(tile);
+    } // ix0
+  } // iy0
 
-  fl32 *colMaxDbz = _colMaxDbz.dat();
+  if (_verbose) {
+    cerr << "ConvStratFinder - n tiles: " << _tiles.size() << endl;
+  }
+
+}
+
+/////////////////////////////////////////////////////////
+// run a stage over nItems tiles or clumps
+// The items are split between the threads in a fixed pattern,
+// and the stage is complete for all items on return.
+
+void ConvStratFinder::_runStage(stage_t stage, size_t nItems)
   
-  // initialize
+{
 
-  for (size_t ii = 0; ii < _nxy; ii++) {
-    colMaxDbz[ii] = _missingFl32;
+  PMU_auto_register("ConvStratFinder::_runStage()");
+
+  int nThreads = _nThreads;
+  if (nThreads > (int) nItems) {
+    nThreads = nItems;
   }
 
-  fl32 *dbz = _dbz3D.dat();
+  if (nThreads <= 1) {
+    _processItems(stage, 0, 1);
+    return;
+  }
+
+  // create the thread que the first time, or if the
+  // number of threads has changed
+  
+  if (_threads == NULL || _nThreadsInQue != _nThreads) {
+    delete _threads;
+    _threads = new ConvStratThreads();
+    _threads->init(_nThreads, false);
+    _nThreadsInQue = _nThreads;
+  }
+
+  for (int ii = 0; ii < nThreads; ii++) {
+    ThreadInfo *info = new ThreadInfo(this, stage, ii, nThreads);
+    _threads->thread(ii, (void *) info);
+  }
+
+  _threads->waitForThreads();
+
+}
+
+/////////////////////////////////////////////////////////
+// process every nThreads'th item for a stage,
+// starting at threadNum
+
+void ConvStratFinder::_processItems(stage_t stage,
+                                    int threadNum,
+                                    int nThreads)
+  
+{
+
+  switch (stage) {
+
+    case STAGE_COL_MAX:
+      for (size_t ii = threadNum; ii < _tiles.size(); ii += nThreads) {
+        _computeColMax(_tiles[ii]);
+      }
+      break;
+
+    case STAGE_TEXTURE:
+      for (size_t ii = threadNum; ii < _tiles.size(); ii += nThreads) {
+        _computeTexture(_tiles[ii]);
+        _computeConvectivity(_tiles[ii]);
+      }
+      break;
+
+    case STAGE_CLUMPS:
+      // the clumps do not overlap, so each writes its own points
+      for (size_t ii = threadNum; ii < _clumps.size(); ii += nThreads) {
+        _clumps[ii]->computeGeom();
+        _clumps[ii]->setPartition();
+      }
+      break;
+
+    case STAGE_PARTITION:
+      for (size_t ii = threadNum; ii < _tiles.size(); ii += nThreads) {
+        _setPartition3D(_tiles[ii]);
+        _set2DFields(_tiles[ii]);
+      }
+      break;
+
+  } // switch
+
+}
+
+/////////////////////////////////////////////////////////
+// thread method - deletes the ThreadInfo object
+
+void ConvStratFinder::_threadMethod(void *threadData)
+  
+{
+  ThreadInfo *info = (ThreadInfo *) threadData;
+  info->_finder->_processItems(info->_stage,
+                               info->_threadNum, info->_nThreads);
+  delete info;
+}
+
+/////////////////////////////////////////////////////////
+// clone a thread for the que
+
+TaThread *ConvStratFinder::ConvStratThreads::clone(int index)
+  
+{
+  TaThreadSimple *t = new TaThreadSimple(index);
+  t->setThreadMethod(ConvStratFinder::_threadMethod);
+  t->setThreadContext(this);
+  return (TaThread *) t;
+}
+
+/////////////////////////////////////////////////////////
+// Load the thresholded dbz for a tile, and compute the
+// column maximum and echo tops.
+// Also initialize the 3D outputs for the tile.
+
+void ConvStratFinder::_computeColMax(const tile_t &tile)
+  
+{
+
+  // get data pointers
+
+  fl32 *colMaxDbz = _colMaxDbz.dat();
   fl32 *topKm = _echoTopKm.dat();
+  fl32 *dbz = _dbz3D.dat();
+  fl32 *texture3D = _texture3D.dat();
+  fl32 *convDbz = _convDbz.dat();
+  ui08 *partition3D = _partition3D.dat();
   
-  for (size_t iz = _minIz; iz <= _maxIz; iz++) {
+  // initialize
+
+  for (size_t iy = tile.iy0; iy < tile.iy1; iy++) {
+    size_t jj = tile.ix0 + iy * _nx;
+    for (size_t ix = tile.ix0; ix < tile.ix1; ix++, jj++) {
+      colMaxDbz[jj] = _missingFl32;
+      topKm[jj] = _missingFl32;
+    } // ix
+  } // iy
+
+  for (size_t iz = 0; iz < _zKm.size(); iz++) {
+
+    bool inValidRange = (iz >= _minIz && iz <= _maxIz);
     double htKm = _zKm[iz];
-    size_t jj = 0;
-    size_t ii = iz * _nxy;
-    for (size_t iy = 0; iy < _ny; iy++) {
-      for (size_t ix = 0; ix < _nx; ix++, jj++, ii++) {
+
+    for (size_t iy = tile.iy0; iy < tile.iy1; iy++) {
+      
+      size_t jj = tile.ix0 + iy * _nx;
+      size_t ii = jj + iz * _nxy;
+      
+      for (size_t ix = tile.ix0; ix < tile.ix1; ix++, jj++, ii++) {
         
-        // size_t jj = ix + iy * _nx;
-        // size_t ii = jj + iz * _nxy;
-        fl32 dbzVal = dbz[ii];
+        // set dbz field to missing if below the min threshold
         
-        if (dbzVal == _missingFl32) {
+        fl32 dbzVal = _dbzInput[ii];
+        if (dbzVal == _dbzInputMissing || dbzVal < _minValidDbz) {
+          dbzVal = _missingFl32;
+        }
+        dbz[ii] = dbzVal;
+
+        texture3D[ii] = _missingFl32;
+        convDbz[ii] = _missingFl32;
+        partition3D[ii] = _missingUi08;
+        
+        if (!inValidRange || dbzVal == _missingFl32) {
           continue;
         }
 
@@ -407,15 +566,45 @@ void ConvStratFinder::_computeColMax()
       } // ix
     } // iy
   } // iz
+
+}
+
+/////////////////////////////////////////////////////////
+// Compute the fraction active, and the spatial texture,
+// for a tile.
+// The kernel reads the column max and dbz in the halo around
+// the tile, which were computed in the previous stage.
+
+void ConvStratFinder::_computeTexture(const tile_t &tile)
   
-  // compute fraction covered array for texture kernel
-  // we use the column maximum dbz to find points with coverage
+{
 
+  // array pointers
+
+  const fl32 *colMaxDbz = _colMaxDbz.dat();
   fl32 *fractionTexture = _fractionActive.dat();
-  memset(fractionTexture, 0, _nxy * sizeof(fl32));
-  for (int iy = _nyTexture; iy < (int) _ny - _nyTexture; iy++) {
-    for (int ix = _nxTexture; ix < (int) _nx - _nxTexture; ix++) {
-      size_t xycenter = ix + iy * _nx;
+  fl32 *volTexture = _texture3D.dat();
+
+  // limits of the points with a full kernel
+
+  size_t minIx = max(tile.ix0, (size_t) _nxTexture);
+  size_t minIy = max(tile.iy0, (size_t) _nyTexture);
+  size_t maxIx = min(tile.ix1, _nx - min(_nx, (size_t) _nxTexture));
+  size_t maxIy = min(tile.iy1, _ny - min(_ny, (size_t) _nyTexture));
+
+  // compute fraction covered array for texture kernel
+  // we use the column maximum dbz to find points with coverage
+  
+  for (size_t iy = tile.iy0; iy < tile.iy1; iy++) {
+    size_t xycenter = tile.ix0 + iy * _nx;
+    for (size_t ix = tile.ix0; ix < tile.ix1; ix++, xycenter++) {
+      fractionTexture[xycenter] = 0.0;
+    }
+  }
+  
+  for (size_t iy = minIy; iy < maxIy; iy++) {
+    size_t xycenter = minIx + iy * _nx;
+    for (size_t ix = minIx; ix < maxIx; ix++, xycenter++) {
       double count = 0;
       for (size_t ii = 0; ii < _textureKernelOffsets.size(); ii++) {
         size_t jj = xycenter + _textureKernelOffsets[ii].offset;
@@ -429,108 +618,153 @@ void ConvStratFinder::_computeColMax()
     } // ix
   } // iy
 
-}
-
-/////////////////////////////////////////////////////////
-// compute the spatial texture
+  // compute texture at each point in the tile
 
-void ConvStratFinder::_computeTexture()
-  
-{
-
-  PMU_auto_register("ConvStratFinder::_computeTexture()");
-
-  // array pointers
-
-  fl32 *volTexture = _texture3D.dat();
-  fl32 *fractionTexture = _fractionActive.dat();
+  size_t nKernel = _textureKernelOffsets.size();
+  size_t minPtsForTexture = 
+    (size_t) (_minValidFractionForTexture * nKernel + 0.5);
+  size_t minPtsForFit = 
+    (size_t) (_minValidFractionForFit * nKernel + 0.5);
 
-  // initialize
-  
-  for (size_t ii = 0; ii < _nxyz; ii++) {
-    volTexture[ii] = _missingFl32;
-  }
+  PlaneFit pfit;
+  vector<double> dbzVals, xx, yy;
+  dbzVals.reserve(nKernel);
+  xx.reserve(nKernel);
+  yy.reserve(nKernel);
   
-  // set up threads for computing texture at each level
-
-  const fl32 *dbz = _dbz3D.dat();
-  const fl32 *colMaxDbz = _colMaxDbz.dat();
-  vector<ComputeTexture *> threads;
   for (size_t iz = _minIz; iz <= _maxIz; iz++) {
-    size_t zoffset = iz * _nxy;
-    ComputeTexture *thread = new ComputeTexture(iz);
-    thread->setGridSize(_nx, _ny);
-    thread->setKernelSize(_nxTexture, _nyTexture);
-    thread->setMinValidFractionForTexture(_minValidFractionForTexture);
-    thread->setMinValidFractionForFit(_minValidFractionForFit);
-    thread->setDbz(dbz + zoffset, colMaxDbz, _missingFl32);
-    thread->setFractionCovered(fractionTexture);
-    thread->setKernelOffsets(_textureKernelOffsets);
-    thread->setTextureArray(volTexture + zoffset);
-    threads.push_back(thread);
-  }
-
-  // set threads going
 
-  for (size_t ii = 0; ii < threads.size(); ii++) {
-    if (_verbose) {
-      cerr << "====>> starting texture thread: " << ii << endl;
-    }
-    threads[ii]->signalRunToStart();
-  }
-
-  // wait until they are done
-
-  for (size_t ii = 0; ii < threads.size(); ii++) {
-    threads[ii]->waitForRunToComplete();
-    if (_verbose) {
-      cerr << "====>> texture thread complete: " << ii << endl;
-    }
-  }
-
-  // delete threads
-
-  for (size_t ii = 0; ii < threads.size(); ii++) {
-    if (_verbose) {
-      cerr << "====>> deleting texture thread: " << ii << endl;
-    }
-    delete threads[ii];
-  }
-
-  threads.clear();
-  if (_verbose) {
-    cerr << "====>> All threads freed" << endl;
-  }
+    const fl32 *dbz = _dbz3D.dat() + iz * _nxy;
+    fl32 *texture = volTexture + iz * _nxy;
+    
+    for (size_t iy = minIy; iy < maxIy; iy++) {
+      
+      size_t icenter = minIx + iy * _nx;
+      
+      for (size_t ix = minIx; ix < maxIx; ix++, icenter++) {
+        
+        if (fractionTexture[icenter] < _minValidFractionForTexture) {
+          continue;
+        }
+        if (dbz[icenter] == _missingFl32) {
+          continue;
+        }
+        
+        // fit a plane to the reflectivity in a circular kernel around point
+        
+        pfit.clear();
+        size_t count = 0;
+        dbzVals.clear();
+        xx.clear();
+        yy.clear();
+        double sumDbz = 0.0;
+        for (size_t ii = 0; ii < nKernel; ii++) {
+          const kernel_t &kern = _textureKernelOffsets[ii];
+          size_t kk = icenter + kern.offset;
+          double val = dbz[kk];
+          if (val != _missingFl32) {
+            pfit.addPoint(kern.xx, kern.yy, val);
+            dbzVals.push_back(val);
+            xx.push_back(kern.xx);
+            yy.push_back(kern.yy);
+            sumDbz += val;
+            count++;
+          }
+        } // ii
+        
+        double meanDbz = sumDbz / count;
+        meanDbz = max(meanDbz, 1.0);
+        
+        // check we have sufficient data around this point
+        // for computing the fit
+        
+        if (count >= minPtsForFit) {
+          // fit a plane to the reflectivity
+          if (pfit.performFit() == 0) {
+            // subtract plane fit from dbz values to
+            // remove 2d trends in the data
+            double aa = pfit.getCoeffA();
+            double bb = pfit.getCoeffB();
+            for (size_t ii = 0; ii < dbzVals.size(); ii++) {
+              double delta = aa * xx[ii] + bb * yy[ii];
+              dbzVals[ii] -= delta;
+            }
+          }
+        } // if (count >= minPtsForFit)
+        
+        // check we have sufficient data around this point
+        // for computing the texture
+        
+        if (count >= minPtsForTexture) {
+          
+          // compute sdev of dbz squared
+          
+          double nn = 0.0;
+          double sum = 0.0;
+          double sumSq = 0.0;
+          for (size_t ii = 0; ii < dbzVals.size(); ii++) {
+            double val = dbzVals[ii];
+            // constrain to positive values
+            val = max(val, 1.0);
+            double dbzSq = val * val;
+            sum += dbzSq;
+            sumSq += dbzSq * dbzSq;
+            nn++;
+          } // ii
+          // for missing points, substitute the mean
+          if (dbzVals.size() < nKernel) {
+            double minSq = meanDbz * meanDbz;
+            for (size_t ii = dbzVals.size(); ii < nKernel; ii++) {
+              sum += minSq;
+              sumSq += minSq * minSq;
+              nn++;
+            }
+          }
+          double mean = sum / nn;
+          double var = sumSq / nn - (mean * mean);
+          if (var < 0.0) {
+            var = 0.0;
+          }
+          double sdev = sqrt(var);
+          texture[icenter] = sqrt(sdev);
+          
+        } // if (count >= minPtsForTexture)
+        
+      } // ix
+      
+    } // iy
 
+  } // iz
+  
 }
 
 /////////////////////////////////////////////////////////
-// compute the convectivity convectivity
+// compute the convectivity for a tile
 
-void ConvStratFinder::_computeConvectivity()
+void ConvStratFinder::_computeConvectivity(const tile_t &tile)
   
 {
 
   // array pointers
 
-  fl32 *texture3D = _texture3D.dat();
+  const fl32 *texture3D = _texture3D.dat();
   fl32 *convectivity3D = _convectivity3D.dat();
-  fl32 *active2D = _fractionActive.dat();
+  const fl32 *active2D = _fractionActive.dat();
   
-  // loop through the vol
+  // loop through the tile
   
-  size_t index3D = 0;
   double textureRange = _textureLimitHigh - _textureLimitLow;
   double convectivitySlope = 1.0 / textureRange;
   
   for (size_t iz = 0; iz < _zKm.size(); iz++) {
     
-    // loop through a plane
-    
-    size_t index2D = 0;
-    
-    for (size_t iy = 0; iy < _ny; iy++) {
-      for (size_t ix = 0; ix < _nx; ix++, index2D++, index3D++) {
+    for (size_t iy = tile.iy0; iy < tile.iy1; iy++) {
+
+      size_t index2D = tile.ix0 + iy * _nx;
+      size_t index3D = index2D + iz * _nxy;
+      
+      for (size_t ix = tile.ix0; ix < tile.ix1;
+           ix++, index2D++, index3D++) {
         
         fl32 convectivity = _missingFl32;
         if (active2D[index2D] >= _minValidFractionForTexture) {
@@ -553,6 +787,7 @@ void ConvStratFinder::_computeConvectivity()
 
 /////////////////////////////////////////////////////////
 // perform clumping on the convectivity field
+// The clump geometry is computed in the STAGE_CLUMPS stage
 
 void ConvStratFinder::_performClumping()
   
@@ -573,7 +808,6 @@ void ConvStratFinder::_performClumping()
   for (int ii = 0; ii < _nClumps; ii++) {
     const Clump_order *clumpOrder = clumpOrders + ii;
     ClumpGeom *clump = new ClumpGeom(this, clumpOrder);
-    clump->computeGeom();
     _clumps.push_back(clump);
   }
 
@@ -592,18 +826,13 @@ void ConvStratFinder::_freeClumps()
 }
 
 /////////////////////////////////////////////////////////
-// set 3d partition array
+// set 3d partition array for a tile
+// The convective clumps have already been set
 
-void ConvStratFinder::_setPartition3D()
+void ConvStratFinder::_setPartition3D(const tile_t &tile)
   
 {
 
-  // loop through the convective clumps, setting the category
-  
-  for (size_t ii = 0; ii < _clumps.size(); ii++) {
-    _clumps[ii]->setPartition();
-  }
-  
   // set the stratiform categories
 
   ui08 *partition3D = _partition3D.dat();
@@ -615,12 +844,10 @@ void ConvStratFinder::_setPartition3D()
 
   // loop through (x,y)
 
-  int nPtsPlane = _nx * _ny;
-  
-  for (size_t ix = 0; ix < _nx; ix++) {
-    for (size_t iy = 0; iy < _ny; iy++) {
+  for (size_t iy = tile.iy0; iy < tile.iy1; iy++) {
+    for (size_t ix = tile.ix0; ix < tile.ix1; ix++) {
 
-      int offset2D = iy * _nx + ix;
+      size_t offset2D = iy * _nx + ix;
       fl32 shallowHtKm = shallowHtGrid[offset2D];
       fl32 deepHtKm = deepHtGrid[offset2D];
       
@@ -628,7 +855,7 @@ void ConvStratFinder::_setPartition3D()
   
       for (size_t iz = 0; iz < _zKm.size(); iz++) {
         
-        int offset3D = iz * nPtsPlane + offset2D;
+        size_t offset3D = iz * _nxy + offset2D;
 
         // check if we have already assigned a convective category
         
@@ -666,20 +893,18 @@ void ConvStratFinder::_setPartition3D()
         }
 
       } // iz
-    } // iy
-  } // ix
+    } // ix
+  } // iy
   
 }
 
 /////////////////////////////////////////////////////////
-// compute 2D summary fields
+// compute 2D summary fields for a tile
 
-void ConvStratFinder::_set2DFields()
+void ConvStratFinder::_set2DFields(const tile_t &tile)
   
 {
   
-  PMU_auto_register("ConvStratFinder::_set2DFields()");
-
   // get data pointers
   
   ui08 *partition3D = _partition3D.dat();
@@ -694,15 +919,9 @@ void ConvStratFinder::_set2DFields()
 
   // loop through the x/y arrays
   
-  size_t xycenter = 0;
-  for (size_t iy = 0; iy < _ny; iy++) {
-    for (size_t ix = 0; ix < _nx; ix++, xycenter++) {
-      
-      // check for activity
-
-      if (fractionActive[xycenter] < _minValidFractionForTexture) {
-        continue;
-      }
+  for (size_t iy = tile.iy0; iy < tile.iy1; iy++) {
+    size_t xycenter = tile.ix0 + iy * _nx;
+    for (size_t ix = tile.ix0; ix < tile.ix1; ix++, xycenter++) {
       
       // init
 
@@ -712,6 +931,17 @@ void ConvStratFinder::_set2DFields()
       fl32 cTop = _missingFl32;
       fl32 sTop = _missingFl32;
         
+      // check for activity
+
+      if (fractionActive[xycenter] < _minValidFractionForTexture) {
+        partition2D[xycenter] = _missingUi08;
+        texture2D[xycenter] = tMax;
+        convectivity2D[xycenter] = cMax;
+        convTopKm[xycenter] = cTop;
+        stratTopKm[xycenter] = sTop;
+        continue;
+      }
+      
       // loop through the z layers
       
       size_t zcenter = xycenter + _minIz * _nxy;
@@ -839,163 +1069,6 @@ void ConvStratFinder::_printSettings(ostream &out)
 
 }
 
-///////////////////////////////////////////////////////////////
-// ComputeTexture inner class
-//
-// Compute texture for 1 level in a thread
-//
-///////////////////////////////////////////////////////////////
-
-// Constructor
-
-ConvStratFinder::ComputeTexture::ComputeTexture(size_t iz) :
-        TaThread(),
-        _iz(iz)
-{
-  char name[128];
-  sprintf(name, "ComputeTexture-level-%ld", _iz);
-  setThreadName(name);
-  _dbz = NULL;
-  _fractionCovered = NULL;
-  _texture = NULL;
-  _nx = _ny = 0;
-  _nxTexture = _nyTexture = 0;
-}  
-
-
-ConvStratFinder::ComputeTexture::~ComputeTexture() 
-{
-}
-
-// override run method
-// compute texture at each point in plane
-
-void ConvStratFinder::ComputeTexture::run()
-{
-
-  // check for validity
-  
-  if (_dbz == NULL ||
-      _fractionCovered == NULL ||
-      _texture == NULL) {
-    cerr << "ERROR - ComputeTexture::run" << endl;
-    cerr << "  Initialization not complete" << endl;
-    return;
-  }
-  
-  // initialize texture to missing
-
-  for (size_t ii = 0; ii < _nx * _ny; ii++) {
-    _texture[ii] = _missingVal;
-  }
-  
-  // compute texture at each point in the plane
-
-  size_t minPtsForTexture = 
-    (size_t) (_minValidFractionForTexture * _kernelOffsets.size() + 0.5);
-  size_t minPtsForFit = 
-    (size_t) (_minValidFractionForFit * _kernelOffsets.size() + 0.5);
-
-  PlaneFit pfit;
-  
-  for (int iy = _nyTexture; iy < (int) _ny - _nyTexture; iy++) {
-    
-    int icenter = _nxTexture + iy * _nx;
-    
-    for (int ix = _nxTexture; ix < (int) _nx - _nxTexture; ix++, icenter++) {
-      
-      if (_fractionCovered[icenter] < _minValidFractionForTexture) {
-        continue;
-      }
-      if (_dbz[icenter] == _missingVal) {
-        continue;
-      }
-
-      // fit a plane to the reflectivity in a circular kernel around point
-      
-      pfit.clear();
-      size_t count = 0;
-      vector<double> dbzVals;
-      double sumDbz = 0.0;
-      vector<double> xx, yy;
-      for (size_t ii = 0; ii < _kernelOffsets.size(); ii++) {
-        const kernel_t &kern = _kernelOffsets[ii];
-        size_t kk = icenter + kern.offset;
-        double val = _dbz[kk];
-        if (val != _missingVal) {
-          pfit.addPoint(kern.xx, kern.yy, val);
-          dbzVals.push_back(val);
-          xx.push_back(kern.xx);
-          yy.push_back(kern.yy);
-          sumDbz += val;
-          count++;
-        }
-      } // ii
-
-      double meanDbz = sumDbz / count;
-      meanDbz = max(meanDbz, 1.0);
-
-      // check we have sufficient data around this point
-      // for computing the fit
-      
-      if (count >= minPtsForFit) {
-        // fit a plane to the reflectivity
-        if (pfit.performFit() == 0) {
-          // subtract plane fit from dbz values to
-          // remove 2d trends in the data
-          double aa = pfit.getCoeffA();
-          double bb = pfit.getCoeffB();
-          for (size_t ii = 0; ii < dbzVals.size(); ii++) {
-            double delta = aa * xx[ii] + bb * yy[ii];
-            dbzVals[ii] -= delta;
-          }
-        }
-      } // if (count >= minPtsForFit)
-
-      // check we have sufficient data around this point
-      // for computing the texture
-      
-      if (count >= minPtsForTexture) {
-
-        // compute sdev of dbz squared
-        
-        double nn = 0.0;
-        double sum = 0.0;
-        double sumSq = 0.0;
-        for (size_t ii = 0; ii < dbzVals.size(); ii++) {
-          double val = dbzVals[ii];
-          // constrain to positive values
-          val = max(val, 1.0);
-          double dbzSq = val * val;
-          sum += dbzSq;
-          sumSq += dbzSq * dbzSq;
-          nn++;
-        } // ii
-        // for missing points, substitute the mean
-        if (dbzVals.size() < _kernelOffsets.size()) {
-          double minSq = meanDbz * meanDbz;
-          for (size_t ii = dbzVals.size(); ii < _kernelOffsets.size(); ii++) {
-            sum += minSq;
-            sumSq += minSq * minSq;
-            nn++;
-          }
-        }
-        double mean = sum / nn;
-        double var = sumSq / nn - (mean * mean);
-        if (var < 0.0) {
-          var = 0.0;
-        }
-        double sdev = sqrt(var);
-        _texture[icenter] = sqrt(sdev);
-
-      } // if (count >= minPtsForTexture)
-      
-    } // ix
-    
-  } // iy
-  
-}
-
 ///////////////////////////////////////////////////////////////
 // ClumpGeom inner class
 //
@@ -33,6 +33,13 @@
 // ConvStratFinder partitions stratiform and convective regions in a
 // Cartesian radar volume
 //
+// The grid is split into tiles of columns in (x,y), each covering all
+// z levels. The stages are run over the tiles in parallel. Stages
+// which use a neighbourhood read the halo around the tile directly
+// from the shared arrays computed in the previous stage, and each tile
+// writes only its own columns, so the results do not depend on the
+// number of threads.
+//
 /////////////////////////////////////////////////////////////////////
 
 #ifndef ConvStratFinder_HH
@@ -42,6 +49,7 @@
 #include <vector>
 #include <toolsa/TaArray.hh>
 #include <toolsa/TaThread.hh>
+#include <toolsa/TaThreadDoubleQue.hh>
 #include <dataport/port_types.h>
 #include <euclid/GridClumping.hh>
 using namespace std;
@@ -134,6 +142,19 @@ public:
   void setMinGridOverlapForClumping(int val) {
     _minOverlapForClumping = val;
   }
+
+  // set number of threads for clumping the convective regions
+  // if greater than 1, the regions are clumped in parallel
+  
+  void setNThreadsForClumping(int val) {
+    _clumping.setNThreads(val);
+  }
+  
+  // set number of threads for the other stages of the computation.
+  // If greater than 1, the tiles of the grid, and the convective
+  // clumps, are processed in parallel.
+  
+  void setNThreads(int val) { _nThreads = val; }
   
   ////////////////////////////////////////////////////////////////////
   // Radius for texture analysis (km).  We determine the reflectivity
@@ -290,6 +311,10 @@ private:
   bool _debug; // Print debug messages
   bool _verbose; // Print verbose debug messages
 
+  // tile size in (x,y), in grid points
+
+  static const size_t _tileSize;
+
   double _minValidHtKm;
   double _maxValidHtKm;
   double _minValidDbz;
@@ -344,6 +369,33 @@ private:
   GridClumping _clumping;
   int _nClumps;
   vector<ClumpGeom *> _clumps;
+
+  // stages of the computation which are run in parallel
+  
+  typedef enum {
+    STAGE_COL_MAX,     // threshold dbz, column max and echo tops
+    STAGE_TEXTURE,     // fraction active, texture and convectivity
+    STAGE_CLUMPS,      // clump geometry and convective partition
+    STAGE_PARTITION    // stratiform partition and 2D fields
+  } stage_t;
+
+  // tile of columns - the end indices are exclusive
+
+  typedef struct {
+    size_t ix0, ix1;
+    size_t iy0, iy1;
+  } tile_t;
+
+  vector<tile_t> _tiles;
+
+  // input dbz for the current partition
+  
+  const fl32 *_dbzInput;
+  fl32 _dbzInputMissing;
+  
+  // threads
+
+  int _nThreads;
   
   // inputs
   
@@ -378,101 +430,51 @@ private:
   void _initToMissing();
   void _initToMissing(TaArray<fl32> &array, fl32 missingVal);
   void _initToMissing(TaArray<ui08> &array, ui08 missingVal);
-  void _computeColMax();
-  void _finalizePartition();
-  void _computeTexture();
-  void _computeConvectivity();
+  void _computeTiles();
+  void _runStage(stage_t stage, size_t nItems);
+  void _processItems(stage_t stage, int threadNum, int nThreads);
+  void _computeColMax(const tile_t &tile);
+  void _computeTexture(const tile_t &tile);
+  void _computeConvectivity(const tile_t &tile);
   void _performClumping();
   void _freeClumps();
-  void _setPartition3D();
-  void _set2DFields();
+  void _setPartition3D(const tile_t &tile);
+  void _set2DFields(const tile_t &tile);
   void _computeKernels();
   void _printSettings(ostream &out);
 
   /////////////////////////////////////////////////////////
-  // inner class for starting timers in a separate thread
+  // Information passed to each thread
+
+  class ThreadInfo
+  {
+  public:
+    ThreadInfo(ConvStratFinder *finder, stage_t stage,
+               int threadNum, int nThreads) :
+            _finder(finder), _stage(stage),
+            _threadNum(threadNum), _nThreads(nThreads) {}
+    ConvStratFinder *_finder;
+    stage_t _stage;
+    int _threadNum;
+    int _nThreads;
+  };
 
-  class ComputeTexture : public TaThread
-  {  
-    
-  public:   
-    
-    // constructor saves _sd3c pointer
-    
-    ComputeTexture(size_t iz);
-    
-    // destructor
-    
-    virtual ~ComputeTexture();
-    
-    // set parameters
-    
-    void setGridSize(size_t nx, size_t ny)
-    {
-      _nx = nx;
-      _ny = ny;
-    }
-    
-    void setKernelSize(size_t nx, size_t ny)
-    {
-      _nxTexture = nx;
-      _nyTexture = ny;
-    }
-    
-    void setMinValidFractionForTexture(double val)
-    {
-      _minValidFractionForTexture = val;
-    }
-    
-    void setMinValidFractionForFit(double val)
-    {
-      _minValidFractionForFit = val;
-    }
-    
-    void setDbz(const fl32 *dbz,
-                const fl32 *dbzColMax,
-                fl32 missingVal)
-    {
-      _dbz = dbz;
-      _dbzColMax = dbzColMax;
-      _missingVal = missingVal;
-    }
-    
-    void setFractionCovered(const fl32 *frac)
-    {
-      _fractionCovered = frac;
-    }
-    
-    void setKernelOffsets(const vector<kernel_t> &offsets)
-    {
-      _kernelOffsets = offsets;
-    }
-    
-    void setTextureArray(fl32 *texture)
-    {
-      _texture = texture;
-    }
-    
-    // override run method
-    
-    virtual void run();
-    
-  private:
-    
-    size_t _iz;
-    size_t _nx, _ny;
-    int _nxTexture, _nyTexture;
-    double _minValidFractionForTexture;
-    double _minValidFractionForFit;
-    fl32 _missingVal;
-    const fl32 *_dbz;
-    const fl32 *_dbzColMax;
-    const fl32 *_fractionCovered;
-    fl32 *_texture;
-    vector<kernel_t> _kernelOffsets;
-    
+  static void _threadMethod(void *threadData);
+
+  /////////////////////////////////////////////////////////
+  // Thread que for the stages
+
+  class ConvStratThreads : public TaThreadDoubleQue
+  {
+  public:
+    inline ConvStratThreads() : TaThreadDoubleQue() {}
+    inline virtual ~ConvStratThreads() {}
+    TaThread *clone(int index);
   };
 
+  ConvStratThreads *_threads;
+  int _nThreadsInQue;
+
   /////////////////////////////////////////////////////////
   // inner class for clump geometry
 
@@ -0,0 +1,166 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////////
+// TitanMappedFile.cc
+//
+// Read-only memory mapping of TITAN storm and track files.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#include <titan/TitanMappedFile.hh>
+#include <toolsa/TaStr.hh>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+using namespace std;
+
+#if defined(__APPLE__)
+#define TITAN_ST_CTIME(st) ((st).st_ctimespec)
+#else
+#define TITAN_ST_CTIME(st) ((st).st_ctim)
+#endif
+
+////////////////////////////////////////////////////////////
+// Constructor
+
+TitanMappedFile::TitanMappedFile()
+
+{
+  _isMapped = false;
+  _ptr = NULL;
+  _size = 0;
+  _dev = 0;
+  _ino = 0;
+  _fileSize = 0;
+  _mtime = 0;
+  memset(&_ctime, 0, sizeof(_ctime));
+}
+
+////////////////////////////////////////////////////////////
+// destructor
+
+TitanMappedFile::~TitanMappedFile()
+
+{
+  unmap();
+}
+
+////////////////////////////////////////////////////////////
+// map the file, read-only
+// returns 0 on success, -1 on failure
+
+int TitanMappedFile::map(const string &path)
+
+{
+
+  unmap();
+  _errStr = "ERROR - TitanMappedFile::map\n";
+  TaStr::AddStr(_errStr, "  File: ", path);
+  _path = path;
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  Cannot open file: ", strerror(errNum));
+    return -1;
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat)) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  Cannot stat file: ", strerror(errNum));
+    close(fd);
+    return -1;
+  }
+
+  _dev = fileStat.st_dev;
+  _ino = fileStat.st_ino;
+  _fileSize = fileStat.st_size;
+  _mtime = fileStat.st_mtime;
+  _ctime = TITAN_ST_CTIME(fileStat);
+  _size = fileStat.st_size;
+
+  // empty files cannot be mapped - treat as mapped with no data
+
+  if (_size == 0) {
+    close(fd);
+    _isMapped = true;
+    return 0;
+  }
+
+  void *addr = mmap(NULL, _size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  Cannot mmap file: ", strerror(errNum));
+    _size = 0;
+    return -1;
+  }
+
+  _ptr = (char *) addr;
+  _isMapped = true;
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// unmap the file
+
+void TitanMappedFile::unmap()
+
+{
+  if (_ptr != NULL) {
+    munmap(_ptr, _size);
+  }
+  _ptr = NULL;
+  _size = 0;
+  _isMapped = false;
+}
+
+////////////////////////////////////////////////////////////
+// has the file on disk changed since it was mapped?
+
+bool TitanMappedFile::changed() const
+
+{
+  if (!_isMapped) {
+    return true;
+  }
+  struct stat fileStat;
+  if (stat(_path.c_str(), &fileStat)) {
+    return true;
+  }
+  return (fileStat.st_dev != _dev ||
+          fileStat.st_ino != _ino ||
+          fileStat.st_size != _fileSize ||
+          fileStat.st_mtime != _mtime ||
+          TITAN_ST_CTIME(fileStat).tv_sec != _ctime.tv_sec ||
+          TITAN_ST_CTIME(fileStat).tv_nsec != _ctime.tv_nsec);
+}
+
@@ -0,0 +1,322 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////////
+// TitanStormFileMap.cc
+//
+// Read-only, memory-mapped access to a TITAN storm file.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#include <titan/TitanStormFileMap.hh>
+#include <titan/TitanStormFile.hh>
+#include <toolsa/TaStr.hh>
+#include <toolsa/mem.h>
+#include <algorithm>
+using namespace std;
+
+////////////////////////////////////////////////////////////
+// Constructor
+
+TitanStormFileMap::TitanStormFileMap()
+
+{
+  MEM_zero(_header);
+}
+
+////////////////////////////////////////////////////////////
+// destructor
+
+TitanStormFileMap::~TitanStormFileMap()
+
+{
+  close();
+}
+
+////////////////////////////////////////////////////////////
+// Open the storm file, given the header file path.
+// returns 0 on success, -1 on failure
+
+int TitanStormFileMap::open(const string &header_file_path)
+
+{
+
+  close();
+  _errStr = "ERROR - TitanStormFileMap::open\n";
+
+  // use TitanStormFile to check the labels, read the header
+  // and find the data file, uncompressing if required
+
+  TitanStormFile sfile;
+  if (sfile.OpenFiles("r", header_file_path.c_str())) {
+    _errStr += sfile.getErrStr();
+    return -1;
+  }
+  _header = sfile.header();
+  _scanOffsets.assign(sfile.scan_offsets(),
+                      sfile.scan_offsets() + _header.n_scans);
+  _headerFilePath = sfile.header_file_path();
+  _dataFilePath = sfile.data_file_path();
+  sfile.CloseFiles();
+
+  // map the data file
+  
+  if (_dataMap.map(_dataFilePath)) {
+    _errStr += _dataMap.getErrStr();
+    return -1;
+  }
+
+  // build the time index from the scan headers
+
+  _scanTimes.resize(_scanOffsets.size());
+  for (size_t ii = 0; ii < _scanOffsets.size(); ii++) {
+    storm_file_scan_header_t scan;
+    if (getScan(ii, scan)) {
+      close();
+      return -1;
+    }
+    _scanTimes[ii] = scan.time;
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// close
+
+void TitanStormFileMap::close()
+
+{
+  _dataMap.unmap();
+  _scanOffsets.clear();
+  _scanTimes.clear();
+  MEM_zero(_header);
+}
+
+////////////////////////////////////////////////////////////
+// have the files changed on disk since opening?
+
+bool TitanStormFileMap::filesChanged() const
+
+{
+  return _dataMap.changed();
+}
+
+////////////////////////////////////////////////////////////
+// time of given scan, -1 if scan_num is not valid
+
+time_t TitanStormFileMap::scanTime(int scan_num) const
+
+{
+  if (scan_num < 0 || scan_num >= (int) _scanTimes.size()) {
+    return -1;
+  }
+  return _scanTimes[scan_num];
+}
+
+////////////////////////////////////////////////////////////
+// find the last scan at or before the given time
+// returns scan_num, or -1 if none
+
+int TitanStormFileMap::findScanBefore(time_t search_time) const
+
+{
+  vector<time_t>::const_iterator it =
+    upper_bound(_scanTimes.begin(), _scanTimes.end(), search_time);
+  return (int) (it - _scanTimes.begin()) - 1;
+}
+
+////////////////////////////////////////////////////////////
+// find the scan closest to the given time, within the time margin
+// returns scan_num, or -1 if none
+
+int TitanStormFileMap::findScanClosest(time_t search_time,
+                                       int time_margin) const
+
+{
+
+  int before = findScanBefore(search_time);
+  int after = before + 1;
+  
+  int best = -1;
+  time_t bestDiff = 0;
+  if (before >= 0) {
+    best = before;
+    bestDiff = search_time - _scanTimes[before];
+  }
+  if (after < (int) _scanTimes.size()) {
+    time_t diff = _scanTimes[after] - search_time;
+    if (best < 0 || diff < bestDiff) {
+      best = after;
+      bestDiff = diff;
+    }
+  }
+
+  if (best < 0 || bestDiff > time_margin) {
+    return -1;
+  }
+  return best;
+
+}
+
+////////////////////////////////////////////////////////////
+// get scan header
+// Returns 0 on success, -1 on failure.
+
+int TitanStormFileMap::getScan(int scan_num,
+                               storm_file_scan_header_t &scan) const
+
+{
+
+  if (scan_num < 0 || scan_num >= (int) _scanOffsets.size()) {
+    _errStr = "ERROR - TitanStormFileMap::getScan\n";
+    TaStr::AddInt(_errStr, "  Scan number out of range: ", scan_num);
+    return -1;
+  }
+
+  long offset = _scanOffsets[scan_num];
+  if (!_dataMap.inRange(offset, sizeof(scan))) {
+    _errStr = "ERROR - TitanStormFileMap::getScan\n";
+    TaStr::AddStr(_errStr, "  File: ", _dataFilePath);
+    TaStr::AddInt(_errStr, "  Scan offset beyond end of file: ", offset);
+    return -1;
+  }
+
+  // decode the scan struct from network byte order into host byte order
+  // the chars at the end are not swapped
+
+  memcpy(&scan, _dataMap.ptr() + offset, sizeof(scan));
+  si32 nbytes_char = scan.nbytes_char;
+  BE_to_array_32(&nbytes_char, sizeof(si32));
+  BE_to_array_32(&scan, (sizeof(storm_file_scan_header_t) - nbytes_char));
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// global props for all storms in a scan
+// Returns 0 on success, -1 on failure.
+
+int TitanStormFileMap::getGprops
+  (const storm_file_scan_header_t &scan,
+   TitanBeArray<storm_file_global_props_t> &gprops) const
+
+{
+  return _getArray(scan.gprops_offset, scan.nstorms, "gprops", gprops);
+}
+
+////////////////////////////////////////////////////////////
+// global props for a single storm
+// Returns 0 on success, -1 on failure.
+
+int TitanStormFileMap::getGprops(int scan_num, int storm_num,
+                                 storm_file_global_props_t &gprops) const
+
+{
+  storm_file_scan_header_t scan;
+  if (getScan(scan_num, scan)) {
+    return -1;
+  }
+  if (storm_num < 0 || storm_num >= scan.nstorms) {
+    _errStr = "ERROR - TitanStormFileMap::getGprops\n";
+    TaStr::AddInt(_errStr, "  Scan number: ", scan_num);
+    TaStr::AddInt(_errStr, "  Storm number out of range: ", storm_num);
+    return -1;
+  }
+  TitanBeArray<storm_file_global_props_t> array;
+  if (getGprops(scan, array)) {
+    return -1;
+  }
+  gprops = array[storm_num];
+  return 0;
+}
+
+////////////////////////////////////////////////////////////
+// secondary props for a storm
+// Returns 0 on success, -1 on failure.
+
+int TitanStormFileMap::getLprops
+  (const storm_file_global_props_t &gprops,
+   TitanBeArray<storm_file_layer_props_t> &lprops) const
+
+{
+  return _getArray(gprops.layer_props_offset, gprops.n_layers,
+                   "lprops", lprops);
+}
+  
+int TitanStormFileMap::getHist
+  (const storm_file_global_props_t &gprops,
+   TitanBeArray<storm_file_dbz_hist_t> &hist) const
+
+{
+  return _getArray(gprops.dbz_hist_offset, gprops.n_dbz_intervals,
+                   "hist", hist);
+}
+  
+int TitanStormFileMap::getRuns
+  (const storm_file_global_props_t &gprops,
+   TitanBeArray<storm_file_run_t, 2> &runs) const
+
+{
+  return _getArray(gprops.runs_offset, gprops.n_runs, "runs", runs);
+}
+
+int TitanStormFileMap::getProjRuns
+  (const storm_file_global_props_t &gprops,
+   TitanBeArray<storm_file_run_t, 2> &proj_runs) const
+
+{
+  return _getArray(gprops.proj_runs_offset, gprops.n_proj_runs,
+                   "proj_runs", proj_runs);
+}
+
+////////////////////////////////////////////////////////////
+// set up view onto an array in the data file
+// Returns 0 on success, -1 on failure.
+
+template <class T, int WORD_BYTES>
+  int TitanStormFileMap::_getArray(long offset, int n_elem,
+                                   const char *label,
+                                   TitanBeArray<T, WORD_BYTES> &array) const
+
+{
+  if (n_elem <= 0) {
+    array = TitanBeArray<T, WORD_BYTES>();
+    return 0;
+  }
+  if (!_dataMap.inRange(offset, n_elem * sizeof(T))) {
+    _errStr = "ERROR - TitanStormFileMap::_getArray\n";
+    TaStr::AddStr(_errStr, "  File: ", _dataFilePath);
+    TaStr::AddStr(_errStr, "  Array beyond end of file: ", label);
+    TaStr::AddInt(_errStr, "  Offset: ", offset);
+    TaStr::AddInt(_errStr, "  N elements: ", n_elem);
+    return -1;
+  }
+  array = TitanBeArray<T, WORD_BYTES>(_dataMap.ptr() + offset, n_elem);
+  return 0;
+}
+
@@ -45,6 +45,10 @@
 #include <toolsa/str.h>
 #include <toolsa/pjg.h>
 #include <toolsa/TaArray.hh>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 using namespace std;
 
 ////////////////////////////////////////////////////////////
@@ -75,6 +79,8 @@ TitanTrackFile::TitanTrackFile()
 
   _header_file = NULL;
   _data_file = NULL;
+  _undo_file = NULL;
+  _undo_data_len = 0;
 
   _first_entry = true;
 
@@ -120,6 +126,56 @@ void TitanTrackFile::_clearErrStr()
   TaStr::AddStr(_errStr, "ERROR at time: ", DateTime::str());
 }
 
+//////////////////////////////////////////////////////////////
+// save the contents of a region of the data file to the undo
+// file, before it is rewritten. Only the part below the data
+// length at the time the undo file was opened is saved - data
+// beyond that is removed by truncation on rollback.
+// returns 0 on success, -1 on failure
+
+int TitanTrackFile::_saveUndo(long offset, int nbytes)
+
+{
+
+  if (_undo_file == NULL || offset >= _undo_data_len) {
+    return 0;
+  }
+  if (offset + nbytes > _undo_data_len) {
+    nbytes = _undo_data_len - offset;
+  }
+
+  // read the current contents
+
+  fflush(_data_file);
+  TaArray<char> buf_;
+  char *buf = buf_.alloc(nbytes);
+  if (pread(fileno(_data_file), buf, nbytes, offset) != nbytes) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  Reading data for undo file: ", _undo_file_path);
+    TaStr::AddInt(_errStr, "  offset: ", offset);
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    return -1;
+  }
+
+  // write the record, flushing it before the data is rewritten
+
+  si32 rec[2];
+  rec[0] = offset;
+  rec[1] = nbytes;
+  BE_from_array_32(rec, sizeof(rec));
+  if (ufwrite(rec, sizeof(rec), 1, _undo_file) != 1 ||
+      ufwrite(buf, 1, nbytes, _undo_file) != nbytes ||
+      fflush(_undo_file)) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  Writing undo file: ", _undo_file_path);
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    return -1;
+  }
+
+  return 0;
+
+}
+
 #define N_ALLOC 20
 
 ///////////////////////////////////////////////////////////////////////////
@@ -679,6 +735,10 @@ void TitanTrackFile::CloseFiles()
     _data_file = (FILE *) NULL;
   }
   
+  // close the undo file
+
+  CloseUndoFile();
+
 }
 
 //////////////////////////////////////////////////////////////
@@ -696,6 +756,219 @@ void TitanTrackFile::FlushFiles()
 
 }
 
+//////////////////////////////////////////////////////////////
+//
+// Open an undo file for the track data file.
+//
+// The file starts with the current length of the data file.
+// Each record which follows holds the offset and length of a
+// region of the data file, followed by its contents before it
+// was rewritten. All values are stored big-endian.
+//
+// returns 0 on success, -1 on failure
+//
+//////////////////////////////////////////////////////////////
+
+int TitanTrackFile::OpenUndoFile(const char *undo_file_path)
+  
+{
+
+  _clearErrStr();
+  _errStr += "ERROR - TitanTrackFile::OpenUndoFile\n";
+  TaStr::AddStr(_errStr, "  Undo file: ", undo_file_path);
+
+  CloseUndoFile();
+
+  if (_data_file == NULL) {
+    _errStr += "  Data file not open\n";
+    return -1;
+  }
+
+  // get the data file length
+
+  fflush(_data_file);
+  if (fseek(_data_file, 0L, SEEK_END)) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  Cannot seek data file: ", _data_file_path);
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    return -1;
+  }
+  long data_len = ftell(_data_file);
+
+  // create the undo file, with the data file length
+
+  if ((_undo_file = fopen(undo_file_path, "w")) == NULL) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  ", "Cannot create undo file");
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    return -1;
+  }
+
+  si32 len = data_len;
+  BE_from_array_32(&len, sizeof(len));
+  if (ufwrite(&len, sizeof(len), 1, _undo_file) != 1 ||
+      fflush(_undo_file)) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  ", "Cannot write undo file");
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    CloseUndoFile();
+    return -1;
+  }
+
+  _undo_file_path = undo_file_path;
+  _undo_data_len = data_len;
+
+  return 0;
+
+}
+
+//////////////////////////////////////////////////////////////
+//
+// Close the undo file
+//
+//////////////////////////////////////////////////////////////
+
+void TitanTrackFile::CloseUndoFile()
+  
+{
+
+  if (_undo_file != NULL) {
+    fclose(_undo_file);
+    _undo_file = (FILE *) NULL;
+  }
+  _undo_file_path.clear();
+  _undo_data_len = 0;
+
+}
+
+//////////////////////////////////////////////////////////////
+//
+// Roll back a data file using an undo file.
+//
+// The records are applied in reverse order, so that if a region
+// was rewritten more than once the earliest contents are restored.
+// A partial record at the end of the undo file is ignored - it is
+// flushed before the rewrite, so the rewrite did not happen.
+//
+// returns 0 on success, -1 on failure
+//
+//////////////////////////////////////////////////////////////
+
+int TitanTrackFile::RollbackData(const char *data_file_path,
+                                 const char *undo_file_path)
+  
+{
+
+  _clearErrStr();
+  _errStr += "ERROR - TitanTrackFile::RollbackData\n";
+  TaStr::AddStr(_errStr, "  Data file: ", data_file_path);
+  TaStr::AddStr(_errStr, "  Undo file: ", undo_file_path);
+
+  // read in the undo file
+
+  FILE *undo_file;
+  if ((undo_file = fopen(undo_file_path, "r")) == NULL) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  ", "Cannot open undo file");
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    return -1;
+  }
+
+  si32 data_len;
+  if (ufread(&data_len, sizeof(data_len), 1, undo_file) != 1) {
+    _errStr += "  Cannot read data length from undo file\n";
+    fclose(undo_file);
+    return -1;
+  }
+  BE_to_array_32(&data_len, sizeof(data_len));
+
+  vector<si32> offsets;
+  vector<si32> lens;
+  vector<long> positions;
+  si32 rec[2];
+  while (ufread(rec, sizeof(rec), 1, undo_file) == 1) {
+    BE_to_array_32(rec, sizeof(rec));
+    long pos = ftell(undo_file);
+    if (rec[0] < 0 || rec[1] <= 0 ||
+        fseek(undo_file, rec[1], SEEK_CUR)) {
+      break;
+    }
+    offsets.push_back(rec[0]);
+    lens.push_back(rec[1]);
+    positions.push_back(pos);
+  }
+
+  // the last record may be incomplete
+
+  struct stat undo_stat;
+  if (fstat(fileno(undo_file), &undo_stat)) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  ", "Cannot stat undo file");
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    fclose(undo_file);
+    return -1;
+  }
+  if (positions.size() > 0 &&
+      positions.back() + lens.back() > undo_stat.st_size) {
+    offsets.pop_back();
+    lens.pop_back();
+    positions.pop_back();
+  }
+
+  // open the data file, check it is at least as long as
+  // when the undo file was started
+
+  int data_fd = open(data_file_path, O_RDWR);
+  if (data_fd < 0) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  ", "Cannot open data file");
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    fclose(undo_file);
+    return -1;
+  }
+  struct stat data_stat;
+  if (fstat(data_fd, &data_stat) || data_stat.st_size < data_len) {
+    _errStr += "  Data file is shorter than when undo file was started\n";
+    TaStr::AddInt(_errStr, "  Undo data len: ", data_len);
+    close(data_fd);
+    fclose(undo_file);
+    return -1;
+  }
+
+  // restore in reverse order
+
+  int iret = 0;
+  for (int ii = (int) offsets.size() - 1; ii >= 0; ii--) {
+    TaArray<char> buf_;
+    char *buf = buf_.alloc(lens[ii]);
+    if (fseek(undo_file, positions[ii], SEEK_SET) ||
+        ufread(buf, 1, lens[ii], undo_file) != lens[ii] ||
+        pwrite(data_fd, buf, lens[ii], offsets[ii]) != lens[ii]) {
+      int errNum = errno;
+      TaStr::AddInt(_errStr, "  Cannot restore data at offset: ",
+                    offsets[ii]);
+      TaStr::AddStr(_errStr, "  ", strerror(errNum));
+      iret = -1;
+      break;
+    }
+  }
+
+  // truncate
+
+  if (iret == 0 && ftruncate(data_fd, data_len)) {
+    int errNum = errno;
+    TaStr::AddStr(_errStr, "  ", "Cannot truncate data file");
+    TaStr::AddStr(_errStr, "  ", strerror(errNum));
+    iret = -1;
+  }
+
+  close(data_fd);
+  fclose(undo_file);
+
+  return iret;
+
+}
+
 //////////////////////////////////////////////////////////////
 //
 // TitanTrackFile::LockHeaderFile()
@@ -1488,6 +1761,12 @@ int TitanTrackFile::RewriteEntry()
   track_file_entry_t entry = _entry;
   BE_to_array_32(&entry, sizeof(track_file_entry_t));
   
+  // save the previous entry for undo
+
+  if (_saveUndo(_entry.this_entry_offset, sizeof(track_file_entry_t))) {
+    return -1;
+  }
+
   // move to entry offset
   
   fseek(_data_file, _entry.this_entry_offset, SEEK_SET);
@@ -1829,9 +2108,14 @@ int TitanTrackFile::WriteSimpleParams(int track_num)
   BE_from_array_32(&simple_params,
 		   sizeof(simple_track_params_t));
   
-  // for rewrite, move to stored offset
+  // for rewrite, save the previous params for undo, and move
+  // to stored offset
   
   if (rewrite) {
+    if (_saveUndo(_simple_track_offsets[track_num],
+                  sizeof(simple_track_params_t))) {
+      return -1;
+    }
     fseek(_data_file, _simple_track_offsets[track_num], SEEK_SET);
   }
   
@@ -1920,6 +2204,15 @@ int TitanTrackFile::WriteComplexParams(int track_num)
     
   }
   
+  // save the previous contents of a reused slot or a rewrite
+  // for undo, then go back to the offset
+
+  long params_offset = ftell(_data_file);
+  if (_saveUndo(params_offset, sizeof(complex_track_params_t))) {
+    return -1;
+  }
+  fseek(_data_file, params_offset, SEEK_SET);
+
   // copy track params, encode and write to file
   
   complex_track_params_t complex_params = _complex_params;
@@ -1977,6 +2270,12 @@ long TitanTrackFile::WriteEntry(int prev_in_track_offset,
   
   if (prev_in_track_offset != 0) {
     
+    // save the entry for undo
+
+    if (_saveUndo(prev_in_track_offset, sizeof(track_file_entry_t))) {
+      return -1;
+    }
+
     // move to the entry prev_in_track_offset in the file
     
     fseek(_data_file, prev_in_track_offset, SEEK_SET);
@@ -2025,6 +2324,12 @@ long TitanTrackFile::WriteEntry(int prev_in_track_offset,
   
   if (prev_in_scan_offset != 0) {
     
+    // save the entry for undo
+
+    if (_saveUndo(prev_in_scan_offset, sizeof(track_file_entry_t))) {
+      return -1;
+    }
+
     // move to the entry prev_in_scan_offset in the file
     
     fseek(_data_file, prev_in_scan_offset, SEEK_SET);
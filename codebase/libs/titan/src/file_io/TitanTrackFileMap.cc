@@ -0,0 +1,501 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////////
+// TitanTrackFileMap.cc
+//
+// Read-only, memory-mapped access to a TITAN track file.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#include <titan/TitanTrackFileMap.hh>
+#include <titan/TitanTrackFile.hh>
+#include <toolsa/TaStr.hh>
+#include <toolsa/mem.h>
+using namespace std;
+
+////////////////////////////////////////////////////////////
+// Constructor
+
+TitanTrackFileMap::TitanTrackFileMap()
+
+{
+  _complexIndexBuilt = false;
+  MEM_zero(_header);
+}
+
+////////////////////////////////////////////////////////////
+// destructor
+
+TitanTrackFileMap::~TitanTrackFileMap()
+
+{
+  close();
+}
+
+////////////////////////////////////////////////////////////
+// Open the track file, given the header file path.
+// returns 0 on success, -1 on failure
+
+int TitanTrackFileMap::open(const string &header_file_path)
+
+{
+
+  close();
+  _errStr = "ERROR - TitanTrackFileMap::open\n";
+
+  // use TitanTrackFile to check the labels, read the header arrays
+  // and find the data file, uncompressing if required
+
+  TitanTrackFile tfile;
+  if (tfile.OpenFiles("r", header_file_path.c_str())) {
+    _errStr += tfile.getErrStr();
+    return -1;
+  }
+  _header = tfile.header();
+  int nComplex = _header.n_complex_tracks;
+  int nSimple = _header.n_simple_tracks;
+  int nScans = _header.n_scans;
+  _complexTrackNums.assign(tfile.complex_track_nums(),
+                           tfile.complex_track_nums() + nComplex);
+  _complexTrackOffsets.assign(tfile.complex_track_offsets(),
+                              tfile.complex_track_offsets() + nSimple);
+  _simpleTrackOffsets.assign(tfile.simple_track_offsets(),
+                             tfile.simple_track_offsets() + nSimple);
+  _scanIndex.assign(tfile.scan_index(), tfile.scan_index() + nScans);
+  _nsimplesPerComplex.assign(tfile.nsimples_per_complex(),
+                             tfile.nsimples_per_complex() + nSimple);
+  _simplesPerComplexOffsets.assign
+    (tfile.simples_per_complex_offsets(),
+     tfile.simples_per_complex_offsets() + nSimple);
+  _headerFilePath = tfile.header_file_path();
+  _dataFilePath = tfile.data_file_path();
+  tfile.CloseFiles();
+
+  // map the files
+  
+  if (_headerMap.map(_headerFilePath)) {
+    _errStr += _headerMap.getErrStr();
+    close();
+    return -1;
+  }
+  if (_dataMap.map(_dataFilePath)) {
+    _errStr += _dataMap.getErrStr();
+    close();
+    return -1;
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// close
+
+void TitanTrackFileMap::close()
+
+{
+  _headerMap.unmap();
+  _dataMap.unmap();
+  _complexTrackNums.clear();
+  _complexTrackOffsets.clear();
+  _simpleTrackOffsets.clear();
+  _scanIndex.clear();
+  _nsimplesPerComplex.clear();
+  _simplesPerComplexOffsets.clear();
+  _complexIndexBuilt = false;
+  _complexEntryStart.clear();
+  _complexEntryOffsets.clear();
+  MEM_zero(_header);
+}
+
+////////////////////////////////////////////////////////////
+// have the files changed on disk since opening?
+
+bool TitanTrackFileMap::filesChanged() const
+
+{
+  return (_headerMap.changed() || _dataMap.changed());
+}
+
+////////////////////////////////////////////////////////////
+// time of given scan, -1 if scan_num is not valid
+
+time_t TitanTrackFileMap::scanTime(int scan_num) const
+
+{
+  if (scan_num < 0 || scan_num >= (int) _scanIndex.size()) {
+    return -1;
+  }
+  return _scanIndex[scan_num].utime;
+}
+
+////////////////////////////////////////////////////////////
+// find the last scan at or before the given time
+// returns scan_num, or -1 if none
+
+int TitanTrackFileMap::findScanBefore(time_t search_time) const
+
+{
+
+  // binary search on the scan index times
+
+  int lower = 0;
+  int upper = (int) _scanIndex.size();
+  while (lower < upper) {
+    int mid = (lower + upper) / 2;
+    if (_scanIndex[mid].utime <= search_time) {
+      lower = mid + 1;
+    } else {
+      upper = mid;
+    }
+  }
+  return lower - 1;
+
+}
+
+////////////////////////////////////////////////////////////
+// find the scan closest to the given time, within the time margin
+// returns scan_num, or -1 if none
+
+int TitanTrackFileMap::findScanClosest(time_t search_time,
+                                       int time_margin) const
+
+{
+
+  int before = findScanBefore(search_time);
+  int after = before + 1;
+  
+  int best = -1;
+  time_t bestDiff = 0;
+  if (before >= 0) {
+    best = before;
+    bestDiff = search_time - _scanIndex[before].utime;
+  }
+  if (after < (int) _scanIndex.size()) {
+    time_t diff = _scanIndex[after].utime - search_time;
+    if (best < 0 || diff < bestDiff) {
+      best = after;
+      bestDiff = diff;
+    }
+  }
+
+  if (best < 0 || bestDiff > time_margin) {
+    return -1;
+  }
+  return best;
+
+}
+
+////////////////////////////////////////////////////////////
+// get complex track params
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getComplexParams(int complex_num,
+                                        complex_track_params_t &params) const
+
+{
+
+  if (complex_num < 0 || complex_num >= (int) _complexTrackOffsets.size()) {
+    _errStr = "ERROR - TitanTrackFileMap::getComplexParams\n";
+    TaStr::AddInt(_errStr, "  Complex num out of range: ", complex_num);
+    return -1;
+  }
+
+  long offset = _complexTrackOffsets[complex_num];
+  if (offset <= 0 || !_dataMap.inRange(offset, sizeof(params))) {
+    _errStr = "ERROR - TitanTrackFileMap::getComplexParams\n";
+    TaStr::AddStr(_errStr, "  File: ", _dataFilePath);
+    TaStr::AddInt(_errStr, "  Complex num: ", complex_num);
+    TaStr::AddInt(_errStr, "  Bad offset: ", offset);
+    return -1;
+  }
+
+  memcpy(&params, _dataMap.ptr() + offset, sizeof(params));
+  BE_to_array_32(&params, sizeof(params));
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// get simple track params
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getSimpleParams(int simple_num,
+                                       simple_track_params_t &params) const
+
+{
+
+  if (simple_num < 0 || simple_num >= (int) _simpleTrackOffsets.size()) {
+    _errStr = "ERROR - TitanTrackFileMap::getSimpleParams\n";
+    TaStr::AddInt(_errStr, "  Simple num out of range: ", simple_num);
+    return -1;
+  }
+
+  long offset = _simpleTrackOffsets[simple_num];
+  if (!_dataMap.inRange(offset, sizeof(params))) {
+    _errStr = "ERROR - TitanTrackFileMap::getSimpleParams\n";
+    TaStr::AddStr(_errStr, "  File: ", _dataFilePath);
+    TaStr::AddInt(_errStr, "  Simple num: ", simple_num);
+    TaStr::AddInt(_errStr, "  Bad offset: ", offset);
+    return -1;
+  }
+
+  memcpy(&params, _dataMap.ptr() + offset, sizeof(params));
+  BE_to_array_32(&params, sizeof(params));
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// simple track numbers for a complex track
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getSimplesPerComplex(int complex_num,
+                                            TitanBeArray<si32> &simples) const
+
+{
+
+  if (complex_num < 0 || complex_num >= (int) _nsimplesPerComplex.size()) {
+    _errStr = "ERROR - TitanTrackFileMap::getSimplesPerComplex\n";
+    TaStr::AddInt(_errStr, "  Complex num out of range: ", complex_num);
+    return -1;
+  }
+
+  int nsimples = _nsimplesPerComplex[complex_num];
+  long offset = _simplesPerComplexOffsets[complex_num];
+  if (nsimples < 0 ||
+      !_headerMap.inRange(offset, nsimples * sizeof(si32))) {
+    _errStr = "ERROR - TitanTrackFileMap::getSimplesPerComplex\n";
+    TaStr::AddStr(_errStr, "  File: ", _headerFilePath);
+    TaStr::AddInt(_errStr, "  Complex num: ", complex_num);
+    TaStr::AddInt(_errStr, "  Bad offset: ", offset);
+    return -1;
+  }
+
+  simples = TitanBeArray<si32>(_headerMap.ptr() + offset, nsimples);
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// entry at given offset in data file
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getEntry(long offset,
+                                track_file_entry_t &entry) const
+
+{
+  if (offset <= 0 || !_dataMap.inRange(offset, sizeof(entry))) {
+    _errStr = "ERROR - TitanTrackFileMap::getEntry\n";
+    TaStr::AddStr(_errStr, "  File: ", _dataFilePath);
+    TaStr::AddInt(_errStr, "  Bad entry offset: ", offset);
+    return -1;
+  }
+  memcpy(&entry, _dataMap.ptr() + offset, sizeof(entry));
+  BE_to_array_32(&entry, sizeof(entry));
+  return 0;
+}
+
+////////////////////////////////////////////////////////////
+// all entries for a simple track, in time order
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getSimpleEntries(const simple_track_params_t &params,
+                                        vector<track_file_entry_t> &entries) const
+
+{
+
+  entries.resize(params.duration_in_scans);
+  long offset = params.first_entry_offset;
+  for (int ii = 0; ii < params.duration_in_scans; ii++) {
+    if (getEntry(offset, entries[ii])) {
+      TaStr::AddInt(_errStr, "  Simple track num: ",
+                    params.simple_track_num);
+      entries.clear();
+      return -1;
+    }
+    offset = entries[ii].next_entry_offset;
+  }
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// all entries for a scan
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getScanEntries(int scan_num,
+                                      vector<track_file_entry_t> &entries) const
+
+{
+
+  entries.clear();
+  if (scan_num < 0 || scan_num >= (int) _scanIndex.size()) {
+    _errStr = "ERROR - TitanTrackFileMap::getScanEntries\n";
+    TaStr::AddInt(_errStr, "  Scan num out of range: ", scan_num);
+    return -1;
+  }
+
+  const track_file_scan_index_t &sindex = _scanIndex[scan_num];
+  entries.resize(sindex.n_entries);
+  long offset = sindex.first_entry_offset;
+  for (int ii = 0; ii < sindex.n_entries; ii++) {
+    if (getEntry(offset, entries[ii])) {
+      TaStr::AddInt(_errStr, "  Scan num: ", scan_num);
+      entries.clear();
+      return -1;
+    }
+    offset = entries[ii].next_scan_entry_offset;
+  }
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// all entries for a complex track, in scan order
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getComplexEntries(int complex_num,
+                                         vector<track_file_entry_t> &entries) const
+
+{
+
+  entries.clear();
+  if (!_complexIndexBuilt) {
+    _errStr = "ERROR - TitanTrackFileMap::getComplexEntries\n";
+    if (_buildComplexIndex()) {
+      return -1;
+    }
+  }
+  if (complex_num < 0 ||
+      complex_num + 1 >= (int) _complexEntryStart.size()) {
+    _errStr = "ERROR - TitanTrackFileMap::getComplexEntries\n";
+    TaStr::AddInt(_errStr, "  Complex num out of range: ", complex_num);
+    return -1;
+  }
+
+  int start = _complexEntryStart[complex_num];
+  int end = _complexEntryStart[complex_num + 1];
+  entries.resize(end - start);
+  for (int ii = start; ii < end; ii++) {
+    if (getEntry(_complexEntryOffsets[ii], entries[ii - start])) {
+      entries.clear();
+      return -1;
+    }
+  }
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// start and end times of the tracks
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::getUtime(vector<track_utime_t> &track_utime) const
+
+{
+
+  track_utime_t zero;
+  MEM_zero(zero);
+  track_utime.assign(_header.max_simple_track_num + 1, zero);
+
+  for (size_t itrack = 0; itrack < _complexTrackNums.size(); itrack++) {
+    int complex_num = _complexTrackNums[itrack];
+    complex_track_params_t cparams;
+    if (complex_num >= (int) track_utime.size() ||
+        getComplexParams(complex_num, cparams)) {
+      return -1;
+    }
+    track_utime[complex_num].start_complex = cparams.start_time;
+    track_utime[complex_num].end_complex = cparams.end_time;
+  }
+
+  for (int simple_num = 0; simple_num < _header.n_simple_tracks;
+       simple_num++) {
+    simple_track_params_t sparams;
+    if (simple_num >= (int) track_utime.size() ||
+        getSimpleParams(simple_num, sparams)) {
+      return -1;
+    }
+    track_utime[simple_num].start_simple = sparams.start_time;
+    track_utime[simple_num].end_simple = sparams.end_time;
+  }
+
+  return 0;
+
+}
+
+////////////////////////////////////////////////////////////
+// build the complex track index, by walking the entries
+// for each scan
+// Returns 0 on success, -1 on failure.
+
+int TitanTrackFileMap::_buildComplexIndex() const
+
+{
+
+  int nComplexSlots = (int) _complexTrackOffsets.size();
+  vector<si32> entryComplex;
+  vector<si32> entryOffset;
+
+  for (size_t iscan = 0; iscan < _scanIndex.size(); iscan++) {
+    const track_file_scan_index_t &sindex = _scanIndex[iscan];
+    long offset = sindex.first_entry_offset;
+    for (int ii = 0; ii < sindex.n_entries; ii++) {
+      track_file_entry_t entry;
+      if (getEntry(offset, entry)) {
+        TaStr::AddInt(_errStr, "  Building complex index, scan: ", iscan);
+        return -1;
+      }
+      if (entry.complex_track_num >= 0 &&
+          entry.complex_track_num < nComplexSlots) {
+        entryComplex.push_back(entry.complex_track_num);
+        entryOffset.push_back(offset);
+      }
+      offset = entry.next_scan_entry_offset;
+    }
+  }
+
+  // counting sort by complex num, keeping scan order
+
+  _complexEntryStart.assign(nComplexSlots + 1, 0);
+  for (size_t ii = 0; ii < entryComplex.size(); ii++) {
+    _complexEntryStart[entryComplex[ii] + 1]++;
+  }
+  for (int ii = 0; ii < nComplexSlots; ii++) {
+    _complexEntryStart[ii + 1] += _complexEntryStart[ii];
+  }
+  _complexEntryOffsets.resize(entryOffset.size());
+  vector<int> next(_complexEntryStart.begin(), _complexEntryStart.end() - 1);
+  for (size_t ii = 0; ii < entryComplex.size(); ii++) {
+    _complexEntryOffsets[next[entryComplex[ii]]++] = entryOffset[ii];
+  }
+
+  _complexIndexBuilt = true;
+  return 0;
+
+}
+
@@ -0,0 +1,168 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////////
+// <titan/TitanMappedFile.hh>
+//
+// Read-only memory mapping of TITAN storm and track files.
+//
+// TitanMappedFile maps a single file.
+//
+// TitanBeArray is a view onto an array of structs in the mapped
+// file. The files are stored in big-endian byte order, so elements
+// are decoded into host byte order as they are accessed. No reads
+// or allocations are needed to access the data.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef TitanMappedFile_HH
+#define TitanMappedFile_HH
+
+#include <dataport/port_types.h>
+#include <dataport/bigend.h>
+#include <sys/types.h>
+#include <cstring>
+#include <string>
+using namespace std;
+
+class TitanMappedFile
+{
+
+public:
+  
+  // constructor
+  
+  TitanMappedFile();
+  
+  // destructor
+  
+  virtual ~TitanMappedFile();
+
+  // map the file, read-only
+  // returns 0 on success, -1 on failure
+
+  int map(const string &path);
+
+  // unmap the file
+
+  void unmap();
+
+  // data access
+
+  bool isMapped() const { return _isMapped; }
+  const string &path() const { return _path; }
+  const char *ptr() const { return _ptr; }
+  size_t size() const { return _size; }
+
+  // check that a region lies within the mapped file
+  
+  bool inRange(long offset, size_t nbytes) const {
+    return (offset >= 0 &&
+            (size_t) offset <= _size &&
+            nbytes <= _size - (size_t) offset);
+  }
+
+  // has the file on disk changed since it was mapped?
+  // For example, has it been appended to by Titan?
+  // The change time is compared to the nanosecond, to catch
+  // rewrites in place within the same second.
+
+  bool changed() const;
+
+  ///////////////////////////////////////////////////////////////////
+  // error string
+  
+  const string &getErrStr() const { return (_errStr); }
+
+protected:
+
+  string _path;
+  bool _isMapped;
+  char *_ptr;
+  size_t _size;
+
+  // file details at time of mapping, for checking for changes
+
+  dev_t _dev;
+  ino_t _ino;
+  off_t _fileSize;
+  time_t _mtime;
+  struct timespec _ctime;
+
+  string _errStr;
+
+private:
+  
+  // Private methods with no bodies. Copy and assignment not implemented.
+
+  TitanMappedFile(const TitanMappedFile & orig);
+  TitanMappedFile & operator = (const TitanMappedFile & other);
+  
+};
+
+////////////////////////////////////////////////////////////////////
+// TitanBeArray
+//
+// View onto an array of structs stored in big-endian order.
+// WORD_BYTES is the size of the struct members - 4 for most
+// TITAN structs, 2 for runs.
+
+template <class T, int WORD_BYTES = 4>
+class TitanBeArray
+{
+
+public:
+
+  TitanBeArray() : _buf(NULL), _n(0) {}
+  TitanBeArray(const char *buf, size_t n) : _buf(buf), _n(n) {}
+
+  size_t size() const { return _n; }
+  bool empty() const { return _n == 0; }
+
+  // raw big-endian bytes
+
+  const void *raw() const { return _buf; }
+
+  // decode element into host byte order
+
+  T operator[](size_t ii) const {
+    T val;
+    memcpy(&val, _buf + ii * sizeof(T), sizeof(T));
+    if (WORD_BYTES == 2) {
+      BE_to_array_16(&val, sizeof(T));
+    } else {
+      BE_to_array_32(&val, sizeof(T));
+    }
+    return val;
+  }
+
+private:
+
+  const char *_buf;
+  size_t _n;
+
+};
+
+#endif
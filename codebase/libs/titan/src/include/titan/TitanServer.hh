@@ -43,8 +43,8 @@
 #include <titan/track.h>
 using namespace std;
 
-class TitanStormFile;
-class TitanTrackFile;
+class TitanStormFileMap;
+class TitanTrackFileMap;
 
 // read time modes
 
@@ -258,6 +258,13 @@ protected:
 
   vector<int> _trackSetNums;
   
+  // mapped storm and track files, kept across requests and
+  // reopened when the file in use changes, or when the files
+  // are changed on disk
+
+  TitanStormFileMap *_stormMap;
+  TitanTrackFileMap *_trackMap;
+
   // dir, file and scan currently in use
 
   string _dirInUse;
@@ -276,15 +283,18 @@ protected:
   int _findLatestScan();
   void _loadScanList(int iday, vector<_tserver_scan_t> &scanList);
   int _findLastDay(time_t &last_day);
-  int _compileTrackSet(TitanTrackFile &tfile);
+  int _compileTrackSet(const TitanTrackFileMap &tmap);
 
   int _readLatestTime();
 
-  int _readTracks(TitanStormFile &sfile,
-		  TitanTrackFile &tfile);
+  int _readTracks(const TitanStormFileMap &smap,
+		  const TitanTrackFileMap &tmap);
+
+  int _readCurrentEntries(const TitanStormFileMap &smap,
+			  const TitanTrackFileMap &tmap);
 
-  int _readCurrentEntries(TitanStormFile &sfile,
-			  TitanTrackFile &tfile);
+  int _loadEntryProps(const TitanStormFileMap &smap,
+		      TitanTrackEntry *entry);
 
 private:
   
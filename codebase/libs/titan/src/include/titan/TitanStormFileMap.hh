@@ -0,0 +1,168 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////////
+// <titan/TitanStormFileMap.hh>
+//
+// Read-only, memory-mapped access to a TITAN storm file.
+//
+// The data file is mapped, and the scans, storm properties and
+// runs are accessed through TitanBeArray views, without any reads
+// or allocations. An index of scan times is built when the file is
+// opened, for looking up scans by time.
+//
+// The map reflects the file at the time it was opened. If the file
+// may be growing (e.g. in realtime), check filesChanged() and reopen.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef TitanStormFileMap_HH
+#define TitanStormFileMap_HH
+
+#include <titan/storm.h>
+#include <titan/TitanMappedFile.hh>
+#include <string>
+#include <vector>
+using namespace std;
+
+class TitanStormFileMap
+{
+
+public:
+  
+  // constructor
+  
+  TitanStormFileMap();
+  
+  // destructor
+  
+  virtual ~TitanStormFileMap();
+
+  // Open the storm file, given the header file path.
+  // The header is read and the data file is mapped.
+  // returns 0 on success, -1 on failure
+
+  int open(const string &header_file_path);
+
+  // close - unmaps the data file
+
+  void close();
+
+  // is the file open?
+
+  bool isOpen() const { return _dataMap.isMapped(); }
+
+  // have the files changed on disk since opening?
+
+  bool filesChanged() const;
+
+  // header access
+
+  const storm_file_header_t &header() const { return _header; }
+  const storm_file_params_t &params() const { return _header.params; }
+  int nScans() const { return (int) _scanOffsets.size(); }
+
+  const string &header_file_path() const { return _headerFilePath; }
+  const string &data_file_path() const { return _dataFilePath; }
+
+  ///////////////////////////////////////////////
+  // time index
+
+  // time of given scan, -1 if scan_num is not valid
+
+  time_t scanTime(int scan_num) const;
+
+  // find the last scan at or before the given time
+  // returns scan_num, or -1 if none
+
+  int findScanBefore(time_t search_time) const;
+
+  // find the scan closest to the given time, within the time margin
+  // returns scan_num, or -1 if none
+
+  int findScanClosest(time_t search_time, int time_margin) const;
+
+  ///////////////////////////////////////////////
+  // scan and storm access
+  // Returns 0 on success, -1 on failure.
+
+  int getScan(int scan_num, storm_file_scan_header_t &scan) const;
+
+  // global props for all storms in a scan
+  
+  int getGprops(const storm_file_scan_header_t &scan,
+                TitanBeArray<storm_file_global_props_t> &gprops) const;
+
+  // global props for a single storm
+
+  int getGprops(int scan_num, int storm_num,
+                storm_file_global_props_t &gprops) const;
+
+  // secondary props for a storm, given its global props
+  
+  int getLprops(const storm_file_global_props_t &gprops,
+                TitanBeArray<storm_file_layer_props_t> &lprops) const;
+  
+  int getHist(const storm_file_global_props_t &gprops,
+              TitanBeArray<storm_file_dbz_hist_t> &hist) const;
+  
+  int getRuns(const storm_file_global_props_t &gprops,
+              TitanBeArray<storm_file_run_t, 2> &runs) const;
+  
+  int getProjRuns(const storm_file_global_props_t &gprops,
+                  TitanBeArray<storm_file_run_t, 2> &proj_runs) const;
+
+  ///////////////////////////////////////////////////////////////////
+  // error string
+  
+  const string &getErrStr() const { return (_errStr); }
+
+protected:
+
+  string _headerFilePath;
+  string _dataFilePath;
+  
+  TitanMappedFile _dataMap;
+
+  storm_file_header_t _header;
+  vector<si32> _scanOffsets;
+  vector<time_t> _scanTimes;
+
+  mutable string _errStr;
+
+  template <class T, int WORD_BYTES>
+    int _getArray(long offset, int n_elem, const char *label,
+                  TitanBeArray<T, WORD_BYTES> &array) const;
+
+private:
+  
+  // Private methods with no bodies. Copy and assignment not implemented.
+
+  TitanStormFileMap(const TitanStormFileMap & orig);
+  TitanStormFileMap & operator = (const TitanStormFileMap & other);
+  
+};
+
+#endif
@@ -109,6 +109,32 @@ public:
   // Flush the storm header and data files
 
   void FlushFiles();
+
+  // Open an undo file for the track data file.
+  // The current length of the data file is stored in the undo file.
+  // While it is open, the previous contents of any part of the data
+  // below that length are appended to the undo file before they are
+  // rewritten, so that the data file can later be rolled back to its
+  // state at the time the undo file was opened.
+  // The data file must be open. The undo file is closed by
+  // CloseUndoFile() or CloseFiles().
+  // returns 0 on success, -1 on failure
+
+  int OpenUndoFile(const char *undo_file_path);
+
+  // Close the undo file
+
+  void CloseUndoFile();
+
+  // Roll back a data file using an undo file written as above, by
+  // restoring the saved contents in reverse order and truncating
+  // the data file to the length stored in the undo file.
+  // To roll back over several undo files, apply them newest first.
+  // The data file should not be open in this object.
+  // returns 0 on success, -1 on failure
+
+  int RollbackData(const char *data_file_path,
+                   const char *undo_file_path);
   
   // Put an advisory lock on the header file.
   // Mode is "w" - write lock, or "r" - read lock.
@@ -239,6 +265,12 @@ protected:
   FILE *_header_file;
   FILE *_data_file;
 
+  // undo file for rewrites of the data file
+
+  string _undo_file_path;
+  FILE *_undo_file;
+  long _undo_data_len;
+
   bool _first_entry;  // set to TRUE if first entry of a track
   
   // track data
@@ -278,6 +310,7 @@ protected:
   // functions
 
   void _clearErrStr();
+  int _saveUndo(long offset, int nbytes);
 
 public:
 
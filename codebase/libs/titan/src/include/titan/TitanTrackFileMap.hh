@@ -0,0 +1,203 @@
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+// ** Copyright UCAR (c) 1990 - 2016                                         
+// ** University Corporation for Atmospheric Research (UCAR)                 
+// ** National Center for Atmospheric Research (NCAR)                        
+// ** Boulder, Colorado, USA                                                 
+// ** BSD licence applies - redistribution and use in source and binary      
+// ** forms, with or without modification, are permitted provided that       
+// ** the following conditions are met:                                      
+// ** 1) If the software is modified to produce derivative works,            
+// ** such modified software should be clearly marked, so as not             
+// ** to confuse it with the version available from UCAR.                    
+// ** 2) Redistributions of source code must retain the above copyright      
+// ** notice, this list of conditions and the following disclaimer.          
+// ** 3) Redistributions in binary form must reproduce the above copyright   
+// ** notice, this list of conditions and the following disclaimer in the    
+// ** documentation and/or other materials provided with the distribution.   
+// ** 4) Neither the name of UCAR nor the names of its contributors,         
+// ** if any, may be used to endorse or promote products derived from        
+// ** this software without specific prior written permission.               
+// ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  
+// ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      
+// ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    
+// *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* 
+////////////////////////////////////////////////////////////////////
+// <titan/TitanTrackFileMap.hh>
+//
+// Read-only, memory-mapped access to a TITAN track file.
+//
+// The header and data files are mapped, and the track params and
+// entries are decoded directly from the mapped files, without
+// reads or allocations. The following indexes are used:
+//
+//   time -> scan, from the scan index, read when the file is opened;
+//   complex track -> entries, in scan order. This walks all of the
+//     entries in the file, so it is built on the first call to
+//     getComplexEntries(), not on open.
+//
+// The map reflects the file at the time it was opened. If the file
+// may be growing (e.g. in realtime), check filesChanged() and reopen.
+//
+// Oct 2026
+//
+////////////////////////////////////////////////////////////////////
+
+#ifndef TitanTrackFileMap_HH
+#define TitanTrackFileMap_HH
+
+#include <titan/track.h>
+#include <titan/TitanMappedFile.hh>
+#include <string>
+#include <vector>
+using namespace std;
+
+class TitanTrackFileMap
+{
+
+public:
+  
+  // constructor
+  
+  TitanTrackFileMap();
+  
+  // destructor
+  
+  virtual ~TitanTrackFileMap();
+
+  // Open the track file, given the header file path.
+  // The header arrays are read, the files are mapped and
+  // the indexes are built.
+  // returns 0 on success, -1 on failure
+
+  int open(const string &header_file_path);
+
+  // close - unmaps the files
+
+  void close();
+
+  // is the file open?
+
+  bool isOpen() const { return _dataMap.isMapped(); }
+
+  // have the files changed on disk since opening?
+
+  bool filesChanged() const;
+
+  // header access
+
+  const track_file_header_t &header() const { return _header; }
+  const track_file_params_t &params() const { return _header.params; }
+  int nScans() const { return (int) _scanIndex.size(); }
+
+  const string &header_file_path() const { return _headerFilePath; }
+  const string &data_file_path() const { return _dataFilePath; }
+
+  // header arrays, decoded
+
+  const vector<si32> &complex_track_nums() const {
+    return _complexTrackNums;
+  }
+  const vector<track_file_scan_index_t> &scan_index() const {
+    return _scanIndex;
+  }
+  
+  ///////////////////////////////////////////////
+  // time index
+
+  // time of given scan, -1 if scan_num is not valid
+
+  time_t scanTime(int scan_num) const;
+
+  // find the last scan at or before the given time
+  // returns scan_num, or -1 if none
+
+  int findScanBefore(time_t search_time) const;
+
+  // find the scan closest to the given time, within the time margin
+  // returns scan_num, or -1 if none
+
+  int findScanClosest(time_t search_time, int time_margin) const;
+
+  ///////////////////////////////////////////////
+  // track access
+  // Returns 0 on success, -1 on failure.
+
+  int getComplexParams(int complex_num,
+                       complex_track_params_t &params) const;
+
+  int getSimpleParams(int simple_num,
+                      simple_track_params_t &params) const;
+
+  // simple track numbers for a complex track
+
+  int getSimplesPerComplex(int complex_num,
+                           TitanBeArray<si32> &simples) const;
+
+  // entry at given offset in data file
+
+  int getEntry(long offset, track_file_entry_t &entry) const;
+
+  // all entries for a simple track, in time order
+
+  int getSimpleEntries(const simple_track_params_t &params,
+                       vector<track_file_entry_t> &entries) const;
+
+  // all entries for a scan
+
+  int getScanEntries(int scan_num,
+                     vector<track_file_entry_t> &entries) const;
+
+  // complex track index - all entries for a complex track, in
+  // scan order. The index is built on the first call.
+
+  int getComplexEntries(int complex_num,
+                        vector<track_file_entry_t> &entries) const;
+
+  // start and end times of the tracks, as loaded by
+  // TitanTrackFile::ReadUtime()
+
+  int getUtime(vector<track_utime_t> &track_utime) const;
+
+  ///////////////////////////////////////////////////////////////////
+  // error string
+  
+  const string &getErrStr() const { return (_errStr); }
+
+protected:
+
+  string _headerFilePath;
+  string _dataFilePath;
+  
+  TitanMappedFile _headerMap;
+  TitanMappedFile _dataMap;
+
+  track_file_header_t _header;
+  vector<si32> _complexTrackNums;
+  vector<si32> _complexTrackOffsets;
+  vector<si32> _simpleTrackOffsets;
+  vector<track_file_scan_index_t> _scanIndex;
+  vector<si32> _nsimplesPerComplex;
+  vector<si32> _simplesPerComplexOffsets;
+
+  // complex track index - entry offsets for complex track n are
+  // _complexEntryOffsets[_complexEntryStart[n]] to
+  // _complexEntryOffsets[_complexEntryStart[n+1] - 1]
+
+  mutable bool _complexIndexBuilt;
+  mutable vector<int> _complexEntryStart;
+  mutable vector<si32> _complexEntryOffsets;
+
+  mutable string _errStr;
+
+  int _buildComplexIndex() const;
+
+private:
+  
+  // Private methods with no bodies. Copy and assignment not implemented.
+
+  TitanTrackFileMap(const TitanTrackFileMap & orig);
+  TitanTrackFileMap & operator = (const TitanTrackFileMap & other);
+  
+};
+
+#endif
@@ -38,6 +38,8 @@
 #include <titan/TitanServer.hh>
 #include <titan/TitanStormFile.hh>
 #include <titan/TitanTrackFile.hh>
+#include <titan/TitanStormFileMap.hh>
+#include <titan/TitanTrackFileMap.hh>
 #include <dataport/bigend.h>
 #include <toolsa/TaStr.hh>
 #include <toolsa/TaXml.hh>
@@ -53,6 +55,8 @@ TitanServer::TitanServer()
 
 {
 
+  _stormMap = new TitanStormFileMap;
+  _trackMap = new TitanTrackFileMap;
   clearRead();
 
 }
@@ -65,6 +69,8 @@ TitanServer::~TitanServer()
 {
 
   clearArrays();
+  delete _stormMap;
+  delete _trackMap;
 
 }
 
@@ -460,23 +466,37 @@ int TitanServer::read(const string &dir)
     return -1;
   }
 
-  // read the headers
-
-  if (sfile.ReadHeader()) {
-    _errStr += sfile.getErrStr();
-    return -1;
+  // map the files - the locks are held until the reads are done,
+  // so the headers and data are consistent. The maps from the
+  // previous request are reused if the files have not changed,
+  // which saves rebuilding the indexes.
+
+  TitanStormFileMap &smap = *_stormMap;
+  if (!smap.isOpen() || smap.header_file_path() != _stormPathInUse ||
+      smap.filesChanged()) {
+    if (smap.open(stormPath)) {
+      TaStr::AddStr(_errStr, "Cannot map storm file: ", stormPath);
+      _errStr += smap.getErrStr();
+      return -1;
+    }
   }
-  _stormFileParams = sfile.params();
-  if (tfile.ReadHeader()) {
-    _errStr += tfile.getErrStr();
-    return -1;
+  _stormFileParams = smap.params();
+
+  TitanTrackFileMap &tmap = *_trackMap;
+  if (!tmap.isOpen() || tmap.header_file_path() != _trackPathInUse ||
+      tmap.filesChanged()) {
+    if (tmap.open(trackPath)) {
+      TaStr::AddStr(_errStr, "Cannot map track file: ", trackPath);
+      _errStr += tmap.getErrStr();
+      return -1;
+    }
   }
-  _trackFileParams = tfile.params();
+  _trackFileParams = tmap.params();
 
   if (_trackSet == TITAN_SERVER_CURRENT_ENTRIES) {
-    return _readCurrentEntries(sfile, tfile);
+    return _readCurrentEntries(smap, tmap);
   } else {
-    return _readTracks(sfile, tfile);
+    return _readTracks(smap, tmap);
   }
 
 }
@@ -508,70 +528,66 @@ int TitanServer::_readLatestTime()
 //
 // Returns 0 on success, -1 on failure.
 
-int TitanServer::_readTracks(TitanStormFile &sfile,
-			     TitanTrackFile &tfile)
+int TitanServer::_readTracks(const TitanStormFileMap &smap,
+			     const TitanTrackFileMap &tmap)
 
 {
 
   // compile the track set for the request
 
-  if (_compileTrackSet(tfile)) {
+  if (_compileTrackSet(tmap)) {
     return -1;
   }
 
   // read through complex tracks in set
 
+  vector<track_file_entry_t> simpleEntries;
+  
   for (size_t icomplex = 0; icomplex < _trackSetNums.size(); icomplex++) {
 
     int complexNum = _trackSetNums[icomplex];
 
-    // read in complex params
-
-    if (tfile.ReadComplexParams(complexNum, true)) {
-      _errStr += tfile.getErrStr();
-      return -1;
-    }
-
     // create new complex track, set complex params
 
     TitanComplexTrack *complexTrack = new TitanComplexTrack();
     _complexTracks.push_back(complexTrack);
-    complexTrack->_complex_params = tfile.complex_params();
+    if (tmap.getComplexParams(complexNum, complexTrack->_complex_params)) {
+      _errStr += tmap.getErrStr();
+      return -1;
+    }
+
+    TitanBeArray<si32> simpleNums;
+    if (tmap.getSimplesPerComplex(complexNum, simpleNums)) {
+      _errStr += tmap.getErrStr();
+      return -1;
+    }
 
     // read in simple tracks for this complex track
 
     for (int isimple = 0;
 	 isimple < complexTrack->_complex_params.n_simple_tracks; isimple++) {
       
-      int simpleNum = tfile.simples_per_complex()[complexNum][isimple];
+      int simpleNum = simpleNums[isimple];
 
-      // read simple params, go to start of track
-      
-      if (tfile.RewindSimple(simpleNum)) {
-	_errStr += tfile.getErrStr();
-	return -1;
-      }
-      
       // create new simple track, set simple params
       
       TitanSimpleTrack *simpleTrack = new TitanSimpleTrack();
       complexTrack->_simple_tracks.push_back(simpleTrack);
-      simpleTrack->_simple_params = tfile.simple_params();
-
-      // read in track entries
+      if (tmap.getSimpleParams(simpleNum, simpleTrack->_simple_params)) {
+	_errStr += tmap.getErrStr();
+	return -1;
+      }
 
-      for (int ientry = 0;
-	   ientry < simpleTrack->_simple_params.duration_in_scans;
-	   ientry++) {
+      // track entries
 
-	// read in next entry
+      if (tmap.getSimpleEntries(simpleTrack->_simple_params, simpleEntries)) {
+	_errStr += tmap.getErrStr();
+	return -1;
+      }
 
-	if (tfile.ReadEntry()) {
-	  _errStr += tfile.getErrStr();
-	  return -1;
-	}
+      for (size_t ientry = 0; ientry < simpleEntries.size(); ientry++) {
 
-	time_t entryTime = tfile.entry().time;
+	time_t entryTime = simpleEntries[ientry].time;
 	_dataStartTime = MIN(_dataStartTime, entryTime);
 	_dataEndTime = MAX(_dataEndTime, entryTime);
 
@@ -579,56 +595,21 @@ int TitanServer::_readTracks(TitanStormFile &sfile,
 
 	TitanTrackEntry *entry = new TitanTrackEntry;
 	simpleTrack->_entries.push_back(entry);
-	entry->_entry = tfile.entry();
+	entry->_entry = simpleEntries[ientry];
 
-	// read in storm file scan header and global props
+	// storm file scan header and global props
 	
-	if (sfile.ReadScan(entry->_entry.scan_num, entry->_entry.storm_num)) {
-	  _errStr += sfile.getErrStr();
+	if (smap.getScan(entry->_entry.scan_num, entry->_scan) ||
+	    smap.getGprops(entry->_entry.scan_num, entry->_entry.storm_num,
+			   entry->_gprops)) {
+	  _errStr += smap.getErrStr();
 	  return -1;
 	}
-	entry->_scan = sfile.scan();
-	entry->_gprops = sfile.gprops()[entry->_entry.storm_num];
 
-	// read in other props
+	// other props
 	
-	if (_readLprops || _readDbzHist || _readRuns || _readProjRuns) {
-	  if (sfile.ReadProps(entry->_entry.storm_num)) {
-	    _errStr += sfile.getErrStr();
-	    return -1;
-	  }
-	}
-
-	if (_readLprops) {
-	  for (int i = 0; i < entry->_gprops.n_layers; i++) {
-	    entry->_lprops.push_back(sfile.lprops()[i]);
-	  }
-	} else {
-	  entry->_gprops.n_layers = 0;
-	}
-
-	if (_readDbzHist) {
-	  for (int i = 0; i < entry->_gprops.n_dbz_intervals; i++) {
-	    entry->_hist.push_back(sfile.hist()[i]);
-	  }
-	} else {
-	  entry->_gprops.n_dbz_intervals = 0;
-	}
-      
-	if (_readRuns) {
-	  for (int i = 0; i < entry->_gprops.n_runs; i++) {
-	    entry->_runs.push_back(sfile.runs()[i]);
-	  }
-	} else {
-	  entry->_gprops.n_runs = 0;
-	}
-      
-	if (_readProjRuns) {
-	  for (int i = 0; i < entry->_gprops.n_proj_runs; i++) {
-	    entry->_proj_runs.push_back(sfile.proj_runs()[i]);
-	  }
-	} else {
-	  entry->_gprops.n_proj_runs = 0;
+	if (_loadEntryProps(smap, entry)) {
+	  return -1;
 	}
       
       } // ientry
@@ -646,29 +627,32 @@ int TitanServer::_readTracks(TitanStormFile &sfile,
 //
 // Returns 0 on success, -1 on failure.
 
-int TitanServer::_readCurrentEntries(TitanStormFile &sfile,
-				     TitanTrackFile &tfile)
+int TitanServer::_readCurrentEntries(const TitanStormFileMap &smap,
+				     const TitanTrackFileMap &tmap)
 
 {
 
-  // read in entries for current scan
+  // entries for current scan
 
-  if (tfile.ReadScanEntries(_scanInUse)) {
-    _errStr += sfile.getErrStr();
+  vector<track_file_entry_t> scanEntries;
+  if (tmap.getScanEntries(_scanInUse, scanEntries)) {
+    _errStr += tmap.getErrStr();
     return -1;
   }
 
-  // read in storm file scan header and global props for current scan
+  // storm file scan header and global props for current scan
   
-  if (sfile.ReadScan(_scanInUse)) {
-    _errStr += sfile.getErrStr();
+  storm_file_scan_header_t scan;
+  TitanBeArray<storm_file_global_props_t> gprops;
+  if (smap.getScan(_scanInUse, scan) ||
+      smap.getGprops(scan, gprops)) {
+    _errStr += smap.getErrStr();
     return -1;
   }
 
   // loop through the entries
 
-  int nEntries = tfile.scan_index()[_scanInUse].n_entries;
-  for (int ientry = 0; ientry < nEntries; ientry++) {
+  for (size_t ientry = 0; ientry < scanEntries.size(); ientry++) {
     
     // create a new TitanTrackEntry object, add to the vector
 
@@ -677,58 +661,94 @@ int TitanServer::_readCurrentEntries(TitanStormFile &sfile,
 
     // set members
     
-    entry->_entry = tfile.scan_entries()[ientry];
-    entry->_scan = sfile.scan();
-    entry->_gprops = sfile.gprops()[entry->_entry.storm_num];
+    entry->_entry = scanEntries[ientry];
+    entry->_scan = scan;
+    if (entry->_entry.storm_num < 0 ||
+	entry->_entry.storm_num >= (int) gprops.size()) {
+      TaStr::AddInt(_errStr, "  Bad storm num: ", entry->_entry.storm_num);
+      return -1;
+    }
+    entry->_gprops = gprops[entry->_entry.storm_num];
 
-    // read in other props
+    // other props
     
-    if (_readLprops || _readDbzHist || _readRuns || _readProjRuns) {
-      if (sfile.ReadProps(entry->_entry.storm_num)) {
-	_errStr += sfile.getErrStr();
-	return -1;
-      }
+    if (_loadEntryProps(smap, entry)) {
+      return -1;
     }
 
-    if (_readLprops) {
-      for (int i = 0; i < entry->_gprops.n_layers; i++) {
-	entry->_lprops.push_back(sfile.lprops()[i]);
-      }
-    } else {
-      entry->_gprops.n_layers = 0;
+  } // ientry
+
+  return 0;
+
+}
+
+/////////////////////////////////////////////////////
+// load the secondary props for an entry, as requested,
+// given the global props
+//
+// Returns 0 on success, -1 on failure.
+
+int TitanServer::_loadEntryProps(const TitanStormFileMap &smap,
+				 TitanTrackEntry *entry)
+
+{
+
+  if (_readLprops) {
+    TitanBeArray<storm_file_layer_props_t> lprops;
+    if (smap.getLprops(entry->_gprops, lprops)) {
+      _errStr += smap.getErrStr();
+      return -1;
     }
-    
-    if (_readDbzHist) {
-      for (int i = 0; i < entry->_gprops.n_dbz_intervals; i++) {
-	entry->_hist.push_back(sfile.hist()[i]);
-      }
-    } else {
-      entry->_gprops.n_dbz_intervals = 0;
+    for (size_t i = 0; i < lprops.size(); i++) {
+      entry->_lprops.push_back(lprops[i]);
     }
-    
-    if (_readRuns) {
-      for (int i = 0; i < entry->_gprops.n_runs; i++) {
-	entry->_runs.push_back(sfile.runs()[i]);
-      }
-    } else {
-      entry->_gprops.n_runs = 0;
+  } else {
+    entry->_gprops.n_layers = 0;
+  }
+  
+  if (_readDbzHist) {
+    TitanBeArray<storm_file_dbz_hist_t> hist;
+    if (smap.getHist(entry->_gprops, hist)) {
+      _errStr += smap.getErrStr();
+      return -1;
     }
-    
-    if (_readProjRuns) {
-      for (int i = 0; i < entry->_gprops.n_proj_runs; i++) {
-	entry->_proj_runs.push_back(sfile.proj_runs()[i]);
-      }
-    } else {
-      entry->_gprops.n_proj_runs = 0;
+    for (size_t i = 0; i < hist.size(); i++) {
+      entry->_hist.push_back(hist[i]);
     }
-
-  } // ientry
+  } else {
+    entry->_gprops.n_dbz_intervals = 0;
+  }
+  
+  if (_readRuns) {
+    TitanBeArray<storm_file_run_t, 2> runs;
+    if (smap.getRuns(entry->_gprops, runs)) {
+      _errStr += smap.getErrStr();
+      return -1;
+    }
+    for (size_t i = 0; i < runs.size(); i++) {
+      entry->_runs.push_back(runs[i]);
+    }
+  } else {
+    entry->_gprops.n_runs = 0;
+  }
+  
+  if (_readProjRuns) {
+    TitanBeArray<storm_file_run_t, 2> projRuns;
+    if (smap.getProjRuns(entry->_gprops, projRuns)) {
+      _errStr += smap.getErrStr();
+      return -1;
+    }
+    for (size_t i = 0; i < projRuns.size(); i++) {
+      entry->_proj_runs.push_back(projRuns[i]);
+    }
+  } else {
+    entry->_gprops.n_proj_runs = 0;
+  }
 
   return 0;
 
 }
 
-
 /////////////////////////////////////////////////////
 // find the file path and scan number for the
 // time requested
@@ -1143,15 +1163,16 @@ int TitanServer::_findLastDay(time_t &last_day)
 //
 // Returns 0 on success, -1 on failure.
 
-int TitanServer::_compileTrackSet(TitanTrackFile &tfile)
+int TitanServer::_compileTrackSet(const TitanTrackFileMap &tmap)
 
 {
 
   _trackSetNums.clear();
 
-  if (tfile.ReadUtime()) {
+  vector<track_utime_t> trackUtime;
+  if (tmap.getUtime(trackUtime)) {
     _errStr += "ERROR - TitanServer::_compileTrackSet\n";
-    _errStr += tfile.getErrStr();
+    _errStr += tmap.getErrStr();
     return -1;
   }
 
@@ -1168,10 +1189,10 @@ int TitanServer::_compileTrackSet(TitanTrackFile &tfile)
       cerr << "startTimeInUse: " << utimstr(startTimeInUse) << endl;
       cerr << "_timeInUse: " << utimstr(_timeInUse) << endl;
 #endif
-      for (int icomplex = 0; icomplex < tfile.header().n_complex_tracks;
+      for (int icomplex = 0; icomplex < tmap.header().n_complex_tracks;
 	   icomplex++) {
-	int complexNum = tfile.complex_track_nums()[icomplex];
-	const track_utime_t &utime = tfile.track_utime()[complexNum];
+	int complexNum = tmap.complex_track_nums()[icomplex];
+	const track_utime_t &utime = trackUtime[complexNum];
 	if (utime.start_complex <= _timeInUse &&
 	    utime.end_complex >= startTimeInUse) {
 #ifdef DEBUG_PRINT
@@ -1188,9 +1209,9 @@ int TitanServer::_compileTrackSet(TitanTrackFile &tfile)
 
   case TITAN_SERVER_ALL_IN_FILE:
     {
-      for (int icomplex = 0; icomplex < tfile.header().n_complex_tracks;
+      for (int icomplex = 0; icomplex < tmap.header().n_complex_tracks;
 	   icomplex++) {
-	int complexNum = tfile.complex_track_nums()[icomplex];
+	int complexNum = tmap.complex_track_nums()[icomplex];
 	_trackSetNums.push_back(complexNum);
       }
     }
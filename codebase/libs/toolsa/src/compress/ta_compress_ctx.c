@@ -0,0 +1,761 @@
+/* *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* */
+/* ** Copyright UCAR (c) 1990 - 2016                                         */
+/* ** University Corporation for Atmospheric Research (UCAR)                 */
+/* ** National Center for Atmospheric Research (NCAR)                        */
+/* ** Boulder, Colorado, USA                                                 */
+/* ** BSD licence applies - redistribution and use in source and binary      */
+/* ** forms, with or without modification, are permitted provided that       */
+/* ** the following conditions are met:                                      */
+/* ** 1) If the software is modified to produce derivative works,            */
+/* ** such modified software should be clearly marked, so as not             */
+/* ** to confuse it with the version available from UCAR.                    */
+/* ** 2) Redistributions of source code must retain the above copyright      */
+/* ** notice, this list of conditions and the following disclaimer.          */
+/* ** 3) Redistributions in binary form must reproduce the above copyright   */
+/* ** notice, this list of conditions and the following disclaimer in the    */
+/* ** documentation and/or other materials provided with the distribution.   */
+/* ** 4) Neither the name of UCAR nor the names of its contributors,         */
+/* ** if any, may be used to endorse or promote products derived from        */
+/* ** this software without specific prior written permission.               */
+/* ** DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS" AND WITHOUT ANY EXPRESS  */
+/* ** OR IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED      */
+/* ** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.    */
+/* *=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=*=* */
+/**********************************************************************
+ * ta_compress_ctx.c
+ *
+ * Compression using a reusable context, into caller-supplied buffers.
+ *
+ * ta_compress() and ta_decompress() set up a fresh zlib stream and
+ * allocate the output buffer on every call. For many small buffers,
+ * such as FMQ messages or MDV planes, that overhead dominates.
+ * The routines in this file keep the zlib streams in a context,
+ * which is reset rather than re-created between buffers, and write
+ * to buffers owned by the caller.
+ *
+ * The output is in the same format as ta_compress(), and may be
+ * decoded by ta_decompress(), and vice versa.
+ *
+ * Oct 2026
+ *
+ **********************************************************************/
+
+#include <toolsa/toolsa_macros.h>
+#include <toolsa/compress.h>
+#include <toolsa/mem.h>
+#include <dataport/bigend.h>
+#include <zlib.h>
+#include <bzlib.h>
+#include <string.h>
+
+#define UI32_MAX 4294967295U
+#define GZ_HEADER_LEN 10
+#define GZ_TRAILER_LEN 8
+
+struct ta_compress_ctx {
+
+  /* deflate stream, kept between buffers */
+
+  z_stream def;
+  int defInit;
+
+  /* inflate stream, kept between buffers */
+
+  z_stream inf;
+  int infInit;
+
+  /* bzip stream - libbz2 has no reset, so this is per buffer */
+
+  bz_stream bz;
+  int bzInit;
+
+  /* streaming state */
+
+  int active;
+  int failed;
+  ta_compression_method_t method;
+  unsigned char *out;
+  ui64 outLen;
+  ui64 nOut;
+  ui64 nIn;
+  uLong crc;
+
+};
+
+/*
+ * file scope functions
+ */
+
+static int _gzip_start(ta_compress_ctx_t *ctx);
+static int _store_raw(ui32 magic_cookie,
+                      const void *uncompressed_buffer,
+                      ui64 nbytes_uncompressed,
+                      void *out, ui64 out_len,
+                      ui64 *nbytes_compressed_p);
+static void _insert_hdr(void *out, ui32 magic_cookie,
+                        ui64 nbytes_uncompressed,
+                        ui64 nbytes_compressed);
+static void _insert_long(unsigned char *buf, uLong val);
+static int _copy_from(void *decomp, ui64 nbytes,
+                      void *out, ui64 out_len,
+                      ui64 *nbytes_uncompressed_p);
+
+/**********************************************************************
+ * ta_compress_ctx_create()
+ */
+
+ta_compress_ctx_t *ta_compress_ctx_create(void)
+
+{
+  ta_compress_ctx_t *ctx =
+    (ta_compress_ctx_t *) ucalloc(1, sizeof(ta_compress_ctx_t));
+  return ctx;
+}
+
+/**********************************************************************
+ * ta_compress_ctx_free()
+ */
+
+void ta_compress_ctx_free(ta_compress_ctx_t *ctx)
+
+{
+  if (ctx == NULL) {
+    return;
+  }
+  if (ctx->defInit) {
+    deflateEnd(&ctx->def);
+  }
+  if (ctx->infInit) {
+    inflateEnd(&ctx->inf);
+  }
+  if (ctx->bzInit) {
+    BZ2_bzCompressEnd(&ctx->bz);
+  }
+  ufree(ctx);
+}
+
+/**********************************************************************
+ * ta_compress_bound()
+ */
+
+ui64 ta_compress_bound(ta_compression_method_t method,
+                       ui64 nbytes_uncompressed)
+
+{
+
+  ui64 nn = nbytes_uncompressed;
+
+  if (method == TA_COMPRESSION_NONE) {
+    return sizeof(compress_buf_hdr_t) + nn;
+  } else if (method == TA_COMPRESSION_BZIP) {
+    /* see bzlib docs: 1% plus 600 bytes */
+    return sizeof(compress_buf_hdr_t) + nn + nn / 100 + 600;
+  }
+
+  /* gzip - compressBound() covers the zlib wrapper, which is larger
+   * than the raw deflate stream we write */
+
+  return (sizeof(compress_buf_hdr_t) + GZ_HEADER_LEN + GZ_TRAILER_LEN +
+          nn + (nn >> 12) + (nn >> 14) + (nn >> 25) + 13);
+
+}
+
+/**********************************************************************
+ * ta_compress_init()
+ */
+
+int ta_compress_init(ta_compress_ctx_t *ctx,
+                     ta_compression_method_t method,
+                     void *out, ui64 out_len)
+
+{
+
+  if (ctx->bzInit) {
+    /* previous bzip stream was abandoned */
+    BZ2_bzCompressEnd(&ctx->bz);
+    ctx->bzInit = FALSE;
+  }
+
+  /* for compressing, only none, bzip and gzip are supported */
+
+  if (method != TA_COMPRESSION_NONE && method != TA_COMPRESSION_BZIP) {
+    method = TA_COMPRESSION_GZIP;
+  }
+
+  ctx->active = FALSE;
+  ctx->failed = FALSE;
+  ctx->method = method;
+  ctx->out = (unsigned char *) out;
+  ctx->outLen = out_len;
+  ctx->nIn = 0;
+
+  /* leave room for the toolsa header, which is filled in by finish */
+
+  ctx->nOut = sizeof(compress_buf_hdr_t);
+  if (out_len < ctx->nOut ||
+      (method == TA_COMPRESSION_GZIP &&
+       out_len < ctx->nOut + GZ_HEADER_LEN + GZ_TRAILER_LEN)) {
+    return -1;
+  }
+
+  if (method == TA_COMPRESSION_GZIP) {
+    if (_gzip_start(ctx)) {
+      return -1;
+    }
+  } else if (method == TA_COMPRESSION_BZIP) {
+    memset(&ctx->bz, 0, sizeof(ctx->bz));
+    if (BZ2_bzCompressInit(&ctx->bz, 1, 0, 0) != BZ_OK) {
+      return -1;
+    }
+    ctx->bzInit = TRUE;
+  }
+
+  ctx->active = TRUE;
+  return 0;
+
+}
+
+/**********************************************************************
+ * ta_compress_update()
+ */
+
+int ta_compress_update(ta_compress_ctx_t *ctx,
+                       const void *uncompressed_buffer,
+                       ui64 nbytes_uncompressed)
+
+{
+
+  const unsigned char *in = (const unsigned char *) uncompressed_buffer;
+  ui64 nLeft = nbytes_uncompressed;
+
+  if (!ctx->active || ctx->failed) {
+    return -1;
+  }
+  if (ctx->nIn + nbytes_uncompressed >= UI32_MAX) {
+    /* streamed buffers are limited to the 32-bit header */
+    ctx->failed = TRUE;
+    return -1;
+  }
+
+  if (ctx->method == TA_COMPRESSION_NONE) {
+    if (ctx->nOut + nbytes_uncompressed > ctx->outLen) {
+      ctx->failed = TRUE;
+      return -1;
+    }
+    memcpy(ctx->out + ctx->nOut, in, nbytes_uncompressed);
+    ctx->nOut += nbytes_uncompressed;
+    ctx->nIn += nbytes_uncompressed;
+    return 0;
+  }
+
+  if (ctx->method == TA_COMPRESSION_GZIP) {
+    ctx->crc = crc32(ctx->crc, in, (uInt) nbytes_uncompressed);
+  }
+
+  /* avail_in is 32-bit for both libraries, so feed in chunks */
+
+  while (nLeft > 0) {
+
+    unsigned int nChunk = (nLeft > 0x40000000 ? 0x40000000 : (unsigned int) nLeft);
+    ui64 nSpace = ctx->outLen - ctx->nOut;
+    unsigned int nAvail = (nSpace > 0x40000000 ? 0x40000000 : (unsigned int) nSpace);
+    unsigned int nLeftIn;
+    unsigned int nLeftOut;
+    int iret;
+
+    if (ctx->method == TA_COMPRESSION_GZIP) {
+      ctx->def.next_in = (Bytef *) in;
+      ctx->def.avail_in = nChunk;
+      ctx->def.next_out = ctx->out + ctx->nOut;
+      ctx->def.avail_out = nAvail;
+      iret = deflate(&ctx->def, Z_NO_FLUSH);
+      nLeftIn = ctx->def.avail_in;
+      nLeftOut = ctx->def.avail_out;
+      if (iret != Z_OK && iret != Z_BUF_ERROR) {
+        ctx->failed = TRUE;
+        return -1;
+      }
+    } else {
+      ctx->bz.next_in = (char *) in;
+      ctx->bz.avail_in = nChunk;
+      ctx->bz.next_out = (char *) ctx->out + ctx->nOut;
+      ctx->bz.avail_out = nAvail;
+      iret = BZ2_bzCompress(&ctx->bz, BZ_RUN);
+      nLeftIn = ctx->bz.avail_in;
+      nLeftOut = ctx->bz.avail_out;
+      if (iret != BZ_RUN_OK) {
+        ctx->failed = TRUE;
+        return -1;
+      }
+    }
+
+    ctx->nOut += nAvail - nLeftOut;
+    ctx->nIn += nChunk - nLeftIn;
+    in += nChunk - nLeftIn;
+    nLeft -= nChunk - nLeftIn;
+
+    if (nLeftIn > 0 && nLeftOut == 0) {
+      /* output buffer is full */
+      ctx->failed = TRUE;
+      return -1;
+    }
+
+  } /* while */
+
+  return 0;
+
+}
+
+/**********************************************************************
+ * ta_compress_finish()
+ */
+
+int ta_compress_finish(ta_compress_ctx_t *ctx,
+                       ui64 *nbytes_compressed_p)
+
+{
+
+  ui32 magic_cookie = TA_NOT_COMPRESSED;
+
+  if (!ctx->active) {
+    return -1;
+  }
+  ctx->active = FALSE;
+
+  if (ctx->method == TA_COMPRESSION_GZIP) {
+
+    ui64 nSpace = ctx->outLen - ctx->nOut;
+    unsigned int nAvail = (nSpace > UI32_MAX ? UI32_MAX : (unsigned int) nSpace);
+    if (!ctx->failed) {
+      ctx->def.next_in = Z_NULL;
+      ctx->def.avail_in = 0;
+      ctx->def.next_out = ctx->out + ctx->nOut;
+      ctx->def.avail_out = nAvail;
+      if (deflate(&ctx->def, Z_FINISH) != Z_STREAM_END) {
+        ctx->failed = TRUE;
+      }
+      ctx->nOut += nAvail - ctx->def.avail_out;
+    }
+    if (!ctx->failed && ctx->nOut + GZ_TRAILER_LEN <= ctx->outLen) {
+      _insert_long(ctx->out + ctx->nOut, ctx->crc);
+      _insert_long(ctx->out + ctx->nOut + 4, ctx->nIn & 0xffffffff);
+      ctx->nOut += GZ_TRAILER_LEN;
+    } else {
+      ctx->failed = TRUE;
+    }
+    magic_cookie = GZIP_COMPRESSED;
+
+  } else if (ctx->method == TA_COMPRESSION_BZIP) {
+
+    if (!ctx->failed) {
+      int iret;
+      do {
+        ui64 nSpace = ctx->outLen - ctx->nOut;
+        unsigned int nAvail = (nSpace > 0x40000000 ? 0x40000000 : (unsigned int) nSpace);
+        ctx->bz.next_in = NULL;
+        ctx->bz.avail_in = 0;
+        ctx->bz.next_out = (char *) ctx->out + ctx->nOut;
+        ctx->bz.avail_out = nAvail;
+        iret = BZ2_bzCompress(&ctx->bz, BZ_FINISH);
+        ctx->nOut += nAvail - ctx->bz.avail_out;
+        if (iret == BZ_FINISH_OK && nAvail == ctx->bz.avail_out) {
+          /* no progress, output buffer full */
+          iret = BZ_OUTBUFF_FULL;
+        }
+      } while (iret == BZ_FINISH_OK);
+      if (iret != BZ_STREAM_END) {
+        ctx->failed = TRUE;
+      }
+    }
+    BZ2_bzCompressEnd(&ctx->bz);
+    ctx->bzInit = FALSE;
+    magic_cookie = BZIP_COMPRESSED;
+
+  }
+
+  if (ctx->failed) {
+    return -1;
+  }
+
+  _insert_hdr(ctx->out, magic_cookie, ctx->nIn, ctx->nOut);
+  if (nbytes_compressed_p != NULL) {
+    *nbytes_compressed_p = ctx->nOut;
+  }
+  return 0;
+
+}
+
+/**********************************************************************
+ * ta_compress_buf()
+ */
+
+int ta_compress_buf(ta_compress_ctx_t *ctx,
+                    ta_compression_method_t method,
+                    const void *uncompressed_buffer,
+                    ui64 nbytes_uncompressed,
+                    void *out, ui64 out_len,
+                    ui64 *nbytes_compressed_p)
+
+{
+
+  ui64 hdrLen = sizeof(compress_buf_hdr_t);
+  ui64 nn = nbytes_uncompressed;
+  unsigned char *cbuf = (unsigned char *) out + hdrLen;
+
+  if (method != TA_COMPRESSION_NONE && method != TA_COMPRESSION_BZIP) {
+    method = TA_COMPRESSION_GZIP;
+  }
+
+  if (nn >= UI32_MAX) {
+
+    /* large buffer, 64-bit header - use the allocating routine */
+
+    ui64 nbytes_compressed;
+    void *buf = ta_compress(method, uncompressed_buffer, nn,
+                            &nbytes_compressed);
+    if (buf == NULL || nbytes_compressed > out_len) {
+      ta_compress_free(buf);
+      return -1;
+    }
+    memcpy(out, buf, nbytes_compressed);
+    ta_compress_free(buf);
+    *nbytes_compressed_p = nbytes_compressed;
+    return 0;
+
+  }
+
+  if (method == TA_COMPRESSION_NONE) {
+
+    return _store_raw(TA_NOT_COMPRESSED, uncompressed_buffer, nn,
+                      out, out_len, nbytes_compressed_p);
+
+  } else if (method == TA_COMPRESSION_BZIP) {
+
+    /*
+     * the compressed data is only used if it is smaller than the
+     * uncompressed data, so limit the output to that size
+     */
+
+    unsigned int nAvail = 0;
+    int iret = BZ_OUTBUFF_FULL;
+    if (out_len > hdrLen && nn > 1) {
+      nAvail = (unsigned int) (nn - 1);
+      if (nAvail > out_len - hdrLen) {
+        nAvail = (unsigned int) (out_len - hdrLen);
+      }
+      iret = BZ2_bzBuffToBuffCompress((char *) cbuf, &nAvail,
+                                      (char *) uncompressed_buffer,
+                                      (unsigned int) nn, 1, 0, 0);
+    }
+    if (iret != BZ_OK) {
+      return _store_raw(BZIP_NOT_COMPRESSED, uncompressed_buffer, nn,
+                        out, out_len, nbytes_compressed_p);
+    }
+    _insert_hdr(out, BZIP_COMPRESSED, nn, hdrLen + nAvail);
+    *nbytes_compressed_p = hdrLen + nAvail;
+    return 0;
+
+  } else {
+
+    /*
+     * gzip - as for gzip_compress(), the compressed data, including
+     * the gzip header and trailer, must be smaller than the input
+     */
+
+    ui64 nMax = (nn > 0 ? nn - 1 : 0);
+    ui64 nCoded = 0;
+    int iret = -1;
+    if (nMax > out_len - hdrLen) {
+      nMax = out_len - hdrLen;
+    }
+    if (out_len > hdrLen && nMax > GZ_HEADER_LEN + GZ_TRAILER_LEN) {
+      unsigned int nAvail =
+        (unsigned int) (nMax - GZ_HEADER_LEN - GZ_TRAILER_LEN);
+      ctx->out = (unsigned char *) out;
+      ctx->nOut = hdrLen;
+      if (_gzip_start(ctx) == 0) {
+        ctx->def.next_in = (Bytef *) uncompressed_buffer;
+        ctx->def.avail_in = (uInt) nn;
+        ctx->def.next_out = cbuf + GZ_HEADER_LEN;
+        ctx->def.avail_out = nAvail;
+        if (deflate(&ctx->def, Z_FINISH) == Z_STREAM_END) {
+          nCoded = GZ_HEADER_LEN + (nAvail - ctx->def.avail_out);
+          _insert_long(cbuf + nCoded,
+                       crc32(ctx->crc, uncompressed_buffer, (uInt) nn));
+          _insert_long(cbuf + nCoded + 4, nn & 0xffffffff);
+          nCoded += GZ_TRAILER_LEN;
+          iret = 0;
+        }
+      }
+    }
+    if (iret) {
+      return _store_raw(GZIP_NOT_COMPRESSED, uncompressed_buffer, nn,
+                        out, out_len, nbytes_compressed_p);
+    }
+    _insert_hdr(out, GZIP_COMPRESSED, nn, hdrLen + nCoded);
+    *nbytes_compressed_p = hdrLen + nCoded;
+    return 0;
+
+  }
+
+}
+
+/**********************************************************************
+ * ta_decompress_len()
+ */
+
+ui64 ta_decompress_len(const void *compressed_buffer)
+
+{
+
+  ui32 magic_cookie;
+
+  memcpy(&magic_cookie, compressed_buffer, sizeof(ui32));
+  if (magic_cookie == TA_COMPRESS_FLAG_64) {
+    compress_buf_hdr_64_t hdr;
+    memcpy(&hdr, compressed_buffer, sizeof(hdr));
+    compress_buf_hdr_64_from_BE(&hdr);
+    return hdr.nbytes_uncompressed;
+  }
+  BE_to_array_32(&magic_cookie, sizeof(ui32));
+
+  if (magic_cookie == RLE_COMPRESSED ||
+      magic_cookie == _RLE_COMPRESSED ||
+      magic_cookie == __RLE_COMPRESSED) {
+    /* RLE header: cookie, key, nbytes_buffer, nbytes_uncompressed */
+    ui32 rleHdr[4];
+    memcpy(rleHdr, compressed_buffer, sizeof(rleHdr));
+    BE_to_array_32(rleHdr, sizeof(rleHdr));
+    return rleHdr[3];
+  }
+
+  {
+    compress_buf_hdr_t hdr;
+    memcpy(&hdr, compressed_buffer, sizeof(hdr));
+    compress_buf_hdr_from_BE(&hdr);
+    return hdr.nbytes_uncompressed;
+  }
+
+}
+
+/**********************************************************************
+ * ta_decompress_buf()
+ */
+
+int ta_decompress_buf(ta_compress_ctx_t *ctx,
+                      const void *compressed_buffer,
+                      void *out, ui64 out_len,
+                      ui64 *nbytes_uncompressed_p)
+
+{
+
+  ui32 magic_cookie;
+  compress_buf_hdr_t hdr;
+  const unsigned char *coded =
+    (const unsigned char *) compressed_buffer + sizeof(compress_buf_hdr_t);
+
+  *nbytes_uncompressed_p = 0;
+  if (compressed_buffer == NULL) {
+    return -1;
+  }
+
+  memcpy(&magic_cookie, compressed_buffer, sizeof(ui32));
+  BE_to_array_32(&magic_cookie, sizeof(ui32));
+
+  if (magic_cookie == TA_COMPRESS_FLAG_64 ||
+      (magic_cookie != TA_NOT_COMPRESSED &&
+       magic_cookie != GZIP_NOT_COMPRESSED &&
+       magic_cookie != BZIP_NOT_COMPRESSED &&
+       magic_cookie != LZO_NOT_COMPRESSED &&
+       magic_cookie != ZLIB_NOT_COMPRESSED &&
+       magic_cookie != GZIP_COMPRESSED &&
+       magic_cookie != BZIP_COMPRESSED)) {
+
+    /* 64-bit headers and legacy methods - use the allocating routine */
+
+    ui64 nbytes;
+    void *decomp = ta_decompress(compressed_buffer, &nbytes);
+    if (decomp == NULL) {
+      return -1;
+    }
+    return _copy_from(decomp, nbytes, out, out_len, nbytes_uncompressed_p);
+
+  }
+
+  memcpy(&hdr, compressed_buffer, sizeof(hdr));
+  compress_buf_hdr_from_BE(&hdr);
+  if (hdr.nbytes_uncompressed > out_len) {
+    return -1;
+  }
+
+  if (magic_cookie == GZIP_COMPRESSED) {
+
+    /* inflate with gzip wrapper - checks the header, crc and length */
+
+    int iret;
+    if (!ctx->infInit) {
+      memset(&ctx->inf, 0, sizeof(ctx->inf));
+      if (inflateInit2(&ctx->inf, 16 + MAX_WBITS) != Z_OK) {
+        return -1;
+      }
+      ctx->infInit = TRUE;
+    } else if (inflateReset(&ctx->inf) != Z_OK) {
+      return -1;
+    }
+    ctx->inf.next_in = (Bytef *) coded;
+    ctx->inf.avail_in = hdr.nbytes_coded;
+    ctx->inf.next_out = (Bytef *) out;
+    ctx->inf.avail_out = hdr.nbytes_uncompressed;
+    iret = inflate(&ctx->inf, Z_FINISH);
+    if (iret != Z_STREAM_END ||
+        ctx->inf.total_out != hdr.nbytes_uncompressed) {
+      return -1;
+    }
+
+  } else if (magic_cookie == BZIP_COMPRESSED) {
+
+    unsigned int nOut = hdr.nbytes_uncompressed;
+    if (BZ2_bzBuffToBuffDecompress((char *) out, &nOut,
+                                   (char *) coded, hdr.nbytes_coded,
+                                   0, 0) != BZ_OK ||
+        nOut != hdr.nbytes_uncompressed) {
+      return -1;
+    }
+
+  } else {
+
+    /* not compressed, strip off header */
+
+    memcpy(out, coded, hdr.nbytes_uncompressed);
+
+  }
+
+  *nbytes_uncompressed_p = hdr.nbytes_uncompressed;
+  return 0;
+
+}
+
+/******************************************
+ * Reset the deflate stream, and write
+ * the gzip header to the output.
+ * Returns 0 on success, -1 on failure.
+ */
+
+static int _gzip_start(ta_compress_ctx_t *ctx)
+
+{
+
+  unsigned char *gzbuf;
+
+  if (!ctx->defInit) {
+    memset(&ctx->def, 0, sizeof(ctx->def));
+    /* same settings as gzip_compress() */
+    if (deflateInit2(&ctx->def,
+                     Z_DEFAULT_COMPRESSION,
+                     Z_DEFLATED,
+                     -MAX_WBITS,  /* suppress wrapper */
+                     8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      return -1;
+    }
+    ctx->defInit = TRUE;
+  } else if (deflateReset(&ctx->def) != Z_OK) {
+    return -1;
+  }
+
+  /* simplest gzip header, as written by gzip_compress() */
+
+  gzbuf = ctx->out + ctx->nOut;
+  gzbuf[0] = 0x1f; /* magic */
+  gzbuf[1] = 0x8b; /* magic */
+  gzbuf[2] = Z_DEFLATED;
+  gzbuf[3] = 0; /* flags */
+  gzbuf[4] = 0; /* time: always 0 */
+  gzbuf[5] = 0;
+  gzbuf[6] = 0;
+  gzbuf[7] = 0;
+  gzbuf[8] = 0; /* xflags */
+  gzbuf[9] = 0x03; /* OS code: Unix */
+  ctx->nOut += GZ_HEADER_LEN;
+
+  ctx->crc = crc32(0L, Z_NULL, 0);
+  return 0;
+
+}
+
+/******************************************
+ * Store uncompressed data, with header.
+ * Returns 0 on success, -1 if out is too small.
+ */
+
+static int _store_raw(ui32 magic_cookie,
+                      const void *uncompressed_buffer,
+                      ui64 nbytes_uncompressed,
+                      void *out, ui64 out_len,
+                      ui64 *nbytes_compressed_p)
+
+{
+  ui64 nbytes = sizeof(compress_buf_hdr_t) + nbytes_uncompressed;
+  if (nbytes > out_len) {
+    return -1;
+  }
+  memcpy((char *) out + sizeof(compress_buf_hdr_t),
+         uncompressed_buffer, nbytes_uncompressed);
+  _insert_hdr(out, magic_cookie, nbytes_uncompressed, nbytes);
+  *nbytes_compressed_p = nbytes;
+  return 0;
+}
+
+/******************************************
+ * Load the 32-bit toolsa header, in BE order.
+ */
+
+static void _insert_hdr(void *out, ui32 magic_cookie,
+                        ui64 nbytes_uncompressed,
+                        ui64 nbytes_compressed)
+
+{
+  compress_buf_hdr_t hdr;
+  MEM_zero(hdr);
+  hdr.magic_cookie = magic_cookie;
+  hdr.nbytes_uncompressed = (ui32) nbytes_uncompressed;
+  hdr.nbytes_compressed = (ui32) nbytes_compressed;
+  hdr.nbytes_coded = (ui32) (nbytes_compressed - sizeof(hdr));
+  compress_buf_hdr_to_BE(&hdr);
+  memcpy(out, &hdr, sizeof(hdr));
+}
+
+/******************************************
+ * Insert 32-bit int, little-endian, as
+ * required by the gzip trailer.
+ */
+
+static void _insert_long(unsigned char *buf, uLong val)
+
+{
+  int ii;
+  for (ii = 0; ii < 4; ii++) {
+    buf[ii] = (val & 0xff);
+    val >>= 8;
+  }
+}
+
+/******************************************
+ * Copy buffer from ta_decompress() into
+ * caller's buffer, and free it.
+ */
+
+static int _copy_from(void *decomp, ui64 nbytes,
+                      void *out, ui64 out_len,
+                      ui64 *nbytes_uncompressed_p)
+
+{
+  if (nbytes > out_len) {
+    ta_compress_free(decomp);
+    return -1;
+  }
+  memcpy(out, decomp, nbytes);
+  ta_compress_free(decomp);
+  *nbytes_uncompressed_p = nbytes;
+  return 0;
+}
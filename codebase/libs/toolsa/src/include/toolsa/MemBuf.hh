@@ -151,6 +151,14 @@ public:
 
   void operator=(const MemBuf &other);
 
+  //__________________________________________________________
+  //
+  // Exchange contents with another MemBuf, without copying.
+  //
+  //__________________________________________________________
+
+  void swap(MemBuf &other);
+
   //__________________________________________________________
   //
   // Check available space, grow or shrink as needed
@@ -137,6 +137,12 @@ public:
   //
   bool isOpen() const { return (_sd >= 0); }
 
+  //////////////////////////////////////////////
+  // get the socket descriptor, -1 if not open.
+  // Used for registering the socket with poll/epoll.
+  //
+  int getSd() const { return _sd; }
+
   /////////////////////////////////////////////
   // readSelect()
   //
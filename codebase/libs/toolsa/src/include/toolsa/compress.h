@@ -213,6 +213,122 @@ extern void *ta_decompress(const void *compressed_buffer,
 
 extern void ta_compress_free(void *buffer);
 
+/*****************************************
+ * Compression with a reusable context
+ *
+ * For compressing or decompressing many buffers, the context keeps
+ * the zlib streams alive between calls, and the output is written
+ * to a buffer supplied by the caller, so that it may be reused.
+ *
+ * The buffer format is the same as for ta_compress(), so the output
+ * may be decoded by ta_decompress(), and vice versa.
+ *
+ * A context must not be shared between threads.
+ *****************************************/
+
+typedef struct ta_compress_ctx ta_compress_ctx_t;
+
+/**********************************************************************
+ * ta_compress_ctx_create() - create a compression context.
+ * Free with ta_compress_ctx_free().
+ */
+
+extern ta_compress_ctx_t *ta_compress_ctx_create(void);
+
+extern void ta_compress_ctx_free(ta_compress_ctx_t *ctx);
+
+/**********************************************************************
+ * ta_compress_bound()
+ *
+ * Returns the output buffer length, including the toolsa header,
+ * which is guaranteed to be large enough for compressing
+ * nbytes_uncompressed with the given method.
+ *
+ **********************************************************************/
+
+extern ui64 ta_compress_bound(ta_compression_method_t method,
+                              ui64 nbytes_uncompressed);
+
+/**********************************************************************
+ * ta_compress_init(), ta_compress_update(), ta_compress_finish()
+ *
+ * Streaming compression into the caller's buffer.
+ *
+ * ta_compress_init() starts a buffer, ta_compress_update() adds data
+ * to it, and ta_compress_finish() completes the stream and writes the
+ * toolsa header. Use ta_compress_bound() on the total length to size
+ * the output buffer.
+ *
+ * Unlike ta_compress(), the data is compressed even if that does not
+ * reduce its size. Streamed buffers must be less than 4 GB.
+ *
+ * On success, returns 0. ta_compress_finish() sets *nbytes_compressed_p
+ * to the length of the buffer, including the header.
+ *
+ * On failure, including running out of space in the output buffer,
+ * returns -1.
+ *
+ **********************************************************************/
+
+extern int ta_compress_init(ta_compress_ctx_t *ctx,
+                            ta_compression_method_t method,
+                            void *out, ui64 out_len);
+
+extern int ta_compress_update(ta_compress_ctx_t *ctx,
+                              const void *uncompressed_buffer,
+                              ui64 nbytes_uncompressed);
+
+extern int ta_compress_finish(ta_compress_ctx_t *ctx,
+                              ui64 *nbytes_compressed_p);
+
+/**********************************************************************
+ * ta_compress_buf()
+ *
+ * Compress a single buffer into the caller's buffer.
+ *
+ * Produces the same output as ta_compress(), including storing the
+ * data uncompressed if it does not compress. The output buffer must be
+ * at least sizeof(compress_buf_hdr_t) + nbytes_uncompressed long,
+ * ta_compress_bound() is always sufficient.
+ *
+ * Returns 0 on success, -1 on failure.
+ * Sets *nbytes_compressed_p.
+ *
+ **********************************************************************/
+
+extern int ta_compress_buf(ta_compress_ctx_t *ctx,
+                           ta_compression_method_t method,
+                           const void *uncompressed_buffer,
+                           ui64 nbytes_uncompressed,
+                           void *out, ui64 out_len,
+                           ui64 *nbytes_compressed_p);
+
+/**********************************************************************
+ * ta_decompress_len()
+ *
+ * Returns the uncompressed length of a buffer from any of the toolsa
+ * compression methods, as stored in its header.
+ *
+ **********************************************************************/
+
+extern ui64 ta_decompress_len(const void *compressed_buffer);
+
+/**********************************************************************
+ * ta_decompress_buf()
+ *
+ * Decompress into the caller's buffer, which must be at least
+ * ta_decompress_len() bytes long.
+ *
+ * Returns 0 on success, -1 on failure.
+ * Sets *nbytes_uncompressed_p.
+ *
+ **********************************************************************/
+
+extern int ta_decompress_buf(ta_compress_ctx_t *ctx,
+                             const void *compressed_buffer,
+                             void *out, ui64 out_len,
+                             ui64 *nbytes_uncompressed_p);
+
 /***************
  * LZO routines
  ***************/
@@ -196,6 +196,25 @@ void MemBuf::operator=(const MemBuf &other)
   add(other._buf, other._len);
 }
 
+///////////////////////////////////////////////////////////////
+// 
+// swap contents
+//
+
+void MemBuf::swap(MemBuf &other)
+
+{
+  char *buf = _buf;
+  size_t len = _len;
+  size_t nalloc = _nalloc;
+  _buf = other._buf;
+  _len = other._len;
+  _nalloc = other._nalloc;
+  other._buf = buf;
+  other._len = len;
+  other._nalloc = nalloc;
+}
+
 ///////////////////////////////////////////////////////////////
 // Check available space, alloc as needed
 //